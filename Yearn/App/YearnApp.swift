@@ -16,16 +16,36 @@ struct YearnApp: App {
     @Environment(\.scenePhase) private var scenePhase
     
     init() {
-        // Register static cores at app startup
-        #if STATIC_CORES_ENABLED
-        registerAllStaticCores()
-        print("✅ Static cores registered")
-        #else
-        print("ℹ️ Using dynamic cores (STATIC_CORES_ENABLED not defined)")
-        #endif
+        let startup = StartupScheduler.shared
+        
+        // First screen: the theme and play history are read by the library
+        startup.addCritical(.theme) {
+            _ = ThemeManager.shared
+        }
+        startup.addCritical(.playJournal) {
+            _ = PlayJournal.shared
+        }
+        // Caches shed memory from the first screen on
+        startup.addCritical(.memoryBudget) {
+            MemoryBudget.shared.startMonitoring()
+        }
+        
+        // Only needed once a game starts; EmulationViewModel waits for it
+        startup.addDeferred(.cores, qos: .userInitiated) {
+            #if STATIC_CORES_ENABLED
+            registerAllStaticCores()
+            Log.app.info("Static cores registered")
+            #else
+            Log.app.info("Using dynamic cores (STATIC_CORES_ENABLED not defined)")
+            #endif
+        }
         
         // Setup BIOS files (copy bundled FreeBIOS to Documents/BIOS)
-        BIOSManager.shared.setupBIOS()
+        startup.addDeferred(.bios) {
+            BIOSManager.shared.setupBIOS()
+        }
+        
+        startup.run()
     }
     
     var body: some Scene {
@@ -52,9 +72,9 @@ struct YearnApp: App {
     
     private func handleOpenURL(_ url: URL) {
         // Handle file URLs (ROM imports from other apps)
-        print("📂 handleOpenURL called with: \(url)")
-        print("📂 URL scheme: \(url.scheme ?? "none")")
-        print("📂 Is file URL: \(url.isFileURL)")
+        Log.app.debug("handleOpenURL called with: \(url)")
+        Log.app.debug("URL scheme: \(url.scheme ?? "none")")
+        Log.app.debug("Is file URL: \(url.isFileURL)")
         
         if url.isFileURL {
             // 发送通知让 LibraryView 处理导入
@@ -92,8 +112,8 @@ struct YearnApp: App {
                 // Trigger auto-save
             }
         case .background:
-            // App went to background
-            break
+            // App went to background - write play history before suspension
+            PlayJournal.shared?.flush()
         @unknown default:
             break
         }
@@ -113,7 +133,7 @@ class AppDelegate: NSObject, UIApplicationDelegate {
         // 检查启动时是否有通过其他应用打开的文件
         if let launchOptions = launchOptions,
            let url = launchOptions[.url] as? URL {
-            print("📂 App launched with URL: \(url)")
+            Log.app.debug("App launched with URL: \(url)")
             DispatchQueue.main.asyncAfter(deadline: .now() + 0.5) {
                 NotificationCenter.default.post(
                     name: .importGameFromURL,
@@ -132,8 +152,8 @@ class AppDelegate: NSObject, UIApplicationDelegate {
         open url: URL,
         options: [UIApplication.OpenURLOptionsKey: Any] = [:]
     ) -> Bool {
-        print("📂 AppDelegate.open URL: \(url)")
-        print("📂 Options: \(options)")
+        Log.app.debug("AppDelegate.open URL: \(url)")
+        Log.app.debug("Options: \(options)")
         
         // 发送通知让 LibraryView 处理导入
         NotificationCenter.default.post(
@@ -187,7 +207,7 @@ class SceneDelegate: NSObject, UIWindowSceneDelegate {
         // 处理通过"用...打开"在场景连接时传入的 URL
         if let urlContext = connectionOptions.urlContexts.first {
             let url = urlContext.url
-            print("📂 Scene willConnectTo with URL: \(url)")
+            Log.app.debug("Scene willConnectTo with URL: \(url)")
             
             // 延迟发送通知，确保 UI 已经准备好
             DispatchQueue.main.asyncAfter(deadline: .now() + 0.5) {
@@ -205,7 +225,7 @@ class SceneDelegate: NSObject, UIWindowSceneDelegate {
         guard let urlContext = URLContexts.first else { return }
         let url = urlContext.url
         
-        print("📂 Scene openURLContexts: \(url)")
+        Log.app.debug("Scene openURLContexts: \(url)")
         
         NotificationCenter.default.post(
             name: .importGameFromURL,
@@ -237,6 +257,16 @@ class SceneDelegate: NSObject, UIWindowSceneDelegate {
     }
 }
 
+// MARK: - Startup Tasks
+
+extension StartupScheduler.TaskName {
+    static let theme: Self = "theme"
+    static let playJournal: Self = "playJournal"
+    static let memoryBudget: Self = "memoryBudget"
+    static let cores: Self = "cores"
+    static let bios: Self = "bios"
+}
+
 // MARK: - Notification Names
 
 extension Notification.Name {
@@ -7,6 +7,7 @@
 
 import Foundation
 import SwiftUI
+import YearnCore
 
 /// Represents a game ROM file
 struct Game: Identifiable, Hashable {
@@ -204,92 +205,115 @@ enum GameSystem: String, CaseIterable, Identifiable, Codable {
     static func system(forFileAt url: URL) -> GameSystem? {
         let ext = url.pathExtension.lowercased()
         
+        // 压缩包：根据包内文件判断
+        if ROMArchiveCache.isArchive(url) {
+            return system(forArchiveAt: url)
+        }
+        
         // 对于非歧义的扩展名，直接返回
         if ext != "bin" && ext != "iso" {
             return system(forExtension: ext)
         }
         
-        // 对于 .bin 文件，需要分析文件头来确定平台
-        guard let fileHandle = try? FileHandle(forReadingFrom: url) else {
+        // 对于 .bin/.iso 文件，分析文件头来确定平台（一次读取，按签名表匹配）
+        guard let sniffed = ContentSniffer.sniff(fileAt: url) else {
             // 如果无法读取文件，默认返回 PS1（最常见的 .bin 用途）
             return .ps1
         }
-        
-        defer { try? fileHandle.close() }
-        
-        // 读取文件头（前 16 字节）
-        guard let headerData = try? fileHandle.read(upToCount: 16),
-              headerData.count >= 4 else {
-            return .ps1
+        return system(forFileAt: url, sniffed: sniffed.results, fileSize: sniffed.fileSize)
+    }
+    
+    /// Get the system for a file whose header has already been sniffed (e.g. while importing it)
+    /// - Parameters:
+    ///   - url: The file URL (its extension and neighbouring .cue are consulted)
+    ///   - sniffed: Candidates from `ContentSniffer`, best first
+    ///   - fileSize: Size of the file
+    static func system(forFileAt url: URL, sniffed results: [SniffResult], fileSize: UInt64) -> GameSystem? {
+        let ext = url.pathExtension.lowercased()
+        if ROMArchiveCache.isArchive(url) {
+            return system(forArchiveAt: url)
         }
-        
-        let header = [UInt8](headerData)
-        
-        // N64 ROM 检测
-        // - Big-endian (.z64): 0x80 0x37 0x12 0x40
-        // - Little-endian (.n64): 0x40 0x12 0x37 0x80
-        // - Byte-swapped (.v64): 0x37 0x80 0x40 0x12
-        if header.count >= 4 {
-            // Z64 格式 (Big-endian)
-            if header[0] == 0x80 && header[1] == 0x37 && header[2] == 0x12 && header[3] == 0x40 {
-                print("🔍 Detected N64 ROM (Z64 format)")
-                return .n64
-            }
-            // N64 格式 (Little-endian)
-            if header[0] == 0x40 && header[1] == 0x12 && header[2] == 0x37 && header[3] == 0x80 {
-                print("🔍 Detected N64 ROM (N64 format)")
-                return .n64
-            }
-            // V64 格式 (Byte-swapped)
-            if header[0] == 0x37 && header[1] == 0x80 && header[2] == 0x40 && header[3] == 0x12 {
-                print("🔍 Detected N64 ROM (V64 format)")
-                return .n64
-            }
+        if ext != "bin" && ext != "iso" {
+            return system(forExtension: ext)
         }
         
-        // Genesis/Mega Drive ROM 检测
-        // 通常在偏移 0x100 处有 "SEGA" 字符串，但 .bin 文件可能没有标准头
-        // 检查文件大小：Genesis ROM 通常 < 16MB
-        if let fileSize = try? FileManager.default.attributesOfItem(atPath: url.path)[.size] as? Int64 {
-            // Genesis ROM 通常在 256KB - 8MB 之间
-            if fileSize >= 256 * 1024 && fileSize <= 8 * 1024 * 1024 {
-                // 尝试读取偏移 0x100 处的 SEGA 标识
-                try? fileHandle.seek(toOffset: 0x100)
-                if let segaData = try? fileHandle.read(upToCount: 16) {
-                    let segaString = String(data: segaData, encoding: .ascii) ?? ""
-                    if segaString.contains("SEGA") {
-                        print("🔍 Detected Genesis/Mega Drive ROM")
-                        return .genesis
-                    }
-                }
-            }
+        if let best = results.first, best.confidence >= 0.5, let detected = system(forSniffedFormat: best.format) {
+            Log.library.debug("Detected \(detected.rawValue) (\(best.format.rawValue), confidence \(Int(best.confidence * 100))%)")
+            return detected
         }
         
         // PS1 CD-ROM 检测
-        // PS1 .bin 文件通常是光盘镜像，大小 > 100MB
         // 检查是否有配套的 .cue 文件
         let baseName = url.deletingPathExtension().lastPathComponent
         let directory = url.deletingLastPathComponent()
         let cueURL = directory.appendingPathComponent(baseName).appendingPathExtension("cue")
         
         if FileManager.default.fileExists(atPath: cueURL.path) {
-            print("🔍 Detected PS1 CD-ROM (found .cue file)")
+            Log.library.debug("Detected PS1 CD-ROM (found .cue file)")
             return .ps1
         }
         
         // 检查文件大小：PS1 光盘镜像通常 > 100MB
-        if let fileSize = try? FileManager.default.attributesOfItem(atPath: url.path)[.size] as? Int64 {
-            if fileSize > 100 * 1024 * 1024 {
-                print("🔍 Detected PS1 CD-ROM (large file size: \(fileSize / 1024 / 1024) MB)")
-                return .ps1
-            }
+        if fileSize > 100 * 1024 * 1024 {
+            Log.library.debug("Detected PS1 CD-ROM (large file size: \(fileSize / 1024 / 1024) MB)")
+            return .ps1
+        }
+        
+        // 低置信度的匹配（如无头的原始光盘扇区）仍优先于默认值
+        if let best = results.first, let guessed = system(forSniffedFormat: best.format) {
+            Log.library.debug("Guessing \(guessed.rawValue) (confidence \(Int(best.confidence * 100))%)")
+            return guessed
         }
         
         // 默认返回 PS1（最常见的 .bin 用途）
-        print("🔍 Defaulting to PS1 for .bin file")
+        Log.library.debug("Defaulting to PS1 for .bin file")
         return .ps1
     }
     
+    /// Map a sniffed header format to the system that runs it
+    private static func system(forSniffedFormat format: SniffedFormat) -> GameSystem? {
+        switch format {
+        case .nes, .fds: return .nes
+        case .snes: return .snes
+        case .gb, .gbc: return .gbc
+        case .gba: return .gba
+        case .n64: return .n64
+        case .nds: return .nds
+        case .genesis: return .genesis
+        case .ps1: return .ps1
+        case .iso9660: return nil
+        }
+    }
+    
+    /// Get the system for a ZIP/7z archive from the files it contains
+    /// - Parameter url: The archive URL
+    /// - Returns: The detected GameSystem, or nil if the archive holds no known ROM
+    static func system(forArchiveAt url: URL) -> GameSystem? {
+        // 压缩包所在文件夹名（如 ROMs/SNES/game.7z）
+        let folderSystem = GameSystem(rawValue: url.deletingLastPathComponent().lastPathComponent)
+        
+        // 7z 无法在此列出内容，只能依靠文件夹名
+        guard let archive = try? ZipArchive(url: url) else {
+            return folderSystem
+        }
+        
+        let files = archive.files.sorted { $0.uncompressedSize > $1.uncompressedSize }
+        
+        // 优先使用非歧义的扩展名
+        for entry in files where entry.pathExtension != "bin" && entry.pathExtension != "iso" {
+            if let system = system(forExtension: entry.pathExtension) {
+                Log.library.debug("Detected \(system.rawValue) from archive entry: \(entry.fileName)")
+                return system
+            }
+        }
+        
+        if files.contains(where: { $0.pathExtension == "bin" || $0.pathExtension == "iso" }) {
+            return folderSystem ?? .ps1
+        }
+        
+        return nil
+    }
+    
     /// All supported file extensions across all systems
     static var allSupportedExtensions: [String] {
         GameSystem.allCases.flatMap { $0.supportedExtensions }
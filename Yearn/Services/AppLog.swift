@@ -0,0 +1,20 @@
+//
+//  AppLog.swift
+//  Yearn
+//
+//  The app's logging subsystems
+//
+
+import Foundation
+import YearnCore
+
+extension Log {
+    static let app = Log("app")
+    static let ui = Log("ui")
+    static let startup = Log("startup")
+    static let database = Log("database")
+    static let artwork = Log("artwork")
+    static let skin = Log("skin")
+    static let bios = Log("bios")
+    static let spotlight = Log("spotlight")
+}
@@ -6,6 +6,7 @@
 //
 
 import SwiftUI
+import YearnCore
 
 /// Service for managing game artwork/cover images
 @MainActor
@@ -16,43 +17,26 @@ class ArtworkService: ObservableObject {
     private let artworkDirectory: URL
     private var downloadTasks: [String: Task<URL?, Error>] = [:]
     
-    // Cache for loaded images
-    private var imageCache = NSCache<NSString, UIImage>()
-    
     private init() {
         let documentsURL = fileManager.urls(for: .documentDirectory, in: .userDomainMask).first!
         artworkDirectory = documentsURL.appendingPathComponent("Artwork", isDirectory: true)
         
         // Create artwork directory if needed
         try? fileManager.createDirectory(at: artworkDirectory, withIntermediateDirectories: true)
-        
-        // Configure cache
-        imageCache.countLimit = 100
-        imageCache.totalCostLimit = 50 * 1024 * 1024 // 50MB
     }
     
     /// Get artwork for a game, downloading if necessary
-    func getArtwork(for game: Game) async -> UIImage? {
-        let cacheKey = game.id.uuidString as NSString
-        
-        // Check memory cache
-        if let cachedImage = imageCache.object(forKey: cacheKey) {
-            return cachedImage
-        }
-        
-        // Check disk cache
-        let localURL = artworkDirectory.appendingPathComponent("\(game.id.uuidString).jpg")
-        if fileManager.fileExists(atPath: localURL.path) {
-            if let image = UIImage(contentsOfFile: localURL.path) {
-                imageCache.setObject(image, forKey: cacheKey)
-                return image
-            }
+    /// Decoding happens off the main actor at `maxPixelSize` through `CoverImageCache`
+    func getArtwork(for game: Game, maxPixelSize: Int = 600) async -> UIImage? {
+        // Custom cover or artwork already on disk
+        if let cover = await CoverImageCache.shared.cover(for: game.id, maxPixelSize: maxPixelSize) {
+            return cover
         }
+        guard !Task.isCancelled else { return nil }
         
-        // Download artwork
-        if let downloadedImage = await downloadArtwork(for: game) {
-            imageCache.setObject(downloadedImage, forKey: cacheKey)
-            return downloadedImage
+        // Download artwork, then decode the saved copy at display size
+        if await downloadArtwork(for: game) != nil {
+            return await CoverImageCache.shared.cover(for: game.id, maxPixelSize: maxPixelSize)
         }
         
         return nil
@@ -75,14 +59,14 @@ class ArtworkService: ObservableObject {
             // 尝试从 Libretro Thumbnails 下载
             if let url = ArtworkSource.libretroThumbnails.url(for: tempGame) {
                 if let image = await downloadFromURL(url) {
-                    print("🎨 Found cover with name variant: \(variant)")
+                    Log.artwork.debug("Found cover with name variant: \(variant)")
                     await saveArtwork(image, for: game)
                     return image
                 }
             }
         }
         
-        print("🎨 No cover found for: \(game.name)")
+        Log.artwork.debug("No cover found for: \(game.name)")
         return nil
     }
     
@@ -183,6 +167,7 @@ class ArtworkService: ObservableObject {
         if let data = image.jpegData(compressionQuality: 0.8) {
             try? data.write(to: localURL)
         }
+        CoverImageCache.shared.invalidate(game.id)
     }
     
     /// Fetch artwork from online sources (public method)
@@ -192,7 +177,7 @@ class ArtworkService: ObservableObject {
     
     /// Clear artwork cache
     func clearCache() {
-        imageCache.removeAllObjects()
+        CoverImageCache.shared.removeAll(includingDisk: true)
         try? fileManager.removeItem(at: artworkDirectory)
         try? fileManager.createDirectory(at: artworkDirectory, withIntermediateDirectories: true)
     }
@@ -7,7 +7,7 @@
 //
 
 import Foundation
-import CommonCrypto
+import YearnCore
 
 /// BIOS 文件信息结构体
 struct BIOSFileInfo: Identifiable {
@@ -19,6 +19,8 @@ struct BIOSFileInfo: Identifiable {
     let isRequired: Bool
     let description: String
     let md5Hash: String?
+    /// MD5 校验结果（仅已安装的 PS1 BIOS）
+    var validation: BIOSValidationResult? = nil
     
     /// 格式化的文件大小
     var formattedSize: String {
@@ -44,18 +46,13 @@ enum PS1BIOSRegion: String, CaseIterable {
         }
     }
     
+    /// 哈希表在 YearnCore 的 KnownBIOS 中，由 YearnCoreTests 校验
     var md5Hash: String {
-        switch self {
-        case .japan: return "8dd7d5296a650fac7319bce665a6a53c"
-        case .usa: return "490f666e1afb15b7362b406ed1cea246"
-        case .europe: return "32736f17079d0b2b7024407c39bd3050"
-        case .usaOld: return "924e392ed05558ffdb115408c263dccf"
-        case .psp: return "c53ca5908936d412331790f4426c6c33"
-        }
+        KnownBIOS.ps1MD5[rawValue] ?? ""
     }
     
     var expectedSize: Int64 {
-        return 524288 // 512 KB
+        KnownBIOS.ps1Size
     }
 }
 
@@ -79,6 +76,12 @@ final class BIOSManager: ObservableObject {
     
     // MARK: - Properties
     
+    /// BIOS 哈希缓存，文件大小和修改时间不变时不再重新计算
+    private let hashCache = FileHashCache(
+        storeURL: FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("BIOSHashes.plist")
+    )
+    
     /// BIOS 目录路径
     var biosDirectory: URL {
         let documentsURL = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
@@ -105,14 +108,30 @@ final class BIOSManager: ObservableObject {
     // MARK: - Public Methods
     
     /// 初始化 BIOS 目录并复制内置 BIOS 文件
-    /// 应在应用启动时调用
+    /// 启动时由 StartupScheduler 在后台线程调用，状态回到主线程发布；
+    /// 启动游戏前用 `isBIOSReady(for:)` 等待它完成，不要直接读已发布的状态
     func setupBIOS() {
         createBIOSDirectoryIfNeeded()
         copyBundledBIOSFiles()
-        refreshBIOSStatus()
         
-        print("📀 BIOSManager: BIOS 目录已初始化")
-        print("📀 BIOSManager: 路径 = \(biosDirectory.path)")
+        let isPS1BIOSAvailable = checkPS1BIOSAvailable()
+        let installedFiles = getInstalledBIOSFiles()
+        DispatchQueue.main.async {
+            self.isPS1BIOSAvailable = isPS1BIOSAvailable
+            self.installedFiles = installedFiles
+        }
+        
+        Log.bios.debug("BIOS 目录已初始化")
+        Log.bios.debug("路径 = \(biosDirectory.path)")
+    }
+    
+    /// 等启动时的 BIOS 初始化完成并刷新状态后，检查该系统能否启动
+    /// 只有 PS1 需要用户提供 BIOS；其他系统总是返回 true
+    @MainActor
+    func isBIOSReady(for system: GameSystem) async -> Bool {
+        await StartupScheduler.shared.wait(for: .bios)
+        refreshBIOSStatus()
+        return system != .ps1 || isPS1BIOSAvailable
     }
     
     /// 刷新 BIOS 状态
@@ -240,7 +259,8 @@ final class BIOSManager: ObservableObject {
                 isInstalled: isInstalled,
                 isRequired: false, // PS1 只需要任意一个区域的 BIOS
                 description: region.displayName,
-                md5Hash: region.md5Hash
+                md5Hash: region.md5Hash,
+                validation: isInstalled ? validateBIOSFile(region.rawValue) : nil
             ))
         }
         
@@ -274,6 +294,8 @@ final class BIOSManager: ObservableObject {
             if FileManager.default.fileExists(atPath: targetURL.path) {
                 try FileManager.default.removeItem(at: targetURL)
             }
+            // 复制会保留修改时间，同名同大小的新文件不能沿用旧的哈希
+            hashCache.remove(fileAt: targetURL)
             
             // 复制文件
             try FileManager.default.copyItem(at: sourceURL, to: targetURL)
@@ -281,11 +303,11 @@ final class BIOSManager: ObservableObject {
             // 刷新状态
             refreshBIOSStatus()
             
-            print("📀 BIOSManager: 已导入 BIOS 文件 - \(fileName)")
+            Log.bios.info("已导入 BIOS 文件 - \(fileName)")
             return .success(fileName)
             
         } catch {
-            print("❌ BIOSManager: 导入 BIOS 文件失败 - \(error)")
+            Log.bios.error("导入 BIOS 文件失败 - \(error)")
             return .failure(.copyFailed(error.localizedDescription))
         }
     }
@@ -299,16 +321,18 @@ final class BIOSManager: ObservableObject {
         
         do {
             try FileManager.default.removeItem(at: fileURL)
+            hashCache.remove(fileAt: fileURL)
             refreshBIOSStatus()
-            print("📀 BIOSManager: 已删除 BIOS 文件 - \(fileName)")
+            Log.bios.info("已删除 BIOS 文件 - \(fileName)")
             return true
         } catch {
-            print("❌ BIOSManager: 删除 BIOS 文件失败 - \(error)")
+            Log.bios.error("删除 BIOS 文件失败 - \(error)")
             return false
         }
     }
     
     /// 验证 BIOS 文件的 MD5 哈希值
+    /// 哈希按 (路径, 大小, 修改时间) 缓存，文件未变化时只需一次 stat
     /// - Parameter fileName: 文件名
     /// - Returns: 验证结果
     func validateBIOSFile(_ fileName: String) -> BIOSValidationResult {
@@ -318,14 +342,11 @@ final class BIOSManager: ObservableObject {
             return .notFound
         }
         
-        guard let data = try? Data(contentsOf: fileURL) else {
-            return .readError
-        }
-        
-        let computedHash = md5Hash(data: data)
-        
         // 检查是否为已知的 PS1 BIOS
         if let region = PS1BIOSRegion.allCases.first(where: { $0.rawValue.lowercased() == fileName.lowercased() }) {
+            guard let computedHash = (try? hashCache.hash(fileAt: fileURL))?.md5String else {
+                return .readError
+            }
             if computedHash == region.md5Hash {
                 return .valid
             } else {
@@ -348,9 +369,9 @@ final class BIOSManager: ObservableObject {
                     withIntermediateDirectories: true,
                     attributes: nil
                 )
-                print("📀 BIOSManager: 已创建 BIOS 目录")
+                Log.bios.debug("已创建 BIOS 目录")
             } catch {
-                print("❌ BIOSManager: 创建 BIOS 目录失败 - \(error)")
+                Log.bios.error("创建 BIOS 目录失败 - \(error)")
             }
         }
     }
@@ -371,16 +392,16 @@ final class BIOSManager: ObservableObject {
                 withExtension: "bin",
                 subdirectory: "BIOS"
             ) else {
-                print("⚠️ BIOSManager: 未找到内置 BIOS 文件 - \(biosFile.resource).bin")
+                Log.bios.warning("未找到内置 BIOS 文件 - \(biosFile.resource).bin")
                 continue
             }
             
             // 复制文件
             do {
                 try FileManager.default.copyItem(at: sourceURL, to: targetURL)
-                print("📀 BIOSManager: 已复制 \(biosFile.targetName) (\(biosFile.system))")
+                Log.bios.info("已复制 \(biosFile.targetName) (\(biosFile.system))")
             } catch {
-                print("❌ BIOSManager: 复制 \(biosFile.targetName) 失败 - \(error)")
+                Log.bios.error("复制 \(biosFile.targetName) 失败 - \(error)")
             }
         }
     }
@@ -472,15 +493,6 @@ final class BIOSManager: ObservableObject {
         
         return false
     }
-    
-    /// 计算数据的 MD5 哈希值
-    private func md5Hash(data: Data) -> String {
-        var digest = [UInt8](repeating: 0, count: Int(CC_MD5_DIGEST_LENGTH))
-        _ = data.withUnsafeBytes { buffer in
-            CC_MD5(buffer.baseAddress, CC_LONG(data.count), &digest)
-        }
-        return digest.map { String(format: "%02hhx", $0) }.joined()
-    }
 }
 
 // MARK: - BIOS 导入错误
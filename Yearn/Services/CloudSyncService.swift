@@ -7,6 +7,8 @@
 
 import Foundation
 import CloudKit
+import UIKit
+import YearnCore
 
 // MARK: - Cloud Sync Service
 
@@ -21,11 +23,25 @@ class CloudSyncService: ObservableObject {
     @Published var lastSyncDate: Date?
     @Published var syncError: Error?
     @Published var isCloudAvailable = false
+    /// What the last sync transferred
+    @Published var lastSyncReport: SyncEngine.Statistics?
+    
+    /// How to settle a file changed on this device and another since the last sync
+    var conflictPolicy: SyncEngine.ConflictPolicy = .keepBoth
     
     // MARK: - Private Properties
     
     private let fileManager = FileManager.default
+    private let userDefaults = UserDefaults.standard
     private let containerIdentifier = "iCloud.com.yearn.emulator"
+    private var engines: [String: SyncEngine] = [:]
+    private var backend: UbiquitousBackend?
+    
+    /// Set once the files of the old whole-file sync are in the local directories
+    private let legacyImportKey = "CloudSyncLegacyImportDone"
+    private let lastCollectionKey = "CloudSyncLastChunkCollection"
+    /// How often chunks no manifest refers to are deleted
+    private let collectionInterval: TimeInterval = 7 * 24 * 60 * 60
     
     private var ubiquityContainerURL: URL? {
         fileManager.url(forUbiquityContainerIdentifier: containerIdentifier)
@@ -61,10 +77,19 @@ class CloudSyncService: ObservableObject {
         defer { isSyncing = false }
         
         do {
-            try await syncSaveStates()
-            try await syncGameSaves()
+            await importLegacyCloudFiles()
+            var report = try await syncSaveStates()
+            let saves = try await syncGameSaves()
+            report.bytesUploaded += saves.bytesUploaded
+            report.bytesDownloaded += saves.bytesDownloaded
+            report.filesUploaded += saves.filesUploaded
+            report.filesDownloaded += saves.filesDownloaded
+            report.conflicts += saves.conflicts
+            Log.sync.info("Synced: \(report.filesUploaded) up (\(report.bytesUploaded) bytes), \(report.filesDownloaded) down (\(report.bytesDownloaded) bytes), \(report.conflicts) conflict(s)")
+            lastSyncReport = report
             lastSyncDate = Date()
             syncError = nil
+            await collectGarbageIfDue()
         } catch {
             syncError = error
             throw error
@@ -72,34 +97,15 @@ class CloudSyncService: ObservableObject {
     }
     
     /// Sync save states
-    func syncSaveStates() async throws {
-        guard let cloudURL = documentsURL?.appendingPathComponent("SaveStates") else {
-            throw CloudSyncError.containerNotFound
-        }
-        
-        // Create cloud directory if needed
-        try createDirectoryIfNeeded(at: cloudURL)
-        
-        // Get local save states directory
-        let localURL = getLocalSaveStatesURL()
-        
-        // Sync bidirectionally
-        try await syncDirectory(from: localURL, to: cloudURL)
-        try await syncDirectory(from: cloudURL, to: localURL)
+    @discardableResult
+    func syncSaveStates() async throws -> SyncEngine.Statistics {
+        try await engine(named: "SaveStates", directory: getLocalSaveStatesURL()).sync()
     }
     
     /// Sync game saves (battery saves)
-    func syncGameSaves() async throws {
-        guard let cloudURL = documentsURL?.appendingPathComponent("GameSaves") else {
-            throw CloudSyncError.containerNotFound
-        }
-        
-        try createDirectoryIfNeeded(at: cloudURL)
-        
-        let localURL = getLocalGameSavesURL()
-        
-        try await syncDirectory(from: localURL, to: cloudURL)
-        try await syncDirectory(from: cloudURL, to: localURL)
+    @discardableResult
+    func syncGameSaves() async throws -> SyncEngine.Statistics {
+        try await engine(named: "GameSaves", directory: getLocalGameSavesURL()).sync()
     }
     
     /// Upload a specific file to iCloud
@@ -133,7 +139,7 @@ class CloudSyncService: ObservableObject {
         try fileManager.startDownloadingUbiquitousItem(at: cloudURL)
         
         // Wait for download to complete
-        try await waitForDownload(at: cloudURL)
+        try await Self.waitForDownload(at: cloudURL)
         
         // Copy to local
         let parentDir = localURL.deletingLastPathComponent()
@@ -193,45 +199,98 @@ class CloudSyncService: ObservableObject {
         return documentsURL.appendingPathComponent("GameSaves")
     }
     
-    private func syncDirectory(from source: URL, to destination: URL) async throws {
-        guard fileManager.fileExists(atPath: source.path) else { return }
+    /// The chunk store in iCloud Documents/Sync, shared by every engine
+    private func syncBackend() throws -> UbiquitousBackend {
+        if let backend {
+            return backend
+        }
+        guard let cloudURL = documentsURL?.appendingPathComponent("Sync") else {
+            throw CloudSyncError.containerNotFound
+        }
+        let backend = UbiquitousBackend(store: try LocalDirectoryBackend(root: cloudURL))
+        self.backend = backend
+        return backend
+    }
+    
+    /// The engine syncing `directory` with the chunk store in iCloud Documents/Sync
+    private func engine(named name: String, directory: URL) throws -> SyncEngine {
+        if let engine = engines[name] {
+            engine.conflictPolicy = conflictPolicy
+            return engine
+        }
         
-        let contents = try fileManager.contentsOfDirectory(
-            at: source,
-            includingPropertiesForKeys: [.contentModificationDateKey],
-            options: [.skipsHiddenFiles]
-        )
+        let stateURL = fileManager.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("CloudSync")
+        let backend = try syncBackend()
+        let engine = SyncEngine(name: name, directory: directory, backend: backend, stateDirectory: stateURL)
+        engine.conflictPolicy = conflictPolicy
+        engine.deviceName = UIDevice.current.name
+        engines[name] = engine
+        return engine
+    }
+    
+    /// Copy what the old whole-file sync left in iCloud Documents/SaveStates and
+    /// Documents/GameSaves into the local directories, so the engines upload it
+    ///
+    /// Runs until one pass gets every file. A file on both sides keeps the
+    /// newer copy, as the old sync did.
+    private func importLegacyCloudFiles() async {
+        guard !userDefaults.bool(forKey: legacyImportKey), let documentsURL else { return }
         
-        for sourceFile in contents {
-            let fileName = sourceFile.lastPathComponent
-            let destFile = destination.appendingPathComponent(fileName)
+        var complete = true
+        var imported = 0
+        for (folder, localURL) in [("SaveStates", getLocalSaveStatesURL()), ("GameSaves", getLocalGameSavesURL())] {
+            let legacyURL = documentsURL.appendingPathComponent(folder, isDirectory: true)
+            let root = legacyURL.standardizedFileURL.path
+            let keys: [URLResourceKey] = [.isRegularFileKey, .contentModificationDateKey]
+            guard let enumerator = fileManager.enumerator(at: legacyURL, includingPropertiesForKeys: keys,
+                                                          options: [.skipsHiddenFiles]) else { continue }
             
-            // Check if we should copy
-            if shouldCopyFile(from: sourceFile, to: destFile) {
-                if fileManager.fileExists(atPath: destFile.path) {
-                    try fileManager.removeItem(at: destFile)
+            for case let cloudURL as URL in enumerator {
+                guard (try? cloudURL.resourceValues(forKeys: [.isRegularFileKey]))?.isRegularFile == true else { continue }
+                let path = String(cloudURL.standardizedFileURL.path.dropFirst(root.count + 1))
+                let destination = localURL.appendingPathComponent(path)
+                do {
+                    try fileManager.startDownloadingUbiquitousItem(at: cloudURL)
+                    try await Self.waitForDownload(at: cloudURL)
+                    let cloudDate = try cloudURL.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate
+                    if fileManager.fileExists(atPath: destination.path) {
+                        let localDate = try destination.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate
+                        guard let cloudDate, cloudDate > (localDate ?? .distantPast) else { continue }
+                        try fileManager.removeItem(at: destination)
+                    }
+                    try createDirectoryIfNeeded(at: destination.deletingLastPathComponent())
+                    try fileManager.copyItem(at: cloudURL, to: destination)
+                    imported += 1
+                } catch {
+                    complete = false
+                    Log.sync.warning("Could not import \(folder)/\(path) from the old iCloud layout: \(error.localizedDescription)")
                 }
-                try fileManager.copyItem(at: sourceFile, to: destFile)
             }
         }
+        
+        if complete {
+            userDefaults.set(true, forKey: legacyImportKey)
+        }
+        if imported > 0 {
+            Log.sync.info("Imported \(imported) file(s) from the old iCloud layout")
+        }
     }
     
-    private func shouldCopyFile(from source: URL, to destination: URL) -> Bool {
-        // If destination doesn't exist, copy
-        guard fileManager.fileExists(atPath: destination.path) else {
-            return true
-        }
-        
-        // Compare modification dates
-        guard let sourceDate = try? fileManager.attributesOfItem(atPath: source.path)[.modificationDate] as? Date,
-              let destDate = try? fileManager.attributesOfItem(atPath: destination.path)[.modificationDate] as? Date else {
-            return true
+    /// Delete chunks no manifest refers to any more, at most once per `collectionInterval`
+    private func collectGarbageIfDue() async {
+        let last = userDefaults.object(forKey: lastCollectionKey) as? Date ?? .distantPast
+        guard Date().timeIntervalSince(last) >= collectionInterval,
+              let backend = try? syncBackend() else { return }
+        do {
+            try await SyncEngine.collectGarbage(in: backend)
+            userDefaults.set(Date(), forKey: lastCollectionKey)
+        } catch {
+            Log.sync.warning("Chunk collection failed: \(error.localizedDescription)")
         }
-        
-        return sourceDate > destDate
     }
     
-    private func waitForDownload(at url: URL, timeout: TimeInterval = 30) async throws {
+    fileprivate nonisolated static func waitForDownload(at url: URL, timeout: TimeInterval = 30) async throws {
         let startTime = Date()
         
         while true {
@@ -252,6 +311,73 @@ class CloudSyncService: ObservableObject {
     }
 }
 
+// MARK: - Ubiquitous Backend
+
+/// Chunk store in the iCloud container, fetching items iCloud has not downloaded yet
+private struct UbiquitousBackend: SyncBackend {
+    let store: LocalDirectoryBackend
+    
+    func manifest(named name: String) async throws -> SyncManifest? {
+        let url = store.manifestURL(named: name)
+        try await fetch(url)
+        try resolveConflicts(at: url)
+        return try await store.manifest(named: name)
+    }
+    
+    func storeManifest(_ manifest: SyncManifest, named name: String, replacing expectedVersion: UInt64) async throws {
+        try await store.storeManifest(manifest, named: name, replacing: expectedVersion)
+    }
+    
+    func missingChunks(_ hashes: Set<String>) async throws -> Set<String> {
+        // Chunks another device uploaded may not be downloaded here; they still count
+        hashes.filter { !exists(store.chunkURL(for: $0)) }
+    }
+    
+    func uploadChunk(_ data: Data, hash: String) async throws {
+        guard !exists(store.chunkURL(for: hash)) else { return }
+        try await store.uploadChunk(data, hash: hash)
+    }
+    
+    func downloadChunk(_ hash: String) async throws -> Data {
+        try await fetch(store.chunkURL(for: hash))
+        return try await store.downloadChunk(hash)
+    }
+    
+    func manifestNames() async throws -> [String] {
+        try await store.manifestNames()
+    }
+    
+    func listChunks() async throws -> [String: Date] {
+        try await store.listChunks()
+    }
+    
+    func deleteChunk(_ hash: String) async throws {
+        try await store.deleteChunk(hash)
+    }
+    
+    /// Two devices that stored the manifest at once leave iCloud holding one
+    /// copy and the other as a conflict version; keep the current one and say so
+    private func resolveConflicts(at url: URL) throws {
+        guard let conflicts = NSFileVersion.unresolvedConflictVersionsOfItem(at: url), !conflicts.isEmpty else { return }
+        for version in conflicts {
+            version.isResolved = true
+        }
+        try NSFileVersion.removeOtherVersionsOfItem(at: url)
+        throw SyncError.manifestDiverged
+    }
+    
+    private func exists(_ url: URL) -> Bool {
+        if FileManager.default.fileExists(atPath: url.path) { return true }
+        return (try? url.resourceValues(forKeys: [.isUbiquitousItemKey]))?.isUbiquitousItem == true
+    }
+    
+    private func fetch(_ url: URL) async throws {
+        guard (try? url.resourceValues(forKeys: [.isUbiquitousItemKey]))?.isUbiquitousItem == true else { return }
+        try FileManager.default.startDownloadingUbiquitousItem(at: url)
+        try await CloudSyncService.waitForDownload(at: url)
+    }
+}
+
 // MARK: - Cloud Sync Error
 
 enum CloudSyncError: LocalizedError {
@@ -153,7 +153,7 @@ class CoreManager: ObservableObject {
             coreCache[core.id] = core
         }
         
-        print("Found \(foundCores.count) cores")
+        Log.core.info("Found \(foundCores.count) cores")
     }
     
     /// Get core for a specific system
@@ -179,7 +179,7 @@ class CoreManager: ObservableObject {
         if let staticCore = StaticCoreRegistry.shared.getCore(identifier: core.name) {
             // Use static core
             loadedCore = core
-            print("Loaded static core: \(staticCore.name)")
+            Log.core.debug("Loaded static core: \(staticCore.name)")
             return
         }
         
@@ -189,7 +189,7 @@ class CoreManager: ObservableObject {
         }
         
         loadedCore = core
-        print("Loaded dynamic core: \(core.name)")
+        Log.core.debug("Loaded dynamic core: \(core.name)")
     }
     
     /// Check if using static cores
@@ -272,7 +272,7 @@ class CoreManager: ObservableObject {
                 }
             }
         } catch {
-            print("Error scanning directory: \(error)")
+            Log.core.error("Error scanning directory: \(error)")
         }
         
         return cores
@@ -437,7 +437,7 @@ struct CoreListView: View {
                     }
                 }
             case .failure(let error):
-                print("Import error: \(error)")
+                Log.core.error("Import error: \(error)")
             }
         }
         .task {
@@ -0,0 +1,512 @@
+//
+//  CoverImageCache.swift
+//  Yearn
+//
+//  Cover thumbnails decoded at display size, with a memory and a disk tier
+//
+
+import UIKit
+import ImageIO
+import UniformTypeIdentifiers
+import YearnCore
+
+/// Cover thumbnails for the library and detail views
+///
+/// Covers are decoded straight to the requested pixel size with ImageIO, so a
+/// full-size box art never exists in memory as a bitmap. Thumbnails are kept
+/// in a cost-bounded LRU memory tier and as small JPEGs in one
+/// `ThumbnailAtlas` per pixel size under `Caches/CoverAtlas/`, so later
+/// launches skip the full-size decode and read each cover out of a single
+/// mapped file instead of opening one file per cover. Decoding runs on a background queue; concurrent requests
+/// for the same cover and size share one decode, and a decode that nobody is
+/// waiting for any more is cancelled.
+///
+/// Only local files are read, through `source` (custom covers, then
+/// downloaded artwork); downloading stays with `ArtworkService`.
+final class CoverImageCache: @unchecked Sendable {
+
+    static let shared = CoverImageCache()
+
+    struct Statistics {
+        var memoryHits = 0
+        var diskHits = 0
+        var sourceDecodes = 0
+        var coalesced = 0
+        var misses = 0
+        var decodeTime: TimeInterval = 0
+        var memoryCost = 0
+        var peakMemoryCost = 0
+        /// Latency of the most recent requests, for percentiles
+        fileprivate(set) var latencies: [TimeInterval] = []
+
+        /// 95th percentile request latency, from memory hit to full-size decode
+        var p95Latency: TimeInterval {
+            guard !latencies.isEmpty else { return 0 }
+            let sorted = latencies.sorted()
+            return sorted[min(sorted.count - 1, sorted.count * 95 / 100)]
+        }
+    }
+
+    private struct Key: Hashable {
+        let id: UUID
+        let pixelSize: Int
+    }
+
+    /// One decode and everyone waiting for it
+    private final class Request {
+        let operation = BlockOperation()
+        var waiters: [Int: CheckedContinuation<UIImage?, Never>] = [:]
+    }
+
+    /// Doubly linked LRU entry, most recently used at the head
+    private final class Node {
+        let key: Key
+        let image: UIImage
+        let cost: Int
+        weak var previous: Node?
+        var next: Node?
+
+        init(key: Key, image: UIImage, cost: Int) {
+            self.key = key
+            self.image = image
+            self.cost = cost
+        }
+    }
+
+    // MARK: - Properties
+
+    /// Decoded bytes kept in memory
+    var memoryCostLimit = 48 * 1024 * 1024 {
+        didSet {
+            lock.lock()
+            trimMemory()
+            lock.unlock()
+        }
+    }
+
+    /// Thumbnails kept on disk for each pixel size; set before the first request
+    var maxTilesPerAtlas = ThumbnailAtlas.coverTileLimit
+
+    /// Largest encoded thumbnail; the JPEG quality drops until a cover fits
+    static let tileSize = ThumbnailAtlas.coverSlotSize
+
+    let atlasDirectory: URL
+
+    /// Where full-size covers come from; set before the first request
+    var source: CoverSource = LocalCoverSource.standard
+
+    private let fileManager = FileManager.default
+    private let queue: OperationQueue
+    private let lock = NSLock()
+    private var nodes: [Key: Node] = [:]
+    private var head: Node?
+    private var tail: Node?
+    private var requests: [Key: Request] = [:]
+    /// Games with no local cover, so scrolling past them does not hit the disk again
+    private var missing: Set<UUID> = []
+    private var nextWaiter = 0
+    private var atlases: [Int: ThumbnailAtlas] = [:]
+    private var stats = Statistics()
+    private var memoryRegistration: MemoryBudget.Registration?
+
+    private static let latencySamples = 1000
+
+    // MARK: - Initialization
+
+    private init() {
+        var directoryName = "CoverAtlas"
+#if DEBUG
+        // Stand-in thumbnails live apart, so they never show up in place of real covers
+        if ProcessInfo.processInfo.arguments.contains("-YearnStandInCovers") {
+            source = StandInCoverSource()
+            directoryName += "-StandIn"
+            Log.artwork.info("Using stand-in covers")
+        }
+#endif
+        let cachesURL = fileManager.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        atlasDirectory = cachesURL.appendingPathComponent(directoryName, isDirectory: true)
+        try? fileManager.createDirectory(at: atlasDirectory, withIntermediateDirectories: true)
+
+        queue = OperationQueue()
+        queue.name = "com.yearn.cover-decode"
+        queue.qualityOfService = .userInitiated
+        queue.maxConcurrentOperationCount = max(2, min(ProcessInfo.processInfo.activeProcessorCount, 4))
+
+        // Decoded thumbnails are the first thing to go under memory pressure
+        memoryRegistration = MemoryBudget.shared.register(
+            "Cover thumbnails",
+            tier: .cache,
+            usage: { [weak self] in self?.statistics.memoryCost ?? 0 },
+            shrink: { [weak self] limit in self?.trimMemory(toCost: limit) ?? 0 }
+        )
+
+        // Thumbnails from before the atlas, one file per cover
+        let legacyDirectories = ["CoverThumbnails", "CoverThumbnails-StandIn"]
+            .map { cachesURL.appendingPathComponent($0, isDirectory: true) }
+        queue.addOperation { [fileManager] in
+            for directory in legacyDirectories where fileManager.fileExists(atPath: directory.path) {
+                try? fileManager.removeItem(at: directory)
+            }
+        }
+    }
+
+    // MARK: - Public Methods
+
+    var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Log request latency, hit counts and peak decoded memory since launch,
+    /// e.g. when the grid goes away after a scroll
+    func logStatistics() {
+        let stats = statistics
+        let requests = stats.memoryHits + stats.diskHits + stats.sourceDecodes + stats.coalesced + stats.misses
+        guard requests > 0 else { return }
+        let megabytes = { (bytes: Int) in String(format: "%.1f MB", Double(bytes) / 1_048_576) }
+        Log.artwork.info("Covers: \(requests) requests, p95 \(String(format: "%.0f ms", stats.p95Latency * 1000)); memory \(stats.memoryHits), disk \(stats.diskHits), decoded \(stats.sourceDecodes), coalesced \(stats.coalesced), missing \(stats.misses); peak memory \(megabytes(stats.peakMemoryCost)) (limit \(megabytes(memoryCostLimit)))")
+    }
+
+    /// Memory tier only, so a cell can be filled in the same frame
+    func cachedCover(for id: UUID, maxPixelSize: Int) -> UIImage? {
+        lock.lock()
+        defer { lock.unlock() }
+        return memoryImage(for: Key(id: id, pixelSize: maxPixelSize))
+    }
+
+    /// Thumbnail of a game's cover, no larger than `maxPixelSize` on its long side
+    /// - Returns: nil if the game has no local cover or artwork, or the calling task was cancelled
+    func cover(for id: UUID, maxPixelSize: Int,
+               priority: Operation.QueuePriority = .normal) async -> UIImage? {
+        let start = Date()
+        let key = Key(id: id, pixelSize: maxPixelSize)
+
+        lock.lock()
+        if let image = memoryImage(for: key) {
+            stats.memoryHits += 1
+            recordLatency(since: start)
+            lock.unlock()
+            return image
+        }
+        if missing.contains(id) {
+            stats.misses += 1
+            lock.unlock()
+            return nil
+        }
+        let waiter = nextWaiter
+        nextWaiter += 1
+        lock.unlock()
+
+        let image = await withTaskCancellationHandler {
+            await withCheckedContinuation { continuation in
+                self.enqueue(key, waiter: waiter, priority: priority, continuation: continuation)
+            }
+        } onCancel: {
+            self.cancel(key, waiter: waiter)
+        }
+
+        if image != nil {
+            lock.lock()
+            recordLatency(since: start)
+            lock.unlock()
+        }
+        return image
+    }
+
+    /// Drop every thumbnail of a game after its cover or artwork changed
+    func invalidate(_ id: UUID) {
+        lock.lock()
+        for key in nodes.keys where key.id == id {
+            if let node = nodes[key] {
+                unlink(node)
+            }
+        }
+        missing.remove(id)
+        lock.unlock()
+
+        // Every size on disk, including those not shown since launch
+        for atlas in allAtlases() {
+            atlas.remove(id)
+        }
+    }
+
+    /// Empty the memory tier, and the disk tier too if asked
+    func removeAll(includingDisk: Bool = false) {
+        lock.lock()
+        nodes.removeAll()
+        head = nil
+        tail = nil
+        missing.removeAll()
+        stats.memoryCost = 0
+        if includingDisk {
+            atlases.removeAll()
+        }
+        lock.unlock()
+
+        if includingDisk {
+            try? fileManager.removeItem(at: atlasDirectory)
+            try? fileManager.createDirectory(at: atlasDirectory, withIntermediateDirectories: true)
+        }
+    }
+
+    // MARK: - Requests
+
+    private func enqueue(_ key: Key, waiter: Int, priority: Operation.QueuePriority,
+                         continuation: CheckedContinuation<UIImage?, Never>) {
+        lock.lock()
+        if Task.isCancelled {
+            lock.unlock()
+            continuation.resume(returning: nil)
+            return
+        }
+        if let request = requests[key] {
+            request.waiters[waiter] = continuation
+            if priority.rawValue > request.operation.queuePriority.rawValue {
+                request.operation.queuePriority = priority
+            }
+            stats.coalesced += 1
+            lock.unlock()
+            return
+        }
+
+        let request = Request()
+        request.waiters[waiter] = continuation
+        request.operation.queuePriority = priority
+        requests[key] = request
+        lock.unlock()
+
+        request.operation.addExecutionBlock { [weak self, weak request] in
+            guard let self, let request else { return }
+            let image = self.load(key, isCancelled: { request.operation.isCancelled })
+            self.finish(key, request: request, image: image)
+        }
+        queue.addOperation(request.operation)
+    }
+
+    private func cancel(_ key: Key, waiter: Int) {
+        lock.lock()
+        guard let request = requests[key],
+              let continuation = request.waiters.removeValue(forKey: waiter) else {
+            lock.unlock()
+            return
+        }
+        if request.waiters.isEmpty {
+            request.operation.cancel()
+            requests.removeValue(forKey: key)
+        }
+        lock.unlock()
+        continuation.resume(returning: nil)
+    }
+
+    private func finish(_ key: Key, request: Request, image: UIImage?) {
+        lock.lock()
+        if let image {
+            insert(image, for: key)
+        }
+        var waiters: [CheckedContinuation<UIImage?, Never>] = []
+        // A cancelled request may have been replaced by a new one for the same key
+        if requests[key] === request {
+            requests.removeValue(forKey: key)
+            waiters = Array(request.waiters.values)
+            request.waiters.removeAll()
+        }
+        lock.unlock()
+
+        for waiter in waiters {
+            waiter.resume(returning: image)
+        }
+    }
+
+    // MARK: - Loading
+
+    /// Atlas tile first, then the full-size source, decoded at thumbnail size
+    private func load(_ key: Key, isCancelled: () -> Bool) -> UIImage? {
+        let start = Date()
+        let atlas = self.atlas(for: key.pixelSize)
+
+        if let tile = atlas?.tile(for: key.id),
+           let source = CGImageSourceCreateWithData(tile as CFData, nil),
+           let image = Self.decode(source, maxPixelSize: key.pixelSize) {
+            record { $0.diskHits += 1 }
+            return image
+        }
+
+        guard !isCancelled() else { return nil }
+
+        guard let sourceURL = source.coverURL(for: key.id) else {
+            lock.lock()
+            missing.insert(key.id)
+            stats.misses += 1
+            lock.unlock()
+            return nil
+        }
+
+        let sourceOptions = [kCGImageSourceShouldCache: false] as CFDictionary
+        guard let imageSource = CGImageSourceCreateWithURL(sourceURL as CFURL, sourceOptions),
+              let image = Self.decode(imageSource, maxPixelSize: key.pixelSize) else {
+            Log.artwork.warning("Could not decode cover: \(sourceURL.lastPathComponent)")
+            return nil
+        }
+
+        if let atlas {
+            storeTile(image, for: key.id, in: atlas)
+        }
+        let elapsed = Date().timeIntervalSince(start)
+        record {
+            $0.sourceDecodes += 1
+            $0.decodeTime += elapsed
+        }
+        return image
+    }
+
+    /// Decode an image at no more than `maxPixelSize` on its long side
+    private static func decode(_ source: CGImageSource, maxPixelSize: Int) -> UIImage? {
+        let options = [
+            kCGImageSourceCreateThumbnailFromImageAlways: true,
+            kCGImageSourceCreateThumbnailWithTransform: true,
+            kCGImageSourceShouldCacheImmediately: true,
+            kCGImageSourceThumbnailMaxPixelSize: maxPixelSize
+        ] as CFDictionary
+        guard let image = CGImageSourceCreateThumbnailAtIndex(source, 0, options) else { return nil }
+        return UIImage(cgImage: image)
+    }
+
+    /// Encode a thumbnail as JPEG, lowering the quality until it fits a tile
+    private static func encode(_ image: UIImage, limit: Int) -> Data? {
+        guard let cgImage = image.cgImage else { return nil }
+        for quality in [0.8, 0.6, 0.4] {
+            let data = NSMutableData()
+            guard let destination = CGImageDestinationCreateWithData(data as CFMutableData,
+                                                                     UTType.jpeg.identifier as CFString, 1, nil) else {
+                return nil
+            }
+            let properties = [kCGImageDestinationLossyCompressionQuality: quality] as CFDictionary
+            CGImageDestinationAddImage(destination, cgImage, properties)
+            guard CGImageDestinationFinalize(destination) else { return nil }
+            if data.length <= limit {
+                return data as Data
+            }
+        }
+        return nil
+    }
+
+    // MARK: - Memory Tier
+
+    // Callers hold the lock
+
+    private func memoryImage(for key: Key) -> UIImage? {
+        guard let node = nodes[key] else { return nil }
+        if head !== node {
+            unlink(node)
+            link(node)
+        }
+        return node.image
+    }
+
+    private func insert(_ image: UIImage, for key: Key) {
+        if let old = nodes[key] {
+            unlink(old)
+        }
+        let cost = image.cgImage.map { $0.bytesPerRow * $0.height } ?? 0
+        link(Node(key: key, image: image, cost: cost))
+        trimMemory()
+        stats.peakMemoryCost = max(stats.peakMemoryCost, stats.memoryCost)
+    }
+
+    private func link(_ node: Node) {
+        node.next = head
+        head?.previous = node
+        head = node
+        if tail == nil {
+            tail = node
+        }
+        nodes[node.key] = node
+        stats.memoryCost += node.cost
+    }
+
+    private func unlink(_ node: Node) {
+        node.previous?.next = node.next
+        node.next?.previous = node.previous
+        if head === node { head = node.next }
+        if tail === node { tail = node.previous }
+        node.previous = nil
+        node.next = nil
+        nodes.removeValue(forKey: node.key)
+        stats.memoryCost -= node.cost
+    }
+
+    private func trimMemory() {
+        while stats.memoryCost > memoryCostLimit, let last = tail, last !== head {
+            unlink(last)
+        }
+    }
+
+    /// Drop least recently used thumbnails, the visible ones too, until at most `limit` bytes remain
+    /// - Returns: Bytes still held
+    private func trimMemory(toCost limit: Int) -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        while stats.memoryCost > limit, let last = tail {
+            unlink(last)
+        }
+        return stats.memoryCost
+    }
+
+    private func recordLatency(since start: Date) {
+        stats.latencies.append(Date().timeIntervalSince(start))
+        if stats.latencies.count > Self.latencySamples {
+            stats.latencies.removeFirst(stats.latencies.count - Self.latencySamples)
+        }
+    }
+
+    private func record(_ update: (inout Statistics) -> Void) {
+        lock.lock()
+        update(&stats)
+        lock.unlock()
+    }
+
+    // MARK: - Disk Tier
+
+    /// The atlas for one pixel size, opened on first use
+    private func atlas(for pixelSize: Int) -> ThumbnailAtlas? {
+        lock.lock()
+        defer { lock.unlock() }
+        if let atlas = atlases[pixelSize] {
+            return atlas
+        }
+
+        let url = atlasDirectory.appendingPathComponent("\(pixelSize).atlas")
+        do {
+            let atlas = try ThumbnailAtlas(url: url, slotSize: Self.tileSize)
+            atlas.maxTiles = maxTilesPerAtlas
+            atlases[pixelSize] = atlas
+            return atlas
+        } catch {
+            Log.artwork.warning("Could not open cover atlas \(url.lastPathComponent): \(error)")
+            return nil
+        }
+    }
+
+    /// Every atlas on disk, opening those not used yet
+    private func allAtlases() -> [ThumbnailAtlas] {
+        let names = (try? fileManager.contentsOfDirectory(atPath: atlasDirectory.path)) ?? []
+        let sizes = names.compactMap { name -> Int? in
+            guard name.hasSuffix(".atlas") else { return nil }
+            return Int(name.dropLast(".atlas".count))
+        }
+        return sizes.compactMap { atlas(for: $0) }
+    }
+
+    private func storeTile(_ image: UIImage, for id: UUID, in atlas: ThumbnailAtlas) {
+        guard let data = Self.encode(image, limit: atlas.slotSize) else {
+            Log.artwork.warning("Cover thumbnail too large for the atlas: \(id.uuidString)")
+            return
+        }
+        do {
+            try atlas.store(data, for: id)
+        } catch {
+            Log.artwork.warning("Could not store cover thumbnail: \(error)")
+        }
+    }
+}
@@ -0,0 +1,201 @@
+//
+//  CoverPrefetcher.swift
+//  Yearn
+//
+//  Warms the cover cache ahead of the library grid's visible range
+//
+
+import Foundation
+import YearnCore
+
+/// Prefetches cover thumbnails for the library grid
+///
+/// The grid reports cells as they appear and disappear. From that the
+/// prefetcher tracks the visible range and how fast it moves, and keeps
+/// decodes running for the covers just ahead of it in the scroll direction,
+/// further ahead the faster the scroll. Prefetches for covers that leave the
+/// window (scrolled past, or the fling reversed) are cancelled, which also
+/// cancels their decode in `CoverImageCache` when no cell is waiting on it.
+/// The window never holds more covers than the memory tier can keep, so
+/// prefetched covers are not evicted before they are shown.
+@MainActor
+final class CoverPrefetcher {
+
+    struct Statistics {
+        var prefetched = 0
+        var cancelled = 0
+        /// Cells that appeared with their cover already decoded
+        var readyOnAppear = 0
+        /// How long cells that showed a placeholder waited for their cover
+        fileprivate(set) var placeholderTimes: [TimeInterval] = []
+
+        var p95PlaceholderTime: TimeInterval {
+            guard !placeholderTimes.isEmpty else { return 0 }
+            let sorted = placeholderTimes.sorted()
+            return sorted[min(sorted.count - 1, sorted.count * 95 / 100)]
+        }
+
+        /// Share of cells that never showed a placeholder
+        var readyRatio: Double {
+            let total = readyOnAppear + placeholderTimes.count
+            return total > 0 ? Double(readyOnAppear) / Double(total) : 0
+        }
+    }
+
+    // MARK: - Properties
+
+    /// Cells kept warm ahead of the visible range when scrolling slowly
+    var minimumLookahead = 12
+
+    /// Upper bound on the lookahead during fast flings
+    var maximumLookahead = 120
+
+    /// Seconds of scrolling at the current speed to stay ahead of
+    var leadTime: TimeInterval = 0.75
+
+    /// Cells kept behind the visible range, so a small reversal shows covers at once
+    var trailingMargin = 6
+
+    private(set) var statistics = Statistics()
+
+    private let cache: CoverImageCache
+    private var games: [Game] = []
+    private var pixelSize = 0
+    private var visible: Set<Int> = []
+    private var tasks: [UUID: (token: Int, task: Task<Void, Never>)] = [:]
+    private var nextToken = 0
+
+    /// First visible index when it last changed, for the scroll speed
+    private var leading: (index: Int, time: Date)?
+    /// Cells per second; positive when scrolling towards the end of the list
+    private var velocity: Double = 0
+
+    private static let placeholderSamples = 1000
+
+    // MARK: - Initialization
+
+    init(cache: CoverImageCache = .shared) {
+        self.cache = cache
+    }
+
+    // MARK: - Public Methods
+
+    func cellAppeared(at index: Int, in games: [Game], pixelSize: Int) {
+        self.games = games
+        self.pixelSize = pixelSize
+        visible.insert(index)
+        update()
+    }
+
+    func cellDisappeared(at index: Int) {
+        visible.remove(index)
+        update()
+    }
+
+    /// Report how a cell got its cover: nil if it was ready when the cell
+    /// appeared, otherwise how long the placeholder showed
+    func recordPlaceholder(_ duration: TimeInterval?) {
+        guard let duration else {
+            statistics.readyOnAppear += 1
+            return
+        }
+        statistics.placeholderTimes.append(duration)
+        if statistics.placeholderTimes.count > Self.placeholderSamples {
+            statistics.placeholderTimes.removeFirst(statistics.placeholderTimes.count - Self.placeholderSamples)
+        }
+    }
+
+    /// Cancel every prefetch, e.g. when the grid goes away
+    func stop() {
+        for entry in tasks.values {
+            entry.task.cancel()
+        }
+        statistics.cancelled += tasks.count
+        tasks.removeAll()
+        visible.removeAll()
+        leading = nil
+        velocity = 0
+        logStatistics()
+    }
+
+    // MARK: - Private Methods
+
+    private func logStatistics() {
+        let shown = statistics.readyOnAppear + statistics.placeholderTimes.count
+        guard shown > 0 else { return }
+        Log.artwork.info("Cover prefetch: \(statistics.prefetched) prefetched, \(statistics.cancelled) cancelled; \(String(format: "%.0f%%", statistics.readyRatio * 100)) of \(shown) cells ready on appear, p95 placeholder \(String(format: "%.0f ms", statistics.p95PlaceholderTime * 1000))")
+    }
+
+    private func update() {
+        guard let first = visible.min(), let last = visible.max(), !games.isEmpty else { return }
+        updateVelocity(first: first)
+
+        // As far ahead as the scroll speed asks for, within what the memory tier holds
+        let coverCost = max(1, pixelSize * pixelSize * 4)
+        let capacity = cache.memoryCostLimit / coverCost - visible.count - trailingMargin
+        let wanted = min(maximumLookahead, max(minimumLookahead, Int(abs(velocity) * leadTime)))
+        let ahead = max(0, min(wanted, capacity))
+
+        let forward = velocity >= 0
+        let lower = max(0, first - (forward ? trailingMargin : ahead))
+        let upper = min(games.count - 1, last + (forward ? ahead : trailingMargin))
+        guard lower <= upper else { return }
+
+        // Drop prefetches that left the window
+        let window = Set(games[lower...upper].map(\.id))
+        for (id, entry) in tasks where !window.contains(id) {
+            entry.task.cancel()
+            tasks.removeValue(forKey: id)
+            statistics.cancelled += 1
+        }
+
+        // Start the rest, nearest to the leading edge first
+        let order = forward
+            ? Array(last + 1 ... max(last + 1, upper)) + Array((lower..<first).reversed())
+            : Array((lower..<first).reversed()) + Array(last + 1 ... max(last + 1, upper))
+        for index in order where index >= lower && index <= upper && !visible.contains(index) {
+            prefetch(games[index].id)
+        }
+    }
+
+    private func updateVelocity(first: Int) {
+        let now = Date()
+        guard let previous = leading else {
+            leading = (first, now)
+            return
+        }
+        let elapsed = now.timeIntervalSince(previous.time)
+        guard first != previous.index else {
+            // Settled: no new row for a while
+            if elapsed > 0.3 { velocity = 0 }
+            return
+        }
+        if elapsed > 0 {
+            let instant = Double(first - previous.index) / elapsed
+            velocity = elapsed > 0.3 ? instant : velocity * 0.6 + instant * 0.4
+        }
+        leading = (first, now)
+    }
+
+    private func prefetch(_ id: UUID) {
+        guard tasks[id] == nil,
+              cache.cachedCover(for: id, maxPixelSize: pixelSize) == nil else { return }
+
+        let token = nextToken
+        nextToken += 1
+        let cache = self.cache
+        let pixelSize = self.pixelSize
+        let task = Task(priority: .utility) { [weak self] in
+            _ = await cache.cover(for: id, maxPixelSize: pixelSize, priority: .low)
+            self?.finished(id, token: token)
+        }
+        tasks[id] = (token, task)
+        statistics.prefetched += 1
+    }
+
+    private func finished(_ id: UUID, token: Int) {
+        if tasks[id]?.token == token {
+            tasks.removeValue(forKey: id)
+        }
+    }
+}
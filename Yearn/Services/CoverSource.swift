@@ -0,0 +1,83 @@
+//
+//  CoverSource.swift
+//  Yearn
+//
+//  Where CoverImageCache finds full-size covers
+//
+
+import UIKit
+
+/// Provides the full-size image a cover thumbnail is decoded from
+protocol CoverSource: Sendable {
+    /// Local file holding the game's cover, or nil if it has none
+    func coverURL(for id: UUID) -> URL?
+}
+
+/// Custom covers from `CoverManager`, then artwork downloaded by `ArtworkService`
+struct LocalCoverSource: CoverSource {
+    let directories: [URL]
+
+    static let standard: LocalCoverSource = {
+        let documentsURL = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+        return LocalCoverSource(directories: [
+            documentsURL.appendingPathComponent("Covers", isDirectory: true),
+            documentsURL.appendingPathComponent("Artwork", isDirectory: true)
+        ])
+    }()
+
+    func coverURL(for id: UUID) -> URL? {
+        directories
+            .map { $0.appendingPathComponent("\(id.uuidString).jpg") }
+            .first { FileManager.default.fileExists(atPath: $0.path) }
+    }
+}
+
+/// Synthetic box art rendered on first use, so the cover cache and the grid
+/// prefetcher can be exercised offline with thousands of games
+///
+/// Enabled in debug builds with the `-YearnStandInCovers` launch argument.
+struct StandInCoverSource: CoverSource {
+    let directory: URL
+    /// Full-size cover dimensions, like a scanned box
+    var size = CGSize(width: 1000, height: 1400)
+
+    init(directory: URL = FileManager.default.temporaryDirectory
+            .appendingPathComponent("StandInCovers", isDirectory: true)) {
+        self.directory = directory
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    func coverURL(for id: UUID) -> URL? {
+        let url = directory.appendingPathComponent("\(id.uuidString).jpg")
+        if FileManager.default.fileExists(atPath: url.path) {
+            return url
+        }
+
+        // Colours derived from the ID, so each game keeps its cover across launches
+        let bytes = withUnsafeBytes(of: id.uuid) { Array($0) }
+        let top = UIColor(red: CGFloat(bytes[0]) / 255, green: CGFloat(bytes[1]) / 255,
+                          blue: CGFloat(bytes[2]) / 255, alpha: 1)
+        let bottom = UIColor(red: CGFloat(bytes[3]) / 255, green: CGFloat(bytes[4]) / 255,
+                             blue: CGFloat(bytes[5]) / 255, alpha: 1)
+
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        let image = UIGraphicsImageRenderer(size: size, format: format).image { context in
+            let colors = [top.cgColor, bottom.cgColor] as CFArray
+            if let gradient = CGGradient(colorsSpace: CGColorSpaceCreateDeviceRGB(), colors: colors, locations: nil) {
+                context.cgContext.drawLinearGradient(gradient, start: .zero,
+                                                     end: CGPoint(x: 0, y: size.height), options: [])
+            }
+            let label = String(id.uuidString.prefix(8)) as NSString
+            label.draw(at: CGPoint(x: 60, y: size.height / 2 - 60),
+                       withAttributes: [.font: UIFont.boldSystemFont(ofSize: 120),
+                                        .foregroundColor: UIColor.white])
+        }
+
+        guard let data = image.jpegData(compressionQuality: 0.9),
+              (try? data.write(to: url, options: .atomic)) != nil else {
+            return nil
+        }
+        return url
+    }
+}
@@ -7,6 +7,7 @@
 
 import Foundation
 import SwiftData
+import YearnCore
 
 // MARK: - Game Entity
 
@@ -170,7 +171,7 @@ class GameDatabaseService: ObservableObject {
             loadGames()
             isLoaded = true
         } catch {
-            print("Failed to setup database: \(error)")
+            Log.database.error("Failed to setup database: \(error)")
         }
     }
     
@@ -186,7 +187,7 @@ class GameDatabaseService: ObservableObject {
         do {
             games = try context.fetch(descriptor)
         } catch {
-            print("Failed to fetch games: \(error)")
+            Log.database.error("Failed to fetch games: \(error)")
         }
     }
     
@@ -220,18 +221,19 @@ class GameDatabaseService: ObservableObject {
         loadGames()
     }
     
+    /// Play events go to the play journal rather than a context save (and CloudKit sync) each
     func updateLastPlayed(for gameID: UUID) {
-        guard let game = games.first(where: { $0.id == gameID }) else { return }
-        
-        game.lastPlayed = Date()
-        saveContext()
+        PlayJournal.shared?.recordLaunch(of: gameID)
     }
     
     func updatePlayTime(for gameID: UUID, additionalTime: TimeInterval) {
-        guard let game = games.first(where: { $0.id == gameID }) else { return }
-        
-        game.playTime += additionalTime
-        saveContext()
+        PlayJournal.shared?.record(PlayJournal.Session(
+            gameID: gameID,
+            start: Date().addingTimeInterval(-additionalTime),
+            duration: additionalTime,
+            frames: 0,
+            averageFPS: 0
+        ))
     }
     
     func toggleFavorite(for gameID: UUID) {
@@ -255,7 +257,7 @@ class GameDatabaseService: ObservableObject {
         do {
             return try context.fetch(descriptor)
         } catch {
-            print("Failed to fetch save states: \(error)")
+            Log.database.error("Failed to fetch save states: \(error)")
             return []
         }
     }
@@ -293,7 +295,7 @@ class GameDatabaseService: ObservableObject {
         do {
             return try context.fetch(descriptor)
         } catch {
-            print("Failed to fetch cheats: \(error)")
+            Log.database.error("Failed to fetch cheats: \(error)")
             return []
         }
     }
@@ -348,7 +350,7 @@ class GameDatabaseService: ObservableObject {
         do {
             try context.save()
         } catch {
-            print("Failed to save context: \(error)")
+            Log.database.error("Failed to save context: \(error)")
         }
     }
 }
@@ -8,6 +8,7 @@
 import UIKit
 import AVKit
 import SwiftUI
+import YearnCore
 
 /// Manages external display connections (AirPlay, HDMI, USB-C)
 @MainActor
@@ -166,7 +167,7 @@ class ExternalDisplayManager: ObservableObject {
         externalWindow = window
         externalViewController = viewController
         
-        print("External display connected: \(screen.bounds.size)")
+        Log.video.info("External display connected: \(screen.bounds.size)")
     }
     
     private func teardownExternalDisplay() {
@@ -176,7 +177,7 @@ class ExternalDisplayManager: ObservableObject {
         externalScreen = nil
         isExternalDisplayConnected = false
         
-        print("External display disconnected")
+        Log.video.info("External display disconnected")
     }
     
     private func updateExternalDisplayLayout(for screen: UIScreen) {
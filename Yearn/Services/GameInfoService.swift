@@ -6,6 +6,7 @@
 //
 
 import Foundation
+import YearnCore
 
 // MARK: - Game Info Result (for GameDetailView)
 
@@ -57,6 +58,26 @@ struct GameInfo: Codable, Identifiable {
     }
 }
 
+extension GameInfo {
+    /// Info from an offline DAT match; only the title, region and serial are known
+    init(datMatch match: DATMatch) {
+        self.init(
+            id: match.serial ?? String(format: "%08X", match.crc32),
+            name: match.title,
+            description: nil,
+            releaseDate: nil,
+            developer: nil,
+            publisher: nil,
+            genre: nil,
+            players: nil,
+            rating: nil,
+            boxArtURL: nil,
+            screenshotURLs: nil,
+            region: match.region
+        )
+    }
+}
+
 // MARK: - Game Info Service
 
 @MainActor
@@ -76,8 +97,10 @@ class GameInfoService: ObservableObject {
     // MARK: - Public Methods
     
     /// Search for game info result (simplified for GameDetailView)
+    /// The canonical DAT title is used for the search when the ROM is identified
     func searchGameInfo(for game: Game) async -> GameInfoResult? {
-        let results = await searchGame(name: game.name, system: game.system)
+        let name = await identify(game)?.name ?? game.name
+        let results = await searchGame(name: name, system: game.system)
         guard let first = results.first else { return nil }
         return GameInfoResult(from: first)
     }
@@ -126,20 +149,19 @@ class GameInfoService: ObservableObject {
         return nil
     }
     
+    /// Identify a ROM by its contents against the local No-Intro/Redump DATs
+    func identify(_ game: Game) async -> GameInfo? {
+        let fileURL = game.fileURL
+        let match = await Task.detached(priority: .utility) {
+            DATIndexStore.shared.identify(fileAt: fileURL)
+        }.value
+        return match.map(GameInfo.init(datMatch:))
+    }
+    
     /// Calculate ROM hash for identification
-    func calculateHash(for fileURL: URL) -> String? {
-        guard let data = try? Data(contentsOf: fileURL) else { return nil }
-        
-        // Use CRC32 for ROM identification (common in databases)
-        var crc: UInt32 = 0xFFFFFFFF
-        for byte in data {
-            crc ^= UInt32(byte)
-            for _ in 0..<8 {
-                crc = (crc >> 1) ^ (crc & 1 != 0 ? 0xEDB88320 : 0)
-            }
-        }
-        
-        return String(format: "%08X", ~crc)
+    /// CRC32 as used by No-Intro/Redump; streamed through mmap, not loaded whole
+    nonisolated func calculateHash(for fileURL: URL) -> String? {
+        try? ROMHasher.hash(fileAt: fileURL, digests: .crc32).crc32String
     }
     
     // MARK: - Private Methods
@@ -162,9 +184,12 @@ class GameInfoService: ObservableObject {
     }
     
     private func performHashLookup(hash: String, system: GameSystem) async throws -> GameInfo? {
-        // In real implementation, this would query a database by ROM hash
-        // Many game databases support CRC32/MD5/SHA1 lookups
-        return nil
+        // CRC32 against the offline DAT index; building the index may parse DATs, so stay off the main actor
+        guard let crc = UInt32(hash, radix: 16) else { return nil }
+        let match = await Task.detached(priority: .utility) {
+            DATIndexStore.shared.lookup(crc32: crc)
+        }.value
+        return match.map(GameInfo.init(datMatch:))
     }
     
     private func getPlatformID(for system: GameSystem) -> Int {
@@ -8,6 +8,7 @@
 import UIKit
 import CoreHaptics
 import SwiftUI
+import YearnCore
 
 // MARK: - Haptic Manager
 
@@ -83,7 +84,7 @@ class HapticManager {
             
             try engine?.start()
         } catch {
-            print("Haptic engine setup failed: \(error)")
+            Log.input.error("Haptic engine setup failed: \(error)")
         }
     }
     
@@ -91,7 +92,7 @@ class HapticManager {
         do {
             try engine?.start()
         } catch {
-            print("Failed to restart haptic engine: \(error)")
+            Log.input.error("Failed to restart haptic engine: \(error)")
         }
     }
     
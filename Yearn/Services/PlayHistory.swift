@@ -0,0 +1,23 @@
+//
+//  PlayHistory.swift
+//  Yearn
+//
+//  The app's play journal
+//
+
+import Foundation
+import YearnCore
+
+extension PlayJournal {
+    /// Launches and play sessions, kept in `Application Support/PlayHistory`
+    /// nil if the journal could not be opened; play history is then not recorded
+    static let shared: PlayJournal? = {
+        let supportURL = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+        do {
+            return try PlayJournal(directory: supportURL.appendingPathComponent("PlayHistory", isDirectory: true))
+        } catch {
+            Log.library.warning("Could not open play journal: \(error)")
+            return nil
+        }
+    }()
+}
@@ -9,67 +9,267 @@ import Foundation
 import CoreSpotlight
 import MobileCoreServices
 import UniformTypeIdentifiers
+import YearnCore
 
 /// Service for managing Spotlight search indexing
-class SpotlightService {
+///
+/// The library is not re-indexed wholesale. A manifest of what was last
+/// submitted (`Caches/SpotlightManifest.plist`) is diffed against the current
+/// games, and only added, changed and removed games are sent, in batches of
+/// `batchSize` at background priority. Each batch ends with the manifest
+/// generation as the index's client state; if the two disagree at the next
+/// launch (the manifest was purged, or the app stopped mid-update) the
+/// domain is dropped and rebuilt once.
+final class SpotlightService: @unchecked Sendable {
     static let shared = SpotlightService()
-    
-    private let searchableIndex = CSSearchableIndex.default()
+
+    struct Statistics {
+        var updates = 0
+        /// Updates that found nothing to submit
+        var unchanged = 0
+        var indexedItems = 0
+        var deletedItems = 0
+        var batches = 0
+        var rebuilds = 0
+    }
+
+    /// What an item was indexed from; a game is resubmitted when this changes
+    struct IndexedAttributes: Codable, Equatable {
+        var name: String
+        var system: String
+        var path: String
+        var size: Int?
+
+        init(_ game: Game) {
+            name = game.name
+            system = game.system.rawValue
+            path = game.fileURL.path
+            size = game.fileSizeBytes
+        }
+    }
+
+    private struct Manifest: Codable {
+        var generation: UInt64 = 0
+        var entries: [String: IndexedAttributes] = [:]
+    }
+
+    // MARK: - Properties
+
+    /// Items submitted per index batch
+    var batchSize = 200
+
+    private let searchableIndex = CSSearchableIndex(name: "com.yearn.games")
     private let domainIdentifier = "com.yearn.games"
-    
+    private let manifestURL = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        .appendingPathComponent("SpotlightManifest.plist")
+
+    private let lock = NSLock()
+    /// Latest library snapshot not yet applied; newer snapshots replace it
+    private var pending: [Game]?
+    private var isUpdating = false
+    /// Loaded and checked against the index's client state on first use
+    private var manifest: Manifest?
+    private var stats = Statistics()
+
+    /// Set once the items indexed in the default index, before the named one, are gone
+    private let defaultIndexClearedKey = "SpotlightDefaultIndexCleared"
+
     private init() {}
-    
+
     // MARK: - Indexing
-    
-    /// Index all games for Spotlight search
-    func indexGames(_ games: [Game]) {
-        let items = games.map { createSearchableItem(for: $0) }
-        
-        searchableIndex.indexSearchableItems(items) { error in
-            if let error = error {
-                print("Spotlight indexing error: \(error.localizedDescription)")
-            }
-        }
+
+    var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
     }
-    
-    /// Index a single game
-    func indexGame(_ game: Game) {
-        let item = createSearchableItem(for: game)
-        
-        searchableIndex.indexSearchableItems([item]) { error in
-            if let error = error {
-                print("Spotlight indexing error: \(error.localizedDescription)")
-            }
+
+    /// Bring the index in line with the full library
+    /// Only games that differ from the manifest are submitted; calls made while
+    /// an update runs are coalesced into one more pass with the latest list.
+    func update(with games: [Game]) {
+        lock.lock()
+        pending = games
+        guard !isUpdating else {
+            lock.unlock()
+            return
         }
-    }
-    
-    /// Remove a game from Spotlight index
-    func removeGame(_ game: Game) {
-        searchableIndex.deleteSearchableItems(withIdentifiers: [game.id.uuidString]) { error in
-            if let error = error {
-                print("Spotlight removal error: \(error.localizedDescription)")
+        isUpdating = true
+        lock.unlock()
+
+        Task.detached(priority: .background) { [self] in
+            while let games = takePending() {
+                await apply(games)
             }
         }
     }
-    
+
     /// Remove all games from Spotlight index
     func removeAllGames() {
+        lock.lock()
+        manifest = Manifest()
+        lock.unlock()
+        try? FileManager.default.removeItem(at: manifestURL)
+
         searchableIndex.deleteSearchableItems(withDomainIdentifiers: [domainIdentifier]) { error in
             if let error = error {
-                print("Spotlight removal error: \(error.localizedDescription)")
+                Log.spotlight.error("Removal error: \(error.localizedDescription)")
             }
         }
     }
-    
+
+    /// Games to submit and identifiers to delete so the index matches `games`
+    static func diff(_ games: [Game], against entries: [String: IndexedAttributes]) -> IndexDiff<Game> {
+        IndexDiff(games, against: entries, identifier: { $0.id.uuidString }, attributes: IndexedAttributes.init)
+    }
+
     // MARK: - Private
-    
+
+    private func takePending() -> [Game]? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let games = pending else {
+            isUpdating = false
+            return nil
+        }
+        pending = nil
+        return games
+    }
+
+    private func apply(_ games: [Game]) async {
+        var manifest = await loadManifest()
+        let diff = Self.diff(games, against: manifest.entries)
+
+        record { $0.updates += 1 }
+        guard !diff.isEmpty else {
+            record { $0.unchanged += 1 }
+            return
+        }
+
+        // Deletions ride along with the first batch
+        var removed = diff.removed
+        var start = 0
+        repeat {
+            let chunk = diff.changed[start..<min(start + batchSize, diff.changed.count)]
+            let items = chunk.map { createSearchableItem(for: $0) }
+            let generation = manifest.generation + 1
+
+            searchableIndex.beginBatch()
+            if !items.isEmpty {
+                searchableIndex.indexSearchableItems(items, completionHandler: nil)
+            }
+            if !removed.isEmpty {
+                searchableIndex.deleteSearchableItems(withIdentifiers: removed, completionHandler: nil)
+            }
+            do {
+                try await searchableIndex.endBatch(withClientState: Self.clientState(generation))
+            } catch {
+                Log.spotlight.error("Indexing error: \(error.localizedDescription)")
+                break
+            }
+
+            for game in chunk {
+                manifest.entries[game.id.uuidString] = IndexedAttributes(game)
+            }
+            for identifier in removed {
+                manifest.entries.removeValue(forKey: identifier)
+            }
+            manifest.generation = generation
+            let deleted = removed.count
+            record {
+                $0.indexedItems += items.count
+                $0.deletedItems += deleted
+                $0.batches += 1
+            }
+            removed = []
+            start += batchSize
+        } while start < diff.changed.count
+
+        lock.lock()
+        self.manifest = manifest
+        lock.unlock()
+        saveManifest(manifest)
+        Log.spotlight.info("\(diff.changed.count) indexed, \(diff.removed.count) removed")
+    }
+
+    /// The manifest, or an empty one (after clearing the domain) if it does not
+    /// match what the index last committed
+    private func loadManifest() async -> Manifest {
+        lock.lock()
+        if let manifest {
+            lock.unlock()
+            return manifest
+        }
+        lock.unlock()
+
+        await clearDefaultIndexOnce()
+        
+        var loaded = Manifest()
+        if let data = try? Data(contentsOf: manifestURL),
+           let decoded = try? PropertyListDecoder().decode(Manifest.self, from: data) {
+            loaded = decoded
+        }
+
+        let committed = (try? await searchableIndex.fetchLastClientState()).flatMap(Self.generation(from:)) ?? 0
+        if committed != loaded.generation {
+            Log.spotlight.info("Manifest is out of date, rebuilding the index")
+            try? await searchableIndex.deleteSearchableItems(withDomainIdentifiers: [domainIdentifier])
+            loaded = Manifest(generation: committed, entries: [:])
+            record { $0.rebuilds += 1 }
+        }
+
+        lock.lock()
+        manifest = loaded
+        lock.unlock()
+        return loaded
+    }
+
+    /// Games used to be indexed in the default index; the named one starts empty,
+    /// so what the default one holds would show up twice
+    private func clearDefaultIndexOnce() async {
+        let defaults = UserDefaults.standard
+        guard !defaults.bool(forKey: defaultIndexClearedKey) else { return }
+        do {
+            try await CSSearchableIndex.default().deleteAllSearchableItems()
+            defaults.set(true, forKey: defaultIndexClearedKey)
+            Log.spotlight.info("Cleared games indexed before the named index")
+        } catch {
+            Log.spotlight.error("Could not clear the default index: \(error.localizedDescription)")
+        }
+    }
+
+    private func saveManifest(_ manifest: Manifest) {
+        let encoder = PropertyListEncoder()
+        encoder.outputFormat = .binary
+        do {
+            try encoder.encode(manifest).write(to: manifestURL, options: .atomic)
+        } catch {
+            Log.spotlight.error("Manifest save error: \(error.localizedDescription)")
+        }
+    }
+
+    private static func clientState(_ generation: UInt64) -> Data {
+        withUnsafeBytes(of: generation.littleEndian) { Data($0) }
+    }
+
+    private static func generation(from state: Data) -> UInt64? {
+        guard state.count == MemoryLayout<UInt64>.size else { return nil }
+        return UInt64(littleEndian: state.withUnsafeBytes { $0.loadUnaligned(as: UInt64.self) })
+    }
+
+    private func record(_ update: (inout Statistics) -> Void) {
+        lock.lock()
+        update(&stats)
+        lock.unlock()
+    }
+
     private func createSearchableItem(for game: Game) -> CSSearchableItem {
         let attributeSet = CSSearchableItemAttributeSet(contentType: .data)
-        
+
         // Basic info
         attributeSet.title = game.name
         attributeSet.contentDescription = "\(game.system.displayName) game"
-        
+
         // Keywords for search
         attributeSet.keywords = [
             game.name,
@@ -80,30 +280,30 @@ class SpotlightService {
             "emulator",
             "retro"
         ]
-        
+
         // Display information
         attributeSet.displayName = game.name
         attributeSet.alternateNames = [game.system.shortName]
-        
+
         // File information
         attributeSet.contentURL = game.fileURL
         if let size = game.fileSizeBytes {
             attributeSet.fileSize = NSNumber(value: size)
         }
-        
+
         // Custom attributes
         attributeSet.creator = game.system.manufacturer
         attributeSet.genre = "Video Game"
-        
+
         let item = CSSearchableItem(
             uniqueIdentifier: game.id.uuidString,
             domainIdentifier: domainIdentifier,
             attributeSet: attributeSet
         )
-        
+
         // Set expiration (never expires)
         item.expirationDate = .distantFuture
-        
+
         return item
     }
 }
@@ -113,7 +313,6 @@ class SpotlightService {
 extension LibraryViewModel {
     /// Update Spotlight index when games change
     func updateSpotlightIndex() {
-        SpotlightService.shared.indexGames(games)
+        SpotlightService.shared.update(with: games)
     }
 }
-
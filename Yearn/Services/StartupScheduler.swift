@@ -0,0 +1,353 @@
+//
+//  StartupScheduler.swift
+//  Yearn
+//
+//  Launch work declared with dependencies and a recorded timeline
+//
+
+import Foundation
+import QuartzCore
+import YearnCore
+
+/// Runs launch work in dependency order and records when each piece ran
+///
+/// Critical tasks are what the first screen reads; `run()` does them on the
+/// main thread before the first body is evaluated. Deferred tasks start on
+/// global queues at their own QoS as soon as their dependencies finish, in
+/// parallel with each other and with the first frames. Code that needs a
+/// deferred task's result awaits `wait(for:)` instead of redoing the work.
+///
+/// Every launch's timeline is kept with the previous ones in Caches, so
+/// time-to-interactive can be compared between cold and warm launches.
+final class StartupScheduler: @unchecked Sendable {
+    static let shared = StartupScheduler()
+
+    struct TaskName: RawRepresentable, Hashable, Codable, ExpressibleByStringLiteral {
+        let rawValue: String
+        init(rawValue: String) { self.rawValue = rawValue }
+        init(stringLiteral value: String) { self.rawValue = value }
+    }
+
+    enum Phase: String, Codable {
+        case critical
+        case deferred
+    }
+
+    enum Milestone: String, Codable {
+        /// `run()` was called, i.e. `main` has been reached
+        case launched
+        /// The first screen is on screen and takes input
+        case interactive
+        /// The first library scan finished
+        case libraryLoaded
+    }
+
+    /// Seconds are measured from process creation, so pre-main time is included
+    struct TaskRecord: Codable {
+        let name: TaskName
+        let phase: Phase
+        let start: TimeInterval
+        let end: TimeInterval
+        let onMainThread: Bool
+    }
+
+    struct Launch: Codable {
+        enum Kind: String, Codable {
+            /// First launch since the device booted
+            case cold
+            case warm
+        }
+
+        var date: Date
+        var kind: Kind
+        /// Launched ahead of time by the system, so pre-main time is not the user's wait
+        var prewarmed: Bool
+        var tasks: [TaskRecord]
+        var milestones: [Milestone: TimeInterval]
+
+        var timeToInteractive: TimeInterval? { milestones[.interactive] }
+    }
+
+    private struct Declaration {
+        let name: TaskName
+        let phase: Phase
+        let qos: DispatchQoS.QoSClass
+        let dependencies: [TaskName]
+        let critical: (@MainActor () -> Void)?
+        let deferred: (@Sendable () -> Void)?
+    }
+
+    /// Launches kept for comparison
+    private static let historyLimit = 20
+
+    private let lock = NSLock()
+    private var declarations: [TaskName: Declaration] = [:]
+    private var order: [TaskName] = []
+    private var started: Set<TaskName> = []
+    private var finished: Set<TaskName> = []
+    private var waiters: [TaskName: [CheckedContinuation<Void, Never>]] = [:]
+    private var records: [TaskRecord] = []
+    private var milestones: [Milestone: TimeInterval] = [:]
+    private var isRecorded = false
+
+    /// `CACurrentMediaTime()` at process creation
+    private let processStart: CFTimeInterval
+    private let historyURL = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        .appendingPathComponent("StartupTimeline.plist")
+
+    private init() {
+        let now = CACurrentMediaTime()
+        if let start = Self.processStartDate() {
+            processStart = now - Date().timeIntervalSince(start)
+        } else {
+            processStart = now
+        }
+    }
+
+    // MARK: - Declaring Tasks
+
+    /// Work the first screen needs; runs on the main thread inside `run()`
+    func addCritical(_ name: TaskName, after dependencies: [TaskName] = [], work: @escaping @MainActor () -> Void) {
+        declare(Declaration(name: name, phase: .critical, qos: .userInteractive,
+                            dependencies: dependencies, critical: work, deferred: nil))
+    }
+
+    /// Work that can finish after the first screen; runs on a global queue at `qos`
+    func addDeferred(_ name: TaskName, qos: DispatchQoS.QoSClass = .utility, after dependencies: [TaskName] = [],
+                     work: @escaping @Sendable () -> Void) {
+        declare(Declaration(name: name, phase: .deferred, qos: qos,
+                            dependencies: dependencies, critical: nil, deferred: work))
+    }
+
+    private func declare(_ declaration: Declaration) {
+        lock.lock()
+        defer { lock.unlock() }
+        assert(started.isEmpty, "Startup task \(declaration.name.rawValue) declared after run()")
+        assert(declarations[declaration.name] == nil, "Startup task \(declaration.name.rawValue) declared twice")
+        declarations[declaration.name] = declaration
+        order.append(declaration.name)
+    }
+
+    // MARK: - Running
+
+    /// Run the critical path now and start the deferred tasks behind it
+    @MainActor
+    func run() {
+        mark(.launched)
+        for declaration in criticalPath() {
+            guard let work = declaration.critical else { continue }
+            let start = now
+            work()
+            complete(declaration.name, phase: .critical, start: start, onMainThread: true)
+        }
+        startReadyTasks()
+    }
+
+    /// Critical tasks with each after its dependencies, in declaration order otherwise
+    private func criticalPath() -> [Declaration] {
+        lock.lock()
+        defer { lock.unlock() }
+
+        for declaration in declarations.values {
+            for dependency in declaration.dependencies {
+                assert(declarations[dependency] != nil, "Startup task \(declaration.name.rawValue) depends on undeclared \(dependency.rawValue)")
+            }
+        }
+
+        var sorted: [TaskName] = []
+        var visiting: Set<TaskName> = []
+        func visit(_ name: TaskName) {
+            guard let declaration = declarations[name], !sorted.contains(name) else { return }
+            assert(declaration.phase == .critical, "Critical startup work depends on deferred task \(name.rawValue)")
+            guard visiting.insert(name).inserted else {
+                assertionFailure("Startup tasks depend on each other through \(name.rawValue)")
+                return
+            }
+            declaration.dependencies.forEach(visit)
+            sorted.append(name)
+        }
+        for name in order where declarations[name]?.phase == .critical {
+            visit(name)
+            started.insert(name)
+        }
+        return sorted.compactMap { declarations[$0] }
+    }
+
+    /// Dispatch every deferred task whose dependencies have all finished
+    private func startReadyTasks() {
+        lock.lock()
+        let ready = order.compactMap { name -> Declaration? in
+            guard let declaration = declarations[name],
+                  declaration.phase == .deferred,
+                  !started.contains(name),
+                  declaration.dependencies.allSatisfy(finished.contains) else { return nil }
+            started.insert(name)
+            return declaration
+        }
+        lock.unlock()
+
+        for declaration in ready {
+            guard let work = declaration.deferred else { continue }
+            DispatchQueue.global(qos: declaration.qos).async { [self] in
+                let start = now
+                work()
+                complete(declaration.name, phase: .deferred, start: start, onMainThread: false)
+                startReadyTasks()
+            }
+        }
+    }
+
+    private func complete(_ name: TaskName, phase: Phase, start: TimeInterval, onMainThread: Bool) {
+        lock.lock()
+        records.append(TaskRecord(name: name, phase: phase, start: start, end: now, onMainThread: onMainThread))
+        finished.insert(name)
+        let resumed = waiters.removeValue(forKey: name) ?? []
+        lock.unlock()
+
+        resumed.forEach { $0.resume() }
+        recordIfComplete()
+    }
+
+    // MARK: - Waiting
+
+    /// Returns once `name` has run; at once if it already has or was never declared
+    func wait(for name: TaskName) async {
+        await withCheckedContinuation { continuation in
+            if !enqueue(continuation, for: name) {
+                continuation.resume()
+            }
+        }
+    }
+
+    /// Whether `name` has run, so code that cannot wait can tell
+    func hasFinished(_ name: TaskName) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return finished.contains(name) || declarations[name] == nil
+    }
+
+    private func enqueue(_ continuation: CheckedContinuation<Void, Never>, for name: TaskName) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        guard declarations[name] != nil, !finished.contains(name) else { return false }
+        waiters[name, default: []].append(continuation)
+        return true
+    }
+
+    // MARK: - Timeline
+
+    /// Record a milestone the first time it is reached this launch
+    func mark(_ milestone: Milestone) {
+        lock.lock()
+        let isNew = milestones[milestone] == nil
+        if isNew {
+            milestones[milestone] = now
+        }
+        lock.unlock()
+
+        if isNew {
+            recordIfComplete()
+        }
+    }
+
+    /// Launches recorded before this one, oldest first
+    func history() -> [Launch] {
+        guard let data = try? Data(contentsOf: historyURL) else { return [] }
+        return (try? PropertyListDecoder().decode([Launch].self, from: data)) ?? []
+    }
+
+    /// Median time-to-interactive of the recorded launches of one kind, prewarmed launches excluded
+    static func medianTimeToInteractive(_ kind: Launch.Kind, in launches: [Launch]) -> TimeInterval? {
+        let times = launches
+            .filter { $0.kind == kind && !$0.prewarmed }
+            .compactMap(\.timeToInteractive)
+            .sorted()
+        guard !times.isEmpty else { return nil }
+        let middle = times.count / 2
+        return times.count % 2 == 0 ? (times[middle - 1] + times[middle]) / 2 : times[middle]
+    }
+
+    /// Save this launch once the first screen is interactive, the library
+    /// has loaded and every declared task has finished
+    private func recordIfComplete() {
+        lock.lock()
+        guard !isRecorded,
+              milestones[.interactive] != nil,
+              milestones[.libraryLoaded] != nil,
+              finished.count == declarations.count else {
+            lock.unlock()
+            return
+        }
+        isRecorded = true
+        let tasks = records.sorted { $0.start < $1.start }
+        let reached = milestones
+        lock.unlock()
+
+        DispatchQueue.global(qos: .utility).async { [self] in
+            var launches = history()
+            let bootDate = Self.bootDate() ?? .distantPast
+            let launch = Launch(
+                date: Date(),
+                kind: launches.contains { $0.date > bootDate } ? .warm : .cold,
+                prewarmed: ProcessInfo.processInfo.environment["ActivePrewarm"] == "1",
+                tasks: tasks,
+                milestones: reached
+            )
+            launches.append(launch)
+            launches = Array(launches.suffix(Self.historyLimit))
+
+            do {
+                let encoder = PropertyListEncoder()
+                encoder.outputFormat = .binary
+                try encoder.encode(launches).write(to: historyURL, options: .atomic)
+            } catch {
+                Log.startup.warning("Could not save startup timeline: \(error)")
+            }
+
+            #if DEBUG
+            report(launch, history: launches)
+            #endif
+        }
+    }
+
+    #if DEBUG
+    private func report(_ launch: Launch, history: [Launch]) {
+        func ms(_ seconds: TimeInterval?) -> String {
+            seconds.map { String(format: "%.0f ms", $0 * 1000) } ?? "-"
+        }
+
+        let criticalTime = launch.tasks.filter { $0.phase == .critical }.reduce(0) { $0 + $1.end - $1.start }
+        Log.startup.info("Startup (\(launch.kind.rawValue)\(launch.prewarmed ? ", prewarmed" : "")): main at \(ms(launch.milestones[.launched])), interactive at \(ms(launch.timeToInteractive)), library at \(ms(launch.milestones[.libraryLoaded])); critical path \(ms(criticalTime)) on main")
+        for task in launch.tasks {
+            Log.startup.debug("\(task.name.rawValue) [\(task.phase.rawValue)\(task.onMainThread ? ", main" : "")] \(ms(task.start)) → \(ms(task.end))")
+        }
+        let cold = history.filter { $0.kind == .cold && !$0.prewarmed }.count
+        let warm = history.filter { $0.kind == .warm && !$0.prewarmed }.count
+        Log.startup.info("Median interactive: cold \(ms(Self.medianTimeToInteractive(.cold, in: history))) over \(cold), warm \(ms(Self.medianTimeToInteractive(.warm, in: history))) over \(warm)")
+    }
+    #endif
+
+    // MARK: - Clock
+
+    /// Seconds since the process was created
+    private var now: TimeInterval {
+        CACurrentMediaTime() - processStart
+    }
+
+    private static func processStartDate() -> Date? {
+        var info = kinfo_proc()
+        var size = MemoryLayout<kinfo_proc>.stride
+        var mib: [Int32] = [CTL_KERN, KERN_PROC, KERN_PROC_PID, getpid()]
+        guard sysctl(&mib, u_int(mib.count), &info, &size, nil, 0) == 0 else { return nil }
+        let start = info.kp_proc.p_starttime
+        return Date(timeIntervalSince1970: TimeInterval(start.tv_sec) + TimeInterval(start.tv_usec) / 1_000_000)
+    }
+
+    private static func bootDate() -> Date? {
+        var boot = timeval()
+        var size = MemoryLayout<timeval>.stride
+        var mib: [Int32] = [CTL_KERN, KERN_BOOTTIME]
+        guard sysctl(&mib, u_int(mib.count), &boot, &size, nil, 0) == 0 else { return nil }
+        return Date(timeIntervalSince1970: TimeInterval(boot.tv_sec) + TimeInterval(boot.tv_usec) / 1_000_000)
+    }
+}
@@ -0,0 +1,72 @@
+//
+//  ViewBodyCounter.swift
+//  Yearn
+//
+//  Debug counts of SwiftUI body evaluations per second
+//
+
+import Foundation
+import QuartzCore
+import YearnCore
+
+/// Counts how often view bodies are evaluated and logs the rate each second
+///
+/// Call from a body as `let _ = ViewBodyCounter.count("Name")`. A second with
+/// no evaluations logs nothing, so a still screen stays quiet;
+/// `beginSession()` and `reportSession(_:)` log the totals over a whole
+/// screen visit instead. Compiles to nothing outside debug builds.
+@MainActor
+enum ViewBodyCounter {
+    #if DEBUG
+    private static var counts: [String: Int] = [:]
+    private static var windowStart = CACurrentMediaTime()
+    private static var totals: [String: Int] = [:]
+    private static var sessionStart = CACurrentMediaTime()
+    #endif
+
+    @inline(__always)
+    static func count(_ view: StaticString) {
+        #if DEBUG
+        let now = CACurrentMediaTime()
+        if now - windowStart >= 1 {
+            report(seconds: now - windowStart)
+            windowStart = now
+        }
+        counts[view.description, default: 0] += 1
+        totals[view.description, default: 0] += 1
+        #endif
+    }
+
+    /// Start counting the totals `reportSession(_:)` logs, e.g. when a screen appears
+    static func beginSession() {
+        #if DEBUG
+        totals.removeAll(keepingCapacity: true)
+        sessionStart = CACurrentMediaTime()
+        #endif
+    }
+
+    /// Log evaluations per view since `beginSession()`, e.g. when the screen goes away
+    static func reportSession(_ screen: String) {
+        #if DEBUG
+        let seconds = CACurrentMediaTime() - sessionStart
+        if !totals.isEmpty && seconds > 0 {
+            let rates = totals
+                .sorted { $0.value > $1.value }
+                .map { "\($0.key) \($0.value) (\(String(format: "%.2f", Double($0.value) / seconds))/s)" }
+            Log.ui.info("\(screen) body evaluations over \(String(format: "%.0f", seconds)) s: \(rates.joined(separator: ", "))")
+        }
+        beginSession()
+        #endif
+    }
+
+    #if DEBUG
+    private static func report(seconds: Double) {
+        guard !counts.isEmpty else { return }
+        let rates = counts
+            .sorted { $0.value > $1.value }
+            .map { "\($0.key) \(String(format: "%.1f", Double($0.value) / seconds))" }
+        Log.ui.debug("Body evaluations/s: \(rates.joined(separator: ", "))")
+        counts.removeAll(keepingCapacity: true)
+    }
+    #endif
+}
@@ -19,13 +19,17 @@ class EmulationViewModel: ObservableObject {
     @Published var isPaused = false
     @Published var isFastForwarding = false
     @Published var errorMessage: String?
-    @Published var currentFPS: Double = 0
-    @Published var frameTexture: MTLTexture?
     @Published var currentScreenshot: UIImage?
+    @Published var extractionProgress: Double?
+    /// Set when a frame hung and came back, or the last run of this game was killed in one
+    @Published var hangRecovery: HangRecoveryOffer?
     
     // Speed settings
     @Published var emulationSpeed: EmulationSpeed = .normal
     
+    /// Per-frame counters and held inputs; sampled by views, never published
+    let frameState = FrameStateStore()
+    
     // Core components
     private var bridge: LibretroBridge?
     private var staticBridge: StaticLibretroBridge?
@@ -36,14 +40,35 @@ class EmulationViewModel: ObservableObject {
     private var audioEngine: AVAudioEngine?
     private var audioPlayerNode: AVAudioPlayerNode?
     
+    /// The running game's buffers, accounted with the memory budget while it runs
+    private var memoryRegistrations: [MemoryBudget.Registration] = []
+    
+    // Hang watchdog, and the auto-save it offers to go back to
+    private var hangWatchdog: HangWatchdog?
+    private var lastAutoSaveTime: CFTimeInterval = 0
+    private let autoSaveInterval: CFTimeInterval = 60
+    
+    #if DEBUG
+    /// `-YearnSimulateHang <seconds>` spins inside one frame ten seconds into play, like a stuck core
+    private var simulatedHangDuration = UserDefaults.standard.double(forKey: "YearnSimulateHang")
+    #endif
+    
     // Frame timing
     private var targetFPS: Double = 60.0
     private var lastFrameTime: CFTimeInterval = 0
     private var frameCount: Int = 0
     private var fpsUpdateTime: CFTimeInterval = 0
+    private var measuredFPS: Double = 0
+    private var totalFrames: UInt64 = 0
     private var framesToSkip: Int = 0
     private var currentFrameSkip: Int = 0
     
+    // Play session, recorded in the play journal when emulation stops
+    private var sessionStart: Date?
+    private var sessionResumedAt: CFTimeInterval?
+    private var sessionPlayTime: TimeInterval = 0
+    private var sessionFrames: Int = 0
+    
     // Video buffer
     private var videoBuffer: UnsafeMutableRawPointer?
     private var videoBufferCapacity: Int = 0
@@ -52,16 +77,10 @@ class EmulationViewModel: ObservableObject {
     private var videoPitch: Int = 0
     private var videoPixelFormat: LibretroPixelFormat = .rgb565
     
-    // Debug: video frame counter
-    private var debugVideoFrameCount: Int = 0
-    
     // Audio buffer
     private var audioBuffer: [Int16] = []
     private var sampleRate: Double = 44100
     
-    // Input state
-    private var inputState: [GameInput: Bool] = [:]
-    
     // Save paths
     private var saveStatePath: URL {
         let documentsPath = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
@@ -73,6 +92,31 @@ class EmulationViewModel: ObservableObject {
         return documentsPath.appendingPathComponent("Saves/\(game.id).sav")
     }
     
+    /// Kept out of Documents, so it is neither synced nor backed up; removed on a clean stop
+    private var autoSavePath: URL {
+        Self.autoSavesPath.appendingPathComponent("\(game.id).state")
+    }
+    
+    private static var autoSavesPath: URL {
+        let supportPath = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+        return supportPath.appendingPathComponent("AutoSaves", isDirectory: true)
+    }
+    
+    /// Where the auto-save used to be written, inside the synced save states
+    private var legacyAutoSavePath: URL {
+        saveStatePath.appendingPathComponent("autosave.state")
+    }
+    
+    /// Hang reports; a game's marker stays until its hang has been dealt with
+    private static var hangReportsPath: URL {
+        let cachesPath = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        return cachesPath.appendingPathComponent("Hangs")
+    }
+    
+    private var pendingHangMarker: URL {
+        Self.hangReportsPath.appendingPathComponent("\(game.id).pending")
+    }
+    
     init(game: Game) {
         self.game = game
         setupDirectories()
@@ -99,9 +143,14 @@ class EmulationViewModel: ObservableObject {
                 startEmulationLoop()
                 isRunning = true
                 isPaused = false
+                beginSession()
+                registerMemory()
+                lastAutoSaveTime = CACurrentMediaTime()
+                startHangWatchdog()
+                offerRecoveryFromLastRun()
             } catch {
                 errorMessage = error.localizedDescription
-                print("Failed to start emulation: \(error)")
+                Log.core.error("Failed to start emulation: \(error)")
             }
         }
     }
@@ -111,10 +160,18 @@ class EmulationViewModel: ObservableObject {
         
         // Save battery RAM before stopping
         saveBatteryRAM()
+        endSession()
         
+        hangWatchdog?.stop()
+        hangWatchdog = nil
         stopEmulationLoop()
         stopAudio()
         
+        // Only a hang that is still unresolved needs the auto-save next time
+        if !FileManager.default.fileExists(atPath: pendingHangMarker.path) {
+            try? FileManager.default.removeItem(at: autoSavePath)
+        }
+        
         if useStaticCore {
             staticBridge?.unloadGame()
             staticBridge?.unloadCore()
@@ -125,6 +182,7 @@ class EmulationViewModel: ObservableObject {
             bridge = nil
         }
         
+        memoryRegistrations.removeAll()
         isRunning = false
         isPaused = false
         useStaticCore = false
@@ -135,6 +193,7 @@ class EmulationViewModel: ObservableObject {
         isPaused = true
         displayLink?.isPaused = true
         audioPlayerNode?.pause()
+        suspendSession()
     }
     
     func resume() {
@@ -142,6 +201,161 @@ class EmulationViewModel: ObservableObject {
         isPaused = false
         displayLink?.isPaused = false
         audioPlayerNode?.play()
+        sessionResumedAt = CACurrentMediaTime()
+    }
+    
+    // MARK: - Memory
+    
+    /// These cannot shrink while the game runs; they are registered so usage shows what is left to reclaim
+    private func registerMemory() {
+        let budget = MemoryBudget.shared
+        memoryRegistrations = [
+            budget.registerAccounting("Video frame") { [weak self] in
+                MainActor.assumeIsolated { self?.videoBufferCapacity ?? 0 }
+            },
+            budget.registerAccounting("Audio queue") { [weak self] in
+                MainActor.assumeIsolated { (self?.audioBuffer.capacity ?? 0) * MemoryLayout<Int16>.size }
+            },
+            budget.registerAccounting("ROM buffer") { [weak self] in
+                MainActor.assumeIsolated { self?.staticBridge?.bufferedROMBytes ?? 0 }
+            },
+        ]
+    }
+    
+    // MARK: - Hang Recovery
+    
+    /// Offer to go back to the auto-save after a frame that did not finish
+    struct HangRecoveryOffer: Identifiable {
+        let id = UUID()
+        /// How long the hung frame took; nil if the last run was killed during it
+        let stalledFor: TimeInterval?
+        let autoSaveDate: Date?
+        
+        var message: String {
+            let cause = stalledFor.map { String(format: "The game stopped responding for %.1f seconds.", $0) }
+                ?? "The game stopped responding the last time it was played."
+            guard let date = autoSaveDate else { return cause }
+            let age = RelativeDateTimeFormatter().localizedString(for: date, relativeTo: Date())
+            return cause + " If it misbehaves, load the auto-save from \(age)."
+        }
+    }
+    
+    /// Watch frames from another thread; the display link runs them on this one
+    private func startHangWatchdog() {
+        let watchdog = HangWatchdog(frameState: frameState, configuration: .init(frameBudget: 1.0 / targetFPS))
+        let directory = Self.hangReportsPath
+        let marker = pendingHangMarker
+        let gameName = game.name
+        
+        // The main thread is stuck in the core and may never return: write everything down here
+        watchdog.onHang = { report in
+            EmulationViewModel.writeHangReport(report, gameName: gameName, to: directory, marker: marker)
+        }
+        watchdog.onRecovered = { [weak self] _, took in
+            Task { @MainActor in
+                self?.offerHangRecovery(stalledFor: took)
+            }
+        }
+        watchdog.start()
+        hangWatchdog = watchdog
+    }
+    
+    private nonisolated static func writeHangReport(_ report: HangWatchdog.Report, gameName: String, to directory: URL, marker: URL) {
+        let fm = FileManager.default
+        try? fm.createDirectory(at: directory, withIntermediateDirectories: true)
+        
+        let stamp = Int(report.detectedAt.timeIntervalSince1970)
+        let url = directory.appendingPathComponent("hang-\(stamp).txt")
+        try? ("Game: \(gameName)\n" + report.text).write(to: url, atomically: true, encoding: .utf8)
+        try? url.lastPathComponent.write(to: marker, atomically: true, encoding: .utf8)
+        Log.core.warning("Frame stuck for \(String(format: "%.2f", report.stalledFor)) s, report written to \(url.lastPathComponent)")
+    }
+    
+    /// The last run of this game was killed while a frame hung
+    private func offerRecoveryFromLastRun() {
+        guard FileManager.default.fileExists(atPath: pendingHangMarker.path) else { return }
+        offerHangRecovery(stalledFor: nil)
+    }
+    
+    private func offerHangRecovery(stalledFor: TimeInterval?) {
+        guard isRunning, hangRecovery == nil else { return }
+        let autoSaveDate = try? FileManager.default.attributesOfItem(atPath: autoSavePath.path)[.modificationDate] as? Date
+        pause()
+        hangRecovery = HangRecoveryOffer(stalledFor: stalledFor, autoSaveDate: autoSaveDate)
+    }
+    
+    func resolveHangRecovery(loadAutoSave: Bool) {
+        hangRecovery = nil
+        try? FileManager.default.removeItem(at: pendingHangMarker)
+        if loadAutoSave {
+            do {
+                try loadState(at: autoSavePath)
+            } catch {
+                errorMessage = error.localizedDescription
+                return
+            }
+        }
+        resume()
+    }
+    
+    /// Keep a recent state to offer after a hang; serialized here, written off the main thread
+    ///
+    /// Serializing runs on the main thread between frames, so its cost goes
+    /// into the frame-time ring as a save-state entry of its own; a hang
+    /// report then shows a slow save as one rather than as a slow core frame.
+    private func autoSaveIfDue(at time: CFTimeInterval) {
+        guard time - lastAutoSaveTime >= autoSaveInterval else { return }
+        lastAutoSaveTime = time
+        
+        let serializeStart = CACurrentMediaTime()
+        let state = useStaticCore ? staticBridge?.saveState() : bridge?.saveState()
+        frameState.record(.saveState, duration: CACurrentMediaTime() - serializeStart)
+        guard let state else { return }
+        let url = autoSavePath
+        let legacyURL = legacyAutoSavePath
+        Task.detached(priority: .utility) {
+            let fm = FileManager.default
+            var directory = url.deletingLastPathComponent()
+            if !fm.fileExists(atPath: directory.path) {
+                try? fm.createDirectory(at: directory, withIntermediateDirectories: true)
+                var values = URLResourceValues()
+                values.isExcludedFromBackup = true
+                try? directory.setResourceValues(values)
+            }
+            try? state.write(to: url, options: .atomic)
+            try? fm.removeItem(at: legacyURL)
+        }
+    }
+    
+    // MARK: - Play Session
+    
+    private func beginSession() {
+        sessionStart = Date()
+        sessionResumedAt = CACurrentMediaTime()
+        sessionPlayTime = 0
+        sessionFrames = 0
+    }
+    
+    /// Stop counting play time while paused
+    private func suspendSession() {
+        if let resumedAt = sessionResumedAt {
+            sessionPlayTime += CACurrentMediaTime() - resumedAt
+        }
+        sessionResumedAt = nil
+    }
+    
+    private func endSession() {
+        suspendSession()
+        guard let start = sessionStart, sessionPlayTime > 0 else { return }
+        sessionStart = nil
+        
+        PlayJournal.shared?.record(PlayJournal.Session(
+            gameID: game.id,
+            start: start,
+            duration: sessionPlayTime,
+            frames: sessionFrames,
+            averageFPS: Double(sessionFrames) / sessionPlayTime
+        ))
     }
     
     // MARK: - Fast Forward
@@ -285,9 +499,9 @@ class EmulationViewModel: ObservableObject {
     // MARK: - Input
     
     func handleInput(_ input: GameInput, pressed: Bool) {
-        inputState[input] = pressed
-        
         let button = input.retroButton
+        frameState.setInput(button.rawValue, pressed: pressed)
+        
         if useStaticCore {
             staticBridge?.setInput(port: 0, button: button, pressed: pressed)
         } else {
@@ -314,8 +528,10 @@ class EmulationViewModel: ObservableObject {
     }
     
     func loadState(from slot: Int) async throws {
-        let url = saveStatePath.appendingPathComponent("slot\(slot).state")
-        
+        try loadState(at: saveStatePath.appendingPathComponent("slot\(slot).state"))
+    }
+    
+    private func loadState(at url: URL) throws {
         if useStaticCore {
             guard let staticBridge = staticBridge else {
                 throw EmulationError.notRunning
@@ -359,65 +575,68 @@ class EmulationViewModel: ObservableObject {
     }
     
     private func loadCore() async throws {
-        print("🎮 Loading core for system: \(game.system.rawValue)")
+        Log.core.debug("Loading core for system: \(game.system.rawValue)")
+        
+        // 核心加载时读取 BIOS 目录，内置 BIOS 须已复制到位
+        await StartupScheduler.shared.wait(for: .bios)
         
         #if STATIC_CORES_ENABLED
         // 使用 StaticLibretroBridge 支持多核心
         // 根据游戏系统选择对应的核心
         let coreIdentifier = getCoreIdentifierForSystem(game.system)
-        print("🎮 Using StaticLibretroBridge (multi-core mode)")
-        print("🎮 Selected core: \(coreIdentifier) for system: \(game.system.rawValue)")
+        Log.core.debug("Using StaticLibretroBridge (multi-core mode)")
+        Log.core.debug("Selected core: \(coreIdentifier) for system: \(game.system.rawValue)")
         
-        // 确保核心已注册
-        registerAllStaticCores()
+        // 核心在启动时由后台任务注册，这里等它完成
+        await StartupScheduler.shared.wait(for: .cores)
         
         // 检查核心是否可用
         guard let coreInfo = StaticCoreRegistry.shared.getCore(identifier: coreIdentifier) else {
-            print("❌ Core not found in registry: \(coreIdentifier)")
+            Log.core.error("Core not found in registry: \(coreIdentifier)")
             throw EmulationError.coreNotFound
         }
         
-        print("🎮 Found core: \(coreInfo.name) for \(coreInfo.systemName)")
+        Log.core.debug("Found core: \(coreInfo.name) for \(coreInfo.systemName)")
         
         staticBridge = StaticLibretroBridge()
         
         do {
             try staticBridge?.loadCore(identifier: coreIdentifier)
-            print("✅ Static core loaded: \(coreInfo.name)")
+            Log.core.info("Static core loaded: \(coreInfo.name)")
             useStaticCore = true
             setupStaticCallbacks()
             return
         } catch {
-            print("❌ Failed to load static core: \(error)")
+            Log.core.error("Failed to load static core: \(error)")
             staticBridge = nil
             throw error
         }
         
         #else
         // Fall back to dynamic core (for simulator/development)
-        print("🎮 Using dynamic core (STATIC_CORES_ENABLED not defined)")
+        Log.core.debug("Using dynamic core (STATIC_CORES_ENABLED not defined)")
         useStaticCore = false
         bridge = LibretroBridge()
         
         // Find the appropriate core for this game system
         guard let corePath = getCorePathForSystem(game.system) else {
-            print("❌ Core not found for system: \(game.system.rawValue)")
+            Log.core.error("Core not found for system: \(game.system.rawValue)")
             throw EmulationError.coreNotFound
         }
         
-        print("🎮 Core path: \(corePath)")
+        Log.core.debug("Core path: \(corePath)")
         
         do {
             try bridge?.loadCore(at: corePath)
-            print("✅ Dynamic core loaded successfully")
+            Log.core.info("Dynamic core loaded successfully")
         } catch {
-            print("❌ Failed to load core: \(error)")
+            Log.core.error("Failed to load core: \(error)")
             throw error
         }
         
         // Setup callbacks
         setupCallbacks()
-        print("✅ Callbacks setup complete")
+        Log.core.debug("Callbacks setup complete")
         #endif
     }
     
@@ -435,83 +654,58 @@ class EmulationViewModel: ObservableObject {
     }
     
     private func loadGame() async throws {
-        print("🎮 Loading game: \(game.name)")
-        print("🎮 Game file URL: \(game.fileURL.path)")
+        Log.core.info("Loading game: \(game.name)")
+        Log.core.debug("Game file URL: \(game.fileURL.path)")
         
         // Verify file exists
         if !FileManager.default.fileExists(atPath: game.fileURL.path) {
-            print("❌ Game file does not exist at: \(game.fileURL.path)")
+            Log.core.error("Game file does not exist at: \(game.fileURL.path)")
             throw EmulationError.gameNotFound
         }
         
-        // For PS1, if loading .img or .bin file, try to find or create accompanying .cue file
         var gameURLToLoad = game.fileURL
-        if game.system == .ps1 {
-            let ext = game.fileURL.pathExtension.lowercased()
-            if ext == "img" || ext == "bin" {
-                let baseName = game.fileURL.deletingPathExtension().lastPathComponent
-                let directory = game.fileURL.deletingLastPathComponent()
-                let cueURL = directory.appendingPathComponent(baseName).appendingPathExtension("cue")
-                
-                if FileManager.default.fileExists(atPath: cueURL.path) {
-                    print("🎮 Found .cue file for \(ext) file, using: \(cueURL.lastPathComponent)")
-                    gameURLToLoad = cueURL
-                } else {
-                    print("⚠️ .cue file not found for \(ext) file.")
-                    
-                    // Check if there's a .ccd file (CloneCD format)
-                    let ccdURL = directory.appendingPathComponent(baseName).appendingPathExtension("ccd")
-                    if FileManager.default.fileExists(atPath: ccdURL.path) {
-                        print("📀 Found .ccd file (CloneCD format). Creating .cue file...")
-                        
-                        // Try to parse .ccd file for track information
-                        var trackMode = "MODE2/2352" // Default for PS1
-                        if let ccdContent = try? String(contentsOf: ccdURL, encoding: .utf8) {
-                            print("📀 Parsing .ccd file...")
-                            // Look for track mode in .ccd file
-                            if ccdContent.contains("MODE=2") {
-                                trackMode = "MODE2/2352"
-                                print("📀 Detected MODE2/2352 (PS1 CD-ROM XA)")
-                            } else if ccdContent.contains("MODE=1") {
-                                trackMode = "MODE1/2352"
-                                print("📀 Detected MODE1/2352 (CD-ROM)")
-                            }
-                        }
-                        
-                        // Create a .cue file for CloneCD .img format
-                        let cueContent = """
-                        FILE "\(game.fileURL.lastPathComponent)" BINARY
-                          TRACK 01 \(trackMode)
-                            INDEX 01 00:00:00
-                        """
-                        
-                        do {
-                            try cueContent.write(to: cueURL, atomically: true, encoding: .utf8)
-                            print("✅ Created .cue file with \(trackMode): \(cueURL.lastPathComponent)")
-                            gameURLToLoad = cueURL
-                        } catch {
-                            print("❌ Failed to create .cue file: \(error)")
-                            print("⚠️ Attempting to load .img directly, may not work correctly.")
-                        }
-                    } else {
-                        print("⚠️ Expected .cue file at: \(cueURL.path)")
-                        print("⚠️ Attempting to load .img directly, may not work correctly.")
-                    }
-                }
+        
+        // ZIP/7z: extract unless the core reads archives itself
+        if ROMArchiveCache.isArchive(gameURLToLoad) {
+            gameURLToLoad = try await resolveArchive(gameURLToLoad)
+        }
+        
+        // Soft patches: a same-named .bps/.ups/.ips next to the ROM is applied at load time
+        if game.system != .ps1, !ROMArchiveCache.isArchive(gameURLToLoad),
+           let patchURL = PatchedROMCache.patch(for: game.fileURL) {
+            let romURL = gameURLToLoad
+            do {
+                gameURLToLoad = try await Task.detached(priority: .userInitiated) {
+                    try PatchedROMCache.shared.apply(patchAt: patchURL, to: romURL)
+                }.value
+                Log.core.info("Loading patched ROM: \(patchURL.lastPathComponent)")
+            } catch {
+                // An unusable patch should not keep the game from starting
+                Log.core.warning("\(error.localizedDescription), loading unpatched ROM")
             }
         }
         
+        // Disc images: find or build a cue sheet, and serve CHD/track reads through the disc cache
+        if game.system == .ps1 && DiscImageLayer.isDiscImage(gameURLToLoad) {
+            let usesVFS = useStaticCore ? (staticBridge?.usesVFS ?? false) : (bridge?.usesVFS ?? false)
+            let discURL = gameURLToLoad
+            gameURLToLoad = await Task.detached(priority: .userInitiated) {
+                DiscImageLayer.shared.prepare(url: discURL, usesVFS: usesVFS)
+            }.value
+            Log.core.info("Loading disc image: \(gameURLToLoad.lastPathComponent)")
+        }
+        
         if useStaticCore {
             guard let staticBridge = staticBridge else {
-                print("❌ Static bridge is nil")
+                Log.core.error("Static bridge is nil")
                 throw EmulationError.notRunning
             }
             
             do {
                 try staticBridge.loadGame(url: gameURLToLoad)
-                print("✅ Game loaded successfully (static)")
+                Log.core.info("Game loaded successfully (static)")
             } catch {
-                print("❌ Failed to load game: \(error)")
+                Log.core.error("Failed to load game: \(error)")
                 throw error
             }
             
@@ -521,21 +715,21 @@ class EmulationViewModel: ObservableObject {
                 videoHeight = avInfo.baseHeight
                 targetFPS = avInfo.fps
                 sampleRate = avInfo.sampleRate
-                print("✅ AV Info: \(videoWidth)x\(videoHeight) @ \(targetFPS) FPS, \(sampleRate) Hz")
+                Log.core.info("AV Info: \(videoWidth)x\(videoHeight) @ \(targetFPS) FPS, \(sampleRate) Hz")
             } else {
-                print("⚠️ No AV info available")
+                Log.core.warning("No AV info available")
             }
         } else {
             guard let bridge = bridge else {
-                print("❌ Bridge is nil")
+                Log.core.error("Bridge is nil")
                 throw EmulationError.notRunning
             }
             
             do {
                 try bridge.loadGame(url: gameURLToLoad)
-                print("✅ Game loaded successfully (dynamic)")
+                Log.core.info("Game loaded successfully (dynamic)")
             } catch {
-                print("❌ Failed to load game: \(error)")
+                Log.core.error("Failed to load game: \(error)")
                 throw error
             }
             
@@ -545,9 +739,9 @@ class EmulationViewModel: ObservableObject {
                 videoHeight = avInfo.baseHeight
                 targetFPS = avInfo.fps
                 sampleRate = avInfo.sampleRate
-                print("✅ AV Info: \(videoWidth)x\(videoHeight) @ \(targetFPS) FPS, \(sampleRate) Hz")
+                Log.core.info("AV Info: \(videoWidth)x\(videoHeight) @ \(targetFPS) FPS, \(sampleRate) Hz")
             } else {
-                print("⚠️ No AV info available")
+                Log.core.warning("No AV info available")
             }
         }
         
@@ -555,6 +749,36 @@ class EmulationViewModel: ObservableObject {
         loadBatteryRAM()
     }
     
+    /// Get the URL to hand to the core for an archive
+    /// Cores that set `block_extract` or list the archive extension get the archive as-is;
+    /// otherwise the ROM is extracted (or taken from the extraction cache)
+    private func resolveArchive(_ archiveURL: URL) async throws -> URL {
+        let ext = archiveURL.pathExtension.lowercased()
+        let systemInfo = useStaticCore ? staticBridge?.systemInfo : bridge?.systemInfo
+        
+        if let info = systemInfo, info.blockExtract || info.extensionArray.contains(ext) {
+            Log.core.debug("Core reads .\(ext) directly, passing archive as-is")
+            return archiveURL
+        }
+        
+        extractionProgress = 0
+        defer { extractionProgress = nil }
+        
+        let romURL = try await ROMArchiveCache.shared.extract(
+            archiveURL: archiveURL,
+            supportedExtensions: game.system.supportedExtensions
+        ) { [weak self] fraction in
+            Task { @MainActor in
+                // Whole percent steps: each publish re-evaluates the emulation view
+                guard let self, let current = self.extractionProgress,
+                      Int(fraction * 100) != Int(current * 100) else { return }
+                self.extractionProgress = fraction
+            }
+        }
+        Log.core.info("Loading extracted ROM: \(romURL.lastPathComponent)")
+        return romURL
+    }
+    
     private func setupCallbacks() {
         bridge?.videoCallback = { [weak self] data, width, height, pitch, format in
             self?.handleVideoFrame(data: data, width: width, height: height, pitch: pitch, format: format)
@@ -598,9 +822,7 @@ class EmulationViewModel: ObservableObject {
         // 验证数据指针有效性
         let size = pitch * height
         guard size > 0 else {
-            #if DEBUG
-            print("⚠️ Invalid video frame size: \(size), pitch: \(pitch), height: \(height)")
-            #endif
+            Log.video.debug("Invalid video frame size: \(size), pitch: \(pitch), height: \(height)")
             return
         }
 
@@ -611,27 +833,6 @@ class EmulationViewModel: ObservableObject {
         }
         
         videoBuffer?.copyMemory(from: data, byteCount: size)
-        
-        // 调试：检查复制后的数据
-        #if DEBUG
-        debugVideoFrameCount += 1
-        if debugVideoFrameCount <= 5 || debugVideoFrameCount % 300 == 0 {
-            if let buffer = videoBuffer {
-                let bytes = buffer.bindMemory(to: UInt8.self, capacity: size)
-                var nonZeroCount = 0
-                for i in 0..<min(100, size) {
-                    if bytes[i] != 0 {
-                        nonZeroCount += 1
-                    }
-                }
-                if nonZeroCount == 0 {
-                    print("⚠️ Copied video data is all zeros (frame #\(debugVideoFrameCount), size=\(size))")
-                } else {
-                    print("✅ Video data has \(nonZeroCount) non-zero bytes in first 100 (frame #\(debugVideoFrameCount))")
-                }
-            }
-        }
-        #endif
     }
     
     private func handleAudioSamples(data: UnsafePointer<Int16>, samples: Int) {
@@ -663,6 +864,8 @@ class EmulationViewModel: ObservableObject {
         guard isRunning else { return }
         
         crashFrameCount += 1
+        let frameStart = CACurrentMediaTime()
+        frameState.beginFrame(at: frameStart)
         
         // Handle frame skipping for fast forward
         if framesToSkip > 0 {
@@ -684,13 +887,30 @@ class EmulationViewModel: ObservableObject {
         
         // Update FPS counter
         frameCount += 1
+        sessionFrames += 1 + framesToSkip
+        totalFrames += UInt64(1 + framesToSkip)
         let currentTime = displayLink.timestamp
         
         if currentTime - fpsUpdateTime >= 1.0 {
-            currentFPS = Double(frameCount) / (currentTime - fpsUpdateTime) * emulationSpeed.multiplier
+            measuredFPS = Double(frameCount) / (currentTime - fpsUpdateTime) * emulationSpeed.multiplier
             frameCount = 0
             fpsUpdateTime = currentTime
         }
+        
+        #if DEBUG
+        if simulatedHangDuration > 0 && totalFrames >= 600 {
+            let end = CACurrentMediaTime() + simulatedHangDuration
+            simulatedHangDuration = 0
+            while CACurrentMediaTime() < end {}
+        }
+        #endif
+        
+        // Nothing observes this: publishing here must not invalidate any view
+        let frameEnd = CACurrentMediaTime()
+        frameState.publish(frames: totalFrames, timestamp: frameEnd, frameTime: frameEnd - frameStart, fps: measuredFPS)
+        // Only after publish, while no frame is open: the watchdog must not
+        // take serializing a save state for the core being stuck in a frame
+        autoSaveIfDue(at: frameEnd)
     }
     
     // MARK: - Audio
@@ -713,7 +933,7 @@ class EmulationViewModel: ObservableObject {
             try engine.start()
             player.play()
         } catch {
-            print("Audio setup failed: \(error)")
+            Log.core.error("Audio setup failed: \(error)")
         }
     }
     
@@ -802,26 +1022,26 @@ class EmulationViewModel: ObservableObject {
         for coreFileName in coreFileNames {
             // 1. Check app bundle Resources/Cores
             if let bundlePath = Bundle.main.path(forResource: coreFileName, ofType: nil, inDirectory: "Cores") {
-                print("Found core in bundle Cores/: \(bundlePath)")
+                Log.core.debug("Found core in bundle Cores/: \(bundlePath)")
                 return bundlePath
             }
             
             // 2. Check app bundle root
             let baseName = coreFileName.replacingOccurrences(of: ".dylib", with: "")
             if let bundlePath = Bundle.main.path(forResource: baseName, ofType: "dylib") {
-                print("Found core in bundle root: \(bundlePath)")
+                Log.core.debug("Found core in bundle root: \(bundlePath)")
                 return bundlePath
             }
             
             // 3. Check Documents/Cores
             let documentsCorePath = coresURL.appendingPathComponent(coreFileName).path
             if FileManager.default.fileExists(atPath: documentsCorePath) {
-                print("Found core in documents: \(documentsCorePath)")
+                Log.core.debug("Found core in documents: \(documentsCorePath)")
                 return documentsCorePath
             }
         }
         
-        print("Core not found for system: \(system.rawValue), tried: \(coreFileNames)")
+        Log.core.warning("Core not found for system: \(system.rawValue), tried: \(coreFileNames)")
         return nil
     }
 }
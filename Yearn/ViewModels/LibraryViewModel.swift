@@ -7,36 +7,83 @@
 
 import Foundation
 import SwiftUI
+import YearnCore
 
 @MainActor
 class LibraryViewModel: ObservableObject {
-    @Published var games: [Game] = []
+    @Published var games: [Game] = [] {
+        didSet {
+            gamesByID = Dictionary(games.map { ($0.id, $0) }, uniquingKeysWith: { first, _ in first })
+            if store == nil { scheduleRefresh() }
+        }
+    }
     @Published var recentGames: [Game] = []
     @Published var favoriteGames: [Game] = []
     @Published var isLoading = false
     @Published var errorMessage: String?
     @Published var importProgress: ImportProgress?
     
+    /// Games matching the shown query, loaded a page at a time as the user scrolls
+    @Published private(set) var displayedGames: [Game] = []
+    
     private let fileManager = FileManager.default
     private let userDefaults = UserDefaults.standard
+    private var scanTask: Task<Void, Never>?
+    
+    /// SQLite copy of the library used for search, filtering and sorting;
+    /// nil if it could not be opened, in which case queries filter `games` in memory
+    private let store: LibraryStore?
+    private var storeWrite: Task<Void, Never>?
+    private var gamesByID: [UUID: Game] = [:]
+    
+    // Paged query state
+    private var displayedQuery = LibraryStore.Query()
+    private var displayedIDs: [UUID] = []
+    private var reachedEnd = false
+    private var pageLoad: Task<Void, Never>?
+    /// Bumped when the shown rows are replaced, so older page loads are dropped
+    private var queryGeneration = 0
+    private var refreshScheduled = false
+    private let pageSize = 200
+    /// Rows before the end of what is loaded at which the next page is requested
+    private let prefetchDistance = 50
+    /// Store writes within this window share one re-query
+    private let refreshDelay: UInt64 = 300_000_000
     
     // Keys for UserDefaults
-    private let recentGamesKey = "recentGameIDs"
     private let favoriteGamesKey = "favoriteGameIDs"
+    // Play history from before the play journal, migrated once
+    private let recentGamesKey = "recentGameIDs"
     private let lastPlayedKey = "lastPlayedDates"
     
     struct ImportProgress {
         var current: Int
         var total: Int
         var currentFile: String
+        var bytesDone: UInt64 = 0
+        var totalBytes: UInt64 = 0
         
+        /// By bytes when sizes are known, so a large disc image does not stall the bar
         var percentage: Double {
+            if totalBytes > 0 {
+                return min(Double(bytesDone) / Double(totalBytes), 1)
+            }
             guard total > 0 else { return 0 }
             return Double(current) / Double(total)
         }
     }
     
     init() {
+        let storeURL = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("Library.sqlite")
+        do {
+            store = try LibraryStore(url: storeURL)
+        } catch {
+            Log.library.warning("Could not open library store: \(error)")
+            store = nil
+        }
+        
+        migratePlayHistory()
         loadGames()
         loadRecentGames()
         loadFavorites()
@@ -46,153 +93,156 @@ class LibraryViewModel: ObservableObject {
     
     /// Record that a game was played
     func recordGamePlayed(_ game: Game) {
-        // Update last played date
-        var lastPlayedDates = userDefaults.dictionary(forKey: lastPlayedKey) as? [String: Date] ?? [:]
-        lastPlayedDates[game.id.uuidString] = Date()
-        userDefaults.set(lastPlayedDates, forKey: lastPlayedKey)
-        
-        // Update recent games list
-        var recentIDs = userDefaults.stringArray(forKey: recentGamesKey) ?? []
-        recentIDs.removeAll { $0 == game.id.uuidString }
-        recentIDs.insert(game.id.uuidString, at: 0)
-        recentIDs = Array(recentIDs.prefix(20)) // Keep last 20
-        userDefaults.set(recentIDs, forKey: recentGamesKey)
-        
+        PlayJournal.shared?.recordLaunch(of: game.id)
         loadRecentGames()
+        let id = game.id
+        updateStore { try $0.recordPlayed(id) }
     }
     
-    /// Load recent games from UserDefaults
+    /// Load recent games from the play journal's totals
     private func loadRecentGames() {
-        let recentIDs = userDefaults.stringArray(forKey: recentGamesKey) ?? []
-        let lastPlayedDates = userDefaults.dictionary(forKey: lastPlayedKey) as? [String: Date] ?? [:]
+        guard let summary = PlayJournal.shared?.summary else { return }
         
-        recentGames = recentIDs.compactMap { idString in
-            guard let uuid = UUID(uuidString: idString),
-                  var game = games.first(where: { $0.id == uuid }) else {
-                return nil
-            }
-            game.lastPlayed = lastPlayedDates[idString]
+        recentGames = summary.recentGameIDs(limit: 20).compactMap { id in
+            guard var game = gamesByID[id] else { return nil }
+            game.lastPlayed = summary.games[id]?.lastPlayed
             return game
         }
     }
     
     /// Clear recent games history
     func clearRecentGames() {
+        PlayJournal.shared?.clearLastPlayed()
+        recentGames = []
+    }
+    
+    /// Move last-played dates kept in UserDefaults into the play journal
+    private func migratePlayHistory() {
+        guard let lastPlayedDates = userDefaults.dictionary(forKey: lastPlayedKey) as? [String: Date],
+              let journal = PlayJournal.shared else { return }
+        for (idString, date) in lastPlayedDates {
+            if let id = UUID(uuidString: idString) {
+                journal.recordLaunch(of: id, at: date)
+            }
+        }
+        journal.flush()
         userDefaults.removeObject(forKey: recentGamesKey)
         userDefaults.removeObject(forKey: lastPlayedKey)
-        recentGames = []
     }
     
     // MARK: - Loading Games
     
     /// Load games from the documents directory
+    /// Starts a background scan; results are published in batches
     func loadGames() {
-        isLoading = true
-        defer { isLoading = false }
-        
+        scanTask?.cancel()
+        scanTask = Task { await scanLibrary() }
+    }
+    
+    /// Scan `Documents/ROMs`, re-examining only files that changed since the last scan
+    func scanLibrary() async {
         guard let documentsURL = fileManager.urls(for: .documentDirectory, in: .userDomainMask).first else {
-            print("🔍 Could not get documents directory")
+            Log.library.error("Could not get documents directory")
             return
         }
         
         let romsURL = documentsURL.appendingPathComponent("ROMs", isDirectory: true)
-        print("🔍 Scanning ROMs directory: \(romsURL.path)")
-        
-        // Create ROMs directory if it doesn't exist
         if !fileManager.fileExists(atPath: romsURL.path) {
             try? fileManager.createDirectory(at: romsURL, withIntermediateDirectories: true)
-            print("🔍 Created ROMs directory")
-        }
-        
-        // List directory contents for debugging
-        if let contents = try? fileManager.contentsOfDirectory(at: romsURL, includingPropertiesForKeys: nil) {
-            print("🔍 ROMs directory contents: \(contents.map { $0.lastPathComponent })")
-        }
-        
-        // Scan for ROM files
-        guard let enumerator = fileManager.enumerator(
-            at: romsURL,
-            includingPropertiesForKeys: [.isRegularFileKey, .fileSizeKey, .creationDateKey],
-            options: [.skipsHiddenFiles]
-        ) else {
-            print("🔍 Could not create enumerator")
-            return
+            Log.library.debug("Created ROMs directory")
         }
         
-        var foundGames: [Game] = []
-        var allFiles: [URL] = []
+        isLoading = true
+        // A cancelled scan has been replaced by one that set isLoading itself
+        defer { if !Task.isCancelled { isLoading = false } }
+        
+        let cacheURL = fileManager.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("LibraryScan.plist")
+        let scanner = LibraryScanner(root: romsURL, cacheURL: cacheURL)
+        
+        let records = await scanner.scan(
+            filter: Self.launchableFiles,
+            classify: Self.classify,
+            onBatch: { [weak self] batch in
+                await self?.publish(batch, root: romsURL)
+            }
+        )
+        // A cancelled scan returns early with nothing; keep the list as it is
+        guard !Task.isCancelled else { return }
+        moveGameData(scanner.reassignedIDs)
+        
+        // Final list drops games whose files disappeared since the last publish
+        let scanned = records.compactMap { Self.game(from: $0, root: romsURL) }
+        games = scanned.sorted { $0.name.localizedCompare($1.name) == .orderedAscending }
+        loadRecentGames()
+        loadFavorites()
         
-        // 首先收集所有文件
-        for case let fileURL as URL in enumerator {
-            guard let resourceValues = try? fileURL.resourceValues(forKeys: [.isRegularFileKey]),
-                  resourceValues.isRegularFile == true else {
-                continue
+        let entries = storeEntries(for: games)
+        updateStore { try $0.replaceAll(with: entries) }
+        updateSpotlightIndex()
+        StartupScheduler.shared.mark(.libraryLoaded)
+        Log.library.info("Total games loaded: \(games.count)")
+    }
+    
+    /// Merge a batch of scan results into the visible list
+    private func publish(_ batch: [ScanRecord], root: URL) {
+        guard !Task.isCancelled else { return }
+        var byID = gamesByID
+        for record in batch {
+            if let game = Self.game(from: record, root: root) {
+                byID[game.id] = game
             }
-            allFiles.append(fileURL)
         }
+        games = byID.values.sorted { $0.name.localizedCompare($1.name) == .orderedAscending }
+        loadFavorites()
         
-        // 构建已存在的 .cue 文件集合（用于跳过对应的 .bin 文件）
-        let cueFiles = Set(allFiles.filter { $0.pathExtension.lowercased() == "cue" }
+        let entries = storeEntries(for: batch.compactMap { gamesByID[$0.id] })
+        updateStore { try $0.upsert(entries) }
+    }
+    
+    private static func game(from record: ScanRecord, root: URL) -> Game? {
+        guard let systemName = record.system, let system = GameSystem(rawValue: systemName) else { return nil }
+        let fileURL = root.appendingPathComponent(record.path)
+        return Game(
+            id: record.id,
+            name: record.title ?? fileURL.deletingPathExtension().lastPathComponent,
+            fileURL: fileURL,
+            system: system,
+            dateAdded: record.creationDate,
+            fileSizeBytes: Int(record.size)
+        )
+    }
+    
+    /// 过滤掉光盘镜像的辅助文件：有 .cue 的 .bin，以及有 .img 的 .ccd/.sub
+    private static let launchableFiles: LibraryScanner.Filter = { files in
+        let cueFiles = Set(files.filter { $0.pathExtension.lowercased() == "cue" }
             .map { $0.deletingPathExtension().lastPathComponent.lowercased() })
-        
-        // 构建已存在的 .img 文件集合（用于跳过对应的 .ccd/.sub 文件）
-        let imgFiles = Set(allFiles.filter { $0.pathExtension.lowercased() == "img" }
+        let imgFiles = Set(files.filter { $0.pathExtension.lowercased() == "img" }
             .map { $0.deletingPathExtension().lastPathComponent.lowercased() })
         
-        for fileURL in allFiles {
-            guard let resourceValues = try? fileURL.resourceValues(forKeys: [.fileSizeKey, .creationDateKey]) else {
-                continue
-            }
-            
+        return files.filter { fileURL in
             let ext = fileURL.pathExtension.lowercased()
             let baseName = fileURL.deletingPathExtension().lastPathComponent.lowercased()
-            
-            print("🔍 Found file: \(fileURL.lastPathComponent) (ext: .\(ext))")
-            
-            // 如果有 .cue 文件，跳过对应的 .bin 文件（优先使用 .cue）
-            if ext == "bin" && cueFiles.contains(baseName) {
-                print("🔍 Skipped .bin (has .cue file): \(fileURL.lastPathComponent)")
-                continue
-            }
-            
-            // 如果有 .img 文件，跳过对应的 .ccd 和 .sub 文件
-            if (ext == "ccd" || ext == "sub") && imgFiles.contains(baseName) {
-                print("🔍 Skipped .\(ext) (has .img file): \(fileURL.lastPathComponent)")
-                continue
-            }
-            
-            // 对于 .bin 文件，使用文件头检测来确定正确的系统
-            let system: GameSystem?
-            if ext == "bin" || ext == "iso" {
-                system = GameSystem.system(forFileAt: fileURL)
-            } else {
-                system = GameSystem.system(forExtension: ext)
-            }
-            
-            if let system = system {
-                let game = Game(
-                    name: fileURL.deletingPathExtension().lastPathComponent,
-                    fileURL: fileURL,
-                    system: system,
-                    dateAdded: resourceValues.creationDate,
-                    fileSizeBytes: resourceValues.fileSize
-                )
-                foundGames.append(game)
-                print("🔍 Added game: \(game.name) (\(system.rawValue))")
-            } else {
-                print("🔍 Skipped (unsupported extension): \(fileURL.lastPathComponent)")
-            }
+            if ext == "bin" && cueFiles.contains(baseName) { return false }
+            if (ext == "ccd" || ext == "sub") && imgFiles.contains(baseName) { return false }
+            return true
         }
-        
-        games = foundGames.sorted { $0.name.localizedCompare($1.name) == .orderedAscending }
-        print("🔍 Total games loaded: \(games.count)")
+    }
+    
+    /// 对于 .bin/.iso 和压缩包，使用文件头检测来确定正确的系统
+    private static let classify: LibraryScanner.Classifier = { fileURL in
+        let ext = fileURL.pathExtension.lowercased()
+        if ext == "bin" || ext == "iso" || ROMArchiveCache.isArchive(fileURL) {
+            return GameSystem.system(forFileAt: fileURL)?.rawValue
+        }
+        return GameSystem.system(forExtension: ext)?.rawValue
     }
     
     // MARK: - Importing Games
     
     /// Import games from multiple URLs
     func importGames(from urls: [URL]) async {
-        print("📥 Starting import of \(urls.count) file(s)")
+        Log.library.info("Starting import of \(urls.count) file(s)")
         
         // Filter out auxiliary files if their main file is also in the list
         var filteredURLs: [URL] = []
@@ -206,7 +256,7 @@ class LibraryViewModel: ObservableObject {
             if ext == "ccd" || ext == "sub" {
                 let imgURL = url.deletingLastPathComponent().appendingPathComponent(baseName).appendingPathExtension("img")
                 if urls.contains(imgURL) {
-                    print("📥 Skipping \(url.lastPathComponent) (will be imported with .img file)")
+                    Log.library.debug("Skipping \(url.lastPathComponent) (will be imported with .img file)")
                     skippedAuxFiles.insert(url.lastPathComponent)
                     continue
                 }
@@ -216,7 +266,7 @@ class LibraryViewModel: ObservableObject {
             if ext == "cue" {
                 let binURL = url.deletingLastPathComponent().appendingPathComponent(baseName).appendingPathExtension("bin")
                 if urls.contains(binURL) {
-                    print("📥 Skipping \(url.lastPathComponent) (will be imported with .bin file)")
+                    Log.library.debug("Skipping \(url.lastPathComponent) (will be imported with .bin file)")
                     skippedAuxFiles.insert(url.lastPathComponent)
                     continue
                 }
@@ -225,227 +275,150 @@ class LibraryViewModel: ObservableObject {
             filteredURLs.append(url)
         }
         
-        print("📥 Processing \(filteredURLs.count) main file(s) (skipped \(skippedAuxFiles.count) auxiliary files)")
-        importProgress = ImportProgress(current: 0, total: filteredURLs.count, currentFile: "")
-        
-        for (index, url) in filteredURLs.enumerated() {
-            importProgress?.current = index
-            importProgress?.currentFile = url.lastPathComponent
-            print("📥 Importing [\(index + 1)/\(filteredURLs.count)]: \(url.lastPathComponent)")
-            
-            await importGame(from: url)
-        }
+        Log.library.debug("Processing \(filteredURLs.count) main file(s) (skipped \(skippedAuxFiles.count) auxiliary files)")
+        await runImport(filteredURLs)
         
-        importProgress = nil
-        print("📥 Import complete, refreshing game list...")
-        loadGames()
-        print("📥 Game list refreshed. Total games: \(games.count)")
+        Log.library.debug("Import complete, refreshing game list...")
+        scanTask?.cancel()
+        await scanLibrary()
+        Log.library.info("Game list refreshed. Total games: \(games.count)")
     }
     
     /// Import a game from an external URL
     func importGame(from sourceURL: URL) async {
-        let accessing = sourceURL.startAccessingSecurityScopedResource()
+        await runImport([sourceURL])
+    }
+    
+    /// Copy files into `ROMs/<system>/` through the import pipeline
+    /// DATs go to the DAT folder instead; the scan cache learns each ROM's
+    /// system and hash so the next scan does not read it again.
+    private func runImport(_ urls: [URL]) async {
+        var jobs: [ImportPipeline.Job] = []
+        var patches: [URL] = []
+        var importedROMs: [URL] = []
         defer {
-            if accessing {
-                sourceURL.stopAccessingSecurityScopedResource()
+            // After the ROMs, so a patch imported together with its ROM finds it
+            let romURLs = importedROMs + games.map(\.fileURL)
+            for patch in patches {
+                importPatch(from: patch, romURLs: romURLs)
             }
         }
-        
-        let ext = sourceURL.pathExtension.lowercased()
-        print("📥 File extension: .\(ext)")
-        
-        // 跳过 PS1 光盘镜像的辅助文件（.ccd, .sub），只处理主镜像文件
-        if ext == "ccd" || ext == "sub" {
-            print("📥 Skipping auxiliary file: .\(ext) (will be imported with main .img file)")
-            return
-        }
-        
-        // 对于 .bin 文件，使用文件头检测来确定正确的系统
-        let system: GameSystem?
-        if ext == "bin" || ext == "iso" {
-            print("📥 Analyzing file content to detect system...")
-            system = GameSystem.system(forFileAt: sourceURL)
-        } else {
-            system = GameSystem.system(forExtension: ext)
-        }
-        
-        guard let system = system else {
-            errorMessage = "Unsupported file format: .\(ext)"
-            print("❌ Unsupported file format: .\(ext)")
-            return
+        for url in urls {
+            let ext = url.pathExtension.lowercased()
+            
+            // No-Intro / Redump DAT 文件放入 DAT 目录，用于离线识别
+            if DATIndexStore.isDAT(url) {
+                let accessing = url.startAccessingSecurityScopedResource()
+                defer {
+                    if accessing {
+                        url.stopAccessingSecurityScopedResource()
+                    }
+                }
+                do {
+                    try DATIndexStore.shared.importDAT(from: url)
+                } catch {
+                    errorMessage = "Failed to import DAT: \(error.localizedDescription)"
+                    Log.library.error("Failed to import DAT: \(error)")
+                }
+                continue
+            }
+            
+            // 跳过 PS1 光盘镜像的辅助文件（.ccd, .sub），只处理主镜像文件
+            if ext == "ccd" || ext == "sub" {
+                Log.library.debug("Skipping auxiliary file: .\(ext) (will be imported with main .img file)")
+                continue
+            }
+            
+            // 补丁文件放到同名 ROM 旁边，加载时自动应用
+            if PatchedROMCache.isPatch(url) {
+                patches.append(url)
+                continue
+            }
+            
+            jobs.append(ImportPipeline.Job(source: url, companions: Self.companions(of: url)))
         }
-        
-        print("📥 Detected system: \(system.rawValue)")
+        guard !jobs.isEmpty else { return }
         
         guard let documentsURL = fileManager.urls(for: .documentDirectory, in: .userDomainMask).first else {
-            print("❌ Could not get documents directory")
+            Log.library.error("Could not get documents directory")
             return
         }
-        
         let romsURL = documentsURL.appendingPathComponent("ROMs", isDirectory: true)
-        let systemURL = romsURL.appendingPathComponent(system.rawValue, isDirectory: true)
         
-        print("📥 Target directory: \(systemURL.path)")
+        importProgress = ImportProgress(current: 0, total: jobs.count, currentFile: "")
+        defer { importProgress = nil }
+        
+        let pipeline = ImportPipeline(stagingDirectory: romsURL.appendingPathComponent(".importing", isDirectory: true))
+        let result = await pipeline.run(
+            jobs,
+            classify: { url, sniffed, fileSize in
+                GameSystem.system(forFileAt: url, sniffed: sniffed, fileSize: fileSize)?.rawValue
+            },
+            destination: { system in
+                romsURL.appendingPathComponent(system, isDirectory: true)
+            },
+            onProgress: { [weak self] progress in
+                await self?.updateImportProgress(progress)
+            }
+        )
         
-        // Create system directory if needed
-        if !fileManager.fileExists(atPath: systemURL.path) {
-            do {
-                try fileManager.createDirectory(at: systemURL, withIntermediateDirectories: true)
-                print("📥 Created directory: \(systemURL.path)")
-            } catch {
-                print("❌ Failed to create directory: \(error)")
+        let cacheURL = fileManager.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+            .appendingPathComponent("LibraryScan.plist")
+        LibraryScanner(root: romsURL, cacheURL: cacheURL).adopt(result.imported.map {
+            (url: $0.destination, system: $0.system, crc32: $0.crc32, title: $0.title)
+        })
+        importedROMs = result.imported.map(\.destination)
+        
+        if let failure = result.failed.first {
+            errorMessage = "Failed to import \(failure.source.lastPathComponent): \(failure.error.localizedDescription)"
+        }
+    }
+    
+    /// Copy an IPS/UPS/BPS patch next to the library ROM with the same name
+    private func importPatch(from url: URL, romURLs: [URL]) {
+        let accessing = url.startAccessingSecurityScopedResource()
+        defer {
+            if accessing {
+                url.stopAccessingSecurityScopedResource()
             }
         }
         
-        let destinationURL = systemURL.appendingPathComponent(sourceURL.lastPathComponent)
-        print("📥 Destination: \(destinationURL.path)")
+        let baseName = url.deletingPathExtension().lastPathComponent
+        guard let romURL = romURLs.first(where: { $0.deletingPathExtension().lastPathComponent == baseName }) else {
+            errorMessage = "No game named \"\(baseName)\" for patch \(url.lastPathComponent)"
+            Log.library.error("No ROM matches patch: \(url.lastPathComponent)")
+            return
+        }
         
+        let destination = romURL.deletingLastPathComponent().appendingPathComponent(url.lastPathComponent)
         do {
-            // Remove existing file if present
-            if fileManager.fileExists(atPath: destinationURL.path) {
-                try fileManager.removeItem(at: destinationURL)
-                print("📥 Removed existing file")
-            }
-            
-            try fileManager.copyItem(at: sourceURL, to: destinationURL)
-            print("✅ Successfully copied to: \(destinationURL.path)")
-            
-            // For PS1 files, also copy accompanying auxiliary files if they exist
-            if system == .ps1 {
-                let baseName = sourceURL.deletingPathExtension().lastPathComponent
-                let sourceDirectory = sourceURL.deletingLastPathComponent()
-                
-                // For .img files, copy .ccd and .sub files
-                if ext == "img" {
-                    print("📥 Checking for CloneCD auxiliary files in: \(sourceDirectory.path)")
-                    
-                    // Copy .ccd file
-                    let ccdSource = sourceDirectory.appendingPathComponent(baseName).appendingPathExtension("ccd")
-                    print("📥 Looking for .ccd file: \(ccdSource.lastPathComponent)")
-                    
-                    let ccdAccessing = ccdSource.startAccessingSecurityScopedResource()
-                    defer {
-                        if ccdAccessing {
-                            ccdSource.stopAccessingSecurityScopedResource()
-                        }
-                    }
-                    
-                    if fileManager.fileExists(atPath: ccdSource.path) {
-                        print("📥 Found .ccd file")
-                        let ccdDest = systemURL.appendingPathComponent(baseName).appendingPathExtension("ccd")
-                        do {
-                            if fileManager.fileExists(atPath: ccdDest.path) {
-                                try fileManager.removeItem(at: ccdDest)
-                            }
-                            try fileManager.copyItem(at: ccdSource, to: ccdDest)
-                            print("✅ Also copied: \(ccdSource.lastPathComponent)")
-                        } catch {
-                            print("⚠️ Failed to copy .ccd file: \(error)")
-                        }
-                    } else {
-                        print("📥 .ccd file not found")
-                    }
-                    
-                    // Copy .sub file
-                    let subSource = sourceDirectory.appendingPathComponent(baseName).appendingPathExtension("sub")
-                    print("📥 Looking for .sub file: \(subSource.lastPathComponent)")
-                    
-                    let subAccessing = subSource.startAccessingSecurityScopedResource()
-                    defer {
-                        if subAccessing {
-                            subSource.stopAccessingSecurityScopedResource()
-                        }
-                    }
-                    
-                    if fileManager.fileExists(atPath: subSource.path) {
-                        print("📥 Found .sub file")
-                        let subDest = systemURL.appendingPathComponent(baseName).appendingPathExtension("sub")
-                        do {
-                            if fileManager.fileExists(atPath: subDest.path) {
-                                try fileManager.removeItem(at: subDest)
-                            }
-                            try fileManager.copyItem(at: subSource, to: subDest)
-                            print("✅ Also copied: \(subSource.lastPathComponent)")
-                        } catch {
-                            print("⚠️ Failed to copy .sub file: \(error)")
-                        }
-                    } else {
-                        print("📥 .sub file not found")
-                    }
-                }
-                
-                // For .bin files, copy .cue file
-                else if ext == "bin" {
-                    print("📥 Checking for .cue file in: \(sourceDirectory.path)")
-                    
-                    let cueSource = sourceDirectory.appendingPathComponent(baseName).appendingPathExtension("cue")
-                    print("📥 Looking for .cue file: \(cueSource.lastPathComponent)")
-                    
-                    let cueAccessing = cueSource.startAccessingSecurityScopedResource()
-                    defer {
-                        if cueAccessing {
-                            cueSource.stopAccessingSecurityScopedResource()
-                        }
-                    }
-                    
-                    if fileManager.fileExists(atPath: cueSource.path) {
-                        print("📥 Found .cue file")
-                        let cueDest = systemURL.appendingPathComponent(baseName).appendingPathExtension("cue")
-                        do {
-                            if fileManager.fileExists(atPath: cueDest.path) {
-                                try fileManager.removeItem(at: cueDest)
-                            }
-                            try fileManager.copyItem(at: cueSource, to: cueDest)
-                            print("✅ Also copied: \(cueSource.lastPathComponent)")
-                        } catch {
-                            print("⚠️ Failed to copy .cue file: \(error)")
-                        }
-                    } else {
-                        print("📥 .cue file not found")
-                    }
-                }
-                
-                // For .cue files, copy .bin file
-                else if ext == "cue" {
-                    print("📥 Checking for .bin file in: \(sourceDirectory.path)")
-                    
-                    let binSource = sourceDirectory.appendingPathComponent(baseName).appendingPathExtension("bin")
-                    print("📥 Looking for .bin file: \(binSource.lastPathComponent)")
-                    
-                    let binAccessing = binSource.startAccessingSecurityScopedResource()
-                    defer {
-                        if binAccessing {
-                            binSource.stopAccessingSecurityScopedResource()
-                        }
-                    }
-                    
-                    if fileManager.fileExists(atPath: binSource.path) {
-                        print("📥 Found .bin file")
-                        let binDest = systemURL.appendingPathComponent(baseName).appendingPathExtension("bin")
-                        do {
-                            if fileManager.fileExists(atPath: binDest.path) {
-                                try fileManager.removeItem(at: binDest)
-                            }
-                            try fileManager.copyItem(at: binSource, to: binDest)
-                            print("✅ Also copied: \(binSource.lastPathComponent)")
-                        } catch {
-                            print("⚠️ Failed to copy .bin file: \(error)")
-                        }
-                    } else {
-                        print("📥 .bin file not found")
-                    }
-                }
-            }
-            
-            // Verify the file exists
-            if fileManager.fileExists(atPath: destinationURL.path) {
-                print("✅ File verified at destination")
-            } else {
-                print("❌ File not found at destination after copy!")
+            if fileManager.fileExists(atPath: destination.path) {
+                try fileManager.removeItem(at: destination)
             }
+            try fileManager.copyItem(at: url, to: destination)
+            Log.library.info("Imported patch for \(romURL.lastPathComponent): \(url.lastPathComponent)")
         } catch {
-            errorMessage = "Failed to import \(sourceURL.lastPathComponent): \(error.localizedDescription)"
-            print("❌ Import failed: \(error.localizedDescription)")
+            errorMessage = "Failed to import patch: \(error.localizedDescription)"
+            Log.library.error("Failed to import patch: \(error)")
+        }
+    }
+    
+    private func updateImportProgress(_ progress: ImportPipeline.Progress) {
+        importProgress = ImportProgress(current: progress.completedFiles,
+                                        total: progress.totalFiles,
+                                        currentFile: progress.currentFile,
+                                        bytesDone: progress.bytesDone,
+                                        totalBytes: progress.totalBytes)
+    }
+    
+    /// Files that belong with a disc image: .cue for .bin (and back), .ccd/.sub for .img
+    private static func companions(of url: URL) -> [URL] {
+        let base = url.deletingPathExtension()
+        switch url.pathExtension.lowercased() {
+        case "img": return [base.appendingPathExtension("ccd"), base.appendingPathExtension("sub")]
+        case "bin": return [base.appendingPathExtension("cue")]
+        case "cue": return [base.appendingPathExtension("bin")]
+        default: return []
         }
     }
     
@@ -458,17 +431,17 @@ class LibraryViewModel: ObservableObject {
             }
         }
         
-        print("📂 importGamesFromFolder: \(folderURL.path)")
+        Log.library.debug("importGamesFromFolder: \(folderURL.path)")
         
         // Check if the URL is actually a file (not a folder)
         var isDirectory: ObjCBool = false
         let exists = fileManager.fileExists(atPath: folderURL.path, isDirectory: &isDirectory)
         
-        print("📂 Path exists: \(exists), isDirectory: \(isDirectory.boolValue)")
+        Log.library.debug("Path exists: \(exists), isDirectory: \(isDirectory.boolValue)")
         
         if exists && !isDirectory.boolValue {
             // User selected a single file instead of a folder - import it directly
-            print("📂 Selected item is a file, importing directly...")
+            Log.library.debug("Selected item is a file, importing directly...")
             await importGames(from: [folderURL])
             return
         }
@@ -479,7 +452,7 @@ class LibraryViewModel: ObservableObject {
             includingPropertiesForKeys: [.isRegularFileKey],
             options: [.skipsHiddenFiles]
         ) else {
-            print("📂 Could not create enumerator for folder")
+            Log.library.warning("Could not create enumerator for folder")
             return
         }
         
@@ -492,17 +465,17 @@ class LibraryViewModel: ObservableObject {
             }
             
             let ext = fileURL.pathExtension.lowercased()
-            print("📂 Found file in folder: \(fileURL.lastPathComponent) (ext: .\(ext))")
-            if GameSystem.system(forExtension: ext) != nil {
+            Log.library.debug("Found file in folder: \(fileURL.lastPathComponent) (ext: .\(ext))")
+            if GameSystem.system(forExtension: ext) != nil || ROMArchiveCache.isArchive(fileURL) || PatchedROMCache.isPatch(fileURL) {
                 romURLs.append(fileURL)
             }
         }
         
-        print("📂 Found \(romURLs.count) ROM file(s) in folder")
+        Log.library.info("Found \(romURLs.count) ROM file(s) in folder")
         
         if romURLs.isEmpty {
             errorMessage = "No supported ROM files found in the selected folder"
-            print("📂 No supported ROM files found")
+            Log.library.debug("No supported ROM files found")
             return
         }
         
@@ -514,6 +487,9 @@ class LibraryViewModel: ObservableObject {
         do {
             try fileManager.removeItem(at: game.fileURL)
             games.removeAll { $0.id == game.id }
+            let id = game.id
+            updateStore { try $0.delete(id: id) }
+            updateSpotlightIndex()
             
             // Also delete associated save files
             deleteSaveFiles(for: game)
@@ -537,6 +513,39 @@ class LibraryViewModel: ObservableObject {
         try? fileManager.removeItem(at: batterySaveURL)
     }
     
+    /// Move saves, screenshots, covers, favorites and play history to games' new identifiers
+    /// Only libraries scanned before identifiers were derived from the path have any
+    private func moveGameData(_ ids: [UUID: UUID]) {
+        guard !ids.isEmpty,
+              let documentsURL = fileManager.urls(for: .documentDirectory, in: .userDomainMask).first else {
+            return
+        }
+        
+        for (old, new) in ids {
+            for (from, to) in [("SaveStates/\(old)", "SaveStates/\(new)"),
+                               ("Saves/\(old).sav", "Saves/\(new).sav"),
+                               ("Screenshots/\(old)", "Screenshots/\(new)"),
+                               ("Covers/\(old.uuidString).jpg", "Covers/\(new.uuidString).jpg")] {
+                let source = documentsURL.appendingPathComponent(from)
+                let destination = documentsURL.appendingPathComponent(to)
+                guard fileManager.fileExists(atPath: source.path),
+                      !fileManager.fileExists(atPath: destination.path) else { continue }
+                do {
+                    try fileManager.moveItem(at: source, to: destination)
+                } catch {
+                    Log.library.warning("Could not move \(from) to \(to): \(error.localizedDescription)")
+                }
+            }
+        }
+        
+        let favoriteIDs = userDefaults.stringArray(forKey: favoriteGamesKey) ?? []
+        let moved = favoriteIDs.map { id in UUID(uuidString: id).flatMap { ids[$0] }?.uuidString ?? id }
+        userDefaults.set(moved, forKey: favoriteGamesKey)
+        
+        PlayJournal.shared?.reassign(ids)
+        Log.library.info("Moved data for \(ids.count) game(s) to path-derived identifiers")
+    }
+    
     // MARK: - Favorites
     
     func toggleFavorite(_ game: Game) {
@@ -544,6 +553,10 @@ class LibraryViewModel: ObservableObject {
             games[index].isFavorite.toggle()
             saveFavorites()
             loadFavorites()
+            
+            let id = game.id
+            let isFavorite = games[index].isFavorite
+            updateStore { try $0.setFavorite(isFavorite, for: id) }
         }
     }
     
@@ -551,9 +564,18 @@ class LibraryViewModel: ObservableObject {
     private func loadFavorites() {
         let favoriteIDs = Set(userDefaults.stringArray(forKey: favoriteGamesKey) ?? [])
         
-        // Update isFavorite flag on games
-        for index in games.indices {
-            games[index].isFavorite = favoriteIDs.contains(games[index].id.uuidString)
+        // Update isFavorite flag on a copy; each write to `games` re-indexes the whole library
+        var updated = games
+        var changed = false
+        for index in updated.indices {
+            let isFavorite = favoriteIDs.contains(updated[index].id.uuidString)
+            if updated[index].isFavorite != isFavorite {
+                updated[index].isFavorite = isFavorite
+                changed = true
+            }
+        }
+        if changed {
+            games = updated
         }
         
         favoriteGames = games.filter { $0.isFavorite }
@@ -565,6 +587,142 @@ class LibraryViewModel: ObservableObject {
         userDefaults.set(favoriteIDs, forKey: favoriteGamesKey)
     }
     
+    // MARK: - Queries
+    
+    /// Show games matching `query`, starting from its first page
+    func showGames(matching query: LibraryStore.Query) async {
+        displayedQuery = query
+        queryGeneration += 1
+        pageLoad?.cancel()
+        pageLoad = nil
+        await loadPage(offset: 0, limit: pageSize)
+    }
+    
+    /// Called as rows appear; fetches the next page when the user nears the end of what is loaded
+    func gameAppeared(at index: Int) {
+        guard !reachedEnd, pageLoad == nil,
+              index >= displayedIDs.count - prefetchDistance else { return }
+        let generation = queryGeneration
+        pageLoad = Task { [weak self] in
+            guard let self else { return }
+            await self.loadPage(offset: self.displayedIDs.count, limit: self.pageSize)
+            if generation == self.queryGeneration {
+                self.pageLoad = nil
+            }
+        }
+    }
+    
+    /// Fetch a page of the shown query off the main thread; offset 0 replaces the rows shown
+    private func loadPage(offset: Int, limit: Int) async {
+        let generation = queryGeneration
+        let query = displayedQuery
+        guard let store else {
+            showFiltered(query)
+            return
+        }
+        
+        let ids: [UUID]
+        do {
+            ids = try await store.loadIDs(matching: query, offset: offset, limit: limit)
+        } catch {
+            Log.library.warning("Library query failed: \(error)")
+            showFiltered(query)
+            return
+        }
+        guard generation == queryGeneration, !Task.isCancelled else { return }
+        
+        let page = ids.compactMap { gamesByID[$0] }
+        if offset == 0 {
+            displayedIDs = ids
+            displayedGames = page
+        } else {
+            displayedIDs += ids
+            displayedGames += page
+        }
+        reachedEnd = ids.count < limit
+    }
+    
+    private func showFiltered(_ query: LibraryStore.Query) {
+        displayedGames = filteredGames(query)
+        displayedIDs = displayedGames.map(\.id)
+        reachedEnd = true
+    }
+    
+    /// Re-run the shown query once writes settle, reloading only as many rows as are loaded
+    /// A scan or import makes many writes in a row; they share one re-query
+    private func scheduleRefresh() {
+        guard !refreshScheduled else { return }
+        refreshScheduled = true
+        Task { [weak self] in
+            try? await Task.sleep(nanoseconds: self?.refreshDelay ?? 0)
+            guard let self else { return }
+            self.refreshScheduled = false
+            self.queryGeneration += 1
+            self.pageLoad?.cancel()
+            self.pageLoad = nil
+            await self.loadPage(offset: 0, limit: max(self.displayedIDs.count, self.pageSize))
+        }
+    }
+    
+    /// In-memory fallback for when the store is unavailable
+    private func filteredGames(_ query: LibraryStore.Query) -> [Game] {
+        var result = games
+        if let system = query.system {
+            result = result.filter { $0.system.rawValue == system }
+        }
+        if query.favoritesOnly {
+            result = result.filter { $0.isFavorite }
+        }
+        if !query.search.isEmpty {
+            let words = query.search.split(whereSeparator: \.isWhitespace)
+            result = result.filter { game in words.allSatisfy { game.name.localizedCaseInsensitiveContains($0) } }
+        }
+        switch query.order {
+        case .name, .lastPlayed:
+            result.sort { $0.name.localizedCompare($1.name) == .orderedAscending }
+        case .system:
+            result.sort { ($0.system.rawValue, $0.name) < ($1.system.rawValue, $1.name) }
+        case .dateAdded:
+            result.sort { ($0.dateAdded ?? .distantPast) > ($1.dateAdded ?? .distantPast) }
+        }
+        return result
+    }
+    
+    private func storeEntries(for games: [Game]) -> [LibraryStore.Entry] {
+        let played = PlayJournal.shared?.summary.games ?? [:]
+        return games.map { game in
+            LibraryStore.Entry(
+                id: game.id,
+                path: game.fileURL.path,
+                name: game.name,
+                system: game.system.rawValue,
+                size: Int64(game.fileSizeBytes ?? 0),
+                dateAdded: game.dateAdded,
+                lastPlayed: played[game.id]?.lastPlayed,
+                isFavorite: game.isFavorite
+            )
+        }
+    }
+    
+    /// Write to the store off the main thread; writes apply in the order they were made
+    private func updateStore(_ change: @escaping @Sendable (LibraryStore) throws -> Void) {
+        guard let store else { return }
+        let previous = storeWrite
+        storeWrite = Task.detached(priority: .utility) { [weak self] in
+            await previous?.value
+            do {
+                try change(store)
+            } catch {
+                Log.library.warning("Library store update failed: \(error)")
+            }
+            await self?.storeDidChange()
+        }
+    }
+    
+    private func storeDidChange() {
+        scheduleRefresh()
+    }
+    
     // MARK: - Statistics
     
     var totalGames: Int {
@@ -249,11 +249,23 @@ struct ControllerSkin: Identifiable, Codable {
     static let allBuiltIn: [ControllerSkin] = [
         .default, .minimal, .retro, .neon, .classicNintendo, .playStation, .xbox, .transparent, .darkMode
     ]
+    
+    /// Identifies the look of the skin's artwork for `SkinRasterCache`
+    /// Built-in skins get a new `id` each launch, so only style fields count.
+    var rasterKey: Int {
+        var hasher = Hasher()
+        hasher.combine(backgroundColor)
+        hasher.combine(buttonColor)
+        hasher.combine(buttonPressedColor)
+        hasher.combine(dpadColor)
+        hasher.combine(buttonStyle)
+        return hasher.finalize()
+    }
 }
 
 // MARK: - Codable Color
 
-struct CodableColor: Codable {
+struct CodableColor: Codable, Hashable {
     var red: Double
     var green: Double
     var blue: Double
@@ -325,6 +337,10 @@ class ControllerSkinManager: ObservableObject {
     
     func setCurrentSkin(_ skin: ControllerSkin) {
         currentSkin = skin
+        // Artwork of the previous skin is not shown anywhere any more
+        Task { @MainActor in
+            SkinRasterCache.shared.removeAll()
+        }
         
         if let data = try? JSONEncoder().encode(skin) {
             UserDefaults.standard.set(data, forKey: currentSkinKey)
@@ -0,0 +1,147 @@
+//
+//  SkinRasterCache.swift
+//  Yearn
+//
+//  Controller skin artwork rendered once into bitmaps
+//
+
+import SwiftUI
+import UIKit
+import YearnCore
+
+// MARK: - Skin Raster Cache
+
+/// Bitmaps of static controller artwork, keyed by skin style, element, size and scale
+///
+/// Gradients, shapes and shadows of a D-pad or button are drawn once with
+/// `ImageRenderer`; afterwards the compositor only blends an image. Pressed
+/// highlights stay live views on top, or use a second cached variant.
+/// Everything is dropped when the current skin changes, and when
+/// `MemoryBudget` reclaims caches; what is on screen is drawn again on its
+/// next layout.
+@MainActor
+final class SkinRasterCache {
+    static let shared = SkinRasterCache()
+
+    struct Key: Hashable {
+        /// `ControllerSkin.rasterKey` or `DeltaControllerTheme.rasterKey`
+        let style: Int
+        let element: String
+        /// E.g. 1 for the pressed look of a button
+        let variant: Int
+        let width: CGFloat
+        let height: CGFloat
+        let scale: CGFloat
+    }
+
+    struct Statistics {
+        var renders = 0
+        var hits = 0
+        var renderTime: TimeInterval = 0
+        var bytes = 0
+    }
+
+    private var images: [Key: UIImage] = [:]
+    private(set) var statistics = Statistics()
+    private var memoryRegistration: MemoryBudget.Registration?
+
+    private init() {
+        // The budget calls back on the main thread
+        memoryRegistration = MemoryBudget.shared.register(
+            "Controller skin artwork",
+            tier: .cache,
+            usage: { [weak self] in
+                MainActor.assumeIsolated { self?.statistics.bytes ?? 0 }
+            },
+            shrink: { [weak self] limit in
+                MainActor.assumeIsolated {
+                    guard let self else { return 0 }
+                    if self.statistics.bytes > limit {
+                        self.removeAll()
+                    }
+                    return self.statistics.bytes
+                }
+            }
+        )
+    }
+
+    /// The cached bitmap for `key`, rendering `content` at the key's size plus `bleed` on each side
+    /// Bleed leaves room for shadows drawn outside the element's frame.
+    func image<Content: View>(for key: Key, bleed: CGFloat, content: () -> Content) -> UIImage? {
+        if let image = images[key] {
+            statistics.hits += 1
+            return image
+        }
+
+        let start = CACurrentMediaTime()
+        let renderer = ImageRenderer(
+            content: content()
+                .frame(width: key.width, height: key.height)
+                .padding(bleed)
+        )
+        renderer.scale = key.scale
+        renderer.isOpaque = false
+        guard let image = renderer.uiImage else { return nil }
+
+        let elapsed = CACurrentMediaTime() - start
+        images[key] = image
+        statistics.renders += 1
+        statistics.renderTime += elapsed
+        statistics.bytes += Self.cost(of: image)
+        Log.skin.debug("Rasterized \(key.element) \(Int(key.width))x\(Int(key.height))@\(Int(key.scale))x in \(String(format: "%.1f", elapsed * 1000)) ms")
+        return image
+    }
+
+    func removeAll() {
+        images.removeAll()
+        statistics.bytes = 0
+    }
+
+    /// Log renders, hits and bitmap memory since launch, e.g. when a game ends
+    func logStatistics() {
+        guard statistics.renders > 0 else { return }
+        let hitRatio = Double(statistics.hits) / Double(statistics.hits + statistics.renders)
+        Log.skin.info("Skin artwork: \(statistics.renders) renders in \(String(format: "%.0f ms", statistics.renderTime * 1000)), \(statistics.hits) hits (\(String(format: "%.1f%%", hitRatio * 100))); \(images.count) bitmaps, \(String(format: "%.1f MB", Double(statistics.bytes) / 1_048_576))")
+    }
+
+    private static func cost(of image: UIImage) -> Int {
+        guard let cgImage = image.cgImage else { return 0 }
+        return cgImage.bytesPerRow * cgImage.height
+    }
+}
+
+// MARK: - Rasterized Skin Layer
+
+/// Shows static controller artwork from `SkinRasterCache`
+///
+/// `content` must not depend on input state; put pressed highlights in a
+/// view above this one, or pass a different `variant` for each look. The
+/// layer takes `size` in layout; its shadows spill into the bleed around it.
+struct RasterizedSkinLayer<Content: View>: View {
+    let style: Int
+    let element: String
+    var variant = 0
+    let size: CGSize
+    var bleed: CGFloat = 12
+    @ViewBuilder let content: () -> Content
+
+    @Environment(\.displayScale) private var displayScale
+
+    var body: some View {
+        let key = SkinRasterCache.Key(
+            style: style,
+            element: element,
+            variant: variant,
+            width: size.width,
+            height: size.height,
+            scale: displayScale
+        )
+        if let image = SkinRasterCache.shared.image(for: key, bleed: bleed, content: content) {
+            Image(uiImage: image)
+                .frame(width: size.width, height: size.height)
+        } else {
+            content()
+                .frame(width: size.width, height: size.height)
+        }
+    }
+}
@@ -49,6 +49,7 @@ struct EmulationView: View {
     }
     
     var body: some View {
+        let _ = ViewBodyCounter.count("EmulationView")
         GeometryReader { geometry in
             let isLandscape = geometry.size.width > geometry.size.height
             let isIPad = geometry.size.width > 700 && geometry.size.height > 500
@@ -66,9 +67,9 @@ struct EmulationView: View {
                     portraitLayout(geometry: geometry, isIPad: isIPad)
                 }
                 
-                // FPS 计数器 (调试)
+                // FPS 计数器 (调试)，自行定时采样，不触发整个视图刷新
                 #if DEBUG
-                fpsOverlay
+                FrameStatsOverlay(frameState: viewModel.frameState)
                 #endif
                 
                 // 快进指示器
@@ -113,11 +114,14 @@ struct EmulationView: View {
         .persistentSystemOverlays(.hidden)
         .ignoresSafeArea()
         .onAppear {
+            ViewBodyCounter.beginSession()
             viewModel.start()
             setupGameController()
         }
         .onDisappear {
             viewModel.stop()
+            ViewBodyCounter.reportSession("Emulation")
+            SkinRasterCache.shared.logStatistics()
         }
         .sheet(isPresented: $showingSaveStates) {
             SaveStatesSheet(
@@ -125,6 +129,26 @@ struct EmulationView: View {
                 isLoading: $isLoadingState
             )
         }
+        // 卡死恢复：帧卡住后恢复，或上次运行卡死时被结束
+        .alert(
+            "Game Not Responding",
+            isPresented: Binding(
+                get: { viewModel.hangRecovery != nil },
+                set: { _ in }
+            ),
+            presenting: viewModel.hangRecovery
+        ) { offer in
+            if offer.autoSaveDate != nil {
+                Button("Load Auto-Save") {
+                    viewModel.resolveHangRecovery(loadAutoSave: true)
+                }
+            }
+            Button("Keep Playing", role: .cancel) {
+                viewModel.resolveHangRecovery(loadAutoSave: false)
+            }
+        } message: { offer in
+            Text(offer.message)
+        }
     }
     
     // MARK: - Delta Handheld Components
@@ -268,6 +292,7 @@ struct EmulationView: View {
         }
         
         var body: some View {
+            let _ = ViewBodyCounter.count("DeltaControllerDeckView")
             VStack(spacing: 8) {
                 // 主控制区域：D-Pad / MENU / 动作按钮（L/R已移至屏幕下方的过渡区域）
                 HStack(alignment: .center, spacing: 0) {
@@ -533,17 +558,22 @@ struct EmulationView: View {
         
         var body: some View {
             ZStack {
-                // D-Pad 底座
-                Circle()
-                    .fill(theme.dpadBaseColor)
-                    .frame(width: size * 1.05, height: size * 1.05)
-                    .shadow(color: .black.opacity(0.3), radius: 6, y: 4)
-                
-                // 十字形状
-                DPadCrossShape()
-                    .fill(theme.dpadCrossGradient)
-                    .frame(width: size, height: size)
-                    .shadow(color: .black.opacity(0.35), radius: 6, y: 3)
+                // 底座和十字形状预先栅格化
+                RasterizedSkinLayer(style: theme.rasterKey, element: "DeltaDPad", size: CGSize(width: size, height: size), bleed: 16) {
+                    ZStack {
+                        // D-Pad 底座
+                        Circle()
+                            .fill(theme.dpadBaseColor)
+                            .frame(width: size * 1.05, height: size * 1.05)
+                            .shadow(color: .black.opacity(0.3), radius: 6, y: 4)
+                        
+                        // 十字形状
+                        DPadCrossShape()
+                            .fill(theme.dpadCrossGradient)
+                            .frame(width: size, height: size)
+                            .shadow(color: .black.opacity(0.35), radius: 6, y: 3)
+                    }
+                }
                 
                 // 方向指示高亮
                 ForEach(Array(pressedDirections), id: \.self) { dir in
@@ -604,14 +634,14 @@ struct EmulationView: View {
             // 找出需要释放的方向
             let toRelease = pressedDirections.subtracting(newDirections)
             for dir in toRelease {
-                print("🎯 DeltaDPad: \(dir) released")
+                Log.input.debug("DeltaDPad: \(dir) released")
                 onInput(dir, false)
             }
             
             // 找出需要按下的方向
             let toPress = newDirections.subtracting(pressedDirections)
             for dir in toPress {
-                print("🎯 DeltaDPad: \(dir) pressed")
+                Log.input.debug("DeltaDPad: \(dir) pressed")
                 onInput(dir, true)
             }
             
@@ -620,7 +650,7 @@ struct EmulationView: View {
         
         private func releaseAllDirections() {
             for dir in pressedDirections {
-                print("🎯 DeltaDPad: \(dir) released")
+                Log.input.debug("DeltaDPad: \(dir) released")
                 onInput(dir, false)
             }
             pressedDirections.removeAll()
@@ -647,34 +677,29 @@ struct EmulationView: View {
         
         var body: some View {
             ZStack {
-                Circle()
-                    .fill(theme.actionBaseColor)
-                    .frame(width: size * 1.1, height: size * 1.1)
-                    .shadow(color: .black.opacity(0.25), radius: 6, y: 3)
+                RasterizedSkinLayer(style: theme.rasterKey, element: "DeltaActionPlate", size: CGSize(width: size * 1.1, height: size * 1.1)) {
+                    Circle()
+                        .fill(theme.actionBaseColor)
+                        .shadow(color: .black.opacity(0.25), radius: 6, y: 3)
+                }
                 
                 if system.hasXYButtons {
-                    DeltaActionButton(label: "Y", color: theme.actionColors[.y] ?? .green) { onInput(.y, $0) }
-                        .frame(width: size * 0.4, height: size * 0.4)
+                    DeltaActionButton(label: "Y", color: theme.actionColors[.y] ?? .green, size: size * 0.4) { onInput(.y, $0) }
                         .offset(x: -size * 0.35)
                     
-                    DeltaActionButton(label: "X", color: theme.actionColors[.x] ?? .blue) { onInput(.x, $0) }
-                        .frame(width: size * 0.4, height: size * 0.4)
+                    DeltaActionButton(label: "X", color: theme.actionColors[.x] ?? .blue, size: size * 0.4) { onInput(.x, $0) }
                         .offset(y: -size * 0.35)
                     
-                    DeltaActionButton(label: "A", color: theme.actionColors[.a] ?? .red) { onInput(.a, $0) }
-                        .frame(width: size * 0.4, height: size * 0.4)
+                    DeltaActionButton(label: "A", color: theme.actionColors[.a] ?? .red, size: size * 0.4) { onInput(.a, $0) }
                         .offset(x: size * 0.35)
                     
-                    DeltaActionButton(label: "B", color: theme.actionColors[.b] ?? .yellow) { onInput(.b, $0) }
-                        .frame(width: size * 0.4, height: size * 0.4)
+                    DeltaActionButton(label: "B", color: theme.actionColors[.b] ?? .yellow, size: size * 0.4) { onInput(.b, $0) }
                         .offset(y: size * 0.35)
                 } else {
-                    DeltaActionButton(label: "B", color: theme.actionColors[.b] ?? .yellow) { onInput(.b, $0) }
-                        .frame(width: size * 0.45, height: size * 0.45)
+                    DeltaActionButton(label: "B", color: theme.actionColors[.b] ?? .yellow, size: size * 0.45) { onInput(.b, $0) }
                         .offset(x: -size * 0.15, y: size * 0.2)
                     
-                    DeltaActionButton(label: "A", color: theme.actionColors[.a] ?? .red) { onInput(.a, $0) }
-                        .frame(width: size * 0.45, height: size * 0.45)
+                    DeltaActionButton(label: "A", color: theme.actionColors[.a] ?? .red, size: size * 0.45) { onInput(.a, $0) }
                         .offset(x: size * 0.25, y: -size * 0.2)
                 }
             }
@@ -684,45 +709,50 @@ struct EmulationView: View {
     struct DeltaActionButton: View {
         let label: String
         let color: Color
+        let size: CGFloat
         let onPressed: (Bool) -> Void
         
         @State private var isPressed = false
         
         var body: some View {
-            Circle()
-                .fill(
-                    LinearGradient(
-                        colors: [
-                            color.blended(with: .white, amount: 0.2),
-                            color.blended(with: .black, amount: 0.2)
-                        ],
-                        startPoint: .topLeading,
-                        endPoint: .bottomTrailing
+            // 渐变、描边、标签和阴影预先栅格化，按下时只做缩放
+            RasterizedSkinLayer(style: color.hashValue, element: "DeltaActionButton.\(label)", size: CGSize(width: size, height: size)) {
+                Circle()
+                    .fill(
+                        LinearGradient(
+                            colors: [
+                                color.blended(with: .white, amount: 0.2),
+                                color.blended(with: .black, amount: 0.2)
+                            ],
+                            startPoint: .topLeading,
+                            endPoint: .bottomTrailing
+                        )
                     )
-                )
-                .overlay {
-                    Circle()
-                        .stroke(Color.black.opacity(0.25), lineWidth: 1)
-                }
-                .overlay {
-                    Text(label)
-                        .font(.system(size: 18, weight: .bold, design: .rounded))
-                        .foregroundStyle(Color.white)
-                }
-                .scaleEffect(isPressed ? 0.92 : 1)
-                .shadow(color: .black.opacity(0.3), radius: 6, y: 4)
-                .gesture(
-                    DragGesture(minimumDistance: 0)
-                        .onChanged { _ in
-                            guard !isPressed else { return }
-                            isPressed = true
-                            onPressed(true)
-                        }
-                        .onEnded { _ in
-                            isPressed = false
-                            onPressed(false)
-                        }
-                )
+                    .overlay {
+                        Circle()
+                            .stroke(Color.black.opacity(0.25), lineWidth: 1)
+                    }
+                    .overlay {
+                        Text(label)
+                            .font(.system(size: 18, weight: .bold, design: .rounded))
+                            .foregroundStyle(Color.white)
+                    }
+                    .shadow(color: .black.opacity(0.3), radius: 6, y: 4)
+            }
+            .contentShape(Circle())
+            .scaleEffect(isPressed ? 0.92 : 1)
+            .gesture(
+                DragGesture(minimumDistance: 0)
+                    .onChanged { _ in
+                        guard !isPressed else { return }
+                        isPressed = true
+                        onPressed(true)
+                    }
+                    .onEnded { _ in
+                        isPressed = false
+                        onPressed(false)
+                    }
+            )
         }
     }
     
@@ -867,6 +897,16 @@ struct EmulationView: View {
             )
         }
         
+        /// Identifies the D-pad and action artwork for `SkinRasterCache`
+        var rasterKey: Int {
+            var hasher = Hasher()
+            hasher.combine(dpadBaseColor)
+            hasher.combine(dpadCrossLight)
+            hasher.combine(dpadCrossDark)
+            hasher.combine(actionBaseColor)
+            return hasher.finalize()
+        }
+        
         var dpadCrossGradient: LinearGradient {
             LinearGradient(
                 colors: [dpadCrossLight, dpadCrossDark],
@@ -1300,23 +1340,6 @@ struct EmulationView: View {
     
     // MARK: - 辅助视图
     
-    private var fpsOverlay: some View {
-        VStack {
-            HStack {
-                Spacer()
-                Text(String(format: "%.1f FPS", viewModel.currentFPS))
-                    .font(.caption.monospacedDigit())
-                    .foregroundStyle(.green)
-                    .padding(6)
-                    .background(.black.opacity(0.6))
-                    .clipShape(RoundedRectangle(cornerRadius: 4))
-                    .padding(.trailing, 8)
-                    .padding(.top, 8)
-            }
-            Spacer()
-        }
-    }
-    
     private var fastForwardIndicator: some View {
                     VStack {
                         HStack {
@@ -1336,11 +1359,20 @@ struct EmulationView: View {
                 
     private var loadingOverlay: some View {
                     VStack(spacing: 16) {
-                        ProgressView()
-                            .scaleEffect(1.5)
-                            .tint(.white)
-                        Text("Loading...")
-                            .foregroundStyle(.white.opacity(0.7))
+                        if let progress = viewModel.extractionProgress {
+                            ProgressView(value: progress)
+                                .progressViewStyle(.circular)
+                                .scaleEffect(1.5)
+                                .tint(.white)
+                            Text("Extracting... \(Int(progress * 100))%")
+                                .foregroundStyle(.white.opacity(0.7))
+                        } else {
+                            ProgressView()
+                                .scaleEffect(1.5)
+                                .tint(.white)
+                            Text("Loading...")
+                                .foregroundStyle(.white.opacity(0.7))
+                        }
                     }
                 }
                 
@@ -1423,11 +1455,43 @@ struct GameDisplayView: View {
     @ObservedObject var viewModel: EmulationViewModel
     
     var body: some View {
+        let _ = ViewBodyCounter.count("GameDisplayView")
         MetalGameView(viewModel: viewModel)
             .background(Color.black)
     }
 }
 
+// MARK: - Frame Stats Overlay
+
+/// FPS and frame time, sampled from the frame store twice a second
+///
+/// Reads the store on its own timeline, so nothing above it observes per-frame state.
+struct FrameStatsOverlay: View {
+    let frameState: FrameStateStore
+    
+    var body: some View {
+        TimelineView(.periodic(from: .now, by: 0.5)) { _ in
+            let _ = ViewBodyCounter.count("FrameStatsOverlay")
+            let sample = frameState.sample
+            VStack {
+                HStack {
+                    Spacer()
+                    Text(String(format: "%.1f FPS  %.1f ms", sample.fps, sample.frameTime * 1000))
+                        .font(.caption.monospacedDigit())
+                        .foregroundStyle(.green)
+                        .padding(6)
+                        .background(.black.opacity(0.6))
+                        .clipShape(RoundedRectangle(cornerRadius: 4))
+                        .padding(.trailing, 8)
+                        .padding(.top, 8)
+                }
+                Spacer()
+            }
+        }
+        .allowsHitTesting(false)
+    }
+}
+
 // MARK: - Metal Game View
 
 struct MetalGameView: UIViewRepresentable {
@@ -1436,10 +1500,10 @@ struct MetalGameView: UIViewRepresentable {
     func makeUIView(context: Context) -> MTKView {
         let mtkView = MTKView()
         guard let device = MTLCreateSystemDefaultDevice() else {
-            print("❌ Failed to create Metal device")
+            Log.video.error("Failed to create Metal device")
             return mtkView
         }
-        print("✅ Metal device created: \(device.name)")
+        Log.video.info("Metal device created: \(device.name)")
         
         mtkView.device = device
         mtkView.colorPixelFormat = .bgra8Unorm
@@ -1455,6 +1519,7 @@ struct MetalGameView: UIViewRepresentable {
     }
     
     func updateUIView(_ uiView: MTKView, context: Context) {
+        ViewBodyCounter.count("MetalGameView.update")
         context.coordinator.viewModel = viewModel
     }
     
@@ -1476,14 +1541,14 @@ struct MetalGameView: UIViewRepresentable {
         }
         
         func setupMetal(device: MTLDevice) {
-            print("🔧 Setting up Metal resources...")
+            Log.video.debug("Setting up Metal resources...")
             
             commandQueue = device.makeCommandQueue()
             if commandQueue == nil {
-                print("❌ Failed to create command queue")
+                Log.video.error("Failed to create command queue")
                 return
             }
-            print("✅ Command queue created")
+            Log.video.debug("Command queue created")
             
             // Create sampler state
             let samplerDescriptor = MTLSamplerDescriptor()
@@ -1493,10 +1558,10 @@ struct MetalGameView: UIViewRepresentable {
             samplerDescriptor.tAddressMode = .clampToEdge
             samplerState = device.makeSamplerState(descriptor: samplerDescriptor)
             if samplerState == nil {
-                print("❌ Failed to create sampler state")
+                Log.video.error("Failed to create sampler state")
                 return
             }
-            print("✅ Sampler state created")
+            Log.video.debug("Sampler state created")
             
             // Create vertex buffer for a full-screen quad
             let vertices: [Float] = [
@@ -1508,10 +1573,10 @@ struct MetalGameView: UIViewRepresentable {
             ]
             vertexBuffer = device.makeBuffer(bytes: vertices, length: vertices.count * MemoryLayout<Float>.size, options: [])
             if vertexBuffer == nil {
-                print("❌ Failed to create vertex buffer")
+                Log.video.error("Failed to create vertex buffer")
                 return
             }
-            print("✅ Vertex buffer created")
+            Log.video.debug("Vertex buffer created")
             
             // Create shader library and pipeline
             let shaderSource = """
@@ -1541,17 +1606,17 @@ struct MetalGameView: UIViewRepresentable {
             
             do {
                 let library = try device.makeLibrary(source: shaderSource, options: nil)
-                print("✅ Shader library created")
+                Log.video.debug("Shader library created")
                 
                 guard let vertexFunction = library.makeFunction(name: "vertexShader") else {
-                    print("❌ Failed to find vertexShader function")
+                    Log.video.error("Failed to find vertexShader function")
                     return
                 }
                 guard let fragmentFunction = library.makeFunction(name: "fragmentShader") else {
-                    print("❌ Failed to find fragmentShader function")
+                    Log.video.error("Failed to find fragmentShader function")
                     return
                 }
-                print("✅ Shader functions loaded")
+                Log.video.debug("Shader functions loaded")
                 
                 let pipelineDescriptor = MTLRenderPipelineDescriptor()
                 pipelineDescriptor.vertexFunction = vertexFunction
@@ -1559,10 +1624,10 @@ struct MetalGameView: UIViewRepresentable {
                 pipelineDescriptor.colorAttachments[0].pixelFormat = .bgra8Unorm
                 
                 pipelineState = try device.makeRenderPipelineState(descriptor: pipelineDescriptor)
-                print("✅ Pipeline state created")
-                print("✅ Metal setup complete!")
+                Log.video.debug("Pipeline state created")
+                Log.video.info("Metal setup complete!")
             } catch {
-                print("❌ Failed to create Metal pipeline: \(error)")
+                Log.video.error("Failed to create Metal pipeline: \(error)")
             }
         }
         
@@ -1579,7 +1644,7 @@ struct MetalGameView: UIViewRepresentable {
                   let vertexBuffer = vertexBuffer,
                   let samplerState = samplerState else {
                 if drawCount <= 3 {
-                    print("⚠️ Metal draw: missing resources")
+                    Log.video.debug("Metal draw: missing resources")
                 }
                 return
             }
@@ -1588,7 +1653,7 @@ struct MetalGameView: UIViewRepresentable {
             guard let videoData = viewModel.getVideoBuffer(),
                   videoData.width > 0 && videoData.height > 0 else {
                 if drawCount <= 10 || drawCount % 60 == 0 {
-                    print("⚠️ Metal draw #\(drawCount): no video data, videoFrameCount=\(viewModel.videoFrameCount)")
+                    Log.video.debug("Metal draw #\(drawCount): no video data, videoFrameCount=\(viewModel.videoFrameCount)")
                 }
                 // No video data, just clear the screen
                 guard let commandBuffer = commandQueue.makeCommandBuffer(),
@@ -1602,11 +1667,9 @@ struct MetalGameView: UIViewRepresentable {
                 return
             }
             
-            #if DEBUG
-            if drawCount <= 3 {
-                print("🖼️ Rendering: \(videoData.width)x\(videoData.height), format: \(videoData.pixelFormat)")
+            if Log.isDebugEnabled && drawCount <= 3 {
+                Log.video.debug("Rendering: \(videoData.width)x\(videoData.height), format: \(videoData.pixelFormat)")
             }
-            #endif
             
             // Create or update texture
             if texture == nil || texture!.width != videoData.width || texture!.height != videoData.height {
@@ -1618,13 +1681,11 @@ struct MetalGameView: UIViewRepresentable {
                 )
                 textureDescriptor.usage = [.shaderRead]
                 texture = view.device?.makeTexture(descriptor: textureDescriptor)
-                #if DEBUG
-                print("🖼️ Texture created: \(videoData.width)x\(videoData.height)")
-                #endif
+                Log.video.debug("Texture created: \(videoData.width)x\(videoData.height)")
             }
             
             guard let texture = texture else {
-                print("⚠️ Metal draw: texture is nil")
+                Log.video.debug("Metal draw: texture is nil")
                 return
             }
             
@@ -1632,82 +1693,13 @@ struct MetalGameView: UIViewRepresentable {
             // Note: pitch is in bytes, and may include padding
             let width = videoData.width
             let height = videoData.height
-            let srcPitch = videoData.pitch  // Source pitch in bytes
             var bgraData = [UInt8](repeating: 0, count: width * height * 4)
             
             videoData.data.withUnsafeBytes { srcBuffer in
-                let srcBytes = srcBuffer.bindMemory(to: UInt8.self)
-                
-                switch videoData.pixelFormat {
-                case .xrgb8888:
-                    // XRGB8888: 4 bytes per pixel (X, R, G, B in memory as little-endian)
-                    // Memory layout: B, G, R, X (little-endian)
-                    for y in 0..<height {
-                        let srcRowStart = y * srcPitch
-                        let dstRowStart = y * width * 4
-                        
-                        for x in 0..<width {
-                            let srcOffset = srcRowStart + x * 4
-                            let dstOffset = dstRowStart + x * 4
-                            
-                            // XRGB8888 little-endian: memory is [B, G, R, X]
-                            // We need BGRA, so just copy and set alpha
-                            bgraData[dstOffset + 0] = srcBytes[srcOffset + 0]  // B
-                            bgraData[dstOffset + 1] = srcBytes[srcOffset + 1]  // G
-                            bgraData[dstOffset + 2] = srcBytes[srcOffset + 2]  // R
-                            bgraData[dstOffset + 3] = 255  // A (replace X with full alpha)
-                        }
-                    }
-                    
-                case .rgb565:
-                    // RGB565: 2 bytes per pixel
-                    for y in 0..<height {
-                        let srcRowStart = y * srcPitch
-                        let dstRowStart = y * width * 4
-                        
-                        for x in 0..<width {
-                            let srcOffset = srcRowStart + x * 2
-                            let lo = UInt16(srcBytes[srcOffset])
-                            let hi = UInt16(srcBytes[srcOffset + 1])
-                            let pixel = lo | (hi << 8)
-                            
-                            // RGB565: RRRRRGGGGGGBBBBB
-                            let r = UInt8((pixel >> 11) & 0x1F) << 3
-                            let g = UInt8((pixel >> 5) & 0x3F) << 2
-                            let b = UInt8(pixel & 0x1F) << 3
-                            
-                            let dstOffset = dstRowStart + x * 4
-                            bgraData[dstOffset + 0] = b  // B
-                            bgraData[dstOffset + 1] = g  // G
-                            bgraData[dstOffset + 2] = r  // R
-                            bgraData[dstOffset + 3] = 255  // A
-                        }
-                    }
-                    
-                case .rgb1555:
-                    // RGB1555 (0RGB1555): 2 bytes per pixel
-                    for y in 0..<height {
-                        let srcRowStart = y * srcPitch
-                        let dstRowStart = y * width * 4
-                        
-                        for x in 0..<width {
-                            let srcOffset = srcRowStart + x * 2
-                            let lo = UInt16(srcBytes[srcOffset])
-                            let hi = UInt16(srcBytes[srcOffset + 1])
-                            let pixel = lo | (hi << 8)
-                            
-                            // 0RGB1555: 0RRRRRGGGGGBBBBB
-                            let r = UInt8((pixel >> 10) & 0x1F) << 3
-                            let g = UInt8((pixel >> 5) & 0x1F) << 3
-                            let b = UInt8(pixel & 0x1F) << 3
-                            
-                            let dstOffset = dstRowStart + x * 4
-                            bgraData[dstOffset + 0] = b  // B
-                            bgraData[dstOffset + 1] = g  // G
-                            bgraData[dstOffset + 2] = r  // R
-                            bgraData[dstOffset + 3] = 255  // A
-                        }
-                    }
+                bgraData.withUnsafeMutableBytes { dstBuffer in
+                    guard let src = srcBuffer.baseAddress, let dst = dstBuffer.baseAddress else { return }
+                    PixelConversion.convertToBGRA(src, width: width, height: height, pitch: videoData.pitch,
+                                                  format: videoData.pixelFormat, into: dst)
                 }
             }
             
@@ -1715,28 +1707,12 @@ struct MetalGameView: UIViewRepresentable {
                                    size: MTLSize(width: width, height: height, depth: 1))
             texture.replace(region: region, mipmapLevel: 0, withBytes: bgraData, bytesPerRow: width * 4)
             
-            // Debug: Check if we have non-zero pixel data (only log if all black)
-            #if DEBUG
-            if drawCount <= 5 || drawCount % 300 == 0 {
-                var nonZeroCount = 0
-                for i in stride(from: 0, to: min(1000, bgraData.count), by: 4) {
-                    if bgraData[i] != 0 || bgraData[i+1] != 0 || bgraData[i+2] != 0 {
-                        nonZeroCount += 1
-                        break
-                    }
-                }
-                if nonZeroCount == 0 {
-                    print("⚠️ Frame #\(drawCount): All pixels are black (game may be loading or needs input)")
-                }
-            }
-            #endif
-            
             // Render
             guard let commandBuffer = commandQueue.makeCommandBuffer(),
                   let renderPassDescriptor = view.currentRenderPassDescriptor,
                   let renderEncoder = commandBuffer.makeRenderCommandEncoder(descriptor: renderPassDescriptor) else {
                 if drawCount <= 5 {
-                    print("⚠️ Failed to create render resources")
+                    Log.video.debug("Failed to create render resources")
                 }
                 return
             }
@@ -1774,6 +1750,7 @@ struct VirtualControllerView: View {
     @AppStorage("controllerHaptics") private var hapticsEnabled = true
     
     var body: some View {
+        let _ = ViewBodyCounter.count("VirtualControllerView")
         let layout = ControllerLayoutCalculator(
             screenSize: screenSize,
             safeAreaInsets: safeAreaInsets,
@@ -2020,7 +1997,7 @@ struct VirtualControllerView: View {
             hapticEngine = try CHHapticEngine()
             try hapticEngine?.start()
         } catch {
-            print("Haptic engine failed: \(error)")
+            Log.input.error("Haptic engine failed: \(error)")
         }
     }
 }
@@ -2169,6 +2146,36 @@ struct SkinnedDPad: View {
     @State private var pressedDirections: Set<GameInput> = []
     
     var body: some View {
+        let _ = ViewBodyCounter.count("SkinnedDPad")
+        ZStack {
+            // 静态部分预先栅格化，只有按下的高亮实时绘制
+            RasterizedSkinLayer(style: skin.rasterKey, element: "SkinnedDPad", size: CGSize(width: size, height: size), bleed: 16) {
+                staticLayer
+            }
+            
+            // 方向高亮指示
+            ForEach([GameInput.up, .down, .left, .right], id: \.self) { direction in
+                if pressedDirections.contains(direction) {
+                    directionHighlight(for: direction)
+                    directionIcon(for: direction, isPressed: true)
+                }
+            }
+        }
+        .frame(width: size, height: size)
+        .contentShape(Circle())
+        .gesture(
+            DragGesture(minimumDistance: 0)
+                .onChanged { value in
+                    handleDrag(at: value.location)
+                }
+                .onEnded { _ in
+                    releaseAllDirections()
+                }
+        )
+    }
+    
+    // 底座、十字键、边框、箭头和中心点，不随输入变化
+    private var staticLayer: some View {
         ZStack {
             // D-Pad 底座 - 使用皮肤颜色
             Circle()
@@ -2187,16 +2194,9 @@ struct SkinnedDPad: View {
                 .stroke(skin.dpadColor.color.opacity(0.3), lineWidth: 1)
                 .frame(width: size * 0.85, height: size * 0.85)
             
-            // 方向高亮指示
-            ForEach([GameInput.up, .down, .left, .right], id: \.self) { direction in
-                if pressedDirections.contains(direction) {
-                    directionHighlight(for: direction)
-                }
-            }
-            
             // 方向箭头图标
             ForEach([GameInput.up, .down, .left, .right], id: \.self) { direction in
-                directionIcon(for: direction)
+                directionIcon(for: direction, isPressed: false)
             }
             
             // 中心圆点装饰
@@ -2204,17 +2204,6 @@ struct SkinnedDPad: View {
                 .fill(skin.dpadColor.color.opacity(0.5))
                 .frame(width: size * 0.12, height: size * 0.12)
         }
-        .frame(width: size, height: size)
-        .contentShape(Circle())
-        .gesture(
-            DragGesture(minimumDistance: 0)
-                .onChanged { value in
-                    handleDrag(at: value.location)
-                }
-                .onEnded { _ in
-                    releaseAllDirections()
-                }
-        )
     }
     
     // 处理拖拽手势，计算八方向输入
@@ -2298,9 +2287,8 @@ struct SkinnedDPad: View {
     
     // 方向图标
     @ViewBuilder
-    private func directionIcon(for direction: GameInput) -> some View {
+    private func directionIcon(for direction: GameInput, isPressed: Bool) -> some View {
         let offset: CGFloat = size * 0.28
-        let isPressed = pressedDirections.contains(direction)
         
         Image(systemName: iconName(for: direction))
             .font(.system(size: size * 0.15, weight: .bold))
@@ -2385,21 +2373,23 @@ struct SkinnedActionButtons: View {
     }
     
     var body: some View {
+        let _ = ViewBodyCounter.count("SkinnedActionButtons")
         ZStack {
-            // 按钮区域底座 - 深色圆形背景
-            Circle()
-                .fill(
-                    LinearGradient(
-                        colors: [
-                            skin.backgroundColor.color.blended(with: .black, amount: 0.15),
-                            skin.backgroundColor.color.blended(with: .black, amount: 0.25)
-                        ],
-                        startPoint: .top,
-                        endPoint: .bottom
+            // 按钮区域底座 - 深色圆形背景（预先栅格化）
+            RasterizedSkinLayer(style: skin.rasterKey, element: "SkinnedActionPlate", size: CGSize(width: size * 1.1, height: size * 1.1)) {
+                Circle()
+                    .fill(
+                        LinearGradient(
+                            colors: [
+                                skin.backgroundColor.color.blended(with: .black, amount: 0.15),
+                                skin.backgroundColor.color.blended(with: .black, amount: 0.25)
+                            ],
+                            startPoint: .top,
+                            endPoint: .bottom
+                        )
                     )
-                )
-                .frame(width: size * 1.1, height: size * 1.1)
-                .shadow(color: .black.opacity(0.35), radius: 8, y: 4)
+                    .shadow(color: .black.opacity(0.35), radius: 8, y: 4)
+            }
             
             if system.hasXYButtons {
                 // 四按钮布局 (XYAB)
@@ -2480,6 +2470,34 @@ struct ColoredActionButton: View {
     @State private var isPressed = false
     
     var body: some View {
+        // 按下与松开两种外观各栅格化一次，缩放动画实时合成
+        RasterizedSkinLayer(
+            style: color.hashValue,
+            element: "ColoredActionButton.\(label)",
+            variant: isPressed ? 1 : 0,
+            size: CGSize(width: size, height: size)
+        ) {
+            artwork(isPressed: isPressed)
+        }
+        .scaleEffect(isPressed ? 0.92 : 1)
+        .contentShape(Circle())
+        .gesture(
+            DragGesture(minimumDistance: 0)
+                .onChanged { _ in
+                    guard !isPressed else { return }
+                    isPressed = true
+                    onPressed(true)
+                    playHaptic()
+                }
+                .onEnded { _ in
+                    isPressed = false
+                    onPressed(false)
+                }
+        )
+        .animation(.easeOut(duration: 0.08), value: isPressed)
+    }
+    
+    private func artwork(isPressed: Bool) -> some View {
         Circle()
             .fill(
                 LinearGradient(
@@ -2491,7 +2509,6 @@ struct ColoredActionButton: View {
                     endPoint: .bottomTrailing
                 )
             )
-            .frame(width: size, height: size)
             .overlay {
                 Circle()
                     .stroke(Color.black.opacity(0.25), lineWidth: 1)
@@ -2515,22 +2532,7 @@ struct ColoredActionButton: View {
                     .foregroundStyle(Color.white)
                     .shadow(color: .black.opacity(0.4), radius: 1, y: 1)
             }
-            .scaleEffect(isPressed ? 0.92 : 1)
             .shadow(color: .black.opacity(0.3), radius: isPressed ? 3 : 6, y: isPressed ? 2 : 4)
-            .gesture(
-                DragGesture(minimumDistance: 0)
-                    .onChanged { _ in
-                        guard !isPressed else { return }
-                        isPressed = true
-                        onPressed(true)
-                        playHaptic()
-                    }
-                    .onEnded { _ in
-                        isPressed = false
-                        onPressed(false)
-                    }
-            )
-            .animation(.easeOut(duration: 0.08), value: isPressed)
     }
     
     private func playHaptic() {
@@ -2556,6 +2558,35 @@ struct SkinnedActionButton: View {
     @State private var isPressed = false
     
     var body: some View {
+        // 按下与松开两种外观各栅格化一次
+        RasterizedSkinLayer(
+            style: skin.rasterKey,
+            element: "SkinnedActionButton.\(label)",
+            variant: isPressed ? 1 : 0,
+            size: CGSize(width: size, height: size)
+        ) {
+            artwork(isPressed: isPressed)
+        }
+        .contentShape(Rectangle())
+        .scaleEffect(isPressed ? 0.95 : 1.0)
+        .animation(.easeOut(duration: 0.08), value: isPressed)
+        .gesture(
+            DragGesture(minimumDistance: 0)
+                .onChanged { _ in
+                    if !isPressed {
+                        isPressed = true
+                        onPressed(true)
+                        playHaptic()
+                    }
+                }
+                .onEnded { _ in
+                    isPressed = false
+                    onPressed(false)
+                }
+        )
+    }
+    
+    private func artwork(isPressed: Bool) -> some View {
         ZStack {
             // 按钮阴影
             buttonShape
@@ -2596,22 +2627,6 @@ struct SkinnedActionButton: View {
                 }
                 .offset(y: isPressed ? 2 : 0)
         }
-        .scaleEffect(isPressed ? 0.95 : 1.0)
-        .animation(.easeOut(duration: 0.08), value: isPressed)
-        .gesture(
-            DragGesture(minimumDistance: 0)
-                .onChanged { _ in
-                    if !isPressed {
-                        isPressed = true
-                        onPressed(true)
-                        playHaptic()
-                    }
-                }
-                .onEnded { _ in
-                    isPressed = false
-                    onPressed(false)
-                }
-        )
     }
     
     private var buttonShape: AnyShape {
@@ -3478,6 +3493,7 @@ struct ConsoleControllerAreaView: View {
     }
     
     var body: some View {
+        let _ = ViewBodyCounter.count("ConsoleControllerAreaView")
         VStack(spacing: 4) {
             // 肩键区域
             if system.hasShoulderButtons {
@@ -3580,7 +3596,7 @@ struct ConsoleControllerAreaView: View {
             hapticEngine = try CHHapticEngine()
             try hapticEngine?.start()
         } catch {
-            print("Haptic engine failed: \(error)")
+            Log.input.error("Haptic engine failed: \(error)")
         }
     }
 }
@@ -3808,6 +3824,35 @@ struct ConsoleDPad: View {
     private var pressedColor: Color { skin.buttonPressedColor.color }
     
     var body: some View {
+        ZStack {
+            // 静态部分预先栅格化，只有按下的高亮实时绘制
+            RasterizedSkinLayer(style: skin.rasterKey, element: "ConsoleDPad", size: CGSize(width: size, height: size), bleed: 16) {
+                staticLayer
+            }
+            
+            // 方向高亮指示
+            ForEach([GameInput.up, .down, .left, .right], id: \.self) { direction in
+                if pressedDirections.contains(direction) {
+                    directionHighlight(for: direction)
+                    directionIcon(for: direction, isPressed: true)
+                }
+            }
+        }
+        .frame(width: size, height: size)
+        .contentShape(Circle())
+        .gesture(
+            DragGesture(minimumDistance: 0)
+                .onChanged { value in
+                    handleDrag(at: value.location)
+                }
+                .onEnded { _ in
+                    releaseAllDirections()
+                }
+        )
+    }
+    
+    // 底座、十字键、箭头和中心点，不随输入变化
+    private var staticLayer: some View {
         ZStack {
             // D-Pad 底座阴影
             DPadCrossShape()
@@ -3855,16 +3900,9 @@ struct ConsoleDPad: View {
                         .frame(width: size * 0.9, height: size * 0.9)
                 }
             
-            // 方向高亮指示
-            ForEach([GameInput.up, .down, .left, .right], id: \.self) { direction in
-                if pressedDirections.contains(direction) {
-                    directionHighlight(for: direction)
-                }
-            }
-            
             // 方向箭头图标
             ForEach([GameInput.up, .down, .left, .right], id: \.self) { direction in
-                directionIcon(for: direction)
+                directionIcon(for: direction, isPressed: false)
             }
             
             // 中心圆点
@@ -3872,17 +3910,6 @@ struct ConsoleDPad: View {
                 .fill(buttonColor.opacity(0.3))
                 .frame(width: size * 0.15, height: size * 0.15)
         }
-        .frame(width: size, height: size)
-        .contentShape(Circle())
-        .gesture(
-            DragGesture(minimumDistance: 0)
-                .onChanged { value in
-                    handleDrag(at: value.location)
-                }
-                .onEnded { _ in
-                    releaseAllDirections()
-                }
-        )
     }
     
     // 处理拖拽手势，计算八方向输入
@@ -3966,9 +3993,8 @@ struct ConsoleDPad: View {
     
     // 方向图标
     @ViewBuilder
-    private func directionIcon(for direction: GameInput) -> some View {
+    private func directionIcon(for direction: GameInput, isPressed: Bool) -> some View {
         let offset: CGFloat = size * 0.28
-        let isPressed = pressedDirections.contains(direction)
         
         Image(systemName: "arrowtriangle.\(directionName(direction)).fill")
             .font(.system(size: size * 0.12, weight: .bold))
@@ -4147,6 +4173,40 @@ struct ConsoleActionButton: View {
     @State private var isPressed = false
     
     var body: some View {
+        // 按下与松开两种外观各栅格化一次
+        RasterizedSkinLayer(
+            style: styleKey,
+            element: "ConsoleActionButton.\(label)",
+            variant: isPressed ? 1 : 0,
+            size: CGSize(width: size, height: size)
+        ) {
+            artwork(isPressed: isPressed)
+        }
+        .contentShape(Circle())
+        .gesture(
+            DragGesture(minimumDistance: 0)
+                .onChanged { _ in
+                    if !isPressed {
+                        isPressed = true
+                        onPressed(true)
+                        triggerHaptic()
+                    }
+                }
+                .onEnded { _ in
+                    isPressed = false
+                    onPressed(false)
+                }
+        )
+    }
+    
+    private var styleKey: Int {
+        var hasher = Hasher()
+        hasher.combine(color)
+        hasher.combine(pressedColor)
+        return hasher.finalize()
+    }
+    
+    private func artwork(isPressed: Bool) -> some View {
         ZStack {
             // 按钮阴影
             Circle()
@@ -4187,20 +4247,6 @@ struct ConsoleActionButton: View {
                 }
                 .offset(y: isPressed ? 1 : 0)
         }
-        .gesture(
-            DragGesture(minimumDistance: 0)
-                .onChanged { _ in
-                    if !isPressed {
-                        isPressed = true
-                        onPressed(true)
-                        triggerHaptic()
-                    }
-                }
-                .onEnded { _ in
-                    isPressed = false
-                    onPressed(false)
-                }
-        )
     }
     
     private func triggerHaptic() {
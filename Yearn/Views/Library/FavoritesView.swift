@@ -80,16 +80,18 @@ struct FavoritesView: View {
     
     /// 启动游戏前检查 BIOS 是否可用
     private func launchGame(_ game: Game) {
-        // 检查是否需要 BIOS
-        if game.system == .ps1 && !biosManager.checkPS1BIOSAvailable() {
-            pendingGame = game
-            showingBIOSAlert = true
-            return
+        Task { @MainActor in
+            // 等启动时的 BIOS 初始化完成，避免读到旧状态
+            guard await biosManager.isBIOSReady(for: game.system) else {
+                pendingGame = game
+                showingBIOSAlert = true
+                return
+            }
+            
+            viewModel.recordGamePlayed(game)
+            appState.currentGame = game
+            appState.isEmulating = true
         }
-        
-        viewModel.recordGamePlayed(game)
-        appState.currentGame = game
-        appState.isEmulating = true
     }
 }
 
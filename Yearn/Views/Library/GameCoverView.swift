@@ -16,6 +16,7 @@ struct GameCoverView: View {
     
     @State private var coverImage: UIImage?
     @State private var isLoading = true
+    @Environment(\.displayScale) private var displayScale
     
     enum CoverSize {
         case small   // 60x60
@@ -95,21 +96,24 @@ struct GameCoverView: View {
         }
     }
     
+    /// Long side of the cover in pixels; covers are decoded at this size
+    private var maxPixelSize: Int {
+        Int((max(size.dimensions.width, size.dimensions.height) * displayScale).rounded(.up))
+    }
+    
     private func loadCover() async {
-        isLoading = true
-        
-        // Try to load custom cover first
-        if let customCover = await CoverManager.shared.loadCover(for: game) {
-            coverImage = customCover
+        // Already decoded: show it in the same frame, without a placeholder
+        if let cached = CoverImageCache.shared.cachedCover(for: game.id, maxPixelSize: maxPixelSize) {
+            coverImage = cached
             isLoading = false
             return
         }
         
-        // Try to load from artwork service
-        if let artwork = await ArtworkService.shared.getArtwork(for: game) {
+        isLoading = true
+        
+        // Custom cover or downloaded artwork, downloading if there is neither
+        if let artwork = await ArtworkService.shared.getArtwork(for: game, maxPixelSize: maxPixelSize) {
             coverImage = artwork
-            isLoading = false
-            return
         }
         
         isLoading = false
@@ -122,7 +126,6 @@ actor CoverManager {
     static let shared = CoverManager()
     
     private let coversDirectory: URL
-    private var coverCache: [UUID: UIImage] = [:]
     
     private init() {
         let documentsPath = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
@@ -132,28 +135,6 @@ actor CoverManager {
         try? FileManager.default.createDirectory(at: coversDirectory, withIntermediateDirectories: true)
     }
     
-    // MARK: - Load Cover
-    
-    func loadCover(for game: Game) -> UIImage? {
-        // Check cache first
-        if let cached = coverCache[game.id] {
-            return cached
-        }
-        
-        // Try to load from disk
-        let coverURL = coversDirectory.appendingPathComponent("\(game.id.uuidString).jpg")
-        
-        guard FileManager.default.fileExists(atPath: coverURL.path),
-              let data = try? Data(contentsOf: coverURL),
-              let image = UIImage(data: data) else {
-            return nil
-        }
-        
-        // Cache and return
-        coverCache[game.id] = image
-        return image
-    }
-    
     // MARK: - Save Cover
     
     func saveCover(_ image: UIImage, for game: Game) throws {
@@ -167,8 +148,8 @@ actor CoverManager {
         let coverURL = coversDirectory.appendingPathComponent("\(game.id.uuidString).jpg")
         try data.write(to: coverURL)
         
-        // Update cache
-        coverCache[game.id] = resizedImage
+        // Thumbnails of the old cover are stale now
+        CoverImageCache.shared.invalidate(game.id)
     }
     
     // MARK: - Delete Cover
@@ -180,7 +161,7 @@ actor CoverManager {
             try FileManager.default.removeItem(at: coverURL)
         }
         
-        coverCache.removeValue(forKey: game.id)
+        CoverImageCache.shared.invalidate(game.id)
     }
     
     // MARK: - Has Custom Cover
@@ -190,12 +171,6 @@ actor CoverManager {
         return FileManager.default.fileExists(atPath: coverURL.path)
     }
     
-    // MARK: - Clear Cache
-    
-    func clearCache() {
-        coverCache.removeAll()
-    }
-    
     // MARK: - Helpers
     
     private func resizeImage(_ image: UIImage, maxSize: CGSize) -> UIImage {
@@ -254,17 +254,19 @@ struct GameDetailView: View {
     
     /// 启动游戏前检查 BIOS 是否可用
     private func playGame() {
-        // 检查是否需要 BIOS
-        if game.system == .ps1 && !biosManager.checkPS1BIOSAvailable() {
-            // PS1 需要 BIOS 但未找到
-            showingBIOSAlert = true
-            return
+        Task { @MainActor in
+            // 等启动时的 BIOS 初始化完成，避免读到旧状态
+            guard await biosManager.isBIOSReady(for: game.system) else {
+                // PS1 需要 BIOS 但未找到
+                showingBIOSAlert = true
+                return
+            }
+            
+            // BIOS 检查通过，启动游戏
+            appState.currentGame = game
+            appState.isEmulating = true
+            dismiss()
         }
-        
-        // BIOS 检查通过，启动游戏
-        appState.currentGame = game
-        appState.isEmulating = true
-        dismiss()
     }
     
     private func toggleFavorite() {
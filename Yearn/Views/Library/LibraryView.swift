@@ -8,6 +8,7 @@
 import SwiftUI
 import UniformTypeIdentifiers
 import UIKit
+import YearnCore
 
 // MARK: - Document Picker 适配器
 // 使用 UIKit 的 UIDocumentPickerViewController 来确保文件选择器能正确显示
@@ -24,7 +25,7 @@ struct DocumentPickerView: UIViewControllerRepresentable {
         let picker = UIDocumentPickerViewController(forOpeningContentTypes: contentTypes, asCopy: true)
         picker.allowsMultipleSelection = allowsMultipleSelection
         picker.delegate = context.coordinator
-        print("📂 DocumentPickerView: Created UIDocumentPickerViewController")
+        Log.library.debug("Created UIDocumentPickerViewController")
         return picker
     }
     
@@ -44,15 +45,15 @@ struct DocumentPickerView: UIViewControllerRepresentable {
         }
         
         func documentPicker(_ controller: UIDocumentPickerViewController, didPickDocumentsAt urls: [URL]) {
-            print("📂 DocumentPicker: Selected \(urls.count) file(s)")
+            Log.library.debug("Selected \(urls.count) file(s)")
             for url in urls {
-                print("📂 - \(url.lastPathComponent)")
+                Log.library.debug("- \(url.lastPathComponent)")
             }
             onPicked(urls)
         }
         
         func documentPickerWasCancelled(_ controller: UIDocumentPickerViewController) {
-            print("📂 DocumentPicker: Cancelled")
+            Log.library.debug("Cancelled")
             onCancelled()
         }
     }
@@ -137,6 +138,12 @@ struct LibraryView: View {
                 }
             }
             .id(refreshID)
+            .onAppear {
+                // 首屏已提交，下一轮 run loop 即可响应操作
+                DispatchQueue.main.async {
+                    StartupScheduler.shared.mark(.interactive)
+                }
+            }
             .navigationTitle("library.title".localized)
             .themedListBackground()
             .searchable(text: $searchText, prompt: "library.search.placeholder".localized)
@@ -252,10 +259,10 @@ struct LibraryView: View {
                 .ignoresSafeArea()
             }
             .onChange(of: showingImporter) { oldValue, newValue in
-                print("📂 showingImporter changed: \(oldValue) -> \(newValue)")
+                Log.library.debug("showingImporter changed: \(oldValue) -> \(newValue)")
             }
             .onChange(of: showingFolderPicker) { oldValue, newValue in
-                print("📂 showingFolderPicker changed: \(oldValue) -> \(newValue)")
+                Log.library.debug("showingFolderPicker changed: \(oldValue) -> \(newValue)")
             }
             .alert("library.game.delete".localized, isPresented: $showingDeleteAlert) {
                 Button("common.cancel".localized, role: .cancel) {}
@@ -278,6 +285,11 @@ struct LibraryView: View {
             .refreshable {
                 viewModel.loadGames()
             }
+            // 搜索、筛选和排序在 SQLite 中完成，条件变化时从第一页重新查询；
+            // 库内容变化由 view model 合并后刷新，滚动到末尾附近时再加载下一页
+            .task(id: storeQuery) {
+                await viewModel.showGames(matching: storeQuery)
+            }
             .onReceive(NotificationCenter.default.publisher(for: .languageChanged)) { _ in
                 refreshID = UUID()
             }
@@ -318,7 +330,10 @@ struct LibraryView: View {
             switch viewMode {
             case .grid:
                 GameGridView(
-                    games: filteredAndSortedGames,
+                    games: viewModel.displayedGames,
+                    onGameAppeared: { index in
+                        viewModel.gameAppeared(at: index)
+                    },
                     onGameSelected: { game in
                         launchGame(game)
                     },
@@ -332,7 +347,10 @@ struct LibraryView: View {
                 )
             case .list:
                 GameListView(
-                    games: filteredAndSortedGames,
+                    games: viewModel.displayedGames,
+                    onGameAppeared: { index in
+                        viewModel.gameAppeared(at: index)
+                    },
                     onGameSelected: { game in
                         launchGame(game)
                     },
@@ -345,32 +363,14 @@ struct LibraryView: View {
         }
     }
     
-    private var filteredAndSortedGames: [Game] {
-        var result = viewModel.games
-        
-        // Filter by system
-        if let system = selectedSystem {
-            result = result.filter { $0.system == system }
-        }
-        
-        // Filter by search
-        if !searchText.isEmpty {
-            result = result.filter { game in
-                game.name.localizedCaseInsensitiveContains(searchText)
-            }
-        }
-        
-        // Sort
+    private var storeQuery: LibraryStore.Query {
+        let order: LibraryStore.Order
         switch sortOrder {
-        case .name:
-            result.sort { $0.name.localizedCompare($1.name) == .orderedAscending }
-        case .system:
-            result.sort { ($0.system.rawValue, $0.name) < ($1.system.rawValue, $1.name) }
-        case .recent:
-            result.sort { ($0.dateAdded ?? .distantPast) > ($1.dateAdded ?? .distantPast) }
+        case .name: order = .name
+        case .system: order = .system
+        case .recent: order = .dateAdded
         }
-        
-        return result
+        return LibraryStore.Query(search: searchText, system: selectedSystem?.rawValue, order: order)
     }
     
     private var romContentTypes: [UTType] {
@@ -381,25 +381,27 @@ struct LibraryView: View {
     
     /// 启动游戏前检查 BIOS 是否可用
     private func launchGame(_ game: Game) {
-        // 检查是否需要 BIOS
-        if game.system == .ps1 && !biosManager.checkPS1BIOSAvailable() {
-            // PS1 需要 BIOS 但未找到
-            pendingGame = game
-            showingBIOSAlert = true
-            return
+        Task { @MainActor in
+            // 等启动时的 BIOS 初始化完成，避免读到旧状态
+            guard await biosManager.isBIOSReady(for: game.system) else {
+                // PS1 需要 BIOS 但未找到
+                pendingGame = game
+                showingBIOSAlert = true
+                return
+            }
+            
+            // BIOS 检查通过，启动游戏
+            appState.currentGame = game
+            appState.isEmulating = true
         }
-        
-        // BIOS 检查通过，启动游戏
-        appState.currentGame = game
-        appState.isEmulating = true
     }
     
     /// 处理导入的文件 URL 列表
     private func handleImportURLs(_ urls: [URL]) {
-        print("📂 handleImportURLs called with \(urls.count) URLs")
+        Log.library.debug("handleImportURLs called with \(urls.count) URLs")
         for url in urls {
-            print("📂 - URL: \(url.path)")
-            print("📂 - Extension: \(url.pathExtension)")
+            Log.library.debug("- URL: \(url.path)")
+            Log.library.debug("- Extension: \(url.pathExtension)")
         }
         Task {
             await viewModel.importGames(from: urls)
@@ -407,38 +409,38 @@ struct LibraryView: View {
             await MainActor.run {
                 refreshID = UUID()
                 viewModel.loadGames()
-                print("📂 UI refreshed after import, total games: \(viewModel.games.count)")
+                Log.library.debug("UI refreshed after import, total games: \(viewModel.games.count)")
             }
         }
     }
     
     /// 处理导入的文件夹 URL
     private func handleFolderImportURL(_ folderURL: URL) {
-        print("📂 handleFolderImportURL called with: \(folderURL.path)")
-        print("📂 URL scheme: \(folderURL.scheme ?? "none")")
-        print("📂 Is file URL: \(folderURL.isFileURL)")
+        Log.library.debug("handleFolderImportURL called with: \(folderURL.path)")
+        Log.library.debug("URL scheme: \(folderURL.scheme ?? "none")")
+        Log.library.debug("Is file URL: \(folderURL.isFileURL)")
         Task {
             await viewModel.importGamesFromFolder(folderURL)
             // 强制刷新 UI
             await MainActor.run {
                 refreshID = UUID()
                 viewModel.loadGames()
-                print("📂 UI refreshed after folder import, total games: \(viewModel.games.count)")
+                Log.library.debug("UI refreshed after folder import, total games: \(viewModel.games.count)")
             }
         }
     }
     
     /// 处理从其他应用导入的文件
     private func handleExternalImport(_ url: URL) {
-        print("📂 handleExternalImport called with: \(url.path)")
-        print("📂 URL scheme: \(url.scheme ?? "none")")
-        print("📂 Is file URL: \(url.isFileURL)")
-        print("📂 File exists: \(FileManager.default.fileExists(atPath: url.path))")
+        Log.library.debug("handleExternalImport called with: \(url.path)")
+        Log.library.debug("URL scheme: \(url.scheme ?? "none")")
+        Log.library.debug("Is file URL: \(url.isFileURL)")
+        Log.library.debug("File exists: \(FileManager.default.fileExists(atPath: url.path))")
         
         Task {
             // 获取安全访问权限
             let accessing = url.startAccessingSecurityScopedResource()
-            print("📂 Security scoped access: \(accessing)")
+            Log.library.debug("Security scoped access: \(accessing)")
             
             defer {
                 if accessing {
@@ -448,13 +450,13 @@ struct LibraryView: View {
             
             // 检查文件是否存在
             guard FileManager.default.fileExists(atPath: url.path) else {
-                print("❌ File does not exist at path: \(url.path)")
+                Log.library.error("File does not exist at path: \(url.path)")
                 // 尝试从 Inbox 目录读取（某些应用会将文件复制到 Inbox）
                 if let inboxURL = getInboxFileURL(for: url) {
-                    print("📂 Found file in Inbox: \(inboxURL.path)")
+                    Log.library.debug("Found file in Inbox: \(inboxURL.path)")
                     await viewModel.importGame(from: inboxURL)
                 } else {
-                    print("❌ Could not find file in Inbox either")
+                    Log.library.error("Could not find file in Inbox either")
                 }
                 return
             }
@@ -465,7 +467,7 @@ struct LibraryView: View {
             await MainActor.run {
                 refreshID = UUID()
                 viewModel.loadGames()
-                print("📂 UI refreshed after external import, total games: \(viewModel.games.count)")
+                Log.library.debug("UI refreshed after external import, total games: \(viewModel.games.count)")
                 
                 // 发送导入完成通知
                 NotificationCenter.default.post(name: .gameImportCompleted, object: nil)
@@ -490,7 +492,7 @@ struct LibraryView: View {
         // 尝试查找 Inbox 目录中的所有文件
         do {
             let inboxContents = try FileManager.default.contentsOfDirectory(at: inboxURL, includingPropertiesForKeys: nil)
-            print("📂 Inbox contents: \(inboxContents.map { $0.lastPathComponent })")
+            Log.library.debug("Inbox contents: \(inboxContents.map { $0.lastPathComponent })")
             
             // 查找匹配的文件
             if let matchingFile = inboxContents.first(where: { $0.lastPathComponent == fileName }) {
@@ -502,7 +504,7 @@ struct LibraryView: View {
                 return inboxContents.first
             }
         } catch {
-            print("❌ Failed to read Inbox directory: \(error)")
+            Log.library.error("Failed to read Inbox directory: \(error)")
         }
         
         return nil
@@ -528,18 +530,18 @@ struct EmptyLibraryView: View {
             VStack(spacing: 16) {
                 HStack(spacing: 16) {
                     Button {
-                        print("📂 Import button tapped, setting showingImporter = true")
+                        Log.library.debug("Import button tapped, setting showingImporter = true")
                         showingImporter = true
-                        print("📂 showingImporter is now: \(showingImporter)")
+                        Log.library.debug("showingImporter is now: \(showingImporter)")
                     } label: {
                         Label("library.import".localized, systemImage: "doc.badge.plus")
                     }
                     .buttonStyle(.borderedProminent)
                     
                     Button {
-                        print("📂 Folder button tapped, setting showingFolderPicker = true")
+                        Log.library.debug("Folder button tapped, setting showingFolderPicker = true")
                         showingFolderPicker = true
-                        print("📂 showingFolderPicker is now: \(showingFolderPicker)")
+                        Log.library.debug("showingFolderPicker is now: \(showingFolderPicker)")
                     } label: {
                         Label("library.import.folder".localized, systemImage: "folder.badge.plus")
                     }
@@ -567,10 +569,14 @@ struct EmptyLibraryView: View {
 
 struct GameGridView: View {
     let games: [Game]
+    var onGameAppeared: (Int) -> Void = { _ in }
     let onGameSelected: (Game) -> Void
     let onGameLongPress: (Game) -> Void
     let onDeleteGame: (Game) -> Void
     
+    @State private var prefetcher = CoverPrefetcher()
+    @Environment(\.displayScale) private var displayScale
+    
     private let columns = [
         GridItem(.adaptive(minimum: 120, maximum: 160), spacing: 16)
     ]
@@ -578,8 +584,16 @@ struct GameGridView: View {
     var body: some View {
         ScrollView {
             LazyVGrid(columns: columns, spacing: 20) {
-                ForEach(games) { game in
-                    GameCardView(game: game)
+                ForEach(Array(zip(games.indices, games)), id: \.1.id) { index, game in
+                    GameCardView(game: game, prefetcher: prefetcher)
+                        .onAppear {
+                            prefetcher.cellAppeared(at: index, in: games,
+                                                    pixelSize: Int(GameCardView.coverPointSize * displayScale))
+                            onGameAppeared(index)
+                        }
+                        .onDisappear {
+                            prefetcher.cellDisappeared(at: index)
+                        }
                         .onTapGesture {
                             onGameSelected(game)
                         }
@@ -611,6 +625,10 @@ struct GameGridView: View {
             }
             .padding()
         }
+        .onDisappear {
+            prefetcher.stop()
+            CoverImageCache.shared.logStatistics()
+        }
     }
 }
 
@@ -618,14 +636,18 @@ struct GameGridView: View {
 
 struct GameListView: View {
     let games: [Game]
+    var onGameAppeared: (Int) -> Void = { _ in }
     let onGameSelected: (Game) -> Void
     let onDeleteGame: (Game) -> Void
     
     var body: some View {
         List {
-            ForEach(games) { game in
+            ForEach(Array(zip(games.indices, games)), id: \.1.id) { index, game in
                 GameRowView(game: game)
                     .contentShape(Rectangle())
+                    .onAppear {
+                        onGameAppeared(index)
+                    }
                     .onTapGesture {
                         onGameSelected(game)
                     }
@@ -688,26 +710,39 @@ struct GameRowView: View {
 
 struct GameCardView: View {
     let game: Game
+    var prefetcher: CoverPrefetcher? = nil
     @State private var isPressed = false
+    @State private var cover: UIImage?
+    @Environment(\.displayScale) private var displayScale
+    
+    /// Widest grid column, so every cell shares one thumbnail size
+    static let coverPointSize: CGFloat = 160
     
     var body: some View {
         VStack(spacing: 8) {
-            // Artwork placeholder
+            // Artwork, or a placeholder until it is decoded
             RoundedRectangle(cornerRadius: 12)
                 .fill(game.system.color.opacity(0.15))
                 .aspectRatio(1, contentMode: .fit)
                 .overlay {
-                    VStack(spacing: 8) {
-                        Image(systemName: game.system.iconName)
-                            .font(.system(size: 32))
-                            .foregroundStyle(game.system.color)
-                        
-                        Text(game.system.localizedName)
-                            .font(.caption2)
-                            .fontWeight(.medium)
-                            .foregroundStyle(game.system.color.opacity(0.8))
+                    if let cover {
+                        Image(uiImage: cover)
+                            .resizable()
+                            .aspectRatio(contentMode: .fill)
+                    } else {
+                        VStack(spacing: 8) {
+                            Image(systemName: game.system.iconName)
+                                .font(.system(size: 32))
+                                .foregroundStyle(game.system.color)
+                            
+                            Text(game.system.localizedName)
+                                .font(.caption2)
+                                .fontWeight(.medium)
+                                .foregroundStyle(game.system.color.opacity(0.8))
+                        }
                     }
                 }
+                .clipShape(RoundedRectangle(cornerRadius: 12))
                 .overlay(alignment: .topTrailing) {
                     if game.isFavorite {
                         Image(systemName: "heart.fill")
@@ -727,6 +762,26 @@ struct GameCardView: View {
                     .multilineTextAlignment(.center)
             }
         }
+        .task(id: game.id) {
+            await loadCover()
+        }
+    }
+    
+    /// Local covers only; scrolling the grid never starts downloads
+    private func loadCover() async {
+        let maxPixelSize = Int(Self.coverPointSize * displayScale)
+        if let cached = CoverImageCache.shared.cachedCover(for: game.id, maxPixelSize: maxPixelSize) {
+            cover = cached
+            prefetcher?.recordPlaceholder(nil)
+            return
+        }
+        
+        cover = nil
+        let start = Date()
+        cover = await CoverImageCache.shared.cover(for: game.id, maxPixelSize: maxPixelSize, priority: .high)
+        if cover != nil, !Task.isCancelled {
+            prefetcher?.recordPlaceholder(Date().timeIntervalSince(start))
+        }
     }
 }
 
@@ -1170,8 +1170,14 @@ struct PS1BIOSRow: View {
             
             if bios.isInstalled {
                 VStack(alignment: .trailing, spacing: 2) {
-                    Image(systemName: "checkmark.circle.fill")
-                        .foregroundStyle(.green)
+                    if bios.validation?.isValid == false {
+                        // 文件存在但 MD5 与已知 BIOS 不符
+                        Image(systemName: "exclamationmark.triangle.fill")
+                            .foregroundStyle(.orange)
+                    } else {
+                        Image(systemName: "checkmark.circle.fill")
+                            .foregroundStyle(.green)
+                    }
                     Text(bios.formattedSize)
                         .font(.caption2)
                         .foregroundStyle(.secondary)
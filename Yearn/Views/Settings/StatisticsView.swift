@@ -7,6 +7,7 @@
 
 import SwiftUI
 import Charts
+import YearnCore
 
 // MARK: - Statistics View
 
@@ -14,6 +15,11 @@ struct StatisticsView: View {
     @ObservedObject var viewModel: LibraryViewModel
     @State private var selectedTimeRange: TimeRange = .week
     
+    /// Running totals kept by the play journal; reading them costs no I/O
+    private var playSummary: PlayJournal.Summary {
+        PlayJournal.shared?.summary ?? PlayJournal.Summary()
+    }
+    
     enum TimeRange: String, CaseIterable {
         case week = "Week"
         case month = "Month"
@@ -28,6 +34,7 @@ struct StatisticsView: View {
                 StatRow(title: "stats.totalGames".localized, value: "\(viewModel.totalGames)", icon: "gamecontroller.fill", color: .blue)
                 StatRow(title: "stats.totalSize".localized, value: viewModel.totalSize, icon: "internaldrive.fill", color: .orange)
                 StatRow(title: "stats.favorites".localized, value: "\(viewModel.favoriteGames.count)", icon: "heart.fill", color: .red)
+                StatRow(title: "stats.totalPlayTime".localized, value: Self.formatPlayTime(playSummary.totalPlayTime), icon: "clock.fill", color: .green)
             }
             
             // Games by System
@@ -59,7 +66,7 @@ struct StatisticsView: View {
             // Play Time Chart (placeholder)
             Section("stats.recentActivity".localized) {
                 if #available(iOS 17.0, *) {
-                    PlayTimeChart(games: viewModel.recentGames)
+                    PlayTimeChart(summary: playSummary)
                         .frame(height: 200)
                 } else {
                     Text("stats.chartsRequireIOS17".localized)
@@ -92,6 +99,27 @@ struct StatisticsView: View {
                 }
             }
             
+            // Most Played
+            let mostPlayed = mostPlayedGames
+            if !mostPlayed.isEmpty {
+                Section("stats.mostPlayed".localized) {
+                    ForEach(mostPlayed, id: \.game.id) { entry in
+                        HStack {
+                            Image(systemName: entry.game.system.iconName)
+                                .foregroundStyle(entry.game.system.color)
+                            
+                            Text(entry.game.name)
+                                .lineLimit(1)
+                            
+                            Spacer()
+                            
+                            Text(Self.formatPlayTime(entry.playTime))
+                                .foregroundStyle(.secondary)
+                        }
+                    }
+                }
+            }
+            
             // Storage Breakdown
             Section("stats.storage".localized) {
                 StorageBreakdownView()
@@ -99,6 +127,23 @@ struct StatisticsView: View {
         }
         .navigationTitle("stats.title".localized)
     }
+    
+    private var mostPlayedGames: [(game: Game, playTime: TimeInterval)] {
+        let gamesByID = Dictionary(viewModel.games.map { ($0.id, $0) }, uniquingKeysWith: { first, _ in first })
+        return playSummary.games
+            .filter { $0.value.playTime > 0 }
+            .sorted { $0.value.playTime > $1.value.playTime }
+            .compactMap { id, totals in gamesByID[id].map { ($0, totals.playTime) } }
+            .prefix(5)
+            .map { $0 }
+    }
+    
+    static func formatPlayTime(_ seconds: TimeInterval) -> String {
+        let formatter = DateComponentsFormatter()
+        formatter.allowedUnits = seconds >= 3600 ? [.hour, .minute] : [.minute]
+        formatter.unitsStyle = .abbreviated
+        return formatter.string(from: seconds) ?? "0m"
+    }
 }
 
 // MARK: - Stat Row
@@ -131,24 +176,19 @@ struct StatRow: View {
 
 @available(iOS 17.0, *)
 struct PlayTimeChart: View {
-    let games: [Game]
+    let summary: PlayJournal.Summary
     
     var chartData: [ChartDataPoint] {
-        // Group by day for the last 7 days
+        // Minutes played on each of the last 7 days, from the per-day totals
         let calendar = Calendar.current
         var data: [ChartDataPoint] = []
         
         for dayOffset in (0..<7).reversed() {
             let date = calendar.date(byAdding: .day, value: -dayOffset, to: Date())!
             let dayStart = calendar.startOfDay(for: date)
-            let dayEnd = calendar.date(byAdding: .day, value: 1, to: dayStart)!
-            
-            let gamesPlayedThatDay = games.filter { game in
-                guard let lastPlayed = game.lastPlayed else { return false }
-                return lastPlayed >= dayStart && lastPlayed < dayEnd
-            }.count
+            let minutes = Int((summary.playTime(onDayOf: dayStart) / 60).rounded())
             
-            data.append(ChartDataPoint(date: dayStart, count: gamesPlayedThatDay))
+            data.append(ChartDataPoint(date: dayStart, count: minutes))
         }
         
         return data
@@ -158,7 +198,7 @@ struct PlayTimeChart: View {
         Chart(chartData) { point in
             BarMark(
                 x: .value("Day", point.date, unit: .day),
-                y: .value("Games", point.count)
+                y: .value("Minutes", point.count)
             )
             .foregroundStyle(.blue.gradient)
             .cornerRadius(4)
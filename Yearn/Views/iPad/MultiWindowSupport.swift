@@ -7,6 +7,7 @@
 
 import SwiftUI
 import UIKit
+import YearnCore
 
 // MARK: - Multi-Window Manager
 
@@ -36,7 +37,7 @@ class MultiWindowManager: ObservableObject {
             userActivity: activity,
             options: nil,
             errorHandler: { error in
-                print("Failed to open new window: \(error)")
+                Log.app.error("Failed to open new window: \(error)")
             }
         )
     }
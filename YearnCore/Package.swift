@@ -14,6 +14,10 @@ let package = Package(
             name: "YearnCore",
             targets: ["YearnCore"]
         ),
+        .executable(
+            name: "YearnHeadless",
+            targets: ["YearnHeadless"]
+        ),
     ],
     dependencies: [],
     targets: [
@@ -26,21 +30,80 @@ let package = Package(
             publicHeadersPath: "include",
             cSettings: [
                 .headerSearchPath("include"),
-                // Enable static cores - required for iOS App Store
-                .define("STATIC_CORES_ENABLED")
+                // Static cores are iOS arm64 archives linked by the (iOS-only) app; macOS
+                // and Linux builds of this package load dynamic cores only
+                .define("STATIC_CORES_ENABLED", .when(platforms: [.iOS]))
             ]
         ),
-        // Main Swift target
+        // C helpers for ROM handling (archive decoding, disc image VFS and CHD)
         .target(
-            name: "YearnCore",
+            name: "CYearnSupport",
             dependencies: ["CLibretro"],
+            path: "Sources/CYearnSupport",
+            publicHeadersPath: "include",
+            linkerSettings: [
+                .linkedLibrary("z")
+            ]
+        ),
+        // System SQLite for the library store
+        .systemLibrary(
+            name: "CSQLite",
+            path: "Sources/CSQLite",
+            providers: [
+                .apt(["libsqlite3-dev"])
+            ]
+        ),
+        // Emulation runtime: bridges, rewind, save states, library; no Apple frameworks
+        .target(
+            name: "YearnCore",
+            dependencies: ["CLibretro", "CYearnSupport", "CSQLite"],
             path: "Sources/YearnCore",
             swiftSettings: [
                 .enableExperimentalFeature("StrictConcurrency"),
-                // Enable static cores - required for iOS App Store
-                .define("STATIC_CORES_ENABLED")
+                // Static cores are iOS arm64 archives linked by the (iOS-only) app; macOS
+                // and Linux builds of this package load dynamic cores only
+                .define("STATIC_CORES_ENABLED", .when(platforms: [.iOS]))
             ]
         ),
+        // Runs a dynamic libretro core with no window or audio device:
+        // swift run -c release YearnHeadless --core <core> --rom <rom>
+        .executableTarget(
+            name: "YearnHeadless",
+            dependencies: ["YearnCore"],
+            path: "Sources/YearnHeadless"
+        ),
+        // Microbenchmarks for hot paths: swift run -c release YearnBenchmarks
+        .executableTarget(
+            name: "YearnBenchmarks",
+            dependencies: ["YearnCore", "CLibretro", "CYearnSupport"],
+            path: "Sources/YearnBenchmarks"
+        ),
+        .testTarget(
+            name: "YearnCoreTests",
+            dependencies: ["YearnCore", "CYearnSupport"],
+            path: "Tests/YearnCoreTests"
+        ),
     ]
 )
 
+// Apple presentation: Metal video, AVAudioEngine audio, GameController input and
+// the SwiftUI controls. Only declared where those frameworks exist, so the runtime,
+// the headless runner and the benchmarks build on Linux.
+#if canImport(Darwin)
+package.products.append(
+    .library(
+        name: "YearnPresentation",
+        targets: ["YearnPresentation"]
+    )
+)
+package.targets.append(
+    .target(
+        name: "YearnPresentation",
+        dependencies: ["YearnCore", "CLibretro"],
+        path: "Sources/YearnPresentation",
+        swiftSettings: [
+            .enableExperimentalFeature("StrictConcurrency")
+        ]
+    )
+)
+#endif
@@ -233,6 +233,76 @@ typedef size_t (*retro_audio_sample_batch_t)(const int16_t *data, size_t frames)
 typedef void (*retro_input_poll_t)(void);
 typedef int16_t (*retro_input_state_t)(unsigned port, unsigned device, unsigned index, unsigned id);
 
+/* Virtual file system (RETRO_ENVIRONMENT_GET_VFS_INTERFACE) */
+#define RETRO_VFS_FILE_ACCESS_READ            (1 << 0)
+#define RETRO_VFS_FILE_ACCESS_WRITE           (1 << 1)
+#define RETRO_VFS_FILE_ACCESS_READ_WRITE      (RETRO_VFS_FILE_ACCESS_READ | RETRO_VFS_FILE_ACCESS_WRITE)
+#define RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING (1 << 2)
+
+#define RETRO_VFS_FILE_ACCESS_HINT_NONE            (0)
+#define RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS (1 << 0)
+
+#define RETRO_VFS_SEEK_POSITION_START   0
+#define RETRO_VFS_SEEK_POSITION_CURRENT 1
+#define RETRO_VFS_SEEK_POSITION_END     2
+
+#define RETRO_VFS_STAT_IS_VALID             (1 << 0)
+#define RETRO_VFS_STAT_IS_DIRECTORY         (1 << 1)
+#define RETRO_VFS_STAT_IS_CHARACTER_SPECIAL (1 << 2)
+
+struct retro_vfs_file_handle;
+struct retro_vfs_dir_handle;
+
+typedef const char *(*retro_vfs_get_path_t)(struct retro_vfs_file_handle *stream);
+typedef struct retro_vfs_file_handle *(*retro_vfs_open_t)(const char *path, unsigned mode, unsigned hints);
+typedef int (*retro_vfs_close_t)(struct retro_vfs_file_handle *stream);
+typedef int64_t (*retro_vfs_size_t)(struct retro_vfs_file_handle *stream);
+typedef int64_t (*retro_vfs_truncate_t)(struct retro_vfs_file_handle *stream, int64_t length);
+typedef int64_t (*retro_vfs_tell_t)(struct retro_vfs_file_handle *stream);
+typedef int64_t (*retro_vfs_seek_t)(struct retro_vfs_file_handle *stream, int64_t offset, int seek_position);
+typedef int64_t (*retro_vfs_read_t)(struct retro_vfs_file_handle *stream, void *s, uint64_t len);
+typedef int64_t (*retro_vfs_write_t)(struct retro_vfs_file_handle *stream, const void *s, uint64_t len);
+typedef int (*retro_vfs_flush_t)(struct retro_vfs_file_handle *stream);
+typedef int (*retro_vfs_remove_t)(const char *path);
+typedef int (*retro_vfs_rename_t)(const char *old_path, const char *new_path);
+typedef int (*retro_vfs_stat_t)(const char *path, int32_t *size);
+typedef int (*retro_vfs_mkdir_t)(const char *dir);
+typedef struct retro_vfs_dir_handle *(*retro_vfs_opendir_t)(const char *dir, _Bool include_hidden);
+typedef _Bool (*retro_vfs_readdir_t)(struct retro_vfs_dir_handle *dirstream);
+typedef const char *(*retro_vfs_dirent_get_name_t)(struct retro_vfs_dir_handle *dirstream);
+typedef _Bool (*retro_vfs_dirent_is_dir_t)(struct retro_vfs_dir_handle *dirstream);
+typedef int (*retro_vfs_closedir_t)(struct retro_vfs_dir_handle *dirstream);
+
+struct retro_vfs_interface {
+    /* VFS API v1 */
+    retro_vfs_get_path_t get_path;
+    retro_vfs_open_t open;
+    retro_vfs_close_t close;
+    retro_vfs_size_t size;
+    retro_vfs_tell_t tell;
+    retro_vfs_seek_t seek;
+    retro_vfs_read_t read;
+    retro_vfs_write_t write;
+    retro_vfs_flush_t flush;
+    retro_vfs_remove_t remove;
+    retro_vfs_rename_t rename;
+    /* VFS API v2 */
+    retro_vfs_truncate_t truncate;
+    /* VFS API v3 */
+    retro_vfs_stat_t stat;
+    retro_vfs_mkdir_t mkdir;
+    retro_vfs_opendir_t opendir;
+    retro_vfs_readdir_t readdir;
+    retro_vfs_dirent_get_name_t dirent_get_name;
+    retro_vfs_dirent_is_dir_t dirent_is_dir;
+    retro_vfs_closedir_t closedir;
+};
+
+struct retro_vfs_interface_info {
+    uint32_t required_interface_version;
+    struct retro_vfs_interface *iface;
+};
+
 /* Core API functions */
 void retro_set_environment(retro_environment_t);
 void retro_set_video_refresh(retro_video_refresh_t);
@@ -0,0 +1,13 @@
+//
+//  shim.h
+//  YearnCore
+//
+//  System SQLite (the iOS/macOS SDK copy, libsqlite3-dev elsewhere)
+//
+
+#ifndef CSQLite_shim_h
+#define CSQLite_shim_h
+
+#include <sqlite3.h>
+
+#endif /* CSQLite_shim_h */
@@ -0,0 +1,68 @@
+//
+//  yearn_atlas.h
+//  YearnCore
+//
+//  Packed thumbnail store: one memory-mapped file of fixed-size tiles
+//
+//  Tiles are small compressed images (e.g. JPEG cover thumbnails) keyed by a
+//  16-byte ID. The file is a header page followed by chunks, each holding
+//  an index of 1024 entries and then 1024 slots of `slot_size` bytes:
+//
+//      [header][index 0][slots 0..1023][index 1][slots 1024..2047]...
+//
+//  Opening reads only the index pages; tiles are read through the mapping,
+//  so showing a cover costs no open/read/close. Every entry carries a CRC32
+//  of its tile, so a tile torn by a crash reads as missing rather than as
+//  garbage. The store grows one chunk at a time; a tile that is replaced or
+//  removed frees its slot for the next one.
+//
+//  Not thread-safe: callers serialise access to one atlas.
+//
+
+#ifndef yearn_atlas_h
+#define yearn_atlas_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct yearn_atlas yearn_atlas;
+
+/// Open an atlas, creating it if needed
+/// `slot_size` is rounded up to a multiple of 4096. An existing file with a
+/// different slot size or an unknown layout is emptied and started afresh.
+/// Returns NULL with errno set on failure.
+yearn_atlas *yearn_atlas_open(const char *path, uint32_t slot_size);
+
+void yearn_atlas_close(yearn_atlas *atlas);
+
+/// Largest tile the atlas can hold
+uint32_t yearn_atlas_slot_size(const yearn_atlas *atlas);
+
+/// Number of tiles stored
+uint32_t yearn_atlas_count(const yearn_atlas *atlas);
+
+/// Keep at most `max_tiles` tiles (0 = unlimited); once full, storing a new
+/// tile evicts the one stored longest ago
+void yearn_atlas_set_max_tiles(yearn_atlas *atlas, uint32_t max_tiles);
+
+/// Copy a tile into `buffer`
+/// Returns the tile length, or -1 with errno ENOENT if there is no valid tile
+/// for `key`, or ENOBUFS if `capacity` is too small (slot_size always suffices)
+long yearn_atlas_get(yearn_atlas *atlas, const uint8_t key[16], void *buffer, size_t capacity);
+
+/// Store or replace a tile
+/// Returns 0, or -1 with errno set (EFBIG if `length` exceeds the slot size)
+int yearn_atlas_put(yearn_atlas *atlas, const uint8_t key[16], const void *data, size_t length);
+
+/// Remove a tile; returns 0, or -1 with errno ENOENT if there was none
+int yearn_atlas_remove(yearn_atlas *atlas, const uint8_t key[16]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_atlas_h */
@@ -0,0 +1,50 @@
+//
+//  yearn_backtrace.h
+//  YearnCore
+//
+//  Return addresses of another thread's stack, captured while it runs
+//
+//  A watchdog that sees the emulation thread stuck in a frame can ask where
+//  it is. On Apple platforms the thread is suspended with Mach, its
+//  registers read and its frame-pointer chain walked within its own stack,
+//  then it is resumed; nothing is allocated or locked while it is stopped,
+//  since it may hold the malloc lock. On Linux the thread is sent a signal
+//  whose handler walks its own chain the same way.
+//
+//  Frames past one whose code was built without frame pointers are lost;
+//  the first frame, the thread's program counter, is always exact.
+//
+
+#ifndef yearn_backtrace_h
+#define yearn_backtrace_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct yearn_thread yearn_thread;
+
+/// A handle on the calling thread that other threads can capture
+/// Returns NULL with errno set on failure.
+yearn_thread *yearn_thread_current(void);
+
+/// Release a handle; the thread itself is unaffected
+void yearn_thread_release(yearn_thread *thread);
+
+/// Capture up to `max` return addresses of `thread`, innermost first
+/// Safe while the thread is running. Returns the number captured, or -1
+/// with errno set (ETIMEDOUT if a Linux thread did not answer in time).
+int yearn_thread_backtrace(yearn_thread *thread, uintptr_t *frames, int max);
+
+/// Describe `address` as "image symbol + offset", or "image + offset" when
+/// the symbol is not exported. Returns 0, or -1 if no image contains it.
+int yearn_symbolicate(uintptr_t address, char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_backtrace_h */
@@ -0,0 +1,81 @@
+//
+//  yearn_chd.h
+//  YearnCore
+//
+//  Minimal reader for CHD v5 CD images
+//
+//  Parses the header, hunk map and metadata, and decodes hunks stored
+//  uncompressed or with the zlib / cdzl codecs. Images that use other codecs
+//  (LZMA, FLAC, Zstandard) or a parent image report themselves as unsupported
+//  so callers can hand the file to the core's own CHD reader instead.
+//
+
+#ifndef yearn_chd_h
+#define yearn_chd_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Bytes per CD frame in a CHD: 2352 sector bytes + 96 subcode bytes
+#define YEARN_CHD_FRAME_SIZE 2448
+#define YEARN_CHD_SECTOR_SIZE 2352
+
+/// Frames in each CHD track are padded to a multiple of this
+#define YEARN_CHD_TRACK_PADDING 4
+
+/// Metadata tags for CD track descriptions
+#define YEARN_CHD_TRACK_METADATA_TAG  0x43485452  // 'CHTR'
+#define YEARN_CHD_TRACK_METADATA2_TAG 0x43485432  // 'CHT2'
+
+typedef enum {
+    YEARN_CHD_OK = 0,
+    YEARN_CHD_ERROR_FILE = -1,          // cannot open or read the file
+    YEARN_CHD_ERROR_FORMAT = -2,        // not a CHD, or a damaged one
+    YEARN_CHD_ERROR_UNSUPPORTED = -3,   // version, codec or parent not handled
+    YEARN_CHD_ERROR_DECOMPRESS = -4,    // hunk failed to decode or verify
+    YEARN_CHD_ERROR_MEMORY = -5
+} yearn_chd_error;
+
+typedef struct {
+    uint32_t version;
+    uint32_t hunk_bytes;
+    uint32_t unit_bytes;
+    uint32_t hunk_count;
+    uint64_t logical_bytes;
+    uint32_t compressors[4];
+} yearn_chd_header;
+
+typedef struct yearn_chd yearn_chd;
+
+/// Open a CHD file and decode its hunk map
+yearn_chd *yearn_chd_open(const char *path, yearn_chd_error *error);
+
+/// Close a CHD file
+void yearn_chd_close(yearn_chd *chd);
+
+/// Header fields of an open CHD
+const yearn_chd_header *yearn_chd_get_header(const yearn_chd *chd);
+
+/// Whether every hunk can be decoded by yearn_chd_read_hunk()
+int yearn_chd_is_supported(const yearn_chd *chd);
+
+/// Copy the `index`-th metadata entry with `tag` into `buffer` (NUL-terminated)
+/// Returns the entry length, or -1 if there is no such entry
+int yearn_chd_get_metadata(yearn_chd *chd, uint32_t tag, uint32_t index, char *buffer, size_t capacity);
+
+/// Decode one hunk into `dest`, which must hold `hunk_bytes`
+/// Safe to call from several threads at once.
+yearn_chd_error yearn_chd_read_hunk(yearn_chd *chd, uint32_t hunk, uint8_t *dest);
+
+/// Regenerate the ECC P/Q parity of a raw mode 1 / mode 2 form 1 sector
+void yearn_cdrom_ecc_generate(uint8_t *sector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_chd_h */
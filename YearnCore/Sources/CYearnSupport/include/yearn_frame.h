@@ -0,0 +1,96 @@
+//
+//  yearn_frame.h
+//  YearnCore
+//
+//  Lock-free store of per-frame emulation state
+//
+//  The emulation loop publishes a sample after every frame; the UI, a
+//  watchdog or an overlay reads the latest one whenever it likes, at its own
+//  rate, without either side taking a lock or waking the other.
+//
+//  Samples are published under a sequence lock: the writer makes the
+//  sequence odd, stores the sample and makes it even again; a reader copies
+//  the sample and retries if the sequence moved meanwhile, so it never sees
+//  half of one frame and half of the next. Publishing needs one writer at a
+//  time. Pressed inputs are kept beside the sample in one atomic word, so
+//  any thread may set them.
+//
+//  The loop also marks when each frame begins, so a watchdog can tell a
+//  frame that never finishes from a loop that is simply not running, and
+//  the times of the last YEARN_FRAME_RECENT frames are kept for its report.
+//  Work the loop does between frames, such as serializing a save state, is
+//  kept among them as entries of its own, so it is not taken for the core's.
+//
+
+#ifndef yearn_frame_h
+#define yearn_frame_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    /// Frames run since the game started, including skipped ones
+    uint64_t frames;
+    /// Host time in seconds when the last frame finished
+    double timestamp;
+    /// Seconds the last frame took to run
+    double frame_time;
+    /// Frames per second over the last measuring interval
+    double fps;
+    /// Bit n set while libretro button n is held, on port 0
+    uint64_t inputs;
+} yearn_frame_sample;
+
+/// Frame times kept for `yearn_frame_state_recent`
+#define YEARN_FRAME_RECENT 128
+
+/// What a recent time was spent on
+typedef enum {
+    /// Running one frame, from `yearn_frame_state_begin` to publish
+    YEARN_FRAME_WORK_FRAME = 0,
+    /// Serializing a save state between frames
+    YEARN_FRAME_WORK_SAVE_STATE = 1,
+} yearn_frame_work;
+
+typedef struct yearn_frame_state yearn_frame_state;
+
+/// Returns NULL with errno set on failure
+yearn_frame_state *yearn_frame_state_create(void);
+
+void yearn_frame_state_destroy(yearn_frame_state *state);
+
+/// Mark that a frame began at host time `timestamp`; the next publish ends it.
+/// Called by the publishing thread.
+void yearn_frame_state_begin(yearn_frame_state *state, double timestamp);
+
+/// Publish a sample; its `inputs` are ignored. One writer at a time.
+void yearn_frame_state_publish(yearn_frame_state *state, const yearn_frame_sample *sample);
+
+/// Add `seconds` spent on `work` between frames to the recent times.
+/// Called by the publishing thread.
+void yearn_frame_state_record(yearn_frame_state *state, yearn_frame_work work, double seconds);
+
+/// Host time the frame in progress began, or 0 between frames. Any thread.
+double yearn_frame_state_in_frame_since(const yearn_frame_state *state);
+
+/// Copy up to `max` of the latest times, oldest first, and what each was
+/// spent on into `work` unless it is NULL. Any thread.
+/// Returns the number copied.
+size_t yearn_frame_state_recent(const yearn_frame_state *state, double *times, yearn_frame_work *work, size_t max);
+
+/// Copy the latest sample, with the inputs pressed now. Any thread.
+void yearn_frame_state_read(const yearn_frame_state *state, yearn_frame_sample *sample);
+
+/// Mark libretro button `button` (0-63) pressed or released. Any thread.
+void yearn_frame_state_set_input(yearn_frame_state *state, unsigned button, bool pressed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_frame_h */
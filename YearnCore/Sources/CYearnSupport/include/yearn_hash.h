@@ -0,0 +1,83 @@
+//
+//  yearn_hash.h
+//  YearnCore
+//
+//  Streaming CRC32 / MD5 / SHA-1 for ROM identification
+//
+//  All requested digests are computed in one pass: each chunk is run through
+//  every hash while it is still in cache. CRC32 uses the ARMv8 CRC32
+//  instructions or PCLMULQDQ folding when the CPU has them, and slicing-by-8
+//  tables otherwise.
+//
+
+#ifndef yearn_hash_h
+#define yearn_hash_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Digests to compute
+enum {
+    YEARN_HASH_CRC32 = 1 << 0,
+    YEARN_HASH_MD5   = 1 << 1,
+    YEARN_HASH_SHA1  = 1 << 2,
+    YEARN_HASH_ALL   = YEARN_HASH_CRC32 | YEARN_HASH_MD5 | YEARN_HASH_SHA1
+};
+
+/// CRC32 implementation in use
+typedef enum {
+    YEARN_CRC32_TABLE = 0,      // slicing-by-8
+    YEARN_CRC32_ARMV8 = 1,      // ARMv8 CRC32X/CRC32B
+    YEARN_CRC32_PCLMUL = 2      // x86 carry-less multiply folding
+} yearn_crc32_impl;
+
+typedef struct {
+    uint32_t crc32;
+    uint8_t md5[16];
+    uint8_t sha1[20];
+    uint64_t length;            // bytes hashed
+} yearn_hash_result;
+
+typedef struct {
+    unsigned flags;
+    uint32_t crc;
+    uint64_t length;
+
+    uint32_t md5_state[4];
+    uint32_t sha1_state[5];
+    uint8_t block[64];          // partial MD5/SHA-1 block
+    size_t block_used;
+} yearn_hasher;
+
+/// Start hashing with the digests in `flags`
+void yearn_hasher_init(yearn_hasher *hasher, unsigned flags);
+
+/// Feed bytes
+void yearn_hasher_update(yearn_hasher *hasher, const void *data, size_t length);
+
+/// Finish and write the digests; digests not requested are zeroed
+void yearn_hasher_final(yearn_hasher *hasher, yearn_hash_result *result);
+
+/// Hash a file from byte `skip` to the end, reading it through mmap'd windows
+/// Returns 0, or -1 with errno set if the file cannot be opened or mapped
+int yearn_hash_file(const char *path, uint64_t skip, unsigned flags, yearn_hash_result *result);
+
+/// CRC-32 (IEEE 802.3) over a buffer, continuing from `crc` (0 for the first chunk)
+uint32_t yearn_crc32(uint32_t crc, const void *data, size_t length);
+
+/// CRC-32 with a given implementation, for benchmarks and tests
+/// Falls back to the table when the CPU lacks the instructions
+uint32_t yearn_crc32_with(yearn_crc32_impl impl, uint32_t crc, const void *data, size_t length);
+
+/// Fastest CRC32 implementation available on this CPU
+yearn_crc32_impl yearn_crc32_best_impl(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_hash_h */
@@ -0,0 +1,62 @@
+//
+//  yearn_import.h
+//  YearnCore
+//
+//  Copy a ROM into the library while hashing and sniffing it
+//
+//  The destination is cloned when the filesystem supports it (APFS
+//  clonefile, Linux FICLONE); otherwise the file is copied in one pass that
+//  also feeds the hasher and the header sniffer, so an import reads the
+//  source exactly once.
+//
+
+#ifndef yearn_import_h
+#define yearn_import_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "yearn_hash.h"
+#include "yearn_sniff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    /// Digests of the file without its copier header (iNES, FDS, Lynx),
+    /// which is what No-Intro DATs hash
+    yearn_hash_result hash;
+    /// Bytes left out of `hash`; 0 when the file has no copier header
+    uint64_t header_skip;
+    /// CRC32 of the whole file, when `header_skip` > 0
+    uint32_t crc32_whole;
+
+    yearn_sniff_result sniff[YEARN_SNIFF_MAX_RESULTS];
+    int sniff_count;
+
+    uint64_t size;
+    /// 1 if the destination shares the source's blocks
+    int cloned;
+} yearn_import_result;
+
+/// Called after each chunk with the bytes processed so far; return nonzero to cancel
+typedef int (*yearn_import_progress_fn)(void *context, uint64_t done, uint64_t total);
+
+/// Copy `src` to `dst`, hashing and sniffing on the way
+/// `dst` must not exist; it is written under a temporary name and renamed
+/// into place, so a failed or cancelled import leaves nothing behind.
+/// `hash_flags` may be 0 to copy and sniff only.
+/// Returns 0, or -1 with errno set (ECANCELED if the progress callback cancelled)
+int yearn_import_file(const char *src, const char *dst, unsigned hash_flags,
+                      yearn_import_progress_fn progress, void *context,
+                      yearn_import_result *result);
+
+/// Disable cloning, for benchmarks comparing against the streaming copy
+void yearn_import_set_clone_enabled(int enabled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_import_h */
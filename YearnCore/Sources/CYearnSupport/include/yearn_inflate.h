@@ -0,0 +1,48 @@
+//
+//  yearn_inflate.h
+//  YearnCore
+//
+//  Streaming raw DEFLATE decoder used to extract ROMs from ZIP archives
+//  Thin wrapper over zlib, since inflateInit2() is a macro Swift cannot call
+//
+
+#ifndef yearn_inflate_h
+#define yearn_inflate_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Result codes returned by yearn_inflate_run
+typedef enum {
+    YEARN_INFLATE_OK = 0,           // Progress made, call again with more input/output
+    YEARN_INFLATE_STREAM_END = 1,   // End of the DEFLATE stream reached
+    YEARN_INFLATE_ERROR = -1        // Corrupt stream or out of memory
+} yearn_inflate_result;
+
+typedef struct yearn_inflate yearn_inflate;
+
+/// Create a decoder for a raw (headerless) DEFLATE stream, as stored in ZIP entries
+yearn_inflate *yearn_inflate_create(void);
+
+/// Decode as much as possible from `input` into `output`
+/// `consumed` and `produced` receive the number of bytes used from each buffer
+yearn_inflate_result yearn_inflate_run(yearn_inflate *stream,
+                                       const uint8_t *input, size_t input_length, size_t *consumed,
+                                       uint8_t *output, size_t output_capacity, size_t *produced);
+
+/// Release a decoder
+void yearn_inflate_destroy(yearn_inflate *stream);
+
+/// CRC-32 (IEEE 802.3, as used by ZIP) over a buffer, continuing from `crc`
+/// Pass 0 for the first chunk
+uint32_t yearn_inflate_crc32(uint32_t crc, const uint8_t *data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_inflate_h */
@@ -0,0 +1,78 @@
+//
+//  yearn_journal.h
+//  YearnCore
+//
+//  Append-only journal of fixed-size play records
+//
+//  The file is a 16-byte header (magic and a generation number) followed by
+//  44-byte entries: a 40-byte record and the CRC32 of it. Appends are single
+//  write() calls and are not synced; yearn_journal_sync() makes everything
+//  appended so far durable, so callers choose how many records share one
+//  fsync. A record torn by a crash fails its CRC and reads back as
+//  YEARN_JOURNAL_INVALID; a partial entry at the end is cut off on open.
+//
+//  The generation lets a caller that folds the journal into a summary tell
+//  whether the journal was reset after the summary was written.
+//
+//  Not thread-safe: callers serialise access to one journal.
+//
+
+#ifndef yearn_journal_h
+#define yearn_journal_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    YEARN_JOURNAL_INVALID = 0,      // damaged entry, skip it
+    YEARN_JOURNAL_SESSION = 1,      // a finished play session
+    YEARN_JOURNAL_LAUNCH = 2        // a game was started; duration and frames are 0
+} yearn_journal_kind;
+
+typedef struct {
+    uint8_t game_id[16];
+    /// Seconds since 2001-01-01 UTC, like Foundation's reference date
+    double start;
+    /// Seconds of play, excluding pauses
+    float duration;
+    float average_fps;
+    uint32_t frames;
+    uint32_t kind;
+} yearn_journal_record;
+
+typedef struct yearn_journal yearn_journal;
+
+/// Open a journal, creating it with generation 0 if needed
+/// A file with an unknown header is started afresh. Returns NULL with errno set on failure.
+yearn_journal *yearn_journal_open(const char *path);
+
+void yearn_journal_close(yearn_journal *journal);
+
+uint64_t yearn_journal_generation(const yearn_journal *journal);
+
+/// Entries in the journal, including damaged ones
+size_t yearn_journal_count(const yearn_journal *journal);
+
+/// Append records with one write; returns 0, or -1 with errno set
+int yearn_journal_append(yearn_journal *journal, const yearn_journal_record *records, size_t count);
+
+/// Make every appended record durable; returns 0, or -1 with errno set
+int yearn_journal_sync(yearn_journal *journal);
+
+/// Read `count` entries starting at entry `first`
+/// Damaged entries come back zeroed with kind YEARN_JOURNAL_INVALID.
+/// Returns the number of entries read, or -1 with errno set.
+long yearn_journal_read(yearn_journal *journal, size_t first, yearn_journal_record *records, size_t count);
+
+/// Drop every entry and start `generation`, durably; returns 0, or -1 with errno set
+int yearn_journal_reset(yearn_journal *journal, uint64_t generation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_journal_h */
@@ -0,0 +1,82 @@
+//
+//  yearn_log.h
+//  YearnCore
+//
+//  Fixed-size ring of recent log messages, writable from any thread
+//
+//  Writers never block and never allocate: each takes the next ticket with
+//  one atomic add and copies its message into the slot the ticket maps to,
+//  overwriting the oldest entry. A slot carries the ticket it holds and
+//  whether it is being written, so a snapshot (taken by a watchdog, say,
+//  while the writing thread is stuck) copies only whole entries and skips
+//  ones written meanwhile. When two writers land on the same slot at once,
+//  which takes the ring wrapping all the way round during one copy, the
+//  later one drops its message and counts it in `dropped`.
+//
+//  Messages and categories longer than their fields are cut off.
+//
+
+#ifndef yearn_log_h
+#define yearn_log_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "libretro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YEARN_LOG_CATEGORY_SIZE 16
+#define YEARN_LOG_MESSAGE_SIZE 224
+
+typedef struct {
+    /// Host time in seconds when the entry was written
+    double timestamp;
+    /// Position of the entry in everything ever written
+    uint64_t ticket;
+    uint32_t level;
+    char category[YEARN_LOG_CATEGORY_SIZE];
+    char message[YEARN_LOG_MESSAGE_SIZE];
+    uint32_t reserved;
+} yearn_log_entry;
+
+typedef struct yearn_log_ring yearn_log_ring;
+
+/// Host time in seconds on the clock entries use; `CACurrentMediaTime()` on Apple platforms
+double yearn_log_now(void);
+
+/// `capacity` is rounded up to a power of two. Returns NULL with errno set on failure.
+yearn_log_ring *yearn_log_ring_create(uint32_t capacity);
+
+void yearn_log_ring_destroy(yearn_log_ring *ring);
+
+/// Append a message; any thread, never blocks
+void yearn_log_ring_write(yearn_log_ring *ring, double timestamp, uint32_t level,
+                          const char *category, const char *message);
+
+/// Copy up to `max` of the newest entries, oldest first. Any thread.
+/// Returns the number copied.
+size_t yearn_log_ring_snapshot(const yearn_log_ring *ring, yearn_log_entry *entries, size_t max);
+
+/// Messages dropped because their slot was being written
+uint64_t yearn_log_ring_dropped(const yearn_log_ring *ring);
+
+// MARK: - Core Logging
+
+/// Route libretro core log messages into `ring`, or nowhere if NULL
+void yearn_log_set_core_ring(yearn_log_ring *ring);
+
+/// A `retro_log_printf_t`: formats the message and writes it to the core
+/// ring under category "core"
+void yearn_log_core_printf(enum retro_log_level level, const char *format, ...);
+
+/// Answer RETRO_ENVIRONMENT_GET_LOG_INTERFACE with `yearn_log_core_printf`,
+/// which Swift cannot name since it is variadic. Returns 0, or -1 if NULL.
+int yearn_log_provide_interface(struct retro_log_callback *callback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_log_h */
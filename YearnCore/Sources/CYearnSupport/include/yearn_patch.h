@@ -0,0 +1,70 @@
+//
+//  yearn_patch.h
+//  YearnCore
+//
+//  IPS / UPS / BPS soft-patching
+//
+//  A patch is applied in one forward pass over the patch data, writing into
+//  a caller-provided target buffer (typically a mapped output file) sized
+//  from yearn_patch_inspect(). UPS and BPS carry CRC32s of the source,
+//  target and patch; all three are checked.
+//
+
+#ifndef yearn_patch_h
+#define yearn_patch_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    YEARN_PATCH_UNKNOWN = 0,
+    YEARN_PATCH_IPS,
+    YEARN_PATCH_UPS,
+    YEARN_PATCH_BPS
+} yearn_patch_format;
+
+typedef enum {
+    YEARN_PATCH_OK = 0,
+    YEARN_PATCH_ERROR_FORMAT,          // not a patch, or truncated / malformed
+    YEARN_PATCH_ERROR_PATCH_CRC,       // the patch file is damaged
+    YEARN_PATCH_ERROR_SOURCE,          // the ROM is not the one the patch was made for
+    YEARN_PATCH_ERROR_TARGET_CRC,      // the result does not match the patch's checksum
+    YEARN_PATCH_ERROR_TARGET_SIZE      // the target buffer is too small
+} yearn_patch_status;
+
+typedef struct {
+    yearn_patch_format format;
+    /// Source size the patch expects (UPS/BPS; 0 for IPS)
+    uint64_t source_size;
+    /// Size of the patched ROM for a source of the given size
+    uint64_t target_size;
+    /// Checksums recorded in the patch (UPS/BPS)
+    uint32_t source_crc32;
+    uint32_t target_crc32;
+    uint32_t patch_crc32;
+} yearn_patch_info;
+
+/// Identify a patch and work out the target size
+/// `source_size` is needed for IPS, whose output is the source grown by its records
+yearn_patch_status yearn_patch_inspect(const uint8_t *patch, size_t patch_size, uint64_t source_size,
+                                       yearn_patch_info *info);
+
+/// Apply a patch
+/// `target` must hold `info.target_size` bytes from yearn_patch_inspect and
+/// must not overlap `source`. Checksums are verified unless `verify` is 0.
+yearn_patch_status yearn_patch_apply(const uint8_t *source, size_t source_size,
+                                     const uint8_t *patch, size_t patch_size,
+                                     uint8_t *target, size_t target_size, int verify);
+
+/// Human-readable status, for logs and errors
+const char *yearn_patch_status_string(yearn_patch_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_patch_h */
@@ -0,0 +1,68 @@
+//
+//  yearn_sniff.h
+//  YearnCore
+//
+//  Table-driven ROM / disc image classifier
+//
+//  One read of the start of the file (YEARN_SNIFF_BLOCK_SIZE bytes) is
+//  matched against a table of signatures and header checks. Each match
+//  yields a confidence between 0 and 1; checksummed headers score higher
+//  than bare magic strings.
+//
+
+#ifndef yearn_sniff_h
+#define yearn_sniff_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Bytes read from the start of a file: 64 KB, plus room for a SNES HiROM
+/// header behind a 512-byte copier header (0xFFC0 + 0x200)
+#define YEARN_SNIFF_BLOCK_SIZE (0x10000 + 0x1000)
+
+/// Most candidates yearn_sniff_* can return
+#define YEARN_SNIFF_MAX_RESULTS 4
+
+typedef enum {
+    YEARN_SNIFF_UNKNOWN = 0,
+    YEARN_SNIFF_NES,
+    YEARN_SNIFF_FDS,
+    YEARN_SNIFF_SNES,
+    YEARN_SNIFF_GB,
+    YEARN_SNIFF_GBC,
+    YEARN_SNIFF_GBA,
+    YEARN_SNIFF_N64,
+    YEARN_SNIFF_NDS,
+    YEARN_SNIFF_GENESIS,
+    YEARN_SNIFF_PS1,
+    YEARN_SNIFF_ISO9660        // a data CD that is not marked PlayStation
+} yearn_sniff_system;
+
+typedef struct {
+    yearn_sniff_system system;
+    float confidence;          // 0...1
+} yearn_sniff_result;
+
+/// Classify a header block
+/// `file_size` is the size of the whole file (used for copier-header detection)
+/// Fills up to `capacity` results, best first, and returns how many were written
+int yearn_sniff_buffer(const uint8_t *data, size_t length, uint64_t file_size,
+                       yearn_sniff_result *results, int capacity);
+
+/// Read the header block of a file and classify it
+/// Returns the number of results, or -1 with errno set if the file cannot be read
+/// `file_size` (may be NULL) receives the file size from the same open
+int yearn_sniff_file(const char *path, yearn_sniff_result *results, int capacity, uint64_t *file_size);
+
+/// Human-readable system name, for logs
+const char *yearn_sniff_system_name(yearn_sniff_system system);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_sniff_h */
@@ -0,0 +1,77 @@
+//
+//  yearn_vfs.h
+//  YearnCore
+//
+//  libretro VFS implementation with a read cache for disc images
+//
+//  Files registered with yearn_vfs_register_file() or
+//  yearn_vfs_register_virtual() are read through a block cache with
+//  sequential read-ahead on a background thread; every other path is
+//  passed straight to the file system.
+//
+
+#ifndef yearn_vfs_h
+#define yearn_vfs_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "libretro.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Highest VFS interface version implemented
+#define YEARN_VFS_INTERFACE_VERSION 3
+
+/// Cache block size (about 27 raw 2352-byte sectors)
+#define YEARN_VFS_BLOCK_SIZE (64 * 1024)
+
+/// Reads `length` bytes at `offset` of a virtual file into `buffer`
+/// Returns the number of bytes read, or -1 on error. Called from any thread.
+typedef int64_t (*yearn_vfs_read_fn)(void *context, uint64_t offset, void *buffer, uint64_t length);
+
+/// Releases the context of a virtual file once no reader can reach it
+typedef void (*yearn_vfs_release_fn)(void *context);
+
+/// Cache counters, summed over every registered file
+typedef struct {
+    uint64_t reads;             // read() calls served from registered files
+    uint64_t block_hits;        // blocks found in the cache
+    uint64_t block_misses;      // blocks read synchronously on the caller's thread
+    uint64_t readahead_blocks;  // blocks filled by the read-ahead thread
+    uint64_t readahead_hits;    // read-ahead blocks later used by a read
+    uint64_t bytes_read;        // bytes returned to the core
+    uint64_t source_bytes;      // bytes fetched from disk or a virtual source
+} yearn_vfs_stats;
+
+/// The interface handed to cores for RETRO_ENVIRONMENT_GET_VFS_INTERFACE
+struct retro_vfs_interface *yearn_vfs_interface(void);
+
+/// Serve reads of a file on disk through the block cache
+/// `cache_blocks` is the number of blocks kept for this file (0 = default)
+int yearn_vfs_register_file(const char *path, unsigned cache_blocks);
+
+/// Expose a read-only file that does not exist on disk
+/// `release` (may be NULL) is called with `context` after the file is
+/// unregistered and its last open handle and read-ahead request are gone.
+/// Not called if registration fails.
+int yearn_vfs_register_virtual(const char *path, uint64_t size,
+                               yearn_vfs_read_fn read, yearn_vfs_release_fn release,
+                               void *context, unsigned cache_blocks);
+
+/// Drop every registration and its cached blocks
+/// Handles that are still open keep working until they are closed
+void yearn_vfs_unregister_all(void);
+
+/// Current cache counters
+void yearn_vfs_get_stats(yearn_vfs_stats *stats);
+
+/// Reset the cache counters
+void yearn_vfs_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* yearn_vfs_h */
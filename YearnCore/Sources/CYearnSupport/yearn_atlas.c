@@ -0,0 +1,394 @@
+//
+//  yearn_atlas.c
+//  YearnCore
+//
+//  Packed thumbnail store: one memory-mapped file of fixed-size tiles
+//
+
+#include "include/yearn_atlas.h"
+#include "include/yearn_hash.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ATLAS_MAGIC "YATLAS01"
+#define PAGE 4096u
+#define HEADER_SIZE PAGE
+#define CHUNK_SLOTS 1024u
+#define ENTRY_SIZE 32u
+#define INDEX_SIZE (((CHUNK_SLOTS * ENTRY_SIZE) + PAGE - 1) / PAGE * PAGE)
+
+#define TABLE_EMPTY (-1)
+#define TABLE_TOMBSTONE (-2)
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_size;
+    uint32_t chunk_slots;
+    uint32_t chunk_count;
+} atlas_header;
+
+typedef struct {
+    uint8_t key[16];
+    uint32_t length;            // 0 = free slot
+    uint32_t crc32;
+    uint64_t sequence;          // store order, for eviction
+} atlas_entry;
+
+_Static_assert(sizeof(atlas_entry) == ENTRY_SIZE, "index entry layout");
+
+struct yearn_atlas {
+    int fd;
+    uint8_t *map;               // tiles are read through the mapping
+    size_t map_size;
+    atlas_entry *entries;       // in-memory copy of every index page
+
+    uint32_t slot_size;
+    uint32_t chunk_count;
+    uint32_t count;
+    uint32_t max_tiles;
+    uint64_t sequence;
+
+    // Open-addressing table: key -> slot
+    int32_t *table;
+    uint32_t table_mask;
+
+    uint32_t *free_slots;       // stack, lowest slot on top
+    uint32_t free_count;
+};
+
+// MARK: - Layout
+
+static size_t chunk_size(const yearn_atlas *atlas) {
+    return INDEX_SIZE + (size_t)CHUNK_SLOTS * atlas->slot_size;
+}
+
+static off_t entry_offset(const yearn_atlas *atlas, uint32_t slot) {
+    return (off_t)(HEADER_SIZE + (slot / CHUNK_SLOTS) * chunk_size(atlas) + (slot % CHUNK_SLOTS) * ENTRY_SIZE);
+}
+
+static off_t tile_offset(const yearn_atlas *atlas, uint32_t slot) {
+    return (off_t)(HEADER_SIZE + (slot / CHUNK_SLOTS) * chunk_size(atlas) + INDEX_SIZE
+                   + (size_t)(slot % CHUNK_SLOTS) * atlas->slot_size);
+}
+
+static const atlas_entry *entry_at(const yearn_atlas *atlas, uint32_t slot) {
+    return &atlas->entries[slot];
+}
+
+static uint32_t slot_capacity(const yearn_atlas *atlas) {
+    return atlas->chunk_count * CHUNK_SLOTS;
+}
+
+static int write_all(int fd, const void *data, size_t length, off_t offset) {
+    const uint8_t *p = data;
+    while (length > 0) {
+        ssize_t written = pwrite(fd, p, length, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += written;
+        offset += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+static int write_header(yearn_atlas *atlas) {
+    atlas_header header = { .version = 1, .slot_size = atlas->slot_size,
+                            .chunk_slots = CHUNK_SLOTS, .chunk_count = atlas->chunk_count };
+    memcpy(header.magic, ATLAS_MAGIC, 8);
+    return write_all(atlas->fd, &header, sizeof(header), 0);
+}
+
+static int write_entry(yearn_atlas *atlas, uint32_t slot, const atlas_entry *entry) {
+    if (write_all(atlas->fd, entry, sizeof(*entry), entry_offset(atlas, slot)) != 0) return -1;
+    atlas->entries[slot] = *entry;
+    return 0;
+}
+
+// Read the index pages with pread rather than through the mapping: faulting
+// them in would read ahead far into the tiles around each one
+static int load_entries(yearn_atlas *atlas, uint32_t first_chunk) {
+    atlas_entry *entries = realloc(atlas->entries, ((size_t)atlas->chunk_count * CHUNK_SLOTS + 1) * sizeof(atlas_entry));
+    if (!entries) {
+        errno = ENOMEM;
+        return -1;
+    }
+    atlas->entries = entries;
+    for (uint32_t chunk = first_chunk; chunk < atlas->chunk_count; chunk++) {
+        size_t length = CHUNK_SLOTS * sizeof(atlas_entry);
+        off_t offset = entry_offset(atlas, chunk * CHUNK_SLOTS);
+        ssize_t got = pread(atlas->fd, &entries[chunk * CHUNK_SLOTS], length, offset);
+        if (got < 0) return -1;
+        if ((size_t)got < length) memset((uint8_t *)&entries[chunk * CHUNK_SLOTS] + got, 0, length - (size_t)got);
+    }
+    return 0;
+}
+
+static int remap(yearn_atlas *atlas) {
+    if (atlas->map) {
+        munmap(atlas->map, atlas->map_size);
+        atlas->map = NULL;
+    }
+    atlas->map_size = HEADER_SIZE + atlas->chunk_count * chunk_size(atlas);
+    void *map = mmap(NULL, atlas->map_size, PROT_READ, MAP_SHARED, atlas->fd, 0);
+    if (map == MAP_FAILED) return -1;
+    atlas->map = map;
+    // Tiles are read one at a time, in no particular order; get() asks for each
+    madvise(map, atlas->map_size, MADV_RANDOM);
+    return 0;
+}
+
+// MARK: - Key Table
+
+static uint32_t key_hash(const uint8_t key[16]) {
+    uint32_t hash = 2166136261u;                // FNV-1a
+    for (int i = 0; i < 16; i++) hash = (hash ^ key[i]) * 16777619u;
+    return hash;
+}
+
+// Slot holding `key`, or -1
+static int32_t table_find(const yearn_atlas *atlas, const uint8_t key[16], uint32_t *position) {
+    uint32_t i = key_hash(key) & atlas->table_mask;
+    for (;;) {
+        int32_t slot = atlas->table[i];
+        if (slot == TABLE_EMPTY) return -1;
+        if (slot >= 0 && memcmp(entry_at(atlas, (uint32_t)slot)->key, key, 16) == 0) {
+            if (position) *position = i;
+            return slot;
+        }
+        i = (i + 1) & atlas->table_mask;
+    }
+}
+
+static void table_insert(yearn_atlas *atlas, const uint8_t key[16], uint32_t slot) {
+    uint32_t i = key_hash(key) & atlas->table_mask;
+    while (atlas->table[i] >= 0) i = (i + 1) & atlas->table_mask;
+    atlas->table[i] = (int32_t)slot;
+}
+
+static void free_push(yearn_atlas *atlas, uint32_t slot) {
+    atlas->free_slots[atlas->free_count++] = slot;
+}
+
+// Rebuild the table and free list from the index pages
+static int rebuild(yearn_atlas *atlas) {
+    uint32_t capacity = slot_capacity(atlas);
+    uint32_t table_size = 64;
+    while (table_size < capacity * 2) table_size <<= 1;
+
+    free(atlas->table);
+    free(atlas->free_slots);
+    atlas->table = malloc(table_size * sizeof(int32_t));
+    atlas->free_slots = malloc((capacity ? capacity : 1) * sizeof(uint32_t));
+    if (!atlas->table || !atlas->free_slots) {
+        errno = ENOMEM;
+        return -1;
+    }
+    for (uint32_t i = 0; i < table_size; i++) atlas->table[i] = TABLE_EMPTY;
+    atlas->table_mask = table_size - 1;
+    atlas->count = 0;
+    atlas->free_count = 0;
+
+    // Highest slots pushed first, so the lowest free slot is reused first
+    for (uint32_t n = capacity; n-- > 0;) {
+        const atlas_entry *entry = entry_at(atlas, n);
+        if (entry->length == 0 || entry->length > atlas->slot_size) {
+            free_push(atlas, n);
+            continue;
+        }
+        if (entry->sequence >= atlas->sequence) atlas->sequence = entry->sequence + 1;
+
+        // A crash between storing a replacement and freeing the old slot leaves two copies
+        int32_t other = table_find(atlas, entry->key, NULL);
+        if (other >= 0) {
+            uint32_t stale = entry_at(atlas, (uint32_t)other)->sequence > entry->sequence ? n : (uint32_t)other;
+            atlas_entry empty = { .length = 0 };
+            write_entry(atlas, stale, &empty);
+            free_push(atlas, stale);
+            if (stale == n) continue;
+            uint32_t position = 0;
+            table_find(atlas, entry->key, &position);
+            atlas->table[position] = (int32_t)n;
+            continue;
+        }
+        table_insert(atlas, entry->key, n);
+        atlas->count++;
+    }
+    return 0;
+}
+
+static int grow(yearn_atlas *atlas) {
+    uint32_t chunks = atlas->chunk_count + 1;
+    if (ftruncate(atlas->fd, (off_t)(HEADER_SIZE + chunks * chunk_size(atlas))) != 0) return -1;
+    atlas->chunk_count = chunks;
+    if (write_header(atlas) != 0 || remap(atlas) != 0 || load_entries(atlas, chunks - 1) != 0) return -1;
+    return rebuild(atlas);
+}
+
+// MARK: - Public
+
+yearn_atlas *yearn_atlas_open(const char *path, uint32_t slot_size) {
+    if (slot_size == 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    yearn_atlas *atlas = calloc(1, sizeof(*atlas));
+    if (!atlas) return NULL;
+    atlas->slot_size = (slot_size + PAGE - 1) / PAGE * PAGE;
+
+    atlas->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (atlas->fd < 0) {
+        free(atlas);
+        return NULL;
+    }
+
+    atlas_header header;
+    struct stat info;
+    int valid = fstat(atlas->fd, &info) == 0
+        && pread(atlas->fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header)
+        && memcmp(header.magic, ATLAS_MAGIC, 8) == 0
+        && header.version == 1
+        && header.slot_size == atlas->slot_size
+        && header.chunk_slots == CHUNK_SLOTS;
+
+    if (valid) {
+        // Keep only the chunks the file really holds
+        uint64_t available = info.st_size > HEADER_SIZE ? (uint64_t)info.st_size - HEADER_SIZE : 0;
+        uint64_t chunks = available / chunk_size(atlas);
+        atlas->chunk_count = header.chunk_count < chunks ? header.chunk_count : (uint32_t)chunks;
+    } else {
+        atlas->chunk_count = 0;
+        if (ftruncate(atlas->fd, HEADER_SIZE) != 0 || write_header(atlas) != 0) goto fail;
+    }
+
+    if (remap(atlas) != 0 || load_entries(atlas, 0) != 0 || rebuild(atlas) != 0) goto fail;
+    return atlas;
+
+fail:
+    {
+        int error = errno;
+        yearn_atlas_close(atlas);
+        errno = error;
+    }
+    return NULL;
+}
+
+void yearn_atlas_close(yearn_atlas *atlas) {
+    if (!atlas) return;
+    if (atlas->map) munmap(atlas->map, atlas->map_size);
+    if (atlas->fd >= 0) close(atlas->fd);
+    free(atlas->entries);
+    free(atlas->table);
+    free(atlas->free_slots);
+    free(atlas);
+}
+
+uint32_t yearn_atlas_slot_size(const yearn_atlas *atlas) {
+    return atlas->slot_size;
+}
+
+uint32_t yearn_atlas_count(const yearn_atlas *atlas) {
+    return atlas->count;
+}
+
+void yearn_atlas_set_max_tiles(yearn_atlas *atlas, uint32_t max_tiles) {
+    atlas->max_tiles = max_tiles;
+}
+
+long yearn_atlas_get(yearn_atlas *atlas, const uint8_t key[16], void *buffer, size_t capacity) {
+    int32_t slot = table_find(atlas, key, NULL);
+    if (slot < 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    const atlas_entry *entry = entry_at(atlas, (uint32_t)slot);
+    if (entry->length > capacity) {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    const uint8_t *tile = atlas->map + tile_offset(atlas, (uint32_t)slot);
+    madvise((void *)tile, entry->length, MADV_WILLNEED);      // one read for the whole tile
+    memcpy(buffer, tile, entry->length);
+    if (yearn_crc32(0, buffer, entry->length) != entry->crc32) {
+        // Torn by a crash while it was being written
+        yearn_atlas_remove(atlas, key);
+        errno = ENOENT;
+        return -1;
+    }
+    return (long)entry->length;
+}
+
+int yearn_atlas_remove(yearn_atlas *atlas, const uint8_t key[16]) {
+    uint32_t position = 0;
+    int32_t slot = table_find(atlas, key, &position);
+    if (slot < 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    atlas_entry empty = { .length = 0 };
+    if (write_entry(atlas, (uint32_t)slot, &empty) != 0) return -1;
+    atlas->table[position] = TABLE_TOMBSTONE;
+    free_push(atlas, (uint32_t)slot);
+    atlas->count--;
+    return 0;
+}
+
+// Remove the tile stored longest ago
+static int evict_oldest(yearn_atlas *atlas) {
+    uint32_t capacity = slot_capacity(atlas);
+    int64_t oldest = -1;
+    for (uint32_t n = 0; n < capacity; n++) {
+        const atlas_entry *entry = entry_at(atlas, n);
+        if (entry->length == 0 || entry->length > atlas->slot_size) continue;
+        if (oldest < 0 || entry->sequence < entry_at(atlas, (uint32_t)oldest)->sequence) oldest = n;
+    }
+    if (oldest < 0) return 0;
+    uint8_t key[16];
+    memcpy(key, entry_at(atlas, (uint32_t)oldest)->key, 16);
+    return yearn_atlas_remove(atlas, key);
+}
+
+int yearn_atlas_put(yearn_atlas *atlas, const uint8_t key[16], const void *data, size_t length) {
+    if (length == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (length > atlas->slot_size) {
+        errno = EFBIG;
+        return -1;
+    }
+
+    // The old tile stays readable until the new one is complete
+    int32_t old = table_find(atlas, key, NULL);
+    if (old < 0 && atlas->max_tiles && atlas->count >= atlas->max_tiles && evict_oldest(atlas) != 0) return -1;
+    if (atlas->free_count == 0 && grow(atlas) != 0) return -1;
+    if (old >= 0) old = table_find(atlas, key, NULL);     // grow() rebuilt the table
+
+    uint32_t slot = atlas->free_slots[--atlas->free_count];
+    atlas_entry entry = { .length = (uint32_t)length, .crc32 = yearn_crc32(0, data, length),
+                          .sequence = atlas->sequence++ };
+    memcpy(entry.key, key, 16);
+
+    if (write_all(atlas->fd, data, length, tile_offset(atlas, slot)) != 0
+        || write_entry(atlas, slot, &entry) != 0) {
+        free_push(atlas, slot);
+        return -1;
+    }
+
+    if (old >= 0) {
+        yearn_atlas_remove(atlas, key);
+    }
+    table_insert(atlas, key, slot);
+    atlas->count++;
+    return 0;
+}
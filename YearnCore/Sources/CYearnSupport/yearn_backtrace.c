@@ -0,0 +1,291 @@
+//
+//  yearn_backtrace.c
+//  YearnCore
+//
+//  Return addresses of another thread's stack, captured while it runs
+//
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "include/yearn_backtrace.h"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <semaphore.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+#endif
+
+#if defined(__has_feature)
+#if __has_feature(ptrauth_calls)
+#include <ptrauth.h>
+#define STRIP(address) ((uintptr_t)ptrauth_strip((void *)(address), ptrauth_key_return_address))
+#endif
+#endif
+#ifndef STRIP
+#define STRIP(address) ((uintptr_t)(address))
+#endif
+
+struct yearn_thread {
+    pthread_t pthread;
+#if defined(__APPLE__)
+    thread_t port;
+#endif
+    // Stack bounds; frame records outside them end the walk
+    uintptr_t low;
+    uintptr_t high;
+};
+
+// MARK: - Frame Walking
+
+// Follow frame records (saved frame pointer, then return address) outward
+// from `fp`, after `pc` if it is non-zero. Reads only inside the stack,
+// including the redzones AddressSanitizer puts between locals.
+__attribute__((no_sanitize("address")))
+static int walk(uintptr_t pc, uintptr_t fp, uintptr_t low, uintptr_t high, uintptr_t *frames, int max) {
+    int count = 0;
+    if (pc != 0 && count < max) {
+        frames[count++] = STRIP(pc);
+    }
+    while (count < max && fp >= low && fp % sizeof(uintptr_t) == 0
+           && fp + 2 * sizeof(uintptr_t) <= high) {
+        const uintptr_t *record = (const uintptr_t *)fp;
+        uintptr_t next = record[0];
+        uintptr_t address = STRIP(record[1]);
+        if (address == 0) break;
+        frames[count++] = address;
+        // Stacks grow down, so callers' records are always higher
+        if (next <= fp) break;
+        fp = next;
+    }
+    return count;
+}
+
+// MARK: - Linux Capture
+
+#if defined(__linux__)
+
+#define CAPTURE_TIMEOUT_NS 500000000L
+#define CAPTURE_MAX_FRAMES 256
+
+// One capture at a time; the handler fills the request and posts `done`
+static struct {
+    pthread_mutex_t lock;
+    sem_t done;
+    uintptr_t low;
+    uintptr_t high;
+    int count;
+    uintptr_t frames[CAPTURE_MAX_FRAMES];
+} capture = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static pthread_once_t capture_once = PTHREAD_ONCE_INIT;
+static int capture_signal = -1;
+
+static void capture_handler(int signal, siginfo_t *info, void *context) {
+    (void)signal;
+    (void)info;
+    int saved = errno;
+    const ucontext_t *state = context;
+    uintptr_t pc = 0, fp = 0;
+#if defined(__x86_64__)
+    pc = (uintptr_t)state->uc_mcontext.gregs[REG_RIP];
+    fp = (uintptr_t)state->uc_mcontext.gregs[REG_RBP];
+#elif defined(__aarch64__)
+    pc = (uintptr_t)state->uc_mcontext.pc;
+    fp = (uintptr_t)state->uc_mcontext.regs[29];
+#else
+    (void)state;
+#endif
+    uintptr_t low = __atomic_load_n(&capture.low, __ATOMIC_ACQUIRE);
+    uintptr_t high = __atomic_load_n(&capture.high, __ATOMIC_ACQUIRE);
+    int count = walk(pc, fp, low, high, capture.frames, CAPTURE_MAX_FRAMES);
+    __atomic_store_n(&capture.count, count, __ATOMIC_RELEASE);
+    sem_post(&capture.done);
+    errno = saved;
+}
+
+static void install_capture_handler(void) {
+    if (sem_init(&capture.done, 0, 0) != 0) return;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = capture_handler;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    // A real-time signal nothing else in the process claims
+    int signal = SIGRTMIN + 3;
+    if (sigaction(signal, &action, NULL) == 0) {
+        capture_signal = signal;
+    }
+}
+
+static int capture_other(yearn_thread *thread, uintptr_t *frames, int max) {
+    pthread_once(&capture_once, install_capture_handler);
+    if (capture_signal < 0) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    pthread_mutex_lock(&capture.lock);
+    // A handler that answered after an earlier timeout left a post behind
+    while (sem_trywait(&capture.done) == 0) {}
+    __atomic_store_n(&capture.low, thread->low, __ATOMIC_RELEASE);
+    __atomic_store_n(&capture.high, thread->high, __ATOMIC_RELEASE);
+    __atomic_store_n(&capture.count, 0, __ATOMIC_RELEASE);
+
+    int result = pthread_kill(thread->pthread, capture_signal);
+    if (result != 0) {
+        pthread_mutex_unlock(&capture.lock);
+        errno = result;
+        return -1;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += CAPTURE_TIMEOUT_NS;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    int waited;
+    while ((waited = sem_timedwait(&capture.done, &deadline)) != 0 && errno == EINTR) {}
+    if (waited != 0) {
+        pthread_mutex_unlock(&capture.lock);
+        errno = ETIMEDOUT;
+        return -1;
+    }
+
+    int count = __atomic_load_n(&capture.count, __ATOMIC_ACQUIRE);
+    if (count > max) count = max;
+    memcpy(frames, capture.frames, (size_t)count * sizeof(uintptr_t));
+    pthread_mutex_unlock(&capture.lock);
+    return count;
+}
+
+#endif
+
+// MARK: - Apple Capture
+
+#if defined(__APPLE__)
+
+static int capture_other(yearn_thread *thread, uintptr_t *frames, int max) {
+    if (thread_suspend(thread->port) != KERN_SUCCESS) {
+        errno = ESRCH;
+        return -1;
+    }
+
+    // The thread may hold any lock, malloc's included: only read registers
+    // and its stack until it is resumed
+    uintptr_t pc = 0, fp = 0;
+    kern_return_t status = KERN_FAILURE;
+#if defined(__arm64__)
+    arm_thread_state64_t state;
+    mach_msg_type_number_t count = ARM_THREAD_STATE64_COUNT;
+    status = thread_get_state(thread->port, ARM_THREAD_STATE64, (thread_state_t)&state, &count);
+    if (status == KERN_SUCCESS) {
+        pc = (uintptr_t)arm_thread_state64_get_pc(state);
+        fp = (uintptr_t)arm_thread_state64_get_fp(state);
+    }
+#elif defined(__x86_64__)
+    x86_thread_state64_t state;
+    mach_msg_type_number_t count = x86_THREAD_STATE64_COUNT;
+    status = thread_get_state(thread->port, x86_THREAD_STATE64, (thread_state_t)&state, &count);
+    if (status == KERN_SUCCESS) {
+        pc = (uintptr_t)state.__rip;
+        fp = (uintptr_t)state.__rbp;
+    }
+#endif
+    int captured = status == KERN_SUCCESS ? walk(pc, fp, thread->low, thread->high, frames, max) : 0;
+    thread_resume(thread->port);
+
+    if (status != KERN_SUCCESS) {
+        errno = EIO;
+        return -1;
+    }
+    return captured;
+}
+
+#endif
+
+// MARK: - Public
+
+yearn_thread *yearn_thread_current(void) {
+    yearn_thread *thread = calloc(1, sizeof(*thread));
+    if (!thread) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    thread->pthread = pthread_self();
+
+#if defined(__APPLE__)
+    thread->port = mach_thread_self();
+    thread->high = (uintptr_t)pthread_get_stackaddr_np(thread->pthread);
+    thread->low = thread->high - pthread_get_stacksize_np(thread->pthread);
+#elif defined(__linux__)
+    pthread_attr_t attributes;
+    void *base = NULL;
+    size_t size = 0;
+    if (pthread_getattr_np(thread->pthread, &attributes) == 0) {
+        pthread_attr_getstack(&attributes, &base, &size);
+        pthread_attr_destroy(&attributes);
+    }
+    thread->low = (uintptr_t)base;
+    thread->high = (uintptr_t)base + size;
+#endif
+    return thread;
+}
+
+void yearn_thread_release(yearn_thread *thread) {
+    if (!thread) return;
+#if defined(__APPLE__)
+    mach_port_deallocate(mach_task_self(), thread->port);
+#endif
+    free(thread);
+}
+
+int yearn_thread_backtrace(yearn_thread *thread, uintptr_t *frames, int max) {
+    if (!thread || !frames || max <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (pthread_equal(thread->pthread, pthread_self())) {
+        // Stopping ourselves would never return; our own chain is right here
+        return walk(0, (uintptr_t)__builtin_frame_address(0), thread->low, thread->high, frames, max);
+    }
+#if defined(__APPLE__) || defined(__linux__)
+    return capture_other(thread, frames, max);
+#else
+    errno = ENOTSUP;
+    return -1;
+#endif
+}
+
+int yearn_symbolicate(uintptr_t address, char *buffer, size_t size) {
+    Dl_info info;
+    if (!buffer || size == 0 || dladdr((const void *)address, &info) == 0 || !info.dli_fname) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    const char *image = strrchr(info.dli_fname, '/');
+    image = image ? image + 1 : info.dli_fname;
+    if (info.dli_sname && info.dli_saddr) {
+        snprintf(buffer, size, "%s %s + %lu", image, info.dli_sname,
+                 (unsigned long)(address - (uintptr_t)info.dli_saddr));
+    } else {
+        snprintf(buffer, size, "%s + %lu", image,
+                 (unsigned long)(address - (uintptr_t)info.dli_fbase));
+    }
+    return 0;
+}
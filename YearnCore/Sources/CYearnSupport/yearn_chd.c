@@ -0,0 +1,737 @@
+//
+//  yearn_chd.c
+//  YearnCore
+//
+//  Minimal reader for CHD v5 CD images
+//
+//  Follows the layout used by MAME's chdman / libchdr: a 124-byte header,
+//  a Huffman-coded hunk map, a chain of metadata entries and hunks that are
+//  compressed independently, which is what lets callers decode them in
+//  parallel.
+//
+
+#include "include/yearn_chd.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define CHD_V5_HEADER_SIZE 124
+#define CHD_CODEC_ZLIB 0x7a6c6962      // 'zlib'
+#define CHD_CODEC_CD_ZLIB 0x63647a6c   // 'cdzl'
+
+#define CD_SUBCODE_SIZE 96
+#define CD_SYNC_SIZE 12
+#define CD_MAX_FRAMES_PER_HUNK 256
+
+// Hunk map entry types
+enum {
+    COMPRESSION_TYPE_0 = 0,
+    COMPRESSION_TYPE_1,
+    COMPRESSION_TYPE_2,
+    COMPRESSION_TYPE_3,
+    COMPRESSION_NONE,
+    COMPRESSION_SELF,
+    COMPRESSION_PARENT,
+    COMPRESSION_RLE_SMALL,
+    COMPRESSION_RLE_LARGE,
+    COMPRESSION_SELF_0,
+    COMPRESSION_SELF_1,
+    COMPRESSION_PARENT_SELF,
+    COMPRESSION_PARENT_0,
+    COMPRESSION_PARENT_1
+};
+
+struct yearn_chd {
+    int fd;
+    yearn_chd_header header;
+    uint64_t map_offset;
+    uint64_t meta_offset;
+    uint8_t *map;           // 12 bytes per hunk when compressed, 4 when not
+    int compressed;
+    int supported;
+};
+
+static const uint8_t cd_sync_header[CD_SYNC_SIZE] = {
+    0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00
+};
+
+// MARK: - Byte Helpers
+
+static uint16_t be16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t be24(const uint8_t *p) {
+    return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+static uint32_t be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint64_t be48(const uint8_t *p) {
+    return ((uint64_t)be16(p) << 32) | be32(p + 2);
+}
+
+static uint64_t be64(const uint8_t *p) {
+    return ((uint64_t)be32(p) << 32) | be32(p + 4);
+}
+
+static void put_be16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+static void put_be24(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)(value >> 16);
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)value;
+}
+
+static void put_be48(uint8_t *p, uint64_t value) {
+    for (int i = 5; i >= 0; i--) {
+        p[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+static int read_at(int fd, uint64_t offset, void *buffer, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = pread(fd, (uint8_t *)buffer + done, length - done, (off_t)(offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        done += (size_t)n;
+    }
+    return 0;
+}
+
+// MARK: - Tables
+
+static uint16_t crc16_table[256];
+static uint8_t ecc_f_lut[256];
+static uint8_t ecc_b_lut[256];
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+static void build_tables(void) {
+    // CRC-16/CCITT, as used for hunk and map checksums
+    for (unsigned i = 0; i < 256; i++) {
+        uint16_t crc = (uint16_t)(i << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+        crc16_table[i] = crc;
+    }
+
+    // GF(2^8) multiply-by-2 and its inverse for the CD-ROM Reed-Solomon parity
+    for (unsigned i = 0; i < 256; i++) {
+        unsigned j = (i << 1) ^ ((i & 0x80) ? 0x11d : 0);
+        ecc_f_lut[i] = (uint8_t)j;
+        ecc_b_lut[i ^ j] = (uint8_t)i;
+    }
+}
+
+static uint16_t crc16(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xffff;
+    while (length--) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[(crc >> 8) ^ *data++]);
+    }
+    return crc;
+}
+
+// MARK: - ECC
+
+// Byte `offset` of the area covered by the parity, counted from the header.
+// Mode 2 form 1 sectors compute parity with the header treated as zero.
+static uint8_t ecc_source_byte(const uint8_t *sector, uint32_t offset) {
+    return (sector[15] == 2 && offset < 4) ? 0x00 : sector[CD_SYNC_SIZE + offset];
+}
+
+static void ecc_compute(const uint8_t *sector, uint32_t major, uint32_t major_mult,
+                        uint32_t minor_count, uint32_t minor_inc, uint8_t *out1, uint8_t *out2) {
+    const uint32_t size = 2236;     // header + user data + EDC + P parity
+    uint32_t index = (major >> 1) * major_mult + (major & 1);
+    uint8_t a = 0;
+    uint8_t b = 0;
+
+    for (uint32_t minor = 0; minor < minor_count; minor++) {
+        uint8_t value = ecc_source_byte(sector, index);
+        index += minor_inc;
+        if (index >= size) {
+            index -= size;
+        }
+        a ^= value;
+        b ^= value;
+        a = ecc_f_lut[a];
+    }
+
+    a = ecc_b_lut[ecc_f_lut[a] ^ b];
+    *out1 = a;
+    *out2 = a ^ b;
+}
+
+void yearn_cdrom_ecc_generate(uint8_t *sector) {
+    pthread_once(&tables_once, build_tables);
+
+    // P parity: 86 columns of 24 bytes
+    for (uint32_t major = 0; major < 86; major++) {
+        ecc_compute(sector, major, 2, 24, 86, &sector[0x81c + major], &sector[0x81c + 86 + major]);
+    }
+    // Q parity: 52 diagonals of 43 bytes, covering the P parity too
+    for (uint32_t major = 0; major < 52; major++) {
+        ecc_compute(sector, major, 86, 43, 88, &sector[0x8c8 + major], &sector[0x8c8 + 52 + major]);
+    }
+}
+
+// MARK: - Hunk Map
+
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+    size_t offset;
+    uint32_t buffer;
+    int bits;
+} bitstream;
+
+static uint32_t bits_peek(bitstream *bs, int count) {
+    if (count == 0) {
+        return 0;
+    }
+    if (count > bs->bits) {
+        while (bs->bits <= 24) {
+            if (bs->offset < bs->length) {
+                bs->buffer |= (uint32_t)bs->data[bs->offset] << (24 - bs->bits);
+            }
+            bs->offset++;
+            bs->bits += 8;
+        }
+    }
+    return bs->buffer >> (32 - count);
+}
+
+static void bits_remove(bitstream *bs, int count) {
+    bs->buffer <<= count;
+    bs->bits -= count;
+}
+
+static uint32_t bits_read(bitstream *bs, int count) {
+    uint32_t value = bits_peek(bs, count);
+    bits_remove(bs, count);
+    return value;
+}
+
+static int bits_overflowed(const bitstream *bs) {
+    return bs->offset - (size_t)(bs->bits / 8) > bs->length;
+}
+
+// Canonical Huffman decoder for the 16 map codes, at most 8 bits each
+#define MAP_CODES 16
+#define MAP_MAX_BITS 8
+
+typedef struct {
+    uint8_t lengths[MAP_CODES];
+    uint16_t lookup[1 << MAP_MAX_BITS];    // code << 5 | length
+} huffman;
+
+static int huffman_import(huffman *h, bitstream *bs) {
+    const int field = 4;    // bits per length for an 8-bit maximum
+    int node = 0;
+
+    while (node < MAP_CODES) {
+        int length = (int)bits_read(bs, field);
+        if (length != 1) {
+            h->lengths[node++] = (uint8_t)length;
+            continue;
+        }
+        // 1 escapes: "1 1" is a literal 1, "1 n r" repeats n (r + 3) times
+        length = (int)bits_read(bs, field);
+        if (length == 1) {
+            h->lengths[node++] = 1;
+            continue;
+        }
+        int repeat = (int)bits_read(bs, field) + 3;
+        if (node + repeat > MAP_CODES) {
+            return -1;
+        }
+        while (repeat--) {
+            h->lengths[node++] = (uint8_t)length;
+        }
+    }
+
+    // Assign canonical codes, longest first
+    uint32_t histogram[33] = { 0 };
+    for (int i = 0; i < MAP_CODES; i++) {
+        if (h->lengths[i] > MAP_MAX_BITS) {
+            return -1;
+        }
+        histogram[h->lengths[i]]++;
+    }
+    uint32_t start = 0;
+    for (int length = 32; length > 0; length--) {
+        uint32_t next = (start + histogram[length]) >> 1;
+        if (length != 1 && next * 2 != start + histogram[length]) {
+            return -1;
+        }
+        histogram[length] = start;
+        start = next;
+    }
+
+    memset(h->lookup, 0, sizeof(h->lookup));
+    for (int i = 0; i < MAP_CODES; i++) {
+        int length = h->lengths[i];
+        if (length == 0) {
+            continue;
+        }
+        uint32_t code = histogram[length]++;
+        int shift = MAP_MAX_BITS - length;
+        uint16_t value = (uint16_t)((i << 5) | length);
+        for (uint32_t slot = code << shift; slot < ((code + 1) << shift); slot++) {
+            h->lookup[slot] = value;
+        }
+    }
+
+    return bits_overflowed(bs) ? -1 : 0;
+}
+
+static int huffman_decode(const huffman *h, bitstream *bs) {
+    uint16_t value = h->lookup[bits_peek(bs, MAP_MAX_BITS)];
+    bits_remove(bs, value & 0x1f);
+    return value >> 5;
+}
+
+static yearn_chd_error decode_map(yearn_chd *chd) {
+    const yearn_chd_header *header = &chd->header;
+    uint8_t raw[16];
+    if (read_at(chd->fd, chd->map_offset, raw, sizeof(raw)) != 0) {
+        return YEARN_CHD_ERROR_FILE;
+    }
+
+    uint32_t map_bytes = be32(&raw[0]);
+    uint64_t first_offset = be48(&raw[4]);
+    uint16_t map_crc = be16(&raw[10]);
+    int length_bits = raw[12];
+    int self_bits = raw[13];
+    int parent_bits = raw[14];
+
+    uint8_t *compressed = malloc(map_bytes ? map_bytes : 1);
+    chd->map = calloc(header->hunk_count, 12);
+    if (!compressed || !chd->map) {
+        free(compressed);
+        return YEARN_CHD_ERROR_MEMORY;
+    }
+    if (read_at(chd->fd, chd->map_offset + sizeof(raw), compressed, map_bytes) != 0) {
+        free(compressed);
+        return YEARN_CHD_ERROR_FILE;
+    }
+
+    bitstream bs = { compressed, map_bytes, 0, 0, 0 };
+    huffman h;
+    if (huffman_import(&h, &bs) != 0) {
+        free(compressed);
+        return YEARN_CHD_ERROR_FORMAT;
+    }
+
+    // Pass 1: entry types, run-length coded
+    uint8_t last_type = 0;
+    uint32_t repeat = 0;
+    for (uint32_t hunk = 0; hunk < header->hunk_count; hunk++) {
+        uint8_t *entry = &chd->map[hunk * 12];
+        if (repeat > 0) {
+            entry[0] = last_type;
+            repeat--;
+            continue;
+        }
+        int value = huffman_decode(&h, &bs);
+        if (value == COMPRESSION_RLE_SMALL) {
+            entry[0] = last_type;
+            repeat = 2 + (uint32_t)huffman_decode(&h, &bs);
+        } else if (value == COMPRESSION_RLE_LARGE) {
+            entry[0] = last_type;
+            repeat = 2 + 16 + ((uint32_t)huffman_decode(&h, &bs) << 4);
+            repeat += (uint32_t)huffman_decode(&h, &bs);
+        } else {
+            entry[0] = last_type = (uint8_t)value;
+        }
+    }
+
+    // Pass 2: lengths, offsets and CRCs; pseudo-types become base types
+    uint64_t current = first_offset;
+    uint64_t last_self = 0;
+    uint64_t last_parent = 0;
+    for (uint32_t hunk = 0; hunk < header->hunk_count; hunk++) {
+        uint8_t *entry = &chd->map[hunk * 12];
+        uint64_t offset = current;
+        uint32_t length = 0;
+        uint16_t crc = 0;
+
+        switch (entry[0]) {
+        case COMPRESSION_TYPE_0:
+        case COMPRESSION_TYPE_1:
+        case COMPRESSION_TYPE_2:
+        case COMPRESSION_TYPE_3:
+            length = bits_read(&bs, length_bits);
+            current += length;
+            crc = (uint16_t)bits_read(&bs, 16);
+            break;
+        case COMPRESSION_NONE:
+            length = header->hunk_bytes;
+            current += length;
+            crc = (uint16_t)bits_read(&bs, 16);
+            break;
+        case COMPRESSION_SELF:
+            last_self = offset = bits_read(&bs, self_bits);
+            break;
+        case COMPRESSION_PARENT:
+            offset = bits_read(&bs, parent_bits);
+            last_parent = offset;
+            break;
+        case COMPRESSION_SELF_1:
+            last_self++;
+            /* fall through */
+        case COMPRESSION_SELF_0:
+            entry[0] = COMPRESSION_SELF;
+            offset = last_self;
+            break;
+        case COMPRESSION_PARENT_SELF:
+            entry[0] = COMPRESSION_PARENT;
+            last_parent = offset = ((uint64_t)hunk * header->hunk_bytes) / header->unit_bytes;
+            break;
+        case COMPRESSION_PARENT_1:
+            last_parent += header->hunk_bytes / header->unit_bytes;
+            /* fall through */
+        case COMPRESSION_PARENT_0:
+            entry[0] = COMPRESSION_PARENT;
+            offset = last_parent;
+            break;
+        default:
+            free(compressed);
+            return YEARN_CHD_ERROR_FORMAT;
+        }
+
+        put_be24(&entry[1], length);
+        put_be48(&entry[4], offset);
+        put_be16(&entry[10], crc);
+    }
+
+    free(compressed);
+
+    if (bits_overflowed(&bs) || crc16(chd->map, (size_t)header->hunk_count * 12) != map_crc) {
+        return YEARN_CHD_ERROR_FORMAT;
+    }
+    return YEARN_CHD_OK;
+}
+
+static int codec_supported(uint32_t codec) {
+    return codec == CHD_CODEC_ZLIB || codec == CHD_CODEC_CD_ZLIB;
+}
+
+static int check_supported(const yearn_chd *chd) {
+    if (!chd->compressed) {
+        return 1;
+    }
+    for (uint32_t hunk = 0; hunk < chd->header.hunk_count; hunk++) {
+        uint8_t type = chd->map[hunk * 12];
+        if (type == COMPRESSION_PARENT) {
+            return 0;
+        }
+        if (type <= COMPRESSION_TYPE_3 && !codec_supported(chd->header.compressors[type])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// MARK: - Open / Close
+
+yearn_chd *yearn_chd_open(const char *path, yearn_chd_error *error) {
+    yearn_chd_error status = YEARN_CHD_OK;
+    pthread_once(&tables_once, build_tables);
+
+    yearn_chd *chd = calloc(1, sizeof(yearn_chd));
+    if (!chd) {
+        status = YEARN_CHD_ERROR_MEMORY;
+        goto fail;
+    }
+    chd->fd = open(path, O_RDONLY);
+    if (chd->fd < 0) {
+        status = YEARN_CHD_ERROR_FILE;
+        goto fail;
+    }
+
+    uint8_t raw[CHD_V5_HEADER_SIZE];
+    if (read_at(chd->fd, 0, raw, 16) != 0 || memcmp(raw, "MComprHD", 8) != 0) {
+        status = YEARN_CHD_ERROR_FORMAT;
+        goto fail;
+    }
+    chd->header.version = be32(&raw[12]);
+    if (chd->header.version != 5 || be32(&raw[8]) != CHD_V5_HEADER_SIZE) {
+        status = YEARN_CHD_ERROR_UNSUPPORTED;
+        goto fail;
+    }
+    if (read_at(chd->fd, 0, raw, CHD_V5_HEADER_SIZE) != 0) {
+        status = YEARN_CHD_ERROR_FILE;
+        goto fail;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        chd->header.compressors[i] = be32(&raw[16 + i * 4]);
+    }
+    chd->header.logical_bytes = be64(&raw[32]);
+    chd->map_offset = be64(&raw[40]);
+    chd->meta_offset = be64(&raw[48]);
+    chd->header.hunk_bytes = be32(&raw[56]);
+    chd->header.unit_bytes = be32(&raw[60]);
+
+    const yearn_chd_header *header = &chd->header;
+    if (header->hunk_bytes == 0 || header->unit_bytes == 0 ||
+        header->hunk_bytes % header->unit_bytes != 0) {
+        status = YEARN_CHD_ERROR_FORMAT;
+        goto fail;
+    }
+    uint64_t hunk_count = (header->logical_bytes + header->hunk_bytes - 1) / header->hunk_bytes;
+    if (hunk_count > UINT32_MAX / 12) {
+        status = YEARN_CHD_ERROR_FORMAT;
+        goto fail;
+    }
+    chd->header.hunk_count = (uint32_t)hunk_count;
+
+    // A non-zero parent SHA-1 means hunks may live in another file
+    int has_parent = 0;
+    for (int i = 104; i < 124; i++) {
+        has_parent |= raw[i];
+    }
+
+    chd->compressed = header->compressors[0] != 0;
+    if (chd->compressed) {
+        status = decode_map(chd);
+        if (status != YEARN_CHD_OK) {
+            goto fail;
+        }
+    } else {
+        chd->map = malloc((size_t)header->hunk_count * 4 + 1);
+        if (!chd->map) {
+            status = YEARN_CHD_ERROR_MEMORY;
+            goto fail;
+        }
+        if (read_at(chd->fd, chd->map_offset, chd->map, (size_t)header->hunk_count * 4) != 0) {
+            status = YEARN_CHD_ERROR_FILE;
+            goto fail;
+        }
+    }
+
+    chd->supported = !has_parent && check_supported(chd);
+    if (error) {
+        *error = YEARN_CHD_OK;
+    }
+    return chd;
+
+fail:
+    yearn_chd_close(chd);
+    if (error) {
+        *error = status;
+    }
+    return NULL;
+}
+
+void yearn_chd_close(yearn_chd *chd) {
+    if (!chd) {
+        return;
+    }
+    if (chd->fd >= 0) {
+        close(chd->fd);
+    }
+    free(chd->map);
+    free(chd);
+}
+
+const yearn_chd_header *yearn_chd_get_header(const yearn_chd *chd) {
+    return &chd->header;
+}
+
+int yearn_chd_is_supported(const yearn_chd *chd) {
+    return chd->supported;
+}
+
+int yearn_chd_get_metadata(yearn_chd *chd, uint32_t tag, uint32_t index, char *buffer, size_t capacity) {
+    uint64_t offset = chd->meta_offset;
+    uint32_t found = 0;
+
+    // The chain is short; the bound only guards against loops in damaged files
+    for (int guard = 0; offset != 0 && guard < 4096; guard++) {
+        uint8_t raw[16];
+        if (read_at(chd->fd, offset, raw, sizeof(raw)) != 0) {
+            return -1;
+        }
+        uint32_t entry_tag = be32(&raw[0]);
+        uint32_t length = be24(&raw[5]);
+
+        if (entry_tag == tag && found++ == index) {
+            if (capacity == 0) {
+                return (int)length;
+            }
+            size_t count = length < capacity - 1 ? length : capacity - 1;
+            if (read_at(chd->fd, offset + sizeof(raw), buffer, count) != 0) {
+                return -1;
+            }
+            buffer[count] = '\0';
+            return (int)length;
+        }
+        offset = be64(&raw[8]);
+    }
+    return -1;
+}
+
+// MARK: - Hunk Decoding
+
+static int inflate_raw(const uint8_t *source, size_t source_length, uint8_t *dest, size_t dest_length) {
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+        return -1;
+    }
+    zs.next_in = (Bytef *)source;
+    zs.avail_in = (uInt)source_length;
+    zs.next_out = dest;
+    zs.avail_out = (uInt)dest_length;
+
+    int status = inflate(&zs, Z_FINISH);
+    uLong produced = zs.total_out;
+    inflateEnd(&zs);
+
+    if (status != Z_STREAM_END && status != Z_OK && status != Z_BUF_ERROR) {
+        return -1;
+    }
+    return produced == dest_length ? 0 : -1;
+}
+
+// cdzl: deflated sector data, deflated subcode, and a bitmap of sectors whose
+// sync header and ECC were stripped because they could be regenerated
+static int decode_cd_zlib(const uint8_t *source, size_t length, uint8_t *dest, size_t dest_length) {
+    uint32_t frames = (uint32_t)(dest_length / YEARN_CHD_FRAME_SIZE);
+    if (frames == 0 || frames > CD_MAX_FRAMES_PER_HUNK) {
+        return -1;
+    }
+    size_t ecc_bytes = (frames + 7) / 8;
+    size_t length_bytes = dest_length < 65536 ? 2 : 3;
+    size_t header_bytes = ecc_bytes + length_bytes;
+    if (length < header_bytes) {
+        return -1;
+    }
+
+    size_t base_length = ((size_t)source[ecc_bytes] << 8) | source[ecc_bytes + 1];
+    if (length_bytes > 2) {
+        base_length = (base_length << 8) | source[ecc_bytes + 2];
+    }
+    if (header_bytes + base_length > length) {
+        return -1;
+    }
+
+    size_t sector_bytes = (size_t)frames * YEARN_CHD_SECTOR_SIZE;
+    size_t subcode_bytes = (size_t)frames * CD_SUBCODE_SIZE;
+    uint8_t *buffer = malloc(sector_bytes + subcode_bytes);
+    if (!buffer) {
+        return -1;
+    }
+
+    if (inflate_raw(source + header_bytes, base_length, buffer, sector_bytes) != 0) {
+        free(buffer);
+        return -1;
+    }
+    // Subcode is not used by the cores; keep going with zeros if it is damaged
+    size_t subcode_offset = header_bytes + base_length;
+    if (inflate_raw(source + subcode_offset, length - subcode_offset, buffer + sector_bytes, subcode_bytes) != 0) {
+        memset(buffer + sector_bytes, 0, subcode_bytes);
+    }
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        uint8_t *sector = dest + (size_t)frame * YEARN_CHD_FRAME_SIZE;
+        memcpy(sector, buffer + (size_t)frame * YEARN_CHD_SECTOR_SIZE, YEARN_CHD_SECTOR_SIZE);
+        memcpy(sector + YEARN_CHD_SECTOR_SIZE, buffer + sector_bytes + (size_t)frame * CD_SUBCODE_SIZE, CD_SUBCODE_SIZE);
+
+        if (source[frame / 8] & (1 << (frame % 8))) {
+            memcpy(sector, cd_sync_header, CD_SYNC_SIZE);
+            yearn_cdrom_ecc_generate(sector);
+        }
+    }
+
+    free(buffer);
+    return 0;
+}
+
+static yearn_chd_error read_hunk(yearn_chd *chd, uint32_t hunk, uint8_t *dest, int depth) {
+    const yearn_chd_header *header = &chd->header;
+    if (hunk >= header->hunk_count) {
+        return YEARN_CHD_ERROR_FORMAT;
+    }
+
+    if (!chd->compressed) {
+        uint64_t offset = (uint64_t)be32(&chd->map[hunk * 4]) * header->hunk_bytes;
+        if (offset == 0) {
+            memset(dest, 0, header->hunk_bytes);
+            return YEARN_CHD_OK;
+        }
+        return read_at(chd->fd, offset, dest, header->hunk_bytes) == 0 ? YEARN_CHD_OK : YEARN_CHD_ERROR_FILE;
+    }
+
+    const uint8_t *entry = &chd->map[hunk * 12];
+    uint32_t length = be24(&entry[1]);
+    uint64_t offset = be48(&entry[4]);
+    uint16_t crc = be16(&entry[10]);
+
+    switch (entry[0]) {
+    case COMPRESSION_TYPE_0:
+    case COMPRESSION_TYPE_1:
+    case COMPRESSION_TYPE_2:
+    case COMPRESSION_TYPE_3: {
+        uint32_t codec = header->compressors[entry[0]];
+        if (!codec_supported(codec)) {
+            return YEARN_CHD_ERROR_UNSUPPORTED;
+        }
+        uint8_t *compressed = malloc(length ? length : 1);
+        if (!compressed) {
+            return YEARN_CHD_ERROR_MEMORY;
+        }
+        if (read_at(chd->fd, offset, compressed, length) != 0) {
+            free(compressed);
+            return YEARN_CHD_ERROR_FILE;
+        }
+        int result = codec == CHD_CODEC_CD_ZLIB
+            ? decode_cd_zlib(compressed, length, dest, header->hunk_bytes)
+            : inflate_raw(compressed, length, dest, header->hunk_bytes);
+        free(compressed);
+        if (result != 0 || crc16(dest, header->hunk_bytes) != crc) {
+            return YEARN_CHD_ERROR_DECOMPRESS;
+        }
+        return YEARN_CHD_OK;
+    }
+
+    case COMPRESSION_NONE:
+        if (read_at(chd->fd, offset, dest, header->hunk_bytes) != 0) {
+            return YEARN_CHD_ERROR_FILE;
+        }
+        return crc16(dest, header->hunk_bytes) == crc ? YEARN_CHD_OK : YEARN_CHD_ERROR_DECOMPRESS;
+
+    case COMPRESSION_SELF:
+        // Duplicate of an earlier hunk
+        if (depth > 8 || offset >= hunk) {
+            return YEARN_CHD_ERROR_FORMAT;
+        }
+        return read_hunk(chd, (uint32_t)offset, dest, depth + 1);
+
+    default:
+        return YEARN_CHD_ERROR_UNSUPPORTED;
+    }
+}
+
+yearn_chd_error yearn_chd_read_hunk(yearn_chd *chd, uint32_t hunk, uint8_t *dest) {
+    return read_hunk(chd, hunk, dest, 0);
+}
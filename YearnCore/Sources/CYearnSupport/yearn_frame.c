@@ -0,0 +1,147 @@
+//
+//  yearn_frame.c
+//  YearnCore
+//
+//  Lock-free store of per-frame emulation state
+//
+
+#include "include/yearn_frame.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLE_WORDS (sizeof(yearn_frame_sample) / sizeof(uint64_t))
+// One spare slot: the one being written while its count is not yet published
+#define RECENT_SLOTS (YEARN_FRAME_RECENT + 1)
+
+_Static_assert(sizeof(yearn_frame_sample) % sizeof(uint64_t) == 0, "frame sample is whole words");
+
+struct yearn_frame_state {
+    uint64_t sequence;
+    uint64_t words[SAMPLE_WORDS];
+    // Written from input handlers; kept off the sample's cache line
+    _Alignas(64) uint64_t inputs;
+    // Bits of the double the frame in progress began at, 0 between frames
+    _Alignas(64) uint64_t started;
+    // Times as double bits and what they were spent on; entry n % RECENT_SLOTS is the nth
+    uint64_t recent_count;
+    uint64_t recent[RECENT_SLOTS];
+    uint8_t recent_work[RECENT_SLOTS];
+};
+
+static uint64_t double_bits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double bits_double(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// One writer: the slot is filled before the count that makes it readable moves on
+static void push_recent(yearn_frame_state *state, yearn_frame_work work, double seconds) {
+    uint64_t count = __atomic_load_n(&state->recent_count, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->recent[count % RECENT_SLOTS], double_bits(seconds), __ATOMIC_RELAXED);
+    __atomic_store_n(&state->recent_work[count % RECENT_SLOTS], (uint8_t)work, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->recent_count, count + 1, __ATOMIC_RELEASE);
+}
+
+// MARK: - Public
+
+yearn_frame_state *yearn_frame_state_create(void) {
+    yearn_frame_state *state = NULL;
+    if (posix_memalign((void **)&state, 64, sizeof(*state)) != 0) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    memset(state, 0, sizeof(*state));
+    return state;
+}
+
+void yearn_frame_state_destroy(yearn_frame_state *state) {
+    free(state);
+}
+
+void yearn_frame_state_publish(yearn_frame_state *state, const yearn_frame_sample *sample) {
+    uint64_t words[SAMPLE_WORDS];
+    memcpy(words, sample, sizeof(words));
+
+    uint64_t sequence = __atomic_load_n(&state->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (size_t i = 0; i < SAMPLE_WORDS; i++) {
+        __atomic_store_n(&state->words[i], words[i], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&state->sequence, sequence + 2, __ATOMIC_RELEASE);
+
+    push_recent(state, YEARN_FRAME_WORK_FRAME, sample->frame_time);
+    __atomic_store_n(&state->started, 0, __ATOMIC_RELEASE);
+}
+
+void yearn_frame_state_record(yearn_frame_state *state, yearn_frame_work work, double seconds) {
+    push_recent(state, work, seconds);
+}
+
+void yearn_frame_state_begin(yearn_frame_state *state, double timestamp) {
+    __atomic_store_n(&state->started, double_bits(timestamp), __ATOMIC_RELEASE);
+}
+
+double yearn_frame_state_in_frame_since(const yearn_frame_state *state) {
+    return bits_double(__atomic_load_n(&state->started, __ATOMIC_ACQUIRE));
+}
+
+size_t yearn_frame_state_recent(const yearn_frame_state *state, double *times, yearn_frame_work *work, size_t max) {
+    uint64_t end = __atomic_load_n(&state->recent_count, __ATOMIC_ACQUIRE);
+    uint64_t span = end < YEARN_FRAME_RECENT ? end : YEARN_FRAME_RECENT;
+    if (span > max) span = max;
+
+    uint64_t bits[YEARN_FRAME_RECENT];
+    uint8_t kinds[YEARN_FRAME_RECENT];
+    for (uint64_t i = 0; i < span; i++) {
+        bits[i] = __atomic_load_n(&state->recent[(end - span + i) % RECENT_SLOTS], __ATOMIC_RELAXED);
+        kinds[i] = __atomic_load_n(&state->recent_work[(end - span + i) % RECENT_SLOTS], __ATOMIC_RELAXED);
+    }
+    // Times pushed meanwhile, and the one being written now, may have
+    // overwritten the oldest entries copied
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t after = __atomic_load_n(&state->recent_count, __ATOMIC_RELAXED);
+    uint64_t overwritten = after - end;
+    if (overwritten >= span) return 0;
+
+    size_t count = 0;
+    for (uint64_t i = overwritten; i < span; i++) {
+        if (work) work[count] = (yearn_frame_work)kinds[i];
+        times[count++] = bits_double(bits[i]);
+    }
+    return count;
+}
+
+void yearn_frame_state_read(const yearn_frame_state *state, yearn_frame_sample *sample) {
+    uint64_t words[SAMPLE_WORDS];
+    uint64_t before, after;
+    do {
+        before = __atomic_load_n(&state->sequence, __ATOMIC_ACQUIRE);
+        for (size_t i = 0; i < SAMPLE_WORDS; i++) {
+            words[i] = __atomic_load_n(&state->words[i], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&state->sequence, __ATOMIC_RELAXED);
+    } while ((before & 1) != 0 || before != after);
+
+    memcpy(sample, words, sizeof(words));
+    sample->inputs = __atomic_load_n(&state->inputs, __ATOMIC_RELAXED);
+}
+
+void yearn_frame_state_set_input(yearn_frame_state *state, unsigned button, bool pressed) {
+    if (button >= 64) return;
+    uint64_t bit = (uint64_t)1 << button;
+    if (pressed) {
+        __atomic_fetch_or(&state->inputs, bit, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_and(&state->inputs, ~bit, __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,572 @@
+//
+//  yearn_hash.c
+//  YearnCore
+//
+//  Streaming CRC32 / MD5 / SHA-1 for ROM identification
+//
+
+#include "include/yearn_hash.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__aarch64__)
+#include <arm_acle.h>
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+#elif defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#define SLICE_BYTES (64 * 1024)             // bytes run through every hash at a time
+#define WINDOW_BYTES (16 * 1024 * 1024)     // bytes mapped at a time
+
+// MARK: - CRC32 (slicing-by-8)
+
+static uint32_t crc_table[8][256];
+static pthread_once_t crc_table_once = PTHREAD_ONCE_INIT;
+
+static void crc_table_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c >> 1) ^ (c & 1 ? 0xEDB88320u : 0);
+        }
+        crc_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            uint32_t prev = crc_table[t - 1][i];
+            crc_table[t][i] = (prev >> 8) ^ crc_table[0][prev & 0xFF];
+        }
+    }
+}
+
+// `c` is the running (inverted) register
+static uint32_t crc32_table(uint32_t c, const uint8_t *p, size_t n) {
+    pthread_once(&crc_table_once, crc_table_init);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (n >= 8) {
+        uint32_t one, two;
+        memcpy(&one, p, 4);
+        memcpy(&two, p + 4, 4);
+        one ^= c;
+        c = crc_table[7][one & 0xFF] ^ crc_table[6][(one >> 8) & 0xFF] ^
+            crc_table[5][(one >> 16) & 0xFF] ^ crc_table[4][one >> 24] ^
+            crc_table[3][two & 0xFF] ^ crc_table[2][(two >> 8) & 0xFF] ^
+            crc_table[1][(two >> 16) & 0xFF] ^ crc_table[0][two >> 24];
+        p += 8;
+        n -= 8;
+    }
+#endif
+    while (n--) {
+        c = (c >> 8) ^ crc_table[0][(c ^ *p++) & 0xFF];
+    }
+    return c;
+}
+
+// MARK: - CRC32 (ARMv8)
+
+#if defined(__aarch64__)
+
+#if defined(__clang__)
+#define CRC_TARGET __attribute__((target("crc")))
+#else
+#define CRC_TARGET __attribute__((target("+crc")))
+#endif
+
+CRC_TARGET
+static uint32_t crc32_armv8(uint32_t c, const uint8_t *p, size_t n) {
+    while (n && ((uintptr_t)p & 7)) {
+        c = __crc32b(c, *p++);
+        n--;
+    }
+    while (n >= 32) {
+        uint64_t a, b, d, e;
+        memcpy(&a, p, 8);
+        memcpy(&b, p + 8, 8);
+        memcpy(&d, p + 16, 8);
+        memcpy(&e, p + 24, 8);
+        c = __crc32d(c, a);
+        c = __crc32d(c, b);
+        c = __crc32d(c, d);
+        c = __crc32d(c, e);
+        p += 32;
+        n -= 32;
+    }
+    while (n >= 8) {
+        uint64_t a;
+        memcpy(&a, p, 8);
+        c = __crc32d(c, a);
+        p += 8;
+        n -= 8;
+    }
+    while (n--) {
+        c = __crc32b(c, *p++);
+    }
+    return c;
+}
+
+static int cpu_has_crc(void) {
+#if defined(__ARM_FEATURE_CRC32)
+    return 1;
+#elif defined(__APPLE__)
+    int value = 0;
+    size_t size = sizeof(value);
+    return sysctlbyname("hw.optional.armv8_crc32", &value, &size, NULL, 0) == 0 && value;
+#elif defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+    return 0;
+#endif
+}
+
+#endif
+
+// MARK: - CRC32 (PCLMULQDQ)
+
+#if defined(__x86_64__)
+
+// Folds 64 bytes at a time with carry-less multiplies, then reduces with
+// Barrett reduction ("Fast CRC Computation Using PCLMULQDQ", Intel).
+// Requires n >= 64 and a multiple of 16.
+__attribute__((target("sse4.1,pclmul")))
+static uint32_t crc32_pclmul_fold(uint32_t c, const uint8_t *p, size_t n) {
+    static const uint64_t k1k2[2] __attribute__((aligned(16))) = { 0x0154442bd4, 0x01c6e41596 };
+    static const uint64_t k3k4[2] __attribute__((aligned(16))) = { 0x01751997d0, 0x00ccaa009e };
+    static const uint64_t k5k0[2] __attribute__((aligned(16))) = { 0x0163cd6124, 0x0000000000 };
+    static const uint64_t poly[2] __attribute__((aligned(16))) = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)c));
+    x0 = _mm_load_si128((const __m128i *)k1k2);
+    p += 64;
+    n -= 64;
+
+    while (n >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+        y6 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+        y7 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+        y8 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        p += 64;
+        n -= 64;
+    }
+
+    // Fold the four lanes into one
+    x0 = _mm_load_si128((const __m128i *)k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    while (n >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *)p);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        p += 16;
+        n -= 16;
+    }
+
+    // 128 -> 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128((const __m128i *)poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static uint32_t crc32_pclmul(uint32_t c, const uint8_t *p, size_t n) {
+    if (n >= 64) {
+        size_t bulk = n & ~(size_t)15;
+        c = crc32_pclmul_fold(c, p, bulk);
+        p += bulk;
+        n -= bulk;
+    }
+    return crc32_table(c, p, n);
+}
+
+static int cpu_has_pclmul(void) {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    return (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1);
+}
+
+#endif
+
+// MARK: - CRC32 Dispatch
+
+static yearn_crc32_impl best_impl = YEARN_CRC32_TABLE;
+static pthread_once_t best_impl_once = PTHREAD_ONCE_INIT;
+
+static void detect_impl(void) {
+#if defined(__aarch64__)
+    if (cpu_has_crc()) {
+        best_impl = YEARN_CRC32_ARMV8;
+    }
+#elif defined(__x86_64__)
+    if (cpu_has_pclmul()) {
+        best_impl = YEARN_CRC32_PCLMUL;
+    }
+#endif
+}
+
+yearn_crc32_impl yearn_crc32_best_impl(void) {
+    pthread_once(&best_impl_once, detect_impl);
+    return best_impl;
+}
+
+uint32_t yearn_crc32_with(yearn_crc32_impl impl, uint32_t crc, const void *data, size_t length) {
+    const uint8_t *p = data;
+    uint32_t c = ~crc;
+
+    if (impl != YEARN_CRC32_TABLE && impl != yearn_crc32_best_impl()) {
+        impl = YEARN_CRC32_TABLE;
+    }
+
+    switch (impl) {
+#if defined(__aarch64__)
+    case YEARN_CRC32_ARMV8:
+        c = crc32_armv8(c, p, length);
+        break;
+#elif defined(__x86_64__)
+    case YEARN_CRC32_PCLMUL:
+        c = crc32_pclmul(c, p, length);
+        break;
+#endif
+    default:
+        c = crc32_table(c, p, length);
+        break;
+    }
+    return ~c;
+}
+
+uint32_t yearn_crc32(uint32_t crc, const void *data, size_t length) {
+    return yearn_crc32_with(yearn_crc32_best_impl(), crc, data, length);
+}
+
+// MARK: - MD5 (RFC 1321)
+
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static const uint32_t md5_k[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const uint8_t md5_r[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static void md5_blocks(uint32_t state[4], const uint8_t *p, size_t blocks) {
+    while (blocks--) {
+        uint32_t m[16];
+        for (int i = 0; i < 16; i++) {
+            m[i] = (uint32_t)p[i * 4] | (uint32_t)p[i * 4 + 1] << 8 |
+                   (uint32_t)p[i * 4 + 2] << 16 | (uint32_t)p[i * 4 + 3] << 24;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        for (int i = 0; i < 64; i++) {
+            uint32_t f;
+            int g;
+            if (i < 16) {
+                f = (b & c) | (~b & d);
+                g = i;
+            } else if (i < 32) {
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) & 15;
+            } else if (i < 48) {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) & 15;
+            } else {
+                f = c ^ (b | ~d);
+                g = (7 * i) & 15;
+            }
+            uint32_t t = d;
+            d = c;
+            c = b;
+            b = b + ROTL(a + f + md5_k[i] + m[g], md5_r[i]);
+            a = t;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        p += 64;
+    }
+}
+
+// MARK: - SHA-1 (FIPS 180-4)
+
+static void sha1_blocks(uint32_t state[5], const uint8_t *p, size_t blocks) {
+    while (blocks--) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t)p[i * 4] << 24 | (uint32_t)p[i * 4 + 1] << 16 |
+                   (uint32_t)p[i * 4 + 2] << 8 | (uint32_t)p[i * 4 + 3];
+        }
+        for (int i = 16; i < 80; i++) {
+            w[i] = ROTL(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t t = ROTL(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = ROTL(b, 30);
+            b = a;
+            a = t;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        p += 64;
+    }
+}
+
+// MARK: - Hasher
+
+static void hasher_blocks(yearn_hasher *hasher, const uint8_t *p, size_t blocks) {
+    if (hasher->flags & YEARN_HASH_MD5) {
+        md5_blocks(hasher->md5_state, p, blocks);
+    }
+    if (hasher->flags & YEARN_HASH_SHA1) {
+        sha1_blocks(hasher->sha1_state, p, blocks);
+    }
+}
+
+void yearn_hasher_init(yearn_hasher *hasher, unsigned flags) {
+    memset(hasher, 0, sizeof(*hasher));
+    hasher->flags = flags;
+
+    hasher->md5_state[0] = 0x67452301;
+    hasher->md5_state[1] = 0xefcdab89;
+    hasher->md5_state[2] = 0x98badcfe;
+    hasher->md5_state[3] = 0x10325476;
+
+    hasher->sha1_state[0] = 0x67452301;
+    hasher->sha1_state[1] = 0xEFCDAB89;
+    hasher->sha1_state[2] = 0x98BADCFE;
+    hasher->sha1_state[3] = 0x10325476;
+    hasher->sha1_state[4] = 0xC3D2E1F0;
+}
+
+static void hasher_update_slice(yearn_hasher *hasher, const uint8_t *p, size_t n) {
+    if (hasher->flags & YEARN_HASH_CRC32) {
+        hasher->crc = yearn_crc32(hasher->crc, p, n);
+    }
+    hasher->length += n;
+
+    if (!(hasher->flags & (YEARN_HASH_MD5 | YEARN_HASH_SHA1))) {
+        return;
+    }
+
+    if (hasher->block_used) {
+        size_t take = 64 - hasher->block_used;
+        if (take > n) {
+            take = n;
+        }
+        memcpy(hasher->block + hasher->block_used, p, take);
+        hasher->block_used += take;
+        p += take;
+        n -= take;
+        if (hasher->block_used < 64) {
+            return;
+        }
+        hasher_blocks(hasher, hasher->block, 1);
+        hasher->block_used = 0;
+    }
+
+    size_t blocks = n / 64;
+    hasher_blocks(hasher, p, blocks);
+    p += blocks * 64;
+    n -= blocks * 64;
+
+    if (n) {
+        memcpy(hasher->block, p, n);
+        hasher->block_used = n;
+    }
+}
+
+void yearn_hasher_update(yearn_hasher *hasher, const void *data, size_t length) {
+    // Feed every hash one slice at a time so the data is read from memory once
+    const uint8_t *p = data;
+    while (length) {
+        size_t n = length < SLICE_BYTES ? length : SLICE_BYTES;
+        hasher_update_slice(hasher, p, n);
+        p += n;
+        length -= n;
+    }
+}
+
+void yearn_hasher_final(yearn_hasher *hasher, yearn_hash_result *result) {
+    memset(result, 0, sizeof(*result));
+    result->length = hasher->length;
+
+    if (hasher->flags & YEARN_HASH_CRC32) {
+        result->crc32 = hasher->crc;
+    }
+    if (!(hasher->flags & (YEARN_HASH_MD5 | YEARN_HASH_SHA1))) {
+        return;
+    }
+
+    // Pad: 0x80, zeros, then the bit length (MD5 little-endian, SHA-1 big-endian)
+    uint64_t bits = hasher->length * 8;
+    uint8_t tail[128] = { 0 };
+    size_t used = hasher->block_used;
+    memcpy(tail, hasher->block, used);
+    tail[used] = 0x80;
+    size_t total = used + 9 <= 64 ? 64 : 128;
+
+    if (hasher->flags & YEARN_HASH_MD5) {
+        for (int i = 0; i < 8; i++) {
+            tail[total - 8 + i] = (uint8_t)(bits >> (8 * i));
+        }
+        md5_blocks(hasher->md5_state, tail, total / 64);
+        for (int i = 0; i < 16; i++) {
+            result->md5[i] = (uint8_t)(hasher->md5_state[i / 4] >> (8 * (i % 4)));
+        }
+    }
+    if (hasher->flags & YEARN_HASH_SHA1) {
+        for (int i = 0; i < 8; i++) {
+            tail[total - 1 - i] = (uint8_t)(bits >> (8 * i));
+        }
+        sha1_blocks(hasher->sha1_state, tail, total / 64);
+        for (int i = 0; i < 20; i++) {
+            result->sha1[i] = (uint8_t)(hasher->sha1_state[i / 4] >> (24 - 8 * (i % 4)));
+        }
+    }
+}
+
+// MARK: - Files
+
+int yearn_hash_file(const char *path, uint64_t skip, unsigned flags, yearn_hash_result *result) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+
+    yearn_hasher hasher;
+    yearn_hasher_init(&hasher, flags);
+
+    uint64_t size = (uint64_t)info.st_size;
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t position = skip;
+
+    while (position < size) {
+        // Windows start on a page boundary; `lead` bytes before `position` are skipped
+        uint64_t start = position / page * page;
+        uint64_t lead = position - start;
+        uint64_t span = size - start;
+        if (span > WINDOW_BYTES) {
+            span = WINDOW_BYTES;
+        }
+
+        void *window = mmap(NULL, (size_t)span, PROT_READ, MAP_PRIVATE, fd, (off_t)start);
+        if (window == MAP_FAILED) {
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            return -1;
+        }
+        madvise(window, (size_t)span, MADV_SEQUENTIAL);
+        madvise(window, (size_t)span, MADV_WILLNEED);
+
+        yearn_hasher_update(&hasher, (const uint8_t *)window + lead, (size_t)(span - lead));
+        munmap(window, (size_t)span);
+        position = start + span;
+    }
+
+    close(fd);
+    yearn_hasher_final(&hasher, result);
+    return 0;
+}
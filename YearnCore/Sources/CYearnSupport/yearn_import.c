@@ -0,0 +1,212 @@
+//
+//  yearn_import.c
+//  YearnCore
+//
+//  Copy a ROM into the library while hashing and sniffing it
+//
+
+#include "include/yearn_import.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <sys/clonefile.h>
+#elif defined(__linux__)
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
+#define COPY_CHUNK (1024 * 1024)
+
+static atomic_int clone_enabled = 1;
+
+void yearn_import_set_clone_enabled(int enabled) {
+    atomic_store(&clone_enabled, enabled ? 1 : 0);
+}
+
+// Copier headers DATs leave out; matches DATIndex.headerSkip(forFileAt:)
+static uint64_t header_skip(const uint8_t *p, size_t n) {
+    if (n < 4) return 0;
+    if (memcmp(p, "NES\x1A", 4) == 0 || memcmp(p, "FDS\x1A", 4) == 0) return 16;
+    if (memcmp(p, "LYNX", 4) == 0) return 64;
+    return 0;
+}
+
+static int write_all(int fd, const uint8_t *p, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        p += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+// Clone `src_fd` into the (empty) temporary file; 0 on success
+static int try_clone(int src_fd, const char *src, const char *tmp, int *tmp_fd) {
+    if (!atomic_load(&clone_enabled)) return -1;
+#if defined(__APPLE__)
+    (void)src_fd;
+    // clonefile creates the destination itself
+    close(*tmp_fd);
+    unlink(tmp);
+    if (clonefile(src, tmp, 0) == 0) {
+        *tmp_fd = open(tmp, O_RDONLY);
+        return *tmp_fd >= 0 ? 0 : -1;
+    }
+    *tmp_fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    return -1;
+#elif defined(__linux__) && defined(FICLONE)
+    (void)src;
+    (void)tmp;
+    return ioctl(*tmp_fd, FICLONE, src_fd);
+#else
+    (void)src_fd;
+    (void)src;
+    (void)tmp;
+    (void)tmp_fd;
+    return -1;
+#endif
+}
+
+int yearn_import_file(const char *src, const char *dst, unsigned hash_flags,
+                      yearn_import_progress_fn progress, void *context,
+                      yearn_import_result *result) {
+    memset(result, 0, sizeof(*result));
+
+    int src_fd = open(src, O_RDONLY);
+    if (src_fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(src_fd, &st) != 0) {
+        int saved = errno;
+        close(src_fd);
+        errno = saved;
+        return -1;
+    }
+    uint64_t size = (uint64_t)st.st_size;
+    result->size = size;
+
+    size_t tmp_length = strlen(dst) + 16;
+    char *tmp = malloc(tmp_length);
+    uint8_t *buffer = malloc(COPY_CHUNK > YEARN_SNIFF_BLOCK_SIZE ? COPY_CHUNK : YEARN_SNIFF_BLOCK_SIZE);
+    if (!tmp || !buffer) {
+        free(tmp);
+        free(buffer);
+        close(src_fd);
+        errno = ENOMEM;
+        return -1;
+    }
+    snprintf(tmp, tmp_length, "%s.importing", dst);
+
+    int tmp_fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (tmp_fd < 0) {
+        int saved = errno;
+        free(tmp);
+        free(buffer);
+        close(src_fd);
+        errno = saved;
+        return -1;
+    }
+
+    result->cloned = try_clone(src_fd, src, tmp, &tmp_fd) == 0;
+    if (tmp_fd < 0) goto fail;
+
+#if defined(__APPLE__)
+    fcntl(src_fd, F_RDAHEAD, 1);
+#elif defined(__linux__)
+    posix_fadvise(src_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    // One pass: read a chunk, write it unless cloned, feed the hashers.
+    // The first chunk is at least the sniff block, so the header decides
+    // the copier skip before anything is hashed.
+    yearn_hasher hasher;
+    yearn_hasher_init(&hasher, hash_flags);
+    uint32_t whole = 0;
+    uint64_t done = 0;
+    int first = 1;
+
+    while (done < size) {
+        size_t wanted = COPY_CHUNK;
+        if (size - done < wanted) wanted = (size_t)(size - done);
+
+        size_t got = 0;
+        while (got < wanted) {
+            ssize_t n = read(src_fd, buffer + got, wanted - got);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) goto fail;
+            if (n == 0) break;
+            got += (size_t)n;
+        }
+        if (got == 0) break;
+
+        if (!result->cloned && write_all(tmp_fd, buffer, got) != 0) goto fail;
+
+        size_t skip = 0;
+        if (first) {
+            result->sniff_count = yearn_sniff_buffer(buffer, got < YEARN_SNIFF_BLOCK_SIZE ? got : YEARN_SNIFF_BLOCK_SIZE,
+                                                     size, result->sniff, YEARN_SNIFF_MAX_RESULTS);
+            result->header_skip = header_skip(buffer, got);
+            skip = (size_t)result->header_skip;
+            if (skip > got) skip = got;
+            if (skip > 0 && (hash_flags & YEARN_HASH_CRC32)) {
+                whole = yearn_crc32(0, buffer, skip);
+            }
+            first = 0;
+        }
+        if (hash_flags) {
+            yearn_hasher_update(&hasher, buffer + skip, got - skip);
+        }
+        if (result->header_skip > 0 && (hash_flags & YEARN_HASH_CRC32)) {
+            whole = yearn_crc32(whole, buffer + skip, got - skip);
+        }
+
+        done += got;
+        // A clone needs no further reads unless something is being hashed
+        if (result->cloned && !hash_flags) done = size;
+        if (progress && progress(context, done, size) != 0) {
+            errno = ECANCELED;
+            goto fail;
+        }
+    }
+
+    if (done != size) {
+        errno = EIO;
+        goto fail;
+    }
+
+    yearn_hasher_final(&hasher, &result->hash);
+    result->crc32_whole = result->header_skip > 0 ? whole : result->hash.crc32;
+
+    if (close(tmp_fd) != 0) {
+        tmp_fd = -1;
+        goto fail;
+    }
+    tmp_fd = -1;
+    if (rename(tmp, dst) != 0) goto fail;
+
+    close(src_fd);
+    free(tmp);
+    free(buffer);
+    return 0;
+
+fail: {
+        int saved = errno;
+        if (tmp_fd >= 0) close(tmp_fd);
+        unlink(tmp);
+        close(src_fd);
+        free(tmp);
+        free(buffer);
+        errno = saved;
+        return -1;
+    }
+}
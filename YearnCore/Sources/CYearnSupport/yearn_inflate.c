@@ -0,0 +1,80 @@
+//
+//  yearn_inflate.c
+//  YearnCore
+//
+//  Streaming raw DEFLATE decoder used to extract ROMs from ZIP archives
+//
+
+#include "include/yearn_inflate.h"
+
+#include <stdlib.h>
+#include <limits.h>
+#include <zlib.h>
+
+struct yearn_inflate {
+    z_stream zs;
+};
+
+yearn_inflate *yearn_inflate_create(void) {
+    yearn_inflate *stream = calloc(1, sizeof(yearn_inflate));
+    if (!stream) {
+        return NULL;
+    }
+
+    // Negative window bits: raw DEFLATE without zlib/gzip header
+    if (inflateInit2(&stream->zs, -MAX_WBITS) != Z_OK) {
+        free(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+yearn_inflate_result yearn_inflate_run(yearn_inflate *stream,
+                                       const uint8_t *input, size_t input_length, size_t *consumed,
+                                       uint8_t *output, size_t output_capacity, size_t *produced) {
+    // zlib counts in uInt; callers use chunk sizes far below that
+    uInt in_len = input_length > UINT_MAX ? UINT_MAX : (uInt)input_length;
+    uInt out_cap = output_capacity > UINT_MAX ? UINT_MAX : (uInt)output_capacity;
+
+    stream->zs.next_in = (Bytef *)input;
+    stream->zs.avail_in = in_len;
+    stream->zs.next_out = output;
+    stream->zs.avail_out = out_cap;
+
+    int status = inflate(&stream->zs, Z_NO_FLUSH);
+
+    *consumed = in_len - stream->zs.avail_in;
+    *produced = out_cap - stream->zs.avail_out;
+
+    switch (status) {
+    case Z_STREAM_END:
+        return YEARN_INFLATE_STREAM_END;
+    case Z_OK:
+        return YEARN_INFLATE_OK;
+    case Z_BUF_ERROR:
+        // No progress possible with the buffers given; not fatal
+        return YEARN_INFLATE_OK;
+    default:
+        return YEARN_INFLATE_ERROR;
+    }
+}
+
+void yearn_inflate_destroy(yearn_inflate *stream) {
+    if (!stream) {
+        return;
+    }
+    inflateEnd(&stream->zs);
+    free(stream);
+}
+
+uint32_t yearn_inflate_crc32(uint32_t crc, const uint8_t *data, size_t length) {
+    uLong value = crc;
+    while (length > 0) {
+        uInt chunk = length > UINT_MAX ? UINT_MAX : (uInt)length;
+        value = crc32(value, data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+    return (uint32_t)value;
+}
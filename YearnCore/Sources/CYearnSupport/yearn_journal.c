@@ -0,0 +1,205 @@
+//
+//  yearn_journal.c
+//  YearnCore
+//
+//  Append-only journal of fixed-size play records
+//
+
+#include "include/yearn_journal.h"
+#include "include/yearn_hash.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define JOURNAL_MAGIC "YJOURN01"
+#define HEADER_SIZE 16u
+#define RECORD_SIZE 40u
+#define ENTRY_SIZE (RECORD_SIZE + 4u)
+
+_Static_assert(sizeof(yearn_journal_record) == RECORD_SIZE, "journal record layout");
+
+struct yearn_journal {
+    int fd;
+    uint64_t generation;
+    size_t count;
+};
+
+// MARK: - I/O
+
+static int write_all(int fd, const void *data, size_t length, off_t offset) {
+    const uint8_t *p = data;
+    while (length > 0) {
+        ssize_t written = pwrite(fd, p, length, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += written;
+        offset += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+static int read_all(int fd, void *data, size_t length, off_t offset) {
+    uint8_t *p = data;
+    while (length > 0) {
+        ssize_t got = pread(fd, p, length, offset);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (got == 0) {
+            errno = EIO;
+            return -1;
+        }
+        p += got;
+        offset += got;
+        length -= (size_t)got;
+    }
+    return 0;
+}
+
+static int full_sync(int fd) {
+#if defined(__APPLE__)
+    // fsync() on Darwin does not flush the drive's cache
+    if (fcntl(fd, F_FULLFSYNC) == 0) return 0;
+#endif
+    return fsync(fd);
+}
+
+static int write_header(yearn_journal *journal) {
+    uint8_t header[HEADER_SIZE];
+    memcpy(header, JOURNAL_MAGIC, 8);
+    memcpy(header + 8, &journal->generation, 8);
+    return write_all(journal->fd, header, sizeof(header), 0);
+}
+
+// MARK: - Public
+
+yearn_journal *yearn_journal_open(const char *path) {
+    yearn_journal *journal = calloc(1, sizeof(*journal));
+    if (!journal) return NULL;
+
+    journal->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (journal->fd < 0) {
+        free(journal);
+        return NULL;
+    }
+
+    uint8_t header[HEADER_SIZE];
+    struct stat info;
+    if (fstat(journal->fd, &info) != 0) goto fail;
+
+    if (info.st_size >= (off_t)HEADER_SIZE
+        && read_all(journal->fd, header, sizeof(header), 0) == 0
+        && memcmp(header, JOURNAL_MAGIC, 8) == 0) {
+        memcpy(&journal->generation, header + 8, 8);
+        journal->count = (size_t)(info.st_size - HEADER_SIZE) / ENTRY_SIZE;
+
+        // Cut off an entry the last append did not finish
+        off_t end = (off_t)(HEADER_SIZE + journal->count * ENTRY_SIZE);
+        if (end != info.st_size && ftruncate(journal->fd, end) != 0) goto fail;
+    } else {
+        if (yearn_journal_reset(journal, 0) != 0) goto fail;
+    }
+    return journal;
+
+fail:
+    {
+        int error = errno;
+        yearn_journal_close(journal);
+        errno = error;
+    }
+    return NULL;
+}
+
+void yearn_journal_close(yearn_journal *journal) {
+    if (!journal) return;
+    if (journal->fd >= 0) close(journal->fd);
+    free(journal);
+}
+
+uint64_t yearn_journal_generation(const yearn_journal *journal) {
+    return journal->generation;
+}
+
+size_t yearn_journal_count(const yearn_journal *journal) {
+    return journal->count;
+}
+
+int yearn_journal_append(yearn_journal *journal, const yearn_journal_record *records, size_t count) {
+    if (count == 0) return 0;
+
+    uint8_t stack[64 * ENTRY_SIZE];
+    uint8_t *buffer = count <= 64 ? stack : malloc(count * ENTRY_SIZE);
+    if (!buffer) {
+        errno = ENOMEM;
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *entry = buffer + i * ENTRY_SIZE;
+        uint32_t crc = yearn_crc32(0, &records[i], RECORD_SIZE);
+        memcpy(entry, &records[i], RECORD_SIZE);
+        memcpy(entry + RECORD_SIZE, &crc, 4);
+    }
+
+    off_t end = (off_t)(HEADER_SIZE + journal->count * ENTRY_SIZE);
+    int result = write_all(journal->fd, buffer, count * ENTRY_SIZE, end);
+    if (buffer != stack) free(buffer);
+    if (result != 0) {
+        // Leave no partial entries behind for the next append to misalign
+        int error = errno;
+        ftruncate(journal->fd, end);
+        errno = error;
+        return -1;
+    }
+    journal->count += count;
+    return 0;
+}
+
+int yearn_journal_sync(yearn_journal *journal) {
+    return full_sync(journal->fd);
+}
+
+long yearn_journal_read(yearn_journal *journal, size_t first, yearn_journal_record *records, size_t count) {
+    if (first >= journal->count) return 0;
+    if (count > journal->count - first) count = journal->count - first;
+
+    uint8_t *buffer = malloc(count * ENTRY_SIZE + 1);
+    if (!buffer) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (read_all(journal->fd, buffer, count * ENTRY_SIZE, (off_t)(HEADER_SIZE + first * ENTRY_SIZE)) != 0) {
+        int error = errno;
+        free(buffer);
+        errno = error;
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *entry = buffer + i * ENTRY_SIZE;
+        uint32_t crc;
+        memcpy(&crc, entry + RECORD_SIZE, 4);
+        if (yearn_crc32(0, entry, RECORD_SIZE) == crc) {
+            memcpy(&records[i], entry, RECORD_SIZE);
+        } else {
+            memset(&records[i], 0, RECORD_SIZE);
+            records[i].kind = YEARN_JOURNAL_INVALID;
+        }
+    }
+    free(buffer);
+    return (long)count;
+}
+
+int yearn_journal_reset(yearn_journal *journal, uint64_t generation) {
+    journal->generation = generation;
+    journal->count = 0;
+    if (ftruncate(journal->fd, 0) != 0 || write_header(journal) != 0) return -1;
+    return full_sync(journal->fd);
+}
@@ -0,0 +1,164 @@
+//
+//  yearn_log.c
+//  YearnCore
+//
+//  Fixed-size ring of recent log messages, writable from any thread
+//
+
+#include "include/yearn_log.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ENTRY_WORDS (sizeof(yearn_log_entry) / sizeof(uint64_t))
+
+_Static_assert(sizeof(yearn_log_entry) % sizeof(uint64_t) == 0, "log entry is whole words");
+
+typedef struct {
+    // 2 * ticket + 1 while being written, 2 * ticket + 2 once written, 0 if never
+    uint64_t state;
+    uint64_t words[ENTRY_WORDS];
+} log_slot;
+
+struct yearn_log_ring {
+    _Alignas(64) uint64_t next_ticket;
+    _Alignas(64) uint64_t dropped;
+    uint32_t mask;
+    log_slot slots[];
+};
+
+static yearn_log_ring *core_ring;
+
+// MARK: - Public
+
+double yearn_log_now(void) {
+    struct timespec now;
+#if defined(__APPLE__)
+    clock_gettime(CLOCK_UPTIME_RAW, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+yearn_log_ring *yearn_log_ring_create(uint32_t capacity) {
+    if (capacity == 0 || capacity > (1u << 20)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    uint32_t size = 1;
+    while (size < capacity) size <<= 1;
+
+    yearn_log_ring *ring = NULL;
+    if (posix_memalign((void **)&ring, 64, sizeof(*ring) + (size_t)size * sizeof(log_slot)) != 0) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    memset(ring, 0, sizeof(*ring) + (size_t)size * sizeof(log_slot));
+    ring->mask = size - 1;
+    return ring;
+}
+
+void yearn_log_ring_destroy(yearn_log_ring *ring) {
+    free(ring);
+}
+
+void yearn_log_ring_write(yearn_log_ring *ring, double timestamp, uint32_t level,
+                          const char *category, const char *message) {
+    yearn_log_entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.timestamp = timestamp;
+    entry.level = level;
+    if (category) strncpy(entry.category, category, sizeof(entry.category) - 1);
+    if (message) strncpy(entry.message, message, sizeof(entry.message) - 1);
+
+    uint64_t ticket = __atomic_fetch_add(&ring->next_ticket, 1, __ATOMIC_RELAXED);
+    entry.ticket = ticket;
+    log_slot *slot = &ring->slots[ticket & ring->mask];
+
+    // Claim the slot only from a finished (or empty) state, so two writers never interleave
+    uint64_t state = __atomic_load_n(&slot->state, __ATOMIC_RELAXED);
+    if ((state & 1) != 0 || state > 2 * ticket
+        || !__atomic_compare_exchange_n(&slot->state, &state, 2 * ticket + 1, false,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    uint64_t words[ENTRY_WORDS];
+    memcpy(words, &entry, sizeof(words));
+    for (size_t i = 0; i < ENTRY_WORDS; i++) {
+        __atomic_store_n(&slot->words[i], words[i], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&slot->state, 2 * ticket + 2, __ATOMIC_RELEASE);
+}
+
+size_t yearn_log_ring_snapshot(const yearn_log_ring *ring, yearn_log_entry *entries, size_t max) {
+    uint64_t end = __atomic_load_n(&ring->next_ticket, __ATOMIC_ACQUIRE);
+    uint64_t capacity = (uint64_t)ring->mask + 1;
+    uint64_t span = end < capacity ? end : capacity;
+    if (span > max) span = max;
+
+    size_t count = 0;
+    uint64_t words[ENTRY_WORDS];
+    for (uint64_t ticket = end - span; ticket < end; ticket++) {
+        const log_slot *slot = &ring->slots[ticket & ring->mask];
+        uint64_t before = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+        if (before != 2 * ticket + 2) continue;
+        for (size_t i = 0; i < ENTRY_WORDS; i++) {
+            words[i] = __atomic_load_n(&slot->words[i], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint64_t after = __atomic_load_n(&slot->state, __ATOMIC_RELAXED);
+        if (after != before) continue;
+
+        memcpy(&entries[count], words, sizeof(words));
+        entries[count].category[YEARN_LOG_CATEGORY_SIZE - 1] = '\0';
+        entries[count].message[YEARN_LOG_MESSAGE_SIZE - 1] = '\0';
+        count++;
+    }
+    return count;
+}
+
+uint64_t yearn_log_ring_dropped(const yearn_log_ring *ring) {
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
+
+// MARK: - Core Logging
+
+void yearn_log_set_core_ring(yearn_log_ring *ring) {
+    __atomic_store_n(&core_ring, ring, __ATOMIC_RELEASE);
+}
+
+void yearn_log_core_printf(enum retro_log_level level, const char *format, ...) {
+    yearn_log_ring *ring = __atomic_load_n(&core_ring, __ATOMIC_ACQUIRE);
+    if (!ring || !format) return;
+
+    char message[YEARN_LOG_MESSAGE_SIZE];
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(message, sizeof(message), format, arguments);
+    va_end(arguments);
+
+    // Cores end most messages with a newline
+    size_t length = strlen(message);
+    while (length > 0 && (message[length - 1] == '\n' || message[length - 1] == '\r')) {
+        message[--length] = '\0';
+    }
+    yearn_log_ring_write(ring, yearn_log_now(), (uint32_t)level, "core", message);
+}
+
+int yearn_log_provide_interface(struct retro_log_callback *callback) {
+    if (!callback) {
+        errno = EINVAL;
+        return -1;
+    }
+    callback->log = yearn_log_core_printf;
+    return 0;
+}
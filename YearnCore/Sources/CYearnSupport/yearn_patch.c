@@ -0,0 +1,287 @@
+//
+//  yearn_patch.c
+//  YearnCore
+//
+//  IPS / UPS / BPS soft-patching
+//
+
+#include "include/yearn_patch.h"
+#include "include/yearn_hash.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FOOTER_SIZE 12      // UPS / BPS: source, target and patch CRC32
+
+// MARK: - Helpers
+
+static uint32_t load32le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// beat variable-length integer, as used by UPS and BPS; 0 past the end
+static int read_varint(const uint8_t *p, size_t end, size_t *pos, uint64_t *value) {
+    uint64_t data = 0;
+    uint64_t shift = 1;
+    for (int i = 0; i < 10; i++) {
+        if (*pos >= end) return 0;
+        uint8_t x = p[(*pos)++];
+        data += (uint64_t)(x & 0x7F) * shift;
+        if (x & 0x80) {
+            *value = data;
+            return 1;
+        }
+        shift <<= 7;
+        data += shift;
+    }
+    return 0;
+}
+
+static yearn_patch_format detect(const uint8_t *patch, size_t size) {
+    if (size >= 8 && memcmp(patch, "PATCH", 5) == 0) return YEARN_PATCH_IPS;
+    if (size >= 4 + FOOTER_SIZE && memcmp(patch, "UPS1", 4) == 0) return YEARN_PATCH_UPS;
+    if (size >= 4 + FOOTER_SIZE && memcmp(patch, "BPS1", 4) == 0) return YEARN_PATCH_BPS;
+    return YEARN_PATCH_UNKNOWN;
+}
+
+// MARK: - IPS
+
+// Walks the records; `target` may be NULL to only measure
+static yearn_patch_status ips_walk(const uint8_t *patch, size_t size, uint8_t *target, size_t target_size,
+                                   uint64_t *end_out, int64_t *truncate_out) {
+    size_t p = 5;
+    uint64_t end = 0;
+    for (;;) {
+        if (p + 3 > size) return YEARN_PATCH_ERROR_FORMAT;
+        if (memcmp(patch + p, "EOF", 3) == 0) {
+            p += 3;
+            break;
+        }
+        if (p + 5 > size) return YEARN_PATCH_ERROR_FORMAT;
+        uint32_t offset = ((uint32_t)patch[p] << 16) | ((uint32_t)patch[p + 1] << 8) | patch[p + 2];
+        uint32_t length = ((uint32_t)patch[p + 3] << 8) | patch[p + 4];
+        p += 5;
+
+        if (length > 0) {
+            if (p + length > size) return YEARN_PATCH_ERROR_FORMAT;
+            if (target && offset + length <= target_size) {
+                memcpy(target + offset, patch + p, length);
+            }
+            p += length;
+        } else {
+            // RLE record: 16-bit run length, then the byte
+            if (p + 3 > size) return YEARN_PATCH_ERROR_FORMAT;
+            length = ((uint32_t)patch[p] << 8) | patch[p + 1];
+            if (target && offset + length <= target_size) {
+                memset(target + offset, patch[p + 2], length);
+            }
+            p += 3;
+        }
+        if (offset + length > end) end = offset + length;
+    }
+
+    // Lunar IPS extension: a 24-bit size to truncate the output to
+    *truncate_out = -1;
+    if (p + 3 <= size) {
+        *truncate_out = ((int64_t)patch[p] << 16) | ((int64_t)patch[p + 1] << 8) | patch[p + 2];
+    }
+    *end_out = end;
+    return YEARN_PATCH_OK;
+}
+
+// MARK: - UPS
+
+static yearn_patch_status ups_apply(const uint8_t *source, size_t source_size,
+                                    const uint8_t *patch, size_t size, size_t start,
+                                    uint8_t *target, size_t target_size) {
+    size_t end = size - FOOTER_SIZE;
+    size_t p = start;
+    uint64_t out = 0;
+
+    while (p < end) {
+        uint64_t skip;
+        if (!read_varint(patch, end, &p, &skip)) return YEARN_PATCH_ERROR_FORMAT;
+        out += skip;
+
+        // XOR bytes up to a terminating zero, which stands for one unchanged byte
+        for (;;) {
+            if (p >= end) return YEARN_PATCH_ERROR_FORMAT;
+            uint8_t x = patch[p++];
+            if (x == 0) break;
+            if (out < target_size) {
+                target[out] = (uint8_t)((out < source_size ? source[out] : 0) ^ x);
+            }
+            out++;
+        }
+        out++;
+    }
+    return YEARN_PATCH_OK;
+}
+
+// MARK: - BPS
+
+enum { BPS_SOURCE_READ, BPS_TARGET_READ, BPS_SOURCE_COPY, BPS_TARGET_COPY };
+
+static yearn_patch_status bps_apply(const uint8_t *source, size_t source_size,
+                                    const uint8_t *patch, size_t size, size_t start,
+                                    uint8_t *target, size_t target_size) {
+    size_t end = size - FOOTER_SIZE;
+    size_t p = start;
+    uint64_t out = 0;
+    int64_t source_relative = 0;
+    int64_t target_relative = 0;
+
+    while (p < end) {
+        uint64_t data;
+        if (!read_varint(patch, end, &p, &data)) return YEARN_PATCH_ERROR_FORMAT;
+        uint64_t length = (data >> 2) + 1;
+        if (length > target_size - out) return YEARN_PATCH_ERROR_FORMAT;
+
+        switch (data & 3) {
+        case BPS_SOURCE_READ:
+            if (out + length > source_size) return YEARN_PATCH_ERROR_FORMAT;
+            memcpy(target + out, source + out, (size_t)length);
+            break;
+
+        case BPS_TARGET_READ:
+            if (length > end - p) return YEARN_PATCH_ERROR_FORMAT;
+            memcpy(target + out, patch + p, (size_t)length);
+            p += (size_t)length;
+            break;
+
+        case BPS_SOURCE_COPY:
+        case BPS_TARGET_COPY: {
+            uint64_t encoded;
+            if (!read_varint(patch, end, &p, &encoded)) return YEARN_PATCH_ERROR_FORMAT;
+            int64_t delta = (int64_t)(encoded >> 1);
+            if (encoded & 1) delta = -delta;
+
+            if ((data & 3) == BPS_SOURCE_COPY) {
+                source_relative += delta;
+                if (source_relative < 0 || (uint64_t)source_relative + length > source_size) {
+                    return YEARN_PATCH_ERROR_FORMAT;
+                }
+                memcpy(target + out, source + source_relative, (size_t)length);
+                source_relative += (int64_t)length;
+            } else {
+                target_relative += delta;
+                if (target_relative < 0 || (uint64_t)target_relative >= out) return YEARN_PATCH_ERROR_FORMAT;
+                if ((uint64_t)target_relative + length <= out) {
+                    memcpy(target + out, target + target_relative, (size_t)length);
+                } else {
+                    // Overlapping copy repeats the bytes just written (run-length fill)
+                    for (uint64_t i = 0; i < length; i++) {
+                        target[out + i] = target[target_relative + (int64_t)i];
+                    }
+                }
+                target_relative += (int64_t)length;
+            }
+            break;
+        }
+        }
+        out += length;
+    }
+    return out == target_size ? YEARN_PATCH_OK : YEARN_PATCH_ERROR_FORMAT;
+}
+
+// MARK: - Public API
+
+yearn_patch_status yearn_patch_inspect(const uint8_t *patch, size_t patch_size, uint64_t source_size,
+                                       yearn_patch_info *info) {
+    memset(info, 0, sizeof(*info));
+    info->format = detect(patch, patch_size);
+
+    switch (info->format) {
+    case YEARN_PATCH_IPS: {
+        uint64_t end;
+        int64_t truncate;
+        yearn_patch_status status = ips_walk(patch, patch_size, NULL, 0, &end, &truncate);
+        if (status != YEARN_PATCH_OK) return status;
+        info->target_size = truncate >= 0 ? (uint64_t)truncate : (end > source_size ? end : source_size);
+        return YEARN_PATCH_OK;
+    }
+
+    case YEARN_PATCH_UPS:
+    case YEARN_PATCH_BPS: {
+        size_t p = 4;
+        size_t end = patch_size - FOOTER_SIZE;
+        if (!read_varint(patch, end, &p, &info->source_size) ||
+            !read_varint(patch, end, &p, &info->target_size)) {
+            return YEARN_PATCH_ERROR_FORMAT;
+        }
+        const uint8_t *footer = patch + end;
+        info->source_crc32 = load32le(footer);
+        info->target_crc32 = load32le(footer + 4);
+        info->patch_crc32 = load32le(footer + 8);
+        return YEARN_PATCH_OK;
+    }
+
+    default:
+        return YEARN_PATCH_ERROR_FORMAT;
+    }
+}
+
+yearn_patch_status yearn_patch_apply(const uint8_t *source, size_t source_size,
+                                     const uint8_t *patch, size_t patch_size,
+                                     uint8_t *target, size_t target_size, int verify) {
+    yearn_patch_info info;
+    yearn_patch_status status = yearn_patch_inspect(patch, patch_size, source_size, &info);
+    if (status != YEARN_PATCH_OK) return status;
+    if (target_size < info.target_size) return YEARN_PATCH_ERROR_TARGET_SIZE;
+    target_size = (size_t)info.target_size;
+
+    if (info.format == YEARN_PATCH_IPS) {
+        size_t keep = source_size < target_size ? source_size : target_size;
+        memcpy(target, source, keep);
+        memset(target + keep, 0, target_size - keep);
+        uint64_t end;
+        int64_t truncate;
+        return ips_walk(patch, patch_size, target, target_size, &end, &truncate);
+    }
+
+    if (verify) {
+        if (yearn_crc32(0, patch, patch_size - 4) != info.patch_crc32) return YEARN_PATCH_ERROR_PATCH_CRC;
+        if (source_size != info.source_size || yearn_crc32(0, source, source_size) != info.source_crc32) {
+            return YEARN_PATCH_ERROR_SOURCE;
+        }
+    }
+
+    // Skip the header fields the inspect pass already read
+    size_t p = 4;
+    uint64_t ignored;
+    read_varint(patch, patch_size, &p, &ignored);
+    read_varint(patch, patch_size, &p, &ignored);
+
+    if (info.format == YEARN_PATCH_UPS) {
+        size_t keep = source_size < target_size ? source_size : target_size;
+        memcpy(target, source, keep);
+        memset(target + keep, 0, target_size - keep);
+        status = ups_apply(source, source_size, patch, patch_size, p, target, target_size);
+    } else {
+        uint64_t metadata;
+        if (!read_varint(patch, patch_size - FOOTER_SIZE, &p, &metadata) ||
+            metadata > patch_size - FOOTER_SIZE - p) {
+            return YEARN_PATCH_ERROR_FORMAT;
+        }
+        p += (size_t)metadata;
+        status = bps_apply(source, source_size, patch, patch_size, p, target, target_size);
+    }
+    if (status != YEARN_PATCH_OK) return status;
+
+    if (verify && yearn_crc32(0, target, target_size) != info.target_crc32) {
+        return YEARN_PATCH_ERROR_TARGET_CRC;
+    }
+    return YEARN_PATCH_OK;
+}
+
+const char *yearn_patch_status_string(yearn_patch_status status) {
+    switch (status) {
+    case YEARN_PATCH_OK: return "ok";
+    case YEARN_PATCH_ERROR_FORMAT: return "not a valid IPS/UPS/BPS patch";
+    case YEARN_PATCH_ERROR_PATCH_CRC: return "patch checksum mismatch (damaged patch)";
+    case YEARN_PATCH_ERROR_SOURCE: return "ROM does not match the patch's source";
+    case YEARN_PATCH_ERROR_TARGET_CRC: return "patched ROM checksum mismatch";
+    case YEARN_PATCH_ERROR_TARGET_SIZE: return "target buffer too small";
+    default: return "unknown error";
+    }
+}
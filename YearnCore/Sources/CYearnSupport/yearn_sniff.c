@@ -0,0 +1,350 @@
+//
+//  yearn_sniff.c
+//  YearnCore
+//
+//  Table-driven ROM / disc image classifier
+//
+
+#include "include/yearn_sniff.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Nintendo logo bitmap in Game Boy cartridge headers (0x104...0x133)
+static const uint8_t gb_logo[48] = {
+    0xCE, 0xED, 0x66, 0x66, 0xCC, 0x0D, 0x00, 0x0B, 0x03, 0x73, 0x00, 0x83,
+    0x00, 0x0C, 0x00, 0x0D, 0x00, 0x08, 0x11, 0x1F, 0x88, 0x89, 0x00, 0x0E,
+    0xDC, 0xCC, 0x6E, 0xE6, 0xDD, 0xDD, 0xD9, 0x99, 0xBB, 0xBB, 0x67, 0x63,
+    0x6E, 0x0E, 0xEC, 0xCC, 0xDD, 0xDC, 0x99, 0x9F, 0xBB, 0xB9, 0x33, 0x3E,
+};
+
+// The GBA / NDS logo (156 bytes) is recognised by its CRC-16, which the NDS
+// header also stores at 0x15C, rather than by comparing the bitmap
+#define AGB_LOGO_LENGTH 156
+#define AGB_LOGO_CRC 0xCF56
+
+#define CD_SECTOR_RAW 2352
+#define CD_SECTOR_COOKED 2048
+#define ISO_PVD_SECTOR 16
+
+// MARK: - Helpers
+
+// CRC-16/MODBUS, as used by NDS headers
+static uint16_t crc16(const uint8_t *p, size_t n) {
+    uint16_t c = 0xFFFF;
+    while (n--) {
+        c ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (uint16_t)((c >> 1) ^ 0xA001) : (uint16_t)(c >> 1);
+        }
+    }
+    return c;
+}
+
+static uint16_t load16le(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static int has(size_t length, size_t offset, size_t count) {
+    return offset + count <= length;
+}
+
+static int printable(const uint8_t *p, size_t n) {
+    int count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += (p[i] >= 0x20 && p[i] < 0x7F);
+    }
+    return count;
+}
+
+// MARK: - Checks
+//
+// A check looks at the block after the rule's magic (if any) has matched and
+// returns the confidence for its system, or 0 to reject.
+
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+    uint64_t file_size;
+} sniff_input;
+
+static float check_magic(const sniff_input *in) {
+    (void)in;
+    return 1;
+}
+
+static float check_gba(const sniff_input *in) {
+    const uint8_t *h = in->data;
+    if (!has(in->length, 0, 0xC0)) return 0;
+
+    int logo = crc16(h + 0x04, AGB_LOGO_LENGTH) == AGB_LOGO_CRC;
+    int fixed = h[0xB2] == 0x96;
+    uint8_t sum = 0;
+    for (int i = 0xA0; i <= 0xBC; i++) sum = (uint8_t)(sum - h[i]);
+    int checksum = (uint8_t)(sum - 0x19) == h[0xBD];
+
+    if (logo) return 0.6f + 0.15f * fixed + 0.23f * checksum;
+    // Homebrew and some flash-cart dumps zero the logo but keep the rest
+    if (fixed && checksum) return 0.5f;
+    return 0;
+}
+
+static float gb_check(const sniff_input *in, int color) {
+    const uint8_t *h = in->data;
+    if (!has(in->length, 0, 0x150)) return 0;
+
+    int logo = memcmp(h + 0x104, gb_logo, sizeof(gb_logo)) == 0;
+    uint8_t sum = 0;
+    for (int i = 0x134; i <= 0x14C; i++) sum = (uint8_t)(sum - h[i] - 1);
+    int checksum = sum == h[0x14D];
+    if (!logo && !checksum) return 0;
+    if (!logo) return 0;        // 1 in 256 blocks pass the checksum by chance
+
+    int cgb = h[0x143] == 0x80 || h[0x143] == 0xC0;
+    if (cgb != color) return 0;
+    return 0.7f + 0.28f * checksum;
+}
+
+static float check_gb(const sniff_input *in) { return gb_check(in, 0); }
+static float check_gbc(const sniff_input *in) { return gb_check(in, 1); }
+
+static float check_nds(const sniff_input *in) {
+    const uint8_t *h = in->data;
+    if (!has(in->length, 0, 0x160)) return 0;
+
+    int header = crc16(h, 0x15E) == load16le(h + 0x15E);
+    int stored_logo = load16le(h + 0x15C) == AGB_LOGO_CRC;
+    int logo = crc16(h + 0xC0, AGB_LOGO_LENGTH) == AGB_LOGO_CRC;
+
+    if (header && (stored_logo || logo)) return 0.98f;
+    if (stored_logo && logo) return 0.85f;
+    if (header) return 0.6f;
+    return 0;
+}
+
+static float check_genesis(const sniff_input *in) {
+    const uint8_t *h = in->data;
+    if (has(in->length, 0x100, 16) &&
+        (memcmp(h + 0x100, "SEGA MEGA DRIVE", 15) == 0 || memcmp(h + 0x100, "SEGA GENESIS", 12) == 0)) {
+        return 0.92f;
+    }
+    // "SEGA" alone also starts 32X ("SEGA 32X") and Pico headers, which the Genesis core runs anyway
+    return 0.8f;
+}
+
+// Super Magic Drive dumps: a 512-byte header, then 16 KB blocks with even and odd bytes split
+static float check_smd(const sniff_input *in) {
+    const uint8_t *h = in->data;
+    if (in->file_size % 0x4000 != 0x200) return 0;
+    if (!has(in->length, 0x200, 0x4000)) return 0;
+
+    // De-interleave the first block and look for "SEGA" at 0x100 there
+    const uint8_t *block = h + 0x200;
+    uint8_t sega[4];
+    for (int i = 0; i < 4; i++) {
+        int offset = 0x100 + i;
+        sega[i] = (offset & 1) ? block[offset / 2] : block[0x2000 + offset / 2];
+    }
+    return memcmp(sega, "SEGA", 4) == 0 ? 0.85f : 0;
+}
+
+static float snes_header_score(const uint8_t *h, int hirom) {
+    uint16_t complement = load16le(h + 0x1C);
+    uint16_t checksum = load16le(h + 0x1E);
+    uint8_t map = h[0x15];
+    uint16_t reset = load16le(h + 0x3C);
+
+    int sums = (uint16_t)(checksum + complement) == 0xFFFF;
+    // Map mode 0x20-0x3F, low bit set for HiROM (0x25 ExHiROM counts as HiROM)
+    int mapped = (map & 0xE0) == 0x20 && ((map & 0x01) == hirom || map == 0x25 || map == 0x35);
+    int titled = printable(h, 21) >= 18;
+    int vector = reset >= 0x8000;
+
+    if (!sums && !(mapped && titled && vector)) return 0;
+    float score = (sums ? 0.5f : 0.2f) + 0.18f * mapped + 0.15f * titled + 0.1f * vector;
+    return score > 0.97f ? 0.97f : score;
+}
+
+static float check_snes(const sniff_input *in) {
+    // Copier headers pad the file to 512 bytes past a multiple of 1 KB
+    size_t base = (in->file_size % 1024 == 512) ? 0x200 : 0;
+    static const struct { size_t offset; int hirom; } headers[] = {
+        { 0x7FC0, 0 },
+        { 0xFFC0, 1 },
+    };
+
+    float best = 0;
+    for (size_t i = 0; i < sizeof(headers) / sizeof(headers[0]); i++) {
+        size_t offset = base + headers[i].offset;
+        if (!has(in->length, offset, 0x40)) continue;
+        float score = snes_header_score(in->data + offset, headers[i].hirom);
+        if (score > best) best = score;
+    }
+    return best;
+}
+
+// Offset of the ISO9660 primary volume descriptor in a block, or 0
+static size_t iso_pvd(const sniff_input *in) {
+    static const size_t offsets[] = {
+        ISO_PVD_SECTOR * CD_SECTOR_COOKED,              // .iso, 2048-byte sectors
+        ISO_PVD_SECTOR * CD_SECTOR_RAW + 24,            // raw MODE2/2352 (PlayStation)
+        ISO_PVD_SECTOR * CD_SECTOR_RAW + 16,            // raw MODE1/2352
+    };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        size_t offset = offsets[i];
+        if (has(in->length, offset, 40) && memcmp(in->data + offset, "\x01" "CD001", 6) == 0) {
+            return offset;
+        }
+    }
+    return 0;
+}
+
+static float check_ps1(const sniff_input *in) {
+    size_t pvd = iso_pvd(in);
+    if (pvd == 0) return 0;
+    // System identifier, space padded
+    return memcmp(in->data + pvd + 8, "PLAYSTATION", 11) == 0 ? 0.97f : 0;
+}
+
+static float check_iso9660(const sniff_input *in) {
+    return iso_pvd(in) != 0 ? 0.5f : 0;
+}
+
+// Raw 2352-byte sectors without a readable volume descriptor (e.g. an audio-less
+// data track of a copy-protected disc); weak evidence for a PlayStation image
+static float check_raw_cd(const sniff_input *in) {
+    return in->file_size % CD_SECTOR_RAW == 0 ? 0.35f : 0.2f;
+}
+
+// MARK: - Rules
+
+typedef struct {
+    yearn_sniff_system system;
+    uint32_t offset;            // where `magic` must appear
+    const char *magic;          // NULL: run `check` unconditionally
+    uint8_t magic_length;
+    float confidence;           // scales what `check` returns
+    float (*check)(const sniff_input *in);
+} sniff_rule;
+
+static const sniff_rule rules[] = {
+    // Copier and container headers
+    { YEARN_SNIFF_NES,     0x000, "NES\x1A",            4, 0.97f, check_magic },
+    { YEARN_SNIFF_FDS,     0x000, "FDS\x1A",            4, 0.97f, check_magic },
+    { YEARN_SNIFF_FDS,     0x000, "\x01*NINTENDO-HVC*", 15, 0.95f, check_magic },
+
+    // N64 boot header in big-endian (.z64), byte-swapped (.v64) and little-endian (.n64) order
+    { YEARN_SNIFF_N64,     0x000, "\x80\x37\x12\x40",   4, 0.97f, check_magic },
+    { YEARN_SNIFF_N64,     0x000, "\x37\x80\x40\x12",   4, 0.97f, check_magic },
+    { YEARN_SNIFF_N64,     0x000, "\x40\x12\x37\x80",   4, 0.97f, check_magic },
+
+    // Cartridge headers verified by checksum
+    { YEARN_SNIFF_GBA,     0,     NULL,                 0, 1,     check_gba },
+    { YEARN_SNIFF_GB,      0,     NULL,                 0, 1,     check_gb },
+    { YEARN_SNIFF_GBC,     0,     NULL,                 0, 1,     check_gbc },
+    { YEARN_SNIFF_NDS,     0,     NULL,                 0, 1,     check_nds },
+    { YEARN_SNIFF_GENESIS, 0x100, "SEGA",               4, 1,     check_genesis },
+    { YEARN_SNIFF_GENESIS, 0x008, "\xAA\xBB",           2, 1,     check_smd },
+    { YEARN_SNIFF_SNES,    0,     NULL,                 0, 1,     check_snes },
+
+    // Disc images
+    { YEARN_SNIFF_PS1,     0,     NULL,                 0, 1,     check_ps1 },
+    { YEARN_SNIFF_ISO9660, 0,     NULL,                 0, 1,     check_iso9660 },
+    { YEARN_SNIFF_PS1,     0x000, "\x00\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x00", 12, 1, check_raw_cd },
+};
+
+#define RULE_COUNT (sizeof(rules) / sizeof(rules[0]))
+#define SYSTEM_COUNT (YEARN_SNIFF_ISO9660 + 1)
+
+// MARK: - Public API
+
+int yearn_sniff_buffer(const uint8_t *data, size_t length, uint64_t file_size,
+                       yearn_sniff_result *results, int capacity) {
+    if (!data || !results || capacity <= 0) return 0;
+
+    sniff_input in = { data, length, file_size };
+    float best[SYSTEM_COUNT] = { 0 };
+
+    for (size_t i = 0; i < RULE_COUNT; i++) {
+        const sniff_rule *rule = &rules[i];
+        if (rule->magic) {
+            if (!has(length, rule->offset, rule->magic_length) ||
+                memcmp(data + rule->offset, rule->magic, rule->magic_length) != 0) {
+                continue;
+            }
+        }
+        float confidence = rule->confidence * rule->check(&in);
+        if (confidence > best[rule->system]) best[rule->system] = confidence;
+    }
+
+    // Best first; SYSTEM_COUNT is small enough for selection
+    int count = 0;
+    while (count < capacity) {
+        int pick = 0;
+        for (int s = 1; s < SYSTEM_COUNT; s++) {
+            if (best[s] > best[pick]) pick = s;
+        }
+        if (pick == 0 || best[pick] <= 0) break;
+        results[count].system = (yearn_sniff_system)pick;
+        results[count].confidence = best[pick];
+        best[pick] = 0;
+        count++;
+    }
+    return count;
+}
+
+int yearn_sniff_file(const char *path, yearn_sniff_result *results, int capacity, uint64_t *file_size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    if (file_size) *file_size = (uint64_t)st.st_size;
+
+    size_t wanted = (uint64_t)st.st_size < YEARN_SNIFF_BLOCK_SIZE ? (size_t)st.st_size : YEARN_SNIFF_BLOCK_SIZE;
+    uint8_t *block = malloc(wanted ? wanted : 1);
+    if (!block) {
+        close(fd);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    size_t got = 0;
+    while (got < wanted) {
+        ssize_t n = pread(fd, block + got, wanted - got, (off_t)got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    close(fd);
+
+    int count = yearn_sniff_buffer(block, got, (uint64_t)st.st_size, results, capacity);
+    free(block);
+    return count;
+}
+
+const char *yearn_sniff_system_name(yearn_sniff_system system) {
+    switch (system) {
+    case YEARN_SNIFF_NES: return "NES";
+    case YEARN_SNIFF_FDS: return "FDS";
+    case YEARN_SNIFF_SNES: return "SNES";
+    case YEARN_SNIFF_GB: return "GB";
+    case YEARN_SNIFF_GBC: return "GBC";
+    case YEARN_SNIFF_GBA: return "GBA";
+    case YEARN_SNIFF_N64: return "N64";
+    case YEARN_SNIFF_NDS: return "NDS";
+    case YEARN_SNIFF_GENESIS: return "Genesis";
+    case YEARN_SNIFF_PS1: return "PS1";
+    case YEARN_SNIFF_ISO9660: return "ISO9660";
+    default: return "unknown";
+    }
+}
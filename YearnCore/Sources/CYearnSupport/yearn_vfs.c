@@ -0,0 +1,773 @@
+//
+//  yearn_vfs.c
+//  YearnCore
+//
+//  libretro VFS implementation with a read cache for disc images
+//
+
+#include "include/yearn_vfs.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DEFAULT_CACHE_BLOCKS 64     // 4 MB per registered file
+#define READAHEAD_BLOCKS 4          // 256 KB ahead of a sequential reader
+#define READAHEAD_TRIGGER 2         // blocks read in order before read-ahead starts
+#define READAHEAD_QUEUE 64
+
+enum {
+    BLOCK_EMPTY = 0,
+    BLOCK_LOADING,
+    BLOCK_READY
+};
+
+typedef struct {
+    int64_t index;          // block number, -1 when empty
+    uint8_t *data;
+    size_t length;
+    uint64_t last_use;
+    int state;
+    int from_readahead;     // filled ahead of time and not read yet
+} cache_block;
+
+typedef struct source {
+    char *path;
+    uint64_t size;
+    int fd;                 // -1 for virtual files
+    yearn_vfs_read_fn read;
+    yearn_vfs_release_fn release;
+    void *context;
+    cache_block *blocks;
+    unsigned block_count;
+    uint64_t clock;
+    int64_t last_block;     // last block touched by a read, for sequential detection
+    unsigned sequential;    // consecutive blocks read in order
+    int refcount;           // registry + open handles + queued read-ahead
+    struct source *next;
+} source;
+
+struct retro_vfs_file_handle {
+    char *path;
+    int fd;                 // pass-through files
+    source *cached;         // registered files
+    int64_t position;
+};
+
+struct retro_vfs_dir_handle {
+    char *path;
+    DIR *dir;
+    struct dirent *entry;
+    _Bool include_hidden;
+};
+
+typedef struct {
+    source *src;
+    int64_t block;
+} readahead_request;
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_block_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_work = PTHREAD_COND_INITIALIZER;
+static source *g_sources = NULL;
+static yearn_vfs_stats g_stats;
+
+static readahead_request g_queue[READAHEAD_QUEUE];
+static unsigned g_queue_head = 0;
+static unsigned g_queue_count = 0;
+static int g_worker_started = 0;
+
+// MARK: - Sources
+
+static char *copy_string(const char *string) {
+    size_t length = strlen(string) + 1;
+    char *copy = malloc(length);
+    if (copy) {
+        memcpy(copy, string, length);
+    }
+    return copy;
+}
+
+// Caller holds g_lock
+static void source_release(source *src) {
+    if (--src->refcount > 0) {
+        return;
+    }
+    for (unsigned i = 0; i < src->block_count; i++) {
+        free(src->blocks[i].data);
+    }
+    free(src->blocks);
+    if (src->fd >= 0) {
+        close(src->fd);
+    }
+    if (src->release) {
+        src->release(src->context);
+    }
+    free(src->path);
+    free(src);
+}
+
+// Caller holds g_lock
+static source *source_find(const char *path) {
+    for (source *src = g_sources; src; src = src->next) {
+        if (strcmp(src->path, path) == 0) {
+            return src;
+        }
+    }
+    return NULL;
+}
+
+static int source_add(source *src, unsigned cache_blocks) {
+    src->block_count = cache_blocks ? cache_blocks : DEFAULT_CACHE_BLOCKS;
+    src->blocks = calloc(src->block_count, sizeof(cache_block));
+    if (!src->blocks) {
+        return -1;
+    }
+    for (unsigned i = 0; i < src->block_count; i++) {
+        src->blocks[i].index = -1;
+    }
+    src->last_block = -2;
+    src->refcount = 1;
+
+    pthread_mutex_lock(&g_lock);
+    source *existing = source_find(src->path);
+    if (existing) {
+        // Re-registering replaces the old entry; open handles keep theirs
+        source **link = &g_sources;
+        while (*link != existing) {
+            link = &(*link)->next;
+        }
+        *link = existing->next;
+        source_release(existing);
+    }
+    src->next = g_sources;
+    g_sources = src;
+    pthread_mutex_unlock(&g_lock);
+    return 0;
+}
+
+int yearn_vfs_register_file(const char *path, unsigned cache_blocks) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    source *src = calloc(1, sizeof(source));
+    if (!src || !(src->path = copy_string(path))) {
+        free(src);
+        close(fd);
+        return -1;
+    }
+    src->fd = fd;
+    src->size = (uint64_t)info.st_size;
+
+    if (source_add(src, cache_blocks) != 0) {
+        free(src->path);
+        free(src);
+        close(fd);
+        return -1;
+    }
+    return 0;
+}
+
+int yearn_vfs_register_virtual(const char *path, uint64_t size,
+                               yearn_vfs_read_fn read, yearn_vfs_release_fn release,
+                               void *context, unsigned cache_blocks) {
+    source *src = calloc(1, sizeof(source));
+    if (!src || !(src->path = copy_string(path))) {
+        free(src);
+        return -1;
+    }
+    src->fd = -1;
+    src->size = size;
+    src->read = read;
+    src->release = release;
+    src->context = context;
+
+    if (source_add(src, cache_blocks) != 0) {
+        free(src->path);
+        free(src);
+        return -1;
+    }
+    return 0;
+}
+
+void yearn_vfs_unregister_all(void) {
+    pthread_mutex_lock(&g_lock);
+    source *src = g_sources;
+    g_sources = NULL;
+    while (src) {
+        source *next = src->next;
+        source_release(src);
+        src = next;
+    }
+    pthread_mutex_unlock(&g_lock);
+}
+
+void yearn_vfs_get_stats(yearn_vfs_stats *stats) {
+    pthread_mutex_lock(&g_lock);
+    *stats = g_stats;
+    pthread_mutex_unlock(&g_lock);
+}
+
+void yearn_vfs_reset_stats(void) {
+    pthread_mutex_lock(&g_lock);
+    memset(&g_stats, 0, sizeof(g_stats));
+    pthread_mutex_unlock(&g_lock);
+}
+
+// MARK: - Block Cache
+
+// Read one block from the backing file or virtual source. Called without g_lock.
+static int64_t source_fetch(source *src, int64_t block, uint8_t *data) {
+    uint64_t offset = (uint64_t)block * YEARN_VFS_BLOCK_SIZE;
+    if (offset >= src->size) {
+        return 0;
+    }
+    uint64_t length = src->size - offset;
+    if (length > YEARN_VFS_BLOCK_SIZE) {
+        length = YEARN_VFS_BLOCK_SIZE;
+    }
+
+    if (src->fd < 0) {
+        return src->read(src->context, offset, data, length);
+    }
+
+    uint64_t done = 0;
+    while (done < length) {
+        ssize_t n = pread(src->fd, data + done, (size_t)(length - done), (off_t)(offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return n < 0 ? -1 : (int64_t)done;
+        }
+        done += (uint64_t)n;
+    }
+    return (int64_t)done;
+}
+
+// Caller holds g_lock
+static cache_block *block_find(source *src, int64_t block) {
+    for (unsigned i = 0; i < src->block_count; i++) {
+        if (src->blocks[i].index == block) {
+            return &src->blocks[i];
+        }
+    }
+    return NULL;
+}
+
+// Least recently used block that is not being filled. Caller holds g_lock.
+static cache_block *block_victim(source *src) {
+    cache_block *victim = NULL;
+    for (unsigned i = 0; i < src->block_count; i++) {
+        cache_block *b = &src->blocks[i];
+        if (b->state == BLOCK_LOADING) {
+            continue;
+        }
+        if (b->state == BLOCK_EMPTY) {
+            return b;
+        }
+        if (!victim || b->last_use < victim->last_use) {
+            victim = b;
+        }
+    }
+    return victim;
+}
+
+// Fill `b` with `block`, dropping g_lock for the I/O. Caller holds g_lock.
+static int block_fill(source *src, cache_block *b, int64_t block, int readahead) {
+    if (!b->data && !(b->data = malloc(YEARN_VFS_BLOCK_SIZE))) {
+        return -1;
+    }
+    b->index = block;
+    b->state = BLOCK_LOADING;
+    pthread_mutex_unlock(&g_lock);
+
+    int64_t n = source_fetch(src, block, b->data);
+
+    pthread_mutex_lock(&g_lock);
+    if (n < 0) {
+        b->index = -1;
+        b->state = BLOCK_EMPTY;
+    } else {
+        b->length = (size_t)n;
+        b->state = BLOCK_READY;
+        b->last_use = ++src->clock;
+        b->from_readahead = readahead;
+        g_stats.source_bytes += (uint64_t)n;
+    }
+    pthread_cond_broadcast(&g_block_ready);
+    return n < 0 ? -1 : 0;
+}
+
+// Return a ready block, loading it on the caller's thread on a miss. Caller holds g_lock.
+static cache_block *block_acquire(source *src, int64_t block) {
+    for (;;) {
+        cache_block *b = block_find(src, block);
+        if (b && b->state == BLOCK_READY) {
+            g_stats.block_hits++;
+            if (b->from_readahead) {
+                g_stats.readahead_hits++;
+                b->from_readahead = 0;
+            }
+            b->last_use = ++src->clock;
+            return b;
+        }
+        if (b && b->state == BLOCK_LOADING) {
+            pthread_cond_wait(&g_block_ready, &g_lock);
+            continue;
+        }
+
+        b = block_victim(src);
+        if (!b) {
+            pthread_cond_wait(&g_block_ready, &g_lock);
+            continue;
+        }
+        g_stats.block_misses++;
+        if (block_fill(src, b, block, 0) != 0) {
+            return NULL;
+        }
+        // Another reader may have evicted it while unlocked; look it up again
+    }
+}
+
+// MARK: - Read-ahead
+
+static void *readahead_worker(void *unused) {
+    (void)unused;
+    pthread_mutex_lock(&g_lock);
+    for (;;) {
+        while (g_queue_count == 0) {
+            pthread_cond_wait(&g_work, &g_lock);
+        }
+        readahead_request request = g_queue[g_queue_head];
+        g_queue_head = (g_queue_head + 1) % READAHEAD_QUEUE;
+        g_queue_count--;
+
+        source *src = request.src;
+        uint64_t offset = (uint64_t)request.block * YEARN_VFS_BLOCK_SIZE;
+        if (offset < src->size && !block_find(src, request.block)) {
+            cache_block *b = block_victim(src);
+            if (b && block_fill(src, b, request.block, 1) == 0) {
+                g_stats.readahead_blocks++;
+            }
+        }
+        source_release(src);
+    }
+    return NULL;
+}
+
+// Queue the blocks after `block`. Caller holds g_lock.
+static void readahead_schedule(source *src, int64_t block) {
+    if (!g_worker_started) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, readahead_worker, NULL) != 0) {
+            return;
+        }
+        pthread_detach(thread);
+        g_worker_started = 1;
+    }
+
+    for (int64_t next = block + 1; next <= block + READAHEAD_BLOCKS; next++) {
+        if ((uint64_t)next * YEARN_VFS_BLOCK_SIZE >= src->size) {
+            break;
+        }
+        if (block_find(src, next) || g_queue_count == READAHEAD_QUEUE) {
+            continue;
+        }
+        unsigned tail = (g_queue_head + g_queue_count) % READAHEAD_QUEUE;
+        g_queue[tail].src = src;
+        g_queue[tail].block = next;
+        g_queue_count++;
+        src->refcount++;
+    }
+    pthread_cond_signal(&g_work);
+}
+
+static int64_t cached_read(struct retro_vfs_file_handle *stream, uint8_t *buffer, uint64_t length) {
+    source *src = stream->cached;
+    if (stream->position < 0 || (uint64_t)stream->position >= src->size) {
+        return 0;
+    }
+    if (length > src->size - (uint64_t)stream->position) {
+        length = src->size - (uint64_t)stream->position;
+    }
+
+    uint64_t copied = 0;
+    pthread_mutex_lock(&g_lock);
+    g_stats.reads++;
+
+    while (copied < length) {
+        uint64_t position = (uint64_t)stream->position + copied;
+        int64_t block = (int64_t)(position / YEARN_VFS_BLOCK_SIZE);
+        size_t offset = (size_t)(position % YEARN_VFS_BLOCK_SIZE);
+
+        cache_block *b = block_acquire(src, block);
+        if (!b || b->length <= offset) {
+            break;
+        }
+
+        uint64_t count = b->length - offset;
+        if (count > length - copied) {
+            count = length - copied;
+        }
+        memcpy(buffer + copied, b->data + offset, (size_t)count);
+        copied += count;
+
+        // Several blocks in a row means a streaming reader (FMV, audio);
+        // a single step is usually a short file load at boot and not worth it
+        if (block != src->last_block) {
+            src->sequential = block == src->last_block + 1 ? src->sequential + 1 : 0;
+            src->last_block = block;
+            if (src->sequential >= READAHEAD_TRIGGER) {
+                readahead_schedule(src, block);
+            }
+        }
+    }
+
+    g_stats.bytes_read += copied;
+    pthread_mutex_unlock(&g_lock);
+
+    stream->position += (int64_t)copied;
+    return copied > 0 || length == 0 ? (int64_t)copied : -1;
+}
+
+// MARK: - File Interface
+
+static const char *vfs_get_path(struct retro_vfs_file_handle *stream) {
+    return stream ? stream->path : NULL;
+}
+
+static struct retro_vfs_file_handle *vfs_open(const char *path, unsigned mode, unsigned hints) {
+    (void)hints;
+    if (!path) {
+        return NULL;
+    }
+
+    struct retro_vfs_file_handle *stream = calloc(1, sizeof(*stream));
+    if (!stream || !(stream->path = copy_string(path))) {
+        free(stream);
+        return NULL;
+    }
+    stream->fd = -1;
+
+    if (mode == RETRO_VFS_FILE_ACCESS_READ) {
+        pthread_mutex_lock(&g_lock);
+        source *src = source_find(path);
+        if (src) {
+            src->refcount++;
+            stream->cached = src;
+        }
+        pthread_mutex_unlock(&g_lock);
+        if (src) {
+            return stream;
+        }
+    }
+
+    int flags;
+    switch (mode & RETRO_VFS_FILE_ACCESS_READ_WRITE) {
+    case RETRO_VFS_FILE_ACCESS_READ:
+        flags = O_RDONLY;
+        break;
+    case RETRO_VFS_FILE_ACCESS_WRITE:
+        flags = (mode & RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING) ? O_WRONLY : (O_WRONLY | O_CREAT | O_TRUNC);
+        break;
+    case RETRO_VFS_FILE_ACCESS_READ_WRITE:
+        flags = (mode & RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING) ? O_RDWR : (O_RDWR | O_CREAT | O_TRUNC);
+        break;
+    default:
+        free(stream->path);
+        free(stream);
+        return NULL;
+    }
+
+    stream->fd = open(path, flags, 0644);
+    if (stream->fd < 0) {
+        free(stream->path);
+        free(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+static int vfs_close(struct retro_vfs_file_handle *stream) {
+    if (!stream) {
+        return -1;
+    }
+    if (stream->cached) {
+        pthread_mutex_lock(&g_lock);
+        source_release(stream->cached);
+        pthread_mutex_unlock(&g_lock);
+    }
+    if (stream->fd >= 0) {
+        close(stream->fd);
+    }
+    free(stream->path);
+    free(stream);
+    return 0;
+}
+
+static int64_t vfs_size(struct retro_vfs_file_handle *stream) {
+    if (!stream) {
+        return -1;
+    }
+    if (stream->cached) {
+        return (int64_t)stream->cached->size;
+    }
+    struct stat info;
+    return fstat(stream->fd, &info) == 0 ? (int64_t)info.st_size : -1;
+}
+
+static int64_t vfs_truncate(struct retro_vfs_file_handle *stream, int64_t length) {
+    if (!stream || stream->cached) {
+        return -1;
+    }
+    return ftruncate(stream->fd, (off_t)length) == 0 ? 0 : -1;
+}
+
+static int64_t vfs_tell(struct retro_vfs_file_handle *stream) {
+    if (!stream) {
+        return -1;
+    }
+    if (stream->cached) {
+        return stream->position;
+    }
+    return (int64_t)lseek(stream->fd, 0, SEEK_CUR);
+}
+
+static int64_t vfs_seek(struct retro_vfs_file_handle *stream, int64_t offset, int seek_position) {
+    if (!stream) {
+        return -1;
+    }
+
+    if (!stream->cached) {
+        int whence = seek_position == RETRO_VFS_SEEK_POSITION_CURRENT ? SEEK_CUR
+                   : seek_position == RETRO_VFS_SEEK_POSITION_END ? SEEK_END : SEEK_SET;
+        return (int64_t)lseek(stream->fd, (off_t)offset, whence);
+    }
+
+    int64_t base = 0;
+    if (seek_position == RETRO_VFS_SEEK_POSITION_CURRENT) {
+        base = stream->position;
+    } else if (seek_position == RETRO_VFS_SEEK_POSITION_END) {
+        base = (int64_t)stream->cached->size;
+    }
+    if (base + offset < 0) {
+        return -1;
+    }
+    stream->position = base + offset;
+    return stream->position;
+}
+
+static int64_t vfs_read(struct retro_vfs_file_handle *stream, void *s, uint64_t len) {
+    if (!stream || !s) {
+        return -1;
+    }
+    if (stream->cached) {
+        return cached_read(stream, s, len);
+    }
+
+    ssize_t n;
+    do {
+        n = read(stream->fd, s, (size_t)len);
+    } while (n < 0 && errno == EINTR);
+    return (int64_t)n;
+}
+
+static int64_t vfs_write(struct retro_vfs_file_handle *stream, const void *s, uint64_t len) {
+    if (!stream || !s || stream->cached) {
+        return -1;
+    }
+
+    ssize_t n;
+    do {
+        n = write(stream->fd, s, (size_t)len);
+    } while (n < 0 && errno == EINTR);
+    return (int64_t)n;
+}
+
+static int vfs_flush(struct retro_vfs_file_handle *stream) {
+    // Writes go straight to the descriptor; nothing is buffered here
+    return stream ? 0 : -1;
+}
+
+static int vfs_remove(const char *path) {
+    if (!path) {
+        return -1;
+    }
+    struct stat info;
+    if (stat(path, &info) == 0 && S_ISDIR(info.st_mode)) {
+        return rmdir(path) == 0 ? 0 : -1;
+    }
+    return unlink(path) == 0 ? 0 : -1;
+}
+
+static int vfs_rename(const char *old_path, const char *new_path) {
+    if (!old_path || !new_path) {
+        return -1;
+    }
+    return rename(old_path, new_path) == 0 ? 0 : -1;
+}
+
+// MARK: - Directory Interface
+
+static int vfs_stat(const char *path, int32_t *size) {
+    if (!path) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&g_lock);
+    source *src = source_find(path);
+    uint64_t virtual_size = src ? src->size : 0;
+    pthread_mutex_unlock(&g_lock);
+
+    if (src) {
+        if (size) {
+            *size = virtual_size > INT32_MAX ? INT32_MAX : (int32_t)virtual_size;
+        }
+        return RETRO_VFS_STAT_IS_VALID;
+    }
+
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        return 0;
+    }
+    if (size) {
+        *size = info.st_size > INT32_MAX ? INT32_MAX : (int32_t)info.st_size;
+    }
+
+    int flags = RETRO_VFS_STAT_IS_VALID;
+    if (S_ISDIR(info.st_mode)) {
+        flags |= RETRO_VFS_STAT_IS_DIRECTORY;
+    }
+    if (S_ISCHR(info.st_mode)) {
+        flags |= RETRO_VFS_STAT_IS_CHARACTER_SPECIAL;
+    }
+    return flags;
+}
+
+static int vfs_mkdir(const char *dir) {
+    if (!dir) {
+        return -1;
+    }
+    if (mkdir(dir, 0755) == 0) {
+        return 0;
+    }
+    return errno == EEXIST ? -2 : -1;
+}
+
+static struct retro_vfs_dir_handle *vfs_opendir(const char *dir, _Bool include_hidden) {
+    if (!dir) {
+        return NULL;
+    }
+    DIR *handle = opendir(dir);
+    if (!handle) {
+        return NULL;
+    }
+
+    struct retro_vfs_dir_handle *stream = calloc(1, sizeof(*stream));
+    if (!stream || !(stream->path = copy_string(dir))) {
+        free(stream);
+        closedir(handle);
+        return NULL;
+    }
+    stream->dir = handle;
+    stream->include_hidden = include_hidden;
+    return stream;
+}
+
+static _Bool vfs_readdir(struct retro_vfs_dir_handle *stream) {
+    if (!stream) {
+        return 0;
+    }
+    while ((stream->entry = readdir(stream->dir)) != NULL) {
+        const char *name = stream->entry->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+            continue;
+        }
+        if (!stream->include_hidden && name[0] == '.') {
+            continue;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static const char *vfs_dirent_get_name(struct retro_vfs_dir_handle *stream) {
+    return stream && stream->entry ? stream->entry->d_name : NULL;
+}
+
+static _Bool vfs_dirent_is_dir(struct retro_vfs_dir_handle *stream) {
+    if (!stream || !stream->entry) {
+        return 0;
+    }
+#ifdef DT_DIR
+    if (stream->entry->d_type == DT_DIR) {
+        return 1;
+    }
+    if (stream->entry->d_type != DT_UNKNOWN && stream->entry->d_type != DT_LNK) {
+        return 0;
+    }
+#endif
+    size_t length = strlen(stream->path) + strlen(stream->entry->d_name) + 2;
+    char *path = malloc(length);
+    if (!path) {
+        return 0;
+    }
+    snprintf(path, length, "%s/%s", stream->path, stream->entry->d_name);
+    struct stat info;
+    _Bool is_dir = stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+    free(path);
+    return is_dir;
+}
+
+static int vfs_closedir(struct retro_vfs_dir_handle *stream) {
+    if (!stream) {
+        return -1;
+    }
+    closedir(stream->dir);
+    free(stream->path);
+    free(stream);
+    return 0;
+}
+
+// MARK: - Interface
+
+static struct retro_vfs_interface g_interface = {
+    vfs_get_path,
+    vfs_open,
+    vfs_close,
+    vfs_size,
+    vfs_tell,
+    vfs_seek,
+    vfs_read,
+    vfs_write,
+    vfs_flush,
+    vfs_remove,
+    vfs_rename,
+    vfs_truncate,
+    vfs_stat,
+    vfs_mkdir,
+    vfs_opendir,
+    vfs_readdir,
+    vfs_dirent_get_name,
+    vfs_dirent_is_dir,
+    vfs_closedir
+};
+
+struct retro_vfs_interface *yearn_vfs_interface(void) {
+    return &g_interface;
+}
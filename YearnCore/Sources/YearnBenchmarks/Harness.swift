@@ -0,0 +1,255 @@
+//
+//  Harness.swift
+//  YearnBenchmarks
+//
+//  Timing, statistics and reports for the benchmark suite
+//
+
+import Foundation
+
+// MARK: - Benchmark
+
+/// One measured operation
+///
+/// State is built once by whoever makes the benchmark and captured by `run`,
+/// so setup is never timed. `run(n)` performs the operation `n` times.
+struct Benchmark {
+    let name: String
+    /// Bytes processed by one operation, for throughput; 0 when it means nothing
+    let bytesPerOperation: Int
+    let run: (Int) -> Void
+
+    init(_ name: String, bytesPerOperation: Int = 0, run: @escaping (Int) -> Void) {
+        self.name = name
+        self.bytesPerOperation = bytesPerOperation
+        self.run = run
+    }
+}
+
+/// Keeps a value alive so the optimizer cannot drop the work that made it
+@inline(never)
+func blackHole<T>(_ value: T) {
+    withExtendedLifetime(value) {}
+}
+
+// MARK: - Statistics
+
+/// Summary of the per-operation times of all samples, in nanoseconds
+struct Statistics: Codable {
+    let median: Double
+    /// Median absolute deviation from the median
+    let mad: Double
+    let mean: Double
+    let min: Double
+    let max: Double
+    let samples: Int
+
+    init(_ values: [Double]) {
+        precondition(!values.isEmpty, "No samples")
+        let sorted = values.sorted()
+        median = Self.median(of: sorted)
+        mad = Self.median(of: sorted.map { abs($0 - median) }.sorted())
+        mean = sorted.reduce(0, +) / Double(sorted.count)
+        min = sorted[0]
+        max = sorted[sorted.count - 1]
+        samples = sorted.count
+    }
+
+    /// MAD relative to the median
+    var relativeMAD: Double {
+        median > 0 ? mad / median : 0
+    }
+
+    private static func median(of sorted: [Double]) -> Double {
+        let middle = sorted.count / 2
+        return sorted.count % 2 == 0 ? (sorted[middle - 1] + sorted[middle]) / 2 : sorted[middle]
+    }
+}
+
+// MARK: - Runner
+
+/// Measures benchmarks: calibrate, warm up, then time a fixed number of samples
+struct Runner {
+    /// Samples run and thrown away before measuring
+    var warmup = 5
+    /// Samples measured
+    var iterations = 25
+    /// Time one sample should take; operations per sample are calibrated to it
+    var sampleTime: TimeInterval = 0.01
+
+    struct Result: Codable {
+        let name: String
+        let operationsPerSample: Int
+        /// Nanoseconds per operation
+        let statistics: Statistics
+        /// Median throughput, when the benchmark has a size
+        let bytesPerSecond: Double?
+    }
+
+    func measure(_ benchmark: Benchmark) -> Result {
+        let operations = calibrate(benchmark)
+
+        for _ in 0..<warmup {
+            _ = time(benchmark, operations)
+        }
+        var perOperation: [Double] = []
+        perOperation.reserveCapacity(iterations)
+        for _ in 0..<iterations {
+            perOperation.append(Double(time(benchmark, operations)) / Double(operations))
+        }
+
+        let statistics = Statistics(perOperation)
+        let throughput = benchmark.bytesPerOperation > 0 && statistics.median > 0
+            ? Double(benchmark.bytesPerOperation) / (statistics.median / 1e9)
+            : nil
+        return Result(name: benchmark.name, operationsPerSample: operations,
+                      statistics: statistics, bytesPerSecond: throughput)
+    }
+
+    /// Smallest power of two operations that fills `sampleTime`
+    private func calibrate(_ benchmark: Benchmark) -> Int {
+        let target = UInt64(sampleTime * 1e9)
+        var operations = 1
+        while operations < 1 << 24 {
+            let elapsed = time(benchmark, operations)
+            if elapsed >= target { break }
+            // Jump straight to the estimate once the timer resolves the sample
+            if elapsed > 10_000 {
+                let estimate = Double(operations) * Double(target) / Double(elapsed)
+                operations = 1 << Swift.min(24, Int(log2(estimate).rounded(.up)))
+                break
+            }
+            operations *= 2
+        }
+        return operations
+    }
+
+    private func time(_ benchmark: Benchmark, _ operations: Int) -> UInt64 {
+        let start = DispatchTime.now().uptimeNanoseconds
+        benchmark.run(operations)
+        return DispatchTime.now().uptimeNanoseconds - start
+    }
+}
+
+// MARK: - Report
+
+/// Everything one run measured; written as JSON and read back as a baseline
+struct Report: Codable {
+    static let formatVersion = 1
+
+    let formatVersion: Int
+    let date: Date
+    let host: Host
+    let configuration: Configuration
+    let results: [Runner.Result]
+
+    struct Host: Codable {
+        let system: String
+        let architecture: String
+        let processors: Int
+        let crc32: String
+    }
+
+    struct Configuration: Codable {
+        let warmup: Int
+        let iterations: Int
+        let sampleTime: TimeInterval
+        /// False for a debug build; nil in reports written before it was recorded
+        let optimized: Bool?
+    }
+
+    /// What makes this run's numbers not comparable with `baseline`'s
+    func differences(from baseline: Report) -> [String] {
+        var differences: [String] = []
+        func check<T: Equatable>(_ label: String, _ current: T, _ previous: T) {
+            if current != previous {
+                differences.append("\(label): \(previous) → \(current)")
+            }
+        }
+        check("system", host.system, baseline.host.system)
+        check("architecture", host.architecture, baseline.host.architecture)
+        check("processors", host.processors, baseline.host.processors)
+        check("crc32", host.crc32, baseline.host.crc32)
+        if let optimized = configuration.optimized, let previous = baseline.configuration.optimized {
+            check("optimized", optimized, previous)
+        }
+        return differences
+    }
+
+    func json() throws -> Data {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        encoder.dateEncodingStrategy = .iso8601
+        return try encoder.encode(self)
+    }
+
+    static func load(from url: URL) throws -> Report {
+        let decoder = JSONDecoder()
+        decoder.dateDecodingStrategy = .iso8601
+        return try decoder.decode(Report.self, from: Data(contentsOf: url))
+    }
+}
+
+// MARK: - Baseline Comparison
+
+/// How one benchmark moved against a baseline run
+struct Comparison {
+    enum Verdict: String {
+        case faster, slower, unchanged, new
+    }
+
+    let name: String
+    let baseline: Statistics?
+    let current: Statistics
+    let verdict: Verdict
+
+    /// Change in median time; positive is slower
+    var change: Double? {
+        baseline.map { ($0.median > 0) ? current.median / $0.median - 1 : 0 }
+    }
+
+    /// A change counts only if it beats `threshold` and three times the noise of either run
+    static func compare(_ report: Report, against baseline: Report, threshold: Double) -> [Comparison] {
+        let previous = Dictionary(baseline.results.map { ($0.name, $0.statistics) }, uniquingKeysWith: { first, _ in first })
+        return report.results.map { result in
+            let current = result.statistics
+            guard let old = previous[result.name] else {
+                return Comparison(name: result.name, baseline: nil, current: current, verdict: .new)
+            }
+            let delta = current.median - old.median
+            let noise = 3 * Swift.max(old.mad, current.mad)
+            let significant = abs(delta) > noise && abs(delta) > threshold * old.median
+            let verdict: Verdict = !significant ? .unchanged : (delta > 0 ? .slower : .faster)
+            return Comparison(name: result.name, baseline: old, current: current, verdict: verdict)
+        }
+    }
+}
+
+// MARK: - Formatting
+
+enum Format {
+    static func duration(_ nanoseconds: Double) -> String {
+        switch nanoseconds {
+        case ..<1_000: return String(format: "%.1f ns", nanoseconds)
+        case ..<1_000_000: return String(format: "%.2f µs", nanoseconds / 1_000)
+        case ..<1_000_000_000: return String(format: "%.2f ms", nanoseconds / 1_000_000)
+        default: return String(format: "%.2f s", nanoseconds / 1_000_000_000)
+        }
+    }
+
+    static func throughput(_ bytesPerSecond: Double?) -> String {
+        guard let bytesPerSecond else { return "" }
+        if bytesPerSecond >= 1 << 30 {
+            return String(format: "%.2f GB/s", bytesPerSecond / Double(1 << 30))
+        }
+        return String(format: "%.1f MB/s", bytesPerSecond / Double(1 << 20))
+    }
+
+    static func pad(_ text: String, _ width: Int) -> String {
+        text.count >= width ? text : text + String(repeating: " ", count: width - text.count)
+    }
+
+    static func padLeft(_ text: String, _ width: Int) -> String {
+        text.count >= width ? text : String(repeating: " ", count: width - text.count) + text
+    }
+}
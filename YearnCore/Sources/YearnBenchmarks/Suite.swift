@@ -0,0 +1,379 @@
+//
+//  Suite.swift
+//  YearnBenchmarks
+//
+//  The YearnCore hot paths we measure
+//
+
+import Foundation
+import CLibretro
+import CYearnSupport
+import YearnCore
+
+enum Suite {
+
+    /// Every benchmark, in report order
+    static func all() -> [Benchmark] {
+        audio() + rewind() + pixels() + video() + input() + cheats() + hashing() + atlas() + scan()
+    }
+
+    // MARK: - Audio
+
+    /// One 60 Hz frame of 44.1 kHz stereo through the ring, in and out
+    private static func audio() -> [Benchmark] {
+        let samples = 735 * 2
+        let ring = AudioRingBuffer(capacity: 8192)
+        let input = UnsafeMutablePointer<Int16>.allocate(capacity: samples)
+        let output = UnsafeMutablePointer<Int16>.allocate(capacity: samples)
+        for i in 0..<samples {
+            input[i] = Int16(truncatingIfNeeded: i &* 97)
+        }
+        // Split per channel, as the AVAudioEngine output reads it
+        let left = UnsafeMutablePointer<Int16>.allocate(capacity: samples / 2)
+        let right = UnsafeMutablePointer<Int16>.allocate(capacity: samples / 2)
+        let channels = UnsafeMutablePointer<UnsafeMutablePointer<Int16>>.allocate(capacity: 2)
+        channels[0] = left
+        channels[1] = right
+
+        return [
+            Benchmark("audio.ring.write+read", bytesPerOperation: samples * 2) { count in
+                for _ in 0..<count {
+                    ring.write(input, count: samples)
+                    blackHole(ring.read(output, count: samples))
+                }
+            },
+            Benchmark("audio.ring.write+readFrames stereo", bytesPerOperation: samples * 2) { count in
+                for _ in 0..<count {
+                    ring.write(input, count: samples)
+                    blackHole(ring.readFrames(samples / 2, channels: 2, into: channels))
+                }
+            }
+        ]
+    }
+
+    // MARK: - Rewind
+
+    /// A 256 KB save state: zeroed RAM, repeated tiles and noisy registers
+    private static func saveState(seed: UInt64) -> Data {
+        var random = SplitMix(seed: seed)
+        var bytes = [UInt8](repeating: 0, count: 256 * 1024)
+        for i in stride(from: 0, to: bytes.count, by: 4096) {
+            switch (i / 4096) % 4 {
+            case 0:
+                continue
+            case 1:
+                let tile = (0..<16).map { _ in random.byte() }
+                for j in 0..<4096 { bytes[i + j] = tile[j % 16] }
+            default:
+                for j in 0..<4096 { bytes[i + j] = random.byte() }
+            }
+        }
+        return Data(bytes)
+    }
+
+    private static func rewind() -> [Benchmark] {
+        let state = saveState(seed: 1)
+        let configuration = RewindManager.Configuration(maxStates: 60, captureInterval: 1, maxMemoryUsage: 0)
+
+        let capturing = RewindManager(configuration: configuration)
+
+        let restoring = RewindManager(configuration: configuration)
+        for seed in 0..<UInt64(configuration.maxStates) {
+            restoring.captureState(saveState(seed: seed))
+        }
+        var position: Float = 0
+
+        return [
+            // Compresses the state and trims the history
+            Benchmark("rewind.capture", bytesPerOperation: state.count) { count in
+                for _ in 0..<count {
+                    capturing.captureState(state)
+                }
+            },
+            // Decompresses a stored state
+            Benchmark("rewind.restore", bytesPerOperation: state.count) { count in
+                for _ in 0..<count {
+                    position = position >= 1 ? 0 : position + 0.1
+                    blackHole(restoring.getState(atProgress: position))
+                }
+            }
+        ]
+    }
+
+    // MARK: - Pixel Conversion
+
+    private static func pixels() -> [Benchmark] {
+        let cases: [(String, LibretroPixelFormat, Int, Int)] = [
+            ("pixel.rgb565->bgra 256x224", .rgb565, 256, 224),
+            ("pixel.rgb1555->bgra 320x240", .rgb1555, 320, 240),
+            ("pixel.xrgb8888->bgra 320x240", .xrgb8888, 320, 240),
+        ]
+        return cases.map { name, format, width, height in
+            // Padded source rows, as most cores hand them over
+            let pitch = (width * format.bytesPerPixel + 63) & ~63
+            let source = filledBuffer(count: pitch * height, seed: 2)
+            let destination = UnsafeMutableRawPointer.allocate(byteCount: width * height * 4, alignment: 16)
+            return Benchmark(name, bytesPerOperation: width * height * 4) { count in
+                for _ in 0..<count {
+                    PixelConversion.convertToBGRA(source, width: width, height: height, pitch: pitch,
+                                                  format: format, into: destination)
+                }
+                blackHole(destination.load(as: UInt32.self))
+            }
+        }
+    }
+
+    // MARK: - Video Buffer
+
+    private static func video() -> [Benchmark] {
+        let buffer = VideoBuffer(width: 256, height: 224, pixelFormat: .rgb565)
+        let packed = filledBuffer(count: buffer.bytesPerRow * buffer.height, seed: 3)
+        let paddedPitch = 1024
+        let padded = filledBuffer(count: paddedPitch * buffer.height, seed: 4)
+
+        return [
+            Benchmark("video.copyFrom packed 256x224", bytesPerOperation: buffer.bytesPerRow * buffer.height) { count in
+                for _ in 0..<count {
+                    buffer.copyFrom(packed, bytesPerRow: buffer.bytesPerRow)
+                }
+            },
+            Benchmark("video.copyFrom strided 256x224", bytesPerOperation: buffer.bytesPerRow * buffer.height) { count in
+                for _ in 0..<count {
+                    buffer.copyFrom(padded, bytesPerRow: paddedPitch)
+                }
+            }
+        ]
+    }
+
+    // MARK: - Input
+
+    /// What a core asks each frame: every joypad button one by one, then the mask
+    private static func input() -> [Benchmark] {
+        let bridge = StaticLibretroBridge()
+        bridge.setInput(port: 0, button: .a, pressed: true)
+        bridge.setInput(port: 0, button: .right, pressed: true)
+        let device = UInt32(RETRO_DEVICE_JOYPAD)
+        let mask = UInt32(RETRO_DEVICE_ID_JOYPAD_MASK)
+
+        return [
+            Benchmark("input.state 16 buttons + mask") { count in
+                var pressed = 0
+                for _ in 0..<count {
+                    for id in 0..<UInt32(16) {
+                        pressed &+= Int(bridge.inputState(port: 0, device: device, index: 0, id: id))
+                    }
+                    pressed &+= Int(bridge.inputState(port: 0, device: device, index: 0, id: mask))
+                }
+                blackHole(pressed)
+            }
+        ]
+    }
+
+    // MARK: - Cheats
+
+    private static func cheats() -> [Benchmark] {
+        let codes: [(String, CheatFormat)] = [
+            ("SXIOPO", .gameGenie),
+            ("AAEAULPA", .gameGenie),
+            ("YEUZUGAA", .gameGenie),
+            ("7E0DBE:63", .raw),
+            ("7E1A2B:FF", .raw),
+            ("7E0DBE0063", .actionReplay),
+            ("8010C24E 0063", .gameShark),
+            ("82025BD4 03E7", .codeBreaker),
+        ]
+
+        return [
+            Benchmark("cheat.parse 8 codes") { count in
+                for _ in 0..<count {
+                    for (code, format) in codes {
+                        blackHole(CheatCodeParser.parse(code: code, format: format))
+                    }
+                }
+            }
+        ]
+    }
+
+    // MARK: - Hashing
+
+    private static func hashing() -> [Benchmark] {
+        let size = 1 << 20
+        let bytes = filledBuffer(count: size, seed: 5)
+        let data = Data(bytes: bytes, count: size)
+
+        var benchmarks = [
+            Benchmark("crc32.slicing-by-8 1 MB", bytesPerOperation: size) { count in
+                var crc: UInt32 = 0
+                for _ in 0..<count {
+                    crc = yearn_crc32_with(YEARN_CRC32_TABLE, crc, bytes, size)
+                }
+                blackHole(crc)
+            }
+        ]
+        let best = yearn_crc32_best_impl()
+        if best != YEARN_CRC32_TABLE {
+            benchmarks.append(Benchmark("crc32.\(ROMHasher.crc32Implementation) 1 MB", bytesPerOperation: size) { count in
+                var crc: UInt32 = 0
+                for _ in 0..<count {
+                    crc = yearn_crc32_with(best, crc, bytes, size)
+                }
+                blackHole(crc)
+            })
+        }
+        benchmarks.append(Benchmark("hash.crc32+md5+sha1 1 MB", bytesPerOperation: size) { count in
+            for _ in 0..<count {
+                blackHole(ROMHasher.hash(data: data))
+            }
+        })
+        return benchmarks
+    }
+
+    // MARK: - Cover Atlas
+
+    /// A 5,000-cover library in an atlas laid out as the app lays out covers
+    private static func atlas() -> [Benchmark] {
+        let library = 5000
+        let url = FileManager.default.temporaryDirectory
+            .appendingPathComponent("YearnBenchmarks-\(ProcessInfo.processInfo.processIdentifier).atlas")
+        try? FileManager.default.removeItem(at: url)
+        guard let atlas = try? ThumbnailAtlas(url: url, slotSize: ThumbnailAtlas.coverSlotSize) else {
+            FileHandle.standardError.write(Data("Could not create \(url.path); skipping the atlas\n".utf8))
+            return []
+        }
+        // The open descriptor keeps the file; nothing is left in the temporary directory
+        try? FileManager.default.removeItem(at: url)
+        atlas.maxTiles = ThumbnailAtlas.coverTileLimit
+
+        // 20-40 KB tiles, the size of real 480 px covers; JPEG data does not compress, nor does this
+        var random = SplitMix(seed: 6)
+        let pool = filledBuffer(count: 1 << 20, seed: 7)
+        let ids = (0..<library).map { _ in UUID() }
+        for id in ids {
+            let size = 20 * 1024 + Int(random.next() % UInt64(20 * 1024))
+            let offset = Int(random.next() % UInt64((1 << 20) - size))
+            try? atlas.store(Data(bytes: pool + offset, count: size), for: id)
+        }
+        guard atlas.count == library else {
+            fatalError("The cover atlas kept \(atlas.count) of \(library) covers")
+        }
+
+        var next = 0
+        let screen = 30
+        return [
+            // One screenful of covers, from a different part of the library each time
+            Benchmark("atlas.tile 30 of 5000 covers") { count in
+                for _ in 0..<count {
+                    for i in 0..<screen {
+                        blackHole(atlas.tile(for: ids[(next + i * 167) % library]))
+                    }
+                    next = (next + screen) % library
+                }
+            }
+        ]
+    }
+
+    // MARK: - Library Scan
+
+    /// Scratch folder of the scan benchmarks; removed when the process exits
+    private static let scanRoot = FileManager.default.temporaryDirectory
+        .appendingPathComponent("YearnBenchmarks-\(ProcessInfo.processInfo.processIdentifier)-ROMs", isDirectory: true)
+
+    /// A 10,000-ROM library in 100 folders, scanned with and without the scan cache
+    private static func scan() -> [Benchmark] {
+        let library = 10_000
+        let folders = 100
+        let romSize = 4096
+        let roms = scanRoot.appendingPathComponent("ROMs", isDirectory: true)
+        let pool = filledBuffer(count: 1 << 20, seed: 8)
+        do {
+            for folder in 0..<folders {
+                let directory = roms.appendingPathComponent("System \(folder)", isDirectory: true)
+                try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+                for rom in 0..<(library / folders) {
+                    let offset = (folder * 977 + rom * 131) % ((1 << 20) - romSize)
+                    try Data(bytes: pool + offset, count: romSize)
+                        .write(to: directory.appendingPathComponent("Game \(rom).gba"))
+                }
+            }
+        } catch {
+            FileHandle.standardError.write(Data("Could not create \(roms.path): \(error); skipping the scan\n".utf8))
+            return []
+        }
+        atexit {
+            try? FileManager.default.removeItem(at: Suite.scanRoot)
+        }
+
+        let scanner = LibraryScanner(root: roms, cacheURL: scanRoot.appendingPathComponent("LibraryScan.plist"))
+        let scanOnce = {
+            wait {
+                await scanner.scan(filter: { $0 },
+                                   classify: { $0.pathExtension == "gba" ? "gba" : nil },
+                                   onBatch: { _ in })
+            }
+            guard scanner.statistics.files == library else {
+                fatalError("The scan found \(scanner.statistics.files) of \(library) ROMs")
+            }
+        }
+        scanOnce()
+
+        return [
+            // Every file classified and hashed, as on first launch or after the cache was purged
+            Benchmark("scan.cold 10000 ROMs", bytesPerOperation: library * romSize) { count in
+                for _ in 0..<count {
+                    scanner.invalidate()
+                    scanOnce()
+                }
+            },
+            // Nothing changed: one lstat per file against the cache
+            Benchmark("scan.warm 10000 ROMs") { count in
+                for _ in 0..<count {
+                    scanOnce()
+                }
+            },
+        ]
+    }
+
+    /// Run `operation` to completion from synchronous benchmark code
+    private static func wait(_ operation: @escaping @Sendable () async -> Void) {
+        let done = DispatchSemaphore(value: 0)
+        Task.detached {
+            await operation()
+            done.signal()
+        }
+        done.wait()
+    }
+
+    // MARK: - Data
+
+    /// Deterministic pseudo-random bytes; kept for the life of the process
+    private static func filledBuffer(count: Int, seed: UInt64) -> UnsafeMutableRawPointer {
+        let buffer = UnsafeMutableRawPointer.allocate(byteCount: count, alignment: 64)
+        var random = SplitMix(seed: seed)
+        let bytes = buffer.assumingMemoryBound(to: UInt8.self)
+        for i in 0..<count {
+            bytes[i] = random.byte()
+        }
+        return buffer
+    }
+}
+
+/// SplitMix64, so every run measures the same bytes
+struct SplitMix {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+
+    mutating func byte() -> UInt8 {
+        UInt8(truncatingIfNeeded: next() >> 56)
+    }
+}
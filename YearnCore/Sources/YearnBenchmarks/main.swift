@@ -0,0 +1,183 @@
+//
+//  main.swift
+//  YearnBenchmarks
+//
+//  Microbenchmarks for YearnCore hot paths
+//
+//  swift run -c release YearnBenchmarks [options]
+//
+//    --filter TEXT        Run only benchmarks whose name contains TEXT
+//    --list               Print benchmark names and exit
+//    --warmup N           Samples thrown away first (default 5)
+//    --iterations N       Samples measured (default 25)
+//    --sample-time MS     Target length of one sample (default 10)
+//    --json PATH          Write the report as JSON; "-" for standard output
+//    --baseline PATH      Compare against a report written by --json
+//    --threshold PERCENT  Smallest change worth reporting (default 5)
+//
+//  With --baseline the exit status is 1 when anything got slower.
+//
+
+import Foundation
+import YearnCore
+
+// MARK: - Options
+
+struct Options {
+    var filter: String?
+    var list = false
+    var runner = Runner()
+    var jsonPath: String?
+    var baselinePath: String?
+    var threshold = 0.05
+
+    init(_ arguments: [String]) throws {
+        var arguments = arguments[...]
+        func value(for flag: String) throws -> String {
+            guard let value = arguments.popFirst() else { throw UsageError("\(flag) needs a value") }
+            return value
+        }
+        func number(for flag: String) throws -> Double {
+            let text = try value(for: flag)
+            guard let number = Double(text), number >= 0 else { throw UsageError("\(flag): not a number: \(text)") }
+            return number
+        }
+
+        while let flag = arguments.popFirst() {
+            switch flag {
+            case "--filter": filter = try value(for: flag)
+            case "--list": list = true
+            case "--warmup": runner.warmup = Int(try number(for: flag))
+            case "--iterations": runner.iterations = max(1, Int(try number(for: flag)))
+            case "--sample-time": runner.sampleTime = try number(for: flag) / 1000
+            case "--json": jsonPath = try value(for: flag)
+            case "--baseline": baselinePath = try value(for: flag)
+            case "--threshold": threshold = try number(for: flag) / 100
+            default: throw UsageError("Unknown option \(flag)")
+            }
+        }
+    }
+}
+
+struct UsageError: Error, CustomStringConvertible {
+    let description: String
+    init(_ description: String) { self.description = description }
+}
+
+/// Human-readable output; goes to standard error when the JSON report takes standard output
+func say(_ line: String, to options: Options) {
+    if options.jsonPath == "-" {
+        FileHandle.standardError.write(Data((line + "\n").utf8))
+    } else {
+        print(line)
+    }
+}
+
+// MARK: - Main
+
+let options: Options
+do {
+    options = try Options(Array(CommandLine.arguments.dropFirst()))
+} catch {
+    FileHandle.standardError.write(Data("\(error)\nSee the top of main.swift for options.\n".utf8))
+    exit(2)
+}
+
+let benchmarks = Suite.all().filter { benchmark in
+    options.filter.map { benchmark.name.contains($0) } ?? true
+}
+if options.list {
+    benchmarks.forEach { print($0.name) }
+    exit(0)
+}
+
+#if DEBUG
+say("warning: debug build; use swift run -c release for meaningful numbers", to: options)
+#endif
+
+let nameWidth = max(32, benchmarks.map(\.name.count).max() ?? 0) + 2
+var results: [Runner.Result] = []
+for benchmark in benchmarks {
+    let result = options.runner.measure(benchmark)
+    results.append(result)
+    let stats = result.statistics
+    say(Format.pad(result.name, nameWidth)
+        + Format.padLeft(Format.duration(stats.median), 12)
+        + Format.padLeft("± " + Format.duration(stats.mad), 14)
+        + Format.padLeft(String(format: "(%.1f%%)", stats.relativeMAD * 100), 9)
+        + Format.padLeft(Format.throughput(result.bytesPerSecond), 13), to: options)
+}
+
+let report = Report(
+    formatVersion: Report.formatVersion,
+    date: Date(),
+    host: Report.Host(
+        system: ProcessInfo.processInfo.operatingSystemVersionString,
+        architecture: {
+            #if arch(arm64)
+            return "arm64"
+            #elseif arch(x86_64)
+            return "x86_64"
+            #else
+            return "unknown"
+            #endif
+        }(),
+        processors: ProcessInfo.processInfo.activeProcessorCount,
+        crc32: ROMHasher.crc32Implementation
+    ),
+    configuration: Report.Configuration(
+        warmup: options.runner.warmup,
+        iterations: options.runner.iterations,
+        sampleTime: options.runner.sampleTime,
+        optimized: {
+            #if DEBUG
+            return false
+            #else
+            return true
+            #endif
+        }()
+    ),
+    results: results
+)
+
+if let path = options.jsonPath {
+    do {
+        let json = try report.json()
+        if path == "-" {
+            FileHandle.standardOutput.write(json)
+            FileHandle.standardOutput.write(Data("\n".utf8))
+        } else {
+            try json.write(to: URL(fileURLWithPath: path), options: .atomic)
+        }
+    } catch {
+        FileHandle.standardError.write(Data("Could not write report: \(error)\n".utf8))
+        exit(1)
+    }
+}
+
+if let path = options.baselinePath {
+    let baseline: Report
+    do {
+        baseline = try Report.load(from: URL(fileURLWithPath: path))
+    } catch {
+        FileHandle.standardError.write(Data("Could not read baseline \(path): \(error)\n".utf8))
+        exit(1)
+    }
+
+    let comparisons = Comparison.compare(report, against: baseline, threshold: options.threshold)
+    say("\nAgainst \(path) (\(baseline.host.architecture), \(baseline.date)):", to: options)
+    // Numbers from another machine or build say nothing about the code; flag it rather than refuse
+    for difference in report.differences(from: baseline) {
+        say("warning: baseline differs in \(difference)", to: options)
+    }
+    for comparison in comparisons {
+        let change = comparison.change.map { String(format: "%+.1f%%", $0 * 100) } ?? ""
+        let before = comparison.baseline.map { Format.duration($0.median) } ?? "-"
+        say(Format.pad(comparison.name, nameWidth)
+            + Format.padLeft(before, 12) + " → " + Format.pad(Format.duration(comparison.current.median), 12)
+            + Format.padLeft(change, 9) + "  " + comparison.verdict.rawValue, to: options)
+    }
+    if comparisons.contains(where: { $0.verdict == .slower }) {
+        exit(1)
+    }
+}
@@ -0,0 +1,267 @@
+//
+//  ROMArchiveCache.swift
+//  YearnCore
+//
+//  Extracts ROMs from archives into a size-limited on-disk cache
+//
+
+import Foundation
+
+/// Cache of ROMs extracted from ZIP archives
+///
+/// Extracted files are stored under `Caches/ExtractedROMs/<key>/`, where the key
+/// is derived from the CRC32 and size the archive records for each extracted
+/// entry. Renaming or moving an archive therefore still hits, and two archives
+/// holding the same ROM share one copy. Entries are evicted least recently
+/// used first once the cache grows past `maxCacheSize`.
+public final class ROMArchiveCache: @unchecked Sendable {
+
+    public static let shared = ROMArchiveCache()
+
+    /// Archive formats the library recognises
+    public static let archiveExtensions: Set<String> = ["zip", "7z"]
+
+    /// Extensions that describe a multi-file disc image and pull in their track files
+    private static let sheetExtensions: Set<String> = ["cue", "ccd", "m3u"]
+
+    /// Counters for cache effectiveness and decompression speed
+    public struct Statistics {
+        public var hits = 0
+        public var misses = 0
+        public var bytesExtracted: UInt64 = 0
+        public var extractionTime: TimeInterval = 0
+
+        public var hitRate: Double {
+            let total = hits + misses
+            return total > 0 ? Double(hits) / Double(total) : 0
+        }
+
+        /// Decompression throughput in MB/s
+        public var throughput: Double {
+            extractionTime > 0 ? Double(bytesExtracted) / 1_048_576 / extractionTime : 0
+        }
+    }
+
+    // MARK: - Properties
+
+    /// Maximum size of extracted ROMs kept on disk
+    public var maxCacheSize: UInt64 = 4 * 1024 * 1024 * 1024
+
+    public let cacheDirectory: URL
+
+    private let fileManager = FileManager.default
+    private let queue = DispatchQueue(label: "com.yearn.archive-extract", qos: .userInitiated)
+    private let lock = NSLock()
+    private var stats = Statistics()
+
+    // MARK: - Initialization
+
+    private init() {
+        let cachesURL = fileManager.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        cacheDirectory = cachesURL.appendingPathComponent("ExtractedROMs", isDirectory: true)
+        try? fileManager.createDirectory(at: cacheDirectory, withIntermediateDirectories: true)
+    }
+
+    // MARK: - Public Methods
+
+    public static func isArchive(_ url: URL) -> Bool {
+        archiveExtensions.contains(url.pathExtension.lowercased())
+    }
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Choose the entry to launch from an archive
+    /// Cue/ccd/m3u sheets win over their track files; otherwise the largest
+    /// entry with a supported extension is used
+    public static func launchEntry(in archive: ZipArchive, supportedExtensions: [String]) -> ZipEntry? {
+        let supported = Set(supportedExtensions.map { $0.lowercased() })
+        let candidates = archive.files.filter { supported.contains($0.pathExtension) }
+
+        if let sheet = candidates.first(where: { sheetExtensions.contains($0.pathExtension) }) {
+            return sheet
+        }
+        return candidates.max { $0.uncompressedSize < $1.uncompressedSize }
+    }
+
+    /// Extract the launchable ROM from an archive, reusing a cached copy when possible
+    /// - Parameters:
+    ///   - archiveURL: ZIP archive to open
+    ///   - supportedExtensions: Extensions the target system can load
+    ///   - progress: Called on a background queue with the extracted fraction (0...1)
+    /// - Returns: URL of the extracted ROM (or cue sheet)
+    public func extract(archiveURL: URL,
+                        supportedExtensions: [String],
+                        progress: ((Double) -> Void)? = nil) async throws -> URL {
+        try await withCheckedThrowingContinuation { continuation in
+            queue.async {
+                do {
+                    let url = try self.extractSync(archiveURL: archiveURL,
+                                                   supportedExtensions: supportedExtensions,
+                                                   progress: progress)
+                    continuation.resume(returning: url)
+                } catch {
+                    continuation.resume(throwing: error)
+                }
+            }
+        }
+    }
+
+    /// Blocking variant of `extract(archiveURL:supportedExtensions:progress:)`
+    public func extractSync(archiveURL: URL,
+                            supportedExtensions: [String],
+                            progress: ((Double) -> Void)? = nil) throws -> URL {
+        guard archiveURL.pathExtension.lowercased() == "zip" else {
+            throw ArchiveError.unsupportedFormat(archiveURL.pathExtension.uppercased())
+        }
+
+        let archive = try ZipArchive(url: archiveURL)
+        guard let launch = Self.launchEntry(in: archive, supportedExtensions: supportedExtensions) else {
+            throw ArchiveError.noROMFound
+        }
+
+        // A sheet needs every file next to it; a plain ROM is extracted alone
+        let selected = Self.sheetExtensions.contains(launch.pathExtension) ? archive.files : [launch]
+        guard let launchPath = launch.relativePath else {
+            throw ArchiveError.corrupt("unsafe path \(launch.name)")
+        }
+        let key = cacheKey(for: selected)
+        let directory = cacheDirectory.appendingPathComponent(key, isDirectory: true)
+        let launchURL = directory.appendingPathComponent(launchPath)
+
+        if fileManager.fileExists(atPath: launchURL.path) {
+            touch(directory)
+            record { $0.hits += 1 }
+            Log.archive.debug("Archive cache hit: \(launch.fileName)")
+            progress?(1)
+            return launchURL
+        }
+
+        // Extract into a scratch directory and rename at the end, so an
+        // interrupted extraction never looks like a cache hit
+        let partial = cacheDirectory.appendingPathComponent(key + ".partial", isDirectory: true)
+        try? fileManager.removeItem(at: partial)
+        try fileManager.createDirectory(at: partial, withIntermediateDirectories: true)
+
+        let totalBytes = max(selected.reduce(UInt64(0)) { $0 + $1.uncompressedSize }, 1)
+        var completedBytes: UInt64 = 0
+        let start = Date()
+
+        do {
+            for entry in selected {
+                // Keep the layout a sheet's relative references expect, but never leave `partial`
+                guard let path = entry.relativePath else {
+                    throw ArchiveError.corrupt("unsafe path \(entry.name)")
+                }
+                let destination = partial.appendingPathComponent(path)
+                try fileManager.createDirectory(at: destination.deletingLastPathComponent(), withIntermediateDirectories: true)
+                try archive.extract(entry, to: destination) { written in
+                    progress?(Double(completedBytes + written) / Double(totalBytes))
+                }
+                completedBytes += entry.uncompressedSize
+            }
+            try? fileManager.removeItem(at: directory)
+            try fileManager.moveItem(at: partial, to: directory)
+        } catch {
+            try? fileManager.removeItem(at: partial)
+            throw error
+        }
+
+        let elapsed = Date().timeIntervalSince(start)
+        record {
+            $0.misses += 1
+            $0.bytesExtracted += completedBytes
+            $0.extractionTime += elapsed
+        }
+
+        let current = statistics
+        Log.archive.info("Extracted \(launch.fileName): \(completedBytes / 1024) KB in \(String(format: "%.0f", elapsed * 1000)) ms "
+                         + "(\(String(format: "%.1f", current.throughput)) MB/s avg, hit rate \(String(format: "%.0f", current.hitRate * 100))%)")
+
+        evictIfNeeded(keeping: key)
+        return launchURL
+    }
+
+    /// Remove every extracted ROM
+    public func clear() {
+        try? fileManager.removeItem(at: cacheDirectory)
+        try? fileManager.createDirectory(at: cacheDirectory, withIntermediateDirectories: true)
+    }
+
+    /// Total size of extracted ROMs on disk
+    public func cacheSize() -> UInt64 {
+        cachedItems().reduce(0) { $0 + $1.size }
+    }
+
+    // MARK: - Private
+
+    private func record(_ update: (inout Statistics) -> Void) {
+        lock.lock()
+        update(&stats)
+        lock.unlock()
+    }
+
+    /// Content key for a set of entries, independent of the archive's name
+    private func cacheKey(for entries: [ZipEntry]) -> String {
+        if entries.count == 1, let entry = entries.first {
+            return String(format: "%08x-%llx", entry.crc32, entry.uncompressedSize)
+        }
+
+        // FNV-1a over the sorted entry descriptions
+        var hash: UInt64 = 0xcbf29ce484222325
+        let description = entries
+            .map { "\($0.relativePath ?? $0.name):\($0.crc32):\($0.uncompressedSize)" }
+            .sorted()
+            .joined(separator: "|")
+        for byte in description.utf8 {
+            hash ^= UInt64(byte)
+            hash = hash &* 0x100000001b3
+        }
+        return String(format: "set-%016llx", hash)
+    }
+
+    /// Mark an entry as recently used
+    private func touch(_ directory: URL) {
+        try? fileManager.setAttributes([.modificationDate: Date()], ofItemAtPath: directory.path)
+    }
+
+    private func cachedItems() -> [(url: URL, size: UInt64, date: Date)] {
+        let keys: [URLResourceKey] = [.contentModificationDateKey, .isDirectoryKey]
+        guard let directories = try? fileManager.contentsOfDirectory(at: cacheDirectory,
+                                                                     includingPropertiesForKeys: keys) else {
+            return []
+        }
+
+        return directories.compactMap { directory in
+            guard directory.pathExtension != "partial",
+                  let values = try? directory.resourceValues(forKeys: Set(keys)),
+                  values.isDirectory == true else {
+                return nil
+            }
+
+            let files = (try? fileManager.contentsOfDirectory(at: directory,
+                                                              includingPropertiesForKeys: [.fileSizeKey])) ?? []
+            let size = files.reduce(UInt64(0)) { total, file in
+                total + UInt64((try? file.resourceValues(forKeys: [.fileSizeKey]).fileSize) ?? 0)
+            }
+            return (directory, size, values.contentModificationDate ?? .distantPast)
+        }
+    }
+
+    private func evictIfNeeded(keeping key: String) {
+        var items = cachedItems()
+        var total = items.reduce(UInt64(0)) { $0 + $1.size }
+        guard total > maxCacheSize else { return }
+
+        items.sort { $0.date < $1.date }
+        for item in items where total > maxCacheSize {
+            guard item.url.lastPathComponent != key else { continue }
+            try? fileManager.removeItem(at: item.url)
+            total -= item.size
+            Log.archive.debug("Evicted extracted ROM: \(item.url.lastPathComponent)")
+        }
+    }
+}
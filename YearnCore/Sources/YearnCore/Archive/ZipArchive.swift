@@ -0,0 +1,403 @@
+//
+//  ZipArchive.swift
+//  YearnCore
+//
+//  Streaming reader for ZIP archives
+//
+
+import Foundation
+import CYearnSupport
+
+/// Errors raised while reading ROM archives
+public enum ArchiveError: LocalizedError {
+    case notAnArchive
+    case corrupt(String)
+    case encrypted(String)
+    case unsupportedMethod(UInt16)
+    case unsupportedFormat(String)
+    case checksumMismatch(String)
+    case noROMFound
+    case writeFailed(String)
+
+    public var errorDescription: String? {
+        switch self {
+        case .notAnArchive:
+            return "File is not a ZIP archive"
+        case .corrupt(let reason):
+            return "Archive is damaged: \(reason)"
+        case .encrypted(let name):
+            return "\(name) is password protected"
+        case .unsupportedMethod(let method):
+            return "Unsupported compression method \(method)"
+        case .unsupportedFormat(let format):
+            return "\(format) archives can only be opened by cores that read them directly"
+        case .checksumMismatch(let name):
+            return "CRC mismatch while extracting \(name)"
+        case .noROMFound:
+            return "No compatible ROM found in archive"
+        case .writeFailed(let reason):
+            return "Failed to extract ROM: \(reason)"
+        }
+    }
+}
+
+/// A file stored in a ZIP archive
+public struct ZipEntry {
+    /// Path inside the archive
+    public let name: String
+
+    /// Compression method (0 = stored, 8 = deflate)
+    public let method: UInt16
+
+    /// CRC32 of the uncompressed data, as recorded by the archiver
+    public let crc32: UInt32
+
+    public let compressedSize: UInt64
+    public let uncompressedSize: UInt64
+
+    let flags: UInt16
+    let localHeaderOffset: UInt64
+
+    public var isDirectory: Bool {
+        name.hasSuffix("/")
+    }
+
+    /// File name without any directories
+    public var fileName: String {
+        NSString(string: name).lastPathComponent
+    }
+
+    public var pathExtension: String {
+        NSString(string: name).pathExtension.lowercased()
+    }
+
+    /// `name` as a relative path that stays inside the extraction directory
+    ///
+    /// Backslashes count as separators and empty or "." components are
+    /// dropped. Nil for absolute paths, drive letters and any "..".
+    public var relativePath: String? {
+        guard !name.hasPrefix("/"), !name.hasPrefix("\\") else { return nil }
+        let components = name.split(whereSeparator: { $0 == "/" || $0 == "\\" })
+            .filter { $0 != "." }
+        guard !components.isEmpty,
+              !components.contains(".."),
+              !(components[0].count == 2 && components[0].hasSuffix(":")) else {
+            return nil
+        }
+        return components.joined(separator: "/")
+    }
+}
+
+/// Read-only ZIP archive
+///
+/// Only the central directory is read up front; entries are decoded in
+/// fixed-size chunks so extracting a large disc image never holds more than
+/// one input and one output chunk in memory. Stored and deflate entries are
+/// supported, including ZIP64 archives.
+public final class ZipArchive {
+
+    /// Chunk size used for reading and inflating
+    static let chunkSize = 1 << 20
+
+    public let url: URL
+    public private(set) var entries: [ZipEntry] = []
+
+    private let handle: FileHandle
+    private let fileSize: UInt64
+
+    // MARK: - Initialization
+
+    public init(url: URL) throws {
+        self.url = url
+        do {
+            self.handle = try FileHandle(forReadingFrom: url)
+            self.fileSize = try handle.seekToEnd()
+        } catch {
+            throw ArchiveError.notAnArchive
+        }
+        self.entries = try readCentralDirectory()
+    }
+
+    deinit {
+        try? handle.close()
+    }
+
+    /// Entries that are files rather than directories
+    public var files: [ZipEntry] {
+        entries.filter { !$0.isDirectory }
+    }
+
+    // MARK: - Extraction
+
+    /// Extract an entry to a file, verifying its CRC
+    /// - Parameters:
+    ///   - entry: Entry to extract
+    ///   - destination: File to create (replaced if it exists)
+    ///   - progress: Called with the number of uncompressed bytes written so far
+    public func extract(_ entry: ZipEntry, to destination: URL, progress: ((UInt64) -> Void)? = nil) throws {
+        guard entry.flags & 0x1 == 0 else {
+            throw ArchiveError.encrypted(entry.name)
+        }
+        guard entry.method == 0 || entry.method == 8 else {
+            throw ArchiveError.unsupportedMethod(entry.method)
+        }
+
+        let dataOffset = try dataOffset(of: entry)
+
+        FileManager.default.createFile(atPath: destination.path, contents: nil)
+        guard let output = try? FileHandle(forWritingTo: destination) else {
+            throw ArchiveError.writeFailed("cannot create \(destination.lastPathComponent)")
+        }
+        defer { try? output.close() }
+
+        try handle.seek(toOffset: dataOffset)
+
+        var crc: UInt32 = 0
+        var written: UInt64 = 0
+
+        let write: (UnsafeRawBufferPointer) throws -> Void = { bytes in
+            guard bytes.count > 0 else { return }
+            crc = yearn_inflate_crc32(crc, bytes.bindMemory(to: UInt8.self).baseAddress, bytes.count)
+            do {
+                try output.write(contentsOf: Data(bytes))
+            } catch {
+                throw ArchiveError.writeFailed(error.localizedDescription)
+            }
+            written += UInt64(bytes.count)
+            progress?(written)
+        }
+
+        if entry.method == 0 {
+            var remaining = entry.compressedSize
+            while remaining > 0 {
+                let count = Int(min(remaining, UInt64(Self.chunkSize)))
+                guard let chunk = try handle.read(upToCount: count), chunk.count == count else {
+                    throw ArchiveError.corrupt("truncated entry \(entry.name)")
+                }
+                try chunk.withUnsafeBytes(write)
+                remaining -= UInt64(count)
+            }
+        } else {
+            try inflate(entry, write: write)
+        }
+
+        guard written == entry.uncompressedSize else {
+            throw ArchiveError.corrupt("size mismatch in \(entry.name)")
+        }
+        guard crc == entry.crc32 else {
+            throw ArchiveError.checksumMismatch(entry.name)
+        }
+    }
+
+    // MARK: - Private
+
+    private func inflate(_ entry: ZipEntry, write: (UnsafeRawBufferPointer) throws -> Void) throws {
+        guard let stream = yearn_inflate_create() else {
+            throw ArchiveError.writeFailed("out of memory")
+        }
+        defer { yearn_inflate_destroy(stream) }
+
+        let outputBuffer = UnsafeMutablePointer<UInt8>.allocate(capacity: Self.chunkSize)
+        defer { outputBuffer.deallocate() }
+
+        var remaining = entry.compressedSize
+        var finished = false
+
+        while !finished {
+            let count = Int(min(remaining, UInt64(Self.chunkSize)))
+            guard count > 0 else {
+                throw ArchiveError.corrupt("unexpected end of \(entry.name)")
+            }
+            guard let input = try handle.read(upToCount: count), input.count == count else {
+                throw ArchiveError.corrupt("truncated entry \(entry.name)")
+            }
+            remaining -= UInt64(count)
+
+            try input.withUnsafeBytes { (inputBytes: UnsafeRawBufferPointer) in
+                guard let base = inputBytes.bindMemory(to: UInt8.self).baseAddress else { return }
+                var offset = 0
+
+                // Drain everything this chunk can produce before reading more
+                while !finished {
+                    var consumed = 0
+                    var produced = 0
+                    let result = yearn_inflate_run(stream,
+                                                   base + offset,
+                                                   inputBytes.count - offset,
+                                                   &consumed,
+                                                   outputBuffer,
+                                                   Self.chunkSize,
+                                                   &produced)
+                    if result == YEARN_INFLATE_ERROR {
+                        throw ArchiveError.corrupt("invalid deflate data in \(entry.name)")
+                    }
+                    offset += consumed
+                    try write(UnsafeRawBufferPointer(start: outputBuffer, count: produced))
+
+                    if result == YEARN_INFLATE_STREAM_END {
+                        finished = true
+                    } else if offset == inputBytes.count && produced < Self.chunkSize {
+                        break
+                    }
+                }
+            }
+        }
+    }
+
+    /// Offset of the entry's data, past its local header
+    private func dataOffset(of entry: ZipEntry) throws -> UInt64 {
+        let header = try read(at: entry.localHeaderOffset, count: 30)
+        guard header.le32(0) == 0x04034b50 else {
+            throw ArchiveError.corrupt("bad local header for \(entry.name)")
+        }
+        let nameLength = UInt64(header.le16(26))
+        let extraLength = UInt64(header.le16(28))
+        return entry.localHeaderOffset + 30 + nameLength + extraLength
+    }
+
+    private func read(at offset: UInt64, count: Int) throws -> [UInt8] {
+        // Offsets come from the archive, so a crafted one must not overflow the sum
+        guard UInt64(count) <= fileSize, offset <= fileSize - UInt64(count) else {
+            throw ArchiveError.corrupt("read past end of file")
+        }
+        try handle.seek(toOffset: offset)
+        guard let data = try handle.read(upToCount: count), data.count == count else {
+            throw ArchiveError.corrupt("short read")
+        }
+        return [UInt8](data)
+    }
+
+    private func readCentralDirectory() throws -> [ZipEntry] {
+        // End of central directory record: 22 bytes plus up to 64 KB of comment
+        let tailLength = Int(min(fileSize, 22 + 0xFFFF))
+        guard tailLength >= 22 else { throw ArchiveError.notAnArchive }
+        let tailStart = fileSize - UInt64(tailLength)
+        let tail = try read(at: tailStart, count: tailLength)
+
+        var eocd = -1
+        var index = tailLength - 22
+        while index >= 0 {
+            if tail.le32(index) == 0x06054b50 {
+                eocd = index
+                break
+            }
+            index -= 1
+        }
+        guard eocd >= 0 else { throw ArchiveError.notAnArchive }
+
+        var entryCount = UInt64(tail.le16(eocd + 10))
+        var directorySize = UInt64(tail.le32(eocd + 12))
+        var directoryOffset = UInt64(tail.le32(eocd + 16))
+
+        // ZIP64: the real values live in a separate record found via the locator
+        if entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF {
+            guard tailStart + UInt64(eocd) >= 20 else {
+                throw ArchiveError.corrupt("missing ZIP64 locator")
+            }
+            let locatorOffset = tailStart + UInt64(eocd) - 20
+            let locator = try read(at: locatorOffset, count: 20)
+            guard locator.le32(0) == 0x07064b50 else {
+                throw ArchiveError.corrupt("missing ZIP64 locator")
+            }
+            let record = try read(at: locator.le64(8), count: 56)
+            guard record.le32(0) == 0x06064b50 else {
+                throw ArchiveError.corrupt("bad ZIP64 end record")
+            }
+            entryCount = record.le64(32)
+            directorySize = record.le64(40)
+            directoryOffset = record.le64(48)
+        }
+
+        guard directorySize <= UInt64(Int.max) else {
+            throw ArchiveError.corrupt("central directory too large")
+        }
+        let directory = try read(at: directoryOffset, count: Int(directorySize))
+
+        var entries: [ZipEntry] = []
+        entries.reserveCapacity(Int(min(entryCount, 65_536)))
+
+        var position = 0
+        for _ in 0..<entryCount {
+            guard position + 46 <= directory.count, directory.le32(position) == 0x02014b50 else {
+                throw ArchiveError.corrupt("bad central directory entry")
+            }
+
+            let flags = directory.le16(position + 8)
+            let method = directory.le16(position + 10)
+            let crc = directory.le32(position + 16)
+            var compressedSize = UInt64(directory.le32(position + 20))
+            var uncompressedSize = UInt64(directory.le32(position + 24))
+            let nameLength = Int(directory.le16(position + 28))
+            let extraLength = Int(directory.le16(position + 30))
+            let commentLength = Int(directory.le16(position + 32))
+            var localOffset = UInt64(directory.le32(position + 42))
+
+            let nameStart = position + 46
+            let extraStart = nameStart + nameLength
+            let next = extraStart + extraLength + commentLength
+            guard next <= directory.count else {
+                throw ArchiveError.corrupt("truncated central directory")
+            }
+
+            let nameBytes = directory[nameStart..<extraStart]
+            let name: String
+            if flags & 0x800 != 0 {
+                name = String(decoding: nameBytes, as: UTF8.self)
+            } else {
+                name = String(bytes: nameBytes, encoding: .isoLatin1) ?? String(decoding: nameBytes, as: UTF8.self)
+            }
+
+            // ZIP64 extended information extra field
+            var extra = extraStart
+            while extra + 4 <= extraStart + extraLength {
+                let id = directory.le16(extra)
+                let size = Int(directory.le16(extra + 2))
+                guard extra + 4 + size <= extraStart + extraLength else {
+                    throw ArchiveError.corrupt("extra field overruns entry \(name)")
+                }
+                if id == 0x0001 {
+                    var field = extra + 4
+                    if uncompressedSize == 0xFFFFFFFF, field + 8 <= extra + 4 + size {
+                        uncompressedSize = directory.le64(field)
+                        field += 8
+                    }
+                    if compressedSize == 0xFFFFFFFF, field + 8 <= extra + 4 + size {
+                        compressedSize = directory.le64(field)
+                        field += 8
+                    }
+                    if localOffset == 0xFFFFFFFF, field + 8 <= extra + 4 + size {
+                        localOffset = directory.le64(field)
+                    }
+                }
+                extra += 4 + size
+            }
+
+            entries.append(ZipEntry(name: name,
+                                    method: method,
+                                    crc32: crc,
+                                    compressedSize: compressedSize,
+                                    uncompressedSize: uncompressedSize,
+                                    flags: flags,
+                                    localHeaderOffset: localOffset))
+            position = next
+        }
+
+        return entries
+    }
+}
+
+// MARK: - Little-endian Reads
+
+private extension Array where Element == UInt8 {
+    func le16(_ offset: Int) -> UInt16 {
+        UInt16(self[offset]) | UInt16(self[offset + 1]) << 8
+    }
+
+    func le32(_ offset: Int) -> UInt32 {
+        UInt32(le16(offset)) | UInt32(le16(offset + 2)) << 16
+    }
+
+    func le64(_ offset: Int) -> UInt64 {
+        UInt64(le32(offset)) | UInt64(le32(offset + 4)) << 32
+    }
+}
@@ -6,7 +6,6 @@
 //
 
 import Foundation
-import AVFoundation
 
 /// Thread-safe ring buffer for audio samples
 public final class AudioRingBuffer {
@@ -27,11 +26,7 @@ public final class AudioRingBuffer {
         lock.lock()
         defer { lock.unlock() }
         
-        if writeIndex >= readIndex {
-            return writeIndex - readIndex
-        } else {
-            return capacity - readIndex + writeIndex
-        }
+        return storedSamples
     }
     
     /// Number of samples that can be written
@@ -39,12 +34,21 @@ public final class AudioRingBuffer {
         return capacity - availableSamples - 1
     }
     
+    /// Samples between the read and write index; callers hold `lock`, which is not recursive
+    private var storedSamples: Int {
+        if writeIndex >= readIndex {
+            return writeIndex - readIndex
+        } else {
+            return capacity - readIndex + writeIndex
+        }
+    }
+    
     /// Write samples to the buffer
     public func write(_ samples: UnsafePointer<Int16>, count: Int) {
         lock.lock()
         defer { lock.unlock() }
         
-        let toWrite = min(count, availableSpace)
+        let toWrite = min(count, capacity - storedSamples - 1)
         
         for i in 0..<toWrite {
             buffer[writeIndex] = samples[i]
@@ -52,20 +56,19 @@ public final class AudioRingBuffer {
         }
     }
     
-    /// Read samples into an AVAudioPCMBuffer
-    public func read(into pcmBuffer: AVAudioPCMBuffer) -> Int {
+    /// Read whole frames of interleaved samples, one destination per channel
+    /// - Returns: Frames read
+    public func readFrames(
+        _ frameCapacity: Int,
+        channels: Int,
+        into channelData: UnsafePointer<UnsafeMutablePointer<Int16>>
+    ) -> Int {
         lock.lock()
         defer { lock.unlock() }
         
-        let available = availableSamples
-        let toRead = min(Int(pcmBuffer.frameCapacity), available)
-        
-        guard toRead > 0,
-              let channelData = pcmBuffer.int16ChannelData else {
-            return 0
-        }
-        
-        let channels = Int(pcmBuffer.format.channelCount)
+        guard channels > 0 else { return 0 }
+        let toRead = min(frameCapacity, storedSamples / channels)
+        guard toRead > 0 else { return 0 }
         
         for i in 0..<toRead {
             for channel in 0..<channels {
@@ -84,7 +87,7 @@ public final class AudioRingBuffer {
         lock.lock()
         defer { lock.unlock() }
         
-        let toRead = min(count, availableSamples)
+        let toRead = min(count, storedSamples)
         
         for i in 0..<toRead {
             destination[i] = buffer[readIndex]
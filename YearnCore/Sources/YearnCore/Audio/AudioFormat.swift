@@ -0,0 +1,30 @@
+//
+//  AudioFormat.swift
+//  YearnCore
+//
+//  Sample layout of core audio output
+//
+
+import Foundation
+
+/// Audio format specification
+public struct AudioFormat: Sendable {
+    public let sampleRate: Double
+    public let channels: Int
+    public let bitsPerSample: Int
+    public let interleaved: Bool
+    
+    public init(sampleRate: Double, channels: Int, bitsPerSample: Int = 16, interleaved: Bool = true) {
+        self.sampleRate = sampleRate
+        self.channels = channels
+        self.bitsPerSample = bitsPerSample
+        self.interleaved = interleaved
+    }
+    
+    /// Common audio formats for different systems
+    public static let nes = AudioFormat(sampleRate: 44100, channels: 1)
+    public static let snes = AudioFormat(sampleRate: 32000, channels: 2)
+    public static let gba = AudioFormat(sampleRate: 32768, channels: 2)
+    public static let n64 = AudioFormat(sampleRate: 44100, channels: 2)
+    public static let ps1 = AudioFormat(sampleRate: 44100, channels: 2)
+}
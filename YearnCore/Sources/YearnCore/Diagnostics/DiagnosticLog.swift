@@ -0,0 +1,168 @@
+//
+//  DiagnosticLog.swift
+//  YearnCore
+//
+//  Recent log messages kept in memory for diagnostic reports
+//
+
+import Foundation
+import CYearnSupport
+
+/// The last few hundred log messages, backed by `yearn_log`
+///
+/// Writing never blocks or allocates in C, so the emulation thread and a
+/// core's own log calls can record freely; a snapshot can be taken from any
+/// thread, including while the writer is stuck, which is what a hang report
+/// needs. Oldest messages are overwritten.
+public final class DiagnosticLog: @unchecked Sendable {
+
+    public static let shared = DiagnosticLog(capacity: 1024)
+
+    /// Same values as `retro_log_level`
+    public enum Level: UInt32, Comparable, Sendable {
+        case debug = 0
+        case info = 1
+        case warning = 2
+        case error = 3
+
+        public static func < (lhs: Level, rhs: Level) -> Bool {
+            lhs.rawValue < rhs.rawValue
+        }
+
+        public var label: String {
+            switch self {
+            case .debug: return "DEBUG"
+            case .info: return "INFO"
+            case .warning: return "WARN"
+            case .error: return "ERROR"
+            }
+        }
+    }
+
+    public struct Entry: Sendable {
+        /// Position in everything ever recorded
+        public let ticket: UInt64
+        /// Host time (`CACurrentMediaTime()` on Apple platforms)
+        public let timestamp: TimeInterval
+        public let level: Level
+        public let category: String
+        public let message: String
+
+        public var formatted: String {
+            String(format: "%.3f", timestamp) + " [\(level.label)] \(category): \(message)"
+        }
+    }
+
+    private let ring: OpaquePointer
+    private let lock = NSLock()
+    private var echoTimer: DispatchSourceTimer?
+    /// First ticket the console echo has not written yet; only used on the echo queue
+    private var nextEchoTicket: UInt64 = 0
+
+    // MARK: - Initialization
+
+    /// - Parameter capacity: Messages kept; rounded up to a power of two
+    public init(capacity: Int) {
+        guard let ring = yearn_log_ring_create(UInt32(clamping: capacity)) else {
+            fatalError("Out of memory allocating log ring")
+        }
+        self.ring = ring
+    }
+
+    deinit {
+        echoTimer?.cancel()
+        yearn_log_set_core_ring(nil)
+        yearn_log_ring_destroy(ring)
+    }
+
+    // MARK: - Public Methods
+
+    /// Host time on the clock entries are stamped with
+    public static var now: TimeInterval {
+        yearn_log_now()
+    }
+
+    /// Record a message; any thread. Long messages are cut to 223 bytes.
+    public func record(_ level: Level, category: String, _ message: String) {
+        category.withCString { category in
+            message.withCString { message in
+                yearn_log_ring_write(ring, yearn_log_now(), level.rawValue, category, message)
+            }
+        }
+    }
+
+    /// Up to `limit` of the newest messages, oldest first
+    public func entries(limit: Int = 512) -> [Entry] {
+        guard limit > 0 else { return [] }
+        var raw = [yearn_log_entry](repeating: yearn_log_entry(), count: limit)
+        let count = yearn_log_ring_snapshot(ring, &raw, limit)
+        return raw.prefix(count).map { entry in
+            Entry(
+                ticket: entry.ticket,
+                timestamp: entry.timestamp,
+                level: Level(rawValue: entry.level) ?? .info,
+                category: Self.string(entry.category),
+                message: Self.string(entry.message)
+            )
+        }
+    }
+
+    /// Messages lost because two writers met in one slot
+    public var dropped: UInt64 {
+        yearn_log_ring_dropped(ring)
+    }
+
+    // MARK: - Console
+
+    /// Write new messages to standard error every `interval` seconds
+    /// Writing happens on a utility queue, so writers never wait on the console.
+    public func startConsoleEcho(interval: TimeInterval = 0.25) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard echoTimer == nil else { return }
+
+        let timer = DispatchSource.makeTimerSource(queue: DispatchQueue(label: "com.yearn.log.echo", qos: .utility))
+        timer.schedule(deadline: .now() + interval, repeating: interval, leeway: .milliseconds(50))
+        timer.setEventHandler { [weak self] in
+            self?.echoNewEntries()
+        }
+        timer.resume()
+        echoTimer = timer
+    }
+
+    private func echoNewEntries() {
+        let fresh = entries().filter { $0.ticket >= nextEchoTicket }
+        guard let first = fresh.first, let last = fresh.last else { return }
+
+        var lines: [String] = []
+        if first.ticket > nextEchoTicket {
+            lines.append("… \(first.ticket - nextEchoTicket) log message(s) overwritten before they were shown")
+        }
+        for entry in fresh {
+            let level = entry.level >= .warning ? "\(entry.level.label) " : ""
+            lines.append("[\(entry.category)] \(level)\(entry.message)")
+        }
+        nextEchoTicket = last.ticket + 1
+        // Straight to the file descriptor: print would take stdout's lock and buffer
+        FileHandle.standardError.write(Data((lines.joined(separator: "\n") + "\n").utf8))
+    }
+
+    // MARK: - Core Messages
+
+    /// Answer RETRO_ENVIRONMENT_GET_LOG_INTERFACE so the core's messages land
+    /// in this log under category "core"
+    public func provideCoreLogInterface(_ data: UnsafeMutableRawPointer?) -> Bool {
+        guard let data = data else { return false }
+        yearn_log_set_core_ring(ring)
+        return yearn_log_provide_interface(data.assumingMemoryBound(to: retro_log_callback.self)) == 0
+    }
+
+    // MARK: - Private
+
+    private static func string<T>(_ field: T) -> String {
+        withUnsafeBytes(of: field) { bytes in
+            let end = bytes.firstIndex(of: 0) ?? bytes.count
+            return String(decoding: bytes[..<end], as: UTF8.self)
+        }
+    }
+}
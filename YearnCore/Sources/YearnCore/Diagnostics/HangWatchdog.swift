@@ -0,0 +1,215 @@
+//
+//  HangWatchdog.swift
+//  YearnCore
+//
+//  Notices a frame that does not finish and records where it is stuck
+//
+
+import Foundation
+import CYearnSupport
+
+/// Watches the emulation thread's frame heartbeat from a thread of its own
+///
+/// The emulation loop marks each frame begun and published through
+/// `FrameStateStore`. When one frame has run for `budgetMultiple` frame
+/// budgets (and at least `minimumStall`), the watchdog captures the
+/// emulation thread's backtrace while it is still stuck, the recent frame
+/// times and the diagnostic log, and calls `onHang`. If the frame finishes
+/// after all, `onRecovered` follows with the same report.
+///
+/// Between frames nothing is watched, so pausing, backgrounding or a late
+/// display link never look like a hang. Callbacks run on the watchdog's
+/// queue; since the emulation thread may never come back, `onHang` should
+/// write down whatever must survive a kill right there.
+public final class HangWatchdog: @unchecked Sendable {
+
+    public struct Configuration: Sendable {
+        /// Seconds one frame should take, e.g. 1/60
+        public var frameBudget: TimeInterval
+        /// Frame budgets a frame may take before it counts as hung
+        public var budgetMultiple: Double = 30
+        /// Never report a stall shorter than this, whatever the budget
+        public var minimumStall: TimeInterval = 0.5
+        /// How often the heartbeat is checked
+        public var pollInterval: TimeInterval = 0.1
+
+        public init(frameBudget: TimeInterval = 1.0 / 60.0) {
+            self.frameBudget = frameBudget
+        }
+
+        /// Seconds a frame may run before it is reported
+        public var threshold: TimeInterval {
+            max(frameBudget * budgetMultiple, minimumStall)
+        }
+    }
+
+    public struct Report: Sendable {
+        public let detectedAt: Date
+        /// How long the frame had run when it was caught
+        public let stalledFor: TimeInterval
+        /// Frames finished before the stuck one
+        public let frames: UInt64
+        /// The emulation thread's return addresses, innermost first, symbolicated where possible
+        public let backtrace: [String]
+        /// Frames before the stuck one and the work between them, oldest first
+        public let recentTimings: [FrameStateStore.Timing]
+        public let log: [DiagnosticLog.Entry]
+
+        /// Plain text for a report file
+        public var text: String {
+            var lines = [
+                "Hung frame detected \(ISO8601DateFormatter().string(from: detectedAt))",
+                String(format: "Frame running for %.2f s after %llu frames", stalledFor, frames),
+                "",
+                "Emulation thread:",
+            ]
+            lines += backtrace.enumerated().map { String(format: "%3d  ", $0.offset) + $0.element }
+
+            if !recentTimings.isEmpty {
+                // Save states are marked so a slow one is not read as a slow frame
+                let milliseconds = recentTimings.map { timing in
+                    (timing.work == .saveState ? "save:" : "") + String(format: "%.1f", timing.duration * 1000)
+                }
+                let frames = recentTimings.filter { $0.work == .frame }
+                let slowest = (frames.map(\.duration).max() ?? 0) * 1000
+                lines += ["", String(format: "Last %d frame and save state times (ms, slowest frame %.1f):", recentTimings.count, slowest)]
+                lines.append(milliseconds.joined(separator: " "))
+            }
+
+            lines += ["", "Log:"]
+            lines += log.map(\.formatted)
+            return lines.joined(separator: "\n") + "\n"
+        }
+    }
+
+    // MARK: - Properties
+
+    public let configuration: Configuration
+
+    /// Called on the watchdog queue when a frame has run past the threshold; set before `start`
+    public var onHang: (@Sendable (Report) -> Void)?
+
+    /// Called on the watchdog queue when a reported frame finished after all,
+    /// with how long it took in total
+    public var onRecovered: (@Sendable (Report, TimeInterval) -> Void)?
+
+    private let frameState: FrameStateStore
+    private let log: DiagnosticLog
+    private let queue = DispatchQueue(label: "com.yearn.hangwatchdog", qos: .userInteractive)
+    private let lock = NSLock()
+    private var timer: DispatchSourceTimer?
+    /// The emulation thread; only used on `queue`
+    private var thread: OpaquePointer?
+    /// Start of the frame last reported, and its report; only used on `queue`
+    private var reported: (since: TimeInterval, report: Report)?
+
+    // MARK: - Initialization
+
+    public init(frameState: FrameStateStore, configuration: Configuration = Configuration(), log: DiagnosticLog = .shared) {
+        self.frameState = frameState
+        self.configuration = configuration
+        self.log = log
+    }
+
+    deinit {
+        timer?.cancel()
+        if let thread {
+            yearn_thread_release(thread)
+        }
+    }
+
+    // MARK: - Public Methods
+
+    /// Start watching; call on the thread that runs frames
+    public func start() {
+        let current = yearn_thread_current()
+
+        lock.lock()
+        defer { lock.unlock() }
+        guard timer == nil else {
+            yearn_thread_release(current)
+            return
+        }
+
+        // The handle and report are only touched on the queue, where checks run
+        queue.async { [self] in
+            if let thread {
+                yearn_thread_release(thread)
+            }
+            thread = current
+            reported = nil
+        }
+
+        let interval = configuration.pollInterval
+        let timer = DispatchSource.makeTimerSource(queue: queue)
+        timer.schedule(deadline: .now() + interval, repeating: interval, leeway: .milliseconds(20))
+        timer.setEventHandler { [weak self] in
+            self?.check()
+        }
+        timer.resume()
+        self.timer = timer
+    }
+
+    public func stop() {
+        lock.lock()
+        timer?.cancel()
+        timer = nil
+        lock.unlock()
+
+        queue.async { [self] in
+            if let thread {
+                yearn_thread_release(thread)
+            }
+            thread = nil
+            reported = nil
+        }
+    }
+
+    // MARK: - Private
+
+    private func check() {
+        let since = frameState.inFrameSince
+
+        if let previous = reported, since != previous.since {
+            // The stuck frame was published: it came back
+            let sample = frameState.sample
+            let took = sample.timestamp > previous.since ? sample.timestamp - previous.since : previous.report.stalledFor
+            reported = nil
+            log.record(.warning, category: "watchdog", String(format: "Hung frame finished after %.2f s", took))
+            onRecovered?(previous.report, took)
+        }
+
+        guard let since, let thread, reported == nil else { return }
+        let stalled = DiagnosticLog.now - since
+        guard stalled >= configuration.threshold else { return }
+
+        // Capture first, while the thread is still where it got stuck
+        let backtrace = Self.backtrace(of: thread)
+        log.record(.error, category: "watchdog", String(format: "Frame running for %.2f s", stalled))
+        let report = Report(
+            detectedAt: Date(),
+            stalledFor: stalled,
+            frames: frameState.sample.frames,
+            backtrace: backtrace,
+            recentTimings: frameState.recentTimings(),
+            log: log.entries()
+        )
+        reported = (since, report)
+        onHang?(report)
+    }
+
+    private static func backtrace(of thread: OpaquePointer) -> [String] {
+        var frames = [UInt](repeating: 0, count: 64)
+        let count = yearn_thread_backtrace(thread, &frames, Int32(frames.count))
+        guard count > 0 else {
+            return ["<backtrace unavailable: \(String(cString: strerror(errno)))>"]
+        }
+
+        var name = [CChar](repeating: 0, count: 256)
+        return frames.prefix(Int(count)).map { address in
+            let hex = String(format: "0x%016lx", address)
+            guard yearn_symbolicate(address, &name, name.count) == 0 else { return hex }
+            return "\(hex) \(String(cString: name))"
+        }
+    }
+}
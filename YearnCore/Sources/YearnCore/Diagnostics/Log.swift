@@ -0,0 +1,91 @@
+//
+//  Log.swift
+//  YearnCore
+//
+//  Leveled logging by subsystem into the diagnostic log
+//
+
+import Foundation
+
+/// A subsystem to log under, such as `Log.video` or `Log.library`
+///
+/// Messages are autoclosures, so nothing is interpolated unless the level is
+/// compiled in. `debug` only exists in debug builds: elsewhere its body is
+/// empty, and once inlined the call and its message disappear. Messages go
+/// to `DiagnosticLog.shared`, which never blocks or does I/O on the calling
+/// thread; in debug builds a background echo prints them to the console a
+/// few times a second. Hang reports include the log.
+///
+/// The app adds its own subsystems in an extension, like the ones below.
+public struct Log: Sendable {
+    public let category: String
+
+    public init(_ category: String) {
+        self.category = category
+    }
+
+    /// Whether `debug` messages are compiled in; guard work done only to log with it
+    @inlinable
+    public static var isDebugEnabled: Bool {
+        #if DEBUG
+        return true
+        #else
+        return false
+        #endif
+    }
+
+    // MARK: - Levels
+
+    /// Detail for development: per-frame, per-file and per-symbol chatter. Debug builds only.
+    @inlinable
+    public func debug(_ message: @autoclosure () -> String) {
+        #if DEBUG
+        write(.debug, message())
+        #endif
+    }
+
+    /// Milestones worth having in a hang report: a core or game loaded, a scan finished
+    @inlinable
+    public func info(_ message: @autoclosure () -> String) {
+        write(.info, message())
+    }
+
+    /// Something went wrong and was worked around
+    @inlinable
+    public func warning(_ message: @autoclosure () -> String) {
+        write(.warning, message())
+    }
+
+    /// Something failed
+    @inlinable
+    public func error(_ message: @autoclosure () -> String) {
+        write(.error, message())
+    }
+
+    @usableFromInline
+    func write(_ level: DiagnosticLog.Level, _ message: String) {
+        Log.sink.record(level, category: category, message)
+    }
+
+    private static let sink: DiagnosticLog = {
+        let log = DiagnosticLog.shared
+        #if DEBUG
+        log.startConsoleEcho()
+        #endif
+        return log
+    }()
+}
+
+// MARK: - Subsystems
+
+extension Log {
+    public static let core = Log("core")
+    public static let video = Log("video")
+    public static let audio = Log("audio")
+    public static let input = Log("input")
+    public static let disc = Log("disc")
+    public static let archive = Log("archive")
+    public static let library = Log("library")
+    public static let sync = Log("sync")
+    public static let memory = Log("memory")
+}
@@ -0,0 +1,251 @@
+//
+//  CHDImage.swift
+//  YearnCore
+//
+//  CHD disc images with a decoded-hunk cache
+//
+
+import Foundation
+import CYearnSupport
+
+/// A CHD CD image
+///
+/// Tracks are exposed as plain BIN data (`readTrack`) so the disc layer can
+/// present them to cores as ordinary CUE/BIN files. Decoded hunks are kept in
+/// an LRU cache; a miss decodes the following hunks too, spread across cores,
+/// since disc reads are overwhelmingly sequential.
+public final class CHDImage: @unchecked Sendable {
+
+    public struct Track {
+        public let number: Int
+        public let mode: DiscTrackMode
+        /// Frames in the track, including a stored pregap
+        public let frames: Int
+        /// Pregap frames stored at the start of the track
+        public let pregap: Int
+        /// First frame of the track inside the CHD
+        public let startFrame: Int
+    }
+
+    // MARK: - Properties
+
+    public let url: URL
+    public private(set) var tracks: [Track] = []
+
+    /// Whether every hunk can be decoded here; if not, the core's own reader must be used
+    public let isSupported: Bool
+
+    /// Maximum decoded hunks kept in memory (~19 KB each for CD images)
+    public var maxCachedHunks = 256
+
+    /// Hunks decoded together on a cache miss
+    public var decodeBatch = 8
+
+    public private(set) var hunksDecoded = 0
+    public private(set) var cacheHits = 0
+
+    private let handle: OpaquePointer
+    private let hunkBytes: Int
+    private let hunkCount: UInt32
+    private let framesPerHunk: Int
+
+    private let lock = NSLock()
+    private var cache: [UInt32: Data] = [:]
+    private var lastUse: [UInt32: UInt64] = [:]
+    private var clock: UInt64 = 0
+
+    // MARK: - Initialization
+
+    public init(url: URL) throws {
+        self.url = url
+
+        var error = YEARN_CHD_OK
+        guard let handle = yearn_chd_open(url.path, &error) else {
+            switch error {
+            case YEARN_CHD_ERROR_UNSUPPORTED:
+                throw DiscImageError.unsupported("CHD version")
+            case YEARN_CHD_ERROR_FILE:
+                throw DiscImageError.unreadable(url.lastPathComponent)
+            default:
+                throw DiscImageError.invalidSheet("damaged CHD \(url.lastPathComponent)")
+            }
+        }
+        self.handle = handle
+
+        let header = yearn_chd_get_header(handle).pointee
+        hunkBytes = Int(header.hunk_bytes)
+        hunkCount = header.hunk_count
+        framesPerHunk = Int(header.hunk_bytes) / Int(YEARN_CHD_FRAME_SIZE)
+
+        var supported = yearn_chd_is_supported(handle) != 0 && header.unit_bytes == UInt32(YEARN_CHD_FRAME_SIZE)
+        if supported {
+            do {
+                tracks = try readTrackTable()
+            } catch {
+                supported = false
+            }
+        }
+        isSupported = supported && !tracks.isEmpty
+    }
+
+    deinit {
+        yearn_chd_close(handle)
+    }
+
+    // MARK: - Reading
+
+    /// Read bytes from a track laid out as a BIN file (`mode.sectorSize` bytes per sector)
+    /// - Returns: Bytes copied, or -1 on a decode error
+    public func readTrack(_ index: Int, offset: UInt64, into buffer: UnsafeMutableRawPointer, length: Int) -> Int {
+        guard tracks.indices.contains(index) else { return -1 }
+        let track = tracks[index]
+        let sectorSize = track.mode.sectorSize
+        let trackBytes = UInt64(track.frames * sectorSize)
+        guard offset < trackBytes else { return 0 }
+
+        let total = Int(min(UInt64(length), trackBytes - offset))
+        var copied = 0
+        var swapped = [UInt8](repeating: 0, count: Int(YEARN_CHD_SECTOR_SIZE))
+
+        while copied < total {
+            let position = offset + UInt64(copied)
+            let frame = track.startFrame + Int(position / UInt64(sectorSize))
+            let inSector = Int(position % UInt64(sectorSize))
+            let count = min(sectorSize - inSector, total - copied)
+
+            guard let hunk = hunk(UInt32(frame / framesPerHunk)) else { return copied > 0 ? copied : -1 }
+            let frameOffset = (frame % framesPerHunk) * Int(YEARN_CHD_FRAME_SIZE)
+
+            hunk.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+                let sector = bytes.baseAddress! + frameOffset
+                if track.mode == .audio {
+                    // CHD stores CD audio big-endian; BIN files are little-endian
+                    for i in stride(from: 0, to: sectorSize, by: 2) {
+                        swapped[i] = sector.load(fromByteOffset: i + 1, as: UInt8.self)
+                        swapped[i + 1] = sector.load(fromByteOffset: i, as: UInt8.self)
+                    }
+                    swapped.withUnsafeBytes { source in
+                        (buffer + copied).copyMemory(from: source.baseAddress! + inSector, byteCount: count)
+                    }
+                } else {
+                    (buffer + copied).copyMemory(from: sector + inSector, byteCount: count)
+                }
+            }
+            copied += count
+        }
+
+        return copied
+    }
+
+    /// Decoded hunk, from the cache or decoded together with the hunks after it
+    func hunk(_ number: UInt32) -> Data? {
+        guard number < hunkCount else { return nil }
+
+        lock.lock()
+        if let data = cache[number] {
+            clock += 1
+            lastUse[number] = clock
+            cacheHits += 1
+            lock.unlock()
+            return data
+        }
+        let batch = (number..<min(number + UInt32(decodeBatch), hunkCount)).filter { cache[$0] == nil }
+        lock.unlock()
+
+        // Hunks are compressed independently, so a batch decodes in parallel
+        var decoded = [Data?](repeating: nil, count: batch.count)
+        let hunkBytes = self.hunkBytes
+        let handle = self.handle
+        decoded.withUnsafeMutableBufferPointer { results in
+            let results = results
+            DispatchQueue.concurrentPerform(iterations: batch.count) { i in
+                var data = Data(count: hunkBytes)
+                let status = data.withUnsafeMutableBytes { bytes in
+                    yearn_chd_read_hunk(handle, batch[i], bytes.bindMemory(to: UInt8.self).baseAddress)
+                }
+                if status == YEARN_CHD_OK {
+                    results[i] = data
+                }
+            }
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+        for (i, hunk) in batch.enumerated() {
+            guard let data = decoded[i] else { continue }
+            clock += 1
+            cache[hunk] = data
+            lastUse[hunk] = clock
+            hunksDecoded += 1
+        }
+        let result = cache[number]
+        evictIfNeeded()
+        return result
+    }
+
+    // MARK: - Private
+
+    /// Caller holds `lock`
+    private func evictIfNeeded() {
+        guard cache.count > maxCachedHunks else { return }
+        let excess = cache.count - maxCachedHunks
+        for (hunk, _) in lastUse.sorted(by: { $0.value < $1.value }).prefix(excess) {
+            cache[hunk] = nil
+            lastUse[hunk] = nil
+        }
+    }
+
+    private func readTrackTable() throws -> [Track] {
+        var tracks: [Track] = []
+        var frame = 0
+        let capacity = 256
+        var buffer = [CChar](repeating: 0, count: capacity)
+
+        for tag in [UInt32(YEARN_CHD_TRACK_METADATA2_TAG), UInt32(YEARN_CHD_TRACK_METADATA_TAG)] {
+            var index: UInt32 = 0
+            while yearn_chd_get_metadata(handle, tag, index, &buffer, capacity) >= 0 {
+                let fields = Self.metadataFields(String(cString: buffer))
+                guard let number = fields["TRACK"].flatMap(Int.init),
+                      let frames = fields["FRAMES"].flatMap(Int.init),
+                      let type = fields["TYPE"] else {
+                    throw DiscImageError.invalidSheet("bad CHD track metadata")
+                }
+
+                let mode: DiscTrackMode
+                switch type {
+                case "AUDIO": mode = .audio
+                case "MODE1": mode = .mode1_2048
+                case "MODE1_RAW": mode = .mode1_2352
+                case "MODE2", "MODE2_FORM_MIX": mode = .mode2_2336
+                case "MODE2_RAW": mode = .mode2_2352
+                default: throw DiscImageError.unsupported("CHD track type \(type)")
+                }
+
+                // A pregap type starting with V means the pregap frames are stored in the track
+                let pregapStored = fields["PGTYPE"]?.hasPrefix("V") ?? false
+                let pregap = pregapStored ? (fields["PREGAP"].flatMap(Int.init) ?? 0) : 0
+
+                tracks.append(Track(number: number, mode: mode, frames: frames, pregap: pregap, startFrame: frame))
+
+                let padding = Int(YEARN_CHD_TRACK_PADDING)
+                frame += (frames + padding - 1) / padding * padding
+                index += 1
+            }
+            if !tracks.isEmpty { break }
+        }
+
+        return tracks.sorted { $0.number < $1.number }
+    }
+
+    /// "TRACK:1 TYPE:MODE2_RAW ..." to a dictionary
+    private static func metadataFields(_ text: String) -> [String: String] {
+        var fields: [String: String] = [:]
+        for token in text.split(separator: " ") {
+            let pair = token.split(separator: ":", maxSplits: 1)
+            if pair.count == 2 {
+                fields[String(pair[0])] = String(pair[1])
+            }
+        }
+        return fields
+    }
+}
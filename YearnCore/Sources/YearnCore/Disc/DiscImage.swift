@@ -0,0 +1,319 @@
+//
+//  DiscImage.swift
+//  YearnCore
+//
+//  Track tables for CUE/BIN, CCD/IMG and CHD disc images
+//
+
+import Foundation
+
+/// Errors raised while reading disc images
+public enum DiscImageError: LocalizedError {
+    case unreadable(String)
+    case invalidSheet(String)
+    case missingTrackFile(String)
+    case unsupported(String)
+
+    public var errorDescription: String? {
+        switch self {
+        case .unreadable(let name):
+            return "Cannot read disc image \(name)"
+        case .invalidSheet(let reason):
+            return "Invalid disc sheet: \(reason)"
+        case .missingTrackFile(let name):
+            return "Missing track file \(name)"
+        case .unsupported(let reason):
+            return "Unsupported disc image: \(reason)"
+        }
+    }
+}
+
+/// Sector layout of a track, named as in CUE sheets
+public enum DiscTrackMode: String {
+    case audio = "AUDIO"
+    case mode1_2048 = "MODE1/2048"
+    case mode1_2352 = "MODE1/2352"
+    case mode2_2336 = "MODE2/2336"
+    case mode2_2352 = "MODE2/2352"
+
+    /// Bytes per sector in the track file
+    public var sectorSize: Int {
+        switch self {
+        case .mode1_2048: return 2048
+        case .mode2_2336: return 2336
+        case .audio, .mode1_2352, .mode2_2352: return 2352
+        }
+    }
+}
+
+/// One track of a disc image
+public struct DiscTrack {
+    public let number: Int
+    public let mode: DiscTrackMode
+
+    /// File holding the track's sectors
+    public let fileURL: URL
+
+    /// Sector in `fileURL` where the track starts (INDEX 00 if the pregap is stored, else INDEX 01)
+    public let fileSector: Int
+
+    /// Pregap sectors stored in the file before INDEX 01
+    public let pregap: Int
+
+    /// Sectors in the file, including the stored pregap
+    public let length: Int
+}
+
+/// Parsed disc image: a sheet (or CHD) and its track table
+public struct DiscImage {
+
+    public enum Format: String {
+        case cue
+        case ccd
+        case chd
+    }
+
+    /// Sheet or CHD file
+    public let url: URL
+    public let format: Format
+    public let tracks: [DiscTrack]
+
+    /// Extensions handled by the disc layer
+    public static let extensions: Set<String> = ["cue", "ccd", "chd", "img", "bin", "iso"]
+
+    /// Distinct files holding track data
+    public var trackFiles: [URL] {
+        var seen = Set<String>()
+        return tracks.map(\.fileURL).filter { seen.insert($0.path).inserted }
+    }
+
+    /// Total sectors across all tracks
+    public var sectorCount: Int {
+        tracks.reduce(0) { $0 + $1.length }
+    }
+
+    // MARK: - Parsing
+
+    /// Parse a CUE sheet
+    public static func cue(at url: URL) throws -> DiscImage {
+        guard let text = readText(url) else {
+            throw DiscImageError.unreadable(url.lastPathComponent)
+        }
+        let directory = url.deletingLastPathComponent()
+
+        struct Entry {
+            var number: Int
+            var mode: DiscTrackMode
+            var file: URL
+            var index0: Int?
+            var index1: Int?
+        }
+
+        var entries: [Entry] = []
+        var currentFile: URL?
+
+        for rawLine in text.components(separatedBy: .newlines) {
+            let line = rawLine.trimmingCharacters(in: .whitespaces)
+            let keyword = line.prefix { !$0.isWhitespace }.uppercased()
+            let rest = line.dropFirst(keyword.count).trimmingCharacters(in: .whitespaces)
+
+            switch keyword {
+            case "FILE":
+                let name = fileName(in: rest)
+                currentFile = directory.appendingPathComponent(name)
+            case "TRACK":
+                let parts = rest.split(separator: " ", omittingEmptySubsequences: true)
+                guard let file = currentFile, parts.count >= 2, let number = Int(parts[0]) else {
+                    throw DiscImageError.invalidSheet("TRACK without FILE in \(url.lastPathComponent)")
+                }
+                guard let mode = DiscTrackMode(rawValue: parts[1].uppercased()) else {
+                    throw DiscImageError.unsupported("track mode \(parts[1])")
+                }
+                entries.append(Entry(number: number, mode: mode, file: file))
+            case "INDEX":
+                let parts = rest.split(separator: " ", omittingEmptySubsequences: true)
+                guard parts.count >= 2, let index = Int(parts[0]), let frame = frames(fromMSF: String(parts[1])),
+                      !entries.isEmpty else {
+                    continue
+                }
+                if index == 0 {
+                    entries[entries.count - 1].index0 = frame
+                } else if index == 1 {
+                    entries[entries.count - 1].index1 = frame
+                }
+            default:
+                continue
+            }
+        }
+
+        guard !entries.isEmpty else {
+            throw DiscImageError.invalidSheet("no tracks in \(url.lastPathComponent)")
+        }
+
+        var tracks: [DiscTrack] = []
+        for (i, entry) in entries.enumerated() {
+            guard let index1 = entry.index1 else {
+                throw DiscImageError.invalidSheet("track \(entry.number) has no INDEX 01")
+            }
+            let start = entry.index0 ?? index1
+
+            // A track ends where the next one in the same file starts, or at end of file
+            let end: Int
+            if i + 1 < entries.count, entries[i + 1].file == entry.file {
+                end = entries[i + 1].index0 ?? entries[i + 1].index1 ?? start
+            } else {
+                guard let size = fileSize(entry.file) else {
+                    throw DiscImageError.missingTrackFile(entry.file.lastPathComponent)
+                }
+                end = Int(size / UInt64(entry.mode.sectorSize))
+            }
+
+            tracks.append(DiscTrack(number: entry.number,
+                                    mode: entry.mode,
+                                    fileURL: entry.file,
+                                    fileSector: start,
+                                    pregap: index1 - start,
+                                    length: max(end - start, 0)))
+        }
+
+        return DiscImage(url: url, format: .cue, tracks: tracks)
+    }
+
+    /// Parse a CloneCD control file; track data lives in the matching .img
+    public static func ccd(at url: URL) throws -> DiscImage {
+        guard let text = readText(url) else {
+            throw DiscImageError.unreadable(url.lastPathComponent)
+        }
+
+        let imageURL = url.deletingPathExtension().appendingPathExtension("img")
+        guard let imageSize = fileSize(imageURL) else {
+            throw DiscImageError.missingTrackFile(imageURL.lastPathComponent)
+        }
+
+        // [TRACK n] sections hold MODE and INDEX 0/1 as absolute sectors in the .img
+        var sections: [(number: Int, mode: Int, index0: Int?, index1: Int?)] = []
+        var inTrack = false
+        for rawLine in text.components(separatedBy: .newlines) {
+            let line = rawLine.trimmingCharacters(in: .whitespaces)
+            if line.hasPrefix("[") {
+                let name = line.trimmingCharacters(in: CharacterSet(charactersIn: "[]")).uppercased()
+                inTrack = false
+                if name.hasPrefix("TRACK "), let number = Int(name.dropFirst(6).trimmingCharacters(in: .whitespaces)) {
+                    sections.append((number, 0, nil, nil))
+                    inTrack = true
+                }
+                continue
+            }
+            guard inTrack else { continue }
+
+            let pair = line.split(separator: "=", maxSplits: 1).map { $0.trimmingCharacters(in: .whitespaces) }
+            guard pair.count == 2, let value = Int(pair[1]) else { continue }
+            switch pair[0].uppercased() {
+            case "MODE":
+                sections[sections.count - 1].mode = value
+            case "INDEX 0":
+                sections[sections.count - 1].index0 = value
+            case "INDEX 1":
+                sections[sections.count - 1].index1 = value
+            default:
+                break
+            }
+        }
+
+        guard !sections.isEmpty else {
+            throw DiscImageError.invalidSheet("no tracks in \(url.lastPathComponent)")
+        }
+
+        let totalSectors = Int(imageSize / 2352)
+        var tracks: [DiscTrack] = []
+        for (i, section) in sections.enumerated() {
+            guard let index1 = section.index1 else {
+                throw DiscImageError.invalidSheet("track \(section.number) has no INDEX 1")
+            }
+            let start = section.index0 ?? index1
+            let end = i + 1 < sections.count
+                ? (sections[i + 1].index0 ?? sections[i + 1].index1 ?? totalSectors)
+                : totalSectors
+
+            let mode: DiscTrackMode
+            switch section.mode {
+            case 0: mode = .audio
+            case 1: mode = .mode1_2352
+            default: mode = .mode2_2352
+            }
+
+            tracks.append(DiscTrack(number: section.number,
+                                    mode: mode,
+                                    fileURL: imageURL,
+                                    fileSector: start,
+                                    pregap: index1 - start,
+                                    length: max(end - start, 0)))
+        }
+
+        return DiscImage(url: url, format: .ccd, tracks: tracks)
+    }
+
+    // MARK: - CUE Output
+
+    /// Render the track table as a CUE sheet
+    /// File names are written relative to `directory` when the files live there
+    public func cueSheet(relativeTo directory: URL) -> String {
+        var lines: [String] = []
+        var currentFile: URL?
+
+        for track in tracks {
+            if track.fileURL != currentFile {
+                currentFile = track.fileURL
+                let name = track.fileURL.deletingLastPathComponent().standardizedFileURL == directory.standardizedFileURL
+                    ? track.fileURL.lastPathComponent
+                    : track.fileURL.path
+                lines.append("FILE \"\(name)\" BINARY")
+            }
+
+            lines.append("  TRACK \(String(format: "%02d", track.number)) \(track.mode.rawValue)")
+            if track.pregap > 0 {
+                lines.append("    INDEX 00 \(Self.msf(fromFrames: track.fileSector))")
+            }
+            lines.append("    INDEX 01 \(Self.msf(fromFrames: track.fileSector + track.pregap))")
+        }
+
+        return lines.joined(separator: "\n") + "\n"
+    }
+
+    // MARK: - Helpers
+
+    /// mm:ss:ff to frames (75 per second)
+    static func frames(fromMSF msf: String) -> Int? {
+        let parts = msf.split(separator: ":").compactMap { Int($0) }
+        guard parts.count == 3 else { return nil }
+        return (parts[0] * 60 + parts[1]) * 75 + parts[2]
+    }
+
+    static func msf(fromFrames frames: Int) -> String {
+        String(format: "%02d:%02d:%02d", frames / 75 / 60, frames / 75 % 60, frames % 75)
+    }
+
+    /// File name from the argument of a FILE line: quoted or bare, followed by a type
+    private static func fileName(in argument: String) -> String {
+        if argument.hasPrefix("\""), let close = argument.dropFirst().firstIndex(of: "\"") {
+            return String(argument[argument.index(after: argument.startIndex)..<close])
+        }
+        if let space = argument.lastIndex(of: " ") {
+            return String(argument[..<space])
+        }
+        return argument
+    }
+
+    private static func readText(_ url: URL) -> String? {
+        guard let data = try? Data(contentsOf: url) else { return nil }
+        // Sheets from older tools are often Latin-1 / Shift-JIS rather than UTF-8
+        return String(data: data, encoding: .utf8) ?? String(data: data, encoding: .isoLatin1)
+    }
+
+    static func fileSize(_ url: URL) -> UInt64? {
+        guard let size = try? FileManager.default.attributesOfItem(atPath: url.path)[.size] as? NSNumber else {
+            return nil
+        }
+        return size.uint64Value
+    }
+}
@@ -0,0 +1,266 @@
+//
+//  DiscImageLayer.swift
+//  YearnCore
+//
+//  Prepares disc images for cores and serves their reads through the VFS cache
+//
+
+import Foundation
+import CYearnSupport
+
+/// Disc image front end shared by both bridges
+///
+/// `prepare(url:usesVFS:)` turns whatever the user picked (a CUE, a CCD, a bare
+/// IMG/BIN or a CHD) into the file the core should load. Cores that request the
+/// libretro VFS interface read their track files through `yearn_vfs`, which keeps
+/// a block cache with sequential read-ahead; supported CHDs are presented to them
+/// as a CUE sheet plus virtual BIN tracks decoded from the hunk cache.
+public final class DiscImageLayer: @unchecked Sendable {
+
+    public static let shared = DiscImageLayer()
+
+    /// Counters for the current game
+    public struct Statistics {
+        public var reads: UInt64 = 0
+        public var blockHits: UInt64 = 0
+        public var blockMisses: UInt64 = 0
+        public var readAheadBlocks: UInt64 = 0
+        public var readAheadHits: UInt64 = 0
+        public var hunksDecoded = 0
+        public var hunkCacheHits = 0
+
+        public var hitRate: Double {
+            let total = blockHits + blockMisses
+            return total > 0 ? Double(blockHits) / Double(total) : 0
+        }
+    }
+
+    /// Cache blocks kept per track file (64 KB each)
+    public var cacheBlocksPerFile: UInt32 = 64
+
+    public let cacheDirectory: URL
+
+    private let fileManager = FileManager.default
+    private let lock = NSLock()
+    private var chdImage: CHDImage?
+
+    /// Context handed to the VFS callbacks of a virtual track
+    /// Retained by the VFS until its release callback runs, so a read-ahead
+    /// still in flight during `reset()` never sees a freed image
+    private final class VirtualTrack {
+        let image: CHDImage
+        let index: Int
+
+        init(image: CHDImage, index: Int) {
+            self.image = image
+            self.index = index
+        }
+    }
+
+    // MARK: - Initialization
+
+    private init() {
+        let cachesURL = fileManager.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        cacheDirectory = cachesURL.appendingPathComponent("DiscImages", isDirectory: true)
+    }
+
+    // MARK: - Public Methods
+
+    public static func isDiscImage(_ url: URL) -> Bool {
+        DiscImage.extensions.contains(url.pathExtension.lowercased())
+    }
+
+    /// Answer RETRO_ENVIRONMENT_GET_VFS_INTERFACE
+    /// - Returns: Whether the interface was provided
+    public func provideVFS(_ data: UnsafeMutableRawPointer?) -> Bool {
+        guard let data = data else { return false }
+        let info = data.assumingMemoryBound(to: retro_vfs_interface_info.self)
+        guard info.pointee.required_interface_version <= UInt32(YEARN_VFS_INTERFACE_VERSION) else {
+            return false
+        }
+        info.pointee.iface = yearn_vfs_interface()
+        return true
+    }
+
+    /// Get the file to hand to the core for a disc image
+    /// - Parameters:
+    ///   - url: Image the user picked
+    ///   - usesVFS: Whether the core reads files through the VFS interface
+    /// - Returns: Sheet or image to load; `url` itself when nothing better is available
+    public func prepare(url: URL, usesVFS: Bool) -> URL {
+        reset()
+
+        do {
+            switch url.pathExtension.lowercased() {
+            case "cue":
+                let image = try DiscImage.cue(at: url)
+                if usesVFS { register(image) }
+                return url
+
+            case "ccd":
+                let image = try DiscImage.ccd(at: url)
+                if usesVFS { register(image) }
+                return try writeCue(for: image)
+
+            case "chd":
+                guard usesVFS else { return url }
+                return try prepareCHD(url) ?? url
+
+            case "img", "bin", "iso":
+                let base = url.deletingPathExtension()
+                let cueURL = base.appendingPathExtension("cue")
+                let ccdURL = base.appendingPathExtension("ccd")
+                if fileManager.fileExists(atPath: cueURL.path) {
+                    Log.disc.debug("Found \(cueURL.lastPathComponent) for \(url.lastPathComponent)")
+                    return prepare(url: cueURL, usesVFS: usesVFS)
+                }
+                if fileManager.fileExists(atPath: ccdURL.path) {
+                    Log.disc.debug("Found \(ccdURL.lastPathComponent) for \(url.lastPathComponent)")
+                    return prepare(url: ccdURL, usesVFS: usesVFS)
+                }
+                if usesVFS {
+                    yearn_vfs_register_file(url.path, cacheBlocksPerFile)
+                }
+                return url
+
+            default:
+                return url
+            }
+        } catch {
+            Log.disc.warning("Disc image \(url.lastPathComponent): \(error.localizedDescription), loading as-is")
+            return url
+        }
+    }
+
+    /// Drop registrations and decoded CHD data, logging how the cache did
+    public func reset() {
+        let stats = statistics
+        if stats.reads > 0 {
+            Log.disc.info("Disc cache: \(stats.reads) reads, \(Int(stats.hitRate * 100))% block hits, "
+                          + "\(stats.readAheadHits)/\(stats.readAheadBlocks) read-ahead used, "
+                          + "\(stats.hunksDecoded) hunks decoded")
+        }
+
+        yearn_vfs_unregister_all()
+        yearn_vfs_reset_stats()
+
+        lock.lock()
+        chdImage = nil
+        lock.unlock()
+    }
+
+    public var statistics: Statistics {
+        var raw = yearn_vfs_stats()
+        yearn_vfs_get_stats(&raw)
+
+        var stats = Statistics()
+        stats.reads = raw.reads
+        stats.blockHits = raw.block_hits
+        stats.blockMisses = raw.block_misses
+        stats.readAheadBlocks = raw.readahead_blocks
+        stats.readAheadHits = raw.readahead_hits
+
+        lock.lock()
+        if let image = chdImage {
+            stats.hunksDecoded = image.hunksDecoded
+            stats.hunkCacheHits = image.cacheHits
+        }
+        lock.unlock()
+        return stats
+    }
+
+    // MARK: - Private Methods
+
+    private func register(_ image: DiscImage) {
+        for file in image.trackFiles {
+            yearn_vfs_register_file(file.path, cacheBlocksPerFile)
+        }
+    }
+
+    /// CCD images need a CUE for most cores; write one next to the .img,
+    /// or into the cache when that directory is read-only
+    private func writeCue(for image: DiscImage) throws -> URL {
+        let directory = image.url.deletingLastPathComponent()
+        let siblingURL = image.url.deletingPathExtension().appendingPathExtension("cue")
+        if fileManager.fileExists(atPath: siblingURL.path) {
+            return siblingURL
+        }
+
+        do {
+            try image.cueSheet(relativeTo: directory).write(to: siblingURL, atomically: true, encoding: .utf8)
+            Log.disc.debug("Created \(siblingURL.lastPathComponent) from CloneCD track table")
+            return siblingURL
+        } catch {
+            let folder = try cacheFolder(for: image.url)
+            let cueURL = folder.appendingPathComponent(siblingURL.lastPathComponent)
+            try image.cueSheet(relativeTo: folder).write(to: cueURL, atomically: true, encoding: .utf8)
+            return cueURL
+        }
+    }
+
+    /// Expose each CHD track as a virtual BIN next to a generated CUE
+    /// Returns nil when the CHD uses codecs the host reader lacks
+    private func prepareCHD(_ url: URL) throws -> URL? {
+        let image = try CHDImage(url: url)
+        guard image.isSupported else {
+            Log.disc.debug("\(url.lastPathComponent) uses a codec handled only by the core")
+            return nil
+        }
+
+        let folder = try cacheFolder(for: url)
+        let baseName = url.deletingPathExtension().lastPathComponent
+        var discTracks: [DiscTrack] = []
+
+        let read: yearn_vfs_read_fn = { context, offset, buffer, length in
+            guard let context = context, let buffer = buffer else { return -1 }
+            let track = Unmanaged<VirtualTrack>.fromOpaque(context).takeUnretainedValue()
+            let count = Int(min(length, UInt64(Int.max)))
+            return Int64(track.image.readTrack(track.index, offset: offset, into: buffer, length: count))
+        }
+        let release: yearn_vfs_release_fn = { context in
+            guard let context = context else { return }
+            Unmanaged<VirtualTrack>.fromOpaque(context).release()
+        }
+
+        for (index, track) in image.tracks.enumerated() {
+            let trackURL = folder.appendingPathComponent("\(baseName) (Track \(track.number)).bin")
+            let size = UInt64(track.frames * track.mode.sectorSize)
+            let context = Unmanaged.passRetained(VirtualTrack(image: image, index: index))
+
+            let status = yearn_vfs_register_virtual(trackURL.path, size, read, release,
+                                                    context.toOpaque(), cacheBlocksPerFile)
+            guard status == 0 else {
+                context.release()
+                yearn_vfs_unregister_all()
+                return nil
+            }
+
+            discTracks.append(DiscTrack(number: track.number,
+                                        mode: track.mode,
+                                        fileURL: trackURL,
+                                        fileSector: 0,
+                                        pregap: track.pregap,
+                                        length: track.frames))
+        }
+
+        lock.lock()
+        chdImage = image
+        lock.unlock()
+
+        let sheet = DiscImage(url: url, format: .chd, tracks: discTracks)
+        let cueURL = folder.appendingPathComponent(baseName).appendingPathExtension("cue")
+        try sheet.cueSheet(relativeTo: folder).write(to: cueURL, atomically: true, encoding: .utf8)
+
+        Log.disc.info("Serving \(url.lastPathComponent) as \(discTracks.count) virtual track(s)")
+        return cueURL
+    }
+
+    /// Per-image folder under Caches/DiscImages, keyed by name and size
+    private func cacheFolder(for url: URL) throws -> URL {
+        let size = DiscImage.fileSize(url) ?? 0
+        let key = url.deletingPathExtension().lastPathComponent + "-" + String(size, radix: 16)
+        let folder = cacheDirectory.appendingPathComponent(key, isDirectory: true)
+        try fileManager.createDirectory(at: folder, withIntermediateDirectories: true)
+        return folder
+    }
+}
@@ -0,0 +1,159 @@
+//
+//  EmulationSession.swift
+//  YearnCore
+//
+//  Runs a libretro core into video, audio and input sinks
+//
+
+import Foundation
+
+/// Drives a `LibretroBridge` frame by frame and routes its output to sinks
+///
+/// Nothing here opens a window or an audio device, so the same loop runs
+/// behind the app's presentation layer, in the headless runner and under a
+/// profiler. Call everything from the one thread that runs frames.
+public final class EmulationSession {
+
+    public enum Pacing {
+        /// Frames back to back, as fast as the core goes
+        case unthrottled
+        /// Sleep between frames to hold the core's frame rate
+        case realtime
+    }
+
+    /// What one `run` measured
+    public struct Summary {
+        public let frames: Int
+        /// Wall time of the whole run, pacing included
+        public let elapsed: TimeInterval
+        /// Seconds each frame spent in the core, sorted ascending
+        public let frameTimes: [TimeInterval]
+
+        /// Frames per second over the wall time
+        public var framesPerSecond: Double {
+            elapsed > 0 ? Double(frames) / elapsed : 0
+        }
+
+        /// Frame time at `fraction` (0...1) of the sorted times
+        public func frameTime(atPercentile fraction: Double) -> TimeInterval {
+            guard !frameTimes.isEmpty else { return 0 }
+            let index = Int((Double(frameTimes.count - 1) * min(max(fraction, 0), 1)).rounded())
+            return frameTimes[index]
+        }
+    }
+
+    // MARK: - Properties
+
+    public let bridge: LibretroBridge
+    public let video: VideoSink
+    public let audio: AudioSink
+    public let input: InputSource
+
+    /// Takes a save state after each frame when set, as rewind does in the app
+    ///
+    /// The history is registered with `MemoryBudget.shared` while it is set,
+    /// so memory pressure shortens it.
+    public var rewind: RewindManager? {
+        didSet {
+            rewindRegistration = rewind?.registerMemory()
+        }
+    }
+
+    /// Published after each frame when set, so a `HangWatchdog` can watch the run
+    public var frameState: FrameStateStore?
+
+    /// Frames run since the game loaded
+    public private(set) var frame = 0
+
+    private var rewindRegistration: MemoryBudget.Registration?
+
+    // MARK: - Initialization
+
+    public init(bridge: LibretroBridge, video: VideoSink, audio: AudioSink, input: InputSource) {
+        self.bridge = bridge
+        self.video = video
+        self.audio = audio
+        self.input = input
+
+        bridge.videoCallback = { [unowned self] pixels, width, height, pitch, format in
+            self.video.updateFrame(pixels, width: width, height: height, pitch: pitch, format: format)
+        }
+        bridge.audioCallback = { [unowned self] samples, count in
+            self.audio.writeSamples(samples, count: count)
+        }
+        bridge.inputPollCallback = { [unowned self] in
+            self.input.poll(frame: self.frame)
+        }
+        bridge.inputStateCallback = { [unowned self] port, device, index, id in
+            self.input.inputState(port: port, device: device, index: index, id: id)
+        }
+    }
+
+    deinit {
+        bridge.videoCallback = nil
+        bridge.audioCallback = nil
+        bridge.inputPollCallback = nil
+        bridge.inputStateCallback = nil
+    }
+
+    // MARK: - Loading
+
+    /// Load a core and a game, then configure the sinks from the game's AV info
+    public func load(corePath: String, game: URL) throws {
+        try bridge.loadCore(at: corePath)
+        try bridge.loadGame(url: game)
+        frame = 0
+
+        guard let info = bridge.avInfo else {
+            throw LibretroError.gameLoadFailed
+        }
+        // The core sets its pixel format while loading the game
+        video.configure(format: VideoFormat(
+            width: info.baseWidth,
+            height: info.baseHeight,
+            pixelFormat: bridge.corePixelFormat,
+            frameRate: info.fps
+        ))
+        audio.configure(format: AudioFormat(sampleRate: info.sampleRate, channels: 2))
+    }
+
+    // MARK: - Running
+
+    /// Run `count` frames
+    public func run(frames count: Int, pacing: Pacing = .unthrottled) -> Summary {
+        let frameDuration = 1.0 / (bridge.avInfo?.fps ?? 60)
+        var frameTimes: [TimeInterval] = []
+        frameTimes.reserveCapacity(max(count, 0))
+
+        let start = DiagnosticLog.now
+        var deadline = start
+        for _ in 0..<max(count, 0) {
+            let frameStart = DiagnosticLog.now
+            frameState?.beginFrame(at: frameStart)
+
+            bridge.runFrame()
+            if let rewind, let state = bridge.saveState() {
+                rewind.captureState(state)
+            }
+            frame += 1
+
+            let frameEnd = DiagnosticLog.now
+            frameTimes.append(frameEnd - frameStart)
+            frameState?.publish(frames: UInt64(frame), timestamp: frameEnd, frameTime: frameEnd - frameStart,
+                                fps: frameEnd > start ? Double(frameTimes.count) / (frameEnd - start) : 0)
+
+            if pacing == .realtime {
+                deadline += frameDuration
+                let wait = deadline - DiagnosticLog.now
+                if wait > 0 {
+                    Thread.sleep(forTimeInterval: wait)
+                } else if wait < -frameDuration * 4 {
+                    // Too far behind to catch up; start counting again from now
+                    deadline = DiagnosticLog.now
+                }
+            }
+        }
+
+        return Summary(frames: frameTimes.count, elapsed: DiagnosticLog.now - start, frameTimes: frameTimes.sorted())
+    }
+}
@@ -0,0 +1,122 @@
+//
+//  FrameStateStore.swift
+//  YearnCore
+//
+//  Per-frame emulation state, readable at any rate without observation
+//
+
+import Foundation
+import CYearnSupport
+
+/// Latest frame counters and pressed inputs, backed by `yearn_frame`
+///
+/// The emulation loop publishes after every frame; readers sample whenever
+/// they need to (an overlay twice a second, a watchdog on its own thread)
+/// instead of being notified. A frame marked begun and not yet published is
+/// one still running, which is how `HangWatchdog` spots a stuck core. Nothing here is observable, so publishing
+/// never invalidates a view. Neither side takes a lock: a read that races a
+/// publish retries until it gets one whole sample.
+public final class FrameStateStore: @unchecked Sendable {
+
+    public struct Sample: Sendable {
+        /// Frames run since the game started, including skipped ones
+        public var frames: UInt64
+        /// Host time (e.g. `CACurrentMediaTime()`) when the last frame finished
+        public var timestamp: TimeInterval
+        /// Seconds the last frame took to run
+        public var frameTime: TimeInterval
+        /// Frames per second over the last measuring interval
+        public var fps: Double
+        /// Bit n set while libretro button n is held
+        public var inputs: UInt64
+
+        public func isPressed(_ button: Int) -> Bool {
+            button >= 0 && button < 64 && inputs & (1 << UInt64(button)) != 0
+        }
+    }
+
+    /// Time the publishing thread spent on one thing
+    public struct Timing: Sendable, Equatable {
+        public enum Work: Sendable {
+            /// Running one frame of the core
+            case frame
+            /// Serializing a save state between frames
+            case saveState
+        }
+
+        public var work: Work
+        public var duration: TimeInterval
+    }
+
+    private let handle: OpaquePointer
+
+    // MARK: - Initialization
+
+    public init() {
+        guard let handle = yearn_frame_state_create() else {
+            fatalError("Out of memory allocating frame state")
+        }
+        self.handle = handle
+    }
+
+    deinit {
+        yearn_frame_state_destroy(handle)
+    }
+
+    // MARK: - Public Methods
+
+    /// The latest published frame, with the inputs held now
+    public var sample: Sample {
+        var raw = yearn_frame_sample()
+        yearn_frame_state_read(handle, &raw)
+        return Sample(frames: raw.frames, timestamp: raw.timestamp, frameTime: raw.frame_time,
+                      fps: raw.fps, inputs: raw.inputs)
+    }
+
+    /// Mark the start of a frame; the next `publish` ends it. Call from the publishing thread.
+    public func beginFrame(at timestamp: TimeInterval) {
+        yearn_frame_state_begin(handle, timestamp)
+    }
+
+    /// Host time the frame being run began, or nil between frames
+    public var inFrameSince: TimeInterval? {
+        let since = yearn_frame_state_in_frame_since(handle)
+        return since > 0 ? since : nil
+    }
+
+    /// Up to the last 128 frames and the work recorded between them, oldest first
+    public func recentTimings() -> [Timing] {
+        let capacity = Int(YEARN_FRAME_RECENT)
+        var work = [yearn_frame_work](repeating: YEARN_FRAME_WORK_FRAME, count: capacity)
+        let durations = [TimeInterval](unsafeUninitializedCapacity: capacity) { buffer, count in
+            count = yearn_frame_state_recent(handle, buffer.baseAddress, &work, capacity)
+        }
+        return zip(work, durations).map { work, duration in
+            Timing(work: work == YEARN_FRAME_WORK_SAVE_STATE ? .saveState : .frame, duration: duration)
+        }
+    }
+
+    /// Times of the recent frames alone, oldest first
+    public func recentFrameTimes() -> [TimeInterval] {
+        recentTimings().filter { $0.work == .frame }.map(\.duration)
+    }
+
+    /// Record time spent between frames, kept apart from frame times; call from the publishing thread
+    public func record(_ work: Timing.Work, duration: TimeInterval) {
+        let raw = work == .saveState ? YEARN_FRAME_WORK_SAVE_STATE : YEARN_FRAME_WORK_FRAME
+        yearn_frame_state_record(handle, raw, duration)
+    }
+
+    /// Publish a finished frame; call from one thread at a time
+    public func publish(frames: UInt64, timestamp: TimeInterval, frameTime: TimeInterval, fps: Double) {
+        var raw = yearn_frame_sample(frames: frames, timestamp: timestamp, frame_time: frameTime,
+                                     fps: fps, inputs: 0)
+        yearn_frame_state_publish(handle, &raw)
+    }
+
+    /// Record a libretro button as held or released; any thread
+    public func setInput(_ button: Int, pressed: Bool) {
+        guard button >= 0 && button < 64 else { return }
+        yearn_frame_state_set_input(handle, UInt32(button), pressed)
+    }
+}
@@ -0,0 +1,46 @@
+//
+//  MediaSinks.swift
+//  YearnCore
+//
+//  Where a running core's video, audio and input go
+//
+
+import Foundation
+import CLibretro
+
+/// Receives frames from a running core
+///
+/// Called on the thread that runs frames. `pixels` belongs to the core and is
+/// only valid during the call; a sink that keeps the frame copies it.
+public protocol VideoSink: AnyObject {
+    /// Base geometry and pixel format, once the game is loaded
+    func configure(format: VideoFormat)
+    /// One frame; the size may differ from the configured one
+    func updateFrame(_ pixels: UnsafeRawPointer, width: Int, height: Int, pitch: Int, format: LibretroPixelFormat)
+}
+
+/// Receives interleaved 16-bit samples from a running core
+public protocol AudioSink: AnyObject {
+    func configure(format: AudioFormat)
+    /// `count` is in samples, not frames
+    func writeSamples(_ samples: UnsafePointer<Int16>, count: Int)
+}
+
+/// Answers a running core's input queries
+public protocol InputSource: AnyObject {
+    /// The core is about to read input for `frame`, counted from 0 since the game loaded
+    func poll(frame: Int)
+    /// A `retro_input_state_t` query
+    func inputState(port: UInt32, device: UInt32, index: UInt32, id: UInt32) -> Int16
+}
+
+public extension InputSource {
+    /// Answer a joypad query from a mask with bit n set while `RetroButton` n is held
+    static func joypadState(_ buttons: UInt32, device: UInt32, id: UInt32) -> Int16 {
+        guard device == UInt32(RETRO_DEVICE_JOYPAD) else { return 0 }
+        if id == UInt32(RETRO_DEVICE_ID_JOYPAD_MASK) {
+            return Int16(truncatingIfNeeded: buttons & 0xFFFF)
+        }
+        return id < 16 && buttons & (1 << id) != 0 ? 1 : 0
+    }
+}
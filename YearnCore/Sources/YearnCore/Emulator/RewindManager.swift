@@ -42,12 +42,16 @@ public class RewindManager {
     
     /// Current rewind progress (0.0 to 1.0)
     public var progress: Float {
-        guard !stateHistory.isEmpty else { return 0 }
+        lock.lock()
+        defer { lock.unlock() }
+        guard stateHistory.count > 1 else { return 0 }
         return Float(currentIndex) / Float(stateHistory.count - 1)
     }
     
     /// Duration of available rewind in seconds (at 60fps)
     public var availableDuration: TimeInterval {
+        lock.lock()
+        defer { lock.unlock() }
         let frames = stateHistory.count * configuration.captureInterval
         return TimeInterval(frames) / 60.0
     }
@@ -57,10 +61,14 @@ public class RewindManager {
     
     // MARK: - Private Properties
     
+    // History, guarded by `lock`: a `MemoryBudget` shrink callback trims it from any thread
+    private let lock = NSLock()
     private var stateHistory: [Data] = []
     private var currentIndex: Int = 0
-    private var frameCounter: Int = 0
     private var totalMemoryUsage: Int = 0
+    private var budgetLimit: Int?
+    
+    private var frameCounter: Int = 0
     
     // Compression
     private var useCompression: Bool = true
@@ -92,17 +100,22 @@ public class RewindManager {
         }
         
         // Add to history
+        lock.lock()
         stateHistory.append(dataToStore)
         totalMemoryUsage += dataToStore.count
         currentIndex = stateHistory.count - 1
         
         // Trim if needed
         trimHistory()
+        lock.unlock()
     }
     
     /// Start rewinding
     public func startRewind() {
-        guard !stateHistory.isEmpty else { return }
+        lock.lock()
+        let isEmpty = stateHistory.isEmpty
+        lock.unlock()
+        guard !isEmpty else { return }
         isRewinding = true
     }
     
@@ -111,52 +124,118 @@ public class RewindManager {
         isRewinding = false
         
         // Remove states after current position (we've "branched" the timeline)
+        lock.lock()
         if currentIndex < stateHistory.count - 1 {
             let removedStates = stateHistory.suffix(from: currentIndex + 1)
             totalMemoryUsage -= removedStates.reduce(0) { $0 + $1.count }
             stateHistory.removeLast(stateHistory.count - currentIndex - 1)
         }
+        lock.unlock()
     }
     
     /// Step back one state during rewind
     public func stepBack() -> Data? {
-        guard isRewinding && currentIndex > 0 else { return nil }
+        lock.lock()
+        guard isRewinding && currentIndex > 0 else {
+            lock.unlock()
+            return nil
+        }
         currentIndex -= 1
-        return getState(at: currentIndex)
+        let stored = stateHistory[currentIndex]
+        lock.unlock()
+        return expand(stored)
     }
     
     /// Step forward one state during rewind
     public func stepForward() -> Data? {
-        guard isRewinding && currentIndex < stateHistory.count - 1 else { return nil }
+        lock.lock()
+        guard isRewinding && currentIndex < stateHistory.count - 1 else {
+            lock.unlock()
+            return nil
+        }
         currentIndex += 1
-        return getState(at: currentIndex)
+        let stored = stateHistory[currentIndex]
+        lock.unlock()
+        return expand(stored)
     }
     
     /// Get state at specific position (0.0 to 1.0)
     public func getState(atProgress progress: Float) -> Data? {
-        guard !stateHistory.isEmpty else { return nil }
-        let index = Int(Float(stateHistory.count - 1) * max(0, min(1, progress)))
-        currentIndex = index
-        return getState(at: index)
+        lock.lock()
+        guard !stateHistory.isEmpty else {
+            lock.unlock()
+            return nil
+        }
+        currentIndex = Int(Float(stateHistory.count - 1) * max(0, min(1, progress)))
+        let stored = stateHistory[currentIndex]
+        lock.unlock()
+        return expand(stored)
     }
     
     /// Get current state
     public func getCurrentState() -> Data? {
-        return getState(at: currentIndex)
+        lock.lock()
+        let stored = stateHistory.indices.contains(currentIndex) ? stateHistory[currentIndex] : nil
+        lock.unlock()
+        return stored.map(expand)
     }
     
     /// Clear all history
     public func clear() {
+        lock.lock()
         stateHistory.removeAll()
         currentIndex = 0
-        frameCounter = 0
         totalMemoryUsage = 0
+        lock.unlock()
+        frameCounter = 0
         isRewinding = false
     }
     
+    /// Bytes held by the history; safe from any thread
+    public var memoryUsage: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return totalMemoryUsage
+    }
+    
+    /// Hold at most `bytes` of history, dropping the oldest states now
+    ///
+    /// Safe from any thread, e.g. a `MemoryBudget` shrink callback. The limit
+    /// also holds for later captures until `removeMemoryLimit()`.
+    /// - Returns: Bytes held after trimming
+    @discardableResult
+    public func limitMemory(to bytes: Int) -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        budgetLimit = min(budgetLimit ?? .max, max(0, bytes))
+        trimHistory()
+        return totalMemoryUsage
+    }
+    
+    /// Go back to `configuration.maxMemoryUsage` alone
+    public func removeMemoryLimit() {
+        lock.lock()
+        budgetLimit = nil
+        lock.unlock()
+    }
+    
+    /// Register with `budget`, so memory pressure shortens the history
+    /// and the history may grow again once pressure has passed
+    public func registerMemory(with budget: MemoryBudget = .shared) -> MemoryBudget.Registration {
+        budget.register(
+            "Rewind history",
+            tier: .rewind,
+            usage: { [weak self] in self?.memoryUsage ?? 0 },
+            shrink: { [weak self] limit in self?.limitMemory(to: limit) ?? 0 },
+            restore: { [weak self] in self?.removeMemoryLimit() }
+        )
+    }
+    
     /// Get memory usage info
     public var memoryInfo: MemoryInfo {
-        MemoryInfo(
+        lock.lock()
+        defer { lock.unlock() }
+        return MemoryInfo(
             usedBytes: totalMemoryUsage,
             maxBytes: configuration.maxMemoryUsage,
             stateCount: stateHistory.count,
@@ -166,11 +245,7 @@ public class RewindManager {
     
     // MARK: - Private Methods
     
-    private func getState(at index: Int) -> Data? {
-        guard index >= 0 && index < stateHistory.count else { return nil }
-        
-        let storedData = stateHistory[index]
-        
+    private func expand(_ storedData: Data) -> Data {
         if useCompression {
             return decompress(storedData) ?? storedData
         }
@@ -178,6 +253,7 @@ public class RewindManager {
         return storedData
     }
     
+    /// Under `lock`
     private func trimHistory() {
         // Trim by count
         while stateHistory.count > configuration.maxStates {
@@ -188,9 +264,14 @@ public class RewindManager {
             currentIndex = max(0, currentIndex - 1)
         }
         
-        // Trim by memory
-        if configuration.maxMemoryUsage > 0 {
-            while totalMemoryUsage > configuration.maxMemoryUsage && !stateHistory.isEmpty {
+        // Trim by memory, within the budget limit if one is set
+        var maxMemory = configuration.maxMemoryUsage > 0 ? configuration.maxMemoryUsage : Int.max
+        if let budgetLimit {
+            maxMemory = min(maxMemory, budgetLimit)
+        }
+        
+        if maxMemory < Int.max {
+            while totalMemoryUsage > maxMemory && !stateHistory.isEmpty {
                 if let removed = stateHistory.first {
                     totalMemoryUsage -= removed.count
                 }
@@ -0,0 +1,146 @@
+//
+//  FileHashCache.swift
+//  YearnCore
+//
+//  Persistent file digests keyed by path, size and modification time
+//
+
+import Foundation
+#if canImport(Darwin)
+import Darwin
+#else
+import Glibc
+#endif
+
+/// Remembers the digests of files that rarely change (BIOS images, firmware)
+///
+/// A lookup costs one `stat`: while a file keeps its size and modification
+/// time the stored digests are returned without reading it. Entries are
+/// persisted to `storeURL` as a binary plist after every miss, so the
+/// cache suits small sets of files rather than a whole ROM library.
+public final class FileHashCache: @unchecked Sendable {
+
+    public struct Statistics {
+        public var hits = 0
+        public var misses = 0
+        public var hashedBytes: UInt64 = 0
+    }
+
+    private struct Entry: Codable {
+        var size: Int64
+        var modificationTime: Double
+        var crc32: UInt32
+        var md5: [UInt8]?
+        var sha1: [UInt8]?
+        var length: UInt64
+    }
+
+    // MARK: - Properties
+
+    public let storeURL: URL
+
+    private let lock = NSLock()
+    private var entries: [String: Entry]?
+    private var stats = Statistics()
+
+    // MARK: - Initialization
+
+    public init(storeURL: URL) {
+        self.storeURL = storeURL
+    }
+
+    // MARK: - Public Methods
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Digests of a file, from the cache when the file has not changed
+    /// - Throws: `POSIXError` if the file does not exist or cannot be read
+    public func hash(fileAt url: URL, digests: ROMHasher.Digests = [.md5, .sha1]) throws -> ROMHash {
+        let path = url.path
+        var info = stat()
+        guard stat(path, &info) == 0 else {
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .ENOENT)
+        }
+        let size = Int64(info.st_size)
+#if canImport(Darwin)
+        let mtime = Double(info.st_mtimespec.tv_sec) + Double(info.st_mtimespec.tv_nsec) / 1e9
+#else
+        let mtime = Double(info.st_mtim.tv_sec) + Double(info.st_mtim.tv_nsec) / 1e9
+#endif
+
+        lock.lock()
+        if entries == nil {
+            entries = loadEntries()
+        }
+        let cached = entries?[path]
+        lock.unlock()
+
+        if let entry = cached, entry.size == size, entry.modificationTime == mtime,
+           !digests.contains(.md5) || entry.md5 != nil,
+           !digests.contains(.sha1) || entry.sha1 != nil {
+            record { $0.hits += 1 }
+            return ROMHash(crc32: entry.crc32, md5: entry.md5, sha1: entry.sha1, length: entry.length)
+        }
+
+        // Every digest is computed in the same pass, so take them all while reading anyway
+        let hash = try ROMHasher.hash(fileAt: url, digests: .all)
+
+        lock.lock()
+        entries?[path] = Entry(size: size, modificationTime: mtime, crc32: hash.crc32,
+                               md5: hash.md5, sha1: hash.sha1, length: hash.length)
+        stats.misses += 1
+        stats.hashedBytes += hash.length
+        let snapshot = entries ?? [:]
+        lock.unlock()
+
+        saveEntries(snapshot)
+        return hash
+    }
+
+    /// Forget a file, e.g. after deleting it
+    public func remove(fileAt url: URL) {
+        lock.lock()
+        if entries == nil {
+            entries = loadEntries()
+        }
+        let removed = entries?.removeValue(forKey: url.path) != nil
+        let snapshot = entries ?? [:]
+        lock.unlock()
+
+        if removed {
+            saveEntries(snapshot)
+        }
+    }
+
+    // MARK: - Private Methods
+
+    private func record(_ update: (inout Statistics) -> Void) {
+        lock.lock()
+        update(&stats)
+        lock.unlock()
+    }
+
+    private func loadEntries() -> [String: Entry] {
+        guard let data = try? Data(contentsOf: storeURL),
+              let entries = try? PropertyListDecoder().decode([String: Entry].self, from: data) else {
+            return [:]
+        }
+        return entries
+    }
+
+    private func saveEntries(_ entries: [String: Entry]) {
+        let encoder = PropertyListEncoder()
+        encoder.outputFormat = .binary
+        do {
+            try FileManager.default.createDirectory(at: storeURL.deletingLastPathComponent(),
+                                                    withIntermediateDirectories: true)
+            try encoder.encode(entries).write(to: storeURL, options: .atomic)
+        } catch {
+            Log.library.warning("Failed to save hash cache: \(error)")
+        }
+    }
+}
@@ -0,0 +1,124 @@
+//
+//  ROMHasher.swift
+//  YearnCore
+//
+//  CRC32 / MD5 / SHA-1 of ROM files in one streaming pass
+//
+
+import Foundation
+import CYearnSupport
+
+/// Digests of a ROM file
+public struct ROMHash: Hashable, Sendable {
+    public let crc32: UInt32
+    public let md5: [UInt8]?
+    public let sha1: [UInt8]?
+
+    /// Bytes hashed (file size minus any skipped header)
+    public let length: UInt64
+
+    /// Upper-case, as printed in No-Intro / Redump DATs
+    public var crc32String: String {
+        String(format: "%08X", crc32)
+    }
+
+    public var md5String: String? {
+        md5.map(ROMHasher.hex)
+    }
+
+    public var sha1String: String? {
+        sha1.map(ROMHasher.hex)
+    }
+}
+
+/// Streaming ROM hasher backed by `yearn_hash`
+///
+/// Files are read through mmap'd windows and every requested digest is fed
+/// the same 64 KB slice before moving on, so a file is read once however
+/// many digests are wanted. CRC32 uses the ARMv8 CRC instructions (or
+/// PCLMULQDQ on x86) and slicing-by-8 tables otherwise.
+public enum ROMHasher {
+
+    public struct Digests: OptionSet, Sendable {
+        public let rawValue: UInt32
+        public init(rawValue: UInt32) { self.rawValue = rawValue }
+
+        public static let crc32 = Digests(rawValue: UInt32(YEARN_HASH_CRC32))
+        public static let md5 = Digests(rawValue: UInt32(YEARN_HASH_MD5))
+        public static let sha1 = Digests(rawValue: UInt32(YEARN_HASH_SHA1))
+        public static let all: Digests = [.crc32, .md5, .sha1]
+    }
+
+    /// CRC32 implementation picked for this CPU
+    public static var crc32Implementation: String {
+        switch yearn_crc32_best_impl() {
+        case YEARN_CRC32_ARMV8: return "ARMv8 CRC32"
+        case YEARN_CRC32_PCLMUL: return "PCLMULQDQ"
+        default: return "slicing-by-8"
+        }
+    }
+
+    /// Hash a file
+    /// - Parameters:
+    ///   - url: File to hash
+    ///   - skip: Bytes at the start to leave out (copier headers)
+    ///   - digests: Digests to compute; unrequested ones are nil in the result
+    public static func hash(fileAt url: URL, skip: UInt64 = 0, digests: Digests = .all) throws -> ROMHash {
+        var result = yearn_hash_result()
+        guard yearn_hash_file(url.path, skip, digests.rawValue, &result) == 0 else {
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+        }
+        return ROMHash(result, digests: digests)
+    }
+
+    /// Hash bytes already in memory
+    public static func hash(data: Data, digests: Digests = .all) -> ROMHash {
+        var hasher = yearn_hasher()
+        var result = yearn_hash_result()
+        yearn_hasher_init(&hasher, digests.rawValue)
+        data.withUnsafeBytes { bytes in
+            yearn_hasher_update(&hasher, bytes.baseAddress, bytes.count)
+        }
+        yearn_hasher_final(&hasher, &result)
+        return ROMHash(result, digests: digests)
+    }
+
+    /// Hash several files at once, one file per core
+    /// - Returns: Hashes by URL; files that could not be read are left out
+    public static func hashFiles(_ urls: [URL], skip: UInt64 = 0, digests: Digests = .all) -> [URL: ROMHash] {
+        var hashes = [ROMHash?](repeating: nil, count: urls.count)
+        hashes.withUnsafeMutableBufferPointer { results in
+            let results = results
+            DispatchQueue.concurrentPerform(iterations: urls.count) { i in
+                results[i] = try? hash(fileAt: urls[i], skip: skip, digests: digests)
+            }
+        }
+
+        var byURL: [URL: ROMHash] = [:]
+        for (url, hash) in zip(urls, hashes) {
+            byURL[url] = hash
+        }
+        return byURL
+    }
+
+    static func hex(_ bytes: [UInt8]) -> String {
+        let digits = Array("0123456789abcdef".utf8)
+        var chars = [UInt8]()
+        chars.reserveCapacity(bytes.count * 2)
+        for byte in bytes {
+            chars.append(digits[Int(byte >> 4)])
+            chars.append(digits[Int(byte & 0x0F)])
+        }
+        return String(decoding: chars, as: UTF8.self)
+    }
+}
+
+private extension ROMHash {
+    init(_ result: yearn_hash_result, digests: ROMHasher.Digests) {
+        var result = result
+        crc32 = result.crc32
+        md5 = digests.contains(.md5) ? withUnsafeBytes(of: &result.md5) { Array($0) } : nil
+        sha1 = digests.contains(.sha1) ? withUnsafeBytes(of: &result.sha1) { Array($0) } : nil
+        length = result.length
+    }
+}
@@ -0,0 +1,147 @@
+//
+//  FileSinks.swift
+//  YearnCore
+//
+//  Sinks that write a core's output to disk
+//
+
+import Foundation
+
+// MARK: - Video
+
+/// Writes every `interval`-th frame as a binary PPM, viewable almost anywhere
+public final class PPMVideoSink: VideoSink {
+    public let directory: URL
+    public let interval: Int
+    public private(set) var frames = 0
+    public private(set) var written = 0
+
+    private var bgra: [UInt8] = []
+    private var rgb: [UInt8] = []
+
+    /// - Parameter interval: 1 keeps every frame
+    public init(directory: URL, interval: Int = 60) throws {
+        self.directory = directory
+        self.interval = max(1, interval)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    public func configure(format: VideoFormat) {}
+
+    public func updateFrame(_ pixels: UnsafeRawPointer, width: Int, height: Int, pitch: Int, format: LibretroPixelFormat) {
+        defer { frames += 1 }
+        guard frames % interval == 0, width > 0, height > 0 else { return }
+
+        let count = width * height
+        if bgra.count != count * 4 {
+            bgra = [UInt8](repeating: 0, count: count * 4)
+            rgb = [UInt8](repeating: 0, count: count * 3)
+        }
+        bgra.withUnsafeMutableBytes { buffer in
+            PixelConversion.convertToBGRA(pixels, width: width, height: height, pitch: pitch,
+                                          format: format, into: buffer.baseAddress!)
+        }
+        for i in 0..<count {
+            rgb[i * 3 + 0] = bgra[i * 4 + 2]
+            rgb[i * 3 + 1] = bgra[i * 4 + 1]
+            rgb[i * 3 + 2] = bgra[i * 4 + 0]
+        }
+
+        var data = Data("P6\n\(width) \(height)\n255\n".utf8)
+        data.append(contentsOf: rgb)
+        let url = directory.appendingPathComponent(String(format: "frame-%06d.ppm", frames))
+        do {
+            try data.write(to: url)
+            written += 1
+        } catch {
+            Log.video.error("Could not write \(url.lastPathComponent): \(error)")
+        }
+    }
+}
+
+// MARK: - Audio
+
+/// Writes 16-bit PCM to a WAV file; call `close` to finish the header
+public final class WAVAudioSink: AudioSink {
+    public let url: URL
+    public private(set) var samples = 0
+
+    private let handle: FileHandle
+    private var format = AudioFormat(sampleRate: 44100, channels: 2)
+    private var pending = Data()
+    private var closed = false
+
+    private static let headerSize = 44
+    private static let flushSize = 64 * 1024
+
+    public init(url: URL) throws {
+        self.url = url
+        guard FileManager.default.createFile(atPath: url.path, contents: Data(count: Self.headerSize)) else {
+            throw CocoaError(.fileWriteUnknown, userInfo: [NSFilePathErrorKey: url.path])
+        }
+        handle = try FileHandle(forWritingTo: url)
+        try handle.seekToEnd()
+    }
+
+    deinit {
+        try? close()
+    }
+
+    public func configure(format: AudioFormat) {
+        self.format = format
+    }
+
+    public func writeSamples(_ samples: UnsafePointer<Int16>, count: Int) {
+        guard !closed, count > 0 else { return }
+        // WAV is little-endian, like every host this runs on
+        pending.append(UnsafeBufferPointer(start: samples, count: count))
+        self.samples += count
+        if pending.count >= Self.flushSize {
+            flush()
+        }
+    }
+
+    /// Write what is buffered and the final header
+    public func close() throws {
+        guard !closed else { return }
+        closed = true
+        flush()
+        try handle.seek(toOffset: 0)
+        try handle.write(contentsOf: header(dataSize: samples * 2))
+        try handle.close()
+    }
+
+    private func flush() {
+        guard !pending.isEmpty else { return }
+        do {
+            try handle.write(contentsOf: pending)
+        } catch {
+            Log.audio.error("Could not write \(url.lastPathComponent): \(error)")
+        }
+        pending.removeAll(keepingCapacity: true)
+    }
+
+    private func header(dataSize: Int) -> Data {
+        let channels = UInt16(format.channels)
+        let sampleRate = UInt32(format.sampleRate.rounded())
+        let blockAlign = channels * 2
+
+        var data = Data()
+        func append<T: FixedWidthInteger>(_ value: T) {
+            withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+        }
+        data.append(contentsOf: Array("RIFF".utf8))
+        append(UInt32(truncatingIfNeeded: 36 + dataSize))
+        data.append(contentsOf: Array("WAVEfmt ".utf8))
+        append(UInt32(16))                          // fmt chunk size
+        append(UInt16(1))                           // PCM
+        append(channels)
+        append(sampleRate)
+        append(sampleRate * UInt32(blockAlign))     // byte rate
+        append(blockAlign)
+        append(UInt16(16))                          // bits per sample
+        data.append(contentsOf: Array("data".utf8))
+        append(UInt32(truncatingIfNeeded: dataSize))
+        return data
+    }
+}
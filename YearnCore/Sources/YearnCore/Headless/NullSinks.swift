@@ -0,0 +1,53 @@
+//
+//  NullSinks.swift
+//  YearnCore
+//
+//  Sinks that only count what a core produces
+//
+
+import Foundation
+
+/// Drops frames, keeping a count and the last size
+public final class NullVideoSink: VideoSink {
+    public private(set) var format: VideoFormat?
+    public private(set) var frames = 0
+    public private(set) var lastSize = (width: 0, height: 0)
+
+    public init() {}
+
+    public func configure(format: VideoFormat) {
+        self.format = format
+    }
+
+    public func updateFrame(_ pixels: UnsafeRawPointer, width: Int, height: Int, pitch: Int, format: LibretroPixelFormat) {
+        frames += 1
+        lastSize = (width, height)
+    }
+}
+
+/// Drops samples, keeping a count
+public final class NullAudioSink: AudioSink {
+    public private(set) var format: AudioFormat?
+    public private(set) var samples = 0
+
+    public init() {}
+
+    public func configure(format: AudioFormat) {
+        self.format = format
+    }
+
+    public func writeSamples(_ samples: UnsafePointer<Int16>, count: Int) {
+        self.samples += count
+    }
+}
+
+/// Nothing is ever pressed
+public final class NullInputSource: InputSource {
+    public init() {}
+
+    public func poll(frame: Int) {}
+
+    public func inputState(port: UInt32, device: UInt32, index: UInt32, id: UInt32) -> Int16 {
+        0
+    }
+}
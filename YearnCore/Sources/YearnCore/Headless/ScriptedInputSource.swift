@@ -0,0 +1,133 @@
+//
+//  ScriptedInputSource.swift
+//  YearnCore
+//
+//  Joypad input replayed from a frame-numbered script
+//
+
+import Foundation
+
+/// Holds buttons according to a script, so headless runs are repeatable
+///
+/// One change per line: the frame it takes effect, the buttons held from
+/// then on, and optionally the port (0 when left out). `-` releases all.
+///
+///     # frame  buttons     port
+///     120      start
+///     126      -
+///     300      right,a
+///     300      left        1
+public final class ScriptedInputSource: InputSource {
+
+    public struct Change: Equatable {
+        public let frame: Int
+        public let port: Int
+        /// Bit n set while `RetroButton` n is held
+        public let buttons: UInt32
+
+        public init(frame: Int, port: Int = 0, buttons: UInt32) {
+            self.frame = frame
+            self.port = port
+            self.buttons = buttons
+        }
+    }
+
+    public struct ParseError: LocalizedError {
+        public let line: Int
+        public let message: String
+
+        public var errorDescription: String? {
+            "Input script line \(line): \(message)"
+        }
+    }
+
+    public let changes: [Change]
+    private var next = 0
+    private var held = [UInt32](repeating: 0, count: 4)
+
+    public init(changes: [Change]) {
+        self.changes = changes.sorted { $0.frame < $1.frame }
+    }
+
+    public convenience init(script: String) throws {
+        try self.init(changes: Self.parse(script))
+    }
+
+    public convenience init(url: URL) throws {
+        try self.init(script: String(contentsOf: url, encoding: .utf8))
+    }
+
+    // MARK: - InputSource
+
+    public func poll(frame: Int) {
+        while next < changes.count, changes[next].frame <= frame {
+            let change = changes[next]
+            if held.indices.contains(change.port) {
+                held[change.port] = change.buttons
+            }
+            next += 1
+        }
+    }
+
+    public func inputState(port: UInt32, device: UInt32, index: UInt32, id: UInt32) -> Int16 {
+        guard port < held.count else { return 0 }
+        return Self.joypadState(held[Int(port)], device: device, id: id)
+    }
+
+    // MARK: - Parsing
+
+    private static func button(named name: String) -> RetroButton? {
+        switch name.lowercased() {
+        case "b": return .b
+        case "y": return .y
+        case "select": return .select
+        case "start": return .start
+        case "up": return .up
+        case "down": return .down
+        case "left": return .left
+        case "right": return .right
+        case "a": return .a
+        case "x": return .x
+        case "l": return .l
+        case "r": return .r
+        case "l2": return .l2
+        case "r2": return .r2
+        case "l3": return .l3
+        case "r3": return .r3
+        default: return nil
+        }
+    }
+
+    public static func parse(_ script: String) throws -> [Change] {
+        var changes: [Change] = []
+        for (offset, rawLine) in script.split(separator: "\n", omittingEmptySubsequences: false).enumerated() {
+            let line = rawLine.split(separator: "#", maxSplits: 1, omittingEmptySubsequences: false)[0]
+            let fields = line.split(whereSeparator: { $0 == " " || $0 == "\t" || $0 == "\r" })
+            guard !fields.isEmpty else { continue }
+
+            let number = offset + 1
+            guard fields.count <= 3 else {
+                throw ParseError(line: number, message: "expected frame, buttons and optional port")
+            }
+            guard let frame = Int(fields[0]), frame >= 0 else {
+                throw ParseError(line: number, message: "not a frame number: \(fields[0])")
+            }
+            let port = fields.count == 3 ? Int(fields[2]) : 0
+            guard let port, port >= 0 && port < 4 else {
+                throw ParseError(line: number, message: "port must be 0 to 3")
+            }
+
+            var buttons: UInt32 = 0
+            if fields.count > 1 && fields[1] != "-" {
+                for name in fields[1].split(separator: ",") {
+                    guard let retroButton = button(named: String(name)) else {
+                        throw ParseError(line: number, message: "unknown button: \(name)")
+                    }
+                    buttons |= 1 << UInt32(retroButton.rawValue)
+                }
+            }
+            changes.append(Change(frame: frame, port: port, buttons: buttons))
+        }
+        return changes
+    }
+}
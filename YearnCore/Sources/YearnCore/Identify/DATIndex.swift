@@ -0,0 +1,348 @@
+//
+//  DATIndex.swift
+//  YearnCore
+//
+//  Memory-mapped hash index built from No-Intro / Redump DAT files
+//
+
+import Foundation
+#if canImport(FoundationXML)
+import FoundationXML
+#endif
+
+/// A DAT entry matching a ROM
+public struct DATMatch: Hashable, Sendable {
+    /// Canonical title, e.g. "Super Mario Bros. (World)"
+    public let title: String
+    /// First parenthesised tag of the title, e.g. "World", "USA, Europe"
+    public let region: String?
+    public let serial: String?
+    public let size: UInt64
+    public let crc32: UInt32
+    public let sha1: [UInt8]?
+}
+
+/// Sorted, memory-mapped index of ROM hashes
+///
+/// File layout (little-endian):
+///
+///     header   32 bytes   magic "YDAT", version, entry count, strings offset,
+///                         strings length, source fingerprint
+///     entries  48 bytes   crc32, title/region/serial string offsets, size,
+///                         sha1, flags; sorted by (crc32, sha1)
+///     strings             NUL-terminated UTF-8, deduplicated
+///
+/// Lookups binary-search the mapped entries, so opening an index costs a
+/// page fault rather than a parse and memory use stays flat however many
+/// DATs are loaded.
+public final class DATIndex: @unchecked Sendable {
+
+    public struct Entry {
+        public var title: String
+        public var region: String?
+        public var serial: String?
+        public var size: UInt64
+        public var crc32: UInt32
+        public var sha1: [UInt8]?
+    }
+
+    static let magic: UInt32 = 0x5441_4459    // "YDAT"
+    static let version: UInt32 = 1
+    static let headerSize = 32
+    static let entrySize = 48
+
+    private enum Field {
+        static let crc32 = 0
+        static let title = 4
+        static let region = 8
+        static let serial = 12
+        static let size = 16
+        static let sha1 = 24
+        static let flags = 44
+    }
+
+    private static let hasSHA1: UInt32 = 1 << 0
+
+    // MARK: - Properties
+
+    public let url: URL
+    public let count: Int
+
+    /// Fingerprint of the DAT files the index was built from
+    public let fingerprint: UInt64
+
+    private let data: Data
+    private let stringsOffset: Int
+    /// End of the strings section; bytes past it are not part of the index
+    private let stringsEnd: Int
+
+    // MARK: - Opening
+
+    /// Map an index file
+    public init(contentsOf url: URL) throws {
+        self.url = url
+        data = try Data(contentsOf: url, options: .alwaysMapped)
+
+        guard data.count >= Self.headerSize,
+              data.loadLE(UInt32.self, at: 0) == Self.magic,
+              data.loadLE(UInt32.self, at: 4) == Self.version else {
+            throw CocoaError(.fileReadCorruptFile)
+        }
+
+        count = Int(data.loadLE(UInt32.self, at: 8))
+        stringsOffset = Int(data.loadLE(UInt32.self, at: 12))
+        let stringsLength = Int(data.loadLE(UInt32.self, at: 16))
+        fingerprint = data.loadLE(UInt64.self, at: 20)
+        stringsEnd = stringsOffset + stringsLength
+
+        guard Self.headerSize + count * Self.entrySize <= stringsOffset,
+              stringsEnd <= data.count else {
+            throw CocoaError(.fileReadCorruptFile)
+        }
+    }
+
+    // MARK: - Lookup
+
+    /// Find the entry for a ROM
+    /// - Parameters:
+    ///   - crc32: CRC32 of the ROM (without copier header)
+    ///   - sha1: When given, must match entries that record a SHA-1
+    ///   - size: When given, must match the entry size
+    public func lookup(crc32: UInt32, sha1: [UInt8]? = nil, size: UInt64? = nil) -> DATMatch? {
+        // Lower bound of crc32
+        var low = 0
+        var high = count
+        while low < high {
+            let mid = (low + high) / 2
+            if data.loadLE(UInt32.self, at: entryOffset(mid) + Field.crc32) < crc32 {
+                low = mid + 1
+            } else {
+                high = mid
+            }
+        }
+
+        // CRC32 collisions are rare but real across a full set of DATs; the SHA-1 settles them
+        var index = low
+        while index < count, data.loadLE(UInt32.self, at: entryOffset(index) + Field.crc32) == crc32 {
+            let match = entry(at: index)
+            index += 1
+
+            if let size = size, match.size != 0, match.size != size { continue }
+            if let sha1 = sha1, let stored = match.sha1, stored != sha1 { continue }
+            return match
+        }
+        return nil
+    }
+
+    // MARK: - Building
+
+    /// Parse DAT files and write a sorted index
+    /// - Returns: Number of entries written
+    @discardableResult
+    public static func build(from datURLs: [URL], to indexURL: URL, fingerprint: UInt64) throws -> Int {
+        var entries: [Entry] = []
+        for datURL in datURLs {
+            do {
+                entries += try DATParser.parse(contentsOf: datURL)
+            } catch {
+                Log.library.warning("Skipping DAT \(datURL.lastPathComponent): \(error.localizedDescription)")
+            }
+        }
+
+        entries.sort {
+            if $0.crc32 != $1.crc32 { return $0.crc32 < $1.crc32 }
+            return ($0.sha1 ?? []).lexicographicallyPrecedes($1.sha1 ?? [])
+        }
+
+        // Strings are deduplicated; offset 0 is the empty string, meaning "none"
+        var strings = Data([0])
+        var stringOffsets: [String: UInt32] = [:]
+        func intern(_ string: String?) -> UInt32 {
+            guard let string = string, !string.isEmpty else { return 0 }
+            if let offset = stringOffsets[string] { return offset }
+            let offset = UInt32(strings.count)
+            strings.append(contentsOf: Array(string.utf8))
+            strings.append(0)
+            stringOffsets[string] = offset
+            return offset
+        }
+
+        var table = Data(capacity: entries.count * entrySize)
+        for entry in entries {
+            var record = Data(count: entrySize)
+            record.storeLE(entry.crc32, at: Field.crc32)
+            record.storeLE(intern(entry.title), at: Field.title)
+            record.storeLE(intern(entry.region), at: Field.region)
+            record.storeLE(intern(entry.serial), at: Field.serial)
+            record.storeLE(entry.size, at: Field.size)
+            if let sha1 = entry.sha1, sha1.count == 20 {
+                record.replaceSubrange(Field.sha1..<Field.sha1 + 20, with: sha1)
+                record.storeLE(hasSHA1, at: Field.flags)
+            }
+            table.append(record)
+        }
+
+        var header = Data(count: headerSize)
+        header.storeLE(magic, at: 0)
+        header.storeLE(version, at: 4)
+        header.storeLE(UInt32(entries.count), at: 8)
+        header.storeLE(UInt32(headerSize + table.count), at: 12)
+        header.storeLE(UInt32(strings.count), at: 16)
+        header.storeLE(fingerprint, at: 20)
+
+        try FileManager.default.createDirectory(at: indexURL.deletingLastPathComponent(),
+                                                withIntermediateDirectories: true)
+        try (header + table + strings).write(to: indexURL, options: .atomic)
+        return entries.count
+    }
+
+    // MARK: - Copier Headers
+
+    /// Bytes to skip before hashing, for formats whose DATs hash the ROM without its header
+    /// iNES / FDS headers are 16 bytes, Lynx (LYNX) headers 64 bytes
+    public static func headerSkip(forFileAt url: URL) -> UInt64 {
+        guard let handle = try? FileHandle(forReadingFrom: url) else { return 0 }
+        defer { try? handle.close() }
+        guard let bytes = try? handle.read(upToCount: 16), bytes.count >= 4 else { return 0 }
+
+        let magic = Array(bytes.prefix(4))
+        switch magic {
+        case [0x4E, 0x45, 0x53, 0x1A]:      // "NES\x1A"
+            return 16
+        case [0x46, 0x44, 0x53, 0x1A]:      // "FDS\x1A"
+            return 16
+        case [0x4C, 0x59, 0x4E, 0x58]:      // "LYNX"
+            return 64
+        default:
+            return 0
+        }
+    }
+
+    // MARK: - Private
+
+    private func entryOffset(_ index: Int) -> Int {
+        Self.headerSize + index * Self.entrySize
+    }
+
+    private func entry(at index: Int) -> DATMatch {
+        let base = entryOffset(index)
+        let hasSHA1 = data.loadLE(UInt32.self, at: base + Field.flags) & Self.hasSHA1 != 0
+        let title = string(at: data.loadLE(UInt32.self, at: base + Field.title)) ?? ""
+        return DATMatch(title: title,
+                        region: string(at: data.loadLE(UInt32.self, at: base + Field.region)),
+                        serial: string(at: data.loadLE(UInt32.self, at: base + Field.serial)),
+                        size: data.loadLE(UInt64.self, at: base + Field.size),
+                        crc32: data.loadLE(UInt32.self, at: base + Field.crc32),
+                        sha1: hasSHA1 ? Array(data[(base + Field.sha1)..<(base + Field.sha1 + 20)]) : nil)
+    }
+
+    private func string(at offset: UInt32) -> String? {
+        guard offset != 0 else { return nil }
+        return data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> String? in
+            let start = stringsOffset + Int(offset)
+            guard start < stringsEnd,
+                  let end = bytes[start..<stringsEnd].firstIndex(of: 0) else { return nil }
+            return String(decoding: UnsafeRawBufferPointer(rebasing: bytes[start..<end]), as: UTF8.self)
+        }
+    }
+}
+
+// MARK: - DAT Parsing
+
+/// Logiqx XML DAT reader (the format No-Intro and Redump publish)
+final class DATParser: NSObject, XMLParserDelegate {
+
+    private var entries: [DATIndex.Entry] = []
+    private var gameName: String?
+    private var gameSerial: String?
+    private var gameEntries: [DATIndex.Entry] = []
+    private var text = ""
+
+    static func parse(contentsOf url: URL) throws -> [DATIndex.Entry] {
+        guard let parser = XMLParser(contentsOf: url) else {
+            throw CocoaError(.fileReadNoSuchFile)
+        }
+        let reader = DATParser()
+        parser.delegate = reader
+        guard parser.parse() else {
+            throw parser.parserError ?? CocoaError(.fileReadCorruptFile)
+        }
+        return reader.entries
+    }
+
+    func parser(_ parser: XMLParser, didStartElement elementName: String, namespaceURI: String?,
+                qualifiedName qName: String?, attributes: [String: String] = [:]) {
+        text = ""
+        switch elementName {
+        case "game", "machine":
+            gameName = attributes["name"]
+            gameSerial = nil
+            gameEntries = []
+        case "rom":
+            guard let name = gameName,
+                  let crcText = attributes["crc"], let crc = UInt32(crcText, radix: 16) else { return }
+            gameEntries.append(DATIndex.Entry(title: name,
+                                              region: Self.region(in: name),
+                                              serial: attributes["serial"],
+                                              size: attributes["size"].flatMap { UInt64($0) } ?? 0,
+                                              crc32: crc,
+                                              sha1: attributes["sha1"].flatMap(Self.bytes(fromHex:))))
+        default:
+            break
+        }
+    }
+
+    func parser(_ parser: XMLParser, foundCharacters string: String) {
+        text += string
+    }
+
+    func parser(_ parser: XMLParser, didEndElement elementName: String, namespaceURI: String?,
+                qualifiedName qName: String?) {
+        switch elementName {
+        case "serial":
+            gameSerial = text.trimmingCharacters(in: .whitespacesAndNewlines)
+        case "game", "machine":
+            for var entry in gameEntries {
+                if entry.serial == nil { entry.serial = gameSerial }
+                entries.append(entry)
+            }
+            gameName = nil
+            gameEntries = []
+        default:
+            break
+        }
+    }
+
+    /// "Title (USA, Europe) (Rev 1)" -> "USA, Europe"
+    static func region(in title: String) -> String? {
+        guard let open = title.firstIndex(of: "("),
+              let close = title[open...].firstIndex(of: ")") else { return nil }
+        return String(title[title.index(after: open)..<close])
+    }
+
+    static func bytes(fromHex hex: String) -> [UInt8]? {
+        let chars = Array(hex.utf8)
+        guard chars.count % 2 == 0 else { return nil }
+        var bytes = [UInt8]()
+        bytes.reserveCapacity(chars.count / 2)
+        var i = 0
+        while i < chars.count {
+            guard let byte = UInt8(String(decoding: chars[i..<i + 2], as: UTF8.self), radix: 16) else { return nil }
+            bytes.append(byte)
+            i += 2
+        }
+        return bytes
+    }
+}
+
+// MARK: - Little-endian Helpers
+
+private extension Data {
+    func loadLE<T: FixedWidthInteger>(_ type: T.Type, at offset: Int) -> T {
+        withUnsafeBytes { T(littleEndian: $0.loadUnaligned(fromByteOffset: offset, as: T.self)) }
+    }
+
+    mutating func storeLE<T: FixedWidthInteger>(_ value: T, at offset: Int) {
+        withUnsafeMutableBytes { $0.storeBytes(of: value.littleEndian, toByteOffset: offset, as: T.self) }
+    }
+}
@@ -0,0 +1,218 @@
+//
+//  DATIndexStore.swift
+//  YearnCore
+//
+//  Keeps the DAT index in sync with the user's DAT folder and identifies ROMs
+//
+
+import Foundation
+
+/// Offline ROM identification against local No-Intro / Redump DATs
+///
+/// DAT files live in `Documents/DATs`. The index built from them is cached in
+/// `Caches/DATIndex/index.ydat` and rebuilt when the set of DATs (names, sizes,
+/// modification dates) changes.
+public final class DATIndexStore: @unchecked Sendable {
+
+    public static let shared = DATIndexStore()
+
+    /// Extensions accepted as DAT files
+    public static let datExtensions: Set<String> = ["dat", "xml"]
+
+    public struct Statistics {
+        public var entries = 0
+        public var buildTime: TimeInterval = 0
+        public var lookups = 0
+        public var matches = 0
+        public var lookupTime: TimeInterval = 0
+
+        /// Index lookups per second, excluding hashing
+        public var lookupRate: Double {
+            lookupTime > 0 ? Double(lookups) / lookupTime : 0
+        }
+    }
+
+    // MARK: - Properties
+
+    public let datDirectory: URL
+    public let indexURL: URL
+
+    private let fileManager = FileManager.default
+    private let lock = NSLock()
+    /// Held while an index is opened or built, so only one caller does it
+    private let buildLock = NSLock()
+    private var index: DATIndex?
+    private var lastCheck = Date.distantPast
+    private var stats = Statistics()
+
+    /// How long a loaded index is trusted before the DAT folder is checked again
+    private let recheckInterval: TimeInterval = 5
+
+    // MARK: - Initialization
+
+    private init() {
+        let documentsURL = fileManager.urls(for: .documentDirectory, in: .userDomainMask)[0]
+        let cachesURL = fileManager.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        datDirectory = documentsURL.appendingPathComponent("DATs", isDirectory: true)
+        indexURL = cachesURL.appendingPathComponent("DATIndex", isDirectory: true)
+            .appendingPathComponent("index.ydat")
+    }
+
+    // MARK: - Public Methods
+
+    public static func isDAT(_ url: URL) -> Bool {
+        datExtensions.contains(url.pathExtension.lowercased())
+    }
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Copy a DAT into the DAT folder; the index is rebuilt on next use
+    public func importDAT(from url: URL) throws {
+        try fileManager.createDirectory(at: datDirectory, withIntermediateDirectories: true)
+        let destination = datDirectory.appendingPathComponent(url.lastPathComponent)
+        if fileManager.fileExists(atPath: destination.path) {
+            try fileManager.removeItem(at: destination)
+        }
+        try fileManager.copyItem(at: url, to: destination)
+
+        lock.lock()
+        index = nil
+        lock.unlock()
+        Log.library.info("Imported DAT: \(url.lastPathComponent)")
+    }
+
+    /// Current index, rebuilding it if the DAT folder changed
+    /// Returns nil when there are no DATs
+    ///
+    /// The DAT folder is listed and the index parsed or built without holding
+    /// `lock`, so lookups keep using the loaded index until the new one is
+    /// swapped in.
+    public func currentIndex() -> DATIndex? {
+        lock.lock()
+        // Lookups during a library scan should not list the DAT folder each time
+        if let index = index, Date().timeIntervalSince(lastCheck) < recheckInterval {
+            lock.unlock()
+            return index
+        }
+        lastCheck = Date()
+        lock.unlock()
+
+        let dats = datFiles()
+        guard !dats.isEmpty else {
+            install(nil)
+            return nil
+        }
+        let fingerprint = Self.fingerprint(of: dats)
+        if let loaded = loadedIndex(matching: fingerprint) {
+            return loaded
+        }
+
+        buildLock.lock()
+        defer { buildLock.unlock() }
+        // Another caller may have built it while this one waited
+        if let loaded = loadedIndex(matching: fingerprint) {
+            return loaded
+        }
+        if let existing = try? DATIndex(contentsOf: indexURL), existing.fingerprint == fingerprint {
+            install(existing)
+            return existing
+        }
+
+        let start = Date()
+        do {
+            let count = try DATIndex.build(from: dats, to: indexURL, fingerprint: fingerprint)
+            let built = try DATIndex(contentsOf: indexURL)
+            let buildTime = Date().timeIntervalSince(start)
+            install(built, buildTime: buildTime)
+            Log.library.info("DAT index built: \(count) entries from \(dats.count) DAT(s) in \(Int(buildTime * 1000)) ms")
+            return built
+        } catch {
+            Log.library.error("Failed to build DAT index: \(error)")
+            install(nil)
+            return nil
+        }
+    }
+
+    /// Look up a ROM by the hashes of its contents
+    public func lookup(crc32: UInt32, sha1: [UInt8]? = nil, size: UInt64? = nil) -> DATMatch? {
+        guard let index = currentIndex() else { return nil }
+
+        let start = DispatchTime.now().uptimeNanoseconds
+        let match = index.lookup(crc32: crc32, sha1: sha1, size: size)
+        let elapsed = DispatchTime.now().uptimeNanoseconds - start
+
+        lock.lock()
+        stats.lookups += 1
+        stats.matches += match == nil ? 0 : 1
+        stats.lookupTime += TimeInterval(elapsed) / 1_000_000_000
+        lock.unlock()
+        return match
+    }
+
+    /// Identify a ROM file
+    /// Copier headers (iNES, FDS, Lynx) are skipped first, since DATs hash the
+    /// bare ROM; the whole file is tried as well for headered DATs. CRC32 plus
+    /// size is enough to pick an entry, so SHA-1 is not computed here.
+    public func identify(fileAt url: URL) -> DATMatch? {
+        guard currentIndex() != nil else { return nil }
+
+        let skip = DATIndex.headerSkip(forFileAt: url)
+        for offset in skip > 0 ? [skip, 0] : [0] {
+            guard let hash = try? ROMHasher.hash(fileAt: url, skip: offset, digests: .crc32) else { return nil }
+            if let match = lookup(crc32: hash.crc32, size: hash.length) {
+                return match
+            }
+        }
+        return nil
+    }
+
+    // MARK: - Private Methods
+
+    private func loadedIndex(matching fingerprint: UInt64) -> DATIndex? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let index = index, index.fingerprint == fingerprint else { return nil }
+        return index
+    }
+
+    private func install(_ newIndex: DATIndex?, buildTime: TimeInterval? = nil) {
+        lock.lock()
+        index = newIndex
+        stats.entries = newIndex?.count ?? 0
+        if let buildTime = buildTime {
+            stats.buildTime = buildTime
+        }
+        lock.unlock()
+    }
+
+    private func datFiles() -> [URL] {
+        let contents = (try? fileManager.contentsOfDirectory(at: datDirectory,
+                                                             includingPropertiesForKeys: [.fileSizeKey, .contentModificationDateKey],
+                                                             options: [.skipsHiddenFiles])) ?? []
+        return contents.filter(Self.isDAT).sorted { $0.lastPathComponent < $1.lastPathComponent }
+    }
+
+    /// FNV-1a over each DAT's name, size and modification date
+    private static func fingerprint(of dats: [URL]) -> UInt64 {
+        var hash: UInt64 = 0xcbf2_9ce4_8422_2325
+        func mix(_ bytes: [UInt8]) {
+            for byte in bytes {
+                hash ^= UInt64(byte)
+                hash = hash &* 0x0000_0100_0000_01B3
+            }
+        }
+        for url in dats {
+            let values = try? url.resourceValues(forKeys: [.fileSizeKey, .contentModificationDateKey])
+            let size = UInt64(values?.fileSize ?? 0)
+            let mtime = UInt64(max(values?.contentModificationDate?.timeIntervalSince1970 ?? 0, 0))
+            mix(Array(url.lastPathComponent.utf8))
+            mix(withUnsafeBytes(of: size.littleEndian) { Array($0) })
+            mix(withUnsafeBytes(of: mtime.littleEndian) { Array($0) })
+        }
+        return hash
+    }
+}
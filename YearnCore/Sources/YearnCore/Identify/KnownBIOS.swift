@@ -0,0 +1,27 @@
+//
+//  KnownBIOS.swift
+//  YearnCore
+//
+//  Hashes of the BIOS images the app validates against
+//
+
+import Foundation
+
+/// Reference hashes for user-supplied BIOS images
+///
+/// The images themselves are copyrighted and cannot ship with the app, so
+/// an imported file is accepted only if its MD5 matches one of these.
+public enum KnownBIOS {
+
+    /// Size of every PS1 BIOS image in the table
+    public static let ps1Size: Int64 = 524_288
+
+    /// MD5 of each PS1 BIOS image, keyed by the file name cores look for
+    public static let ps1MD5: [String: String] = [
+        "scph5500.bin": "8dd7d5296a650fac7319bce665a6a53c",
+        "scph5501.bin": "490f666e1afb15b7362b406ed1cea246",
+        "scph5502.bin": "32736f17079d0b2b7024407c39bd3050",
+        "scph1001.bin": "924e392ed05558ffdb115408c263dccf",
+        "psxonpsp660.bin": "c53ca5908936d412331790f4426c6c33",
+    ]
+}
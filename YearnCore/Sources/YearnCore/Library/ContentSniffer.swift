@@ -0,0 +1,85 @@
+//
+//  ContentSniffer.swift
+//  YearnCore
+//
+//  Identifies ROM and disc image formats from their headers
+//
+
+import Foundation
+import CYearnSupport
+
+/// Format recognised from a file's contents
+public enum SniffedFormat: String, CaseIterable, Sendable {
+    case nes
+    case fds
+    case snes
+    case gb
+    case gbc
+    case gba
+    case n64
+    case nds
+    case genesis
+    case ps1
+    /// An ISO9660 data disc that is not marked PlayStation
+    case iso9660
+
+    init?(_ system: yearn_sniff_system) {
+        switch system {
+        case YEARN_SNIFF_NES: self = .nes
+        case YEARN_SNIFF_FDS: self = .fds
+        case YEARN_SNIFF_SNES: self = .snes
+        case YEARN_SNIFF_GB: self = .gb
+        case YEARN_SNIFF_GBC: self = .gbc
+        case YEARN_SNIFF_GBA: self = .gba
+        case YEARN_SNIFF_N64: self = .n64
+        case YEARN_SNIFF_NDS: self = .nds
+        case YEARN_SNIFF_GENESIS: self = .genesis
+        case YEARN_SNIFF_PS1: self = .ps1
+        case YEARN_SNIFF_ISO9660: self = .iso9660
+        default: return nil
+        }
+    }
+}
+
+/// A candidate format with how sure the sniffer is about it
+public struct SniffResult: Hashable, Sendable {
+    public let format: SniffedFormat
+    /// 0...1; checksummed headers score above 0.9, bare magic strings lower
+    public let confidence: Float
+}
+
+/// Header sniffer backed by `yearn_sniff`
+///
+/// A file is opened once and the first 68 KB read in a single `pread`; every
+/// signature (N64 boot headers in all byte orders, SNES internal header
+/// checksums, GB/GBA/NDS logos and header CRCs, Genesis "SEGA", ISO9660
+/// PlayStation volume descriptors) is matched against that block.
+public enum ContentSniffer {
+
+    /// Candidates for a file, best first
+    /// - Returns: The candidates and the file size, or nil if the file cannot be read
+    public static func sniff(fileAt url: URL) -> (results: [SniffResult], fileSize: UInt64)? {
+        var raw = [yearn_sniff_result](repeating: yearn_sniff_result(), count: Int(YEARN_SNIFF_MAX_RESULTS))
+        var fileSize: UInt64 = 0
+        let count = yearn_sniff_file(url.path, &raw, Int32(raw.count), &fileSize)
+        guard count >= 0 else { return nil }
+        return (results(raw.prefix(Int(count))), fileSize)
+    }
+
+    /// Candidates for a header block already in memory
+    /// - Parameter fileSize: Size of the whole file; defaults to the block length
+    public static func sniff(data: Data, fileSize: UInt64? = nil) -> [SniffResult] {
+        var raw = [yearn_sniff_result](repeating: yearn_sniff_result(), count: Int(YEARN_SNIFF_MAX_RESULTS))
+        let count = data.withUnsafeBytes { bytes in
+            yearn_sniff_buffer(bytes.bindMemory(to: UInt8.self).baseAddress, bytes.count,
+                               fileSize ?? UInt64(bytes.count), &raw, Int32(raw.count))
+        }
+        return results(raw.prefix(Int(count)))
+    }
+
+    static func results<Raw: Sequence>(_ raw: Raw) -> [SniffResult] where Raw.Element == yearn_sniff_result {
+        raw.compactMap { result in
+            SniffedFormat(result.system).map { SniffResult(format: $0, confidence: result.confidence) }
+        }
+    }
+}
@@ -0,0 +1,361 @@
+//
+//  ImportPipeline.swift
+//  YearnCore
+//
+//  Parallel ROM import: clone or single-pass copy, hash and classify
+//
+
+import Foundation
+import CYearnSupport
+
+/// Imports ROM files into the library on a bounded pool of workers
+///
+/// Each file is read once: `yearn_import` clones it where the filesystem
+/// allows (APFS) or copies it in chunks that also feed the CRC32 and the
+/// header sniffer. The copy lands in a staging folder next to the library
+/// and is renamed into its system folder once classified, so nothing half
+/// written ever shows up in a scan. Each run stages in its own subfolder,
+/// so runs that overlap never remove each other's files.
+public final class ImportPipeline: @unchecked Sendable {
+
+    /// A file to import, with the files that travel with it (.cue, .ccd, .sub)
+    public struct Job: Sendable {
+        public let source: URL
+        public let companions: [URL]
+
+        public init(source: URL, companions: [URL] = []) {
+            self.source = source
+            self.companions = companions
+        }
+    }
+
+    /// A file that made it into the library
+    public struct Imported: Sendable {
+        public let source: URL
+        public let destination: URL
+        public let system: String
+        /// CRC32 without copier header; nil if hashing was off
+        public let crc32: UInt32?
+        /// Canonical title from the DAT index
+        public let title: String?
+        public let size: UInt64
+        public let cloned: Bool
+    }
+
+    public struct Failure: Error {
+        public let source: URL
+        public let error: Error
+    }
+
+    /// Snapshot handed to the progress callback
+    public struct Progress: Sendable {
+        public var completedFiles = 0
+        public var totalFiles = 0
+        public var bytesDone: UInt64 = 0
+        public var totalBytes: UInt64 = 0
+        /// Name of the file most recently started
+        public var currentFile = ""
+    }
+
+    public enum ImportError: LocalizedError {
+        case unsupportedFormat(String)
+
+        public var errorDescription: String? {
+            switch self {
+            case .unsupportedFormat(let ext): return "Unsupported file format: .\(ext)"
+            }
+        }
+    }
+
+    /// Picks a system identifier for a file from its sniffed header; nil rejects it
+    public typealias Classifier = @Sendable (_ source: URL, _ sniffed: [SniffResult], _ fileSize: UInt64) -> String?
+
+    /// Folder a file of the given system is imported into
+    public typealias Destination = @Sendable (_ system: String) -> URL
+
+    public struct Statistics {
+        public var files = 0
+        public var failed = 0
+        public var cloned = 0
+        public var bytes: UInt64 = 0
+        public var duration: TimeInterval = 0
+
+        public var throughput: Double {
+            duration > 0 ? Double(bytes) / duration : 0
+        }
+    }
+
+    // MARK: - Properties
+
+    /// Staging folder; must be on the same volume as the destinations
+    public let stagingDirectory: URL
+
+    /// Age after which a run's subfolder is taken as left behind by a crash
+    public var staleStagingAge: TimeInterval = 24 * 60 * 60
+
+    /// Files imported at once; imports are I/O bound, so a few workers suffice
+    public var maxConcurrentWorkers = max(1, min(ProcessInfo.processInfo.activeProcessorCount, 3))
+
+    /// Hash imported files and look them up in the DAT index
+    public var identifiesFiles = true
+
+    /// How often progress is reported while files are copying
+    public var progressInterval: TimeInterval = 0.1
+
+    public private(set) var statistics = Statistics()
+
+    private let fileManager = FileManager.default
+    private let lock = NSLock()
+    private var progress = Progress()
+
+    // MARK: - Initialization
+
+    public init(stagingDirectory: URL) {
+        self.stagingDirectory = stagingDirectory
+    }
+
+    // MARK: - Importing
+
+    /// Import files
+    /// - Parameters:
+    ///   - jobs: Files to import
+    ///   - classify: Decides each file's system from its sniffed header
+    ///   - destination: Folder for each system
+    ///   - onProgress: Called every `progressInterval` and after each file
+    public func run(_ jobs: [Job],
+                    classify: @escaping Classifier,
+                    destination: @escaping Destination,
+                    onProgress: @escaping @Sendable (Progress) async -> Void) async -> (imported: [Imported], failed: [Failure]) {
+        let start = Date()
+        removeStaleRuns()
+        let staging = stagingDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        do {
+            try fileManager.createDirectory(at: staging, withIntermediateDirectories: true)
+        } catch {
+            return ([], jobs.map { Failure(source: $0.source, error: error) })
+        }
+        defer { try? fileManager.removeItem(at: staging) }
+
+        lock.lock()
+        progress = Progress(totalFiles: jobs.count,
+                            totalBytes: jobs.reduce(0) { $0 + Self.size(of: $1.source) })
+        lock.unlock()
+
+        // Byte-level progress for large discs, throttled
+        let interval = progressInterval
+        let reporter = Task { [weak self] in
+            while !Task.isCancelled {
+                try? await Task.sleep(nanoseconds: UInt64(interval * 1_000_000_000))
+                guard let self = self, !Task.isCancelled else { return }
+                await onProgress(self.currentProgress)
+            }
+        }
+        defer { reporter.cancel() }
+
+        var imported: [Imported] = []
+        var failed: [Failure] = []
+        let workers = maxConcurrentWorkers
+        let identifies = identifiesFiles
+
+        await withTaskGroup(of: Result<Imported, Failure>.self) { group in
+            var next = 0
+
+            func submit() {
+                let job = jobs[next]
+                next += 1
+                group.addTask { [self] in
+                    self.importFile(job, staging: staging, identify: identifies,
+                                    classify: classify, destination: destination)
+                }
+            }
+
+            while next < min(workers, jobs.count) { submit() }
+
+            for await result in group {
+                if next < jobs.count && !Task.isCancelled { submit() }
+                switch result {
+                case .success(let file): imported.append(file)
+                case .failure(let failure): failed.append(failure)
+                }
+                lock.lock()
+                progress.completedFiles += 1
+                let snapshot = progress
+                lock.unlock()
+                await onProgress(snapshot)
+            }
+        }
+
+        var stats = Statistics()
+        stats.files = imported.count
+        stats.failed = failed.count
+        stats.cloned = imported.filter(\.cloned).count
+        stats.bytes = imported.reduce(0) { $0 + $1.size }
+        stats.duration = Date().timeIntervalSince(start)
+        statistics = stats
+        Log.library.info("Imported \(stats.files) file(s), \(stats.failed) failed, \(stats.cloned) cloned, "
+                         + "\(stats.bytes / 1024 / 1024) MB in \(Int(stats.duration * 1000)) ms")
+
+        return (imported, failed)
+    }
+
+    // MARK: - Private Methods
+
+    private var currentProgress: Progress {
+        lock.lock()
+        defer { lock.unlock() }
+        return progress
+    }
+
+    /// Remove run folders old enough that no import can still be using them
+    private func removeStaleRuns() {
+        let cutoff = Date().addingTimeInterval(-staleStagingAge)
+        let runs = (try? fileManager.contentsOfDirectory(at: stagingDirectory,
+                                                         includingPropertiesForKeys: [.contentModificationDateKey])) ?? []
+        for run in runs {
+            let modified = (try? run.resourceValues(forKeys: [.contentModificationDateKey]))?.contentModificationDate
+            if let modified, modified < cutoff {
+                try? fileManager.removeItem(at: run)
+            }
+        }
+    }
+
+    private func importFile(_ job: Job, staging: URL, identify: Bool,
+                            classify: Classifier, destination: Destination) -> Result<Imported, Failure> {
+        let source = job.source
+        let accessing = source.startAccessingSecurityScopedResource()
+        defer {
+            if accessing {
+                source.stopAccessingSecurityScopedResource()
+            }
+        }
+
+        lock.lock()
+        progress.currentFile = source.lastPathComponent
+        lock.unlock()
+
+        do {
+            let staged = staging.appendingPathComponent(UUID().uuidString + "-" + source.lastPathComponent)
+            let result = try copy(source, to: staged, digests: identify ? .crc32 : [], countsProgress: true)
+
+            let sniffed = withUnsafeBytes(of: result.sniff) { raw in
+                ContentSniffer.results(raw.bindMemory(to: yearn_sniff_result.self).prefix(Int(result.sniff_count)))
+            }
+
+            guard let system = classify(source, sniffed, result.size) else {
+                try? fileManager.removeItem(at: staged)
+                throw ImportError.unsupportedFormat(source.pathExtension.lowercased())
+            }
+
+            let folder = destination(system)
+            try fileManager.createDirectory(at: folder, withIntermediateDirectories: true)
+            let target = folder.appendingPathComponent(source.lastPathComponent)
+            try moveReplacing(staged, to: target)
+
+            for companion in job.companions {
+                copyCompanion(companion, into: folder, staging: staging)
+            }
+
+            var title: String?
+            if identify {
+                // DATs hash the ROM without a copier header; headered DATs hash the whole file
+                title = DATIndexStore.shared.lookup(crc32: result.hash.crc32, size: result.hash.length)?.title
+                if title == nil, result.header_skip > 0 {
+                    title = DATIndexStore.shared.lookup(crc32: result.crc32_whole, size: result.size)?.title
+                }
+            }
+
+            return .success(Imported(source: source,
+                                     destination: target,
+                                     system: system,
+                                     crc32: identify ? result.hash.crc32 : nil,
+                                     title: title,
+                                     size: result.size,
+                                     cloned: result.cloned != 0))
+        } catch {
+            Log.library.error("Import failed: \(source.lastPathComponent): \(error.localizedDescription)")
+            return .failure(Failure(source: source, error: error))
+        }
+    }
+
+    /// Auxiliary files are small (or cloned) and are not hashed
+    private func copyCompanion(_ companion: URL, into folder: URL, staging: URL) {
+        let accessing = companion.startAccessingSecurityScopedResource()
+        defer {
+            if accessing {
+                companion.stopAccessingSecurityScopedResource()
+            }
+        }
+        guard fileManager.fileExists(atPath: companion.path) else { return }
+
+        let staged = staging.appendingPathComponent(UUID().uuidString + "-" + companion.lastPathComponent)
+        do {
+            _ = try copy(companion, to: staged, digests: [], countsProgress: false)
+            try moveReplacing(staged, to: folder.appendingPathComponent(companion.lastPathComponent))
+            Log.library.debug("Also copied: \(companion.lastPathComponent)")
+        } catch {
+            try? fileManager.removeItem(at: staged)
+            Log.library.warning("Failed to copy \(companion.lastPathComponent): \(error)")
+        }
+    }
+
+    private func copy(_ source: URL, to staged: URL, digests: ROMHasher.Digests, countsProgress: Bool) throws -> yearn_import_result {
+        let context = CopyContext(pipeline: countsProgress ? self : nil)
+        let unmanaged = Unmanaged.passRetained(context)
+        defer { unmanaged.release() }
+
+        var result = yearn_import_result()
+        let status = yearn_import_file(source.path, staged.path, digests.rawValue, { context, done, _ in
+            guard let context = context else { return 0 }
+            let copy = Unmanaged<CopyContext>.fromOpaque(context).takeUnretainedValue()
+            return copy.advance(to: done) ? 1 : 0
+        }, unmanaged.toOpaque(), &result)
+        // Read before anything else can make a call that sets it
+        let code = errno
+
+        guard status == 0 else {
+            throw POSIXError(POSIXErrorCode(rawValue: code) ?? .EIO)
+        }
+        return result
+    }
+
+    private func moveReplacing(_ source: URL, to destination: URL) throws {
+        if fileManager.fileExists(atPath: destination.path) {
+            try fileManager.removeItem(at: destination)
+        }
+        try fileManager.moveItem(at: source, to: destination)
+    }
+
+    fileprivate func addBytes(_ count: UInt64) {
+        lock.lock()
+        progress.bytesDone += count
+        lock.unlock()
+    }
+
+    private static func size(of url: URL) -> UInt64 {
+        let accessing = url.startAccessingSecurityScopedResource()
+        defer {
+            if accessing {
+                url.stopAccessingSecurityScopedResource()
+            }
+        }
+        let size = (try? url.resourceValues(forKeys: [.fileSizeKey]))?.fileSize ?? 0
+        return UInt64(size)
+    }
+}
+
+/// Per-copy state handed to the C progress callback
+private final class CopyContext {
+    private weak var pipeline: ImportPipeline?
+    private var reported: UInt64 = 0
+
+    init(pipeline: ImportPipeline?) {
+        self.pipeline = pipeline
+    }
+
+    /// Returns true to cancel the copy
+    func advance(to done: UInt64) -> Bool {
+        pipeline?.addBytes(done - reported)
+        reported = done
+        return Task.isCancelled
+    }
+}
@@ -0,0 +1,35 @@
+//
+//  IndexDiff.swift
+//  YearnCore
+//
+//  What to send an external index so it matches the library
+//
+
+import Foundation
+
+/// Items to submit and identifiers to delete so an index matches the current items
+///
+/// The index is described by a manifest of what was last submitted, keyed by
+/// identifier. An item is submitted again only when the attributes it would
+/// be indexed from differ from the manifest's, so an unchanged library
+/// submits nothing however it is ordered.
+public struct IndexDiff<Item> {
+    public var changed: [Item] = []
+    public var removed: [String] = []
+
+    public var isEmpty: Bool { changed.isEmpty && removed.isEmpty }
+
+    public init<Attributes: Equatable>(_ items: [Item], against entries: [String: Attributes],
+                                       identifier: (Item) -> String, attributes: (Item) -> Attributes) {
+        var current = Set<String>()
+        current.reserveCapacity(items.count)
+        for item in items {
+            let key = identifier(item)
+            current.insert(key)
+            if entries[key] != attributes(item) {
+                changed.append(item)
+            }
+        }
+        removed = entries.keys.filter { !current.contains($0) }
+    }
+}
@@ -0,0 +1,351 @@
+//
+//  LibraryScanner.swift
+//  YearnCore
+//
+//  Incremental ROM folder scanner with a persisted scan cache
+//
+
+import Foundation
+#if canImport(Darwin)
+import Darwin
+#else
+import Glibc
+#endif
+
+/// What the scanner knows about one file
+public struct ScanRecord: Codable, Hashable, Sendable {
+    /// Derived from the path, so it survives the cache being purged; see `LibraryScanner.stableID(forPath:)`
+    public internal(set) var id: UUID
+    /// Path relative to the scan root
+    public let path: String
+    public let size: Int64
+    public let modificationTime: Double
+    public let inode: UInt64
+    public let creationDate: Date?
+
+    /// System identifier from the classifier; nil if the file is not a ROM
+    public var system: String?
+    /// CRC32 of the ROM without copier header
+    public var crc32: UInt32?
+    /// Canonical title from the DAT index
+    public var title: String?
+    /// Fingerprint of the DAT index `title` was looked up in; nil if there was none
+    public var datFingerprint: UInt64?
+}
+
+/// Scans a ROM folder, re-examining only files whose size, mtime or inode changed
+///
+/// Results from the previous scan are persisted to `cacheURL`. A warm scan
+/// costs one `stat` per file; new or changed files are classified and hashed
+/// on a bounded pool of workers and published in batches as they finish.
+/// Cancelling the calling task stops the scan at the next batch of files and
+/// leaves the cache as it was.
+public final class LibraryScanner: @unchecked Sendable {
+
+    /// Decides which of the enumerated files to examine (e.g. drop .bin tracks that have a .cue)
+    public typealias Filter = @Sendable (_ files: [URL]) -> [URL]
+
+    /// Returns a system identifier for a file, or nil if it is not a ROM
+    public typealias Classifier = @Sendable (_ file: URL) -> String?
+
+    public struct Statistics {
+        public var files = 0
+        public var reused = 0
+        public var examined = 0
+        public var hashedBytes: Int64 = 0
+        public var duration: TimeInterval = 0
+    }
+
+    // MARK: - Properties
+
+    public let root: URL
+    public let cacheURL: URL
+
+    /// Workers examining new files at once
+    public var maxConcurrentWorkers = max(1, min(ProcessInfo.processInfo.activeProcessorCount, 4))
+
+    /// Records per published batch
+    public var batchSize = 200
+
+    /// Hash new files and look them up in the DAT index
+    public var identifiesFiles = true
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Old identifier to new, for cached records whose identifier was not
+    /// derived from the path yet; data keyed by the old one should move
+    public var reassignedIDs: [UUID: UUID] {
+        lock.lock()
+        defer { lock.unlock() }
+        return reassigned
+    }
+
+    /// Files enumerated or checked between looks at task cancellation
+    private static let cancellationStride = 256
+
+    private let fileManager = FileManager.default
+    private let lock = NSLock()
+    private var stats = Statistics()
+    private var reassigned: [UUID: UUID] = [:]
+
+    // MARK: - Initialization
+
+    public init(root: URL, cacheURL: URL) {
+        self.root = root
+        self.cacheURL = cacheURL
+    }
+
+    // MARK: - Identity
+
+    /// Name-based (version 5) UUID of a path relative to the scan root
+    ///
+    /// The same file gets the same identifier on every scan and on every
+    /// device, without anything stored; saves, covers and history keyed by it
+    /// follow the file until it is moved or renamed.
+    public static func stableID(forPath path: String) -> UUID {
+        let name = Data(("yearn.library:" + path.precomposedStringWithCanonicalMapping).utf8)
+        var bytes = ROMHasher.hash(data: name, digests: .sha1).sha1 ?? []
+        bytes += [UInt8](repeating: 0, count: max(0, 16 - bytes.count))
+        bytes[6] = (bytes[6] & 0x0F) | 0x50     // version 5
+        bytes[8] = (bytes[8] & 0x3F) | 0x80     // RFC 4122 variant
+        return UUID(uuid: (bytes[0], bytes[1], bytes[2], bytes[3], bytes[4], bytes[5], bytes[6], bytes[7],
+                           bytes[8], bytes[9], bytes[10], bytes[11], bytes[12], bytes[13], bytes[14], bytes[15]))
+    }
+
+    // MARK: - Scanning
+
+    /// Scan the folder
+    /// - Parameters:
+    ///   - filter: Narrows the enumerated files before anything is examined
+    ///   - classify: Called for new and changed files only
+    ///   - onBatch: Receives ROM records (system != nil) in batches; unchanged
+    ///     files come first in one batch, examined files follow as they finish
+    /// - Returns: Every ROM record, in no particular order; empty if the task was cancelled
+    @discardableResult
+    public func scan(filter: Filter,
+                     classify: @escaping Classifier,
+                     onBatch: @escaping @Sendable ([ScanRecord]) async -> Void) async -> [ScanRecord] {
+        let start = Date()
+        var stats = Statistics()
+
+        var reassigned: [UUID: UUID] = [:]
+
+        let cached = loadCache()
+        let files = filter(enumerateFiles())
+        guard !Task.isCancelled else { return cancelled() }
+        stats.files = files.count
+        let datFingerprint = identifiesFiles ? DATIndexStore.shared.currentIndex()?.fingerprint : nil
+
+        // Pass 1: stat every file and reuse what has not changed
+        var records: [ScanRecord] = []
+        var pending: [ScanRecord] = []
+        let rootPath = root.path
+
+        for (index, file) in files.enumerated() {
+            if index % Self.cancellationStride == 0 && Task.isCancelled { return cancelled() }
+            let path = String(file.path.dropFirst(rootPath.count + 1))
+            guard let info = Self.fileInfo(atPath: file.path) else { continue }
+
+            let id = Self.stableID(forPath: path)
+            if let oldID = cached[path]?.id, oldID != id {
+                reassigned[oldID] = id
+            }
+
+            if var old = cached[path], old.size == info.size, old.modificationTime == info.mtime, old.inode == info.inode {
+                old.id = id
+                // DATs installed since the file was hashed may name it now
+                if let crc32 = old.crc32, old.datFingerprint != datFingerprint {
+                    old.title = DATIndexStore.shared.lookup(crc32: crc32)?.title
+                    old.datFingerprint = datFingerprint
+                }
+                records.append(old)
+            } else {
+                pending.append(ScanRecord(id: id,
+                                          path: path,
+                                          size: info.size,
+                                          modificationTime: info.mtime,
+                                          inode: info.inode,
+                                          creationDate: info.birthtime))
+            }
+        }
+        stats.reused = records.count
+
+        let reusedROMs = records.filter { $0.system != nil }
+        if !reusedROMs.isEmpty {
+            await onBatch(reusedROMs)
+        }
+
+        // Pass 2: examine new and changed files on a bounded pool
+        if !pending.isEmpty {
+            let root = self.root
+            let identifies = identifiesFiles
+            let batchSize = self.batchSize
+            let workers = maxConcurrentWorkers
+
+            var examined: [ScanRecord] = []
+            await withTaskGroup(of: ScanRecord.self) { group in
+                var next = 0
+                var batch: [ScanRecord] = []
+
+                func submit() {
+                    let record = pending[next]
+                    next += 1
+                    group.addTask {
+                        Self.examine(record, root: root, identify: identifies, datFingerprint: datFingerprint,
+                                     classify: classify)
+                    }
+                }
+
+                while next < min(workers, pending.count) { submit() }
+
+                for await record in group {
+                    // Workers already running finish; nothing new starts and nothing more is published
+                    guard !Task.isCancelled else { continue }
+                    if next < pending.count { submit() }
+                    examined.append(record)
+                    if record.system != nil {
+                        batch.append(record)
+                    }
+                    if batch.count >= batchSize {
+                        await onBatch(batch)
+                        batch.removeAll(keepingCapacity: true)
+                    }
+                }
+                if !batch.isEmpty && !Task.isCancelled {
+                    await onBatch(batch)
+                }
+            }
+
+            stats.examined = examined.count
+            stats.hashedBytes = examined.filter { $0.crc32 != nil }.reduce(0) { $0 + $1.size }
+            records += examined
+        }
+
+        // A partial scan would make the next one re-examine whatever it missed
+        guard !Task.isCancelled else { return cancelled() }
+        saveCache(records)
+
+        stats.duration = Date().timeIntervalSince(start)
+        lock.lock()
+        self.stats = stats
+        self.reassigned = reassigned
+        lock.unlock()
+        Log.library.info("Scanned \(stats.files) files in \(Int(stats.duration * 1000)) ms "
+                         + "(\(stats.reused) unchanged, \(stats.examined) examined)")
+
+        return records.filter { $0.system != nil }
+    }
+
+    /// Forget cached results so the next scan examines every file
+    public func invalidate() {
+        try? fileManager.removeItem(at: cacheURL)
+    }
+
+    /// Record files that were already classified and hashed elsewhere (e.g. while importing)
+    /// so the next scan reuses them instead of reading them again
+    public func adopt(_ files: [(url: URL, system: String, crc32: UInt32?, title: String?)]) {
+        guard !files.isEmpty else { return }
+        var cached = loadCache()
+        let rootPath = root.path
+
+        for file in files where file.url.path.hasPrefix(rootPath + "/") {
+            let path = String(file.url.path.dropFirst(rootPath.count + 1))
+            guard let info = Self.fileInfo(atPath: file.url.path) else { continue }
+            var record = ScanRecord(id: Self.stableID(forPath: path),
+                                    path: path,
+                                    size: info.size,
+                                    modificationTime: info.mtime,
+                                    inode: info.inode,
+                                    creationDate: info.birthtime)
+            record.system = file.system
+            record.crc32 = file.crc32
+            record.title = file.title
+            record.datFingerprint = file.crc32 == nil ? nil : DATIndexStore.shared.currentIndex()?.fingerprint
+            cached[path] = record
+        }
+        saveCache(Array(cached.values))
+    }
+
+    // MARK: - Private Methods
+
+    private func cancelled() -> [ScanRecord] {
+        Log.library.info("Scan cancelled")
+        return []
+    }
+
+    private static func examine(_ record: ScanRecord, root: URL, identify: Bool, datFingerprint: UInt64?,
+                                classify: Classifier) -> ScanRecord {
+        var record = record
+        let url = root.appendingPathComponent(record.path)
+        record.system = classify(url)
+
+        if identify, record.system != nil, !ROMArchiveCache.isArchive(url) {
+            let skip = DATIndex.headerSkip(forFileAt: url)
+            if let hash = try? ROMHasher.hash(fileAt: url, skip: skip, digests: .crc32) {
+                record.crc32 = hash.crc32
+                record.title = DATIndexStore.shared.lookup(crc32: hash.crc32, size: hash.length)?.title
+                record.datFingerprint = datFingerprint
+            }
+        }
+        return record
+    }
+
+    /// Every non-hidden path under the root; regular files are picked out by the `lstat` in pass 1
+    private func enumerateFiles() -> [URL] {
+        guard let enumerator = fileManager.enumerator(atPath: root.path) else { return [] }
+
+        var files: [URL] = []
+        while let path = enumerator.nextObject() as? String {
+            if files.count % Self.cancellationStride == 0 && Task.isCancelled { return [] }
+            if NSString(string: path).lastPathComponent.hasPrefix(".") {
+                enumerator.skipDescendants()
+                continue
+            }
+            files.append(root.appendingPathComponent(path))
+        }
+        return files
+    }
+
+    private func loadCache() -> [String: ScanRecord] {
+        guard let data = try? Data(contentsOf: cacheURL),
+              let records = try? PropertyListDecoder().decode([ScanRecord].self, from: data) else {
+            return [:]
+        }
+        return Dictionary(records.map { ($0.path, $0) }, uniquingKeysWith: { first, _ in first })
+    }
+
+    private func saveCache(_ records: [ScanRecord]) {
+        let encoder = PropertyListEncoder()
+        encoder.outputFormat = .binary
+        do {
+            try fileManager.createDirectory(at: cacheURL.deletingLastPathComponent(), withIntermediateDirectories: true)
+            try encoder.encode(records).write(to: cacheURL, options: .atomic)
+        } catch {
+            Log.library.warning("Failed to save scan cache: \(error)")
+        }
+    }
+
+    private struct FileInfo {
+        let size: Int64
+        let mtime: Double
+        let inode: UInt64
+        let birthtime: Date?
+    }
+
+    private static func fileInfo(atPath path: String) -> FileInfo? {
+        var info = stat()
+        guard lstat(path, &info) == 0, (info.st_mode & S_IFMT) == S_IFREG else { return nil }
+#if canImport(Darwin)
+        let mtime = Double(info.st_mtimespec.tv_sec) + Double(info.st_mtimespec.tv_nsec) / 1e9
+        let birth = Date(timeIntervalSince1970: Double(info.st_birthtimespec.tv_sec))
+#else
+        let mtime = Double(info.st_mtim.tv_sec) + Double(info.st_mtim.tv_nsec) / 1e9
+        let birth: Date? = nil
+#endif
+        return FileInfo(size: Int64(info.st_size), mtime: mtime, inode: UInt64(info.st_ino), birthtime: birth)
+    }
+}
@@ -0,0 +1,480 @@
+//
+//  LibraryStore.swift
+//  YearnCore
+//
+//  SQLite-backed game library with indexed queries and trigram title search
+//
+
+import Foundation
+import CSQLite
+
+/// Queryable copy of the game library
+///
+/// Filtering, sorting and searching run in SQLite instead of over an
+/// in-memory array, so their cost follows the page size rather than the
+/// library size. The database runs in WAL mode; every statement is prepared
+/// once and reused. Titles are indexed by an FTS5 trigram table, which
+/// matches any substring of three or more characters; shorter words fall
+/// back to `LIKE`. Sort orders are served by covering indexes that end in
+/// the game ID, so a page of IDs never touches the table itself.
+public final class LibraryStore: @unchecked Sendable {
+
+    public struct Entry: Hashable, Sendable {
+        public var id: UUID
+        public var path: String
+        public var name: String
+        public var system: String
+        public var size: Int64
+        public var crc32: UInt32?
+        public var dateAdded: Date?
+        public var lastPlayed: Date?
+        public var playTime: TimeInterval
+        public var isFavorite: Bool
+
+        public init(id: UUID, path: String, name: String, system: String, size: Int64 = 0,
+                    crc32: UInt32? = nil, dateAdded: Date? = nil, lastPlayed: Date? = nil,
+                    playTime: TimeInterval = 0, isFavorite: Bool = false) {
+            self.id = id
+            self.path = path
+            self.name = name
+            self.system = system
+            self.size = size
+            self.crc32 = crc32
+            self.dateAdded = dateAdded
+            self.lastPlayed = lastPlayed
+            self.playTime = playTime
+            self.isFavorite = isFavorite
+        }
+    }
+
+    public enum Order: Hashable, Sendable {
+        case name
+        case system
+        case dateAdded
+        case lastPlayed
+    }
+
+    public struct Query: Hashable, Sendable {
+        /// Words that must all appear in the title, in any case
+        public var search: String
+        public var system: String?
+        public var favoritesOnly: Bool
+        public var playedOnly: Bool
+        public var order: Order
+
+        public init(search: String = "", system: String? = nil, favoritesOnly: Bool = false,
+                    playedOnly: Bool = false, order: Order = .name) {
+            self.search = search
+            self.system = system
+            self.favoritesOnly = favoritesOnly
+            self.playedOnly = playedOnly
+            self.order = order
+        }
+    }
+
+    public enum StoreError: LocalizedError {
+        case sqlite(code: Int32, message: String)
+
+        public var errorDescription: String? {
+            switch self {
+            case .sqlite(let code, let message): return "SQLite error \(code): \(message)"
+            }
+        }
+    }
+
+    public struct Statistics {
+        public var queries = 0
+        public var queryTime: TimeInterval = 0
+        public var lastQueryTime: TimeInterval = 0
+        public var writes = 0
+
+        /// Average query latency in milliseconds
+        public var averageQueryTime: Double {
+            queries > 0 ? queryTime / Double(queries) * 1000 : 0
+        }
+    }
+
+    // MARK: - Properties
+
+    public let url: URL
+
+    private let db: OpaquePointer
+    private let lock = NSLock()
+    private var statements: [String: OpaquePointer] = [:]
+    private var stats = Statistics()
+
+    private static let schemaVersion: Int32 = 1
+
+    private static let schema = """
+        CREATE TABLE IF NOT EXISTS games (
+            seq INTEGER PRIMARY KEY,
+            id TEXT NOT NULL UNIQUE,
+            path TEXT NOT NULL,
+            name TEXT NOT NULL,
+            system TEXT NOT NULL,
+            size INTEGER NOT NULL DEFAULT 0,
+            crc32 INTEGER,
+            date_added REAL,
+            last_played REAL,
+            play_time REAL NOT NULL DEFAULT 0,
+            favorite INTEGER NOT NULL DEFAULT 0
+        );
+        CREATE INDEX IF NOT EXISTS games_name ON games(name COLLATE NOCASE, id);
+        CREATE INDEX IF NOT EXISTS games_system_name ON games(system, name COLLATE NOCASE, id);
+        CREATE INDEX IF NOT EXISTS games_date_added ON games(date_added DESC, id);
+        CREATE INDEX IF NOT EXISTS games_last_played ON games(last_played DESC, id) WHERE last_played IS NOT NULL;
+        CREATE INDEX IF NOT EXISTS games_favorite ON games(favorite, name COLLATE NOCASE, id);
+        CREATE VIRTUAL TABLE IF NOT EXISTS games_fts USING fts5(
+            name, content='games', content_rowid='seq', tokenize='trigram'
+        );
+        CREATE TRIGGER IF NOT EXISTS games_ai AFTER INSERT ON games BEGIN
+            INSERT INTO games_fts(rowid, name) VALUES (new.seq, new.name);
+        END;
+        CREATE TRIGGER IF NOT EXISTS games_ad AFTER DELETE ON games BEGIN
+            INSERT INTO games_fts(games_fts, rowid, name) VALUES ('delete', old.seq, old.name);
+        END;
+        CREATE TRIGGER IF NOT EXISTS games_au AFTER UPDATE OF name ON games WHEN old.name IS NOT new.name BEGIN
+            INSERT INTO games_fts(games_fts, rowid, name) VALUES ('delete', old.seq, old.name);
+            INSERT INTO games_fts(rowid, name) VALUES (new.seq, new.name);
+        END;
+        """
+
+    private static let columns = "id, path, name, system, size, crc32, date_added, last_played, play_time, favorite"
+
+    private static let upsertSQL = """
+        INSERT INTO games (\(columns)) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+        ON CONFLICT(id) DO UPDATE SET
+            path = excluded.path, name = excluded.name, system = excluded.system,
+            size = excluded.size, crc32 = excluded.crc32, date_added = excluded.date_added,
+            last_played = excluded.last_played, play_time = excluded.play_time,
+            favorite = excluded.favorite
+        """
+
+    // MARK: - Initialization
+
+    /// Open or create a store
+    /// - Throws: `StoreError` if the database cannot be opened or migrated
+    public init(url: URL) throws {
+        self.url = url
+        try FileManager.default.createDirectory(at: url.deletingLastPathComponent(),
+                                                withIntermediateDirectories: true)
+
+        var handle: OpaquePointer?
+        let flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX
+        let status = sqlite3_open_v2(url.path, &handle, flags, nil)
+        guard status == SQLITE_OK, let handle else {
+            let message = handle.map { String(cString: sqlite3_errmsg($0)) } ?? "out of memory"
+            sqlite3_close_v2(handle)
+            throw StoreError.sqlite(code: status, message: message)
+        }
+        db = handle
+
+        // A throw from here on runs deinit, which closes the handle
+        try execute("PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL; PRAGMA temp_store = MEMORY;")
+        if try userVersion() < Self.schemaVersion {
+            try execute("BEGIN; \(Self.schema) PRAGMA user_version = \(Self.schemaVersion); COMMIT;")
+        }
+    }
+
+    deinit {
+        for statement in statements.values {
+            sqlite3_finalize(statement)
+        }
+        sqlite3_close_v2(db)
+    }
+
+    // MARK: - Public Methods
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Insert or update games in one transaction
+    public func upsert(_ entries: [Entry]) throws {
+        guard !entries.isEmpty else { return }
+        try write {
+            let statement = try prepare(Self.upsertSQL)
+            for entry in entries {
+                try bind(entry, to: statement)
+                try step(statement)
+            }
+        }
+    }
+
+    /// Make the store hold exactly these games, e.g. after a full library scan
+    public func replaceAll(with entries: [Entry]) throws {
+        try write {
+            try execute("CREATE TEMP TABLE IF NOT EXISTS keep (id TEXT PRIMARY KEY); DELETE FROM keep;")
+            let upsert = try prepare(Self.upsertSQL)
+            let keep = try prepare("INSERT OR IGNORE INTO keep (id) VALUES (?)")
+            for entry in entries {
+                try bind(entry, to: upsert)
+                try step(upsert)
+                try bind([.text(entry.id.uuidString)], to: keep)
+                try step(keep)
+            }
+            try execute("DELETE FROM games WHERE id NOT IN (SELECT id FROM keep); DELETE FROM keep;")
+        }
+    }
+
+    public func delete(id: UUID) throws {
+        try write {
+            let statement = try prepare("DELETE FROM games WHERE id = ?")
+            try bind([.text(id.uuidString)], to: statement)
+            try step(statement)
+        }
+    }
+
+    public func setFavorite(_ isFavorite: Bool, for id: UUID) throws {
+        try write {
+            let statement = try prepare("UPDATE games SET favorite = ? WHERE id = ?")
+            try bind([.integer(isFavorite ? 1 : 0), .text(id.uuidString)], to: statement)
+            try step(statement)
+        }
+    }
+
+    public func recordPlayed(_ id: UUID, at date: Date = Date(), duration: TimeInterval = 0) throws {
+        try write {
+            let statement = try prepare("UPDATE games SET last_played = ?, play_time = play_time + ? WHERE id = ?")
+            try bind([.real(date.timeIntervalSince1970), .real(duration), .text(id.uuidString)], to: statement)
+            try step(statement)
+        }
+    }
+
+    /// Number of games matching a query
+    public func count(_ query: Query) throws -> Int {
+        let (clause, bindings) = Self.whereClause(for: query)
+        return try read(sql: "SELECT count(*) FROM games\(clause)", bindings: bindings) { statement in
+            Int(sqlite3_column_int64(statement, 0))
+        }.first ?? 0
+    }
+
+    /// One page of game IDs, served from the covering indexes
+    public func ids(matching query: Query, offset: Int = 0, limit: Int) throws -> [UUID] {
+        let (clause, bindings) = Self.whereClause(for: query)
+        let sql = "SELECT id FROM games\(clause) ORDER BY \(Self.orderBy(query.order)) LIMIT ? OFFSET ?"
+        return try read(sql: sql, bindings: bindings + [.integer(Int64(limit)), .integer(Int64(offset))]) { statement in
+            Self.uuid(statement, 0)
+        }.compactMap { $0 }
+    }
+
+    /// One page of games
+    public func entries(matching query: Query, offset: Int = 0, limit: Int) throws -> [Entry] {
+        let (clause, bindings) = Self.whereClause(for: query)
+        let sql = "SELECT \(Self.columns) FROM games\(clause) ORDER BY \(Self.orderBy(query.order)) LIMIT ? OFFSET ?"
+        return try read(sql: sql, bindings: bindings + [.integer(Int64(limit)), .integer(Int64(offset))]) { statement in
+            Self.entry(statement)
+        }.compactMap { $0 }
+    }
+
+    /// `ids(matching:offset:limit:)` off the caller's thread
+    public func loadIDs(matching query: Query, offset: Int = 0, limit: Int) async throws -> [UUID] {
+        try await Task.detached(priority: .userInitiated) {
+            try self.ids(matching: query, offset: offset, limit: limit)
+        }.value
+    }
+
+    /// `entries(matching:offset:limit:)` off the caller's thread
+    public func loadEntries(matching query: Query, offset: Int = 0, limit: Int) async throws -> [Entry] {
+        try await Task.detached(priority: .userInitiated) {
+            try self.entries(matching: query, offset: offset, limit: limit)
+        }.value
+    }
+
+    // MARK: - Query Building
+
+    private enum Binding {
+        case text(String)
+        case integer(Int64)
+        case real(Double)
+        case null
+    }
+
+    private static func whereClause(for query: Query) -> (String, [Binding]) {
+        var conditions: [String] = []
+        var bindings: [Binding] = []
+
+        if let system = query.system {
+            conditions.append("system = ?")
+            bindings.append(.text(system))
+        }
+        if query.favoritesOnly {
+            conditions.append("favorite = 1")
+        }
+        if query.playedOnly || query.order == .lastPlayed {
+            conditions.append("last_played IS NOT NULL")
+        }
+
+        // Trigrams need three characters; shorter words are matched with LIKE
+        let words = query.search.split(whereSeparator: \.isWhitespace).map(String.init)
+        let phrases = words.filter { $0.count >= 3 }
+        if !phrases.isEmpty {
+            conditions.append("seq IN (SELECT rowid FROM games_fts WHERE games_fts MATCH ?)")
+            bindings.append(.text(phrases.map { "\"\($0.replacingOccurrences(of: "\"", with: "\"\""))\"" }
+                .joined(separator: " ")))
+        }
+        for word in words where word.count < 3 {
+            conditions.append("name LIKE ? ESCAPE '\\'")
+            let escaped = word.replacingOccurrences(of: "\\", with: "\\\\")
+                .replacingOccurrences(of: "%", with: "\\%")
+                .replacingOccurrences(of: "_", with: "\\_")
+            bindings.append(.text("%\(escaped)%"))
+        }
+
+        let clause = conditions.isEmpty ? "" : " WHERE " + conditions.joined(separator: " AND ")
+        return (clause, bindings)
+    }
+
+    private static func orderBy(_ order: Order) -> String {
+        switch order {
+        case .name: return "name COLLATE NOCASE, id"
+        case .system: return "system, name COLLATE NOCASE, id"
+        case .dateAdded: return "date_added DESC, id"
+        case .lastPlayed: return "last_played DESC, id"
+        }
+    }
+
+    // MARK: - SQLite
+
+    private func userVersion() throws -> Int32 {
+        var statement: OpaquePointer?
+        guard sqlite3_prepare_v2(db, "PRAGMA user_version", -1, &statement, nil) == SQLITE_OK else {
+            throw error(sqlite3_errcode(db))
+        }
+        defer { sqlite3_finalize(statement) }
+        return sqlite3_step(statement) == SQLITE_ROW ? sqlite3_column_int(statement, 0) : 0
+    }
+
+    private func execute(_ sql: String) throws {
+        let status = sqlite3_exec(db, sql, nil, nil, nil)
+        guard status == SQLITE_OK else { throw error(status) }
+    }
+
+    /// Cached prepared statement; callers hold the lock
+    private func prepare(_ sql: String) throws -> OpaquePointer {
+        if let statement = statements[sql] {
+            sqlite3_reset(statement)
+            sqlite3_clear_bindings(statement)
+            return statement
+        }
+        var statement: OpaquePointer?
+        let status = sqlite3_prepare_v3(db, sql, -1, UInt32(SQLITE_PREPARE_PERSISTENT), &statement, nil)
+        guard status == SQLITE_OK, let statement else { throw error(status) }
+        statements[sql] = statement
+        return statement
+    }
+
+    private func bind(_ values: [Binding], to statement: OpaquePointer) throws {
+        sqlite3_reset(statement)
+        for (index, value) in values.enumerated() {
+            let position = Int32(index + 1)
+            let status: Int32
+            switch value {
+            case .text(let text): status = sqlite3_bind_text(statement, position, text, -1, Self.transient)
+            case .integer(let number): status = sqlite3_bind_int64(statement, position, number)
+            case .real(let number): status = sqlite3_bind_double(statement, position, number)
+            case .null: status = sqlite3_bind_null(statement, position)
+            }
+            guard status == SQLITE_OK else { throw error(status) }
+        }
+    }
+
+    private func bind(_ entry: Entry, to statement: OpaquePointer) throws {
+        try bind([
+            .text(entry.id.uuidString),
+            .text(entry.path),
+            .text(entry.name),
+            .text(entry.system),
+            .integer(entry.size),
+            entry.crc32.map { .integer(Int64($0)) } ?? .null,
+            entry.dateAdded.map { .real($0.timeIntervalSince1970) } ?? .null,
+            entry.lastPlayed.map { .real($0.timeIntervalSince1970) } ?? .null,
+            .real(entry.playTime),
+            .integer(entry.isFavorite ? 1 : 0)
+        ], to: statement)
+    }
+
+    private func step(_ statement: OpaquePointer) throws {
+        let status = sqlite3_step(statement)
+        guard status == SQLITE_DONE || status == SQLITE_ROW else { throw error(status) }
+    }
+
+    /// Run a transaction under the lock, rolling back on error
+    private func write(_ body: () throws -> Void) throws {
+        lock.lock()
+        defer { lock.unlock() }
+
+        try execute("BEGIN IMMEDIATE")
+        do {
+            try body()
+            try execute("COMMIT")
+        } catch {
+            try? execute("ROLLBACK")
+            throw error
+        }
+        stats.writes += 1
+    }
+
+    private func read<T>(sql: String, bindings: [Binding], row: (OpaquePointer) -> T) throws -> [T] {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let start = Date()
+        let statement = try prepare(sql)
+        try bind(bindings, to: statement)
+        defer { sqlite3_reset(statement) }
+
+        var rows: [T] = []
+        while true {
+            let status = sqlite3_step(statement)
+            if status == SQLITE_DONE { break }
+            guard status == SQLITE_ROW else { throw error(status) }
+            rows.append(row(statement))
+        }
+
+        let elapsed = Date().timeIntervalSince(start)
+        stats.queries += 1
+        stats.queryTime += elapsed
+        stats.lastQueryTime = elapsed
+        return rows
+    }
+
+    private func error(_ status: Int32) -> StoreError {
+        .sqlite(code: status, message: String(cString: sqlite3_errmsg(db)))
+    }
+
+    private static let transient = unsafeBitCast(-1, to: sqlite3_destructor_type.self)
+
+    private static func text(_ statement: OpaquePointer, _ column: Int32) -> String? {
+        sqlite3_column_text(statement, column).map { String(cString: $0) }
+    }
+
+    private static func uuid(_ statement: OpaquePointer, _ column: Int32) -> UUID? {
+        text(statement, column).flatMap(UUID.init(uuidString:))
+    }
+
+    private static func date(_ statement: OpaquePointer, _ column: Int32) -> Date? {
+        guard sqlite3_column_type(statement, column) != SQLITE_NULL else { return nil }
+        return Date(timeIntervalSince1970: sqlite3_column_double(statement, column))
+    }
+
+    private static func entry(_ statement: OpaquePointer) -> Entry? {
+        guard let id = uuid(statement, 0),
+              let path = text(statement, 1),
+              let name = text(statement, 2),
+              let system = text(statement, 3) else {
+            return nil
+        }
+        let crc32 = sqlite3_column_type(statement, 5) == SQLITE_NULL
+            ? nil : UInt32(truncatingIfNeeded: sqlite3_column_int64(statement, 5))
+        return Entry(id: id, path: path, name: name, system: system,
+                     size: sqlite3_column_int64(statement, 4),
+                     crc32: crc32,
+                     dateAdded: date(statement, 6),
+                     lastPlayed: date(statement, 7),
+                     playTime: sqlite3_column_double(statement, 8),
+                     isFavorite: sqlite3_column_int(statement, 9) != 0)
+    }
+}
@@ -0,0 +1,337 @@
+//
+//  PlayJournal.swift
+//  YearnCore
+//
+//  Write-behind journal of play sessions, folded into running totals
+//
+
+import Foundation
+import CYearnSupport
+
+/// Records game launches and play sessions without a database write per event
+///
+/// Events go into an in-memory `Summary` at once, so totals are always
+/// current and cost nothing to read, and are appended to a binary journal
+/// (`yearn_journal`) by a background writer: up to `flushThreshold` events
+/// share one write and one fsync, issued at most `flushInterval` after the
+/// first of them. Once the journal holds `compactionThreshold` entries it is
+/// folded into `Summary.plist` and reset, so opening never replays more than
+/// that many. The journal's generation tells on open whether a crash came
+/// between writing the summary and resetting the journal.
+public final class PlayJournal: @unchecked Sendable {
+
+    public struct Session: Sendable {
+        public var gameID: UUID
+        public var start: Date
+        /// Seconds of play, excluding pauses
+        public var duration: TimeInterval
+        public var frames: Int
+        public var averageFPS: Double
+
+        public init(gameID: UUID, start: Date, duration: TimeInterval, frames: Int, averageFPS: Double) {
+            self.gameID = gameID
+            self.start = start
+            self.duration = duration
+            self.frames = frames
+            self.averageFPS = averageFPS
+        }
+    }
+
+    public struct GameTotals: Codable, Sendable {
+        public var playTime: TimeInterval = 0
+        public var sessions = 0
+        public var frames: UInt64 = 0
+        public var lastPlayed: Date?
+    }
+
+    /// Running totals over every recorded event
+    public struct Summary: Codable, Sendable {
+        /// Journal generation the totals were last compacted with
+        public fileprivate(set) var generation: UInt64 = 0
+        public fileprivate(set) var totalPlayTime: TimeInterval = 0
+        public fileprivate(set) var sessions = 0
+        public fileprivate(set) var frames: UInt64 = 0
+        public fileprivate(set) var games: [UUID: GameTotals] = [:]
+        /// Play time per local calendar day, keyed by `Summary.day(of:)`
+        public fileprivate(set) var dailyPlayTime: [Int: TimeInterval] = [:]
+
+        public init() {}
+
+        public func playTime(onDayOf date: Date) -> TimeInterval {
+            dailyPlayTime[Self.day(of: date)] ?? 0
+        }
+
+        /// Played games, most recent first
+        public func recentGameIDs(limit: Int) -> [UUID] {
+            games.compactMap { id, totals in totals.lastPlayed.map { (id, $0) } }
+                .sorted { $0.1 > $1.1 }
+                .prefix(limit)
+                .map(\.0)
+        }
+
+        /// Days since the reference date in the current time zone
+        public static func day(of date: Date) -> Int {
+            let local = date.timeIntervalSinceReferenceDate + Double(TimeZone.current.secondsFromGMT(for: date))
+            return Int((local / 86_400).rounded(.down))
+        }
+
+        fileprivate mutating func add(_ record: yearn_journal_record) {
+            let id = withUnsafeBytes(of: record.game_id) { UUID(uuid: $0.load(as: uuid_t.self)) }
+            let start = Date(timeIntervalSinceReferenceDate: record.start)
+            var totals = games[id] ?? GameTotals()
+            totals.lastPlayed = max(totals.lastPlayed ?? start, start)
+
+            if record.kind == YEARN_JOURNAL_SESSION.rawValue {
+                let duration = TimeInterval(record.duration)
+                totals.playTime += duration
+                totals.sessions += 1
+                totals.frames += UInt64(record.frames)
+                totalPlayTime += duration
+                sessions += 1
+                frames += UInt64(record.frames)
+                dailyPlayTime[Self.day(of: start), default: 0] += duration
+            }
+            games[id] = totals
+        }
+    }
+
+    public struct Statistics {
+        public var recorded = 0
+        public var writes = 0
+        public var syncs = 0
+        public var compactions = 0
+        public var writeTime: TimeInterval = 0
+    }
+
+    // MARK: - Properties
+
+    public let directory: URL
+
+    /// Longest an event waits in memory before it is written
+    public var flushInterval: TimeInterval = 2
+
+    /// Events that trigger a write straight away
+    public var flushThreshold = 64
+
+    /// Journal entries that trigger folding into the summary
+    public var compactionThreshold = 1024
+
+    private let journal: OpaquePointer
+    private let summaryURL: URL
+    private let queue = DispatchQueue(label: "com.yearn.play-journal", qos: .utility)
+    private let lock = NSLock()
+    private var current = Summary()
+    private var pending: [yearn_journal_record] = []
+    private var flushScheduled = false
+    private var stats = Statistics()
+
+    // MARK: - Initialization
+
+    /// Open the journal in `directory`, replaying what was not compacted yet
+    /// - Throws: `POSIXError` if the journal cannot be created or read
+    public init(directory: URL) throws {
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        guard let journal = yearn_journal_open(directory.appendingPathComponent("Sessions.journal").path) else {
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+        }
+        self.directory = directory
+        self.journal = journal
+        self.summaryURL = directory.appendingPathComponent("Summary.plist")
+
+        if let data = try? Data(contentsOf: summaryURL),
+           let summary = try? PropertyListDecoder().decode(Summary.self, from: data) {
+            current = summary
+        }
+
+        let generation = yearn_journal_generation(journal)
+        if generation < current.generation {
+            // Already folded into the summary; the reset after it did not happen
+            guard yearn_journal_reset(journal, current.generation) == 0 else {
+                throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+            }
+        } else {
+            // Newer than the summary (or it was lost): keep what the journal has
+            current.generation = generation
+            try replay()
+        }
+    }
+
+    deinit {
+        yearn_journal_close(journal)
+    }
+
+    // MARK: - Public Methods
+
+    /// Totals including events not written yet
+    public var summary: Summary {
+        lock.lock()
+        defer { lock.unlock() }
+        return current
+    }
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Note that a game was started, for "recently played"
+    public func recordLaunch(of gameID: UUID, at date: Date = Date()) {
+        append(Self.record(gameID, start: date, kind: YEARN_JOURNAL_LAUNCH))
+    }
+
+    /// Record a finished play session
+    public func record(_ session: Session) {
+        var record = Self.record(session.gameID, start: session.start, kind: YEARN_JOURNAL_SESSION)
+        record.duration = Float(session.duration)
+        record.frames = UInt32(clamping: session.frames)
+        record.average_fps = Float(session.averageFPS)
+        append(record)
+    }
+
+    /// Write and sync everything recorded so far, e.g. before the app is suspended
+    public func flush() {
+        queue.sync { writePending() }
+    }
+
+    /// Forget when games were last played, keeping play time
+    public func clearLastPlayed() {
+        queue.sync {
+            writePending()
+            lock.lock()
+            for id in current.games.keys {
+                current.games[id]?.lastPlayed = nil
+            }
+            lock.unlock()
+            compact()
+        }
+    }
+
+    /// Move totals from old game identifiers to new ones, merging with any the new one already has
+    public func reassign(_ ids: [UUID: UUID]) {
+        guard !ids.isEmpty else { return }
+        queue.sync {
+            writePending()
+            lock.lock()
+            for (old, new) in ids {
+                guard let totals = current.games.removeValue(forKey: old) else { continue }
+                var merged = current.games[new] ?? GameTotals()
+                merged.playTime += totals.playTime
+                merged.sessions += totals.sessions
+                merged.frames += totals.frames
+                merged.lastPlayed = [merged.lastPlayed, totals.lastPlayed].compactMap { $0 }.max()
+                current.games[new] = merged
+            }
+            lock.unlock()
+            compact()
+        }
+    }
+
+    // MARK: - Private Methods
+
+    private static func record(_ gameID: UUID, start: Date, kind: yearn_journal_kind) -> yearn_journal_record {
+        var record = yearn_journal_record()
+        withUnsafeBytes(of: gameID.uuid) { source in
+            withUnsafeMutableBytes(of: &record.game_id) { $0.copyMemory(from: source) }
+        }
+        record.start = start.timeIntervalSinceReferenceDate
+        record.kind = kind.rawValue
+        return record
+    }
+
+    private func append(_ record: yearn_journal_record) {
+        lock.lock()
+        current.add(record)
+        pending.append(record)
+        stats.recorded += 1
+        let writeNow = pending.count >= flushThreshold
+        let schedule = !writeNow && !flushScheduled
+        if schedule { flushScheduled = true }
+        lock.unlock()
+
+        if writeNow {
+            queue.async { self.writePending() }
+        } else if schedule {
+            queue.asyncAfter(deadline: .now() + flushInterval) { self.writePending() }
+        }
+    }
+
+    /// On `queue`
+    private func writePending() {
+        lock.lock()
+        let records = pending
+        pending.removeAll(keepingCapacity: true)
+        flushScheduled = false
+        lock.unlock()
+        guard !records.isEmpty else { return }
+
+        let start = Date()
+        let appended = records.withUnsafeBufferPointer {
+            yearn_journal_append(journal, $0.baseAddress, $0.count) == 0
+        }
+        let synced = appended && yearn_journal_sync(journal) == 0
+        if !synced {
+            Log.library.warning("Play journal write failed: \(String(cString: strerror(errno)))")
+        }
+        let elapsed = Date().timeIntervalSince(start)
+
+        lock.lock()
+        stats.writes += 1
+        if synced { stats.syncs += 1 }
+        stats.writeTime += elapsed
+        lock.unlock()
+
+        if yearn_journal_count(journal) >= compactionThreshold {
+            compact()
+        }
+    }
+
+    /// Save the summary and empty the journal; on `queue`
+    private func compact() {
+        // Events not written yet are in the summary too, so they need no journal entry
+        lock.lock()
+        var summary = current
+        pending.removeAll(keepingCapacity: true)
+        lock.unlock()
+
+        let generation = summary.generation + 1
+        summary.generation = generation
+        let encoder = PropertyListEncoder()
+        encoder.outputFormat = .binary
+        do {
+            try encoder.encode(summary).write(to: summaryURL, options: .atomic)
+        } catch {
+            Log.library.warning("Play journal compaction failed: \(error)")
+            return
+        }
+        if yearn_journal_reset(journal, generation) != 0 {
+            // The summary already holds these events; the next open discards the journal
+            Log.library.warning("Play journal reset failed: \(String(cString: strerror(errno)))")
+        }
+
+        lock.lock()
+        current.generation = generation
+        stats.compactions += 1
+        lock.unlock()
+    }
+
+    private func replay() throws {
+        var summary = current
+        try Self.fold(journal, into: &summary)
+        current = summary
+    }
+
+    private static func fold(_ journal: OpaquePointer, into summary: inout Summary) throws {
+        let count = yearn_journal_count(journal)
+        var records = [yearn_journal_record](repeating: yearn_journal_record(), count: count)
+        let read = records.withUnsafeMutableBufferPointer {
+            yearn_journal_read(journal, 0, $0.baseAddress, count)
+        }
+        guard read >= 0 else {
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+        }
+        for record in records.prefix(read) where record.kind != YEARN_JOURNAL_INVALID.rawValue {
+            summary.add(record)
+        }
+    }
+}
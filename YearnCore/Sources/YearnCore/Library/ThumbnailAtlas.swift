@@ -0,0 +1,148 @@
+//
+//  ThumbnailAtlas.swift
+//  YearnCore
+//
+//  Compressed thumbnails packed into one memory-mapped file
+//
+
+import Foundation
+import CYearnSupport
+
+/// Fixed-size thumbnail tiles keyed by game ID, backed by `yearn_atlas`
+///
+/// All tiles of one size live in a single file, so showing a screenful of
+/// covers costs no `open`/`read`/`close` per cover: the index is read once
+/// when the atlas opens and tiles are copied out of the mapping. Tiles are
+/// stored as given (typically JPEG) and must fit in `slotSize`. Storing a
+/// tile for an ID replaces the previous one; with `maxTiles` set, the tile
+/// stored longest ago makes room for a new one.
+public final class ThumbnailAtlas: @unchecked Sendable {
+
+    public struct Statistics {
+        public var hits = 0
+        public var misses = 0
+        public var stores = 0
+        public var bytesRead: UInt64 = 0
+    }
+
+    public enum AtlasError: Error {
+        /// The tile is larger than a slot
+        case tileTooLarge(Int)
+    }
+
+    // MARK: - Properties
+
+    public let url: URL
+
+    /// Largest tile the atlas holds, a multiple of 4 KB
+    public let slotSize: Int
+
+    /// Tiles kept before the oldest is evicted; 0 keeps everything
+    public var maxTiles: Int = 0 {
+        didSet {
+            lock.lock()
+            yearn_atlas_set_max_tiles(handle, UInt32(clamping: maxTiles))
+            lock.unlock()
+        }
+    }
+
+    private let handle: OpaquePointer
+    private let lock = NSLock()
+    private var buffer: [UInt8]
+    private var stats = Statistics()
+
+    // MARK: - Cover Layout
+
+    /// Slot the app stores cover thumbnails in
+    ///
+    /// A grid cover is 160 pt, 480 px at 3x; as JPEG that is 20-40 KB at
+    /// quality 0.8, and the quality drops to 0.6 or 0.4 for the rest.
+    public static let coverSlotSize = 40 * 1024
+
+    /// Covers kept per pixel size: a 5,000-game library with room for replaced
+    /// covers, about 234 MB of slots at most
+    public static let coverTileLimit = 6000
+
+    // MARK: - Initialization
+
+    /// Open the atlas at `url`, creating it if needed
+    /// An existing atlas with a different slot size is emptied.
+    /// - Throws: `POSIXError` if the file cannot be opened or mapped
+    public init(url: URL, slotSize: Int = 64 * 1024) throws {
+        guard let handle = yearn_atlas_open(url.path, UInt32(clamping: slotSize)) else {
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+        }
+        self.url = url
+        self.handle = handle
+        self.slotSize = Int(yearn_atlas_slot_size(handle))
+        self.buffer = [UInt8](repeating: 0, count: self.slotSize)
+    }
+
+    deinit {
+        yearn_atlas_close(handle)
+    }
+
+    // MARK: - Public Methods
+
+    public var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return Int(yearn_atlas_count(handle))
+    }
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// The tile stored for `id`, or nil if there is none (or it was torn by a crash)
+    public func tile(for id: UUID) -> Data? {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let length = withUnsafeBytes(of: id.uuid) { key in
+            buffer.withUnsafeMutableBytes { bytes in
+                yearn_atlas_get(handle, key.bindMemory(to: UInt8.self).baseAddress,
+                                bytes.baseAddress, bytes.count)
+            }
+        }
+        guard length >= 0 else {
+            stats.misses += 1
+            return nil
+        }
+        stats.hits += 1
+        stats.bytesRead += UInt64(length)
+        return Data(buffer[0..<length])
+    }
+
+    /// Store or replace the tile for `id`
+    /// - Throws: `AtlasError.tileTooLarge` if `data` exceeds `slotSize`, or `POSIXError` if the write fails
+    public func store(_ data: Data, for id: UUID) throws {
+        guard data.count <= slotSize else {
+            throw AtlasError.tileTooLarge(data.count)
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+        let result = withUnsafeBytes(of: id.uuid) { key in
+            data.withUnsafeBytes { bytes in
+                yearn_atlas_put(handle, key.bindMemory(to: UInt8.self).baseAddress,
+                                bytes.baseAddress, bytes.count)
+            }
+        }
+        guard result == 0 else {
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+        }
+        stats.stores += 1
+    }
+
+    /// Remove the tile for `id`, if any
+    public func remove(_ id: UUID) {
+        lock.lock()
+        defer { lock.unlock() }
+        _ = withUnsafeBytes(of: id.uuid) { key in
+            yearn_atlas_remove(handle, key.bindMemory(to: UInt8.self).baseAddress)
+        }
+    }
+}
@@ -48,9 +48,9 @@ public class FrameworkCoreLoader {
             frameworkSearchPaths.append(documentsFrameworksURL)
         }
         
-        print("🔧 FrameworkCoreLoader: 搜索路径:")
+        Log.core.debug("搜索路径:")
         for path in frameworkSearchPaths {
-            print("   - \(path.path)")
+            Log.core.debug("- \(path.path)")
         }
     }
     
@@ -69,7 +69,7 @@ public class FrameworkCoreLoader {
             for frameworkName in possibleNames {
                 let frameworkURL = searchPath.appendingPathComponent(frameworkName)
                 if FileManager.default.fileExists(atPath: frameworkURL.path) {
-                    print("✅ 找到 Framework: \(name) -> \(frameworkURL.path)")
+                    Log.core.debug("找到 Framework: \(name) -> \(frameworkURL.path)")
                     return frameworkURL
                 }
             }
@@ -92,7 +92,7 @@ public class FrameworkCoreLoader {
                 let name = url.deletingPathExtension().lastPathComponent
                 if !frameworks.contains(name) {
                     frameworks.append(name)
-                    print("🔍 发现 Framework: \(name)")
+                    Log.core.debug("发现 Framework: \(name)")
                 }
             }
         }
@@ -113,12 +113,12 @@ public class FrameworkCoreLoader {
             throw FrameworkLoadError.binaryNotFound(frameworkName)
         }
         
-        print("📦 加载 Framework: \(binaryURL.path)")
+        Log.core.debug("加载 Framework: \(binaryURL.path)")
         
         // 使用 dlopen 加载动态库
         guard let handle = dlopen(binaryURL.path, RTLD_NOW | RTLD_LOCAL) else {
             let error = String(cString: dlerror())
-            print("❌ dlopen 失败: \(error)")
+            Log.core.error("dlopen 失败: \(error)")
             throw FrameworkLoadError.dlopenFailed(error)
         }
         
@@ -128,7 +128,7 @@ public class FrameworkCoreLoader {
         // 获取所有必需的函数指针
         let interface = try loadFunctionPointers(from: handle, frameworkName: frameworkName)
         
-        print("✅ Framework 核心加载成功: \(frameworkName)")
+        Log.core.info("Framework 核心加载成功: \(frameworkName)")
         return interface
     }
     
@@ -204,14 +204,14 @@ public class FrameworkCoreLoader {
         
         dlclose(handle)
         loadedFrameworks.removeValue(forKey: name)
-        print("📦 Framework 已卸载: \(name)")
+        Log.core.debug("Framework 已卸载: \(name)")
     }
     
     /// 卸载所有 Framework
     public func unloadAllFrameworks() {
         for (name, handle) in loadedFrameworks {
             dlclose(handle)
-            print("📦 Framework 已卸载: \(name)")
+            Log.core.debug("Framework 已卸载: \(name)")
         }
         loadedFrameworks.removeAll()
     }
@@ -254,7 +254,7 @@ public class FrameworkCoreLoader {
         
         for name in possibleNames {
             if let frameworkURL = findFramework(named: name) {
-                print("🎮 为系统 \(system) 加载核心: \(name)")
+                Log.core.debug("为系统 \(system) 加载核心: \(name)")
                 return try loadCore(frameworkURL: frameworkURL)
             }
         }
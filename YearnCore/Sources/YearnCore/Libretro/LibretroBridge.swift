@@ -45,6 +45,12 @@ public final class LibretroBridge {
     private var isLoaded = false
     private var gameLoaded = false
     
+    /// ROM buffer handed to the core; kept alive until the game is unloaded
+    private var romSource: ROMSource?
+    
+    /// Whether the core asked for the VFS interface (disc reads go through the disc cache)
+    public private(set) var usesVFS = false
+    
     // Function pointers
     private var retroInit: RetroInit?
     private var retroDeinit: RetroDeinit?
@@ -93,6 +99,11 @@ public final class LibretroBridge {
     private var saveDirectory: String
     private var coreAssetsDirectory: String
     
+    /// The directories as C strings, handed to the core by pointer; freed in deinit
+    private let systemDirectoryCString: UnsafeMutablePointer<CChar>
+    private let saveDirectoryCString: UnsafeMutablePointer<CChar>
+    private let coreAssetsDirectoryCString: UnsafeMutablePointer<CChar>
+    
     // Input state
     private var inputState: [[Int16]] = Array(repeating: Array(repeating: 0, count: 16), count: 4)
     
@@ -110,18 +121,24 @@ public final class LibretroBridge {
         self.systemDirectory = systemDirectory ?? documentsPath.appendingPathComponent("BIOS").path
         self.saveDirectory = saveDirectory ?? documentsPath.appendingPathComponent("Saves").path
         self.coreAssetsDirectory = documentsPath.appendingPathComponent("CoreAssets").path
+        self.systemDirectoryCString = strdup(self.systemDirectory)
+        self.saveDirectoryCString = strdup(self.saveDirectory)
+        self.coreAssetsDirectoryCString = strdup(self.coreAssetsDirectory)
         
         // Create directories if needed
         createDirectoryIfNeeded(self.systemDirectory)
         createDirectoryIfNeeded(self.saveDirectory)
         createDirectoryIfNeeded(self.coreAssetsDirectory)
         
-        print("📁 System/BIOS directory: \(self.systemDirectory)")
-        print("📁 Save directory: \(self.saveDirectory)")
+        Log.core.debug("System/BIOS directory: \(self.systemDirectory)")
+        Log.core.debug("Save directory: \(self.saveDirectory)")
     }
     
     deinit {
         unloadCore()
+        free(systemDirectoryCString)
+        free(saveDirectoryCString)
+        free(coreAssetsDirectoryCString)
     }
     
     // MARK: - Core Loading
@@ -200,6 +217,27 @@ public final class LibretroBridge {
     
     /// Load a game ROM
     public func loadGame(path: String, data: Data? = nil) throws {
+        if let data = data, !(systemInfo?.needFullpath ?? true) {
+            try loadGame(path: path, source: ROMSource(data: data, url: URL(fileURLWithPath: path)))
+        } else {
+            try loadGame(path: path, source: nil)
+        }
+    }
+    
+    /// Load a game ROM from URL
+    public func loadGame(url: URL) throws {
+        let path = url.path
+        
+        if systemInfo?.needFullpath == false {
+            let source = try ROMSource(url: url)
+            log(.debug, "ROM \(source.storage.rawValue): \(source.size) bytes in \(String(format: "%.1f", source.loadDuration * 1000)) ms")
+            try loadGame(path: path, source: source)
+        } else {
+            try loadGame(path: path, source: nil)
+        }
+    }
+    
+    private func loadGame(path: String, source: ROMSource?) throws {
         guard isLoaded else {
             throw LibretroError.coreNotLoaded
         }
@@ -215,27 +253,22 @@ public final class LibretroBridge {
         
         gameInfo.path = UnsafePointer(pathCString)
         
-        if let data = data, !(systemInfo?.needFullpath ?? true) {
-            // Pass data directly
-            let success = data.withUnsafeBytes { buffer -> Bool in
-                gameInfo.data = buffer.baseAddress
-                gameInfo.size = buffer.count
-                return retroLoadGame?(&gameInfo) ?? false
-            }
-            
-            guard success else {
-                throw LibretroError.gameLoadFailed
-            }
+        if let source = source {
+            // Pass data directly; the source outlives the call
+            gameInfo.data = source.baseAddress
+            gameInfo.size = source.size
         } else {
             // Load from path
             gameInfo.data = nil
             gameInfo.size = 0
-            
-            guard retroLoadGame?(&gameInfo) ?? false else {
-                throw LibretroError.gameLoadFailed
-            }
         }
         
+        guard retroLoadGame?(&gameInfo) ?? false else {
+            throw LibretroError.gameLoadFailed
+        }
+        
+        romSource = source
+        
         // Get AV info
         var info = retro_system_av_info()
         retroGetSystemAVInfo?(&info)
@@ -254,24 +287,14 @@ public final class LibretroBridge {
         log(.info, "Game loaded: \(path)")
     }
     
-    /// Load a game ROM from URL
-    public func loadGame(url: URL) throws {
-        let path = url.path
-        
-        if systemInfo?.needFullpath == false {
-            let data = try Data(contentsOf: url)
-            try loadGame(path: path, data: data)
-        } else {
-            try loadGame(path: path, data: nil)
-        }
-    }
-    
     /// Unload the current game
     public func unloadGame() {
         guard gameLoaded else { return }
         retroUnloadGame?()
         gameLoaded = false
+        romSource = nil
         avInfo = nil
+        DiscImageLayer.shared.reset()
         log(.info, "Game unloaded")
     }
     
@@ -535,27 +558,32 @@ public final class LibretroBridge {
         case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
             if let data = data {
                 let pathPtr = data.assumingMemoryBound(to: UnsafePointer<CChar>?.self)
-                pathPtr.pointee = (systemDirectory as NSString).utf8String
+                pathPtr.pointee = UnsafePointer(systemDirectoryCString)
             }
             return true
             
         case RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY:
             if let data = data {
                 let pathPtr = data.assumingMemoryBound(to: UnsafePointer<CChar>?.self)
-                pathPtr.pointee = (saveDirectory as NSString).utf8String
+                pathPtr.pointee = UnsafePointer(saveDirectoryCString)
             }
             return true
             
         case RETRO_ENVIRONMENT_GET_CORE_ASSETS_DIRECTORY:
             if let data = data {
                 let pathPtr = data.assumingMemoryBound(to: UnsafePointer<CChar>?.self)
-                pathPtr.pointee = (coreAssetsDirectory as NSString).utf8String
+                pathPtr.pointee = UnsafePointer(coreAssetsDirectoryCString)
             }
             return true
             
         case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
-            // Could implement log callback here
-            return false
+            // Core messages go to the diagnostic log, so hang reports include them
+            return DiagnosticLog.shared.provideCoreLogInterface(data)
+            
+        case RETRO_ENVIRONMENT_GET_VFS_INTERFACE:
+            usesVFS = DiscImageLayer.shared.provideVFS(data)
+            log(.debug, "VFS interface \(usesVFS ? "provided" : "refused")")
+            return usesVFS
             
         case RETRO_ENVIRONMENT_GET_CAN_DUPE:
             if let data = data {
@@ -609,6 +637,14 @@ public final class LibretroBridge {
             bridge.videoCallback?(data, Int(width), Int(height), pitch, bridge.pixelFormat)
         })
         
+        retroSetAudioSample?({ left, right in
+            guard let bridge = LibretroBridge.currentBridge else { return }
+            var frame = (left, right)
+            withUnsafePointer(to: &frame) { pointer in
+                pointer.withMemoryRebound(to: Int16.self, capacity: 2) { bridge.audioCallback?($0, 2) }
+            }
+        })
+        
         retroSetAudioSampleBatch?({ data, frames in
             guard let data = data,
                   let bridge = LibretroBridge.currentBridge else { return 0 }
@@ -623,6 +659,11 @@ public final class LibretroBridge {
         retroSetInputState?({ port, device, index, id in
             guard let bridge = LibretroBridge.currentBridge else { return 0 }
             
+            // A custom source answers everything, bitmask queries included
+            if let callback = bridge.inputStateCallback {
+                return callback(port, device, index, id)
+            }
+            
             // Check if using bitmask query
             if id == UInt32(RETRO_DEVICE_ID_JOYPAD_MASK) {
                 var mask: Int16 = 0
@@ -634,11 +675,6 @@ public final class LibretroBridge {
                 return mask
             }
             
-            // Check custom callback first
-            if let callback = bridge.inputStateCallback {
-                return callback(port, device, index, id)
-            }
-            
             // Return stored input state
             let portInt = Int(port)
             let idInt = Int(id)
@@ -648,11 +684,17 @@ public final class LibretroBridge {
         })
     }
     
-    private func log(_ level: LogLevel, _ message: String) {
+    private func log(_ level: LogLevel, _ message: @autoclosure () -> String) {
+        // Debug messages are only built when someone will read them
+        guard level != .debug || logCallback != nil || Log.isDebugEnabled else { return }
+        let message = message()
         logCallback?(level, message)
-        #if DEBUG
-        print("[\(level)] \(message)")
-        #endif
+        switch level {
+        case .debug: Log.core.debug(message)
+        case .info: Log.core.info(message)
+        case .warning: Log.core.warning(message)
+        case .error: Log.core.error(message)
+        }
     }
 }
 
@@ -0,0 +1,134 @@
+//
+//  ROMSource.swift
+//  YearnCore
+//
+//  Read-only ROM data source for cores that take game data in memory
+//
+
+import Foundation
+
+/// Backing storage for the buffer handed to `retro_game_info.data`
+///
+/// Local files are memory-mapped read-only, so the core reads straight from the
+/// page cache instead of from a heap copy of the whole image. Remote or iCloud
+/// placeholder files, and data that was produced in memory (decompressed or
+/// patched ROMs), fall back to a regular buffer.
+///
+/// The source must stay alive until `retro_unload_game`, because cores are
+/// allowed to keep pointing into the buffer after `retro_load_game` returns.
+public final class ROMSource {
+
+    /// How the ROM bytes are held
+    public enum Storage: String {
+        case mapped
+        case buffered
+    }
+
+    // MARK: - Properties
+
+    /// Original location of the ROM
+    public let url: URL
+
+    /// Whether the bytes are mapped or buffered
+    public let storage: Storage
+
+    /// ROM size in bytes
+    public let size: Int
+
+    /// Time spent opening and mapping (or reading) the ROM
+    public let loadDuration: TimeInterval
+
+    private let mapping: UnsafeMutableRawPointer?
+    private let buffer: NSData?
+
+    // MARK: - Initialization
+
+    /// Open a ROM, mapping it when it is a local file
+    public init(url: URL) throws {
+        let start = Date()
+        self.url = url
+
+        if ROMSource.canMap(url), let (pointer, length) = ROMSource.map(path: url.path) {
+            self.mapping = pointer
+            self.buffer = nil
+            self.size = length
+            self.storage = .mapped
+        } else {
+            guard let data = NSData(contentsOf: url) else {
+                throw LibretroError.loadFailed("Failed to read ROM file")
+            }
+            self.mapping = nil
+            self.buffer = data
+            self.size = data.length
+            self.storage = .buffered
+        }
+
+        self.loadDuration = Date().timeIntervalSince(start)
+    }
+
+    /// Wrap ROM data that already lives in memory
+    public init(data: Data, url: URL) {
+        self.url = url
+        self.mapping = nil
+        self.buffer = NSData(data: data)
+        self.size = data.count
+        self.storage = .buffered
+        self.loadDuration = 0
+    }
+
+    deinit {
+        if let mapping = mapping {
+            munmap(mapping, size)
+        }
+    }
+
+    // MARK: - Access
+
+    /// Pointer to the ROM bytes, valid for the lifetime of the source
+    public var baseAddress: UnsafeRawPointer? {
+        if let mapping = mapping {
+            return UnsafeRawPointer(mapping)
+        }
+        return buffer?.bytes
+    }
+
+    /// Access the ROM bytes as a buffer
+    public func withUnsafeBytes<T>(_ body: (UnsafeRawBufferPointer) throws -> T) rethrows -> T {
+        return try body(UnsafeRawBufferPointer(start: baseAddress, count: size))
+    }
+
+    // MARK: - Private
+
+    /// Only map plain local files; mapping a file provider item can fault
+    /// (SIGBUS) if the provider evicts it while the core is running
+    private static func canMap(_ url: URL) -> Bool {
+        guard url.isFileURL else { return false }
+
+        if let values = try? url.resourceValues(forKeys: [.isUbiquitousItemKey]),
+           values.isUbiquitousItem == true {
+            return false
+        }
+
+        return true
+    }
+
+    private static func map(path: String) -> (UnsafeMutableRawPointer, Int)? {
+        let fd = open(path, O_RDONLY)
+        guard fd >= 0 else { return nil }
+        defer { close(fd) }
+
+        var info = stat()
+        guard fstat(fd, &info) == 0, info.st_size > 0 else { return nil }
+
+        let length = Int(info.st_size)
+        guard let pointer = mmap(nil, length, PROT_READ, MAP_PRIVATE, fd, 0),
+              pointer != MAP_FAILED else {
+            return nil
+        }
+
+        // Most cores copy or checksum the whole image right away
+        _ = madvise(pointer, length, MADV_WILLNEED)
+
+        return (pointer, length)
+    }
+}
@@ -71,24 +71,24 @@ public final class SimpleStaticBridge {
         
         SimpleStaticBridge.currentBridge = self
         
-        print("🔧 Setting up environment callback...")
+        Log.core.debug("Setting up environment callback...")
         
         // Setup environment callback FIRST
         retro_set_environment { cmd, data in
             return SimpleStaticBridge.currentBridge?.handleEnvironment(cmd, data: data) ?? false
         }
         
-        print("🔧 Calling retro_init...")
+        Log.core.debug("Calling retro_init...")
         
         // Initialize core
         retro_init()
         
-        print("🔧 Setting up other callbacks...")
+        Log.core.debug("Setting up other callbacks...")
         
         // Setup other callbacks
         setupCallbacks()
         
-        print("🔧 Getting system info...")
+        Log.core.debug("Getting system info...")
         
         // Get system info
         var info = retro_system_info()
@@ -102,7 +102,7 @@ public final class SimpleStaticBridge {
             blockExtract: info.block_extract
         )
         
-        print("✅ Core loaded: \(systemInfo?.libraryName ?? "Unknown") v\(systemInfo?.libraryVersion ?? "?")")
+        Log.core.info("Core loaded: \(systemInfo?.libraryName ?? "Unknown") v\(systemInfo?.libraryVersion ?? "?")")
         
         isLoaded = true
     }
@@ -132,11 +132,11 @@ public final class SimpleStaticBridge {
         }
         
         let path = url.path
-        print("🎮 Loading game from: \(path)")
+        Log.core.debug("Loading game from: \(path)")
         
         // Check if core needs full path or data in memory
         let needFullpath = systemInfo?.needFullpath ?? false
-        print("🎮 Core needs fullpath: \(needFullpath)")
+        Log.core.debug("Core needs fullpath: \(needFullpath)")
         
         var success = false
         
@@ -153,12 +153,12 @@ public final class SimpleStaticBridge {
             }
         } else {
             // Core needs ROM data in memory
-            print("🎮 Loading ROM data into memory...")
+            Log.core.debug("Loading ROM data into memory...")
             guard let romData = try? Data(contentsOf: url) else {
-                print("❌ Failed to read ROM file")
+                Log.core.error("Failed to read ROM file")
                 throw LibretroError.loadFailed("Failed to read ROM file")
             }
-            print("🎮 ROM size: \(romData.count) bytes")
+            Log.core.debug("ROM size: \(romData.count) bytes")
             
             romData.withUnsafeBytes { buffer in
                 path.withCString { pathPtr in
@@ -174,11 +174,11 @@ public final class SimpleStaticBridge {
         }
         
         guard success else {
-            print("❌ retro_load_game returned false")
+            Log.core.error("retro_load_game returned false")
             throw LibretroError.loadFailed("Failed to load game")
         }
         
-        print("✅ retro_load_game succeeded")
+        Log.core.debug("retro_load_game succeeded")
         
         // Get AV info
         var info = retro_system_av_info()
@@ -194,7 +194,7 @@ public final class SimpleStaticBridge {
             sampleRate: info.timing.sample_rate
         )
         
-        print("✅ AV Info: \(avInfo!.baseWidth)x\(avInfo!.baseHeight) @ \(avInfo!.fps) FPS")
+        Log.core.info("AV Info: \(avInfo!.baseWidth)x\(avInfo!.baseHeight) @ \(avInfo!.fps) FPS")
         
         gameLoaded = true
     }
@@ -210,7 +210,7 @@ public final class SimpleStaticBridge {
     /// Run one frame
     public func runFrame() {
         guard gameLoaded else {
-            print("⚠️ runFrame called but no game loaded")
+            Log.core.warning("runFrame called but no game loaded")
             return
         }
         retro_run()
@@ -227,7 +227,7 @@ public final class SimpleStaticBridge {
         guard port >= 0 && port < 4 else { return }
         inputState[port][button.rawValue] = pressed ? 1 : 0
         if pressed {
-            print("🕹️ SimpleStaticBridge: Button \(button.rawValue) pressed on port \(port), inputState: \(inputState[port])")
+            Log.core.debug("Button \(button.rawValue) pressed on port \(port), inputState: \(inputState[port])")
         }
     }
     
@@ -284,11 +284,11 @@ public final class SimpleStaticBridge {
     // MARK: - Private
     
     private func setupCallbacks() {
-        print("🔧 Setting up video refresh callback...")
+        Log.core.debug("Setting up video refresh callback...")
         retro_set_video_refresh { data, width, height, pitch in
             guard let data = data,
                   let bridge = SimpleStaticBridge.currentBridge else {
-                print("⚠️ Video callback: data or bridge is nil")
+                Log.video.debug("Video callback: data or bridge is nil")
                 return
             }
             bridge.videoCallback?(data, Int(width), Int(height), pitch, bridge.pixelFormat)
@@ -348,7 +348,7 @@ public final class SimpleStaticBridge {
                 default:
                     pixelFormat = .rgb565
                 }
-                print("🎨 Pixel format set to: \(pixelFormat)")
+                Log.core.debug("Pixel format set to: \(pixelFormat)")
             }
             return true
             
@@ -14,18 +14,18 @@ import CLibretro
 /// 注册所有可用的静态核心
 /// 在应用启动时调用此函数
 public func registerAllStaticCores() {
-    print("📦 YearnCore: 正在注册核心...")
+    Log.core.debug("正在注册核心...")
     
     // 首先尝试加载所有可用的动态 Framework 核心
     // 动态核心来自 RetroArch 等成熟项目，稳定性更好
     let dynamicCount = StaticCoreRegistry.shared.tryLoadAllDynamicCores()
     if dynamicCount > 0 {
-        print("📦 YearnCore: 已加载 \(dynamicCount) 个动态 Framework 核心")
+        Log.core.info("已加载 \(dynamicCount) 个动态 Framework 核心")
     }
     
     #if STATIC_CORES_ENABLED
     // 对于没有动态核心的系统，使用静态链接的核心作为后备
-    print("📦 YearnCore: 正在注册静态核心（作为后备）...")
+    Log.core.debug("正在注册静态核心（作为后备）...")
     
     // 检查并注册缺失的核心
     let registry = StaticCoreRegistry.shared
@@ -71,9 +71,12 @@ public func registerAllStaticCores() {
     }
     #endif
     
-    print("📦 YearnCore: 已注册 \(StaticCoreRegistry.shared.allCores.count) 个核心")
+    Log.core.info("已注册 \(StaticCoreRegistry.shared.allCores.count) 个核心")
 }
 
+// 静态核心的符号只在链接了这些核心的 Apple 应用里存在
+#if STATIC_CORES_ENABLED
+
 // MARK: - Gambatte (GB/GBC)
 
 private func registerGambatteCore() {
@@ -394,6 +397,8 @@ private func registerPCSXReARMedCore() {
 // PS1 使用动态 Framework，不需要静态注册
 private func registerPCSXReARMedCore() {
     // 动态核心由 tryLoadAllDynamicCores() 加载
-    print("⚠️ PCSX ReARMed 静态核心已禁用，使用动态 Framework")
+    Log.core.warning("PCSX ReARMed 静态核心已禁用，使用动态 Framework")
 }
 #endif
+
+#endif
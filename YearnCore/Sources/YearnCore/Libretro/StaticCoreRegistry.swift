@@ -113,11 +113,14 @@ public struct StaticCoreInfo {
 // MARK: - Static Core Registry
 
 /// Registry for all statically linked cores
-/// Cores must be registered at app startup
+/// Cores are registered by a background startup task while the UI may already
+/// be reading, so the tables are guarded by a lock
 public final class StaticCoreRegistry {
     
     public static let shared = StaticCoreRegistry()
     
+    private let lock = NSLock()
+    
     private var cores: [String: StaticCoreInfo] = [:]
     
     /// 动态加载的 Framework 核心
@@ -130,18 +133,25 @@ public final class StaticCoreRegistry {
     
     /// Register a static core
     public func register(_ core: StaticCoreInfo) {
+        lock.lock()
         cores[core.identifier] = core
-        print("Registered static core: \(core.name) for \(core.systemName)")
+        lock.unlock()
+        Log.core.debug("Registered static core: \(core.name) for \(core.systemName)")
     }
     
     /// 注册动态 Framework 核心
     public func registerDynamic(_ core: StaticCoreInfo) {
+        lock.lock()
         dynamicCores[core.identifier] = core
-        print("Registered dynamic core: \(core.name) for \(core.systemName)")
+        lock.unlock()
+        Log.core.debug("Registered dynamic core: \(core.name) for \(core.systemName)")
     }
     
     /// Get a core by identifier
     public func getCore(identifier: String) -> StaticCoreInfo? {
+        lock.lock()
+        defer { lock.unlock() }
+        
         // 优先使用动态核心（如果启用）
         if preferDynamicCores, let dynamicCore = dynamicCores[identifier] {
             return dynamicCore
@@ -152,6 +162,8 @@ public final class StaticCoreRegistry {
     /// Get a core for a file extension
     public func getCore(forExtension ext: String) -> StaticCoreInfo? {
         let lowercased = ext.lowercased()
+        lock.lock()
+        defer { lock.unlock() }
         
         // 优先使用动态核心（如果启用）
         if preferDynamicCores {
@@ -167,6 +179,8 @@ public final class StaticCoreRegistry {
     
     /// Get all registered cores (包括动态核心)
     public var allCores: [StaticCoreInfo] {
+        lock.lock()
+        defer { lock.unlock() }
         var result = Array(cores.values)
         // 添加动态核心（避免重复）
         for dynamicCore in dynamicCores.values {
@@ -179,6 +193,8 @@ public final class StaticCoreRegistry {
     
     /// Check if any cores are registered
     public var hasCores: Bool {
+        lock.lock()
+        defer { lock.unlock() }
         return !cores.isEmpty || !dynamicCores.isEmpty
     }
     
@@ -250,10 +266,10 @@ public final class StaticCoreRegistry {
             )
             
             registerDynamic(core)
-            print("✅ \(systemName) 动态 Framework 核心加载成功")
+            Log.core.info("\(systemName) 动态 Framework 核心加载成功")
             return true
         } catch {
-            print("⚠️ \(systemName) 动态 Framework 核心加载失败: \(error.localizedDescription)")
+            Log.core.warning("\(systemName) 动态 Framework 核心加载失败: \(error.localizedDescription)")
             return false
         }
     }
@@ -268,6 +284,18 @@ public final class StaticLibretroBridge {
     private var isLoaded = false
     private var gameLoaded = false
     
+    /// ROM buffer handed to the core; kept alive until the game is unloaded
+    private var romSource: ROMSource?
+    
+    /// Heap bytes holding the ROM; 0 when it is mapped from its file or no game is loaded
+    public var bufferedROMBytes: Int {
+        guard let romSource, romSource.storage == .buffered else { return 0 }
+        return romSource.size
+    }
+    
+    /// Whether the core asked for the VFS interface (disc reads go through the disc cache)
+    public private(set) var usesVFS = false
+    
     // Callbacks
     public var videoCallback: ((UnsafeRawPointer, Int, Int, Int, LibretroPixelFormat) -> Void)?
     public var audioCallback: ((UnsafePointer<Int16>, Int) -> Void)?
@@ -290,14 +318,6 @@ public final class StaticLibretroBridge {
     // Input state
     private var inputState: [[Int16]] = Array(repeating: Array(repeating: 0, count: 16), count: 4)
     
-    // 调试用：记录查询的按键
-    fileprivate static var debugQueryIds: Set<Int> = []
-    fileprivate static var debugLastLogTime: CFAbsoluteTime = 0
-    
-    // 调试用：视频和音频帧计数
-    fileprivate static var videoCallbackCount = 0
-    fileprivate static var audioCallbackCount = 0
-    
     // Singleton for callbacks
     fileprivate static var currentBridge: StaticLibretroBridge?
     
@@ -316,8 +336,8 @@ public final class StaticLibretroBridge {
         self.systemDirectoryBuffer = systemDirectory.cString(using: .utf8)
         self.saveDirectoryBuffer = saveDirectory.cString(using: .utf8)
         
-        print("📁 System/BIOS directory: \(systemDirectory)")
-        print("📁 Save directory: \(saveDirectory)")
+        Log.core.debug("System/BIOS directory: \(systemDirectory)")
+        Log.core.debug("Save directory: \(saveDirectory)")
     }
     
     deinit {
@@ -395,7 +415,7 @@ public final class StaticLibretroBridge {
         
         let path = url.path
         let needFullpath = systemInfo?.needFullpath ?? false
-        print("🎮 Loading game: \(url.lastPathComponent) (fullpath: \(needFullpath))")
+        Log.core.info("Loading game: \(url.lastPathComponent) (fullpath: \(needFullpath))")
         
         var success = false
         
@@ -411,29 +431,33 @@ public final class StaticLibretroBridge {
                 success = interface.retro_load_game(&gameInfo)
             }
         } else {
-            // 核心需要 ROM 数据在内存中
-            print("🎮 Loading ROM data into memory...")
-            guard let romData = try? Data(contentsOf: url) else {
-                print("❌ Failed to read ROM file")
+            // 核心需要 ROM 数据在内存中（只读映射，不复制到堆上）
+            let source: ROMSource
+            do {
+                source = try ROMSource(url: url)
+            } catch {
+                Log.core.error("Failed to read ROM file")
                 throw LibretroError.loadFailed("Failed to read ROM file")
             }
-            print("🎮 ROM size: \(romData.count) bytes")
+            Log.core.debug("ROM size: \(source.size) bytes (\(source.storage.rawValue), \(String(format: "%.1f", source.loadDuration * 1000)) ms)")
             
-            romData.withUnsafeBytes { buffer in
-                path.withCString { pathPtr in
-                    var gameInfo = retro_game_info()
-                    gameInfo.path = pathPtr
-                    gameInfo.data = buffer.baseAddress
-                    gameInfo.size = romData.count
-                    gameInfo.meta = nil
-                    
-                    success = interface.retro_load_game(&gameInfo)
-                }
+            path.withCString { pathPtr in
+                var gameInfo = retro_game_info()
+                gameInfo.path = pathPtr
+                gameInfo.data = source.baseAddress
+                gameInfo.size = source.size
+                gameInfo.meta = nil
+                
+                success = interface.retro_load_game(&gameInfo)
+            }
+            
+            if success {
+                romSource = source
             }
         }
         
         guard success else {
-            print("❌ Failed to load game")
+            Log.core.error("Failed to load game")
             throw LibretroError.loadFailed("Failed to load game")
         }
         
@@ -451,7 +475,7 @@ public final class StaticLibretroBridge {
             sampleRate: info.timing.sample_rate
         )
         
-        print("✅ Game loaded: \(avInfo!.baseWidth)x\(avInfo!.baseHeight) @ \(Int(avInfo!.fps)) FPS")
+        Log.core.info("Game loaded: \(avInfo!.baseWidth)x\(avInfo!.baseHeight) @ \(Int(avInfo!.fps)) FPS")
         
         gameLoaded = true
     }
@@ -461,24 +485,26 @@ public final class StaticLibretroBridge {
         guard gameLoaded else { return }
         coreInterface?.retro_unload_game()
         gameLoaded = false
+        romSource = nil
         avInfo = nil
+        DiscImageLayer.shared.reset()
     }
     
     /// Run one frame
     public func runFrame() {
         guard let interface = coreInterface, gameLoaded else { 
-            print("⚠️ runFrame called but game not loaded or core not initialized")
+            Log.core.warning("runFrame called but game not loaded or core not initialized")
             return 
         }
         
         // Add crash detection
-        let start = CFAbsoluteTimeGetCurrent()
+        let start = DiagnosticLog.now
         interface.retro_run()
-        let duration = CFAbsoluteTimeGetCurrent() - start
+        let duration = DiagnosticLog.now - start
         
         // Log if frame takes unusually long (possible infinite loop or crash)
         if duration > 1.0 {
-            print("⚠️ Frame took \(duration)s to complete (unusually long)")
+            Log.core.warning("Frame took \(duration)s to complete (unusually long)")
         }
     }
     
@@ -491,12 +517,34 @@ public final class StaticLibretroBridge {
     /// Set input state
     public func setInput(port: Int, button: RetroButton, pressed: Bool) {
         guard port >= 0 && port < 4 else {
-            print("⚠️ StaticLibretroBridge.setInput: Invalid port \(port)")
+            Log.core.warning("Invalid port \(port)")
             return
         }
         inputState[port][button.rawValue] = pressed ? 1 : 0
     }
     
+    /// Answer the core's input-state query, which it makes for every button every frame
+    public func inputState(port: UInt32, device: UInt32, index: UInt32, id: UInt32) -> Int16 {
+        let portInt = Int(port)
+        let idInt = Int(id)
+        guard portInt < 4 else { return 0 }
+        
+        // JOYPAD_MASK 模式：返回所有按键的位掩码 (id == 256)
+        if id == UInt32(RETRO_DEVICE_ID_JOYPAD_MASK) {
+            var mask: Int16 = 0
+            for i in 0..<16 {
+                if inputState[portInt][i] != 0 {
+                    mask |= Int16(1 << i)
+                }
+            }
+            return mask
+        }
+        
+        guard idInt < 16 else { return 0 }
+        
+        return inputState[portInt][idInt]
+    }
+    
     /// 获取当前按下的按钮名称（调试用）
     func getPressedButtonNames() -> String {
         let buttonNames = ["B", "Y", "SELECT", "START", "UP", "DOWN", "LEFT", "RIGHT", "A", "X", "L", "R", "L2", "R2", "L3", "R3"]
@@ -570,29 +618,6 @@ public final class StaticLibretroBridge {
             guard let data = data,
                   let bridge = StaticLibretroBridge.currentBridge else { return }
             
-            // 调试：检查数据指针的有效性
-            #if DEBUG
-            let dataPtr = data.assumingMemoryBound(to: UInt8.self)
-            var sampleCount = 0
-            var nonZeroCount = 0
-            for i in 0..<min(100, Int(pitch) * Int(height)) {
-                if dataPtr[i] != 0 {
-                    nonZeroCount += 1
-                    if sampleCount < 5 {
-                        sampleCount += 1
-                    }
-                }
-            }
-            if nonZeroCount == 0 && Int(width) > 0 && Int(height) > 0 {
-                // 只在第一次或每300帧打印一次
-                StaticLibretroBridge.videoCallbackCount += 1
-                let count = StaticLibretroBridge.videoCallbackCount
-                if count <= 5 || count % 300 == 0 {
-                    print("⚠️ Video callback: \(Int(width))x\(Int(height)), pitch=\(pitch), all pixels are 0 (frame #\(count))")
-                }
-            }
-            #endif
-            
             bridge.videoCallback?(data, Int(width), Int(height), pitch, bridge.pixelFormat)
         }
         
@@ -606,26 +631,6 @@ public final class StaticLibretroBridge {
             guard let data = data,
                   let bridge = StaticLibretroBridge.currentBridge else { return 0 }
             
-            // 调试：检查音频数据
-            #if DEBUG
-            StaticLibretroBridge.audioCallbackCount += 1
-            let count = StaticLibretroBridge.audioCallbackCount
-            if count <= 5 || count % 300 == 0 {
-                let samples = Int(frames) * 2
-                var nonZeroCount = 0
-                for i in 0..<min(100, samples) {
-                    if data[i] != 0 {
-                        nonZeroCount += 1
-                    }
-                }
-                if nonZeroCount > 0 {
-                    print("🔊 Audio: \(samples) samples, \(nonZeroCount) non-zero (frame #\(count))")
-                } else if count <= 5 {
-                    print("⚠️ Audio: all samples are zero (frame #\(count))")
-                }
-            }
-            #endif
-            
             bridge.audioCallback?(data, Int(frames) * 2)
             return frames
         }
@@ -635,37 +640,7 @@ public final class StaticLibretroBridge {
         }
         
         interface.retro_set_input_state { port, device, index, id in
-            guard let bridge = StaticLibretroBridge.currentBridge else {
-                return 0
-            }
-            
-            let portInt = Int(port)
-            let idInt = Int(id)
-            
-            // 记录被查询的按键 ID（仅调试时）
-            #if DEBUG
-            let now = CFAbsoluteTimeGetCurrent()
-            StaticLibretroBridge.debugQueryIds.insert(idInt)
-            if now - StaticLibretroBridge.debugLastLogTime > 5.0 {
-                StaticLibretroBridge.debugQueryIds.removeAll()
-                StaticLibretroBridge.debugLastLogTime = now
-            }
-            #endif
-            
-            // JOYPAD_MASK 模式：返回所有按键的位掩码 (id == 256)
-            if id == UInt32(RETRO_DEVICE_ID_JOYPAD_MASK) {
-                var mask: Int16 = 0
-                for i in 0..<16 {
-                    if bridge.inputState[portInt][i] != 0 {
-                        mask |= Int16(1 << i)
-                    }
-                }
-                return mask
-            }
-            
-            guard portInt >= 0 && portInt < 4 && idInt >= 0 && idInt < 16 else { return 0 }
-            
-            return bridge.inputState[portInt][idInt]
+            StaticLibretroBridge.currentBridge?.inputState(port: port, device: device, index: index, id: id) ?? 0
         }
     }
     
@@ -721,9 +696,13 @@ public final class StaticLibretroBridge {
             return true
             
         case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
-            // Log interface not fully supported yet
-            // Return false so cores use their fallback logging
-            return false
+            // Core messages go to the diagnostic log, so hang reports include them
+            return DiagnosticLog.shared.provideCoreLogInterface(data)
+            
+        case RETRO_ENVIRONMENT_GET_VFS_INTERFACE:
+            // Disc images are read through the cached VFS
+            usesVFS = DiscImageLayer.shared.provideVFS(data)
+            return usesVFS
             
         case RETRO_ENVIRONMENT_GET_VARIABLE:
             // Return false to indicate variable not found
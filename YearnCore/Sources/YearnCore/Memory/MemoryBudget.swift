@@ -0,0 +1,336 @@
+//
+//  MemoryBudget.swift
+//  YearnCore
+//
+//  Process-wide memory accounting and ordered reclaiming under pressure
+//
+
+import Foundation
+#if canImport(UIKit)
+import UIKit
+#endif
+#if canImport(os)
+import os
+#endif
+
+// MARK: - Pressure Source
+
+/// Where the budget learns how close the process is to being killed
+///
+/// The system source reads `os_proc_available_memory()` on iOS; tests and
+/// platforms without it supply their own.
+public protocol MemoryPressureSource: AnyObject {
+    /// Bytes the process may still allocate before the system terminates it; nil if unknown
+    var availableMemory: Int? { get }
+}
+
+/// `os_proc_available_memory()` where the platform has it
+public final class SystemMemoryPressureSource: MemoryPressureSource {
+    public init() {}
+
+    public var availableMemory: Int? {
+        #if os(iOS) || os(tvOS) || os(visionOS)
+        let available = os_proc_available_memory()
+        return available > 0 ? Int(available) : nil
+        #else
+        return nil
+        #endif
+    }
+}
+
+// MARK: - Memory Budget
+
+/// Keeps account of what each subsystem holds and takes memory back in order
+///
+/// Subsystems register as consumers with a tier, a usage closure and a shrink
+/// closure. When the system sends a memory warning, or the available memory
+/// drops under `lowMemoryThreshold`, consumers are asked to shrink tier by
+/// tier (caches first, then rewind history) until enough has been given
+/// back, largest consumer first within a tier. Once available memory is back
+/// over `targetAvailableMemory`, consumers that were asked to shrink are told
+/// they may grow again. `essential` consumers are only accounted for.
+///
+/// Callbacks run on the thread that reports pressure: the main thread for
+/// warnings and for the monitor started with `startMonitoring`.
+public final class MemoryBudget: @unchecked Sendable {
+
+    public static let shared = MemoryBudget(source: SystemMemoryPressureSource())
+
+    /// Order in which consumers give memory back, lowest first
+    public enum Tier: Int, Comparable, CaseIterable, Sendable {
+        /// Anything that can be decoded or drawn again
+        case cache
+        /// Rewind history; shrinking shortens how far back the player can go
+        case rewind
+        /// Needed to keep running; accounted for, never asked to shrink
+        case essential
+
+        public static func < (lhs: Tier, rhs: Tier) -> Bool {
+            lhs.rawValue < rhs.rawValue
+        }
+    }
+
+    public struct Usage: Sendable {
+        public let name: String
+        public let tier: Tier
+        public let bytes: Int
+        /// Bytes given back under pressure since registering
+        public let reclaimed: Int
+    }
+
+    public struct Statistics: Sendable {
+        public var warnings = 0
+        public var lowMemoryEvents = 0
+        public var reclaimedBytes = 0
+        /// Times pressure passed and shrunk consumers were told they may grow
+        public var restores = 0
+        /// Available memory at the last check, if the source knows it
+        public var lastAvailableMemory: Int?
+    }
+
+    /// Keeps a consumer registered; unregisters when released or cancelled
+    public final class Registration: @unchecked Sendable {
+        fileprivate let id: Int
+        private weak var budget: MemoryBudget?
+
+        fileprivate init(id: Int, budget: MemoryBudget) {
+            self.id = id
+            self.budget = budget
+        }
+
+        deinit {
+            cancel()
+        }
+
+        public func cancel() {
+            budget?.unregister(id)
+            budget = nil
+        }
+    }
+
+    private struct Consumer {
+        let id: Int
+        let name: String
+        let tier: Tier
+        let usage: () -> Int
+        /// Called with the most the consumer may keep; returns what it keeps
+        let shrink: ((Int) -> Int)?
+        /// Called once pressure has passed, to lift the limit `shrink` set
+        let restore: (() -> Void)?
+        var reclaimed = 0
+        var isShrunk = false
+    }
+
+    // MARK: - Properties
+
+    /// Below this much available memory, consumers are asked to shrink
+    public var lowMemoryThreshold = 150 * 1024 * 1024
+
+    /// Available memory to get back to once shrinking starts
+    public var targetAvailableMemory = 250 * 1024 * 1024
+
+    private let source: MemoryPressureSource
+    private let lock = NSLock()
+    private var consumers: [Consumer] = []
+    private var nextID = 0
+    private var stats = Statistics()
+    private var monitor: DispatchSourceTimer?
+    #if canImport(UIKit)
+    private var warningObserver: NSObjectProtocol?
+    #endif
+
+    // MARK: - Initialization
+
+    public init(source: MemoryPressureSource) {
+        self.source = source
+    }
+
+    deinit {
+        monitor?.cancel()
+    }
+
+    // MARK: - Registration
+
+    /// Register a consumer that can give memory back
+    /// - Parameters:
+    ///   - usage: Bytes held now
+    ///   - shrink: Called with the most the consumer may keep (0 to drop
+    ///     everything); returns the bytes it keeps afterwards
+    ///   - restore: Called when available memory is back over the target
+    ///     after `shrink`, for consumers whose limit would otherwise stay
+    public func register(_ name: String, tier: Tier,
+                         usage: @escaping () -> Int,
+                         shrink: @escaping (_ limit: Int) -> Int,
+                         restore: (() -> Void)? = nil) -> Registration {
+        add(Consumer(id: 0, name: name, tier: tier, usage: usage, shrink: shrink, restore: restore))
+    }
+
+    /// Register memory that is only accounted for, such as the running game's buffers
+    public func registerAccounting(_ name: String, usage: @escaping () -> Int) -> Registration {
+        add(Consumer(id: 0, name: name, tier: .essential, usage: usage, shrink: nil, restore: nil))
+    }
+
+    private func add(_ consumer: Consumer) -> Registration {
+        lock.lock()
+        defer { lock.unlock() }
+        nextID += 1
+        consumers.append(Consumer(id: nextID, name: consumer.name, tier: consumer.tier,
+                                  usage: consumer.usage, shrink: consumer.shrink, restore: consumer.restore))
+        return Registration(id: nextID, budget: self)
+    }
+
+    private func unregister(_ id: Int) {
+        lock.lock()
+        consumers.removeAll { $0.id == id }
+        lock.unlock()
+    }
+
+    // MARK: - Accounting
+
+    /// Every registered consumer's current usage, largest first
+    public func usage() -> [Usage] {
+        lock.lock()
+        let current = consumers
+        lock.unlock()
+
+        return current
+            .map { Usage(name: $0.name, tier: $0.tier, bytes: $0.usage(), reclaimed: $0.reclaimed) }
+            .sorted { $0.bytes > $1.bytes }
+    }
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    // MARK: - Pressure
+
+    /// The system warned that memory is short: drop every cache, then go
+    /// deeper if available memory is still under the target
+    public func handleMemoryWarning() {
+        let available = source.availableMemory
+        let cacheBytes = usage().filter { $0.tier == .cache }.reduce(0) { $0 + $1.bytes }
+        let deficit = available.map { max(0, targetAvailableMemory - $0) } ?? 0
+
+        lock.lock()
+        stats.warnings += 1
+        stats.lastAvailableMemory = available
+        lock.unlock()
+
+        let reclaimed = reclaim(max(deficit, cacheBytes))
+        log("⚠️ Memory warning", available: available, reclaimed: reclaimed)
+    }
+
+    /// Poll the pressure source and shrink if available memory is under the
+    /// threshold, or let shrunk consumers grow again once it is over the target
+    public func checkAvailableMemory() {
+        guard let available = source.availableMemory else { return }
+
+        lock.lock()
+        stats.lastAvailableMemory = available
+        let isLow = available < lowMemoryThreshold
+        if isLow {
+            stats.lowMemoryEvents += 1
+        }
+        lock.unlock()
+
+        if isLow {
+            let reclaimed = reclaim(targetAvailableMemory - available)
+            log("⚠️ Low memory", available: available, reclaimed: reclaimed)
+        } else if available >= targetAvailableMemory {
+            restoreShrunkConsumers()
+        }
+    }
+
+    /// Tell every consumer shrunk since the last restore that it may grow again
+    private func restoreShrunkConsumers() {
+        lock.lock()
+        var restores: [() -> Void] = []
+        for index in consumers.indices where consumers[index].isShrunk {
+            consumers[index].isShrunk = false
+            if let restore = consumers[index].restore {
+                restores.append(restore)
+            }
+        }
+        if !restores.isEmpty {
+            stats.restores += 1
+        }
+        lock.unlock()
+
+        restores.forEach { $0() }
+    }
+
+    /// Ask consumers to give back `bytes`, lowest tier first, stopping at `maxTier`
+    /// - Returns: Bytes actually given back
+    @discardableResult
+    public func reclaim(_ bytes: Int, through maxTier: Tier = .rewind) -> Int {
+        guard bytes > 0 else { return 0 }
+
+        lock.lock()
+        let candidates = consumers.filter { $0.shrink != nil && $0.tier <= maxTier && $0.tier != .essential }
+        lock.unlock()
+
+        var remaining = bytes
+        var freedByID: [Int: Int] = [:]
+        for tier in Tier.allCases where tier <= maxTier && remaining > 0 {
+            let inTier = candidates
+                .filter { $0.tier == tier }
+                .map { ($0, $0.usage()) }
+                .sorted { $0.1 > $1.1 }
+            for (consumer, current) in inTier where remaining > 0 && current > 0 {
+                guard let shrink = consumer.shrink else { continue }
+                let kept = shrink(max(0, current - remaining))
+                let freed = max(0, current - kept)
+                remaining -= freed
+                freedByID[consumer.id] = freed
+            }
+        }
+
+        let total = bytes - max(0, remaining)
+        lock.lock()
+        for index in consumers.indices {
+            guard let freed = freedByID[consumers[index].id] else { continue }
+            consumers[index].reclaimed += freed
+            consumers[index].isShrunk = true
+        }
+        stats.reclaimedBytes += total
+        lock.unlock()
+        return total
+    }
+
+    // MARK: - Monitoring
+
+    /// Listen for system memory warnings and poll available memory every `interval` seconds
+    public func startMonitoring(interval: TimeInterval = 2) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard monitor == nil else { return }
+
+        let timer = DispatchSource.makeTimerSource(queue: .main)
+        timer.schedule(deadline: .now() + interval, repeating: interval, leeway: .milliseconds(500))
+        timer.setEventHandler { [weak self] in
+            self?.checkAvailableMemory()
+        }
+        timer.resume()
+        monitor = timer
+
+        #if canImport(UIKit)
+        warningObserver = NotificationCenter.default.addObserver(
+            forName: UIApplication.didReceiveMemoryWarningNotification,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            self?.handleMemoryWarning()
+        }
+        #endif
+    }
+
+    private func log(_ event: String, available: Int?, reclaimed: Int) {
+        let mb = { (bytes: Int) in String(format: "%.1f MB", Double(bytes) / 1_048_576) }
+        let breakdown = usage()
+            .map { "\($0.name) \(mb($0.bytes))" }
+            .joined(separator: ", ")
+        Log.memory.info("\(event): \(available.map(mb) ?? "unknown") available, reclaimed \(mb(reclaimed)); now \(breakdown)")
+    }
+}
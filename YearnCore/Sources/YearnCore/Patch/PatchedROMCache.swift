@@ -0,0 +1,215 @@
+//
+//  PatchedROMCache.swift
+//  YearnCore
+//
+//  Applies IPS / UPS / BPS patches at load time and caches the results
+//
+
+import Foundation
+import CYearnSupport
+
+/// Soft-patching for translation and hack patches
+///
+/// A patch named like the ROM (`Game.sfc` + `Game.bps`) is applied when the
+/// game loads; the ROM file itself is never modified. Patched ROMs are
+/// stored under `Caches/PatchedROMs/<key>/`, keyed by the CRC32 and size of
+/// both the ROM and the patch, so later launches map the cached result
+/// instead of patching again. Entries are evicted least recently used first
+/// once the cache grows past `maxCacheSize`.
+public final class PatchedROMCache: @unchecked Sendable {
+
+    public static let shared = PatchedROMCache()
+
+    /// Patch formats, checksummed formats first
+    public static let patchExtensions = ["bps", "ups", "ips"]
+
+    public enum PatchError: LocalizedError {
+        case failed(String, String)
+
+        public var errorDescription: String? {
+            switch self {
+            case .failed(let patch, let reason): return "Could not apply \(patch): \(reason)"
+            }
+        }
+    }
+
+    public struct Statistics {
+        public var hits = 0
+        public var misses = 0
+        public var bytesPatched: UInt64 = 0
+        public var patchTime: TimeInterval = 0
+
+        /// Patch throughput in MB/s, including checksum validation
+        public var throughput: Double {
+            patchTime > 0 ? Double(bytesPatched) / 1_048_576 / patchTime : 0
+        }
+    }
+
+    // MARK: - Properties
+
+    /// Maximum size of patched ROMs kept on disk
+    public var maxCacheSize: UInt64 = 1024 * 1024 * 1024
+
+    public let cacheDirectory: URL
+
+    private let fileManager = FileManager.default
+    private let lock = NSLock()
+    private var stats = Statistics()
+
+    // MARK: - Initialization
+
+    private init() {
+        let cachesURL = fileManager.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        cacheDirectory = cachesURL.appendingPathComponent("PatchedROMs", isDirectory: true)
+        try? fileManager.createDirectory(at: cacheDirectory, withIntermediateDirectories: true)
+    }
+
+    // MARK: - Public Methods
+
+    public static func isPatch(_ url: URL) -> Bool {
+        patchExtensions.contains(url.pathExtension.lowercased())
+    }
+
+    /// The patch sitting next to a ROM, if any
+    public static func patch(for romURL: URL) -> URL? {
+        let base = romURL.deletingPathExtension()
+        for ext in patchExtensions {
+            for candidate in [base.appendingPathExtension(ext), base.appendingPathExtension(ext.uppercased())] {
+                if FileManager.default.fileExists(atPath: candidate.path) {
+                    return candidate
+                }
+            }
+        }
+        return nil
+    }
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Patch a ROM, reusing a cached result when possible
+    /// - Returns: URL of the patched ROM, named like the original
+    public func apply(patchAt patchURL: URL, to romURL: URL) throws -> URL {
+        let rom = try Data(contentsOf: romURL, options: .alwaysMapped)
+        let patch = try Data(contentsOf: patchURL, options: .alwaysMapped)
+
+        let romCRC = ROMHasher.hash(data: rom, digests: .crc32).crc32
+        let patchCRC = ROMHasher.hash(data: patch, digests: .crc32).crc32
+        let key = String(format: "%08x-%llx-%08x-%llx", romCRC, UInt64(rom.count), patchCRC, UInt64(patch.count))
+        let directory = cacheDirectory.appendingPathComponent(key, isDirectory: true)
+        let patchedURL = directory.appendingPathComponent(romURL.lastPathComponent)
+
+        if fileManager.fileExists(atPath: patchedURL.path) {
+            touch(directory)
+            record { $0.hits += 1 }
+            Log.library.debug("Patch cache hit: \(patchURL.lastPathComponent)")
+            return patchedURL
+        }
+
+        let start = Date()
+        let patched = try Self.patch(rom, with: patch, name: patchURL.lastPathComponent)
+
+        try fileManager.createDirectory(at: directory, withIntermediateDirectories: true)
+        try patched.write(to: patchedURL, options: .atomic)
+
+        let elapsed = Date().timeIntervalSince(start)
+        record {
+            $0.misses += 1
+            $0.bytesPatched += UInt64(patched.count)
+            $0.patchTime += elapsed
+        }
+        Log.library.info("Applied \(patchURL.lastPathComponent): \(patched.count / 1024) KB in \(String(format: "%.0f", elapsed * 1000)) ms")
+
+        evictIfNeeded(keeping: key)
+        return patchedURL
+    }
+
+    /// Remove every patched ROM
+    public func clear() {
+        try? fileManager.removeItem(at: cacheDirectory)
+        try? fileManager.createDirectory(at: cacheDirectory, withIntermediateDirectories: true)
+    }
+
+    // MARK: - Private
+
+    /// Apply a patch in memory
+    /// UPS/BPS patches made for an unheadered SNES ROM also apply to a copy
+    /// with a 512-byte copier header; the result is then unheadered.
+    private static func patch(_ rom: Data, with patch: Data, name: String) throws -> Data {
+        try rom.withUnsafeBytes { (romBytes: UnsafeRawBufferPointer) -> Data in
+            try patch.withUnsafeBytes { (patchBytes: UnsafeRawBufferPointer) -> Data in
+                let patchPointer = patchBytes.bindMemory(to: UInt8.self).baseAddress
+                var source = romBytes.bindMemory(to: UInt8.self)
+
+                var info = yearn_patch_info()
+                var status = yearn_patch_inspect(patchPointer, patchBytes.count, UInt64(source.count), &info)
+                guard status == YEARN_PATCH_OK else {
+                    throw PatchError.failed(name, String(cString: yearn_patch_status_string(status)))
+                }
+                if info.format != YEARN_PATCH_IPS, info.source_size + 512 == UInt64(source.count) {
+                    source = UnsafeBufferPointer(rebasing: source[512...])
+                }
+
+                var target = Data(count: Int(info.target_size))
+                let targetCount = target.count
+                status = target.withUnsafeMutableBytes { targetBytes in
+                    yearn_patch_apply(source.baseAddress, source.count, patchPointer, patchBytes.count,
+                                      targetBytes.bindMemory(to: UInt8.self).baseAddress, targetCount, 1)
+                }
+                guard status == YEARN_PATCH_OK else {
+                    throw PatchError.failed(name, String(cString: yearn_patch_status_string(status)))
+                }
+                return target
+            }
+        }
+    }
+
+    private func record(_ update: (inout Statistics) -> Void) {
+        lock.lock()
+        update(&stats)
+        lock.unlock()
+    }
+
+    /// Mark an entry as recently used
+    private func touch(_ directory: URL) {
+        try? fileManager.setAttributes([.modificationDate: Date()], ofItemAtPath: directory.path)
+    }
+
+    private func cachedItems() -> [(url: URL, size: UInt64, date: Date)] {
+        let keys: [URLResourceKey] = [.contentModificationDateKey, .isDirectoryKey]
+        guard let directories = try? fileManager.contentsOfDirectory(at: cacheDirectory,
+                                                                     includingPropertiesForKeys: keys) else {
+            return []
+        }
+
+        return directories.compactMap { directory in
+            guard let values = try? directory.resourceValues(forKeys: Set(keys)),
+                  values.isDirectory == true else {
+                return nil
+            }
+
+            let files = (try? fileManager.contentsOfDirectory(at: directory,
+                                                              includingPropertiesForKeys: [.fileSizeKey])) ?? []
+            let size = files.reduce(UInt64(0)) { total, file in
+                total + UInt64((try? file.resourceValues(forKeys: [.fileSizeKey]).fileSize) ?? 0)
+            }
+            return (directory, size, values.contentModificationDate ?? .distantPast)
+        }
+    }
+
+    private func evictIfNeeded(keeping key: String) {
+        var items = cachedItems()
+        var total = items.reduce(UInt64(0)) { $0 + $1.size }
+        guard total > maxCacheSize else { return }
+
+        items.sort { $0.date < $1.date }
+        for item in items where total > maxCacheSize {
+            guard item.url.lastPathComponent != key else { continue }
+            try? fileManager.removeItem(at: item.url)
+            total -= item.size
+            Log.library.debug("Evicted patched ROM: \(item.url.lastPathComponent)")
+        }
+    }
+}
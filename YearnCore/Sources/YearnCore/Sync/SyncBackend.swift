@@ -0,0 +1,201 @@
+//
+//  SyncBackend.swift
+//  YearnCore
+//
+//  Storage a SyncEngine syncs against
+//
+
+import Foundation
+#if canImport(Darwin)
+import Darwin
+#else
+import Glibc
+#endif
+
+/// Remote side of a sync: content-addressed chunks plus one manifest per synced directory
+///
+/// Chunks are immutable and named by their SHA-1, so storing one twice is
+/// harmless and an interrupted upload resumes by asking which are missing.
+/// Manifests are replaced with a version check; how far that check reaches
+/// (one process, one device, every device) is up to the backend. A backend
+/// that can only notice a lost race afterwards reports it from `manifest`
+/// as `SyncError.manifestDiverged`.
+public protocol SyncBackend: Sendable {
+    /// The manifest stored under `name`, or nil if there is none yet
+    func manifest(named name: String) async throws -> SyncManifest?
+
+    /// Replace the manifest under `name`
+    /// - Throws: `SyncError.remoteChanged` if the stored manifest's version is no
+    ///   longer `expectedVersion` (0 when there was none)
+    func storeManifest(_ manifest: SyncManifest, named name: String, replacing expectedVersion: UInt64) async throws
+
+    /// The subset of `hashes` the backend does not hold
+    func missingChunks(_ hashes: Set<String>) async throws -> Set<String>
+
+    func uploadChunk(_ data: Data, hash: String) async throws
+
+    func downloadChunk(_ hash: String) async throws -> Data
+
+    /// Names of every stored manifest
+    func manifestNames() async throws -> [String]
+
+    /// Every stored chunk and when it was stored
+    func listChunks() async throws -> [String: Date]
+
+    func deleteChunk(_ hash: String) async throws
+}
+
+/// Backend kept in a directory: `Manifests/<name>.plist` and `Chunks/<ab>/<hash>`
+///
+/// Works with any directory, including one that another service mirrors
+/// (such as an iCloud container), and on Linux for testing. Files are
+/// written beside their target and renamed into place.
+///
+/// The manifest version check holds within this device: on Darwin it runs
+/// under a file coordinator, so other processes using the directory (and a
+/// mirroring service) wait for it. Devices writing through a mirror at the
+/// same time are not excluded; the mirror keeps the losing copy as a
+/// conflict, which the wrapper around this backend has to look for.
+public final class LocalDirectoryBackend: SyncBackend, @unchecked Sendable {
+
+    public let root: URL
+
+    private let fileManager = FileManager.default
+    /// Serialises manifest replacement within this process
+    private let lock = NSLock()
+
+    public init(root: URL) throws {
+        self.root = root
+        try fileManager.createDirectory(at: root.appendingPathComponent("Manifests", isDirectory: true),
+                                        withIntermediateDirectories: true)
+        try fileManager.createDirectory(at: root.appendingPathComponent("Chunks", isDirectory: true),
+                                        withIntermediateDirectories: true)
+    }
+
+    public func manifestURL(named name: String) -> URL {
+        root.appendingPathComponent("Manifests", isDirectory: true).appendingPathComponent("\(name).plist")
+    }
+
+    public func chunkURL(for hash: String) -> URL {
+        root.appendingPathComponent("Chunks", isDirectory: true)
+            .appendingPathComponent(String(hash.prefix(2)), isDirectory: true)
+            .appendingPathComponent(hash)
+    }
+
+    // MARK: - SyncBackend
+
+    public func manifest(named name: String) async throws -> SyncManifest? {
+        lock.lock()
+        defer { lock.unlock() }
+        return try coordinate(reading: manifestURL(named: name)) { try readManifest(at: $0) }
+    }
+
+    public func storeManifest(_ manifest: SyncManifest, named name: String, replacing expectedVersion: UInt64) async throws {
+        lock.lock()
+        defer { lock.unlock() }
+        let encoder = PropertyListEncoder()
+        encoder.outputFormat = .binary
+        let data = try encoder.encode(manifest)
+        try coordinate(writing: manifestURL(named: name)) { url in
+            let current = try readManifest(at: url)?.version ?? 0
+            guard current == expectedVersion else {
+                throw SyncError.remoteChanged
+            }
+            try write(data, to: url)
+        }
+    }
+
+    public func missingChunks(_ hashes: Set<String>) async throws -> Set<String> {
+        hashes.filter { !fileManager.fileExists(atPath: chunkURL(for: $0).path) }
+    }
+
+    public func uploadChunk(_ data: Data, hash: String) async throws {
+        let url = chunkURL(for: hash)
+        guard !fileManager.fileExists(atPath: url.path) else { return }
+        try fileManager.createDirectory(at: url.deletingLastPathComponent(), withIntermediateDirectories: true)
+        try write(data, to: url)
+    }
+
+    public func downloadChunk(_ hash: String) async throws -> Data {
+        let url = chunkURL(for: hash)
+        guard fileManager.fileExists(atPath: url.path) else {
+            throw SyncError.missingChunk(hash)
+        }
+        return try Data(contentsOf: url)
+    }
+
+    public func manifestNames() async throws -> [String] {
+        let directory = root.appendingPathComponent("Manifests", isDirectory: true)
+        return try fileManager.contentsOfDirectory(atPath: directory.path)
+            .filter { !$0.hasPrefix(".") && $0.hasSuffix(".plist") }
+            .map { String($0.dropLast(".plist".count)) }
+    }
+
+    public func listChunks() async throws -> [String: Date] {
+        let chunks = root.appendingPathComponent("Chunks", isDirectory: true)
+        var result: [String: Date] = [:]
+        for prefix in try fileManager.contentsOfDirectory(atPath: chunks.path) where !prefix.hasPrefix(".") {
+            let directory = chunks.appendingPathComponent(prefix, isDirectory: true)
+            for hash in (try? fileManager.contentsOfDirectory(atPath: directory.path)) ?? [] where !hash.hasPrefix(".") {
+                let attributes = try? fileManager.attributesOfItem(atPath: directory.appendingPathComponent(hash).path)
+                result[hash] = attributes?[.modificationDate] as? Date ?? .distantPast
+            }
+        }
+        return result
+    }
+
+    public func deleteChunk(_ hash: String) async throws {
+        let url = chunkURL(for: hash)
+        guard fileManager.fileExists(atPath: url.path) else { return }
+        try fileManager.removeItem(at: url)
+    }
+
+    // MARK: - Private Methods
+
+    private func readManifest(at url: URL) throws -> SyncManifest? {
+        guard fileManager.fileExists(atPath: url.path) else { return nil }
+        return try PropertyListDecoder().decode(SyncManifest.self, from: Data(contentsOf: url))
+    }
+
+    private func coordinate<T>(reading url: URL, _ body: (URL) throws -> T) throws -> T {
+#if canImport(Darwin)
+        var coordinationError: NSError?
+        var result: Result<T, Error>?
+        NSFileCoordinator(filePresenter: nil).coordinate(readingItemAt: url, options: [], error: &coordinationError) {
+            result = Result { try body($0) }
+        }
+        if let coordinationError { throw coordinationError }
+        return try result!.get()
+#else
+        return try body(url)
+#endif
+    }
+
+    /// Run a read-check-write of `url` with no other coordinated access in between
+    private func coordinate(writing url: URL, _ body: (URL) throws -> Void) throws {
+#if canImport(Darwin)
+        var coordinationError: NSError?
+        var result: Result<Void, Error> = .success(())
+        NSFileCoordinator(filePresenter: nil).coordinate(writingItemAt: url, options: .forReplacing,
+                                                         error: &coordinationError) {
+            result = Result { try body($0) }
+        }
+        if let coordinationError { throw coordinationError }
+        try result.get()
+#else
+        try body(url)
+#endif
+    }
+
+    /// Write beside the target and rename, so a reader never sees half a file
+    private func write(_ data: Data, to url: URL) throws {
+        let temporaryURL = url.deletingLastPathComponent()
+            .appendingPathComponent(".\(url.lastPathComponent).\(UUID().uuidString)")
+        try data.write(to: temporaryURL)
+        guard rename(temporaryURL.path, url.path) == 0 else {
+            let error = POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+            try? fileManager.removeItem(at: temporaryURL)
+            throw error
+        }
+    }
+}
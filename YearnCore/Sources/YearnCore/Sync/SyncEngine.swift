@@ -0,0 +1,686 @@
+//
+//  SyncEngine.swift
+//  YearnCore
+//
+//  Three-way, chunk-level sync of a directory against a SyncBackend
+//
+
+import Foundation
+#if canImport(Darwin)
+import Darwin
+#else
+import Glibc
+#endif
+
+/// Files of a synced directory as content hashes
+public struct SyncManifest: Codable, Sendable {
+
+    public struct File: Codable, Sendable, Equatable {
+        public var size: UInt64
+        /// SHA-1 of the whole file; empty for a deletion
+        public var hash: String
+        /// SHA-1 of each `chunkSize` piece, in order
+        public var chunks: [String]
+        /// Informational; only used by `ConflictPolicy.newest`
+        public var modified: Date
+        /// Tombstone, so other devices learn about the deletion
+        public var deleted = false
+
+        public init(size: UInt64, hash: String, chunks: [String], modified: Date, deleted: Bool = false) {
+            self.size = size
+            self.hash = hash
+            self.chunks = chunks
+            self.modified = modified
+            self.deleted = deleted
+        }
+    }
+
+    /// Bumped on every store, for the backend's version check
+    public var version: UInt64 = 0
+    public var chunkSize: Int
+    /// Keyed by path relative to the synced directory
+    ///
+    /// As stored on a backend this holds only files at the top level; the
+    /// files under each top-level directory are in `shards`.
+    public var files: [String: File] = [:]
+    /// Top-level directory to the chunk holding its files, so a sync that
+    /// touches one game's saves rewrites only that game's list
+    public var shards: [String: String] = [:]
+
+    public init(chunkSize: Int) {
+        self.chunkSize = chunkSize
+    }
+
+    func live(_ path: String) -> File? {
+        files[path].flatMap { $0.deleted ? nil : $0 }
+    }
+}
+
+public enum SyncError: Error {
+    /// Another device stored a manifest since it was read
+    case remoteChanged
+    /// Devices replaced the manifest at once and the backend kept one copy;
+    /// the others' changes may be missing from it
+    case manifestDiverged
+    case missingChunk(String)
+    /// A downloaded chunk did not match its hash
+    case corruptChunk(String)
+    /// A local file changed while it was being uploaded
+    case fileChanged(String)
+    /// The backend's manifest uses a different chunk size
+    case chunkSizeMismatch(Int)
+}
+
+/// Syncs a local directory with a backend, transferring only changed chunks
+///
+/// Every file is described by its size, SHA-1 and the SHA-1s of its
+/// fixed-size chunks (save states are memory dumps whose layout does not
+/// move, so most chunks survive a play session unchanged). A sync compares
+/// three manifests: the local files, the backend's, and the one both agreed
+/// on after the last sync. A file changed on one side only is copied to the
+/// other; a file changed on both is resolved by `conflictPolicy`.
+/// Modification dates are never used to decide what changed, so clock skew
+/// between devices cannot cause copies.
+///
+/// Only chunks the backend lacks are uploaded, and only chunks the local
+/// copy lacks are downloaded. Chunks are content-addressed and downloads are
+/// staged under `stateDirectory`, so an interrupted sync resumes where it
+/// stopped. Up to `maxConcurrentTransfers` chunks move at once.
+public final class SyncEngine: @unchecked Sendable {
+
+    public enum ConflictPolicy: Sendable {
+        /// Keep the backend's version under the original name and the local one as a renamed copy
+        case keepBoth
+        case preferLocal
+        case preferRemote
+        /// The version with the later modification date
+        case newest
+    }
+
+    public struct Statistics: Sendable {
+        public var bytesUploaded: UInt64 = 0
+        public var bytesDownloaded: UInt64 = 0
+        public var chunksUploaded = 0
+        public var chunksDownloaded = 0
+        /// Chunks of changed files that did not need transferring
+        public var chunksReused = 0
+        public var filesUploaded = 0
+        public var filesDownloaded = 0
+        public var filesDeleted = 0
+        public var conflicts = 0
+
+        public init() {}
+    }
+
+    /// Cached hashes of a local file, valid while size and modification time match
+    private struct ScannedFile: Codable {
+        var size: UInt64
+        var modificationTime: Double
+        var file: SyncManifest.File
+    }
+
+    private enum Action {
+        case upload
+        case download
+        case deleteRemote
+        case deleteLocal
+        /// Keep both: move the local file aside, then download
+        case keepBoth
+    }
+
+    // MARK: - Properties
+
+    /// Manifest name on the backend
+    public let name: String
+    public let directory: URL
+    public let backend: SyncBackend
+
+    public var chunkSize = 16 * 1024
+    public var maxConcurrentTransfers = 4
+    public var conflictPolicy: ConflictPolicy = .keepBoth
+    /// Appended to conflict copies, e.g. "slot1 (iPhone).state"
+    public var deviceName = "Conflict"
+
+    private let stateDirectory: URL
+    private let fileManager = FileManager.default
+    private let lock = NSLock()
+    private var stats = Statistics()
+
+    private static let maxAttempts = 3
+
+    // MARK: - Initialization
+
+    /// - Parameter stateDirectory: Where this device keeps the last agreed manifest,
+    ///   cached hashes and staged downloads for `name`
+    public init(name: String, directory: URL, backend: SyncBackend, stateDirectory: URL) {
+        self.name = name
+        self.directory = directory
+        self.backend = backend
+        self.stateDirectory = stateDirectory.appendingPathComponent(name, isDirectory: true)
+    }
+
+    // MARK: - Public Methods
+
+    /// Totals over every sync run by this engine
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return stats
+    }
+
+    /// Bring the directory and the backend in line
+    ///
+    /// Run one sync at a time per engine.
+    /// - Returns: What this sync transferred
+    @discardableResult
+    public func sync() async throws -> Statistics {
+        try fileManager.createDirectory(at: directory, withIntermediateDirectories: true)
+        try fileManager.createDirectory(at: stagingDirectory, withIntermediateDirectories: true)
+        try fileManager.createDirectory(at: shardCacheDirectory, withIntermediateDirectories: true)
+
+        var report = Statistics()
+        defer { record(report) }
+
+        var attempt = 1
+        while true {
+            do {
+                try await syncOnce(&report)
+                try? fileManager.removeItem(at: stagingDirectory)
+                return report
+            } catch SyncError.remoteChanged where attempt < Self.maxAttempts {
+                // Another device stored first: merge with its manifest; chunks already sent stay sent
+                attempt += 1
+            } catch SyncError.manifestDiverged where attempt < Self.maxAttempts {
+                // What this device last agreed on may be the copy that was dropped. Without a
+                // base every difference is a conflict, so nothing is overwritten unseen
+                Log.sync.warning("Manifest \(name) diverged between devices; comparing every file")
+                try? fileManager.removeItem(at: stateDirectory.appendingPathComponent("Base.plist"))
+                attempt += 1
+            }
+        }
+    }
+
+    // MARK: - Garbage Collection
+
+    /// Delete chunks no stored manifest refers to
+    ///
+    /// Marks the shards and file chunks of every manifest on the backend,
+    /// then sweeps the rest. Chunks stored within `gracePeriod` are kept,
+    /// since a sync elsewhere may have uploaded them and not yet stored the
+    /// manifest that refers to them.
+    /// - Returns: The number of chunks deleted
+    @discardableResult
+    public static func collectGarbage(in backend: SyncBackend, gracePeriod: TimeInterval = 24 * 60 * 60) async throws -> Int {
+        var live = Set<String>()
+        for name in try await backend.manifestNames() {
+            guard let manifest = try await backend.manifest(named: name) else { continue }
+            for file in manifest.files.values {
+                live.formUnion(file.chunks)
+            }
+            for hash in manifest.shards.values {
+                live.insert(hash)
+                let data = try await backend.downloadChunk(hash)
+                guard sha1(data) == hash else {
+                    throw SyncError.corruptChunk(hash)
+                }
+                let files = try PropertyListDecoder().decode([String: SyncManifest.File].self, from: data)
+                for file in files.values {
+                    live.formUnion(file.chunks)
+                }
+            }
+        }
+
+        let cutoff = Date().addingTimeInterval(-gracePeriod)
+        var deleted = 0
+        for (hash, stored) in try await backend.listChunks() where !live.contains(hash) && stored < cutoff {
+            try await backend.deleteChunk(hash)
+            deleted += 1
+        }
+        Log.sync.info("Chunk collection: \(live.count) live, \(deleted) deleted")
+        return deleted
+    }
+
+    // MARK: - Sync
+
+    private func record(_ report: Statistics) {
+        lock.lock()
+        stats.add(report)
+        lock.unlock()
+    }
+
+    private func syncOnce(_ report: inout Statistics) async throws {
+        var local = try scan()
+        var base = loadState(SyncManifest.self, "Base.plist") ?? SyncManifest(chunkSize: chunkSize)
+        let stored = try await backend.manifest(named: name) ?? SyncManifest(chunkSize: chunkSize)
+        guard stored.chunkSize == chunkSize else {
+            throw SyncError.chunkSizeMismatch(stored.chunkSize)
+        }
+        let remote = try await expand(stored)
+        if base.chunkSize != chunkSize {
+            base = SyncManifest(chunkSize: chunkSize)
+        }
+
+        var conflicts = 0
+        let plan = self.plan(local: local, base: base, remote: remote, conflicts: &conflicts)
+        defer { saveState(base, "Base.plist") }
+
+        // Paths both sides already agree on, e.g. on a first sync or deleted on both
+        for path in Set(local.keys).union(base.files.keys).union(remote.files.keys) where plan[path] == nil {
+            if local[path]?.hash == remote.live(path)?.hash {
+                base.files[path] = local[path]
+            }
+        }
+
+        // Upload, then publish the new manifest in one version-checked store
+        var published = remote
+        let uploads = plan.filter { $0.value == .upload }.map(\.key)
+        let deletions = plan.filter { $0.value == .deleteRemote }.map(\.key)
+        if !uploads.isEmpty || !deletions.isEmpty {
+            try await upload(uploads, local: local, report: &report)
+            for path in uploads {
+                published.files[path] = local[path]
+            }
+            for path in deletions {
+                published.files[path] = SyncManifest.File(size: 0, hash: "", chunks: [], modified: Date(), deleted: true)
+            }
+            published.version = stored.version + 1
+            let sharded = try await shard(published, stored: stored, remote: remote)
+            try await backend.storeManifest(sharded, named: name, replacing: stored.version)
+            published.shards = sharded.shards
+            for path in uploads {
+                base.files[path] = local[path]
+            }
+            for path in deletions {
+                base.files.removeValue(forKey: path)
+            }
+            report.filesUploaded += uploads.count
+            report.filesDeleted += deletions.count
+        }
+
+        // Bring down what changed remotely
+        for (path, action) in plan.sorted(by: { $0.key < $1.key }) {
+            switch action {
+            case .deleteLocal:
+                try? fileManager.removeItem(at: url(for: path))
+                local.removeValue(forKey: path)
+                base.files.removeValue(forKey: path)
+                report.filesDeleted += 1
+            case .keepBoth, .download:
+                guard let file = remote.live(path) else { continue }
+                var current = local[path]
+                if action == .keepBoth {
+                    try moveAside(path)
+                    current = nil
+                }
+                try await download(path, file: file, current: current, report: &report)
+                base.files[path] = file
+                report.filesDownloaded += 1
+            case .upload, .deleteRemote:
+                break
+            }
+        }
+        base.version = published.version
+        report.conflicts += conflicts
+        pruneShardCache(keeping: Set(published.shards.values))
+    }
+
+    /// What to do with each path that differs
+    private func plan(local: [String: SyncManifest.File], base: SyncManifest, remote: SyncManifest,
+                      conflicts: inout Int) -> [String: Action] {
+        var actions: [String: Action] = [:]
+        let paths = Set(local.keys).union(base.files.keys).union(remote.files.keys)
+        for path in paths {
+            let mine = local[path]
+            let agreed = base.live(path)
+            let theirs = remote.live(path)
+
+            let localChanged = mine?.hash != agreed?.hash
+            let remoteChanged = theirs?.hash != agreed?.hash
+            guard mine?.hash != theirs?.hash else { continue }
+
+            switch (localChanged, remoteChanged) {
+            case (false, false):
+                continue
+            case (true, false):
+                actions[path] = mine != nil ? .upload : .deleteRemote
+            case (false, true):
+                actions[path] = theirs != nil ? .download : .deleteLocal
+            case (true, true):
+                conflicts += 1
+                actions[path] = resolve(mine: mine, theirs: theirs)
+            }
+        }
+        return actions
+    }
+
+    private func resolve(mine: SyncManifest.File?, theirs: SyncManifest.File?) -> Action {
+        // An edit beats a deletion unless a side is preferred outright
+        guard let mine, let theirs else {
+            switch conflictPolicy {
+            case .preferLocal: return mine != nil ? .upload : .deleteRemote
+            case .preferRemote: return theirs != nil ? .download : .deleteLocal
+            case .keepBoth, .newest: return mine != nil ? .upload : .download
+            }
+        }
+        switch conflictPolicy {
+        case .keepBoth: return .keepBoth
+        case .preferLocal: return .upload
+        case .preferRemote: return .download
+        case .newest: return mine.modified >= theirs.modified ? .upload : .download
+        }
+    }
+
+    // MARK: - Manifest Shards
+
+    /// The stored manifest with every shard's files merged into `files`
+    private func expand(_ stored: SyncManifest) async throws -> SyncManifest {
+        var manifest = stored
+        for hash in stored.shards.values {
+            let data = try await shardData(hash)
+            let files = try PropertyListDecoder().decode([String: SyncManifest.File].self, from: data)
+            manifest.files.merge(files) { top, _ in top }
+        }
+        return manifest
+    }
+
+    /// `manifest` split for storing, reusing the shards of directories that did not change
+    private func shard(_ manifest: SyncManifest, stored: SyncManifest, remote: SyncManifest) async throws -> SyncManifest {
+        var result = manifest
+        result.shards = [:]
+        let directories = Self.split(&result.files)
+        var unchanged = remote.files
+        let remoteDirectories = Self.split(&unchanged)
+
+        let encoder = PropertyListEncoder()
+        encoder.outputFormat = .binary
+        for (directory, files) in directories {
+            if let hash = stored.shards[directory], remoteDirectories[directory] == files {
+                result.shards[directory] = hash
+                continue
+            }
+            let data = try encoder.encode(files)
+            let hash = Self.sha1(data)
+            let missing = try await backend.missingChunks([hash])
+            if !missing.isEmpty {
+                try await backend.uploadChunk(data, hash: hash)
+            }
+            try? data.write(to: shardCacheDirectory.appendingPathComponent(hash), options: .atomic)
+            result.shards[directory] = hash
+        }
+        return result
+    }
+
+    /// Move files below a top-level directory out of `files`, grouped by that directory
+    private static func split(_ files: inout [String: SyncManifest.File]) -> [String: [String: SyncManifest.File]] {
+        var directories: [String: [String: SyncManifest.File]] = [:]
+        for (path, file) in files {
+            guard let slash = path.firstIndex(of: "/") else { continue }
+            directories[String(path[..<slash]), default: [:]][path] = file
+            files.removeValue(forKey: path)
+        }
+        return directories
+    }
+
+    /// Shards are content-addressed, so a cached copy never goes stale
+    private func shardData(_ hash: String) async throws -> Data {
+        let url = shardCacheDirectory.appendingPathComponent(hash)
+        if let data = try? Data(contentsOf: url) {
+            return data
+        }
+        let data = try await backend.downloadChunk(hash)
+        guard Self.sha1(data) == hash else {
+            throw SyncError.corruptChunk(hash)
+        }
+        try? data.write(to: url, options: .atomic)
+        return data
+    }
+
+    private func pruneShardCache(keeping hashes: Set<String>) {
+        let cached = (try? fileManager.contentsOfDirectory(atPath: shardCacheDirectory.path)) ?? []
+        for hash in cached where !hashes.contains(hash) {
+            try? fileManager.removeItem(at: shardCacheDirectory.appendingPathComponent(hash))
+        }
+    }
+
+    // MARK: - Transfers
+
+    private func upload(_ paths: [String], local: [String: SyncManifest.File], report: inout Statistics) async throws {
+        // Where each needed chunk can be read from; a chunk shared by several files is sent once
+        var sources: [String: (path: String, index: Int)] = [:]
+        for path in paths {
+            for (index, hash) in (local[path]?.chunks ?? []).enumerated() where sources[hash] == nil {
+                sources[hash] = (path, index)
+            }
+        }
+        let missing = try await backend.missingChunks(Set(sources.keys))
+        report.chunksReused += sources.count - missing.count
+
+        let chunkSize = self.chunkSize
+        let backend = self.backend
+        let jobs = missing.sorted().compactMap { hash in sources[hash].map { (hash, url(for: $0.path), $0.index) } }
+        let sent = try await transfer(jobs) { hash, url, index in
+            let data = try Self.readChunk(at: url, index: index, chunkSize: chunkSize)
+            guard Self.sha1(data) == hash else {
+                throw SyncError.fileChanged(url.lastPathComponent)
+            }
+            try await backend.uploadChunk(data, hash: hash)
+            return UInt64(data.count)
+        }
+        report.chunksUploaded += jobs.count
+        report.bytesUploaded += sent
+    }
+
+    private func download(_ path: String, file: SyncManifest.File, current: SyncManifest.File?,
+                          report: inout Statistics) async throws {
+        // Chunks the local copy already has are read from it instead
+        var localChunks: [String: Int] = [:]
+        for (index, hash) in (current?.chunks ?? []).enumerated() where localChunks[hash] == nil {
+            localChunks[hash] = index
+        }
+        let needed = Set(file.chunks).filter { localChunks[$0] == nil }
+        let staged = needed.filter { fileManager.fileExists(atPath: stagedURL(for: $0).path) }
+        let fetch = needed.subtracting(staged).sorted()
+        report.chunksReused += file.chunks.count - fetch.count
+
+        let backend = self.backend
+        let staging = stagingDirectory
+        let received = try await transfer(fetch) { hash in
+            let data = try await backend.downloadChunk(hash)
+            guard Self.sha1(data) == hash else {
+                throw SyncError.corruptChunk(hash)
+            }
+            try data.write(to: staging.appendingPathComponent(hash), options: .atomic)
+            return UInt64(data.count)
+        }
+        report.chunksDownloaded += fetch.count
+        report.bytesDownloaded += received
+
+        // Assemble beside the target and rename over it
+        let target = url(for: path)
+        try fileManager.createDirectory(at: target.deletingLastPathComponent(), withIntermediateDirectories: true)
+        let temporaryURL = target.deletingLastPathComponent().appendingPathComponent(".\(target.lastPathComponent).sync")
+        fileManager.createFile(atPath: temporaryURL.path, contents: nil)
+        let output = try FileHandle(forWritingTo: temporaryURL)
+        do {
+            for hash in file.chunks {
+                let data: Data
+                if let index = localChunks[hash] {
+                    data = try Self.readChunk(at: target, index: index, chunkSize: chunkSize)
+                } else {
+                    data = try Data(contentsOf: stagedURL(for: hash))
+                }
+                try output.write(contentsOf: data)
+            }
+            try output.close()
+        } catch {
+            try? output.close()
+            try? fileManager.removeItem(at: temporaryURL)
+            throw error
+        }
+        let assembled = try Data(contentsOf: temporaryURL, options: .mappedIfSafe)
+        guard Self.sha1(assembled) == file.hash else {
+            try? fileManager.removeItem(at: temporaryURL)
+            throw SyncError.fileChanged(path)
+        }
+        guard rename(temporaryURL.path, target.path) == 0 else {
+            let error = POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+            try? fileManager.removeItem(at: temporaryURL)
+            throw error
+        }
+    }
+
+    /// Run `body` over `items`, at most `maxConcurrentTransfers` at a time
+    /// - Returns: The sum of what `body` returned
+    private func transfer<Item: Sendable>(_ items: [Item],
+                                          _ body: @escaping @Sendable (Item) async throws -> UInt64) async throws -> UInt64 {
+        let width = max(1, maxConcurrentTransfers)
+        return try await withThrowingTaskGroup(of: UInt64.self) { group in
+            var total: UInt64 = 0
+            var next = items.makeIterator()
+            for _ in 0..<width {
+                guard let item = next.next() else { break }
+                group.addTask { try await body(item) }
+            }
+            while let bytes = try await group.next() {
+                total += bytes
+                if let item = next.next() {
+                    group.addTask { try await body(item) }
+                }
+            }
+            return total
+        }
+    }
+
+    /// Rename a conflicting local file, e.g. "slot1.state" to "slot1 (iPhone).state"
+    private func moveAside(_ path: String) throws {
+        let source = url(for: path)
+        guard fileManager.fileExists(atPath: source.path) else { return }
+        let stem = source.deletingPathExtension().lastPathComponent
+        let ext = source.pathExtension
+        var copy = 1
+        var destination: URL
+        repeat {
+            let suffix = copy == 1 ? deviceName : "\(deviceName) \(copy)"
+            let fileName = ext.isEmpty ? "\(stem) (\(suffix))" : "\(stem) (\(suffix)).\(ext)"
+            destination = source.deletingLastPathComponent().appendingPathComponent(fileName)
+            copy += 1
+        } while fileManager.fileExists(atPath: destination.path)
+        try fileManager.moveItem(at: source, to: destination)
+    }
+
+    // MARK: - Local Files
+
+    /// Every regular file under `directory`, hashed unless unchanged since the last scan
+    private func scan() throws -> [String: SyncManifest.File] {
+        var cache = loadState([String: ScannedFile].self, "Scan.plist") ?? [:]
+        var files: [String: SyncManifest.File] = [:]
+        var seen = Set<String>()
+
+        let keys: [URLResourceKey] = [.isRegularFileKey, .fileSizeKey, .contentModificationDateKey]
+        let root = directory.standardizedFileURL.path
+        guard let enumerator = fileManager.enumerator(at: directory, includingPropertiesForKeys: keys,
+                                                      options: [.skipsHiddenFiles]) else {
+            return [:]
+        }
+        for case let url as URL in enumerator {
+            let values = try url.resourceValues(forKeys: Set(keys))
+            guard values.isRegularFile == true else { continue }
+            let fullPath = url.standardizedFileURL.path
+            guard fullPath.hasPrefix(root + "/") else { continue }
+            let path = String(fullPath.dropFirst(root.count + 1))
+            let size = UInt64(values.fileSize ?? 0)
+            let modified = values.contentModificationDate ?? Date(timeIntervalSince1970: 0)
+            seen.insert(path)
+
+            if let cached = cache[path], cached.size == size,
+               cached.modificationTime == modified.timeIntervalSinceReferenceDate,
+               cached.file.chunks.count == Self.chunkCount(size, chunkSize) {
+                files[path] = cached.file
+                continue
+            }
+            let file = try hashFile(at: url, modified: modified)
+            cache[path] = ScannedFile(size: size, modificationTime: modified.timeIntervalSinceReferenceDate, file: file)
+            files[path] = file
+        }
+
+        cache = cache.filter { seen.contains($0.key) }
+        saveState(cache, "Scan.plist")
+        return files
+    }
+
+    private func hashFile(at url: URL, modified: Date) throws -> SyncManifest.File {
+        let data = try Data(contentsOf: url, options: .mappedIfSafe)
+        var chunks: [String] = []
+        chunks.reserveCapacity(Self.chunkCount(UInt64(data.count), chunkSize))
+        var offset = 0
+        while offset < data.count {
+            let end = min(offset + chunkSize, data.count)
+            chunks.append(Self.sha1(data[offset..<end]))
+            offset = end
+        }
+        return SyncManifest.File(size: UInt64(data.count), hash: Self.sha1(data), chunks: chunks, modified: modified)
+    }
+
+    private static func chunkCount(_ size: UInt64, _ chunkSize: Int) -> Int {
+        Int((size + UInt64(chunkSize) - 1) / UInt64(chunkSize))
+    }
+
+    private static func readChunk(at url: URL, index: Int, chunkSize: Int) throws -> Data {
+        let handle = try FileHandle(forReadingFrom: url)
+        defer { try? handle.close() }
+        try handle.seek(toOffset: UInt64(index) * UInt64(chunkSize))
+        return try handle.read(upToCount: chunkSize) ?? Data()
+    }
+
+    private static func sha1<Bytes: DataProtocol>(_ bytes: Bytes) -> String {
+        ROMHasher.hash(data: Data(bytes), digests: .sha1).sha1String ?? ""
+    }
+
+    private func url(for path: String) -> URL {
+        directory.appendingPathComponent(path)
+    }
+
+    // MARK: - State
+
+    private var shardCacheDirectory: URL {
+        stateDirectory.appendingPathComponent("Shards", isDirectory: true)
+    }
+
+    private var stagingDirectory: URL {
+        stateDirectory.appendingPathComponent("Staging", isDirectory: true)
+    }
+
+    private func stagedURL(for hash: String) -> URL {
+        stagingDirectory.appendingPathComponent(hash)
+    }
+
+    private func loadState<Value: Decodable>(_ type: Value.Type, _ fileName: String) -> Value? {
+        guard let data = try? Data(contentsOf: stateDirectory.appendingPathComponent(fileName)) else { return nil }
+        return try? PropertyListDecoder().decode(type, from: data)
+    }
+
+    private func saveState<Value: Encodable>(_ value: Value, _ fileName: String) {
+        let encoder = PropertyListEncoder()
+        encoder.outputFormat = .binary
+        do {
+            try fileManager.createDirectory(at: stateDirectory, withIntermediateDirectories: true)
+            try encoder.encode(value).write(to: stateDirectory.appendingPathComponent(fileName), options: .atomic)
+        } catch {
+            Log.sync.warning("Could not save sync state \(fileName): \(error)")
+        }
+    }
+}
+
+private extension SyncEngine.Statistics {
+    mutating func add(_ other: Self) {
+        bytesUploaded += other.bytesUploaded
+        bytesDownloaded += other.bytesDownloaded
+        chunksUploaded += other.chunksUploaded
+        chunksDownloaded += other.chunksDownloaded
+        chunksReused += other.chunksReused
+        filesUploaded += other.filesUploaded
+        filesDownloaded += other.filesDownloaded
+        filesDeleted += other.filesDeleted
+        conflicts += other.conflicts
+    }
+}
@@ -0,0 +1,71 @@
+//
+//  PixelConversion.swift
+//  YearnCore
+//
+//  Convert libretro frames to BGRA8888 for upload
+//
+
+import Foundation
+
+/// Converts core frames in any `LibretroPixelFormat` to tightly packed BGRA8888
+public enum PixelConversion {
+
+    /// Convert one frame
+    /// - Parameters:
+    ///   - source: First row of the frame
+    ///   - pitch: Source bytes per row, which may include padding
+    ///   - destination: `width * height * 4` bytes; rows are written without padding
+    public static func convertToBGRA(
+        _ source: UnsafeRawPointer,
+        width: Int,
+        height: Int,
+        pitch: Int,
+        format: LibretroPixelFormat,
+        into destination: UnsafeMutableRawPointer
+    ) {
+        let dst = destination.assumingMemoryBound(to: UInt8.self)
+
+        switch format {
+        case .xrgb8888:
+            // Little-endian XRGB8888 is [B, G, R, X] in memory; only alpha changes
+            for y in 0..<height {
+                let srcRow = source.advanced(by: y * pitch).assumingMemoryBound(to: UInt8.self)
+                let dstRow = dst.advanced(by: y * width * 4)
+                for x in 0..<width {
+                    dstRow[x * 4 + 0] = srcRow[x * 4 + 0]  // B
+                    dstRow[x * 4 + 1] = srcRow[x * 4 + 1]  // G
+                    dstRow[x * 4 + 2] = srcRow[x * 4 + 2]  // R
+                    dstRow[x * 4 + 3] = 255                // A
+                }
+            }
+
+        case .rgb565:
+            // RRRRRGGGGGGBBBBB
+            for y in 0..<height {
+                let srcRow = source.advanced(by: y * pitch)
+                let dstRow = dst.advanced(by: y * width * 4)
+                for x in 0..<width {
+                    let pixel = UInt16(littleEndian: srcRow.loadUnaligned(fromByteOffset: x * 2, as: UInt16.self))
+                    dstRow[x * 4 + 0] = UInt8(pixel & 0x1F) << 3           // B
+                    dstRow[x * 4 + 1] = UInt8((pixel >> 5) & 0x3F) << 2    // G
+                    dstRow[x * 4 + 2] = UInt8((pixel >> 11) & 0x1F) << 3   // R
+                    dstRow[x * 4 + 3] = 255                                 // A
+                }
+            }
+
+        case .rgb1555:
+            // 0RRRRRGGGGGBBBBB
+            for y in 0..<height {
+                let srcRow = source.advanced(by: y * pitch)
+                let dstRow = dst.advanced(by: y * width * 4)
+                for x in 0..<width {
+                    let pixel = UInt16(littleEndian: srcRow.loadUnaligned(fromByteOffset: x * 2, as: UInt16.self))
+                    dstRow[x * 4 + 0] = UInt8(pixel & 0x1F) << 3           // B
+                    dstRow[x * 4 + 1] = UInt8((pixel >> 5) & 0x1F) << 3    // G
+                    dstRow[x * 4 + 2] = UInt8((pixel >> 10) & 0x1F) << 3   // R
+                    dstRow[x * 4 + 3] = 255                                 // A
+                }
+            }
+        }
+    }
+}
@@ -6,7 +6,6 @@
 //
 
 import Foundation
-import Metal
 
 /// Video frame buffer for storing pixel data
 public final class VideoBuffer {
@@ -92,19 +91,6 @@ public enum PixelFormat: Sendable {
             return 4
         }
     }
-    
-    public var metalPixelFormat: MTLPixelFormat {
-        switch self {
-        case .rgb565:
-            return .b5g6r5Unorm
-        case .rgba8888:
-            return .rgba8Unorm
-        case .bgra8888:
-            return .bgra8Unorm
-        case .xrgb8888:
-            return .bgra8Unorm
-        }
-    }
 }
 
 // MARK: - Video Format
@@ -127,10 +113,6 @@ public struct VideoFormat: Sendable {
         return Double(width) / Double(height)
     }
     
-    var metalPixelFormat: MTLPixelFormat {
-        return pixelFormat.metalPixelFormat
-    }
-    
     // Common video formats for different systems
     public static let nes = VideoFormat(width: 256, height: 240, pixelFormat: .rgb565, frameRate: 60.0988)
     public static let snes = VideoFormat(width: 256, height: 224, pixelFormat: .rgb565, frameRate: 60.0988)
@@ -0,0 +1,191 @@
+//
+//  main.swift
+//  YearnHeadless
+//
+//  Runs a libretro core with no window or audio device, for profiling and
+//  repeatable runs on any host, Linux included
+//
+//  swift run -c release YearnHeadless --core CORE --rom ROM [options]
+//
+//    --core PATH          Dynamic libretro core (.so, .dylib)
+//    --rom PATH           Game to load
+//    --frames N           Frames to run (default 600)
+//    --realtime           Hold the core's frame rate instead of running flat out
+//    --system DIR         BIOS directory handed to the core
+//    --saves DIR          Save directory handed to the core
+//    --video-dir DIR      Write frames there as PPM images
+//    --video-every N      Keep every Nth frame (default 60)
+//    --audio PATH         Write the audio to a WAV file
+//    --input PATH         Replay a joypad script; see ScriptedInputSource
+//    --rewind             Take a rewind state after every frame, as the app does
+//    --watchdog           Report frames that hang, with a backtrace, on standard error
+//
+//  Under a profiler: perf record -g .build/release/YearnHeadless ...
+//  or valgrind --tool=callgrind .build/release/YearnHeadless --frames 60 ...
+//
+
+import Foundation
+import YearnCore
+
+// MARK: - Options
+
+struct Options {
+    var corePath: String?
+    var romPath: String?
+    var frames = 600
+    var pacing = EmulationSession.Pacing.unthrottled
+    var systemDirectory: String?
+    var saveDirectory: String?
+    var videoDirectory: String?
+    var videoInterval = 60
+    var audioPath: String?
+    var inputPath: String?
+    var rewind = false
+    var watchdog = false
+
+    init(_ arguments: [String]) throws {
+        var arguments = arguments[...]
+        func value(for flag: String) throws -> String {
+            guard let value = arguments.popFirst() else { throw UsageError("\(flag) needs a value") }
+            return value
+        }
+        func count(for flag: String) throws -> Int {
+            let text = try value(for: flag)
+            guard let number = Int(text), number > 0 else { throw UsageError("\(flag): not a positive number: \(text)") }
+            return number
+        }
+
+        while let flag = arguments.popFirst() {
+            switch flag {
+            case "--core": corePath = try value(for: flag)
+            case "--rom": romPath = try value(for: flag)
+            case "--frames": frames = try count(for: flag)
+            case "--realtime": pacing = .realtime
+            case "--system": systemDirectory = try value(for: flag)
+            case "--saves": saveDirectory = try value(for: flag)
+            case "--video-dir": videoDirectory = try value(for: flag)
+            case "--video-every": videoInterval = try count(for: flag)
+            case "--audio": audioPath = try value(for: flag)
+            case "--input": inputPath = try value(for: flag)
+            case "--rewind": rewind = true
+            case "--watchdog": watchdog = true
+            default: throw UsageError("Unknown option \(flag)")
+            }
+        }
+        guard corePath != nil, romPath != nil else {
+            throw UsageError("--core and --rom are required")
+        }
+    }
+}
+
+struct UsageError: Error, CustomStringConvertible {
+    let description: String
+    init(_ description: String) { self.description = description }
+}
+
+func fail(_ message: String, status: Int32 = 1) -> Never {
+    FileHandle.standardError.write(Data((message + "\n").utf8))
+    exit(status)
+}
+
+func milliseconds(_ seconds: TimeInterval) -> String {
+    String(format: "%.2f ms", seconds * 1000)
+}
+
+// MARK: - Main
+
+let options: Options
+do {
+    options = try Options(Array(CommandLine.arguments.dropFirst()))
+} catch {
+    fail("\(error)\nSee the top of main.swift for options.", status: 2)
+}
+
+let nullVideo = NullVideoSink()
+let nullAudio = NullAudioSink()
+var fileVideo: PPMVideoSink?
+var wavAudio: WAVAudioSink?
+var input: InputSource = NullInputSource()
+do {
+    if let directory = options.videoDirectory {
+        fileVideo = try PPMVideoSink(directory: URL(fileURLWithPath: directory, isDirectory: true),
+                                     interval: options.videoInterval)
+    }
+    if let path = options.audioPath {
+        wavAudio = try WAVAudioSink(url: URL(fileURLWithPath: path))
+    }
+    if let path = options.inputPath {
+        input = try ScriptedInputSource(url: URL(fileURLWithPath: path))
+    }
+} catch {
+    fail("\(error.localizedDescription)")
+}
+
+let video: VideoSink = fileVideo ?? nullVideo
+let audio: AudioSink = wavAudio ?? nullAudio
+let bridge = LibretroBridge(systemDirectory: options.systemDirectory, saveDirectory: options.saveDirectory)
+let session = EmulationSession(bridge: bridge, video: video, audio: audio, input: input)
+
+do {
+    try session.load(corePath: options.corePath!, game: URL(fileURLWithPath: options.romPath!))
+} catch {
+    fail("\(error.localizedDescription)")
+}
+
+if options.rewind {
+    session.rewind = RewindManager()
+}
+
+var watchdog: HangWatchdog?
+if options.watchdog {
+    let frameState = FrameStateStore()
+    session.frameState = frameState
+    let fps = bridge.avInfo?.fps ?? 60
+    let hangWatchdog = HangWatchdog(frameState: frameState, configuration: .init(frameBudget: 1.0 / fps))
+    hangWatchdog.onHang = { report in
+        FileHandle.standardError.write(Data(report.text.utf8))
+    }
+    hangWatchdog.start()
+    watchdog = hangWatchdog
+}
+
+let summary = session.run(frames: options.frames, pacing: options.pacing)
+watchdog?.stop()
+
+do {
+    try wavAudio?.close()
+} catch {
+    fail("Could not finish \(options.audioPath ?? "audio"): \(error.localizedDescription)")
+}
+
+// MARK: - Report
+
+if let info = bridge.systemInfo {
+    print("Core    \(info.libraryName) \(info.libraryVersion)")
+}
+if let av = bridge.avInfo {
+    let name = URL(fileURLWithPath: options.romPath!).lastPathComponent
+    print("Game    \(name) " + String(format: "(%dx%d, %.2f fps, %.0f Hz)", av.baseWidth, av.baseHeight, av.fps, av.sampleRate))
+    let realtime = summary.elapsed > 0 ? Double(summary.frames) / av.fps / summary.elapsed : 0
+    print(String(format: "Frames  %d in %.2f s (%.1f fps, %.2fx realtime)",
+                 summary.frames, summary.elapsed, summary.framesPerSecond, realtime))
+}
+print("Frame   median \(milliseconds(summary.frameTime(atPercentile: 0.5)))"
+      + "  p99 \(milliseconds(summary.frameTime(atPercentile: 0.99)))"
+      + "  max \(milliseconds(summary.frameTime(atPercentile: 1)))")
+if let fileVideo {
+    print("Video   \(fileVideo.frames) frames, \(fileVideo.written) written to \(fileVideo.directory.path)")
+} else {
+    print("Video   \(nullVideo.frames) frames (last \(nullVideo.lastSize.width)x\(nullVideo.lastSize.height))")
+}
+if let wavAudio {
+    print("Audio   \(wavAudio.samples) samples written to \(wavAudio.url.path)")
+} else {
+    print("Audio   \(nullAudio.samples) samples")
+}
+if let rewind = session.rewind {
+    let memory = rewind.memoryInfo
+    print(String(format: "Rewind  %d states, %.1f MB", memory.stateCount, memory.usedMB))
+}
+
+session.bridge.unloadCore()
@@ -1,12 +1,13 @@
 //
 //  AudioEngine.swift
-//  YearnCore
+//  YearnPresentation
 //
 //  Audio output management using AVAudioEngine
 //
 
 import Foundation
 import AVFoundation
+import YearnCore
 
 /// Manages audio output for emulation
 public final class AudioEngine {
@@ -50,7 +51,7 @@ public final class AudioEngine {
             channels: AVAudioChannelCount(format.channels),
             interleaved: format.interleaved
         ) else {
-            print("Failed to create AVAudioFormat")
+            Log.audio.error("Failed to create AVAudioFormat")
             return
         }
         
@@ -72,7 +73,7 @@ public final class AudioEngine {
             playerNode?.play()
             isRunning = true
         } catch {
-            print("Failed to start audio engine: \(error)")
+            Log.audio.error("Failed to start audio engine: \(error)")
         }
     }
     
@@ -133,7 +134,7 @@ public final class AudioEngine {
             try session.setCategory(.playback, mode: .default)
             try session.setActive(true)
         } catch {
-            print("Failed to setup audio session: \(error)")
+            Log.audio.error("Failed to setup audio session: \(error)")
         }
         #endif
         
@@ -170,22 +171,13 @@ public final class AudioEngine {
     }
 }
 
-// MARK: - Audio Format
+// MARK: - AudioSink
 
-/// Audio format specification
-public struct AudioFormat: Sendable {
-    public let sampleRate: Double
-    public let channels: Int
-    public let bitsPerSample: Int
-    public let interleaved: Bool
-    
-    public init(sampleRate: Double, channels: Int, bitsPerSample: Int = 16, interleaved: Bool = true) {
-        self.sampleRate = sampleRate
-        self.channels = channels
-        self.bitsPerSample = bitsPerSample
-        self.interleaved = interleaved
-    }
-    
+extension AudioEngine: AudioSink {}
+
+// MARK: - AVFoundation Bridging
+
+extension AudioFormat {
     var commonFormat: AVAudioCommonFormat {
         switch bitsPerSample {
         case 16:
@@ -196,12 +188,18 @@ public struct AudioFormat: Sendable {
             return .pcmFormatFloat32
         }
     }
-    
-    /// Common audio formats for different systems
-    public static let nes = AudioFormat(sampleRate: 44100, channels: 1)
-    public static let snes = AudioFormat(sampleRate: 32000, channels: 2)
-    public static let gba = AudioFormat(sampleRate: 32768, channels: 2)
-    public static let n64 = AudioFormat(sampleRate: 44100, channels: 2)
-    public static let ps1 = AudioFormat(sampleRate: 44100, channels: 2)
 }
 
+extension AudioRingBuffer {
+    /// Read samples into an AVAudioPCMBuffer
+    public func read(into pcmBuffer: AVAudioPCMBuffer) -> Int {
+        guard let channelData = pcmBuffer.int16ChannelData else {
+            return 0
+        }
+        return readFrames(
+            Int(pcmBuffer.frameCapacity),
+            channels: Int(pcmBuffer.format.channelCount),
+            into: channelData
+        )
+    }
+}
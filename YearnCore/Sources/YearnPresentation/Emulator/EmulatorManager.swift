@@ -1,12 +1,13 @@
 //
 //  EmulatorManager.swift
-//  YearnCore
+//  YearnPresentation
 //
 //  Main emulator management class
 //
 
 import Foundation
 import Combine
+import YearnCore
 
 /// Manages emulation lifecycle and coordinates all subsystems
 @MainActor
@@ -1,6 +1,6 @@
 //
 //  InputManager.swift
-//  YearnCore
+//  YearnPresentation
 //
 //  Input management for emulation with enhanced controller support
 //
@@ -8,6 +8,7 @@
 import Foundation
 import GameController
 import CoreHaptics
+import YearnCore
 
 /// Manages input from virtual controllers and physical gamepads
 public final class InputManager: ObservableObject {
@@ -451,7 +452,7 @@ public final class InputManager: ObservableObject {
                 hapticEngines[controller] = engine
             }
         } catch {
-            print("Failed to setup haptic engine: \(error)")
+            Log.input.error("Failed to setup haptic engine: \(error)")
         }
     }
     
@@ -488,7 +489,7 @@ public final class InputManager: ObservableObject {
             let player = try engine.makePlayer(with: pattern)
             try player.start(atTime: CHHapticTimeImmediate)
         } catch {
-            print("Failed to play haptic: \(error)")
+            Log.input.error("Failed to play haptic: \(error)")
         }
     }
     
@@ -606,246 +607,14 @@ public enum RumbleType {
     }
 }
 
-// MARK: - Custom Button Mapping
+// MARK: - InputSource
 
-public struct CustomButtonMapping: Codable, Equatable {
-    public var dpadUp: Int
-    public var dpadDown: Int
-    public var dpadLeft: Int
-    public var dpadRight: Int
-    public var buttonA: Int
-    public var buttonB: Int
-    public var buttonX: Int?
-    public var buttonY: Int?
-    public var leftShoulder: Int?
-    public var rightShoulder: Int?
-    public var leftTrigger: Int?
-    public var rightTrigger: Int?
-    public var leftThumbstickButton: Int?
-    public var rightThumbstickButton: Int?
-    public var start: Int
-    public var select: Int
-    public var cButtons: CButtons?
-    
-    public struct CButtons: Codable, Equatable {
-        public var up: Int
-        public var down: Int
-        public var left: Int
-        public var right: Int
-        
-        public init(up: Int, down: Int, left: Int, right: Int) {
-            self.up = up
-            self.down = down
-            self.left = left
-            self.right = right
-        }
-    }
-    
-    public init(
-        dpadUp: Int,
-        dpadDown: Int,
-        dpadLeft: Int,
-        dpadRight: Int,
-        buttonA: Int,
-        buttonB: Int,
-        buttonX: Int? = nil,
-        buttonY: Int? = nil,
-        leftShoulder: Int? = nil,
-        rightShoulder: Int? = nil,
-        leftTrigger: Int? = nil,
-        rightTrigger: Int? = nil,
-        leftThumbstickButton: Int? = nil,
-        rightThumbstickButton: Int? = nil,
-        start: Int,
-        select: Int,
-        cButtons: CButtons? = nil
-    ) {
-        self.dpadUp = dpadUp
-        self.dpadDown = dpadDown
-        self.dpadLeft = dpadLeft
-        self.dpadRight = dpadRight
-        self.buttonA = buttonA
-        self.buttonB = buttonB
-        self.buttonX = buttonX
-        self.buttonY = buttonY
-        self.leftShoulder = leftShoulder
-        self.rightShoulder = rightShoulder
-        self.leftTrigger = leftTrigger
-        self.rightTrigger = rightTrigger
-        self.leftThumbstickButton = leftThumbstickButton
-        self.rightThumbstickButton = rightThumbstickButton
-        self.start = start
-        self.select = select
-        self.cButtons = cButtons
-    }
-    
-    /// Create default mapping from InputMapping
-    public static func `default`(for mapping: InputMapping) -> CustomButtonMapping {
-        return CustomButtonMapping(
-            dpadUp: mapping.up,
-            dpadDown: mapping.down,
-            dpadLeft: mapping.left,
-            dpadRight: mapping.right,
-            buttonA: mapping.a,
-            buttonB: mapping.b,
-            buttonX: mapping.x,
-            buttonY: mapping.y,
-            leftShoulder: mapping.l,
-            rightShoulder: mapping.r,
-            leftTrigger: mapping.l2,
-            rightTrigger: mapping.r2,
-            leftThumbstickButton: mapping.l3,
-            rightThumbstickButton: mapping.r3,
-            start: mapping.start,
-            select: mapping.select,
-            cButtons: mapping.cUp != nil ? CButtons(
-                up: mapping.cUp!,
-                down: mapping.cDown!,
-                left: mapping.cLeft!,
-                right: mapping.cRight!
-            ) : nil
-        )
+extension InputManager: InputSource {
+    
+    /// Controller handlers update the state as buttons change, so there is nothing to read here
+    public func poll(frame: Int) {}
+    
+    public func inputState(port: UInt32, device: UInt32, index: UInt32, id: UInt32) -> Int16 {
+        Self.joypadState(getInputBitmask(playerIndex: Int(port)), device: device, id: id)
     }
 }
-
-// MARK: - Input Mapping
-
-/// Input mapping for a specific system
-public struct InputMapping: Sendable {
-    public let up: Int
-    public let down: Int
-    public let left: Int
-    public let right: Int
-    public let a: Int
-    public let b: Int
-    public let x: Int?
-    public let y: Int?
-    public let l: Int?
-    public let r: Int?
-    public let l2: Int?
-    public let r2: Int?
-    public let l3: Int?
-    public let r3: Int?
-    public let start: Int
-    public let select: Int
-    public let maxPlayers: Int
-    
-    // N64 C-buttons / PS1 right stick
-    public let cUp: Int?
-    public let cDown: Int?
-    public let cLeft: Int?
-    public let cRight: Int?
-    
-    public init(
-        up: Int,
-        down: Int,
-        left: Int,
-        right: Int,
-        a: Int,
-        b: Int,
-        x: Int? = nil,
-        y: Int? = nil,
-        l: Int? = nil,
-        r: Int? = nil,
-        l2: Int? = nil,
-        r2: Int? = nil,
-        l3: Int? = nil,
-        r3: Int? = nil,
-        start: Int,
-        select: Int,
-        maxPlayers: Int = 2,
-        cUp: Int? = nil,
-        cDown: Int? = nil,
-        cLeft: Int? = nil,
-        cRight: Int? = nil
-    ) {
-        self.up = up
-        self.down = down
-        self.left = left
-        self.right = right
-        self.a = a
-        self.b = b
-        self.x = x
-        self.y = y
-        self.l = l
-        self.r = r
-        self.l2 = l2
-        self.r2 = r2
-        self.l3 = l3
-        self.r3 = r3
-        self.start = start
-        self.select = select
-        self.maxPlayers = maxPlayers
-        self.cUp = cUp
-        self.cDown = cDown
-        self.cLeft = cLeft
-        self.cRight = cRight
-    }
-    
-    // Standard mappings for common systems
-    public static let nes = InputMapping(
-        up: 4, down: 5, left: 6, right: 7,
-        a: 0, b: 1,
-        start: 3, select: 2
-    )
-    
-    public static let snes = InputMapping(
-        up: 4, down: 5, left: 6, right: 7,
-        a: 0, b: 1, x: 8, y: 9,
-        l: 10, r: 11,
-        start: 3, select: 2
-    )
-    
-    public static let gbc = InputMapping(
-        up: 4, down: 5, left: 6, right: 7,
-        a: 0, b: 1,
-        start: 3, select: 2,
-        maxPlayers: 1
-    )
-    
-    public static let gba = InputMapping(
-        up: 4, down: 5, left: 6, right: 7,
-        a: 0, b: 1,
-        l: 10, r: 11,
-        start: 3, select: 2,
-        maxPlayers: 1
-    )
-    
-    public static let n64 = InputMapping(
-        up: 4, down: 5, left: 6, right: 7,
-        a: 0, b: 1,
-        l: 10, r: 11,
-        start: 3, select: 2,
-        maxPlayers: 4,
-        cUp: 12, cDown: 13, cLeft: 14, cRight: 15
-    )
-    
-    public static let nds = InputMapping(
-        up: 4, down: 5, left: 6, right: 7,
-        a: 0, b: 1, x: 8, y: 9,
-        l: 10, r: 11,
-        start: 3, select: 2,
-        maxPlayers: 1
-    )
-    
-    public static let genesis = InputMapping(
-        up: 4, down: 5, left: 6, right: 7,
-        a: 0, b: 1, x: 8,  // Genesis has A, B, C (mapped to X)
-        y: 9,  // Genesis 6-button has X, Y, Z
-        start: 3, select: 2,  // Mode button
-        maxPlayers: 2
-    )
-    
-    public static let ps1 = InputMapping(
-        up: 4, down: 5, left: 6, right: 7,
-        a: 0,  // Cross
-        b: 1,  // Circle
-        x: 8,  // Square
-        y: 9,  // Triangle
-        l: 10, r: 11,  // L1, R1
-        l2: 12, r2: 13,  // L2, R2
-        l3: 14, r3: 15,  // L3, R3
-        start: 3, select: 2,
-        maxPlayers: 2
-    )
-}
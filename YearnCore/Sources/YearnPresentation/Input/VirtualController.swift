@@ -1,6 +1,6 @@
 //
 //  VirtualController.swift
-//  YearnCore
+//  YearnPresentation
 //
 //  Virtual controller UI component with haptic feedback
 //
@@ -10,6 +10,7 @@ import SwiftUI
 import UIKit
 #endif
 import CoreHaptics
+import YearnCore
 
 // MARK: - Virtual Controller View
 
@@ -406,12 +407,12 @@ class HapticManager: ObservableObject {
                     do {
                         try self?.engine?.start()
                     } catch {
-                        print("Failed to restart haptic engine: \(error)")
+                        Log.input.error("Failed to restart haptic engine: \(error)")
                     }
                 }
             }
         } catch {
-            print("Failed to create haptic engine: \(error)")
+            Log.input.error("Failed to create haptic engine: \(error)")
             supportsHaptics = false
         }
     }
@@ -466,7 +467,7 @@ class HapticManager: ObservableObject {
             let player = try engine.makePlayer(with: pattern)
             try player.start(atTime: 0)
         } catch {
-            print("Failed to play haptic: \(error)")
+            Log.input.error("Failed to play haptic: \(error)")
         }
     }
 }
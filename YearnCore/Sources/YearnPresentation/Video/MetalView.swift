@@ -1,6 +1,6 @@
 //
 //  MetalView.swift
-//  YearnCore
+//  YearnPresentation
 //
 //  SwiftUI wrapper for Metal rendering view
 //
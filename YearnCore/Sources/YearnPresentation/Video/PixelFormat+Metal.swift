@@ -0,0 +1,30 @@
+//
+//  PixelFormat+Metal.swift
+//  YearnPresentation
+//
+//  Texture formats for core pixel formats
+//
+
+import Metal
+import YearnCore
+
+extension PixelFormat {
+    public var metalPixelFormat: MTLPixelFormat {
+        switch self {
+        case .rgb565:
+            return .b5g6r5Unorm
+        case .rgba8888:
+            return .rgba8Unorm
+        case .bgra8888:
+            return .bgra8Unorm
+        case .xrgb8888:
+            return .bgra8Unorm
+        }
+    }
+}
+
+extension VideoFormat {
+    var metalPixelFormat: MTLPixelFormat {
+        return pixelFormat.metalPixelFormat
+    }
+}
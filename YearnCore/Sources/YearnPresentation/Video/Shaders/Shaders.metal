@@ -1,6 +1,6 @@
 //
 //  Shaders.metal
-//  YearnCore
+//  YearnPresentation
 //
 //  Metal shaders for video rendering
 //
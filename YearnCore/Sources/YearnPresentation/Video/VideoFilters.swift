@@ -1,6 +1,6 @@
 //
 //  VideoFilters.swift
-//  YearnCore
+//  YearnPresentation
 //
 //  Video filter shaders for retro effects
 //
@@ -1,6 +1,6 @@
 //
 //  VideoRenderer.swift
-//  YearnCore
+//  YearnPresentation
 //
 //  Metal-based video rendering
 //
@@ -9,6 +9,7 @@ import Foundation
 import Metal
 import MetalKit
 import simd
+import YearnCore
 
 /// Metal-based video renderer for emulator output
 public final class VideoRenderer: NSObject, ObservableObject {
@@ -144,7 +145,7 @@ public final class VideoRenderer: NSObject, ObservableObject {
         do {
             // pipelineState = try device.makeRenderPipelineState(descriptor: descriptor)
         } catch {
-            print("Failed to create pipeline state: \(error)")
+            Log.video.error("Failed to create pipeline state: \(error)")
         }
     }
     
@@ -193,6 +194,17 @@ extension VideoRenderer: MTKViewDelegate {
     }
 }
 
+// MARK: - VideoSink
+
+extension VideoRenderer: VideoSink {
+    
+    /// Uploads frames of the configured size; a core that changes geometry needs `configure` again
+    public func updateFrame(_ pixels: UnsafeRawPointer, width: Int, height: Int, pitch: Int, format: LibretroPixelFormat) {
+        guard width == videoFormat?.width, height == videoFormat?.height else { return }
+        updateFrame(pixels, bytesPerRow: pitch)
+    }
+}
+
 // MARK: - Supporting Types
 
 public enum AspectRatioMode {
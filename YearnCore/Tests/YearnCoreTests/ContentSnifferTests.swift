@@ -0,0 +1,323 @@
+//
+//  ContentSnifferTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+import CYearnSupport
+@testable import YearnCore
+
+/// Synthetic headers laid out the way each format does, in a zeroed block
+///
+/// Near misses (a header with one field broken) must fall back to a lower
+/// confidence or to nothing.
+final class ContentSnifferTests: XCTestCase {
+
+    // MARK: - Corpus
+
+    private struct Block {
+        var data = Data(count: Int(YEARN_SNIFF_BLOCK_SIZE))
+        var fileSize: UInt64
+
+        init(fileSize: UInt64) {
+            self.fileSize = fileSize
+        }
+
+        mutating func put(_ bytes: [UInt8], at offset: Int) {
+            data.replaceSubrange(offset..<(offset + bytes.count), with: bytes)
+        }
+
+        mutating func put(_ string: String, at offset: Int) {
+            put(Array(string.utf8), at: offset)
+        }
+    }
+
+    // Nintendo logo in Game Boy cartridge headers (0x104...0x133)
+    private static let gbLogo: [UInt8] = [
+        0xCE, 0xED, 0x66, 0x66, 0xCC, 0x0D, 0x00, 0x0B, 0x03, 0x73, 0x00, 0x83,
+        0x00, 0x0C, 0x00, 0x0D, 0x00, 0x08, 0x11, 0x1F, 0x88, 0x89, 0x00, 0x0E,
+        0xDC, 0xCC, 0x6E, 0xE6, 0xDD, 0xDD, 0xD9, 0x99, 0xBB, 0xBB, 0x67, 0x63,
+        0x6E, 0x0E, 0xEC, 0xCC, 0xDD, 0xDC, 0x99, 0x9F, 0xBB, 0xB9, 0x33, 0x3E,
+    ]
+
+    // The GBA / NDS logo; its CRC-16 is 0xCF56
+    private static let agbLogo: [UInt8] = [
+        0x24, 0xFF, 0xAE, 0x51, 0x69, 0x9A, 0xA2, 0x21, 0x3D, 0x84, 0x82, 0x0A, 0x84, 0xE4, 0x09, 0xAD,
+        0x11, 0x24, 0x8B, 0x98, 0xC0, 0x81, 0x7F, 0x21, 0xA3, 0x52, 0xBE, 0x19, 0x93, 0x09, 0xCE, 0x20,
+        0x10, 0x46, 0x4A, 0x4A, 0xF8, 0x27, 0x31, 0xEC, 0x58, 0xC7, 0xE8, 0x33, 0x82, 0xE3, 0xCE, 0xBF,
+        0x85, 0xF4, 0xDF, 0x94, 0xCE, 0x4B, 0x09, 0xC1, 0x94, 0x56, 0x8A, 0xC0, 0x13, 0x72, 0xA7, 0xFC,
+        0x9F, 0x84, 0x4D, 0x73, 0xA3, 0xCA, 0x9A, 0x61, 0x58, 0x97, 0xA3, 0x27, 0xFC, 0x03, 0x98, 0x76,
+        0x23, 0x1D, 0xC7, 0x61, 0x03, 0x04, 0xAE, 0x56, 0xBF, 0x38, 0x84, 0x00, 0x40, 0xA7, 0x0E, 0xFD,
+        0xFF, 0x52, 0xFE, 0x03, 0x6F, 0x95, 0x30, 0xF1, 0x97, 0xFB, 0xC0, 0x85, 0x60, 0xD6, 0x80, 0x25,
+        0xA9, 0x63, 0xBE, 0x03, 0x01, 0x4E, 0x38, 0xE2, 0xF9, 0xA2, 0x34, 0xFF, 0xBB, 0x3E, 0x03, 0x44,
+        0x78, 0x00, 0x90, 0xCB, 0x88, 0x11, 0x3A, 0x94, 0x65, 0xC0, 0x7C, 0x63, 0x87, 0xF0, 0x3C, 0xAF,
+        0xD6, 0x25, 0xE4, 0x8B, 0x38, 0x0A, 0xAC, 0x72, 0x21, 0xD4, 0xF8, 0x07,
+    ]
+
+    private static let cdSync: [UInt8] = [0x00] + [UInt8](repeating: 0xFF, count: 10) + [0x00]
+    private static let rawSector = 2352
+    private static let cookedSector = 2048
+    private static let pvdSector = 16
+
+    /// CRC-16/MODBUS, as NDS headers use
+    private static func crc16(_ bytes: Data) -> UInt16 {
+        var crc: UInt16 = 0xFFFF
+        for byte in bytes {
+            crc ^= UInt16(byte)
+            for _ in 0..<8 {
+                crc = crc & 1 != 0 ? (crc >> 1) ^ 0xA001 : crc >> 1
+            }
+        }
+        return crc
+    }
+
+    private func gba(logo: Bool) -> Block {
+        var block = Block(fileSize: 4 << 20)
+        if logo {
+            block.put(Self.agbLogo, at: 0x04)
+        }
+        block.put("YEARN TEST  AYTE01", at: 0xA0)
+        block.data[0xB2] = 0x96
+        var sum: UInt8 = 0
+        for i in 0xA0...0xBC {
+            sum = sum &- block.data[i]
+        }
+        block.data[0xBD] = sum &- 0x19
+        return block
+    }
+
+    private func gb(cgb: UInt8, goodChecksum: Bool = true) -> Block {
+        var block = Block(fileSize: 1 << 20)
+        block.put(Self.gbLogo, at: 0x104)
+        block.put("YEARNTEST", at: 0x134)
+        block.data[0x143] = cgb
+        block.data[0x147] = 0x1B        // MBC5+RAM+BATTERY
+        block.data[0x148] = 0x05
+        var sum: UInt8 = 0
+        for i in 0x134...0x14C {
+            sum = sum &- block.data[i] &- 1
+        }
+        block.data[0x14D] = goodChecksum ? sum : sum &+ 1
+        return block
+    }
+
+    private func nds(goodCRC: Bool) -> Block {
+        var block = Block(fileSize: 64 << 20)
+        block.put("YEARNTEST\0\0\0AYTE01", at: 0x00)
+        block.put(Self.agbLogo, at: 0xC0)
+        block.put([0x56, 0xCF], at: 0x15C)
+        var crc = Self.crc16(block.data.prefix(0x15E))
+        if !goodCRC {
+            crc ^= 0x1234
+        }
+        block.put([UInt8(crc & 0xFF), UInt8(crc >> 8)], at: 0x15E)
+        return block
+    }
+
+    private func snes(at offset: Int, map: UInt8, goodSums: Bool = true, fileSize: UInt64) -> Block {
+        var block = Block(fileSize: fileSize)
+        block.put("YEARN TEST CART      ", at: offset)
+        block.data[offset + 0x15] = map
+        block.data[offset + 0x17] = 0x0A
+        let checksum: UInt16 = 0x5A3C
+        let complement: UInt16 = goodSums ? ~checksum : 0x1111
+        block.put([UInt8(complement & 0xFF), UInt8(complement >> 8),
+                   UInt8(checksum & 0xFF), UInt8(checksum >> 8)], at: offset + 0x1C)
+        block.put([0x00, 0x80], at: offset + 0x3C)
+        return block
+    }
+
+    private func iso(system: String, raw: Bool) -> Block {
+        let sector = raw ? Self.rawSector : Self.cookedSector
+        var block = Block(fileSize: UInt64(sector) * 300_000)
+        var descriptor = Self.pvdSector * sector
+        if raw {
+            for s in 0...Self.pvdSector {
+                block.put(Self.cdSync, at: s * sector)
+                block.data[s * sector + 15] = 2
+            }
+            descriptor += 24
+        }
+        block.put([0x01] + Array("CD001".utf8) + [0x01], at: descriptor)
+        block.put(system.padding(toLength: 32, withPad: " ", startingAt: 0), at: descriptor + 8)
+        return block
+    }
+
+    private func assertBest(_ block: Block, is format: SniffedFormat?, confidence range: ClosedRange<Float>,
+                            file: StaticString = #filePath, line: UInt = #line) {
+        let best = ContentSniffer.sniff(data: block.data, fileSize: block.fileSize).first
+        XCTAssert(best?.format == format && range.contains(best?.confidence ?? 0),
+                  "best candidate \(String(describing: best))", file: file, line: line)
+    }
+
+    // MARK: - Cartridges
+
+    func testINES() {
+        var block = Block(fileSize: 16 + 0x8000 + 0x2000)
+        block.put([0x4E, 0x45, 0x53, 0x1A, 0x02, 0x01], at: 0)
+        assertBest(block, is: .nes, confidence: 0.9...1)
+    }
+
+    func testFDSDiskSide() {
+        var block = Block(fileSize: 65_500 * 2)
+        block.put([0x01] + Array("*NINTENDO-HVC*".utf8), at: 0)
+        assertBest(block, is: .fds, confidence: 0.9...1)
+    }
+
+    func testN64BigEndian() {
+        var block = Block(fileSize: 8 << 20)
+        block.put([0x80, 0x37, 0x12, 0x40, 0x00, 0x00, 0x00, 0x0F], at: 0)
+        assertBest(block, is: .n64, confidence: 0.9...1)
+    }
+
+    func testN64ByteSwapped() {
+        var block = Block(fileSize: 8 << 20)
+        block.put([0x37, 0x80, 0x40, 0x12, 0x00, 0x00, 0x0F, 0x00], at: 0)
+        assertBest(block, is: .n64, confidence: 0.9...1)
+    }
+
+    func testN64LittleEndian() {
+        var block = Block(fileSize: 8 << 20)
+        block.put([0x40, 0x12, 0x37, 0x80, 0x0F, 0x00, 0x00, 0x00], at: 0)
+        assertBest(block, is: .n64, confidence: 0.9...1)
+    }
+
+    func testGBA() {
+        assertBest(gba(logo: true), is: .gba, confidence: 0.95...1)
+    }
+
+    func testGBAWithoutLogo() {
+        assertBest(gba(logo: false), is: .gba, confidence: 0.4...0.6)
+    }
+
+    func testGB() {
+        assertBest(gb(cgb: 0x00), is: .gb, confidence: 0.95...1)
+    }
+
+    func testGBCDualMode() {
+        assertBest(gb(cgb: 0x80), is: .gbc, confidence: 0.95...1)
+    }
+
+    func testGBCOnly() {
+        assertBest(gb(cgb: 0xC0), is: .gbc, confidence: 0.95...1)
+    }
+
+    func testGBBadChecksum() {
+        assertBest(gb(cgb: 0x00, goodChecksum: false), is: .gb, confidence: 0.6...0.8)
+    }
+
+    func testNDS() {
+        assertBest(nds(goodCRC: true), is: .nds, confidence: 0.95...1)
+    }
+
+    func testNDSBadHeaderCRC() {
+        assertBest(nds(goodCRC: false), is: .nds, confidence: 0.8...0.9)
+    }
+
+    func testGenesis() {
+        var block = Block(fileSize: 512 << 10)
+        block.put("SEGA MEGA DRIVE (C)SEGA 1991.AP", at: 0x100)
+        assertBest(block, is: .genesis, confidence: 0.9...1)
+    }
+
+    func testGenesisBareSEGA() {
+        var block = Block(fileSize: 512 << 10)
+        block.put("SEGA    ", at: 0x100)
+        assertBest(block, is: .genesis, confidence: 0.7...0.85)
+    }
+
+    func testGenesisSMD() {
+        var block = Block(fileSize: 0x200 + 512 * 1024)
+        block.put([0x20, 0x03], at: 0)
+        block.put([0xAA, 0xBB], at: 8)
+        // Odd bytes go to the first half of the interleaved block, even bytes to the second
+        for (i, byte) in "SEGA GENESIS    ".utf8.enumerated() {
+            let offset = 0x100 + i
+            block.data[0x200 + (offset & 1 != 0 ? 0 : 0x2000) + offset / 2] = byte
+        }
+        assertBest(block, is: .genesis, confidence: 0.8...0.9)
+    }
+
+    func testSNESLoROM() {
+        assertBest(snes(at: 0x7FC0, map: 0x20, fileSize: 1 << 20), is: .snes, confidence: 0.9...1)
+    }
+
+    func testSNESHiROM() {
+        assertBest(snes(at: 0xFFC0, map: 0x21, fileSize: 4 << 20), is: .snes, confidence: 0.9...1)
+    }
+
+    func testSNESCopierHeader() {
+        assertBest(snes(at: 0x200 + 0xFFC0, map: 0x31, fileSize: (2 << 20) + 512), is: .snes, confidence: 0.9...1)
+    }
+
+    func testSNESBadChecksum() {
+        assertBest(snes(at: 0x7FC0, map: 0x20, goodSums: false, fileSize: 1 << 20), is: .snes, confidence: 0.4...0.7)
+    }
+
+    // MARK: - Discs
+
+    func testPS1RawMode2() {
+        assertBest(iso(system: "PLAYSTATION", raw: true), is: .ps1, confidence: 0.95...1)
+    }
+
+    func testPS1CookedISO() {
+        assertBest(iso(system: "PLAYSTATION", raw: false), is: .ps1, confidence: 0.95...1)
+    }
+
+    func testPCISO9660() {
+        assertBest(iso(system: "LINUX", raw: false), is: .iso9660, confidence: 0.4...0.6)
+    }
+
+    func testRawCDWithoutVolumeDescriptor() {
+        var block = Block(fileSize: UInt64(Self.rawSector) * 1000)
+        block.put(Self.cdSync, at: 0)
+        assertBest(block, is: .ps1, confidence: 0.2...0.4)
+    }
+
+    // MARK: - Not ROMs
+
+    func testNoiseHasNoCandidates() {
+        var block = Block(fileSize: UInt64(YEARN_SNIFF_BLOCK_SIZE))
+        var x: UInt32 = 0x1234_5678
+        for i in block.data.indices {
+            x ^= x << 13
+            x ^= x >> 17
+            x ^= x << 5
+            block.data[i] = UInt8(truncatingIfNeeded: x)
+        }
+        assertBest(block, is: nil, confidence: 0...0)
+    }
+
+    func testTextHasNoCandidates() {
+        var block = Block(fileSize: UInt64(YEARN_SNIFF_BLOCK_SIZE))
+        let text = Array("Lorem ipsum dolor sit amet\n".utf8)
+        for i in block.data.indices {
+            block.data[i] = text[i % text.count]
+        }
+        assertBest(block, is: nil, confidence: 0...0)
+    }
+
+    func testUnrecognisedDataHasNoCandidates() {
+        XCTAssertTrue(ContentSniffer.sniff(data: Data(count: 4096)).isEmpty)
+    }
+
+    // MARK: - Files
+
+    func testFileAndBufferAgree() throws {
+        var rom = Data("NES\u{1A}".utf8) + Data([0x02, 0x01])
+        rom += Data(count: 16 + 0x8000 + 0x2000 - rom.count)
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("ContentSnifferTests-\(UUID().uuidString).bin")
+        defer { try? FileManager.default.removeItem(at: url) }
+        try rom.write(to: url)
+
+        let sniffed = try XCTUnwrap(ContentSniffer.sniff(fileAt: url))
+        XCTAssertEqual(sniffed.fileSize, UInt64(rom.count))
+        XCTAssertEqual(sniffed.results.first?.format, .nes)
+        XCTAssertEqual(sniffed.results, ContentSniffer.sniff(data: rom))
+    }
+
+    func testMissingFileIsNil() {
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("ContentSnifferTests-missing-\(UUID().uuidString)")
+        XCTAssertNil(ContentSniffer.sniff(fileAt: url))
+    }
+}
@@ -0,0 +1,65 @@
+//
+//  DATIndexTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+@testable import YearnCore
+
+final class DATIndexTests: XCTestCase {
+
+    private var directory: URL!
+
+    override func setUpWithError() throws {
+        directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("DATIndexTests-\(UUID().uuidString)", isDirectory: true)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDownWithError() throws {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    private func buildIndex() throws -> URL {
+        let dat = directory.appendingPathComponent("test.dat")
+        try """
+        <?xml version="1.0"?>
+        <datafile>
+          <game name="Example Game (USA)">
+            <rom name="Example Game (USA).nes" size="40960" crc="1234abcd"/>
+          </game>
+        </datafile>
+        """.write(to: dat, atomically: true, encoding: .utf8)
+
+        let indexURL = directory.appendingPathComponent("index.ydat")
+        XCTAssertEqual(try DATIndex.build(from: [dat], to: indexURL, fingerprint: 42), 1)
+        return indexURL
+    }
+
+    func testLookupFindsBuiltEntry() throws {
+        let index = try DATIndex(contentsOf: buildIndex())
+        XCTAssertEqual(index.fingerprint, 42)
+
+        let match = index.lookup(crc32: 0x1234_ABCD, size: 40_960)
+        XCTAssertEqual(match?.title, "Example Game (USA)")
+        XCTAssertEqual(match?.region, "USA")
+        XCTAssertNil(index.lookup(crc32: 0x1234_ABCD, size: 1))
+        XCTAssertNil(index.lookup(crc32: 0))
+    }
+
+    func testStringOffsetPastStringsSectionIsIgnored() throws {
+        let indexURL = try buildIndex()
+        var data = try Data(contentsOf: indexURL)
+        let stringsLength = data.withUnsafeBytes { UInt32(littleEndian: $0.loadUnaligned(fromByteOffset: 16, as: UInt32.self)) }
+
+        // Point the title just past the strings section, at bytes appended after it
+        data.append(contentsOf: Array("Outside\0".utf8))
+        withUnsafeBytes(of: stringsLength.littleEndian) { bytes in
+            data.replaceSubrange((DATIndex.headerSize + 4)..<(DATIndex.headerSize + 8), with: bytes)
+        }
+        try data.write(to: indexURL)
+
+        let match = try DATIndex(contentsOf: indexURL).lookup(crc32: 0x1234_ABCD)
+        XCTAssertEqual(match?.title, "")
+    }
+}
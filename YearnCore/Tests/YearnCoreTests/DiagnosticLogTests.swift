@@ -0,0 +1,142 @@
+//
+//  DiagnosticLogTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+import CYearnSupport
+@testable import YearnCore
+
+final class DiagnosticLogTests: XCTestCase {
+
+    private static let writers = 3
+    private static let messagesPerWriter = 20_000
+
+    /// `count` messages "m0", "m1", ... in a log of `capacity`
+    private func log(capacity: Int, messages count: Int) -> DiagnosticLog {
+        let log = DiagnosticLog(capacity: capacity)
+        for index in 0..<count {
+            log.record(index.isMultiple(of: 2) ? .info : .warning, category: "test", "m\(index)")
+        }
+        return log
+    }
+
+    /// Level, category and message all derive from the writer and n, so a
+    /// torn entry breaks the relation
+    private static func isWhole(_ entry: DiagnosticLog.Entry) -> Bool {
+        let parts = entry.message.split(separator: ":")
+        guard parts.count == 2, let writer = UInt32(parts[0]), Int(parts[1]) != nil else { return false }
+        return entry.level.rawValue == writer && entry.category == "writer\(writer)"
+    }
+
+    /// Record from several threads while this one takes snapshots
+    /// - Returns: The log, and the first snapshot holding a torn or out-of-order entry
+    private func writeAndSnapshotConcurrently() -> (log: DiagnosticLog, badSnapshot: [DiagnosticLog.Entry]?) {
+        let log = DiagnosticLog(capacity: 128)
+        let group = DispatchGroup()
+        for writer in 1...Self.writers {
+            DispatchQueue.global().async(group: group) {
+                let level = DiagnosticLog.Level(rawValue: UInt32(writer))!
+                for n in 0..<Self.messagesPerWriter {
+                    log.record(level, category: "writer\(writer)", "\(writer):\(n)")
+                }
+            }
+        }
+
+        var badSnapshot: [DiagnosticLog.Entry]?
+        var finished = false
+        repeat {
+            // Checked before the snapshot, so the last one sees every write
+            finished = group.wait(timeout: .now()) == .success
+            let entries = log.entries(limit: 128)
+            let ordered = zip(entries, entries.dropFirst()).allSatisfy { $0.ticket < $1.ticket }
+            guard entries.allSatisfy(Self.isWhole), ordered else {
+                badSnapshot = entries
+                break
+            }
+        } while !finished
+        group.wait()
+        return (log, badSnapshot)
+    }
+
+    // MARK: - Ring
+
+    func testNewLogIsEmpty() {
+        XCTAssertEqual(DiagnosticLog(capacity: 8).entries().count, 0)
+    }
+
+    func testEntriesAreOldestFirst() {
+        XCTAssertEqual(log(capacity: 8, messages: 2).entries().map(\.message), ["m0", "m1"])
+    }
+
+    func testWrappedRingKeepsTheNewest() {
+        XCTAssertEqual(log(capacity: 8, messages: 12).entries().map(\.message), (4..<12).map { "m\($0)" })
+    }
+
+    func testCapacityIsRoundedUpToAPowerOfTwo() {
+        XCTAssertEqual(log(capacity: 100, messages: 300).entries().count, 128)
+    }
+
+    func testLimitTakesTheNewest() {
+        XCTAssertEqual(log(capacity: 8, messages: 12).entries(limit: 3).map(\.message), ["m9", "m10", "m11"])
+    }
+
+    func testTicketsCountEverythingRecorded() {
+        XCTAssertEqual(log(capacity: 8, messages: 12).entries().last?.ticket, 11)
+    }
+
+    func testLevelIsKept() {
+        XCTAssertEqual(log(capacity: 8, messages: 2).entries().last?.level, .warning)
+    }
+
+    func testCategoryIsKept() {
+        XCTAssertEqual(log(capacity: 8, messages: 2).entries().last?.category, "test")
+    }
+
+    func testSingleWriterDropsNothing() {
+        XCTAssertEqual(log(capacity: 8, messages: 300).dropped, 0)
+    }
+
+    func testLongMessagesAreCut() {
+        let log = DiagnosticLog(capacity: 4)
+        log.record(.error, category: "test", String(repeating: "x", count: 1000))
+        XCTAssertEqual(log.entries().first?.message.utf8.count, 223)
+    }
+
+    func testLongCategoriesAreCut() {
+        let log = DiagnosticLog(capacity: 4)
+        log.record(.info, category: "a-very-long-category-name", "message")
+        XCTAssertEqual(log.entries().first?.category, "a-very-long-cat")
+    }
+
+    // MARK: - Concurrency
+
+    func testConcurrentSnapshotsNeverHoldTornEntries() {
+        XCTAssertNil(writeAndSnapshotConcurrently().badSnapshot)
+    }
+
+    /// Every slot ends up holding a message unless a writer dropped one there
+    func testConcurrentWritersFillOrDropEverySlot() {
+        let log = writeAndSnapshotConcurrently().log
+        XCTAssertGreaterThanOrEqual(UInt64(log.entries(limit: 128).count) + log.dropped, 128)
+    }
+
+    // MARK: - Core Messages
+
+    func testCoreLogInterfaceIsProvided() {
+        let log = DiagnosticLog(capacity: 4)
+        var callback = retro_log_callback()
+        XCTAssertTrue(log.provideCoreLogInterface(&callback))
+    }
+
+    func testCoreLogInterfaceSetsCallback() {
+        let log = DiagnosticLog(capacity: 4)
+        var callback = retro_log_callback()
+        _ = log.provideCoreLogInterface(&callback)
+        XCTAssertNotNil(callback.log)
+    }
+
+    func testCoreLogInterfaceNeedsSomewhereToWrite() {
+        XCTAssertFalse(DiagnosticLog(capacity: 4).provideCoreLogInterface(nil))
+    }
+}
@@ -0,0 +1,121 @@
+//
+//  FrameStateStoreTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+@testable import YearnCore
+
+final class FrameStateStoreTests: XCTestCase {
+
+    private static let frames: UInt64 = 200_000
+
+    /// Every field of frame n derives from n, so a torn read breaks the relation
+    private static func isWhole(_ sample: FrameStateStore.Sample) -> Bool {
+        let n = Double(sample.frames)
+        return sample.timestamp == n * 2 && sample.frameTime == n * 3 && sample.fps == n * 4
+    }
+
+    /// Publish `frames` frames from one thread while two more set alternate
+    /// buttons, reading on this thread until the last frame shows up
+    /// - Returns: The store, and the first read that was torn or went backwards
+    private func publishAndReadConcurrently() -> (store: FrameStateStore, badRead: FrameStateStore.Sample?) {
+        let store = FrameStateStore()
+        let group = DispatchGroup()
+        DispatchQueue.global().async(group: group) {
+            for n in 1...Self.frames {
+                let value = Double(n)
+                store.publish(frames: n, timestamp: value * 2, frameTime: value * 3, fps: value * 4)
+            }
+        }
+        for first in 0..<2 {
+            DispatchQueue.global().async(group: group) {
+                // The last round leaves held only buttons with bit 1 clear in button % 4
+                for round in 0..<10_000 {
+                    for button in stride(from: first, to: 64, by: 2) {
+                        store.setInput(button, pressed: round % 2 == 0 || button % 4 < 2)
+                    }
+                }
+            }
+        }
+
+        var last: UInt64 = 0
+        var badRead: FrameStateStore.Sample?
+        while last < Self.frames {
+            let sample = store.sample
+            guard Self.isWhole(sample), sample.frames >= last else {
+                badRead = sample
+                break
+            }
+            last = sample.frames
+        }
+        group.wait()
+        return (store, badRead)
+    }
+
+    // MARK: - Initial State
+
+    func testNewStoreHasNoFrames() {
+        XCTAssertEqual(FrameStateStore().sample.frames, 0)
+    }
+
+    func testNewStoreHasNoInputsHeld() {
+        XCTAssertEqual(FrameStateStore().sample.inputs, 0)
+    }
+
+    // MARK: - Concurrency
+
+    func testConcurrentReadsAreNeverTornOrStale() {
+        XCTAssertNil(publishAndReadConcurrently().badRead)
+    }
+
+    func testConcurrentInputChangesAreAllKept() {
+        XCTAssertEqual(publishAndReadConcurrently().store.sample.inputs, 0x3333_3333_3333_3333)
+    }
+
+    func testLastPublishedFrameIsRead() {
+        XCTAssertEqual(publishAndReadConcurrently().store.sample.frames, Self.frames)
+    }
+
+    // MARK: - Inputs
+
+    func testInputsSurvivePublishing() {
+        let store = FrameStateStore()
+        store.setInput(3, pressed: true)
+        store.publish(frames: 1, timestamp: 1, frameTime: 0.016, fps: 60)
+        XCTAssertTrue(store.sample.isPressed(3))
+    }
+
+    func testReleasingOneButtonKeepsTheOthers() {
+        let store = FrameStateStore()
+        store.setInput(0, pressed: true)
+        store.setInput(1, pressed: true)
+        store.setInput(0, pressed: false)
+        XCTAssertEqual(store.sample.inputs, 0b10)
+    }
+
+    func testOutOfRangeButtonIsIgnored() {
+        let store = FrameStateStore()
+        store.setInput(64, pressed: true)
+        store.setInput(-1, pressed: true)
+        XCTAssertEqual(store.sample.inputs, 0)
+    }
+
+    func testSampleReflectsLastPublishAndHeldInputs() {
+        let store = FrameStateStore()
+        store.publish(frames: 1, timestamp: 10, frameTime: 0.016, fps: 59.9)
+        store.publish(frames: 2, timestamp: 10.016, frameTime: 0.017, fps: 60)
+        store.setInput(3, pressed: true)
+        store.setInput(8, pressed: true)
+        store.setInput(8, pressed: false)
+        store.setInput(64, pressed: true)
+
+        let sample = store.sample
+        XCTAssertEqual(sample.frames, 2)
+        XCTAssertEqual(sample.frameTime, 0.017)
+        XCTAssertEqual(sample.fps, 60)
+        XCTAssertTrue(sample.isPressed(3))
+        XCTAssertFalse(sample.isPressed(8))
+        XCTAssertFalse(sample.isPressed(64))
+    }
+}
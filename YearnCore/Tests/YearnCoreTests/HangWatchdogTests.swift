@@ -0,0 +1,225 @@
+//
+//  HangWatchdogTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+import CYearnSupport
+@testable import YearnCore
+
+final class HangWatchdogTests: XCTestCase {
+
+    /// Spins on its own thread until `stop` sees a frame, standing in for a
+    /// core stuck inside retro_run
+    private final class Spinner: @unchecked Sendable {
+        let stop = FrameStateStore()
+        private let ready = DispatchSemaphore(value: 0)
+        private(set) var thread: OpaquePointer?
+        /// A return address inside `spin`; the loop the thread is caught in is close by
+        private(set) var insideSpin: UInt = 0
+
+        func start() {
+            Thread { self.spin() }.start()
+            ready.wait()
+        }
+
+        func finish() {
+            stop.publish(frames: 1, timestamp: 0, frameTime: 0, fps: 0)
+        }
+
+        @inline(never)
+        private func spin() {
+            thread = yearn_thread_current()
+            if let thread = thread {
+                // Our own chain starts at the return address into this function
+                _ = yearn_thread_backtrace(thread, &insideSpin, 1)
+            }
+            ready.signal()
+            while stop.sample.frames == 0 {}
+        }
+
+        deinit {
+            yearn_thread_release(thread)
+        }
+    }
+
+    /// Generous: the loop sits right after the call that found `insideSpin`
+    private static let spinSpan: UInt = 2048
+
+    /// Capture the spinner 20 times, and return the first capture that
+    /// misses `spin` (or an empty one if capturing failed)
+    private func firstCaptureMissingSpin() -> [UInt]? {
+        let spinner = Spinner()
+        spinner.start()
+        defer { spinner.finish() }
+        guard let thread = spinner.thread else { return [] }
+
+        let low = spinner.insideSpin - min(spinner.insideSpin, Self.spinSpan)
+        let high = spinner.insideSpin + Self.spinSpan
+        for _ in 0..<20 {
+            var frames = [UInt](repeating: 0, count: 64)
+            let count = Int(yearn_thread_backtrace(thread, &frames, Int32(frames.count)))
+            let captured = Array(frames.prefix(max(count, 0)))
+            // The thread may be inside the frame state read the loop calls
+            guard captured.contains(where: { low..<high ~= $0 }) else { return captured }
+        }
+        return nil
+    }
+
+    /// Frame n takes 3n seconds, so recent times step by 3 unless a read is torn
+    private func publishAndReadRecentConcurrently() -> [TimeInterval]? {
+        let store = FrameStateStore()
+        let frames: UInt64 = 100_000
+        let group = DispatchGroup()
+        DispatchQueue.global().async(group: group) {
+            for n in 1...frames {
+                store.publish(frames: n, timestamp: Double(n), frameTime: Double(n) * 3, fps: 60)
+            }
+        }
+
+        var badRead: [TimeInterval]?
+        var finished = false
+        repeat {
+            finished = group.wait(timeout: .now()) == .success
+            let times = store.recentFrameTimes()
+            guard zip(times, times.dropFirst()).allSatisfy({ $1 == $0 + 3 }) else {
+                badRead = times
+                break
+            }
+        } while !finished
+        group.wait()
+        return badRead
+    }
+
+    /// `count` frames, frame n taking n milliseconds, after a begun frame
+    private func frameState(publishing count: Int) -> FrameStateStore {
+        let frameState = FrameStateStore()
+        frameState.beginFrame(at: 5)
+        for frame in 0..<count {
+            frameState.publish(frames: UInt64(frame + 1), timestamp: Double(frame), frameTime: Double(frame) / 1000, fps: 60)
+        }
+        return frameState
+    }
+
+    // MARK: - Backtraces
+
+    func testOwnBacktraceHasFrames() {
+        let thread = yearn_thread_current()
+        defer { yearn_thread_release(thread) }
+        var frames = [UInt](repeating: 0, count: 64)
+        XCTAssertGreaterThan(yearn_thread_backtrace(thread, &frames, Int32(frames.count)), 0)
+    }
+
+    func testBacktraceNeedsRoomForAFrame() {
+        let thread = yearn_thread_current()
+        defer { yearn_thread_release(thread) }
+        var frames = [UInt](repeating: 0, count: 1)
+        XCTAssertEqual(yearn_thread_backtrace(thread, &frames, 0), -1)
+    }
+
+    func testSpinningThreadIsCaughtInItsLoop() {
+        XCTAssertNil(firstCaptureMissingSpin())
+    }
+
+    func testLibraryAddressIsSymbolicated() {
+        var name = [CChar](repeating: 0, count: 256)
+        let function: @convention(c) (UInt, UnsafeMutablePointer<CChar>?, Int) -> Int32 = yearn_symbolicate
+        let address = unsafeBitCast(function, to: UInt.self)
+        XCTAssertEqual(yearn_symbolicate(address, &name, name.count), 0)
+    }
+
+    func testUnmappedAddressIsNotSymbolicated() {
+        var name = [CChar](repeating: 0, count: 256)
+        XCTAssertEqual(yearn_symbolicate(1, &name, name.count), -1)
+    }
+
+    // MARK: - Frame State
+
+    func testNewStoreIsNotInAFrame() {
+        XCTAssertNil(FrameStateStore().inFrameSince)
+    }
+
+    func testBegunFrameIsMarked() {
+        let store = FrameStateStore()
+        store.beginFrame(at: 5)
+        XCTAssertEqual(store.inFrameSince, 5)
+    }
+
+    func testPublishEndsTheFrame() {
+        XCTAssertNil(frameState(publishing: 1).inFrameSince)
+    }
+
+    func testNewStoreHasNoRecentFrameTimes() {
+        XCTAssertEqual(FrameStateStore().recentFrameTimes(), [])
+    }
+
+    func testRecentFrameTimesAreOldestFirst() {
+        XCTAssertEqual(frameState(publishing: 2).recentFrameTimes(), [0, 0.001])
+    }
+
+    func testRecentFrameTimesKeepTheNewest() {
+        let total = Int(YEARN_FRAME_RECENT) + 10
+        XCTAssertEqual(frameState(publishing: total).recentFrameTimes(), (10..<total).map { Double($0) / 1000 })
+    }
+
+    func testSaveStateIsItsOwnTiming() {
+        let store = frameState(publishing: 2)
+        store.record(.saveState, duration: 0.25)
+        XCTAssertEqual(store.recentTimings().last, FrameStateStore.Timing(work: .saveState, duration: 0.25))
+    }
+
+    func testSaveStateIsNotAFrameTime() {
+        let store = frameState(publishing: 2)
+        store.record(.saveState, duration: 0.25)
+        XCTAssertEqual(store.recentFrameTimes(), [0, 0.001])
+    }
+
+    func testReportMarksSaveStates() {
+        let report = HangWatchdog.Report(
+            detectedAt: Date(), stalledFor: 1, frames: 2, backtrace: [],
+            recentTimings: [.init(work: .frame, duration: 0.016), .init(work: .saveState, duration: 0.25)],
+            log: []
+        )
+        XCTAssertTrue(report.text.contains("16.0 save:250.0"))
+    }
+
+    func testConcurrentRecentFrameTimesAreConsecutive() {
+        XCTAssertNil(publishAndReadRecentConcurrently())
+    }
+
+    // MARK: - Watchdog
+
+    func testThresholdIsBudgetMultiple() {
+        XCTAssertEqual(HangWatchdog.Configuration(frameBudget: 0.1).threshold, 3, accuracy: 1e-9)
+    }
+
+    func testThresholdHasAFloor() {
+        XCTAssertEqual(HangWatchdog.Configuration(frameBudget: 1.0 / 60.0).threshold, 0.5, accuracy: 1e-9)
+    }
+
+    func testStuckFrameIsReportedAndRecovers() {
+        let frameState = FrameStateStore()
+        var configuration = HangWatchdog.Configuration(frameBudget: 0.001)
+        configuration.minimumStall = 0.2
+        configuration.pollInterval = 0.02
+        let watchdog = HangWatchdog(frameState: frameState, configuration: configuration, log: DiagnosticLog(capacity: 16))
+
+        let hung = expectation(description: "hang reported")
+        let recovered = expectation(description: "recovery reported")
+        watchdog.onHang = { report in
+            XCTAssertGreaterThanOrEqual(report.stalledFor, 0.2)
+            XCTAssertFalse(report.backtrace.isEmpty)
+            hung.fulfill()
+        }
+        watchdog.onRecovered = { _, _ in recovered.fulfill() }
+
+        watchdog.start()
+        frameState.beginFrame(at: DiagnosticLog.now)
+        let end = DiagnosticLog.now + 0.6
+        while DiagnosticLog.now < end {}
+        frameState.publish(frames: 1, timestamp: DiagnosticLog.now, frameTime: 0.6, fps: 0)
+
+        wait(for: [hung, recovered], timeout: 5, enforceOrder: true)
+        watchdog.stop()
+    }
+}
@@ -0,0 +1,62 @@
+//
+//  IndexDiffTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+@testable import YearnCore
+
+final class IndexDiffTests: XCTestCase {
+
+    private struct Item {
+        let id: String
+        var name: String
+        var size: Int
+    }
+
+    private struct Attributes: Equatable {
+        let name: String
+        let size: Int
+
+        init(_ item: Item) {
+            name = item.name
+            size = item.size
+        }
+    }
+
+    private let items = (0..<50).map { Item(id: "game-\($0)", name: "Game \($0)", size: 40_960 + $0) }
+
+    private var entries: [String: Attributes] {
+        Dictionary(uniqueKeysWithValues: items.map { ($0.id, Attributes($0)) })
+    }
+
+    private func diff(_ items: [Item], against entries: [String: Attributes]) -> IndexDiff<Item> {
+        IndexDiff(items, against: entries, identifier: \.id, attributes: Attributes.init)
+    }
+
+    func testUnchangedLibrarySubmitsNothing() {
+        XCTAssertTrue(diff(items, against: entries).isEmpty)
+    }
+
+    func testReorderedLibrarySubmitsNothing() {
+        XCTAssertTrue(diff(items.reversed(), against: entries).isEmpty)
+    }
+
+    func testEditsAdditionsAndRemovalsSubmitOnlyThemselves() {
+        var edited = items
+        edited[3].name = "Renamed"
+        let added = Item(id: "new", name: "New", size: 1)
+        edited.append(added)
+        edited.remove(at: 10)
+
+        let changes = diff(edited, against: entries)
+        XCTAssertEqual(Set(changes.changed.map(\.id)), [items[3].id, added.id])
+        XCTAssertEqual(changes.removed, [items[10].id])
+    }
+
+    func testEmptyManifestSubmitsEverything() {
+        let changes = diff(items, against: [:])
+        XCTAssertEqual(changes.changed.count, items.count)
+        XCTAssertTrue(changes.removed.isEmpty)
+    }
+}
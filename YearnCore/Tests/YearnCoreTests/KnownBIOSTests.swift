@@ -0,0 +1,31 @@
+//
+//  KnownBIOSTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+@testable import YearnCore
+
+final class KnownBIOSTests: XCTestCase {
+
+    /// RFC 1321 and FIPS 180-1 test vectors
+    func testHasherMatchesKnownAnswers() {
+        let abc = ROMHasher.hash(data: Data("abc".utf8), digests: [.md5, .sha1])
+        XCTAssertEqual(abc.md5String, "900150983cd24fb0d6963f7d28e17f72")
+        XCTAssertEqual(abc.sha1String, "a9993e364706816aba3e25717850c26c9cd0d89d")
+    }
+
+    func testPS1HashesAreWellFormedAndDistinct() {
+        let hashes = Array(KnownBIOS.ps1MD5.values)
+        XCTAssertEqual(Set(hashes).count, hashes.count)
+        for hash in hashes {
+            XCTAssertEqual(hash.count, 32, hash)
+            XCTAssertTrue(hash.allSatisfy { "0123456789abcdef".contains($0) }, hash)
+        }
+    }
+
+    func testBlankImageMatchesNoPS1Hash() {
+        let blank = ROMHasher.hash(data: Data(count: Int(KnownBIOS.ps1Size)), digests: .md5)
+        XCTAssertFalse(KnownBIOS.ps1MD5.values.contains(blank.md5String ?? ""))
+    }
+}
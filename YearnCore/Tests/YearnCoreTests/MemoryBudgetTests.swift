@@ -0,0 +1,78 @@
+//
+//  MemoryBudgetTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+@testable import YearnCore
+
+final class MemoryBudgetTests: XCTestCase {
+
+    private final class FixedSource: MemoryPressureSource {
+        var availableMemory: Int?
+        init(_ available: Int?) { availableMemory = available }
+    }
+
+    private var source: FixedSource!
+    private var budget: MemoryBudget!
+
+    override func setUp() {
+        source = FixedSource(100)
+        budget = MemoryBudget(source: source)
+        budget.lowMemoryThreshold = 200
+        budget.targetAvailableMemory = 300
+    }
+
+    /// Caches give memory back before rewind history, largest first, and only as much as needed
+    func testCachesEmptyBeforeRewindShrinks() {
+        var small = 30, large = 80, rewind = 200, essential = 500
+        let registrations = [
+            budget.register("small", tier: .cache, usage: { small }, shrink: { small = min(small, $0); return small }),
+            budget.register("large", tier: .cache, usage: { large }, shrink: { large = min(large, $0); return large }),
+            budget.register("rewind", tier: .rewind, usage: { rewind }, shrink: { rewind = min(rewind, $0); return rewind }),
+            budget.registerAccounting("essential", usage: { essential }),
+        ]
+
+        // 200 short: both caches (110), then 90 of rewind
+        budget.checkAvailableMemory()
+        XCTAssertEqual(small, 0)
+        XCTAssertEqual(large, 0)
+        XCTAssertEqual(rewind, 110)
+        XCTAssertEqual(essential, 500)
+        XCTAssertEqual(budget.statistics.reclaimedBytes, 200)
+
+        // A warning with nothing missing still drops the caches, and only them
+        source.availableMemory = nil
+        small = 10
+        budget.handleMemoryWarning()
+        XCTAssertEqual(small, 0)
+        XCTAssertEqual(rewind, 110)
+
+        registrations.forEach { $0.cancel() }
+        XCTAssertTrue(budget.usage().isEmpty)
+    }
+
+    func testShrunkConsumersAreRestoredOnceMemoryRecovers() {
+        var rewind = 400
+        var restored = 0
+        let registration = budget.register("rewind", tier: .rewind, usage: { rewind },
+                                           shrink: { rewind = min(rewind, $0); return rewind },
+                                           restore: { restored += 1 })
+
+        budget.checkAvailableMemory()
+        XCTAssertEqual(rewind, 200)
+        XCTAssertEqual(restored, 0)
+
+        // Between the threshold and the target: neither shrink nor restore
+        source.availableMemory = 250
+        budget.checkAvailableMemory()
+        XCTAssertEqual(restored, 0)
+
+        source.availableMemory = 300
+        budget.checkAvailableMemory()
+        budget.checkAvailableMemory()
+        XCTAssertEqual(restored, 1)
+        XCTAssertEqual(budget.statistics.restores, 1)
+        registration.cancel()
+    }
+}
@@ -0,0 +1,242 @@
+//
+//  PatchedROMCacheTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+import CYearnSupport
+@testable import YearnCore
+
+final class PatchedROMCacheTests: XCTestCase {
+
+    private enum Outcome: Equatable {
+        case patched([UInt8])
+        case failed(yearn_patch_status)
+    }
+
+    /// Builds IPS, UPS and BPS patches byte by byte
+    private struct PatchWriter {
+        var bytes: [UInt8] = []
+
+        mutating func append(_ data: [UInt8]) {
+            bytes += data
+        }
+
+        mutating func append(_ string: String) {
+            bytes += Array(string.utf8)
+        }
+
+        /// beat variable-length integer, as UPS and BPS use
+        mutating func appendVarint(_ value: UInt64) {
+            var value = value
+            while true {
+                let x = UInt8(value & 0x7F)
+                value >>= 7
+                if value == 0 {
+                    bytes.append(0x80 | x)
+                    return
+                }
+                bytes.append(x)
+                value -= 1
+            }
+        }
+
+        mutating func appendCRC(_ crc: UInt32) {
+            for i in 0..<4 {
+                bytes.append(UInt8(truncatingIfNeeded: crc >> (8 * i)))
+            }
+        }
+
+        /// Source, target and patch CRC32s, closing a UPS or BPS patch
+        mutating func appendFooter(source: [UInt8], target: [UInt8]) {
+            appendCRC(Self.crc32(source))
+            appendCRC(Self.crc32(target))
+            appendCRC(Self.crc32(bytes))
+        }
+
+        static func crc32(_ bytes: [UInt8]) -> UInt32 {
+            yearn_crc32(0, bytes, bytes.count)
+        }
+    }
+
+    private static let sourceSize = 1024
+    private static let grownSize = 1100
+
+    private let source = (0..<PatchedROMCacheTests.sourceSize).map { UInt8(truncatingIfNeeded: $0 * 7 + ($0 >> 8)) }
+
+    /// Inspect `patch`, then apply it to `source` with checksums verified
+    private func apply(_ patch: [UInt8], to source: [UInt8]) -> Outcome {
+        var info = yearn_patch_info()
+        var status = yearn_patch_inspect(patch, patch.count, UInt64(source.count), &info)
+        guard status == YEARN_PATCH_OK else { return .failed(status) }
+
+        var target = [UInt8](repeating: 0, count: Int(info.target_size))
+        let targetCount = target.count
+        status = yearn_patch_apply(source, source.count, patch, patch.count, &target, targetCount, 1)
+        return status == YEARN_PATCH_OK ? .patched(target) : .failed(status)
+    }
+
+    // MARK: - IPS
+
+    /// A plain record, an RLE record and a record that grows the ROM
+    private var ipsPatch: [UInt8] {
+        var patch = PatchWriter()
+        patch.append("PATCH")
+        patch.append([0x00, 0x00, 0x10, 0x00, 0x05])
+        patch.append("YEARN")
+        patch.append([0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x20, 0xAA])
+        patch.append([0x00, 0x04, 0x42, 0x00, 0x00, 0x00, 0x0A, 0x55])
+        patch.append("EOF")
+        return patch.bytes
+    }
+
+    private var ipsTarget: [UInt8] {
+        var target = source + [UInt8](repeating: 0, count: Self.grownSize - Self.sourceSize)
+        target.replaceSubrange(0x10..<0x15, with: Array("YEARN".utf8))
+        target.replaceSubrange(0x100..<0x120, with: [UInt8](repeating: 0xAA, count: 32))
+        target.replaceSubrange(1090..<1100, with: [UInt8](repeating: 0x55, count: 10))
+        return target
+    }
+
+    func testIPSRecordsRLEAndGrowth() {
+        XCTAssertEqual(apply(ipsPatch, to: source), .patched(ipsTarget))
+    }
+
+    func testIPSTruncationAfterEOF() {
+        XCTAssertEqual(apply(ipsPatch + [0x00, 0x02, 0x00], to: source), .patched(Array(ipsTarget.prefix(0x200))))
+    }
+
+    func testTargetBufferTooSmall() {
+        var target = [UInt8](repeating: 0, count: Self.grownSize - 1)
+        let targetCount = target.count
+        let status = yearn_patch_apply(source, source.count, ipsPatch, ipsPatch.count, &target, targetCount, 1)
+        XCTAssertEqual(status, YEARN_PATCH_ERROR_TARGET_SIZE)
+    }
+
+    // MARK: - UPS
+
+    /// XOR runs against a ROM that grows by 76 bytes
+    private var upsTarget: [UInt8] {
+        var target = source + [UInt8](repeating: 0, count: Self.grownSize - Self.sourceSize)
+        for i in 200..<264 {
+            target[i] ^= 0x5A
+        }
+        target[900] = ~target[900]
+        for i in Self.sourceSize..<Self.grownSize {
+            target[i] = UInt8(truncatingIfNeeded: i)
+        }
+        return target
+    }
+
+    private var upsPatch: [UInt8] {
+        let target = upsTarget
+        func xor(_ i: Int) -> UInt8 {
+            (i < source.count ? source[i] : 0) ^ target[i]
+        }
+
+        var patch = PatchWriter()
+        patch.append("UPS1")
+        patch.appendVarint(UInt64(Self.sourceSize))
+        patch.appendVarint(UInt64(Self.grownSize))
+        var last = 0
+        var i = 0
+        while i < target.count {
+            guard xor(i) != 0 else {
+                i += 1
+                continue
+            }
+            patch.appendVarint(UInt64(i - last))
+            while i < target.count && xor(i) != 0 {
+                patch.append([xor(i)])
+                i += 1
+            }
+            patch.append([0])
+            i += 1
+            last = i
+        }
+        patch.appendFooter(source: source, target: target)
+        return patch.bytes
+    }
+
+    func testUPSXORRunsAndGrowth() {
+        XCTAssertEqual(apply(upsPatch, to: source), .patched(upsTarget))
+    }
+
+    func testDamagedUPSPatch() {
+        var patch = upsPatch
+        patch[12] ^= 1
+        XCTAssertEqual(apply(patch, to: source), .failed(YEARN_PATCH_ERROR_PATCH_CRC))
+    }
+
+    func testUPSPatchOnWrongROM() {
+        var rom = source
+        rom[0] ^= 1
+        XCTAssertEqual(apply(upsPatch, to: rom), .failed(YEARN_PATCH_ERROR_SOURCE))
+    }
+
+    // MARK: - BPS
+
+    /// Every action, including an overlapping target copy (a run fill)
+    private var bpsTarget: [UInt8] {
+        var target = Array(source[0..<100])                         // SourceRead 100
+        target += Array("TRANSLATED".utf8)                          // TargetRead 10
+        target += source[500..<700]                                 // SourceCopy 200 from 500
+        target += [UInt8](repeating: target[target.count - 1], count: 40)   // TargetCopy 40 from out - 1
+        target += source[10..<60]                                   // SourceCopy 50 from 10 (backwards)
+        return target
+    }
+
+    private var bpsPatch: [UInt8] {
+        let target = bpsTarget
+        let sourceRead: UInt64 = 0, targetRead: UInt64 = 1, sourceCopy: UInt64 = 2, targetCopy: UInt64 = 3
+
+        var patch = PatchWriter()
+        patch.append("BPS1")
+        patch.appendVarint(UInt64(Self.sourceSize))
+        patch.appendVarint(UInt64(target.count))
+        patch.appendVarint(4)
+        patch.append("meta")
+        patch.appendVarint(((100 - 1) << 2) | sourceRead)
+        patch.appendVarint(((10 - 1) << 2) | targetRead)
+        patch.append("TRANSLATED")
+        patch.appendVarint(((200 - 1) << 2) | sourceCopy)
+        patch.appendVarint(500 << 1)
+        patch.appendVarint(((40 - 1) << 2) | targetCopy)
+        patch.appendVarint((310 - 1) << 1)
+        patch.appendVarint(((50 - 1) << 2) | sourceCopy)
+        patch.appendVarint(((700 - 10) << 1) | 1)
+        patch.appendFooter(source: source, target: target)
+        return patch.bytes
+    }
+
+    func testBPSEveryAction() {
+        XCTAssertEqual(apply(bpsPatch, to: source), .patched(bpsTarget))
+    }
+
+    func testBPSPatchForROMOfAnotherSize() {
+        XCTAssertEqual(apply(bpsPatch, to: Array(source.dropLast())), .failed(YEARN_PATCH_ERROR_SOURCE))
+    }
+
+    func testNotAPatch() {
+        XCTAssertEqual(apply(Array("NOT A PATCH FILE".utf8), to: source), .failed(YEARN_PATCH_ERROR_FORMAT))
+    }
+
+    // MARK: - Cache
+
+    func testPatchIsFoundNextToROM() throws {
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("PatchedROMCacheTests-\(UUID().uuidString)", isDirectory: true)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let rom = directory.appendingPathComponent("Game.sfc")
+        try Data(count: 16).write(to: rom)
+        XCTAssertNil(PatchedROMCache.patch(for: rom))
+
+        let patch = directory.appendingPathComponent("Game.bps")
+        try Data("BPS1".utf8).write(to: patch)
+        XCTAssertEqual(PatchedROMCache.patch(for: rom)?.lastPathComponent, patch.lastPathComponent)
+        XCTAssertTrue(PatchedROMCache.isPatch(patch))
+        XCTAssertFalse(PatchedROMCache.isPatch(rom))
+    }
+}
@@ -0,0 +1,248 @@
+//
+//  PlayJournalTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+import CYearnSupport
+@testable import YearnCore
+
+final class PlayJournalTests: XCTestCase {
+
+    private var directory: URL!
+
+    override func setUpWithError() throws {
+        directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("PlayJournalTests-\(UUID().uuidString)", isDirectory: true)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    // MARK: - Journal File
+
+    // A 16-byte header, then 44-byte entries: a 40-byte record and its CRC32
+    private static let headerSize: UInt64 = 16
+    private static let entrySize: UInt64 = 44
+
+    private var journalURL: URL {
+        directory.appendingPathComponent("test.journal")
+    }
+
+    private let records = (0..<200).map { n -> yearn_journal_record in
+        var record = yearn_journal_record()
+        withUnsafeBytes(of: UInt32(n).littleEndian) { source in
+            withUnsafeMutableBytes(of: &record.game_id) { $0.copyMemory(from: source) }
+        }
+        record.start = 700_000_000 + Double(n) * 3600
+        record.duration = 60 + Float(n)
+        record.average_fps = 59.7
+        record.frames = UInt32(n * 3600)
+        record.kind = n % 5 == 0 ? YEARN_JOURNAL_LAUNCH.rawValue : YEARN_JOURNAL_SESSION.rawValue
+        return record
+    }
+
+    /// Records have no Equatable conformance; compare their bytes
+    private func bytes<Records: Sequence>(_ records: Records) -> [[UInt8]] where Records.Element == yearn_journal_record {
+        records.map { record in withUnsafeBytes(of: record) { Array($0) } }
+    }
+
+    private func openJournal() throws -> OpaquePointer {
+        try XCTUnwrap(yearn_journal_open(journalURL.path))
+    }
+
+    private func append<Records: Collection>(_ records: Records, to journal: OpaquePointer) -> Int32
+    where Records.Element == yearn_journal_record {
+        Array(records).withUnsafeBufferPointer { yearn_journal_append(journal, $0.baseAddress, $0.count) }
+    }
+
+    private func read(_ journal: OpaquePointer, from first: Int, count: Int) -> [yearn_journal_record] {
+        var read = [yearn_journal_record](repeating: yearn_journal_record(), count: count)
+        let got = yearn_journal_read(journal, first, &read, count)
+        return Array(read.prefix(max(got, 0)))
+    }
+
+    /// A closed journal holding `records`, appended in a small and a large batch
+    private func writeJournal() throws {
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(append(records[0..<10], to: journal), 0)
+        XCTAssertEqual(append(records[10...], to: journal), 0)
+        XCTAssertEqual(yearn_journal_sync(journal), 0)
+    }
+
+    private func overwrite(_ data: Data, at offset: UInt64) throws {
+        let handle = try FileHandle(forWritingTo: journalURL)
+        defer { try? handle.close() }
+        try handle.seek(toOffset: offset)
+        try handle.write(contentsOf: data)
+    }
+
+    /// Tear entry 3 and leave half an entry at the end, as a crash might
+    private func writeDamagedJournal() throws {
+        try writeJournal()
+        try overwrite(Data("X".utf8), at: Self.headerSize + 3 * Self.entrySize + 20)
+        try overwrite(Data(count: 20), at: Self.headerSize + 200 * Self.entrySize)
+    }
+
+    func testNewJournalStartsAtGenerationZero() throws {
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(yearn_journal_generation(journal), 0)
+    }
+
+    func testNewJournalIsEmpty() throws {
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(yearn_journal_count(journal), 0)
+    }
+
+    func testAppendedRecordsReadBack() throws {
+        try writeJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(bytes(read(journal, from: 0, count: 200)), bytes(records))
+    }
+
+    func testReadPastEndStopsAtLastEntry() throws {
+        try writeJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(bytes(read(journal, from: 195, count: 10)), bytes(records[195...]))
+    }
+
+    func testReadFromEndIsEmpty() throws {
+        try writeJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(yearn_journal_read(journal, 200, nil, 10), 0)
+    }
+
+    func testPartialEntryAtEndIsCutOff() throws {
+        try writeDamagedJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(yearn_journal_count(journal), 200)
+    }
+
+    func testTornEntryReadsAsInvalid() throws {
+        try writeDamagedJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(read(journal, from: 3, count: 1).first?.kind, YEARN_JOURNAL_INVALID.rawValue)
+    }
+
+    func testEntryAfterTornOneIsIntact() throws {
+        try writeDamagedJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(bytes(read(journal, from: 4, count: 1)), bytes([records[4]]))
+    }
+
+    func testAppendAfterCutOffLandsOnEntryBoundary() throws {
+        try writeDamagedJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        _ = append([records[0]], to: journal)
+        XCTAssertEqual(bytes(read(journal, from: 200, count: 1)), bytes([records[0]]))
+    }
+
+    func testResetEmptiesJournal() throws {
+        try writeJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        _ = yearn_journal_reset(journal, 7)
+        XCTAssertEqual(yearn_journal_count(journal), 0)
+    }
+
+    /// Reset to generation 7 and append one record
+    private func writeResetJournal() throws {
+        try writeJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(yearn_journal_reset(journal, 7), 0)
+        XCTAssertEqual(append([records[1]], to: journal), 0)
+    }
+
+    func testResetGenerationSurvivesReopening() throws {
+        try writeResetJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(yearn_journal_generation(journal), 7)
+    }
+
+    func testAppendsAfterResetSurviveReopening() throws {
+        try writeResetJournal()
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(bytes(read(journal, from: 0, count: 10)), bytes([records[1]]))
+    }
+
+    func testUnknownFileStartsAtGenerationZero() throws {
+        try Data("not a journal at all".utf8).write(to: journalURL)
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(yearn_journal_generation(journal), 0)
+    }
+
+    func testUnknownFileStartsEmpty() throws {
+        try Data("not a journal at all".utf8).write(to: journalURL)
+        let journal = try openJournal()
+        defer { yearn_journal_close(journal) }
+        XCTAssertEqual(yearn_journal_count(journal), 0)
+    }
+
+    // MARK: - Play Journal
+
+    func testSessionsSurviveReopening() throws {
+        let game = UUID()
+        let start = Date(timeIntervalSinceReferenceDate: 800_000_000)
+        do {
+            let journal = try PlayJournal(directory: directory)
+            journal.recordLaunch(of: game, at: start)
+            journal.record(.init(gameID: game, start: start, duration: 90, frames: 5400, averageFPS: 60))
+            journal.flush()
+        }
+
+        let summary = try PlayJournal(directory: directory).summary
+        XCTAssertEqual(summary.sessions, 1)
+        XCTAssertEqual(summary.totalPlayTime, 90)
+        XCTAssertEqual(summary.games[game]?.frames, 5400)
+        XCTAssertEqual(summary.games[game]?.lastPlayed, start)
+        XCTAssertEqual(summary.playTime(onDayOf: start), 90)
+    }
+
+    func testCompactionKeepsTotals() throws {
+        let game = UUID()
+        do {
+            let journal = try PlayJournal(directory: directory)
+            journal.compactionThreshold = 4
+            journal.flushThreshold = 1
+            for index in 0..<10 {
+                journal.record(.init(gameID: game, start: Date(timeIntervalSinceReferenceDate: Double(index) * 3600),
+                                     duration: 60, frames: 3600, averageFPS: 60))
+            }
+            journal.flush()
+            XCTAssertGreaterThan(journal.statistics.compactions, 0)
+        }
+
+        let summary = try PlayJournal(directory: directory).summary
+        XCTAssertEqual(summary.sessions, 10)
+        XCTAssertEqual(summary.games[game]?.playTime, 600)
+    }
+
+    func testReassignMergesTotals() throws {
+        let old = UUID(), new = UUID()
+        let journal = try PlayJournal(directory: directory)
+        journal.record(.init(gameID: old, start: Date(), duration: 30, frames: 1800, averageFPS: 60))
+        journal.record(.init(gameID: new, start: Date(), duration: 10, frames: 600, averageFPS: 60))
+        journal.reassign([old: new])
+
+        let summary = journal.summary
+        XCTAssertNil(summary.games[old])
+        XCTAssertEqual(summary.games[new]?.playTime, 40)
+        XCTAssertEqual(summary.games[new]?.sessions, 2)
+    }
+}
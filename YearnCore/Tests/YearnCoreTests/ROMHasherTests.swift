@@ -0,0 +1,152 @@
+//
+//  ROMHasherTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+import CYearnSupport
+@testable import YearnCore
+
+final class ROMHasherTests: XCTestCase {
+
+    private let twoBlockMessage = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"
+    private let eightyDigits = String(repeating: "1234567890", count: 8)
+
+    /// CRC32, MD5 and SHA-1 of `message`, fed to the hasher `chunk` bytes at a time
+    private func digests(of message: String, chunk: Int = .max) -> [String] {
+        let bytes = Array(message.utf8)
+        var hasher = yearn_hasher()
+        var result = yearn_hash_result()
+        yearn_hasher_init(&hasher, UInt32(YEARN_HASH_ALL))
+        bytes.withUnsafeBytes { buffer in
+            var offset = 0
+            while offset < buffer.count {
+                let length = min(chunk, buffer.count - offset)
+                yearn_hasher_update(&hasher, buffer.baseAddress! + offset, length)
+                offset += length
+            }
+        }
+        yearn_hasher_final(&hasher, &result)
+        return [
+            String(format: "%08x", result.crc32),
+            ROMHasher.hex(withUnsafeBytes(of: &result.md5) { Array($0) }),
+            ROMHasher.hex(withUnsafeBytes(of: &result.sha1) { Array($0) }),
+        ]
+    }
+
+    private func pattern(count: Int) -> [UInt8] {
+        (0..<count).map { UInt8(truncatingIfNeeded: $0 &* 131 &+ ($0 >> 5)) }
+    }
+
+    // MARK: - Known Answers
+
+    // RFC 1321 appendix A.5 and FIPS 180 examples; CRC32 from the zlib check values
+
+    func testEmptyMessage() {
+        XCTAssertEqual(digests(of: ""), [
+            "00000000",
+            "d41d8cd98f00b204e9800998ecf8427e",
+            "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+        ])
+    }
+
+    func testABC() {
+        XCTAssertEqual(digests(of: "abc"), [
+            "352441c2",
+            "900150983cd24fb0d6963f7d28e17f72",
+            "a9993e364706816aba3e25717850c26c9cd0d89d",
+        ])
+    }
+
+    func testTwoBlockMessage() {
+        XCTAssertEqual(digests(of: twoBlockMessage), [
+            "171a3f5f",
+            "8215ef0796a20bcaaae116d3876c664a",
+            "84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+        ])
+    }
+
+    func testEightyDigits() {
+        XCTAssertEqual(digests(of: eightyDigits), [
+            "7ca94a72",
+            "57edf4a22be3c955ac49da2e2107b67a",
+            "50abf5706a150990a08b2c5ea40fa0e585554732",
+        ])
+    }
+
+    func testByteAtATimeMatchesOneUpdate() {
+        XCTAssertEqual(digests(of: eightyDigits, chunk: 1), digests(of: eightyDigits))
+    }
+
+    func testUnevenChunksMatchOneUpdate() {
+        XCTAssertEqual(digests(of: twoBlockMessage, chunk: 7), digests(of: twoBlockMessage))
+    }
+
+    func testUnrequestedDigestsAreNil() {
+        let hash = ROMHasher.hash(data: Data("abc".utf8), digests: .crc32)
+        XCTAssertEqual([hash.md5String, hash.sha1String], [nil, nil])
+    }
+
+    // MARK: - CRC32
+
+    func testCRC32CheckValue() {
+        XCTAssertEqual(yearn_crc32_with(YEARN_CRC32_TABLE, 0, Array("123456789".utf8), 9), 0xCBF4_3926)
+    }
+
+    /// Every implementation, including ones this CPU lacks (they fall back to the table)
+    func testEveryCRC32PathMatchesTableAtOddLengthsAndOffsets() {
+        let bytes = pattern(count: 4096 + 16)
+        var mismatches: [String] = []
+        bytes.withUnsafeBytes { buffer in
+            for offset in stride(from: 0, to: 16, by: 3) {
+                for length in stride(from: 0, through: 4096, by: 61) {
+                    let start = buffer.baseAddress! + offset
+                    let expected = yearn_crc32_with(YEARN_CRC32_TABLE, 0, start, length)
+                    for impl in [YEARN_CRC32_ARMV8, YEARN_CRC32_PCLMUL]
+                    where yearn_crc32_with(impl, 0, start, length) != expected {
+                        mismatches.append("impl \(impl.rawValue) offset \(offset) length \(length)")
+                    }
+                    if yearn_crc32(0, start, length) != expected {
+                        mismatches.append("best offset \(offset) length \(length)")
+                    }
+                }
+            }
+        }
+        XCTAssertEqual(mismatches, [])
+    }
+
+    func testChainedCRC32EqualsSingleCall() {
+        let bytes = pattern(count: 4000)
+        let split = bytes.withUnsafeBytes { buffer in
+            yearn_crc32(yearn_crc32(0, buffer.baseAddress, 1000), buffer.baseAddress! + 1000, 3000)
+        }
+        XCTAssertEqual(split, yearn_crc32(0, bytes, bytes.count))
+    }
+
+    func testCRC32PathsAgree() {
+        let bytes = (0..<100_003).map { UInt8(truncatingIfNeeded: $0 &* 31 &+ 7) }
+        let table = yearn_crc32_with(YEARN_CRC32_TABLE, 0, bytes, bytes.count)
+        XCTAssertEqual(yearn_crc32_with(yearn_crc32_best_impl(), 0, bytes, bytes.count), table)
+        XCTAssertEqual(ROMHasher.hash(data: Data(bytes), digests: .crc32).crc32, table)
+    }
+
+    // MARK: - Files
+
+    func testFileHashMatchesInMemoryHashAfterSkip() throws {
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("ROMHasherTests-\(UUID().uuidString)")
+        defer { try? FileManager.default.removeItem(at: url) }
+        let header = Data(repeating: 0xFF, count: 16)
+        let body = Data((0..<300_000).map { UInt8(truncatingIfNeeded: $0 ^ ($0 >> 8)) })
+        try (header + body).write(to: url)
+
+        let fromFile = try ROMHasher.hash(fileAt: url, skip: 16)
+        let fromData = ROMHasher.hash(data: body)
+        XCTAssertEqual(fromFile, fromData)
+        XCTAssertEqual(fromFile.length, UInt64(body.count))
+    }
+
+    func testMissingFileThrows() {
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("ROMHasherTests-missing-\(UUID().uuidString)")
+        XCTAssertThrowsError(try ROMHasher.hash(fileAt: url))
+    }
+}
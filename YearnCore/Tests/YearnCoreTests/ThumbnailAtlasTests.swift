@@ -0,0 +1,202 @@
+//
+//  ThumbnailAtlasTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+@testable import YearnCore
+
+final class ThumbnailAtlasTests: XCTestCase {
+
+    private var url: URL!
+
+    override func setUp() {
+        url = FileManager.default.temporaryDirectory.appendingPathComponent("ThumbnailAtlasTests-\(UUID().uuidString).atlas")
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: url)
+    }
+
+    private func tile(_ n: Int, length: Int) -> Data {
+        Data((0..<length).map { UInt8(truncatingIfNeeded: n * 31 + $0 * 7) })
+    }
+
+    private func length(of n: Int) -> Int {
+        100 + n * 13 % 3900
+    }
+
+    /// 1,100 tiles of assorted lengths, past the 1,024 slots of the first chunk
+    private func filledAtlas() throws -> (atlas: ThumbnailAtlas, ids: [UUID]) {
+        let atlas = try ThumbnailAtlas(url: url, slotSize: 4096)
+        let ids = (0..<1100).map { _ in UUID() }
+        for (n, id) in ids.enumerated() {
+            try atlas.store(tile(n, length: length(of: n)), for: id)
+        }
+        return (atlas, ids)
+    }
+
+    // MARK: - Layout
+
+    func testSlotSizeIsRoundedUpToAPage() throws {
+        XCTAssertEqual(try ThumbnailAtlas(url: url, slotSize: 1000).slotSize, 4096)
+    }
+
+    func testFillingPastOneChunkKeepsEveryTile() throws {
+        XCTAssertEqual(try filledAtlas().atlas.count, 1100)
+    }
+
+    func testTileInFirstChunkReadsBack() throws {
+        let (atlas, ids) = try filledAtlas()
+        XCTAssertEqual(atlas.tile(for: ids[7]), tile(7, length: length(of: 7)))
+    }
+
+    func testTileInGrownChunkReadsBack() throws {
+        let (atlas, ids) = try filledAtlas()
+        XCTAssertEqual(atlas.tile(for: ids[1099]), tile(1099, length: length(of: 1099)))
+    }
+
+    func testMissingTileIsNil() throws {
+        let atlas = try ThumbnailAtlas(url: url, slotSize: 4096)
+        XCTAssertNil(atlas.tile(for: UUID()))
+    }
+
+    func testOversizedTileIsRejected() throws {
+        let atlas = try ThumbnailAtlas(url: url, slotSize: ThumbnailAtlas.coverSlotSize)
+        XCTAssertThrowsError(try atlas.store(Data(count: ThumbnailAtlas.coverSlotSize + 1), for: UUID()))
+    }
+
+    // MARK: - Replace and Remove
+
+    func testReplacedTileReadsNewContents() throws {
+        let (atlas, ids) = try filledAtlas()
+        try atlas.store(tile(5, length: 64), for: ids[5])
+        XCTAssertEqual(atlas.tile(for: ids[5]), tile(5, length: 64))
+    }
+
+    func testReplacingDoesNotChangeCount() throws {
+        let (atlas, ids) = try filledAtlas()
+        try atlas.store(tile(5, length: 64), for: ids[5])
+        XCTAssertEqual(atlas.count, 1100)
+    }
+
+    func testRemovedTileIsNil() throws {
+        let (atlas, ids) = try filledAtlas()
+        atlas.remove(ids[6])
+        XCTAssertNil(atlas.tile(for: ids[6]))
+    }
+
+    // MARK: - Reopening
+
+    func testTilesSurviveReopening() throws {
+        let id = UUID()
+        let tile = Data((0..<5000).map { UInt8(truncatingIfNeeded: $0) })
+        do {
+            let atlas = try ThumbnailAtlas(url: url, slotSize: ThumbnailAtlas.coverSlotSize)
+            try atlas.store(tile, for: id)
+        }
+
+        let atlas = try ThumbnailAtlas(url: url, slotSize: ThumbnailAtlas.coverSlotSize)
+        XCTAssertEqual(atlas.tile(for: id), tile)
+    }
+
+    func testCountSurvivesReopening() throws {
+        do {
+            let (atlas, ids) = try filledAtlas()
+            atlas.remove(ids[6])
+        }
+        XCTAssertEqual(try ThumbnailAtlas(url: url, slotSize: 4096).count, 1099)
+    }
+
+    func testReplacedTileSurvivesReopening() throws {
+        let id: UUID
+        do {
+            let (atlas, ids) = try filledAtlas()
+            id = ids[5]
+            try atlas.store(tile(5, length: 64), for: id)
+        }
+        XCTAssertEqual(try ThumbnailAtlas(url: url, slotSize: 4096).tile(for: id), tile(5, length: 64))
+    }
+
+    func testRemovedTileStaysRemovedAfterReopening() throws {
+        let id: UUID
+        do {
+            let (atlas, ids) = try filledAtlas()
+            id = ids[6]
+            atlas.remove(id)
+        }
+        XCTAssertNil(try ThumbnailAtlas(url: url, slotSize: 4096).tile(for: id))
+    }
+
+    func testDifferentSlotSizeStartsAfresh() throws {
+        do {
+            let atlas = try ThumbnailAtlas(url: url, slotSize: 4096)
+            try atlas.store(tile(1, length: 100), for: UUID())
+        }
+        XCTAssertEqual(try ThumbnailAtlas(url: url, slotSize: 8192).count, 0)
+    }
+
+    // MARK: - Eviction
+
+    func testTileLimitEvicts() throws {
+        let atlas = try ThumbnailAtlas(url: url, slotSize: 4096)
+        atlas.maxTiles = 2
+        for _ in 0..<3 {
+            try atlas.store(Data([1, 2, 3]), for: UUID())
+        }
+        XCTAssertEqual(atlas.count, 2)
+    }
+
+    func testEvictionDropsOldestTile() throws {
+        let atlas = try ThumbnailAtlas(url: url, slotSize: 4096)
+        atlas.maxTiles = 2
+        let ids = (0..<3).map { _ in UUID() }
+        for id in ids {
+            try atlas.store(Data([1, 2, 3]), for: id)
+        }
+        XCTAssertNil(atlas.tile(for: ids[0]))
+    }
+
+    func testEvictionKeepsNewestTile() throws {
+        let atlas = try ThumbnailAtlas(url: url, slotSize: 4096)
+        atlas.maxTiles = 2
+        let ids = (0..<3).map { _ in UUID() }
+        for id in ids {
+            try atlas.store(Data([1, 2, 3]), for: id)
+        }
+        XCTAssertEqual(atlas.tile(for: ids[2]), Data([1, 2, 3]))
+    }
+
+    /// The cover atlas must hold a 5,000-game library without evicting
+    func testCoverLimitCoversLargeLibrary() {
+        XCTAssertGreaterThanOrEqual(ThumbnailAtlas.coverTileLimit, 5000)
+    }
+
+    // MARK: - Torn Tiles
+
+    /// Store one tile in a fresh atlas, then overwrite a byte of it behind the atlas's back
+    private func tornAtlas(id: UUID) throws -> ThumbnailAtlas {
+        let atlas = try ThumbnailAtlas(url: url, slotSize: 8192)
+        try atlas.store(tile(1, length: 100), for: id)
+
+        // Header page, then the first chunk's 1,024 index entries of 32 bytes, then slot 0
+        let slotZero: UInt64 = 4096 + 1024 * 32
+        let handle = try FileHandle(forWritingTo: url)
+        defer { try? handle.close() }
+        try handle.seek(toOffset: slotZero + 10)
+        try handle.write(contentsOf: Data("X".utf8))
+        return atlas
+    }
+
+    func testTornTileReadsAsMissing() throws {
+        let id = UUID()
+        XCTAssertNil(try tornAtlas(id: id).tile(for: id))
+    }
+
+    func testTornTileFreesItsSlot() throws {
+        let id = UUID()
+        let atlas = try tornAtlas(id: id)
+        _ = atlas.tile(for: id)
+        XCTAssertEqual(atlas.count, 0)
+    }
+}
@@ -0,0 +1,65 @@
+//
+//  ZipArchiveTests.swift
+//  YearnCoreTests
+//
+
+import XCTest
+@testable import YearnCore
+
+final class ZipArchiveTests: XCTestCase {
+
+    private var url: URL!
+
+    override func setUp() {
+        url = FileManager.default.temporaryDirectory.appendingPathComponent("ZipArchiveTests-\(UUID().uuidString).zip")
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: url)
+    }
+
+    private func le16(_ value: UInt16) -> [UInt8] {
+        [UInt8(truncatingIfNeeded: value), UInt8(truncatingIfNeeded: value >> 8)]
+    }
+
+    private func le32(_ value: UInt32) -> [UInt8] {
+        le16(UInt16(truncatingIfNeeded: value)) + le16(UInt16(truncatingIfNeeded: value >> 16))
+    }
+
+    private func le64(_ value: UInt64) -> [UInt8] {
+        le32(UInt32(truncatingIfNeeded: value)) + le32(UInt32(truncatingIfNeeded: value >> 32))
+    }
+
+    /// End of central directory record for an empty archive
+    private func endRecord(entries: UInt16 = 0, directoryOffset: UInt32 = 0) -> [UInt8] {
+        le32(0x06054b50) + le32(0) + le16(entries) + le16(entries) + le32(0) + le32(directoryOffset) + le16(0)
+    }
+
+    /// ZIP64 locator pointing at `recordOffset`, then an end record that sends readers to it
+    private func zip64Archive(recordOffset: UInt64) -> [UInt8] {
+        le32(0x07064b50) + le32(0) + le64(recordOffset) + le32(1) + endRecord(entries: 0xFFFF)
+    }
+
+    /// The error opening `bytes` as an archive, described
+    private func openingError(_ bytes: [UInt8]) throws -> String? {
+        try Data(bytes).write(to: url)
+        do {
+            _ = try ZipArchive(url: url)
+            return nil
+        } catch {
+            return (error as? ArchiveError)?.errorDescription
+        }
+    }
+
+    // MARK: - Offsets
+
+    func testDirectoryPastEndIsCorrupt() throws {
+        XCTAssertEqual(try openingError(endRecord(directoryOffset: 1000)), "Archive is damaged: read past end of file")
+    }
+
+    /// An offset this close to the top would overflow when the record length is added
+    func testOverflowingZIP64OffsetIsCorrupt() throws {
+        XCTAssertEqual(try openingError(zip64Archive(recordOffset: UInt64.max - 10)),
+                       "Archive is damaged: read past end of file")
+    }
+}